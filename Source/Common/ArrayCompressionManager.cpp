@@ -0,0 +1,421 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ArrayCompressionManager.h"
+
+#include <algorithm>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "Common/ArrayMemoryPool.h"
+#include "Common/MemoryEstimator.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayCompressionManager::ArrayCompressionManager(const PipelineDataFlowGraph& graph, int idleFilters, const QVector<DataArrayPath>& flaggedPaths)
+: m_Graph(graph)
+, m_IdleFilters(std::max(idleFilters, 0))
+, m_FlaggedPaths(flaggedPaths)
+, m_StartedAt(graph.size(), 0)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayCompressionManager::~ArrayCompressionManager() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ArrayCompressionManager::getIdleFilters() const
+{
+  return m_IdleFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ArrayCompressionManager::Key(const DataArrayPath& path)
+{
+  return path.serialize("|");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayCompressionManager::writes(int node, const DataArrayPath& path) const
+{
+  const FilterDataFootprint& footprint = m_Graph.footprint(node);
+  if(footprint.barrier)
+  {
+    return true;
+  }
+  for(const DataArrayPath& write : footprint.writes)
+  {
+    if(PipelineDataFlowGraph::PathsOverlap(write, path))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayCompressionManager::uses(int node, const DataArrayPath& path) const
+{
+  if(writes(node, path))
+  {
+    return true;
+  }
+  for(const DataArrayPath& read : m_Graph.footprint(node).reads)
+  {
+    if(PipelineDataFlowGraph::PathsOverlap(read, path))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayCompressionManager::markStarted(int node)
+{
+  if(node < 0 || node >= m_StartedAt.size())
+  {
+    return;
+  }
+  m_StartedAt[node] = ++m_Clock;
+
+  QStringList keys = m_Reusable.keys();
+  for(const QString& key : keys)
+  {
+    if(writes(node, DataArrayPath::Deserialize(key, "|")))
+    {
+      m_Reusable.remove(key);
+    }
+  }
+  QStringList incompressible = m_Incompressible.values();
+  for(const QString& key : incompressible)
+  {
+    if(writes(node, DataArrayPath::Deserialize(key, "|")))
+    {
+      m_Incompressible.remove(key);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayCompressionManager::isFlagged(const DataArrayPath& path) const
+{
+  for(const DataArrayPath& flagged : m_FlaggedPaths)
+  {
+    if(PipelineDataFlowGraph::PathsOverlap(flagged, path))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayCompressionManager::isIdle(const DataArrayPath& path) const
+{
+  if(m_IdleFilters == 0)
+  {
+    return false;
+  }
+
+  qint64 lastUse = 0;
+  for(int node = 0; node < m_StartedAt.size(); node++)
+  {
+    if(m_StartedAt[node] > lastUse && uses(node, path))
+    {
+      lastUse = m_StartedAt[node];
+    }
+  }
+  return m_Clock - lastUse >= m_IdleFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayCompressionManager::decompressArray(const DataContainerArray::Pointer& dca, const QString& key, int node)
+{
+  CompressedArray::Pointer compressed = m_Compressed.value(key);
+  DataArrayPath path = DataArrayPath::Deserialize(key, "|");
+  AttributeMatrix::Pointer am = dca->getAttributeMatrix(path);
+  if(am.get() == nullptr)
+  {
+    // A filter removed the attribute matrix, and the array with it
+    m_Compressed.remove(key);
+    return true;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  IDataArray::Pointer array = compressed->decompress();
+  if(array.get() == nullptr)
+  {
+    m_ErrorMessage = QObject::tr("Could not decompress '%1'").arg(path.serialize("/"));
+    return false;
+  }
+  am->addAttributeArray(path.getDataArrayName(), array);
+  m_Compressed.remove(key);
+  if(!writes(node, path))
+  {
+    m_Reusable.insert(key, compressed);
+  }
+
+  m_Stats.decompressedArrays++;
+  m_Stats.decompressMsecs += timer.elapsed();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayCompressionManager::restore(const DataContainerArray::Pointer& dca, int node)
+{
+  QStringList keys = m_Compressed.keys();
+  for(const QString& key : keys)
+  {
+    DataArrayPath path = DataArrayPath::Deserialize(key, "|");
+    if(!dca->doesDataContainerExist(path.getDataContainerName()) || !uses(node, path))
+    {
+      continue;
+    }
+    if(!decompressArray(dca, key, node))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ArrayCompressionManager::compressIdle(const DataContainerArray::Pointer& dca, int node)
+{
+  QString filterHumanLabel = m_Graph.filter(node)->getHumanLabel();
+  ArrayMemoryPool* pool = ArrayMemoryPool::Instance();
+  size_t savedBytes = 0;
+
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        DataArrayPath path(dc->getName(), am->getName(), name);
+        QString key = Key(path);
+        IDataArray::Pointer array = am->getAttributeArray(name);
+        size_t bytes = array->getSize() * array->getTypeSize();
+        if(m_Incompressible.contains(key) || array->getVoidPointer(0) == nullptr || pool->isFileBacked(array))
+        {
+          continue;
+        }
+        // Small arrays are only compressed when the user asked for it
+        if(!isFlagged(path) && (bytes < MinimumIdleBytes || !isIdle(path)))
+        {
+          continue;
+        }
+
+        // A filter that only lists the array as read may still have changed it in place, so the old copy
+        // is compared with the array before it is reused; decoding is much cheaper than encoding again
+        CompressedArray::Pointer compressed = m_Reusable.take(key);
+        if(compressed.get() != nullptr && compressed->matches(array))
+        {
+          m_Stats.reusedArrays++;
+        }
+        else
+        {
+          QElapsedTimer timer;
+          timer.start();
+          compressed = CompressedArray::Compress(array);
+          m_Stats.compressMsecs += timer.elapsed();
+          if(compressed.get() == nullptr || compressed->getRatio() < MinimumRatio)
+          {
+            m_Incompressible.insert(key);
+            continue;
+          }
+          m_Stats.compressedArrays++;
+          m_Stats.compressedBytes += bytes;
+          m_Stats.storedBytes += compressed->getCompressedBytes();
+        }
+
+        am->removeAttributeArray(name);
+        m_Compressed.insert(key, compressed);
+        savedBytes += bytes - compressed->getCompressedBytes();
+
+        CompressedArrayInfo info;
+        info.path = path;
+        info.bytes = bytes;
+        info.compressedBytes = compressed->getCompressedBytes();
+        info.filterHumanLabel = filterHumanLabel;
+        m_History.insert(key, info);
+      }
+    }
+  }
+
+  m_Stats.peakSavedBytes = std::max(m_Stats.peakSavedBytes, getSavedBytes());
+  return savedBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayCompressionManager::forget(const DataArrayPath& path)
+{
+  QString key = Key(path);
+  m_Reusable.remove(key);
+  m_Incompressible.remove(key);
+  return m_Compressed.remove(key) > 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayCompressionManager::isCompressed(const DataArrayPath& path) const
+{
+  return m_Compressed.contains(Key(path));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ArrayCompressionManager::getStoredBytes() const
+{
+  size_t bytes = 0;
+  for(const CompressedArray::Pointer& compressed : m_Compressed)
+  {
+    bytes += compressed->getCompressedBytes();
+  }
+  for(const CompressedArray::Pointer& compressed : m_Reusable)
+  {
+    bytes += compressed->getCompressedBytes();
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ArrayCompressionManager::getSavedBytes() const
+{
+  size_t bytes = 0;
+  for(const CompressedArray::Pointer& compressed : m_Compressed)
+  {
+    bytes += compressed->getBytes() - compressed->getCompressedBytes();
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayCompressionManager::addCompressedStructure(const DataContainerArray::Pointer& structure) const
+{
+  for(QMap<QString, CompressedArray::Pointer>::const_iterator iter = m_Compressed.constBegin(); iter != m_Compressed.constEnd(); ++iter)
+  {
+    DataArrayPath path = DataArrayPath::Deserialize(iter.key(), "|");
+    AttributeMatrix::Pointer am = structure->getAttributeMatrix(path);
+    if(am.get() != nullptr && !am->doesAttributeArrayExist(path.getDataArrayName()))
+    {
+      am->addAttributeArray(path.getDataArrayName(), iter.value()->getPrototype()->deepCopy(true));
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<CompressedArrayInfo> ArrayCompressionManager::getCompressedArrays() const
+{
+  return m_History.values().toVector();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ArrayCompressionManager::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+CompressionStats ArrayCompressionManager::getStats() const
+{
+  return m_Stats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList ArrayCompressionManager::report() const
+{
+  QStringList lines;
+  double ratio = m_Stats.storedBytes > 0 ? static_cast<double>(m_Stats.compressedBytes) / static_cast<double>(m_Stats.storedBytes) : 1.0;
+  lines.push_back(QObject::tr("Compressed %1 arrays (%2 to %3, %4x) in %5 ms, reused the compressed copy of %6 arrays, decompressed %7 times in %8 ms, saved at most %9 at once")
+                      .arg(m_Stats.compressedArrays)
+                      .arg(MemoryEstimator::FormatBytes(m_Stats.compressedBytes))
+                      .arg(MemoryEstimator::FormatBytes(m_Stats.storedBytes))
+                      .arg(ratio, 0, 'f', 1)
+                      .arg(m_Stats.compressMsecs)
+                      .arg(m_Stats.reusedArrays)
+                      .arg(m_Stats.decompressedArrays)
+                      .arg(m_Stats.decompressMsecs)
+                      .arg(MemoryEstimator::FormatBytes(m_Stats.peakSavedBytes)));
+  return lines;
+}
@@ -0,0 +1,245 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QMap>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+#include "Common/CompressedArray.h"
+#include "Common/PipelineDataFlowGraph.h"
+
+/**
+ * @brief The CompressionStats struct sums up what the ArrayCompressionManager did during one run
+ */
+struct CompressionStats
+{
+  int compressedArrays = 0;
+  size_t compressedBytes = 0;
+  size_t storedBytes = 0;
+  qint64 compressMsecs = 0;
+  int reusedArrays = 0;
+  int decompressedArrays = 0;
+  qint64 decompressMsecs = 0;
+  size_t peakSavedBytes = 0;
+};
+
+/**
+ * @brief The CompressedArrayInfo struct describes an array that was held compressed during a run
+ */
+struct CompressedArrayInfo
+{
+  DataArrayPath path;
+  size_t bytes = 0;
+  size_t compressedBytes = 0;
+  QString filterHumanLabel;
+};
+
+/**
+ * @brief The ArrayCompressionManager class holds the arrays of a running pipeline that are not being used
+ * in compressed form.
+ *
+ * After every filter, arrays that none of the last 'idle filters' filters read or wrote, and arrays the
+ * user flagged, are compressed into a CompressedArray and removed from their attribute matrix. Before a
+ * filter executes, restore() decompresses every array the filter reads or writes, and before a barrier
+ * every compressed array.
+ *
+ * Feature ids, phases and masks are mostly read once created, so the compressed copy of an array that was
+ * only read is kept and reused the next time the array goes idle instead of compressing it again. A filter
+ * that writes the array drops that copy, and since a filter may change a required array in place, the copy
+ * is only reused if its contents still match the array. Arrays that do not compress to at least MinimumRatio stay in memory.
+ */
+class ArrayCompressionManager
+{
+public:
+  static constexpr double MinimumRatio = 2.0;
+  static const size_t MinimumIdleBytes = 1024 * 1024;
+
+  /**
+   * @brief ArrayCompressionManager
+   * @param graph The graph of the pipeline, in the order the executor uses
+   * @param idleFilters How many filters in a row must not use an array before it is compressed, 0 to only
+   * compress flagged arrays
+   * @param flaggedPaths Arrays that are compressed whenever no filter is using them. A DataContainer or
+   * AttributeMatrix level path flags every array inside it.
+   */
+  ArrayCompressionManager(const PipelineDataFlowGraph& graph, int idleFilters, const QVector<DataArrayPath>& flaggedPaths);
+  virtual ~ArrayCompressionManager();
+
+  int getIdleFilters() const;
+
+  /**
+   * @brief markStarted Records that 'node' has started and drops the reusable compressed copies of the
+   * arrays it writes
+   * @param node
+   */
+  void markStarted(int node);
+
+  /**
+   * @brief restore Decompresses every compressed array of 'dca' that 'node' reads or writes, or every
+   * compressed array of 'dca' if the node is a barrier
+   * @param dca
+   * @param node
+   * @return false if an array could not be decompressed
+   */
+  bool restore(const DataContainerArray::Pointer& dca, int node);
+
+  /**
+   * @brief compressIdle Compresses the idle and flagged arrays of 'dca'
+   * @param dca The arrays that may be compressed
+   * @param node The node that has just finished
+   * @return The number of bytes the compression saved
+   */
+  size_t compressIdle(const DataContainerArray::Pointer& dca, int node);
+
+  /**
+   * @brief forget Drops the compressed copy of 'path', e.g. once it has been released after its last use
+   * @param path
+   * @return true if the array was compressed
+   */
+  bool forget(const DataArrayPath& path);
+
+  bool isCompressed(const DataArrayPath& path) const;
+
+  /**
+   * @brief getStoredBytes Returns the bytes the compressed arrays currently take
+   * @return
+   */
+  size_t getStoredBytes() const;
+
+  /**
+   * @brief getSavedBytes Returns the bytes the compressed arrays would take in addition if they were
+   * decompressed
+   * @return
+   */
+  size_t getSavedBytes() const;
+
+  /**
+   * @brief addCompressedStructure Adds the structure of every compressed array to 'structure', so a
+   * structural copy of the arrays shows them even while they are compressed
+   * @param structure
+   */
+  void addCompressedStructure(const DataContainerArray::Pointer& structure) const;
+
+  /**
+   * @brief getCompressedArrays Returns every array that was compressed during the run, with the size of
+   * its last compressed copy
+   * @return
+   */
+  QVector<CompressedArrayInfo> getCompressedArrays() const;
+
+  /**
+   * @brief getErrorMessage Returns why the last decompression failed
+   * @return
+   */
+  QString getErrorMessage() const;
+
+  CompressionStats getStats() const;
+
+  /**
+   * @brief report Returns the statistics as lines for a run report
+   * @return
+   */
+  QStringList report() const;
+
+protected:
+  /**
+   * @brief uses Returns true if 'node' reads or writes 'path'
+   * @param node
+   * @param path
+   * @return
+   */
+  bool uses(int node, const DataArrayPath& path) const;
+
+  /**
+   * @brief writes Returns true if 'node' writes 'path'
+   * @param node
+   * @param path
+   * @return
+   */
+  bool writes(int node, const DataArrayPath& path) const;
+
+  /**
+   * @brief isFlagged Returns true if the user asked to compress 'path' whenever it is not in use
+   * @param path
+   * @return
+   */
+  bool isFlagged(const DataArrayPath& path) const;
+
+  /**
+   * @brief isIdle Returns true if no filter used 'path' during the last idle filters
+   * @param path
+   * @return
+   */
+  bool isIdle(const DataArrayPath& path) const;
+
+  /**
+   * @brief decompressArray Puts the compressed array 'key' back into its attribute matrix in 'dca'
+   * @param dca
+   * @param key
+   * @param node The node that needs it; if the node only reads it, the compressed copy is kept for reuse
+   * @return
+   */
+  bool decompressArray(const DataContainerArray::Pointer& dca, const QString& key, int node);
+
+  static QString Key(const DataArrayPath& path);
+
+private:
+  PipelineDataFlowGraph m_Graph;
+  int m_IdleFilters = 0;
+  QVector<DataArrayPath> m_FlaggedPaths;
+
+  // The order in which the nodes started, 0 for nodes that have not
+  QVector<qint64> m_StartedAt;
+  qint64 m_Clock = 0;
+
+  // Arrays that are held compressed, and compressed copies of resident arrays no filter has written since
+  QMap<QString, CompressedArray::Pointer> m_Compressed;
+  QMap<QString, CompressedArray::Pointer> m_Reusable;
+  // Arrays that did not compress well enough, until a filter writes them
+  QSet<QString> m_Incompressible;
+  QMap<QString, CompressedArrayInfo> m_History;
+  CompressionStats m_Stats;
+  QString m_ErrorMessage;
+
+  ArrayCompressionManager(const ArrayCompressionManager&) = delete; // Copy Constructor Not Implemented
+  void operator=(const ArrayCompressionManager&) = delete;          // Move assignment Not Implemented
+};
@@ -0,0 +1,222 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ArrayLivenessAnalysis.h"
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayLivenessAnalysis::ArrayLivenessAnalysis() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayLivenessAnalysis::ArrayLivenessAnalysis(const PipelineDataFlowGraph& graph, const QVector<DataArrayPath>& keptPaths)
+{
+  int count = graph.size();
+  m_ReleasedAfter.fill(QVector<DataArrayPath>(), count);
+
+  QVector<int> createdBy;
+  for(int i = 0; i < count; i++)
+  {
+    for(const DataArrayPath& path : graph.footprint(i).writes)
+    {
+      if(!path.getDataArrayName().isEmpty() && indexOf(path) < 0)
+      {
+        m_Arrays.push_back(path);
+        m_LastUse.push_back(i);
+        m_Kept.push_back(false);
+        createdBy.push_back(i);
+      }
+    }
+  }
+
+  for(int a = 0; a < m_Arrays.size(); a++)
+  {
+    const DataArrayPath& array = m_Arrays[a];
+    for(int j = createdBy[a] + 1; j < count; j++)
+    {
+      const FilterDataFootprint& footprint = graph.footprint(j);
+      bool used = footprint.barrier;
+      for(int r = 0; r < footprint.reads.size() && !used; r++)
+      {
+        used = PipelineDataFlowGraph::PathsOverlap(footprint.reads[r], array);
+      }
+      for(int w = 0; w < footprint.writes.size() && !used; w++)
+      {
+        used = PipelineDataFlowGraph::PathsOverlap(footprint.writes[w], array);
+      }
+
+      if(used)
+      {
+        m_LastUse[a] = j;
+        if(IsWriterFilter(graph.filter(j)))
+        {
+          m_Kept[a] = true;
+        }
+      }
+    }
+
+    for(const DataArrayPath& keptPath : keptPaths)
+    {
+      if(PipelineDataFlowGraph::PathCovers(keptPath, array))
+      {
+        m_Kept[a] = true;
+      }
+    }
+
+    // Releasing after the final filter would only empty the results without lowering the peak
+    if(!m_Kept[a] && m_LastUse[a] < count - 1)
+    {
+      m_ReleasedAfter[m_LastUse[a]].push_back(array);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayLivenessAnalysis::~ArrayLivenessAnalysis() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayLivenessAnalysis::IsWriterFilter(const AbstractFilter::Pointer& filter)
+{
+  return filter->getSubGroupName() == SIMPL::FilterSubGroups::OutputFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ArrayLivenessAnalysis::ArrayBytes(const DataContainerArray::Pointer& dca, const DataArrayPath& path)
+{
+  DataContainer::Pointer dc = dca->getDataContainer(path.getDataContainerName());
+  if(dc.get() == nullptr)
+  {
+    return 0;
+  }
+  AttributeMatrix::Pointer am = dc->getAttributeMatrix(path.getAttributeMatrixName());
+  if(am.get() == nullptr)
+  {
+    return 0;
+  }
+  IDataArray::Pointer array = am->getAttributeArray(path.getDataArrayName());
+  if(array.get() == nullptr)
+  {
+    return 0;
+  }
+  return array->getSize() * array->getTypeSize();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ArrayLivenessAnalysis::TotalArrayBytes(const DataContainerArray::Pointer& dca)
+{
+  size_t total = 0;
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::AttributeMatrixMap_t& matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        IDataArray::Pointer array = am->getAttributeArray(name);
+        total += array->getSize() * array->getTypeSize();
+      }
+    }
+  }
+  return total;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<DataArrayPath> ArrayLivenessAnalysis::trackedArrays() const
+{
+  return m_Arrays;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ArrayLivenessAnalysis::lastUse(const DataArrayPath& path) const
+{
+  int index = indexOf(path);
+  return index < 0 ? -1 : m_LastUse[index];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayLivenessAnalysis::isKept(const DataArrayPath& path) const
+{
+  int index = indexOf(path);
+  return index < 0 ? true : m_Kept[index];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<DataArrayPath> ArrayLivenessAnalysis::releasedAfter(int node) const
+{
+  if(node < 0 || node >= m_ReleasedAfter.size())
+  {
+    return QVector<DataArrayPath>();
+  }
+  return m_ReleasedAfter[node];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ArrayLivenessAnalysis::indexOf(const DataArrayPath& path) const
+{
+  for(int i = 0; i < m_Arrays.size(); i++)
+  {
+    if(m_Arrays[i] == path)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
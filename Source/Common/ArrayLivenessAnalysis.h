@@ -0,0 +1,120 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+#include "Common/PipelineDataFlowGraph.h"
+
+/**
+ * @brief The ArrayLivenessAnalysis class computes the last use of every DataArray that is created by
+ * a pipeline so that the array can be released as soon as no later filter reads it.
+ *
+ * An array is live from the filter that creates it until the last filter whose required or created
+ * paths overlap it. Reads at the AttributeMatrix or DataContainer level keep every array inside
+ * them alive. Barrier filters may read anything and so extend the life of every array created before
+ * them. Arrays are never released when they are read by an output (writer) filter, when the user
+ * has marked them to be kept, or when their last use is the final filter of the pipeline.
+ */
+class ArrayLivenessAnalysis
+{
+public:
+  ArrayLivenessAnalysis();
+  ArrayLivenessAnalysis(const PipelineDataFlowGraph& graph, const QVector<DataArrayPath>& keptPaths);
+  virtual ~ArrayLivenessAnalysis();
+
+  /**
+   * @brief IsWriterFilter Returns true if the filter writes data out of the pipeline
+   * @param filter
+   * @return
+   */
+  static bool IsWriterFilter(const AbstractFilter::Pointer& filter);
+
+  /**
+   * @brief ArrayBytes Returns the number of bytes allocated for the array at 'path' or 0 if it does not exist
+   * @param dca
+   * @param path
+   * @return
+   */
+  static size_t ArrayBytes(const DataContainerArray::Pointer& dca, const DataArrayPath& path);
+
+  /**
+   * @brief TotalArrayBytes Returns the number of bytes allocated for all arrays in the DataContainerArray
+   * @param dca
+   * @return
+   */
+  static size_t TotalArrayBytes(const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief trackedArrays Returns every DataArray path created by the pipeline
+   * @return
+   */
+  QVector<DataArrayPath> trackedArrays() const;
+
+  /**
+   * @brief lastUse Returns the node index of the last filter that uses the array or -1 if the array is not tracked
+   * @param path
+   * @return
+   */
+  int lastUse(const DataArrayPath& path) const;
+
+  /**
+   * @brief isKept Returns true if the array must stay in the DataContainerArray until the end of the run
+   * @param path
+   * @return
+   */
+  bool isKept(const DataArrayPath& path) const;
+
+  /**
+   * @brief releasedAfter Returns the arrays that may be released once the filter at 'node' has finished
+   * @param node
+   * @return
+   */
+  QVector<DataArrayPath> releasedAfter(int node) const;
+
+private:
+  QVector<DataArrayPath> m_Arrays;
+  QVector<int> m_LastUse;
+  QVector<bool> m_Kept;
+  QVector<QVector<DataArrayPath>> m_ReleasedAfter;
+
+  int indexOf(const DataArrayPath& path) const;
+};
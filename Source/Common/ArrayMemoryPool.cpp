@@ -0,0 +1,713 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ArrayMemoryPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+
+#include "Common/MemoryEstimator.h"
+#include "Common/NumaTopology.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T> IDataArray::Pointer WrapBlock(void* block, size_t numTuples, const QVector<size_t>& cDims, const QString& name)
+{
+  return DataArray<T>::WrapPointer(static_cast<T*>(block), numTuples, cDims, name, false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T> IDataArray::Pointer CreateUnpooled(size_t numTuples, const QVector<size_t>& cDims, const QString& name)
+{
+  typename DataArray<T>::Pointer array = DataArray<T>::CreateArray(numTuples, cDims, name, true);
+  array->initializeWithZeros();
+  return array;
+}
+
+using WrapFunction = IDataArray::Pointer (*)(void*, size_t, const QVector<size_t>&, const QString&);
+using CreateFunction = IDataArray::Pointer (*)(size_t, const QVector<size_t>&, const QString&);
+
+struct TypeFunctions
+{
+  const char* typeName;
+  size_t typeSize;
+  WrapFunction wrap;
+  CreateFunction create;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const TypeFunctions* FindTypeFunctions(const QString& typeName)
+{
+  static const TypeFunctions functions[] = {
+      {"int8_t", sizeof(int8_t), &WrapBlock<int8_t>, &CreateUnpooled<int8_t>},
+      {"uint8_t", sizeof(uint8_t), &WrapBlock<uint8_t>, &CreateUnpooled<uint8_t>},
+      {"int16_t", sizeof(int16_t), &WrapBlock<int16_t>, &CreateUnpooled<int16_t>},
+      {"uint16_t", sizeof(uint16_t), &WrapBlock<uint16_t>, &CreateUnpooled<uint16_t>},
+      {"int32_t", sizeof(int32_t), &WrapBlock<int32_t>, &CreateUnpooled<int32_t>},
+      {"uint32_t", sizeof(uint32_t), &WrapBlock<uint32_t>, &CreateUnpooled<uint32_t>},
+      {"int64_t", sizeof(int64_t), &WrapBlock<int64_t>, &CreateUnpooled<int64_t>},
+      {"uint64_t", sizeof(uint64_t), &WrapBlock<uint64_t>, &CreateUnpooled<uint64_t>},
+      {"float", sizeof(float), &WrapBlock<float>, &CreateUnpooled<float>},
+      {"double", sizeof(double), &WrapBlock<double>, &CreateUnpooled<double>},
+      {"bool", sizeof(bool), &WrapBlock<bool>, &CreateUnpooled<bool>},
+  };
+
+  for(const TypeFunctions& entry : functions)
+  {
+    if(typeName == entry.typeName)
+    {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayMemoryPool::ArrayMemoryPool() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayMemoryPool::~ArrayMemoryPool()
+{
+  // Blocks of arrays that are still alive at exit are left to the operating system
+  QMutexLocker locker(&m_Mutex);
+  shrink(0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayMemoryPool* ArrayMemoryPool::Instance()
+{
+  static ArrayMemoryPool pool;
+  return &pool;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayMemoryPool::HugePagesSupported()
+{
+#if defined(Q_OS_LINUX)
+  static const bool supported = [] {
+    QFile file("/sys/kernel/mm/transparent_hugepage/enabled");
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+      return false;
+    }
+    // The active mode is the one in brackets, e.g. "always [madvise] never"
+    return !QString::fromLatin1(file.readAll()).contains("[never]");
+  }();
+  return supported;
+#else
+  return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ArrayMemoryPool::SizeClass(size_t bytes)
+{
+  if(bytes == 0)
+  {
+    return 0;
+  }
+
+  // Four classes per power of two keep the waste of a block below a quarter of its size
+  size_t power = 1;
+  while(power <= bytes / 2)
+  {
+    power *= 2;
+  }
+  size_t step = std::max(power / 4, static_cast<size_t>(64 * 1024));
+  if(bytes >= HugePageBytes)
+  {
+    step = std::max(step, HugePageBytes);
+  }
+  return (bytes + step - 1) / step * step;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryPool::setRetentionCap(size_t bytes)
+{
+  QMutexLocker locker(&m_Mutex);
+  m_RetentionCap = bytes;
+  shrink(m_RetentionCap);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ArrayMemoryPool::getRetentionCap() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_RetentionCap;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryPool::setHugePages(bool enabled)
+{
+  QMutexLocker locker(&m_Mutex);
+  m_HugePages = enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayMemoryPool::getHugePages() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_HugePages;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer ArrayMemoryPool::createArray(const QString& typeName, size_t numTuples, const QVector<size_t>& cDims, const QString& name)
+{
+  const TypeFunctions* functions = FindTypeFunctions(typeName);
+  if(functions == nullptr)
+  {
+    return IDataArray::NullPointer();
+  }
+
+  size_t components = 1;
+  for(size_t dim : cDims)
+  {
+    components *= dim;
+  }
+  size_t bytes = numTuples * components * functions->typeSize;
+  if(bytes < MinimumPooledBytes)
+  {
+    QMutexLocker locker(&m_Mutex);
+    m_Stats.unpooled++;
+    locker.unlock();
+    return functions->create(numTuples, cDims, name);
+  }
+
+  // Blocks of arrays destroyed since the last allocation are the most likely to fit
+  collect();
+
+  size_t classBytes = 0;
+  void* block = acquire(bytes, &classBytes);
+  if(block == nullptr)
+  {
+    return functions->create(numTuples, cDims, name);
+  }
+
+  IDataArray::Pointer array = functions->wrap(block, numTuples, cDims, name);
+  lease(array, block, classBytes);
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer ArrayMemoryPool::createArrayLike(const IDataArray::Pointer& prototype, size_t numTuples, const QString& name)
+{
+  IDataArray::Pointer array = createArray(prototype->getTypeAsString(), numTuples, prototype->getComponentDimensions(), name);
+  if(array.get() == nullptr)
+  {
+    array = prototype->createNewArray(numTuples, prototype->getComponentDimensions(), name, true);
+  }
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer ArrayMemoryPool::mapFile(const QString& filePath, quint64 offset, const QString& typeName, size_t numTuples, const QVector<size_t>& cDims, const QString& name,
+                                             bool copyOnWrite)
+{
+  const TypeFunctions* functions = FindTypeFunctions(typeName);
+  if(functions == nullptr)
+  {
+    return IDataArray::NullPointer();
+  }
+
+  size_t components = 1;
+  for(size_t dim : cDims)
+  {
+    components *= dim;
+  }
+  size_t bytes = numTuples * components * functions->typeSize;
+  // Touching a mapped page beyond the end of the file is a bus error rather than an error code
+  if(bytes == 0 || static_cast<quint64>(QFileInfo(filePath).size()) < offset + bytes)
+  {
+    return IDataArray::NullPointer();
+  }
+
+  size_t head = 0;
+  void* mapping = MapFileRange(filePath, offset, bytes, copyOnWrite, &head);
+  if(mapping == nullptr)
+  {
+    return IDataArray::NullPointer();
+  }
+
+  IDataArray::Pointer array = functions->wrap(static_cast<char*>(mapping) + head, numTuples, cDims, name);
+  Lease lease;
+  lease.array = array;
+  lease.block = mapping;
+  lease.classBytes = head + bytes;
+  lease.backing = Backing::File;
+
+  QMutexLocker locker(&m_Mutex);
+  m_Leases.push_back(lease);
+  m_Stats.fileMappedBytes += lease.classBytes;
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer ArrayMemoryPool::createScratchArray(const IDataArray::Pointer& prototype, size_t numTuples, const QString& name, const QString& directory)
+{
+  const TypeFunctions* functions = FindTypeFunctions(prototype->getTypeAsString());
+  if(functions == nullptr)
+  {
+    return IDataArray::NullPointer();
+  }
+
+  QVector<size_t> cDims = prototype->getComponentDimensions();
+  size_t components = 1;
+  for(size_t dim : cDims)
+  {
+    components *= dim;
+  }
+  size_t bytes = numTuples * components * functions->typeSize;
+  void* mapping = (bytes > 0) ? MapScratchFile(directory.isEmpty() ? QDir::tempPath() : directory, bytes) : nullptr;
+  if(mapping == nullptr)
+  {
+    return IDataArray::NullPointer();
+  }
+
+  IDataArray::Pointer array = functions->wrap(mapping, numTuples, cDims, name);
+  Lease lease;
+  lease.array = array;
+  lease.block = mapping;
+  lease.classBytes = bytes;
+  lease.backing = Backing::Scratch;
+
+  QMutexLocker locker(&m_Mutex);
+  m_Leases.push_back(lease);
+  m_Stats.scratchBytes += bytes;
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArrayMemoryPool::isFileBacked(const IDataArray::Pointer& array) const
+{
+  QMutexLocker locker(&m_Mutex);
+  for(const Lease& lease : m_Leases)
+  {
+    if(lease.backing != Backing::Pool && lease.array.lock() == array)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void* ArrayMemoryPool::acquire(size_t bytes, size_t* classBytes)
+{
+  *classBytes = SizeClass(bytes);
+
+  QMutexLocker locker(&m_Mutex);
+  QMap<size_t, QVector<void*>>::iterator iter = m_FreeBlocks.find(*classBytes);
+  if(iter != m_FreeBlocks.end() && !iter.value().isEmpty())
+  {
+    void* block = iter.value().takeLast();
+    m_Stats.hits++;
+    m_Stats.retainedBytes -= *classBytes;
+    m_Stats.outstandingBytes += *classBytes;
+    locker.unlock();
+
+    // Touching the pages of a reused block costs no page faults, so zeroing it is cheap
+    NumaTopology::Instance()->firstTouch(block, bytes);
+    return block;
+  }
+
+  bool hugePages = m_HugePages && HugePagesSupported() && *classBytes % HugePageBytes == 0;
+  m_Stats.misses++;
+  locker.unlock();
+
+  bool advised = false;
+  void* block = MapBlock(*classBytes, hugePages, &advised);
+  if(block == nullptr)
+  {
+    // Give the retained blocks back and try once more before falling back to the regular allocator
+    trim();
+    block = MapBlock(*classBytes, hugePages, &advised);
+    if(block == nullptr)
+    {
+      return nullptr;
+    }
+  }
+
+  // A fresh block reads as zeros already, but its pages only land on a NUMA node once they are touched.
+  // Touching them with the threads that will work on them keeps every slice local to its thread.
+  NumaTopology* topology = NumaTopology::Instance();
+  bool firstTouch = topology->getFirstTouch() && topology->getNodeCount() > 1;
+  if(firstTouch)
+  {
+    topology->firstTouch(block, bytes);
+  }
+
+  locker.relock();
+  m_Stats.outstandingBytes += *classBytes;
+  if(advised)
+  {
+    m_Stats.hugePageBytes += *classBytes;
+  }
+  if(firstTouch)
+  {
+    m_Stats.firstTouchedBytes += bytes;
+  }
+  return block;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryPool::lease(const IDataArray::Pointer& array, void* block, size_t classBytes)
+{
+  Lease lease;
+  lease.array = array;
+  lease.block = block;
+  lease.classBytes = classBytes;
+
+  QMutexLocker locker(&m_Mutex);
+  m_Leases.push_back(lease);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryPool::collect()
+{
+  QMutexLocker locker(&m_Mutex);
+  for(int i = m_Leases.size() - 1; i >= 0; i--)
+  {
+    const Lease& lease = m_Leases[i];
+    if(!lease.array.expired())
+    {
+      continue;
+    }
+    switch(lease.backing)
+    {
+    case Backing::Pool:
+      m_Stats.outstandingBytes -= lease.classBytes;
+      release(lease.block, lease.classBytes);
+      break;
+    case Backing::File:
+      m_Stats.fileMappedBytes -= lease.classBytes;
+      UnmapFile(lease.block, lease.classBytes);
+      break;
+    case Backing::Scratch:
+      m_Stats.scratchBytes -= lease.classBytes;
+      UnmapFile(lease.block, lease.classBytes);
+      break;
+    }
+    m_Leases.remove(i);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryPool::release(void* block, size_t classBytes)
+{
+  if(m_Stats.retainedBytes + classBytes <= m_RetentionCap)
+  {
+    m_FreeBlocks[classBytes].push_back(block);
+    m_Stats.retainedBytes += classBytes;
+    return;
+  }
+
+  UnmapBlock(block, classBytes);
+  m_Stats.returnedBytes += classBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryPool::trim()
+{
+  QMutexLocker locker(&m_Mutex);
+  shrink(0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryPool::shrink(size_t bytes)
+{
+  // The largest blocks go first, they are the least likely to be asked for again
+  while(m_Stats.retainedBytes > bytes && !m_FreeBlocks.isEmpty())
+  {
+    QMap<size_t, QVector<void*>>::iterator iter = m_FreeBlocks.end();
+    --iter;
+    if(iter.value().isEmpty())
+    {
+      m_FreeBlocks.erase(iter);
+      continue;
+    }
+    UnmapBlock(iter.value().takeLast(), iter.key());
+    m_Stats.retainedBytes -= iter.key();
+    m_Stats.returnedBytes += iter.key();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void* ArrayMemoryPool::MapBlock(size_t bytes, bool hugePages, bool* advised)
+{
+  *advised = false;
+#if defined(Q_OS_WIN)
+  Q_UNUSED(hugePages)
+  // Large pages on Windows need the lock pages privilege, which normal users do not have
+  return VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+  if(!hugePages)
+  {
+    void* block = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (block == MAP_FAILED) ? nullptr : block;
+  }
+
+  // Only whole, aligned huge pages can back a mapping, so map one page more and cut off both ends
+  size_t mappedBytes = bytes + HugePageBytes;
+  char* mapped = static_cast<char*>(mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  if(mapped == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  size_t head = (HugePageBytes - reinterpret_cast<uintptr_t>(mapped) % HugePageBytes) % HugePageBytes;
+  size_t tail = mappedBytes - head - bytes;
+  if(head > 0)
+  {
+    munmap(mapped, head);
+  }
+  if(tail > 0)
+  {
+    munmap(mapped + head + bytes, tail);
+  }
+  char* block = mapped + head;
+#if defined(MADV_HUGEPAGE)
+  *advised = (madvise(block, bytes, MADV_HUGEPAGE) == 0);
+#endif
+  return block;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryPool::UnmapBlock(void* block, size_t bytes)
+{
+#if defined(Q_OS_WIN)
+  Q_UNUSED(bytes)
+  VirtualFree(block, 0, MEM_RELEASE);
+#else
+  munmap(block, bytes);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void* ArrayMemoryPool::MapFileRange(const QString& filePath, quint64 offset, size_t bytes, bool copyOnWrite, size_t* head)
+{
+#if defined(Q_OS_WIN)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  quint64 start = offset - offset % info.dwAllocationGranularity;
+  *head = static_cast<size_t>(offset - start);
+
+  HANDLE file = CreateFileW(reinterpret_cast<const wchar_t*>(filePath.utf16()), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(file == INVALID_HANDLE_VALUE)
+  {
+    return nullptr;
+  }
+  HANDLE section = CreateFileMappingW(file, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if(section == nullptr)
+  {
+    return nullptr;
+  }
+  // The view keeps the section and the file open after their handles are closed
+  void* mapping = MapViewOfFile(section, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, static_cast<DWORD>(start >> 32), static_cast<DWORD>(start & 0xFFFFFFFF), *head + bytes);
+  CloseHandle(section);
+  return mapping;
+#else
+  quint64 pageBytes = static_cast<quint64>(sysconf(_SC_PAGESIZE));
+  quint64 start = offset - offset % pageBytes;
+  *head = static_cast<size_t>(offset - start);
+
+  int fd = open(filePath.toLocal8Bit().constData(), O_RDONLY | O_CLOEXEC);
+  if(fd < 0)
+  {
+    return nullptr;
+  }
+  int protection = copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  void* mapping = mmap(nullptr, *head + bytes, protection, copyOnWrite ? MAP_PRIVATE : MAP_SHARED, fd, static_cast<off_t>(start));
+  close(fd);
+  return (mapping == MAP_FAILED) ? nullptr : mapping;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void* ArrayMemoryPool::MapScratchFile(const QString& directory, size_t bytes)
+{
+#if defined(Q_OS_WIN)
+  static QAtomicInt counter;
+  QString filePath = QDir(directory).absoluteFilePath(QString("SIMPLView-scratch-%1-%2.bin").arg(GetCurrentProcessId()).arg(counter.fetchAndAddRelaxed(1)));
+  HANDLE file = CreateFileW(reinterpret_cast<const wchar_t*>(filePath.utf16()), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+                            nullptr);
+  if(file == INVALID_HANDLE_VALUE)
+  {
+    return nullptr;
+  }
+  quint64 size = bytes;
+  HANDLE section = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+  CloseHandle(file);
+  if(section == nullptr)
+  {
+    return nullptr;
+  }
+  // The file is deleted once the view, which holds the last reference to it, is unmapped
+  void* mapping = MapViewOfFile(section, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+  CloseHandle(section);
+  return mapping;
+#else
+  QByteArray pathTemplate = QDir(directory).absoluteFilePath("SIMPLView-scratch-XXXXXX").toLocal8Bit();
+  int fd = mkstemp(pathTemplate.data());
+  if(fd < 0)
+  {
+    return nullptr;
+  }
+  // Without a name the file goes away with its last mapping, even if the process crashes
+  unlink(pathTemplate.constData());
+  void* mapping = MAP_FAILED;
+  if(ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+  {
+    mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  return (mapping == MAP_FAILED) ? nullptr : mapping;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryPool::UnmapFile(void* mapping, size_t bytes)
+{
+#if defined(Q_OS_WIN)
+  Q_UNUSED(bytes)
+  UnmapViewOfFile(mapping);
+#else
+  munmap(mapping, bytes);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayMemoryPool::Stats ArrayMemoryPool::getStats() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_Stats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ArrayMemoryPool::summary() const
+{
+  Stats stats = getStats();
+  return QObject::tr("Array pool: %1 hits, %2 misses, %3 retained of %4, %5 in use, %6 returned to the system, %7 mapped as huge pages, %8 mapped from files, %9 in scratch files, %10 first touched in parallel")
+      .arg(stats.hits)
+      .arg(stats.misses)
+      .arg(MemoryEstimator::FormatBytes(stats.retainedBytes))
+      .arg(MemoryEstimator::FormatBytes(getRetentionCap()))
+      .arg(MemoryEstimator::FormatBytes(stats.outstandingBytes))
+      .arg(MemoryEstimator::FormatBytes(stats.returnedBytes))
+      .arg(MemoryEstimator::FormatBytes(stats.hugePageBytes))
+      .arg(MemoryEstimator::FormatBytes(stats.fileMappedBytes))
+      .arg(MemoryEstimator::FormatBytes(stats.scratchBytes))
+      .arg(MemoryEstimator::FormatBytes(stats.firstTouchedBytes));
+}
@@ -0,0 +1,291 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <memory>
+
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataArrays/IDataArray.h"
+
+/**
+ * @brief The ArrayMemoryPool class hands out the storage of the arrays the pipeline engine allocates and keeps
+ * it once they are destroyed, so the next run can reuse it instead of asking the operating system again.
+ *
+ * Blocks are mapped directly from the operating system and grouped into size classes, four per power of two,
+ * so an array of about the same size as a destroyed one gets its block back. Large blocks are aligned to and
+ * advised as transparent huge pages where the kernel supports them. When an array is destroyed its block is
+ * retained until the retained bytes reach the retention cap; anything beyond that is returned to the system.
+ *
+ * A reused block is zeroed before it is handed out, like freshly mapped memory. On machines with several
+ * NUMA nodes fresh blocks are zeroed too, in parallel, so their pages are placed by the threads of the
+ * allocating filter; see NumaTopology::firstTouch().
+ *
+ * The arrays wrap their block without owning it; collect() finds the arrays that have been destroyed and
+ * takes their blocks back.
+ *
+ * Arrays smaller than MinimumPooledBytes, and types that are not plain numbers, are allocated as usual.
+ *
+ * The pool also hands out arrays backed by files instead of anonymous memory: mapFile() maps values stored
+ * in a file directly, and createScratchArray() maps an unnamed temporary file. Their mappings are never
+ * retained; collect() unmaps them once their arrays have been destroyed.
+ */
+class ArrayMemoryPool
+{
+public:
+  /**
+   * @brief The Stats struct counts what the pool did since it was created
+   */
+  struct Stats
+  {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t unpooled = 0;
+    size_t retainedBytes = 0;
+    size_t outstandingBytes = 0;
+    size_t hugePageBytes = 0;
+    size_t returnedBytes = 0;
+    size_t fileMappedBytes = 0;
+    size_t scratchBytes = 0;
+    size_t firstTouchedBytes = 0;
+  };
+
+  static const size_t MinimumPooledBytes = 1024 * 1024;
+  static const size_t HugePageBytes = 2 * 1024 * 1024;
+  static const size_t DefaultRetentionCap = 1024 * 1024 * 1024;
+
+  /**
+   * @brief Instance Returns the process-wide pool
+   * @return
+   */
+  static ArrayMemoryPool* Instance();
+
+  /**
+   * @brief HugePagesSupported Returns true if the kernel can back large blocks with transparent huge pages
+   * @return
+   */
+  static bool HugePagesSupported();
+
+  /**
+   * @brief SizeClass Returns the size of the block an allocation of 'bytes' gets
+   * @param bytes
+   * @return
+   */
+  static size_t SizeClass(size_t bytes);
+
+  /**
+   * @brief setRetentionCap Sets the bytes of destroyed arrays the pool keeps for reuse and returns anything
+   * beyond it to the system
+   * @param bytes
+   */
+  void setRetentionCap(size_t bytes);
+  size_t getRetentionCap() const;
+
+  /**
+   * @brief setHugePages Sets whether new blocks are backed by huge pages where supported
+   * @param enabled
+   */
+  void setHugePages(bool enabled);
+  bool getHugePages() const;
+
+  /**
+   * @brief createArray Returns a zeroed array of the type named 'typeName', e.g. "float", or null if the
+   * type is not a plain number
+   * @param typeName
+   * @param numTuples
+   * @param cDims
+   * @param name
+   * @return
+   */
+  IDataArray::Pointer createArray(const QString& typeName, size_t numTuples, const QVector<size_t>& cDims, const QString& name);
+
+  /**
+   * @brief createArrayLike Returns a zeroed array with the type and components of 'prototype'. Types the
+   * pool cannot hold are created by the prototype.
+   * @param prototype
+   * @param numTuples
+   * @param name
+   * @return
+   */
+  IDataArray::Pointer createArrayLike(const IDataArray::Pointer& prototype, size_t numTuples, const QString& name);
+
+  /**
+   * @brief mapFile Returns an array whose values are mapped from byte 'offset' of the file at 'filePath'
+   * instead of read, so pages are only read once they are touched. Writing to a read-only mapping crashes;
+   * a copy-on-write mapping keeps written pages private to the process and never changes the file.
+   * @param filePath
+   * @param offset
+   * @param typeName
+   * @param numTuples
+   * @param cDims
+   * @param name
+   * @param copyOnWrite
+   * @return null if the type is not a plain number or the file cannot be mapped
+   */
+  IDataArray::Pointer mapFile(const QString& filePath, quint64 offset, const QString& typeName, size_t numTuples, const QVector<size_t>& cDims, const QString& name, bool copyOnWrite);
+
+  /**
+   * @brief createScratchArray Returns a zeroed array backed by an unnamed temporary file in 'directory', the
+   * system temporary directory if empty. Under memory pressure its pages are written to that file instead
+   * of to swap.
+   * @param prototype
+   * @param numTuples
+   * @param name
+   * @param directory
+   * @return null if the type is not a plain number or the file cannot be created
+   */
+  IDataArray::Pointer createScratchArray(const IDataArray::Pointer& prototype, size_t numTuples, const QString& name, const QString& directory);
+
+  /**
+   * @brief isFileBacked Returns true if 'array' was created by mapFile() or createScratchArray()
+   * @param array
+   * @return
+   */
+  bool isFileBacked(const IDataArray::Pointer& array) const;
+
+  /**
+   * @brief collect Takes back the blocks of every destroyed array
+   */
+  void collect();
+
+  /**
+   * @brief trim Returns every retained block to the system
+   */
+  void trim();
+
+  Stats getStats() const;
+
+  /**
+   * @brief summary Returns one line with the statistics, e.g. for a run report
+   * @return
+   */
+  QString summary() const;
+
+protected:
+  ArrayMemoryPool();
+  virtual ~ArrayMemoryPool();
+
+  /**
+   * @brief acquire Returns a zeroed block for 'bytes', retained or newly mapped, or null if the system has
+   * no memory left
+   * @param bytes
+   * @param classBytes Set to the size of the block
+   * @return
+   */
+  void* acquire(size_t bytes, size_t* classBytes);
+
+  /**
+   * @brief lease Records that 'array' wraps 'block' so collect() can take it back
+   * @param array
+   * @param block
+   * @param classBytes
+   */
+  void lease(const IDataArray::Pointer& array, void* block, size_t classBytes);
+
+  /**
+   * @brief release Retains 'block' or returns it to the system. Called with the mutex held.
+   * @param block
+   * @param classBytes
+   */
+  void release(void* block, size_t classBytes);
+
+  /**
+   * @brief shrink Returns retained blocks to the system until the retained bytes fit 'bytes'. Called with
+   * the mutex held.
+   * @param bytes
+   */
+  void shrink(size_t bytes);
+
+  /**
+   * @brief MapBlock Maps 'bytes' of zeroed memory, aligned to and advised as huge pages if 'hugePages'
+   * @param bytes
+   * @param hugePages
+   * @param advised Set to true if the block was advised as huge pages
+   * @return
+   */
+  static void* MapBlock(size_t bytes, bool hugePages, bool* advised);
+  static void UnmapBlock(void* block, size_t bytes);
+
+  /**
+   * @brief MapFileRange Maps 'bytes' from 'offset' of 'filePath'. The mapping starts at the page boundary
+   * before 'offset'; 'head' is set to the distance from there to 'offset'.
+   * @param filePath
+   * @param offset
+   * @param bytes
+   * @param copyOnWrite
+   * @param head
+   * @return
+   */
+  static void* MapFileRange(const QString& filePath, quint64 offset, size_t bytes, bool copyOnWrite, size_t* head);
+
+  /**
+   * @brief MapScratchFile Maps 'bytes' of a new temporary file in 'directory' that is deleted once unmapped
+   * @param directory
+   * @param bytes
+   * @return
+   */
+  static void* MapScratchFile(const QString& directory, size_t bytes);
+  static void UnmapFile(void* mapping, size_t bytes);
+
+private:
+  enum class Backing
+  {
+    Pool,
+    File,
+    Scratch
+  };
+
+  struct Lease
+  {
+    std::weak_ptr<IDataArray> array;
+    void* block = nullptr;
+    size_t classBytes = 0;
+    Backing backing = Backing::Pool;
+  };
+
+  mutable QMutex m_Mutex;
+  size_t m_RetentionCap = DefaultRetentionCap;
+  bool m_HugePages = true;
+  QMap<size_t, QVector<void*>> m_FreeBlocks;
+  QVector<Lease> m_Leases;
+  Stats m_Stats;
+
+  ArrayMemoryPool(const ArrayMemoryPool&) = delete; // Copy Constructor Not Implemented
+  void operator=(const ArrayMemoryPool&) = delete;  // Move assignment Not Implemented
+};
@@ -0,0 +1,494 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ArraySpillManager.h"
+
+#include <algorithm>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "Common/ArrayLivenessAnalysis.h"
+#include "Common/ArrayMemoryPool.h"
+#include "Common/HDF5Lock.h"
+#include "Common/MemoryEstimator.h"
+#include "Common/SlabFileReader.h"
+
+namespace
+{
+// Arrays smaller than this are not worth a round trip through the file
+const size_t k_MinimumSpillBytes = 1024 * 1024;
+
+struct SpillCandidate
+{
+  DataArrayPath path;
+  size_t bytes = 0;
+  int nextUse = 0;
+  qint64 lastUse = 0;
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArraySpillManager::ArraySpillManager(const PipelineDataFlowGraph& graph, size_t memoryLimit)
+: m_Graph(graph)
+, m_MemoryLimit(memoryLimit)
+, m_StartedAt(graph.size(), 0)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArraySpillManager::~ArraySpillManager()
+{
+  if(m_FileId >= 0)
+  {
+    QMutexLocker locker(HDF5Lock::Mutex());
+    H5Fclose(m_FileId);
+    QFile::remove(m_FilePath);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ArraySpillManager::getMemoryLimit() const
+{
+  return m_MemoryLimit;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArraySpillManager::setDirectory(const QString& directory)
+{
+  m_Directory = directory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ArraySpillManager::Key(const DataArrayPath& path)
+{
+  return path.serialize("|");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArraySpillManager::markStarted(int node)
+{
+  if(node >= 0 && node < m_StartedAt.size())
+  {
+    m_StartedAt[node] = ++m_Clock;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArraySpillManager::uses(int node, const DataArrayPath& path) const
+{
+  const FilterDataFootprint& footprint = m_Graph.footprint(node);
+  if(footprint.barrier)
+  {
+    return true;
+  }
+  for(const DataArrayPath& read : footprint.reads)
+  {
+    if(PipelineDataFlowGraph::PathsOverlap(read, path))
+    {
+      return true;
+    }
+  }
+  for(const DataArrayPath& write : footprint.writes)
+  {
+    if(PipelineDataFlowGraph::PathsOverlap(write, path))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ArraySpillManager::nextUse(const DataArrayPath& path) const
+{
+  for(int node = 0; node < m_StartedAt.size(); node++)
+  {
+    if(m_StartedAt[node] == 0 && uses(node, path))
+    {
+      return node;
+    }
+  }
+  return m_StartedAt.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 ArraySpillManager::lastUse(const DataArrayPath& path) const
+{
+  qint64 last = 0;
+  for(int node = 0; node < m_StartedAt.size(); node++)
+  {
+    if(m_StartedAt[node] > last && uses(node, path))
+    {
+      last = m_StartedAt[node];
+    }
+  }
+  return last;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArraySpillManager::openFile()
+{
+  if(m_FileId >= 0)
+  {
+    return true;
+  }
+
+  QMutexLocker locker(HDF5Lock::Mutex());
+  QDir directory(m_Directory.isEmpty() ? QDir::tempPath() : m_Directory);
+  m_FilePath = directory.absoluteFilePath(QString("SIMPLView-spill-%1-%2.h5").arg(QCoreApplication::applicationPid()).arg(reinterpret_cast<quintptr>(this), 0, 16));
+  m_FileId = H5Fcreate(m_FilePath.toLocal8Bit().constData(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if(m_FileId < 0)
+  {
+    m_ErrorMessage = QObject::tr("Could not create the spill file '%1'").arg(m_FilePath);
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArraySpillManager::spill(const DataContainerArray::Pointer& dca, const DataArrayPath& path)
+{
+  if(!openFile())
+  {
+    return false;
+  }
+
+  AttributeMatrix::Pointer am = dca->getAttributeMatrix(path);
+  IDataArray::Pointer array = am->getAttributeArray(path.getDataArrayName());
+  hid_t type = SlabFileReader::NativeType(array->getTypeAsString());
+
+  QElapsedTimer timer;
+  timer.start();
+
+  SpilledArray spilled;
+  spilled.path = path;
+  spilled.bytes = array->getSize() * array->getTypeSize();
+  spilled.dataset = QString("a%1").arg(m_DatasetCounter++);
+  spilled.prototype = array->createNewArray(array->getNumberOfTuples(), array->getComponentDimensions(), array->getName(), false);
+
+  QMutexLocker locker(HDF5Lock::Mutex());
+  hsize_t dims[1] = {static_cast<hsize_t>(array->getSize())};
+  hid_t space = H5Screate_simple(1, dims, nullptr);
+  hid_t datasetId = H5Dcreate2(m_FileId, spilled.dataset.toLatin1().constData(), type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Sclose(space);
+  if(datasetId < 0)
+  {
+    m_ErrorMessage = QObject::tr("Could not create a dataset for '%1' in the spill file").arg(path.serialize("/"));
+    return false;
+  }
+  herr_t err = H5Dwrite(datasetId, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, array->getVoidPointer(0));
+  H5Dclose(datasetId);
+  if(err < 0)
+  {
+    m_ErrorMessage = QObject::tr("Could not write '%1' to the spill file").arg(path.serialize("/"));
+    H5Ldelete(m_FileId, spilled.dataset.toLatin1().constData(), H5P_DEFAULT);
+    return false;
+  }
+
+  am->removeAttributeArray(path.getDataArrayName());
+  m_Spilled.insert(Key(path), spilled);
+
+  m_Stats.spilledArrays++;
+  m_Stats.spilledBytes += spilled.bytes;
+  m_Stats.spillMsecs += timer.elapsed();
+  m_Stats.peakSpilledBytes = std::max(m_Stats.peakSpilledBytes, getSpilledBytes());
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArraySpillManager::restoreArray(const DataContainerArray::Pointer& dca, const QString& key)
+{
+  QMutexLocker locker(HDF5Lock::Mutex());
+  SpilledArray spilled = m_Spilled.take(key);
+  AttributeMatrix::Pointer am = dca->getAttributeMatrix(spilled.path);
+  if(am.get() == nullptr)
+  {
+    // A filter removed the attribute matrix, and the array with it
+    H5Ldelete(m_FileId, spilled.dataset.toLatin1().constData(), H5P_DEFAULT);
+    return true;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  IDataArray::Pointer array = ArrayMemoryPool::Instance()->createArrayLike(spilled.prototype, spilled.prototype->getNumberOfTuples(), spilled.prototype->getName());
+  hid_t type = SlabFileReader::NativeType(array->getTypeAsString());
+  hid_t datasetId = H5Dopen2(m_FileId, spilled.dataset.toLatin1().constData(), H5P_DEFAULT);
+  herr_t err = (datasetId < 0) ? -1 : H5Dread(datasetId, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, array->getVoidPointer(0));
+  if(datasetId >= 0)
+  {
+    H5Dclose(datasetId);
+  }
+  if(err < 0)
+  {
+    m_ErrorMessage = QObject::tr("Could not read '%1' back from the spill file").arg(spilled.path.serialize("/"));
+    m_Spilled.insert(key, spilled);
+    return false;
+  }
+  // The space is not reclaimed, but the file is removed at the end of the run anyway
+  H5Ldelete(m_FileId, spilled.dataset.toLatin1().constData(), H5P_DEFAULT);
+
+  am->addAttributeArray(spilled.path.getDataArrayName(), array);
+
+  m_Stats.restoredArrays++;
+  m_Stats.restoredBytes += spilled.bytes;
+  m_Stats.restoreMsecs += timer.elapsed();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArraySpillManager::restore(const DataContainerArray::Pointer& dca, int node)
+{
+  QStringList keys = m_Spilled.keys();
+  for(const QString& key : keys)
+  {
+    const SpilledArray& spilled = m_Spilled[key];
+    if(!dca->doesDataContainerExist(spilled.path.getDataContainerName()) || !uses(node, spilled.path))
+    {
+      continue;
+    }
+    if(!restoreArray(dca, key))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArraySpillManager::restoreAll(const DataContainerArray::Pointer& dca)
+{
+  QStringList keys = m_Spilled.keys();
+  for(const QString& key : keys)
+  {
+    if(dca->doesDataContainerExist(m_Spilled[key].path.getDataContainerName()) && !restoreArray(dca, key))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ArraySpillManager::relieve(const DataContainerArray::Pointer& dca, size_t otherBytes)
+{
+  size_t resident = ArrayLivenessAnalysis::TotalArrayBytes(dca) + otherBytes;
+  if(m_MemoryLimit == 0 || resident <= m_MemoryLimit)
+  {
+    return 0;
+  }
+
+  ArrayMemoryPool* pool = ArrayMemoryPool::Instance();
+  QVector<SpillCandidate> candidates;
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        IDataArray::Pointer array = am->getAttributeArray(name);
+        size_t bytes = array->getSize() * array->getTypeSize();
+        // Mapped and scratch arrays are already paged to disk by the operating system
+        if(bytes < k_MinimumSpillBytes || array->getVoidPointer(0) == nullptr || SlabFileReader::NativeType(array->getTypeAsString()) < 0 || pool->isFileBacked(array))
+        {
+          continue;
+        }
+        SpillCandidate candidate;
+        candidate.path = DataArrayPath(dc->getName(), am->getName(), name);
+        candidate.bytes = bytes;
+        candidate.nextUse = nextUse(candidate.path);
+        candidate.lastUse = lastUse(candidate.path);
+        candidates.push_back(candidate);
+      }
+    }
+  }
+
+  // Furthest next use first, then least recently used, then largest
+  std::sort(candidates.begin(), candidates.end(), [](const SpillCandidate& a, const SpillCandidate& b) {
+    if(a.nextUse != b.nextUse)
+    {
+      return a.nextUse > b.nextUse;
+    }
+    if(a.lastUse != b.lastUse)
+    {
+      return a.lastUse < b.lastUse;
+    }
+    return a.bytes > b.bytes;
+  });
+
+  size_t target = static_cast<size_t>(m_MemoryLimit * LowWaterFraction);
+  size_t spilledBytes = 0;
+  for(const SpillCandidate& candidate : candidates)
+  {
+    if(resident <= target)
+    {
+      break;
+    }
+    if(!spill(dca, candidate.path))
+    {
+      break;
+    }
+    resident -= candidate.bytes;
+    spilledBytes += candidate.bytes;
+  }
+  return spilledBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArraySpillManager::forget(const DataArrayPath& path)
+{
+  QString key = Key(path);
+  if(!m_Spilled.contains(key))
+  {
+    return false;
+  }
+  SpilledArray spilled = m_Spilled.take(key);
+  QMutexLocker locker(HDF5Lock::Mutex());
+  H5Ldelete(m_FileId, spilled.dataset.toLatin1().constData(), H5P_DEFAULT);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ArraySpillManager::isSpilled(const DataArrayPath& path) const
+{
+  return m_Spilled.contains(Key(path));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ArraySpillManager::getSpilledBytes() const
+{
+  size_t bytes = 0;
+  for(const SpilledArray& spilled : m_Spilled)
+  {
+    bytes += spilled.bytes;
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArraySpillManager::addSpilledStructure(const DataContainerArray::Pointer& structure) const
+{
+  for(const SpilledArray& spilled : m_Spilled)
+  {
+    AttributeMatrix::Pointer am = structure->getAttributeMatrix(spilled.path);
+    if(am.get() != nullptr && !am->doesAttributeArrayExist(spilled.path.getDataArrayName()))
+    {
+      am->addAttributeArray(spilled.path.getDataArrayName(), spilled.prototype->deepCopy(true));
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ArraySpillManager::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SpillStats ArraySpillManager::getStats() const
+{
+  return m_Stats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList ArraySpillManager::report() const
+{
+  QStringList lines;
+  lines.push_back(QObject::tr("Spilled %1 arrays (%2) to disk in %3 ms, read back %4 arrays (%5) in %6 ms, at most %7 on disk at once, memory limit %8")
+                      .arg(m_Stats.spilledArrays)
+                      .arg(MemoryEstimator::FormatBytes(m_Stats.spilledBytes))
+                      .arg(m_Stats.spillMsecs)
+                      .arg(m_Stats.restoredArrays)
+                      .arg(MemoryEstimator::FormatBytes(m_Stats.restoredBytes))
+                      .arg(m_Stats.restoreMsecs)
+                      .arg(MemoryEstimator::FormatBytes(m_Stats.peakSpilledBytes))
+                      .arg(MemoryEstimator::FormatBytes(m_MemoryLimit)));
+  return lines;
+}
@@ -0,0 +1,243 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <hdf5.h>
+
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+#include "Common/PipelineDataFlowGraph.h"
+
+/**
+ * @brief The SpillStats struct sums up what the ArraySpillManager did during one run
+ */
+struct SpillStats
+{
+  int spilledArrays = 0;
+  size_t spilledBytes = 0;
+  qint64 spillMsecs = 0;
+  int restoredArrays = 0;
+  size_t restoredBytes = 0;
+  qint64 restoreMsecs = 0;
+  size_t peakSpilledBytes = 0;
+};
+
+/**
+ * @brief The ArraySpillManager class keeps the arrays of a running pipeline within a memory limit by writing
+ * cold arrays to a temporary HDF5 file and reading them back before a filter needs them.
+ *
+ * The graph of the pipeline tells which filters read or write every array. When the resident arrays exceed
+ * the limit, the arrays whose next use is the furthest away are spilled first, least recently used first
+ * among equals, until the resident arrays are back below LowWaterFraction of the limit. Arrays no remaining
+ * filter uses are the best candidates of all. Spilling removes the array from its attribute matrix; before
+ * a filter executes, restore() puts back every array the filter reads or writes, and before a barrier
+ * every spilled array.
+ *
+ * Only arrays with one contiguous buffer of a plain number type can be spilled. The temporary file is
+ * removed when the manager is destroyed.
+ */
+class ArraySpillManager
+{
+public:
+  static constexpr double LowWaterFraction = 0.9;
+
+  /**
+   * @brief ArraySpillManager
+   * @param graph The graph of the pipeline, in the order the executor uses
+   * @param memoryLimit The bytes the arrays may hold before arrays are spilled
+   */
+  ArraySpillManager(const PipelineDataFlowGraph& graph, size_t memoryLimit);
+  virtual ~ArraySpillManager();
+
+  size_t getMemoryLimit() const;
+
+  /**
+   * @brief setDirectory Sets the directory of the temporary file, the system temporary directory if empty
+   * @param directory
+   */
+  void setDirectory(const QString& directory);
+
+  /**
+   * @brief markStarted Records that 'node' has started, so its accesses are no longer in the future and
+   * the arrays it uses were used just now
+   * @param node
+   */
+  void markStarted(int node);
+
+  /**
+   * @brief restore Reads back every spilled array of 'dca' that 'node' reads or writes, or every spilled
+   * array of 'dca' if the node is a barrier
+   * @param dca
+   * @param node
+   * @return false if an array could not be read back
+   */
+  bool restore(const DataContainerArray::Pointer& dca, int node);
+
+  /**
+   * @brief restoreAll Reads back every spilled array of 'dca'
+   * @param dca
+   * @return false if an array could not be read back
+   */
+  bool restoreAll(const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief relieve Spills arrays of 'dca' until the resident arrays fit below the low water mark
+   * @param dca The arrays that may be spilled
+   * @param otherBytes Resident bytes that cannot be spilled, e.g. the arrays of running filters
+   * @return The number of bytes spilled
+   */
+  size_t relieve(const DataContainerArray::Pointer& dca, size_t otherBytes);
+
+  /**
+   * @brief forget Drops the spilled copy of 'path', e.g. once it has been released after its last use
+   * @param path
+   * @return true if the array was spilled
+   */
+  bool forget(const DataArrayPath& path);
+
+  /**
+   * @brief isSpilled
+   * @param path
+   * @return
+   */
+  bool isSpilled(const DataArrayPath& path) const;
+
+  /**
+   * @brief getSpilledBytes Returns the bytes that are currently on disk
+   * @return
+   */
+  size_t getSpilledBytes() const;
+
+  /**
+   * @brief addSpilledStructure Adds the structure of every spilled array to 'structure', so a structural
+   * copy of the arrays shows them even while they are on disk
+   * @param structure
+   */
+  void addSpilledStructure(const DataContainerArray::Pointer& structure) const;
+
+  /**
+   * @brief getErrorMessage Returns why the last spill or restore failed
+   * @return
+   */
+  QString getErrorMessage() const;
+
+  SpillStats getStats() const;
+
+  /**
+   * @brief report Returns the statistics as lines for a run report
+   * @return
+   */
+  QStringList report() const;
+
+protected:
+  struct SpilledArray
+  {
+    DataArrayPath path;
+    IDataArray::Pointer prototype;
+    size_t bytes = 0;
+    QString dataset;
+  };
+
+  /**
+   * @brief nextUse Returns the first node that has not started and uses 'path', or the graph size if none
+   * @param path
+   * @return
+   */
+  int nextUse(const DataArrayPath& path) const;
+
+  /**
+   * @brief lastUse Returns when the most recently started node that uses 'path' started, 0 if none has
+   * @param path
+   * @return
+   */
+  qint64 lastUse(const DataArrayPath& path) const;
+
+  /**
+   * @brief uses Returns true if 'node' reads or writes 'path'
+   * @param node
+   * @param path
+   * @return
+   */
+  bool uses(int node, const DataArrayPath& path) const;
+
+  /**
+   * @brief openFile Creates the temporary file the first time an array is spilled
+   * @return
+   */
+  bool openFile();
+
+  /**
+   * @brief spill Writes the array at 'path' to the file and removes it from its attribute matrix
+   * @param dca
+   * @param path
+   * @return
+   */
+  bool spill(const DataContainerArray::Pointer& dca, const DataArrayPath& path);
+
+  /**
+   * @brief restoreArray Reads the spilled array 'key' back into its attribute matrix in 'dca'
+   * @param dca
+   * @param key
+   * @return
+   */
+  bool restoreArray(const DataContainerArray::Pointer& dca, const QString& key);
+
+  static QString Key(const DataArrayPath& path);
+
+private:
+  PipelineDataFlowGraph m_Graph;
+  size_t m_MemoryLimit = 0;
+  QString m_Directory;
+  QString m_FilePath;
+  hid_t m_FileId = -1;
+  int m_DatasetCounter = 0;
+
+  // The order in which the nodes started, 0 for nodes that have not
+  QVector<qint64> m_StartedAt;
+  qint64 m_Clock = 0;
+  QMap<QString, SpilledArray> m_Spilled;
+  SpillStats m_Stats;
+  QString m_ErrorMessage;
+
+  ArraySpillManager(const ArraySpillManager&) = delete; // Copy Constructor Not Implemented
+  void operator=(const ArraySpillManager&) = delete;    // Move assignment Not Implemented
+};
@@ -0,0 +1,368 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "AsyncFileWriter.h"
+
+#include <algorithm>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/IGeometry.h"
+
+#include "Common/ArrayLivenessAnalysis.h"
+#include "Common/HDF5Lock.h"
+#include "Common/IncrementalFileWriter.h"
+#include "Common/MemoryEstimator.h"
+
+namespace
+{
+const char* const OutputFileProperty = "OutputFile";
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AsyncFileWriter::AsyncFileWriter()
+{
+  // One thread keeps the writes in pipeline order
+  m_IoThread.setMaxThreadCount(1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AsyncFileWriter::~AsyncFileWriter()
+{
+  m_IoThread.waitForDone();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer AsyncFileWriter::ShareArrays(const DataContainerArray::Pointer& dca)
+{
+  DataContainerArray::Pointer shared = dca->deepCopy(true);
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::Pointer sharedDc = shared->getDataContainer(dc->getName());
+    sharedDc->setGeometry(dc->getGeometry());
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      AttributeMatrix::Pointer sharedAm = sharedDc->getAttributeMatrix(am->getName());
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        sharedAm->addAttributeArray(name, am->getAttributeArray(name));
+      }
+    }
+  }
+  return shared;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString AsyncFileWriter::OutputFile(const AbstractFilter::Pointer& filter)
+{
+  return filter->property(OutputFileProperty).toString();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AsyncFileWriter::setWriteProfile(WriteProfile::Preset preset)
+{
+  m_WriteProfile = preset;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AsyncFileWriter::setIncrementalWrites(bool incremental)
+{
+  m_IncrementalWrites = incremental;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AsyncFileWriter::submit(int node, const AbstractFilter::Pointer& filter, const DataContainerArray::Pointer& dca)
+{
+  filter->setErrorCondition(0);
+  filter->setWarningCondition(0);
+  DataContainerArray::Pointer snapshot = ShareArrays(dca);
+  {
+    QMutexLocker locker(&m_Mutex);
+    hold(snapshot, true);
+    m_Pending++;
+    m_PendingFiles.push_back(QFileInfo(OutputFile(filter)).absoluteFilePath());
+  }
+  QtConcurrent::run(&m_IoThread, [this, node, filter, snapshot] { write(node, filter, snapshot); });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool AsyncFileWriter::isWriting() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_Pending > 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool AsyncFileWriter::isWritingFile(const QString& filePath) const
+{
+  QMutexLocker locker(&m_Mutex);
+  return !filePath.isEmpty() && m_PendingFiles.contains(QFileInfo(filePath).absoluteFilePath());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t AsyncFileWriter::protect(const DataContainerArray::Pointer& dca, const FilterDataFootprint& footprint)
+{
+  QMutexLocker locker(&m_Mutex);
+  if(m_Held.isEmpty())
+  {
+    return 0;
+  }
+
+  size_t bytes = 0;
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    // Only a write to the whole container can change its geometry
+    IGeometry::Pointer geom = dc->getGeometry();
+    bool containerWritten = footprint.barrier || footprint.writes.contains(DataArrayPath(dc->getName(), "", ""));
+    if(geom.get() != nullptr && containerWritten && m_Held.contains(geom.get()))
+    {
+      dc->setGeometry(geom->deepCopy());
+    }
+
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        IDataArray::Pointer array = am->getAttributeArray(name);
+        if(!m_Held.contains(array.get()))
+        {
+          continue;
+        }
+        // A filter may change a required array in place while only listing it as read
+        DataArrayPath path(dc->getName(), am->getName(), name);
+        bool touched = footprint.barrier;
+        for(int i = 0; i < footprint.writes.size() && !touched; i++)
+        {
+          touched = PipelineDataFlowGraph::PathsOverlap(footprint.writes[i], path);
+        }
+        for(int i = 0; i < footprint.reads.size() && !touched; i++)
+        {
+          touched = PipelineDataFlowGraph::PathsOverlap(footprint.reads[i], path);
+        }
+        if(!touched)
+        {
+          continue;
+        }
+
+        am->addAttributeArray(name, array->deepCopy());
+        size_t arrayBytes = array->getSize() * array->getTypeSize();
+        bytes += arrayBytes;
+        m_Stats.copiedArrays++;
+        m_Stats.copiedBytes += arrayBytes;
+      }
+    }
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AsyncFileWriter::wait()
+{
+  QElapsedTimer timer;
+  timer.start();
+  QMutexLocker locker(&m_Mutex);
+  if(m_Pending == 0)
+  {
+    return;
+  }
+  while(m_Pending > 0)
+  {
+    m_Idle.wait(&m_Mutex);
+  }
+  m_Stats.waitMsecs += timer.elapsed();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<AsyncFileWriter::Result> AsyncFileWriter::takeFinished()
+{
+  QMutexLocker locker(&m_Mutex);
+  QVector<Result> finished;
+  finished.swap(m_Finished);
+  return finished;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AsyncWriteStats AsyncFileWriter::getStats() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_Stats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList AsyncFileWriter::report() const
+{
+  AsyncWriteStats stats = getStats();
+  QStringList lines;
+  double seconds = static_cast<double>(std::max<qint64>(stats.writeMsecs, 1)) / 1000.0;
+  lines.push_back(QObject::tr("Wrote %1 files (%2) in the background in %3 ms at %4/s, %5 ms overlapped with other filters, %6 ms spent waiting for writes")
+                      .arg(stats.writes)
+                      .arg(MemoryEstimator::FormatBytes(stats.writtenBytes))
+                      .arg(stats.writeMsecs)
+                      .arg(MemoryEstimator::FormatBytes(static_cast<size_t>(static_cast<double>(stats.writtenBytes) / seconds)))
+                      .arg(std::max<qint64>(stats.writeMsecs - stats.waitMsecs, 0))
+                      .arg(stats.waitMsecs));
+  if(stats.copiedArrays > 0)
+  {
+    lines.push_back(QObject::tr("Copied %1 arrays (%2) that filters wrote while a background write still held them")
+                        .arg(stats.copiedArrays)
+                        .arg(MemoryEstimator::FormatBytes(stats.copiedBytes)));
+  }
+  if(stats.failedWrites > 0)
+  {
+    lines.push_back(QObject::tr("%1 background writes failed").arg(stats.failedWrites));
+  }
+  return lines;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AsyncFileWriter::write(int node, AbstractFilter::Pointer filter, DataContainerArray::Pointer snapshot)
+{
+  QMutexLocker ioLocker(HDF5Lock::Mutex());
+  QElapsedTimer timer;
+  timer.start();
+  filter->setDataContainerArray(snapshot);
+  IncrementalFileWriter output(filter, WriteProfile::ForWriter(filter, m_WriteProfile), m_IncrementalWrites);
+  output.stage();
+  filter->execute();
+
+  Result result;
+  result.node = node;
+  result.filter = filter;
+  result.errorCondition = filter->getErrorCondition();
+  result.profileFailed = !output.finish(result.errorCondition >= 0, &result.profileMessage);
+  result.profileErrorCode = output.getErrorCode();
+  result.outputFile = OutputFile(filter);
+  QFileInfo fileInfo(result.outputFile);
+  result.bytes = fileInfo.exists() ? static_cast<size_t>(fileInfo.size()) : ArrayLivenessAnalysis::TotalArrayBytes(snapshot);
+  result.msecs = timer.elapsed();
+
+  // The executor gives the filter its structural copy once every write is done
+  filter->setDataContainerArray(DataContainerArray::New());
+  ioLocker.unlock();
+
+  QMutexLocker locker(&m_Mutex);
+  hold(snapshot, false);
+  m_PendingFiles.removeOne(fileInfo.absoluteFilePath());
+  m_Stats.writes++;
+  m_Stats.writeMsecs += result.msecs;
+  if(result.errorCondition < 0)
+  {
+    m_Stats.failedWrites++;
+  }
+  else
+  {
+    m_Stats.writtenBytes += result.bytes;
+  }
+  m_Finished.push_back(result);
+  m_Pending--;
+  m_Idle.wakeAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AsyncFileWriter::hold(const DataContainerArray::Pointer& snapshot, bool held)
+{
+  auto count = [this, held](const void* object) {
+    if(held)
+    {
+      m_Held[object]++;
+    }
+    else if(--m_Held[object] <= 0)
+    {
+      m_Held.remove(object);
+    }
+  };
+
+  QList<DataContainer::Pointer> containers = snapshot->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    if(dc->getGeometry().get() != nullptr)
+    {
+      count(dc->getGeometry().get());
+    }
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        count(am->getAttributeArray(name).get());
+      }
+    }
+  }
+}
@@ -0,0 +1,211 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+#include "Common/PipelineDataFlowGraph.h"
+#include "Common/WriteProfile.h"
+
+/**
+ * @brief The AsyncWriteStats struct sums up what the AsyncFileWriter did during one run
+ */
+struct AsyncWriteStats
+{
+  int writes = 0;
+  int failedWrites = 0;
+  size_t writtenBytes = 0;
+  qint64 writeMsecs = 0;
+  qint64 waitMsecs = 0;
+  int copiedArrays = 0;
+  size_t copiedBytes = 0;
+};
+
+/**
+ * @brief The AsyncFileWriter class runs writer filters on a background I/O thread while the filters after
+ * them keep executing.
+ *
+ * submit() hands the writer a structural copy of the DataContainerArray that shares every array and
+ * geometry with the pipeline, so handing it off costs no copy. Those arrays are immutable for as long as
+ * the write is pending: before a later filter starts, protect() replaces every held array the filter reads
+ * or writes with a copy in the filter's own Data Containers, and the write keeps the original. Reads count
+ * because a filter may change a required array in place. Removing or replacing
+ * an array in the pipeline is always safe because the copy given to the writer keeps it alive.
+ *
+ * Writes run one at a time in the order they were submitted, so two writers of the same file never
+ * interleave. The result of every write, including its error condition, is collected by takeFinished().
+ * A write profile or an incremental merge is applied on the I/O thread as well, right after the writer
+ * finishes. A write holds the HDF5Lock throughout, so it never calls into HDF5 while a reader, another writer
+ * or another pipeline of the process does.
+ */
+class AsyncFileWriter
+{
+public:
+  /**
+   * @brief The Result struct describes one finished write
+   */
+  struct Result
+  {
+    int node = -1;
+    AbstractFilter::Pointer filter;
+    int errorCondition = 0;
+    QString outputFile;
+    size_t bytes = 0;
+    qint64 msecs = 0;
+    QString profileMessage;
+    bool profileFailed = false;
+    int profileErrorCode = 0;
+  };
+
+  AsyncFileWriter();
+  virtual ~AsyncFileWriter();
+
+  /**
+   * @brief ShareArrays Returns a new DataContainerArray with the structure of 'dca' that shares its arrays
+   * and geometries
+   * @param dca
+   * @return
+   */
+  static DataContainerArray::Pointer ShareArrays(const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief OutputFile Returns the file a writer filter writes, empty if it does not say
+   * @param filter
+   * @return
+   */
+  static QString OutputFile(const AbstractFilter::Pointer& filter);
+
+  /**
+   * @brief setWriteProfile Sets the profile written files are rewritten with unless the writer has its own
+   * @param preset
+   */
+  void setWriteProfile(WriteProfile::Preset preset);
+
+  /**
+   * @brief setIncrementalWrites Enables merging what a writer writes into its existing output file
+   * @param incremental
+   */
+  void setIncrementalWrites(bool incremental);
+
+  /**
+   * @brief submit Queues 'filter' to execute on the I/O thread against the arrays 'dca' holds now
+   * @param node
+   * @param filter
+   * @param dca
+   */
+  void submit(int node, const AbstractFilter::Pointer& filter, const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief isWriting Returns true while a submitted write has not finished
+   * @return
+   */
+  bool isWriting() const;
+
+  /**
+   * @brief isWritingFile Returns true while a pending write goes to 'filePath'
+   * @param filePath
+   * @return
+   */
+  bool isWritingFile(const QString& filePath) const;
+
+  /**
+   * @brief protect Replaces every array of 'dca' that the filter of 'footprint' reads or writes and a
+   * pending write still holds with a copy
+   * @param dca
+   * @param footprint
+   * @return The bytes that were copied
+   */
+  size_t protect(const DataContainerArray::Pointer& dca, const FilterDataFootprint& footprint);
+
+  /**
+   * @brief wait Blocks until every submitted write has finished. The time is counted as waiting.
+   */
+  void wait();
+
+  /**
+   * @brief takeFinished Returns the writes that finished since the last call
+   * @return
+   */
+  QVector<Result> takeFinished();
+
+  AsyncWriteStats getStats() const;
+
+  /**
+   * @brief report Returns the statistics as lines for a run report
+   * @return
+   */
+  QStringList report() const;
+
+protected:
+  /**
+   * @brief write Executes 'filter' against 'snapshot'. Called on the I/O thread.
+   * @param node
+   * @param filter
+   * @param snapshot
+   */
+  void write(int node, AbstractFilter::Pointer filter, DataContainerArray::Pointer snapshot);
+
+  /**
+   * @brief hold Counts the arrays and geometries of 'snapshot' as held, or releases them
+   * @param snapshot
+   * @param held
+   */
+  void hold(const DataContainerArray::Pointer& snapshot, bool held);
+
+private:
+  QThreadPool m_IoThread;
+  WriteProfile::Preset m_WriteProfile = WriteProfile::Preset::Default;
+  bool m_IncrementalWrites = false;
+  mutable QMutex m_Mutex;
+  QWaitCondition m_Idle;
+  int m_Pending = 0;
+  QStringList m_PendingFiles;
+  QHash<const void*, int> m_Held;
+  QVector<Result> m_Finished;
+  AsyncWriteStats m_Stats;
+
+  AsyncFileWriter(const AsyncFileWriter&) = delete; // Copy Constructor Not Implemented
+  void operator=(const AsyncFileWriter&) = delete;  // Move assignment Not Implemented
+};
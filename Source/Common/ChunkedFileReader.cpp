@@ -0,0 +1,304 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ChunkedFileReader.h"
+
+#include <QtCore/QObject>
+
+#include "H5Support/QH5Lite.h"
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainerArrayProxy.h"
+
+#include "Common/ArrayMemoryPool.h"
+#include "Common/ParallelChunkIO.h"
+#include "Common/SlabFileReader.h"
+
+namespace
+{
+const QString ReaderClassName("DataContainerReader");
+const char* const InputFileProperty = "InputFile";
+const char* const ProxyProperty = "InputFileDataContainerArrayProxy";
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DatasetPath(const DataArrayPath& path)
+{
+  return QString("/%1/%2/%3/%4").arg(SIMPL::StringConstants::DataContainerGroupName).arg(path.getDataContainerName()).arg(path.getAttributeMatrixName()).arg(path.getDataArrayName());
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ChunkedFileReader::ChunkedFileReader() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ChunkedFileReader::~ChunkedFileReader() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ChunkedFileReader::planArray(hid_t fileId, const DataArrayPath& path, PlannedArray* planned) const
+{
+  QString datasetPath = DatasetPath(path);
+
+  QString objectType;
+  QH5Lite::readStringAttribute(fileId, datasetPath, SIMPL::HDF5::ObjectType, objectType);
+  if(!objectType.startsWith("DataArray<") || !objectType.endsWith(">"))
+  {
+    return false;
+  }
+  QString typeName = objectType.mid(10, objectType.size() - 11);
+  hid_t memType = SlabFileReader::NativeType(typeName);
+  if(memType < 0)
+  {
+    return false;
+  }
+
+  QVector<uint64_t> componentDims;
+  if(QH5Lite::readVectorAttribute(fileId, datasetPath, SIMPL::HDF5::ComponentDimensions, componentDims) < 0 || componentDims.isEmpty())
+  {
+    return false;
+  }
+  QVector<size_t> cDims;
+  size_t components = 1;
+  for(uint64_t dim : componentDims)
+  {
+    cDims.push_back(static_cast<size_t>(dim));
+    components *= static_cast<size_t>(dim);
+  }
+
+  hid_t datasetId = H5Dopen2(fileId, datasetPath.toLatin1().constData(), H5P_DEFAULT);
+  if(datasetId < 0)
+  {
+    return false;
+  }
+  hid_t space = H5Dget_space(datasetId);
+  hssize_t elements = H5Sget_simple_extent_npoints(space);
+  H5Sclose(space);
+
+  // Only datasets whose chunks ParallelChunkIO decodes itself gain anything; the reader converts the rest
+  hid_t fileType = H5Dget_type(datasetId);
+  bool native = H5Tequal(fileType, memType) > 0;
+  H5Tclose(fileType);
+  bool direct = native && ParallelChunkIO(datasetId).isDirect();
+  H5Dclose(datasetId);
+  if(!direct || elements <= 0 || components == 0 || static_cast<size_t>(elements) % components != 0)
+  {
+    return false;
+  }
+
+  planned->path = path;
+  planned->typeName = typeName;
+  planned->numTuples = static_cast<size_t>(elements) / components;
+  planned->cDims = cDims;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ChunkedFileReader::prepare(const AbstractFilter::Pointer& reader)
+{
+  m_Planned.clear();
+  m_SavedProxy = QVariant();
+  if(reader->getNameOfClass() != ReaderClassName)
+  {
+    return true;
+  }
+
+  m_FilePath = reader->property(InputFileProperty).toString();
+  QVariant var = reader->property(ProxyProperty);
+  if(!var.canConvert<DataContainerArrayProxy>())
+  {
+    return true;
+  }
+
+  hid_t fileId = H5Fopen(m_FilePath.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if(fileId < 0)
+  {
+    m_ErrorMessage = QObject::tr("The file '%1' could not be opened to inspect its chunked arrays").arg(m_FilePath);
+    return false;
+  }
+
+  DataContainerArrayProxy proxy = var.value<DataContainerArrayProxy>();
+  for(DataContainerProxy& dcProxy : proxy.dataContainers)
+  {
+    if(dcProxy.flag == Qt::Unchecked)
+    {
+      continue;
+    }
+    for(AttributeMatrixProxy& amProxy : dcProxy.attributeMatricies)
+    {
+      if(amProxy.flag == Qt::Unchecked)
+      {
+        continue;
+      }
+      for(DataArrayProxy& daProxy : amProxy.dataArrays)
+      {
+        if(daProxy.flag == Qt::Unchecked)
+        {
+          continue;
+        }
+
+        PlannedArray planned;
+        if(!planArray(fileId, DataArrayPath(dcProxy.name, amProxy.name, daProxy.name), &planned))
+        {
+          continue;
+        }
+        m_Planned.push_back(planned);
+        // The attribute matrix stays selected so the reader still creates it
+        daProxy.flag = Qt::Unchecked;
+      }
+    }
+  }
+  H5Fclose(fileId);
+
+  if(!m_Planned.isEmpty())
+  {
+    m_SavedProxy = var;
+    reader->setProperty(ProxyProperty, QVariant::fromValue(proxy));
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer ChunkedFileReader::readArray(hid_t fileId, const PlannedArray& planned) const
+{
+  IDataArray::Pointer array = ArrayMemoryPool::Instance()->createArray(planned.typeName, planned.numTuples, planned.cDims, planned.path.getDataArrayName());
+  if(array.get() == nullptr)
+  {
+    return IDataArray::NullPointer();
+  }
+
+  hid_t datasetId = H5Dopen2(fileId, DatasetPath(planned.path).toLatin1().constData(), H5P_DEFAULT);
+  if(datasetId < 0)
+  {
+    return IDataArray::NullPointer();
+  }
+  hid_t space = H5Dget_space(datasetId);
+  int rank = H5Sget_simple_extent_ndims(space);
+  QVector<hsize_t> dims(rank > 0 ? rank : 0);
+  if(rank > 0)
+  {
+    H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+  }
+  H5Sclose(space);
+
+  bool ok = rank > 0 && ParallelChunkIO(datasetId).readRows(SlabFileReader::NativeType(planned.typeName), 0, dims[0], array->getVoidPointer(0));
+  H5Dclose(datasetId);
+  return ok ? array : IDataArray::NullPointer();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ChunkedFileReader::finish(const AbstractFilter::Pointer& reader, const DataContainerArray::Pointer& dca)
+{
+  // The pipeline must not keep a reader whose selection differs from what the user chose
+  if(m_SavedProxy.isValid())
+  {
+    reader->setProperty(ProxyProperty, m_SavedProxy);
+    m_SavedProxy = QVariant();
+  }
+  if(m_Planned.isEmpty() || reader->getErrorCondition() < 0)
+  {
+    return true;
+  }
+
+  hid_t fileId = H5Fopen(m_FilePath.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if(fileId < 0)
+  {
+    m_ErrorMessage = QObject::tr("The file '%1' could not be opened to read its chunked arrays").arg(m_FilePath);
+    return false;
+  }
+
+  bool ok = true;
+  for(const PlannedArray& planned : m_Planned)
+  {
+    AttributeMatrix::Pointer am = dca->getAttributeMatrix(planned.path);
+    if(am.get() == nullptr || am->getNumberOfTuples() != planned.numTuples)
+    {
+      m_ErrorMessage = QObject::tr("The reader did not create an attribute matrix that fits '%1'").arg(planned.path.serialize("/"));
+      ok = false;
+      break;
+    }
+
+    IDataArray::Pointer array = readArray(fileId, planned);
+    if(array.get() == nullptr)
+    {
+      m_ErrorMessage = QObject::tr("'%1' could not be read from '%2'").arg(planned.path.serialize("/")).arg(m_FilePath);
+      ok = false;
+      break;
+    }
+    am->addAttributeArray(planned.path.getDataArrayName(), array);
+
+    m_ReadArrays++;
+    m_ReadBytes += array->getSize() * array->getTypeSize();
+  }
+  H5Fclose(fileId);
+  return ok;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ChunkedFileReader::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ChunkedFileReader::getReadArrays() const
+{
+  return m_ReadArrays;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ChunkedFileReader::getReadBytes() const
+{
+  return m_ReadBytes;
+}
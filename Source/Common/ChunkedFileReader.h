@@ -0,0 +1,119 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <hdf5.h>
+
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The ChunkedFileReader class reads the chunked shuffle and deflate datasets of a DataContainerReader
+ * through ParallelChunkIO, so their chunks are decompressed on the thread pool instead of in the serial
+ * filter pipeline of HDF5.
+ *
+ * prepare() unchecks those datasets in the selection of the reader, which then only creates their attribute
+ * matrices, and finish() reads them into arrays of the ArrayMemoryPool. Every other dataset is left to the
+ * reader. The PipelineExecutor hands it a copy of the reader, so the selection the user made stays untouched.
+ */
+class ChunkedFileReader
+{
+public:
+  ChunkedFileReader();
+  virtual ~ChunkedFileReader();
+
+  /**
+   * @brief prepare Unchecks the datasets of 'reader' that ParallelChunkIO reads chunk by chunk. Does nothing
+   * for other filters.
+   * @param reader
+   * @return false if the input file could not be inspected
+   */
+  bool prepare(const AbstractFilter::Pointer& reader);
+
+  /**
+   * @brief finish Restores the selection of 'reader' and adds the datasets prepare() took over to 'dca'
+   * @param reader
+   * @param dca
+   * @return false if a dataset could not be read
+   */
+  bool finish(const AbstractFilter::Pointer& reader, const DataContainerArray::Pointer& dca);
+
+  QString getErrorMessage() const;
+  int getReadArrays() const;
+  size_t getReadBytes() const;
+
+protected:
+  struct PlannedArray
+  {
+    DataArrayPath path;
+    QString typeName;
+    size_t numTuples = 0;
+    QVector<size_t> cDims;
+  };
+
+  /**
+   * @brief planArray Decides whether the dataset of 'path' in the open file is read through ParallelChunkIO
+   * @param fileId
+   * @param path
+   * @param planned Filled in if it is
+   * @return
+   */
+  bool planArray(hid_t fileId, const DataArrayPath& path, PlannedArray* planned) const;
+
+  /**
+   * @brief readArray Reads the dataset of 'planned' from the open file into a new array
+   * @param fileId
+   * @param planned
+   * @return The array or null
+   */
+  IDataArray::Pointer readArray(hid_t fileId, const PlannedArray& planned) const;
+
+private:
+  QString m_FilePath;
+  QVariant m_SavedProxy;
+  QVector<PlannedArray> m_Planned;
+  QString m_ErrorMessage;
+  int m_ReadArrays = 0;
+  size_t m_ReadBytes = 0;
+
+  ChunkedFileReader(const ChunkedFileReader&) = delete; // Copy Constructor Not Implemented
+  void operator=(const ChunkedFileReader&) = delete;    // Move assignment Not Implemented
+};
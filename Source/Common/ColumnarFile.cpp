@@ -0,0 +1,520 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ColumnarFile.h"
+
+#include <cstring>
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSysInfo>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+
+#include "Common/ArrayMemoryPool.h"
+#include "Common/ColumnarFileReader.h"
+#include "Common/ColumnarFileWriter.h"
+
+const char ColumnarFile::Magic[9] = "SVCOLUMN";
+const QString ColumnarFile::Extension("svcol");
+
+namespace
+{
+const quint32 k_ByteOrderMark = 0x01020304;
+const size_t k_TrailerBytes = 16;
+
+// Offsets of the fields of the header
+const size_t k_VersionOffset = 8;
+const size_t k_HeaderBytesOffset = 12;
+const size_t k_AlignmentOffset = 16;
+const size_t k_FooterOffsetOffset = 24;
+const size_t k_FooterBytesOffset = 32;
+const size_t k_TuplesOffset = 40;
+const size_t k_ColumnsOffset = 48;
+const size_t k_ByteOrderOffset = 52;
+
+using CreateFunction = IDataArray::Pointer (*)(size_t, const QVector<size_t>&, const QString&, bool);
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T> IDataArray::Pointer CreateColumnArray(size_t numTuples, const QVector<size_t>& cDims, const QString& name, bool allocate)
+{
+  return DataArray<T>::CreateArray(numTuples, cDims, name, allocate);
+}
+
+/**
+ * @brief The ColumnType struct is a plain number type a column can hold, with its numpy kind
+ */
+struct ColumnType
+{
+  const char* typeName;
+  char kind;
+  size_t size;
+  CreateFunction create;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const ColumnType* FindColumnType(const QString& typeName)
+{
+  static const ColumnType types[] = {
+      {"int8_t", 'i', sizeof(int8_t), &CreateColumnArray<int8_t>},       {"uint8_t", 'u', sizeof(uint8_t), &CreateColumnArray<uint8_t>},
+      {"int16_t", 'i', sizeof(int16_t), &CreateColumnArray<int16_t>},    {"uint16_t", 'u', sizeof(uint16_t), &CreateColumnArray<uint16_t>},
+      {"int32_t", 'i', sizeof(int32_t), &CreateColumnArray<int32_t>},    {"uint32_t", 'u', sizeof(uint32_t), &CreateColumnArray<uint32_t>},
+      {"int64_t", 'i', sizeof(int64_t), &CreateColumnArray<int64_t>},    {"uint64_t", 'u', sizeof(uint64_t), &CreateColumnArray<uint64_t>},
+      {"float", 'f', sizeof(float), &CreateColumnArray<float>},          {"double", 'f', sizeof(double), &CreateColumnArray<double>},
+      {"bool", 'b', sizeof(bool), &CreateColumnArray<bool>},
+  };
+
+  for(const ColumnType& type : types)
+  {
+    if(typeName == type.typeName)
+    {
+      return &type;
+    }
+  }
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// The numpy array-interface type string, e.g. "<f4"
+// -----------------------------------------------------------------------------
+QString NumpyTypeString(const ColumnType& type)
+{
+  QChar order = (type.size == 1) ? QChar('|') : (QSysInfo::ByteOrder == QSysInfo::LittleEndian ? QChar('<') : QChar('>'));
+  return QString("%1%2%3").arg(order).arg(QChar(type.kind)).arg(type.size);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonArray ToJsonArray(const QVector<size_t>& values)
+{
+  QJsonArray array;
+  for(size_t value : values)
+  {
+    array.append(static_cast<double>(value));
+  }
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<size_t> FromJsonArray(const QJsonArray& array)
+{
+  QVector<size_t> values;
+  for(const QJsonValue& value : array)
+  {
+    values.push_back(static_cast<size_t>(value.toDouble()));
+  }
+  return values;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t Product(const QVector<size_t>& values)
+{
+  size_t product = 1;
+  for(size_t value : values)
+  {
+    product *= value;
+  }
+  return product;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T> void PutField(QByteArray& buffer, size_t offset, T value)
+{
+  std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T> T GetField(const QByteArray& buffer, size_t offset)
+{
+  T value = 0;
+  std::memcpy(&value, buffer.constData() + offset, sizeof(T));
+  return value;
+}
+
+// -----------------------------------------------------------------------------
+// Writes zeros up to the next multiple of the column alignment
+// -----------------------------------------------------------------------------
+bool Pad(QSaveFile& file, quint64* offset)
+{
+  static const QByteArray zeros(static_cast<int>(ColumnarFile::Alignment), '\0');
+  quint64 padding = (ColumnarFile::Alignment - *offset % ColumnarFile::Alignment) % ColumnarFile::Alignment;
+  if(padding > 0 && file.write(zeros.constData(), static_cast<qint64>(padding)) != static_cast<qint64>(padding))
+  {
+    return false;
+  }
+  *offset += padding;
+  return true;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ColumnarFile::ColumnarFile(const QString& filePath)
+: m_FilePath(filePath)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    m_ErrorMessage = QObject::tr("'%1' could not be opened: %2").arg(filePath).arg(file.errorString());
+    return;
+  }
+
+  quint64 fileBytes = static_cast<quint64>(file.size());
+  QByteArray header = file.read(HeaderBytes);
+  if(fileBytes < HeaderBytes + k_TrailerBytes || header.size() != static_cast<int>(HeaderBytes) || std::memcmp(header.constData(), Magic, 8) != 0)
+  {
+    m_ErrorMessage = QObject::tr("'%1' is not a columnar file").arg(filePath);
+    return;
+  }
+  if(GetField<quint32>(header, k_VersionOffset) > Version)
+  {
+    m_ErrorMessage = QObject::tr("'%1' was written by a newer version of the columnar format").arg(filePath);
+    return;
+  }
+  if(GetField<quint32>(header, k_ByteOrderOffset) != k_ByteOrderMark)
+  {
+    m_ErrorMessage = QObject::tr("'%1' was written on a machine with a different byte order and cannot be mapped").arg(filePath);
+    return;
+  }
+
+  quint64 footerOffset = GetField<quint64>(header, k_FooterOffsetOffset);
+  quint64 footerBytes = GetField<quint64>(header, k_FooterBytesOffset);
+  quint64 footerEnd = footerOffset + footerBytes;
+  if(GetField<quint32>(header, k_HeaderBytesOffset) < HeaderBytes || footerOffset < HeaderBytes || footerEnd < footerOffset || footerEnd + k_TrailerBytes > fileBytes)
+  {
+    m_ErrorMessage = QObject::tr("'%1' is truncated or damaged").arg(filePath);
+    return;
+  }
+
+  QJsonParseError parseError;
+  QJsonDocument footer;
+  if(file.seek(static_cast<qint64>(footerOffset)))
+  {
+    footer = QJsonDocument::fromJson(file.read(static_cast<qint64>(footerBytes)), &parseError);
+  }
+  if(!footer.isObject())
+  {
+    m_ErrorMessage = QObject::tr("The footer of '%1' could not be read: %2").arg(filePath).arg(parseError.errorString());
+    return;
+  }
+  m_Valid = readFooter(footer.object(), GetField<quint64>(header, k_TuplesOffset), GetField<quint32>(header, k_ColumnsOffset), footerOffset);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ColumnarFile::~ColumnarFile() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ColumnarFile::Write(const AttributeMatrix::Pointer& am, const QString& dataContainerName, const QString& filePath, QStringList* skipped, QString* errorMessage)
+{
+  QVector<IDataArray::Pointer> arrays;
+  QList<QString> names = am->getAttributeArrayNames();
+  for(const QString& name : names)
+  {
+    IDataArray::Pointer array = am->getAttributeArray(name);
+    if(FindColumnType(array->getTypeAsString()) == nullptr || (array->getSize() > 0 && array->getVoidPointer(0) == nullptr))
+    {
+      if(skipped != nullptr)
+      {
+        skipped->push_back(name);
+      }
+      continue;
+    }
+    arrays.push_back(array);
+  }
+
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = QObject::tr("'%1' could not be created: %2").arg(filePath).arg(file.errorString());
+    }
+    return false;
+  }
+
+  // The header is written last, once the position of the footer is known
+  QByteArray header(static_cast<int>(HeaderBytes), '\0');
+  bool ok = (file.write(header) == header.size());
+  quint64 offset = HeaderBytes;
+
+  QJsonArray columns;
+  for(const IDataArray::Pointer& array : arrays)
+  {
+    const ColumnType* type = FindColumnType(array->getTypeAsString());
+    quint64 bytes = static_cast<quint64>(array->getSize()) * type->size;
+    ok = ok && Pad(file, &offset);
+    ok = ok && (bytes == 0 || file.write(static_cast<const char*>(array->getVoidPointer(0)), static_cast<qint64>(bytes)) == static_cast<qint64>(bytes));
+
+    QJsonObject column;
+    column["name"] = array->getName();
+    column["type"] = array->getTypeAsString();
+    column["dtype"] = NumpyTypeString(*type);
+    column["componentDimensions"] = ToJsonArray(array->getComponentDimensions());
+    column["components"] = array->getNumberOfComponents();
+    column["offset"] = static_cast<double>(offset);
+    column["bytes"] = static_cast<double>(bytes);
+    columns.append(column);
+    offset += bytes;
+  }
+
+  QJsonObject footer;
+  footer["format"] = QString("SIMPLView columnar");
+  footer["version"] = static_cast<int>(Version);
+  footer["byteOrder"] = QString(QSysInfo::ByteOrder == QSysInfo::LittleEndian ? "little" : "big");
+  footer["alignment"] = static_cast<double>(Alignment);
+  footer["dataContainer"] = dataContainerName;
+  footer["attributeMatrix"] = am->getName();
+  footer["attributeMatrixType"] = static_cast<int>(am->getType());
+  footer["tupleDimensions"] = ToJsonArray(am->getTupleDimensions());
+  footer["tuples"] = static_cast<double>(am->getNumberOfTuples());
+  footer["columns"] = columns;
+  QByteArray footerJson = QJsonDocument(footer).toJson(QJsonDocument::Compact);
+  quint64 footerOffset = offset;
+  ok = ok && (file.write(footerJson) == footerJson.size());
+
+  QByteArray trailer(static_cast<int>(k_TrailerBytes), '\0');
+  PutField<quint64>(trailer, 0, footerOffset);
+  std::memcpy(trailer.data() + 8, Magic, 8);
+  ok = ok && (file.write(trailer) == trailer.size());
+
+  std::memcpy(header.data(), Magic, 8);
+  PutField<quint32>(header, k_VersionOffset, Version);
+  PutField<quint32>(header, k_HeaderBytesOffset, static_cast<quint32>(HeaderBytes));
+  PutField<quint64>(header, k_AlignmentOffset, Alignment);
+  PutField<quint64>(header, k_FooterOffsetOffset, footerOffset);
+  PutField<quint64>(header, k_FooterBytesOffset, static_cast<quint64>(footerJson.size()));
+  PutField<quint64>(header, k_TuplesOffset, static_cast<quint64>(am->getNumberOfTuples()));
+  PutField<quint32>(header, k_ColumnsOffset, static_cast<quint32>(arrays.size()));
+  PutField<quint32>(header, k_ByteOrderOffset, k_ByteOrderMark);
+  ok = ok && file.seek(0) && (file.write(header) == header.size());
+
+  if(!ok || !file.commit())
+  {
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = QObject::tr("'%1' could not be written: %2").arg(filePath).arg(file.errorString());
+    }
+    file.cancelWriting();
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFile::RegisterFilters(FilterManager* manager)
+{
+  manager->addFilterFactory("ColumnarFileWriter", FilterFactory<ColumnarFileWriter>::New());
+  manager->addFilterFactory("ColumnarFileReader", FilterFactory<ColumnarFileReader>::New());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ColumnarFile::readFooter(const QJsonObject& footer, quint64 tuples, quint32 columns, quint64 footerOffset)
+{
+  m_DataContainerName = footer["dataContainer"].toString();
+  m_AttributeMatrixName = footer["attributeMatrix"].toString();
+  m_AttributeMatrixType = static_cast<AttributeMatrix::Type>(footer["attributeMatrixType"].toInt(static_cast<int>(AttributeMatrix::Type::Generic)));
+  m_TupleDimensions = FromJsonArray(footer["tupleDimensions"].toArray());
+  m_NumberOfTuples = static_cast<size_t>(tuples);
+  if(Product(m_TupleDimensions) != m_NumberOfTuples)
+  {
+    m_ErrorMessage = QObject::tr("The tuple dimensions of '%1' do not match its %2 tuples").arg(m_FilePath).arg(tuples);
+    return false;
+  }
+
+  QJsonArray columnArray = footer["columns"].toArray();
+  if(static_cast<quint32>(columnArray.size()) != columns)
+  {
+    m_ErrorMessage = QObject::tr("The footer of '%1' lists %2 columns instead of %3").arg(m_FilePath).arg(columnArray.size()).arg(columns);
+    return false;
+  }
+  for(const QJsonValue& value : columnArray)
+  {
+    QJsonObject object = value.toObject();
+    Column column;
+    column.name = object["name"].toString();
+    column.typeName = object["type"].toString();
+    column.cDims = FromJsonArray(object["componentDimensions"].toArray());
+    column.offset = static_cast<quint64>(object["offset"].toDouble());
+    column.bytes = static_cast<quint64>(object["bytes"].toDouble());
+
+    const ColumnType* type = FindColumnType(column.typeName);
+    bool fits = (type != nullptr && !column.name.isEmpty() && !column.cDims.isEmpty());
+    fits = fits && column.bytes == static_cast<quint64>(m_NumberOfTuples) * Product(column.cDims) * type->size;
+    fits = fits && column.offset >= HeaderBytes && column.offset + column.bytes <= footerOffset;
+    if(!fits)
+    {
+      m_ErrorMessage = QObject::tr("The column '%1' of '%2' is damaged or has an unknown type").arg(column.name).arg(m_FilePath);
+      return false;
+    }
+    m_Columns.push_back(column);
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ColumnarFile::isValid() const
+{
+  return m_Valid;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ColumnarFile::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ColumnarFile::getFilePath() const
+{
+  return m_FilePath;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ColumnarFile::getDataContainerName() const
+{
+  return m_DataContainerName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ColumnarFile::getAttributeMatrixName() const
+{
+  return m_AttributeMatrixName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AttributeMatrix::Type ColumnarFile::getAttributeMatrixType() const
+{
+  return m_AttributeMatrixType;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<size_t> ColumnarFile::getTupleDimensions() const
+{
+  return m_TupleDimensions;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ColumnarFile::getNumberOfTuples() const
+{
+  return m_NumberOfTuples;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<ColumnarFile::Column> ColumnarFile::getColumns() const
+{
+  return m_Columns;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AttributeMatrix::Pointer ColumnarFile::createPrototype(const QString& name) const
+{
+  AttributeMatrix::Pointer am = AttributeMatrix::New(m_TupleDimensions, name, m_AttributeMatrixType);
+  for(const Column& column : m_Columns)
+  {
+    am->addAttributeArray(column.name, FindColumnType(column.typeName)->create(m_NumberOfTuples, column.cDims, column.name, false));
+  }
+  return am;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AttributeMatrix::Pointer ColumnarFile::map(const QString& name, bool copyOnWrite, QString* errorMessage) const
+{
+  AttributeMatrix::Pointer am = AttributeMatrix::New(m_TupleDimensions, name, m_AttributeMatrixType);
+  ArrayMemoryPool* pool = ArrayMemoryPool::Instance();
+  for(const Column& column : m_Columns)
+  {
+    // Nothing can be mapped from an empty column
+    IDataArray::Pointer array = (column.bytes == 0) ? FindColumnType(column.typeName)->create(m_NumberOfTuples, column.cDims, column.name, true)
+                                                    : pool->mapFile(m_FilePath, column.offset, column.typeName, m_NumberOfTuples, column.cDims, column.name, copyOnWrite);
+    if(array.get() == nullptr)
+    {
+      if(errorMessage != nullptr)
+      {
+        *errorMessage = QObject::tr("The column '%1' could not be mapped from '%2'").arg(column.name).arg(m_FilePath);
+      }
+      return AttributeMatrix::NullPointer();
+    }
+    am->addAttributeArray(column.name, array);
+  }
+  return am;
+}
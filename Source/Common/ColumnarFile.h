@@ -0,0 +1,164 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/Filtering/FilterManager.h"
+
+/**
+ * @brief The ColumnarFile class writes an attribute matrix to a file that holds every array as one
+ * contiguous column, and maps such a file back into an attribute matrix without reading it.
+ *
+ * The file starts with a header of HeaderBytes bytes: the Magic, the format version, the header size, the
+ * column alignment, the offset and size of the footer, the number of tuples and columns, and a byte order
+ * mark. Every column follows at an offset that is a multiple of Alignment, so each one can be mapped and
+ * scanned on its own. The footer is a JSON object describing the attribute matrix and every column with
+ * its name, SIMPL type, numpy dtype, component dimensions, offset and size. The file ends with the offset
+ * of the footer and the Magic again, so it can be read from either end.
+ *
+ * Values are stored in the byte order of the machine that wrote them, which is recorded in the header;
+ * a file from a machine with the other byte order is rejected instead of converted. Arrays that are not
+ * plain numbers, e.g. strings or neighbor lists, are left out.
+ */
+class ColumnarFile
+{
+public:
+  /**
+   * @brief The Column struct is one array of the file
+   */
+  struct Column
+  {
+    QString name;
+    QString typeName;
+    QVector<size_t> cDims;
+    quint64 offset = 0;
+    quint64 bytes = 0;
+  };
+
+  static const char Magic[9];
+  static const QString Extension;
+  static const quint32 Version = 1;
+  static const size_t HeaderBytes = 64;
+  static const size_t Alignment = 4096;
+  static const int WriteError = -9437;
+  static const int ReadError = -9438;
+
+  /**
+   * @brief Write Writes the plain number arrays of 'am' to 'filePath'. The file is replaced only once it
+   * has been written completely.
+   * @param am
+   * @param dataContainerName Recorded in the footer
+   * @param filePath
+   * @param skipped Receives the names of the arrays that were left out
+   * @param errorMessage
+   * @return
+   */
+  static bool Write(const AttributeMatrix::Pointer& am, const QString& dataContainerName, const QString& filePath, QStringList* skipped = nullptr, QString* errorMessage = nullptr);
+
+  /**
+   * @brief RegisterFilters Adds the Write Columnar File and Read Columnar File filters to 'manager'
+   * @param manager
+   */
+  static void RegisterFilters(FilterManager* manager);
+
+  /**
+   * @brief ColumnarFile Reads the header and footer of 'filePath'
+   * @param filePath
+   */
+  explicit ColumnarFile(const QString& filePath);
+  virtual ~ColumnarFile();
+
+  bool isValid() const;
+  QString getErrorMessage() const;
+
+  QString getFilePath() const;
+  QString getDataContainerName() const;
+  QString getAttributeMatrixName() const;
+  AttributeMatrix::Type getAttributeMatrixType() const;
+  QVector<size_t> getTupleDimensions() const;
+  size_t getNumberOfTuples() const;
+  QVector<Column> getColumns() const;
+
+  /**
+   * @brief createPrototype Returns an attribute matrix named 'name' with an unallocated array for every
+   * column, e.g. for a preflight
+   * @param name
+   * @return
+   */
+  AttributeMatrix::Pointer createPrototype(const QString& name) const;
+
+  /**
+   * @brief map Returns an attribute matrix named 'name' whose arrays are mapped from the columns of the file.
+   * Writing to a read-only mapping crashes; a copy-on-write mapping keeps written pages private to the
+   * process and never changes the file.
+   * @param name
+   * @param copyOnWrite
+   * @param errorMessage
+   * @return null if a column could not be mapped
+   */
+  AttributeMatrix::Pointer map(const QString& name, bool copyOnWrite, QString* errorMessage = nullptr) const;
+
+protected:
+  /**
+   * @brief readFooter Reads the attribute matrix and the columns from 'footer' and checks them against the
+   * header
+   * @param footer
+   * @param tuples The number of tuples the header records
+   * @param columns The number of columns the header records
+   * @param footerOffset Where the footer starts, which no column may reach into
+   * @return
+   */
+  bool readFooter(const QJsonObject& footer, quint64 tuples, quint32 columns, quint64 footerOffset);
+
+private:
+  QString m_FilePath;
+  QString m_ErrorMessage;
+  QString m_DataContainerName;
+  QString m_AttributeMatrixName;
+  AttributeMatrix::Type m_AttributeMatrixType = AttributeMatrix::Type::Generic;
+  QVector<size_t> m_TupleDimensions;
+  size_t m_NumberOfTuples = 0;
+  QVector<Column> m_Columns;
+  bool m_Valid = false;
+
+  ColumnarFile(const ColumnarFile&) = delete;    // Copy Constructor Not Implemented
+  void operator=(const ColumnarFile&) = delete;  // Move assignment Not Implemented
+};
@@ -0,0 +1,246 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ColumnarFileReader.h"
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/FilterParameters/DataContainerCreationFilterParameter.h"
+#include "SIMPLib/FilterParameters/InputFileFilterParameter.h"
+#include "SIMPLib/FilterParameters/StringFilterParameter.h"
+#include "SIMPLib/SIMPLibVersion.h"
+
+#include "Common/ColumnarFile.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ColumnarFileReader::ColumnarFileReader()
+: m_InputFile("")
+, m_DataContainerName("")
+, m_AttributeMatrixName("")
+{
+  initialize();
+  setupFilterParameters();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ColumnarFileReader::~ColumnarFileReader() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFileReader::initialize()
+{
+  setErrorCondition(0);
+  setWarningCondition(0);
+  setCancel(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFileReader::setupFilterParameters()
+{
+  FilterParameterVector parameters;
+  parameters.push_back(SIMPL_NEW_INPUT_FILE_FP("Input File", InputFile, FilterParameter::Parameter, ColumnarFileReader, "*." + ColumnarFile::Extension));
+  parameters.push_back(SIMPL_NEW_DC_CREATION_FP("Data Container", DataContainerName, FilterParameter::CreatedArray, ColumnarFileReader));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Attribute Matrix", AttributeMatrixName, FilterParameter::CreatedArray, ColumnarFileReader));
+  setFilterParameters(parameters);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ColumnarFileReader::getCreatedDataContainerName(const ColumnarFile& file) const
+{
+  return getDataContainerName().isEmpty() ? file.getDataContainerName() : getDataContainerName();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ColumnarFileReader::getCreatedAttributeMatrixName(const ColumnarFile& file) const
+{
+  return getAttributeMatrixName().isEmpty() ? file.getAttributeMatrixName() : getAttributeMatrixName();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFileReader::dataCheck()
+{
+  setErrorCondition(0);
+  setWarningCondition(0);
+
+  if(getInputFile().isEmpty())
+  {
+    setErrorCondition(ColumnarFile::ReadError);
+    notifyErrorMessage(getHumanLabel(), QObject::tr("The input file must be set"), getErrorCondition());
+    return;
+  }
+
+  ColumnarFile file(getInputFile());
+  if(!file.isValid())
+  {
+    setErrorCondition(ColumnarFile::ReadError);
+    notifyErrorMessage(getHumanLabel(), file.getErrorMessage(), getErrorCondition());
+    return;
+  }
+
+  DataContainer::Pointer dc = getDataContainerArray()->createNonPrereqDataContainer<AbstractFilter>(this, getCreatedDataContainerName(file));
+  if(getErrorCondition() < 0 || dc.get() == nullptr)
+  {
+    return;
+  }
+  QString amName = getCreatedAttributeMatrixName(file);
+  dc->addAttributeMatrix(amName, file.createPrototype(amName));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFileReader::preflight()
+{
+  setInPreflight(true);
+  emit preflightAboutToExecute();
+  emit updateFilterParameters(this);
+  dataCheck();
+  emit preflightExecuted();
+  setInPreflight(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFileReader::execute()
+{
+  initialize();
+  dataCheck();
+  if(getErrorCondition() < 0)
+  {
+    return;
+  }
+
+  ColumnarFile file(getInputFile());
+  QString amName = getCreatedAttributeMatrixName(file);
+  QString errorMessage;
+  AttributeMatrix::Pointer am = file.map(amName, true, &errorMessage);
+  if(am.get() == nullptr)
+  {
+    setErrorCondition(ColumnarFile::ReadError);
+    notifyErrorMessage(getHumanLabel(), errorMessage, getErrorCondition());
+    return;
+  }
+
+  // Swap the unallocated prototype from the data check for the mapped arrays
+  DataContainer::Pointer dc = getDataContainerArray()->getDataContainer(getCreatedDataContainerName(file));
+  dc->removeAttributeMatrix(amName);
+  dc->addAttributeMatrix(amName, am);
+
+  notifyStatusMessage(getHumanLabel(), "Complete");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer ColumnarFileReader::newFilterInstance(bool copyFilterParameters) const
+{
+  ColumnarFileReader::Pointer filter = ColumnarFileReader::New();
+  if(copyFilterParameters)
+  {
+    copyFilterParameterInstanceVariables(filter.get());
+  }
+  return filter;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileReader::getCompiledLibraryName() const
+{
+  return "SIMPLView";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileReader::getBrandingString() const
+{
+  return "SIMPLView";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileReader::getFilterVersion() const
+{
+  return SIMPLib::Version::Complete();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileReader::getGroupName() const
+{
+  return SIMPL::FilterGroups::IOFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileReader::getSubGroupName() const
+{
+  return SIMPL::FilterSubGroups::InputFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileReader::getHumanLabel() const
+{
+  return "Read Columnar File";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QUuid ColumnarFileReader::getUuid()
+{
+  return QUuid("{8e1d4b3c-2f6a-5c9e-a7b1-3d4e5f607182}");
+}
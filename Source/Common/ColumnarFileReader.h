@@ -0,0 +1,122 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+class ColumnarFile;
+
+/**
+ * @brief The ColumnarFileReader class is the Read Columnar File filter. It adds a Data Container holding the
+ * attribute matrix of a ColumnarFile, whose arrays are mapped from the file instead of read. The mappings are
+ * always copy-on-write, so later filters may change the arrays in place without touching the file.
+ */
+class ColumnarFileReader : public AbstractFilter
+{
+  Q_OBJECT
+
+public:
+  SIMPL_SHARED_POINTERS(ColumnarFileReader)
+  SIMPL_FILTER_NEW_MACRO(ColumnarFileReader)
+  SIMPL_TYPE_MACRO_SUPER(ColumnarFileReader, AbstractFilter)
+
+  ~ColumnarFileReader() override;
+
+  SIMPL_FILTER_PARAMETER(QString, InputFile)
+  Q_PROPERTY(QString InputFile READ getInputFile WRITE setInputFile)
+
+  SIMPL_FILTER_PARAMETER(QString, DataContainerName)
+  Q_PROPERTY(QString DataContainerName READ getDataContainerName WRITE setDataContainerName)
+
+  SIMPL_FILTER_PARAMETER(QString, AttributeMatrixName)
+  Q_PROPERTY(QString AttributeMatrixName READ getAttributeMatrixName WRITE setAttributeMatrixName)
+
+  const QString getCompiledLibraryName() const override;
+  const QString getBrandingString() const override;
+  const QString getFilterVersion() const override;
+  AbstractFilter::Pointer newFilterInstance(bool copyFilterParameters) const override;
+  const QString getGroupName() const override;
+  const QString getSubGroupName() const override;
+  const QUuid getUuid() override;
+  const QString getHumanLabel() const override;
+  void setupFilterParameters() override;
+  void execute() override;
+  void preflight() override;
+
+signals:
+  void updateFilterParameters(AbstractFilter* filter);
+  void parametersChanged();
+  void preflightAboutToExecute();
+  void preflightExecuted();
+
+protected:
+  ColumnarFileReader();
+
+  /**
+   * @brief dataCheck Reads the header and footer of the input file and adds the Data Container with
+   * unallocated arrays
+   */
+  void dataCheck();
+
+  /**
+   * @brief getCreatedDataContainerName Returns the name of the created Data Container, which defaults to
+   * the one recorded in 'file'
+   * @param file
+   * @return
+   */
+  QString getCreatedDataContainerName(const ColumnarFile& file) const;
+
+  /**
+   * @brief getCreatedAttributeMatrixName Returns the name of the created attribute matrix, which defaults
+   * to the one recorded in 'file'
+   * @param file
+   * @return
+   */
+  QString getCreatedAttributeMatrixName(const ColumnarFile& file) const;
+
+  /**
+   * @brief Initializes all the private instance variables.
+   */
+  void initialize();
+
+public:
+  ColumnarFileReader(const ColumnarFileReader&) = delete;            // Copy Constructor Not Implemented
+  ColumnarFileReader& operator=(const ColumnarFileReader&) = delete; // Copy Assignment Not Implemented
+  ColumnarFileReader(ColumnarFileReader&&) = delete;                 // Move Constructor Not Implemented
+  ColumnarFileReader& operator=(ColumnarFileReader&&) = delete;      // Move Assignment Not Implemented
+};
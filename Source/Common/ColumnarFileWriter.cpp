@@ -0,0 +1,222 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ColumnarFileWriter.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/FilterParameters/AttributeMatrixSelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/OutputFileFilterParameter.h"
+#include "SIMPLib/SIMPLibVersion.h"
+
+#include "Common/ColumnarFile.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ColumnarFileWriter::ColumnarFileWriter()
+: m_SelectedAttributeMatrixPath("", "", "")
+, m_OutputFile("")
+{
+  initialize();
+  setupFilterParameters();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ColumnarFileWriter::~ColumnarFileWriter() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFileWriter::initialize()
+{
+  setErrorCondition(0);
+  setWarningCondition(0);
+  setCancel(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFileWriter::setupFilterParameters()
+{
+  FilterParameterVector parameters;
+  parameters.push_back(SIMPL_NEW_OUTPUT_FILE_FP("Output File", OutputFile, FilterParameter::Parameter, ColumnarFileWriter, "*." + ColumnarFile::Extension, "Columnar File"));
+  AttributeMatrixSelectionFilterParameter::RequirementType requirement = AttributeMatrixSelectionFilterParameter::CreateRequirement(AttributeMatrix::Category::Any);
+  parameters.push_back(SIMPL_NEW_AM_SELECTION_FP("Attribute Matrix", SelectedAttributeMatrixPath, FilterParameter::RequiredArray, ColumnarFileWriter, requirement));
+  setFilterParameters(parameters);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFileWriter::dataCheck()
+{
+  setErrorCondition(0);
+  setWarningCondition(0);
+
+  if(getOutputFile().isEmpty())
+  {
+    setErrorCondition(ColumnarFile::WriteError);
+    notifyErrorMessage(getHumanLabel(), QObject::tr("The output file must be set"), getErrorCondition());
+    return;
+  }
+  getDataContainerArray()->getPrereqAttributeMatrixFromPath<AbstractFilter>(this, getSelectedAttributeMatrixPath(), ColumnarFile::WriteError);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFileWriter::preflight()
+{
+  setInPreflight(true);
+  emit preflightAboutToExecute();
+  emit updateFilterParameters(this);
+  dataCheck();
+  emit preflightExecuted();
+  setInPreflight(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ColumnarFileWriter::execute()
+{
+  initialize();
+  dataCheck();
+  if(getErrorCondition() < 0)
+  {
+    return;
+  }
+
+  QFileInfo fi(getOutputFile());
+  if(!QDir().mkpath(fi.absolutePath()))
+  {
+    setErrorCondition(ColumnarFile::WriteError);
+    notifyErrorMessage(getHumanLabel(), QObject::tr("The directory '%1' could not be created").arg(fi.absolutePath()), getErrorCondition());
+    return;
+  }
+
+  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(getSelectedAttributeMatrixPath());
+  QStringList skipped;
+  QString errorMessage;
+  if(!ColumnarFile::Write(am, getSelectedAttributeMatrixPath().getDataContainerName(), getOutputFile(), &skipped, &errorMessage))
+  {
+    setErrorCondition(ColumnarFile::WriteError);
+    notifyErrorMessage(getHumanLabel(), errorMessage, getErrorCondition());
+    return;
+  }
+  if(!skipped.isEmpty())
+  {
+    setWarningCondition(ColumnarFile::WriteError);
+    notifyWarningMessage(getHumanLabel(), QObject::tr("Arrays that are not plain numbers were left out: %1").arg(skipped.join(", ")), getWarningCondition());
+  }
+
+  notifyStatusMessage(getHumanLabel(), "Complete");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer ColumnarFileWriter::newFilterInstance(bool copyFilterParameters) const
+{
+  ColumnarFileWriter::Pointer filter = ColumnarFileWriter::New();
+  if(copyFilterParameters)
+  {
+    copyFilterParameterInstanceVariables(filter.get());
+  }
+  return filter;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileWriter::getCompiledLibraryName() const
+{
+  return "SIMPLView";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileWriter::getBrandingString() const
+{
+  return "SIMPLView";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileWriter::getFilterVersion() const
+{
+  return SIMPLib::Version::Complete();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileWriter::getGroupName() const
+{
+  return SIMPL::FilterGroups::IOFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileWriter::getSubGroupName() const
+{
+  return SIMPL::FilterSubGroups::OutputFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString ColumnarFileWriter::getHumanLabel() const
+{
+  return "Write Columnar File";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QUuid ColumnarFileWriter::getUuid()
+{
+  return QUuid("{6c3f1a2e-8d4b-5e7f-9a10-2b3c4d5e6f70}");
+}
@@ -0,0 +1,99 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The ColumnarFileWriter class is the Write Columnar File filter. It writes the plain number arrays of
+ * an attribute matrix to a ColumnarFile, whose columns other tools can map and scan directly.
+ */
+class ColumnarFileWriter : public AbstractFilter
+{
+  Q_OBJECT
+
+public:
+  SIMPL_SHARED_POINTERS(ColumnarFileWriter)
+  SIMPL_FILTER_NEW_MACRO(ColumnarFileWriter)
+  SIMPL_TYPE_MACRO_SUPER(ColumnarFileWriter, AbstractFilter)
+
+  ~ColumnarFileWriter() override;
+
+  SIMPL_FILTER_PARAMETER(DataArrayPath, SelectedAttributeMatrixPath)
+  Q_PROPERTY(DataArrayPath SelectedAttributeMatrixPath READ getSelectedAttributeMatrixPath WRITE setSelectedAttributeMatrixPath)
+
+  SIMPL_FILTER_PARAMETER(QString, OutputFile)
+  Q_PROPERTY(QString OutputFile READ getOutputFile WRITE setOutputFile)
+
+  const QString getCompiledLibraryName() const override;
+  const QString getBrandingString() const override;
+  const QString getFilterVersion() const override;
+  AbstractFilter::Pointer newFilterInstance(bool copyFilterParameters) const override;
+  const QString getGroupName() const override;
+  const QString getSubGroupName() const override;
+  const QUuid getUuid() override;
+  const QString getHumanLabel() const override;
+  void setupFilterParameters() override;
+  void execute() override;
+  void preflight() override;
+
+signals:
+  void updateFilterParameters(AbstractFilter* filter);
+  void parametersChanged();
+  void preflightAboutToExecute();
+  void preflightExecuted();
+
+protected:
+  ColumnarFileWriter();
+
+  /**
+   * @brief dataCheck Checks for the attribute matrix and the output file
+   */
+  void dataCheck();
+
+  /**
+   * @brief Initializes all the private instance variables.
+   */
+  void initialize();
+
+public:
+  ColumnarFileWriter(const ColumnarFileWriter&) = delete;            // Copy Constructor Not Implemented
+  ColumnarFileWriter& operator=(const ColumnarFileWriter&) = delete; // Copy Assignment Not Implemented
+  ColumnarFileWriter(ColumnarFileWriter&&) = delete;                 // Move Constructor Not Implemented
+  ColumnarFileWriter& operator=(ColumnarFileWriter&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,531 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "CompressedArray.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+#include "Common/ArrayMemoryPool.h"
+
+namespace
+{
+// Blocks are handed to qCompress, which takes an int size
+const size_t k_MaximumBlockBytes = 64 * 1024 * 1024;
+
+// A block whose runs shrink it this much is not worth trying deflate on
+const size_t k_GoodRunLengthRatio = 16;
+
+using RunLength = quint32;
+
+/**
+ * @brief RunLengthEncode Encodes 'count' elements as pairs of a run length and an element. Elements are
+ * compared bit for bit through an unsigned type of their size, so NaNs and negative zeros survive.
+ * @return The encoded data, or an empty array as soon as it would not be smaller than the input
+ */
+template <typename T>
+QByteArray RunLengthEncode(const char* data, size_t count)
+{
+  const size_t inputBytes = count * sizeof(T);
+  const size_t entryBytes = sizeof(RunLength) + sizeof(T);
+  QByteArray encoded(static_cast<int>(inputBytes), Qt::Uninitialized);
+  char* out = encoded.data();
+  size_t outBytes = 0;
+
+  size_t i = 0;
+  while(i < count)
+  {
+    T value;
+    std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+    size_t run = 1;
+    while(i + run < count && run < std::numeric_limits<RunLength>::max())
+    {
+      T next;
+      std::memcpy(&next, data + (i + run) * sizeof(T), sizeof(T));
+      if(next != value)
+      {
+        break;
+      }
+      run++;
+    }
+
+    if(outBytes + entryBytes >= inputBytes)
+    {
+      return QByteArray();
+    }
+    RunLength length = static_cast<RunLength>(run);
+    std::memcpy(out + outBytes, &length, sizeof(RunLength));
+    std::memcpy(out + outBytes + sizeof(RunLength), &value, sizeof(T));
+    outBytes += entryBytes;
+    i += run;
+  }
+  encoded.resize(static_cast<int>(outBytes));
+  return encoded;
+}
+
+/**
+ * @brief RunLengthDecode Expands the runs of 'encoded' into 'count' elements at 'destination'
+ * @return false if the runs do not add up to 'count'
+ */
+template <typename T>
+bool RunLengthDecode(const QByteArray& encoded, char* destination, size_t count)
+{
+  const char* in = encoded.constData();
+  const size_t entryBytes = sizeof(RunLength) + sizeof(T);
+  const size_t entries = static_cast<size_t>(encoded.size()) / entryBytes;
+
+  size_t filled = 0;
+  for(size_t e = 0; e < entries; e++)
+  {
+    RunLength length = 0;
+    T value;
+    std::memcpy(&length, in + e * entryBytes, sizeof(RunLength));
+    std::memcpy(&value, in + e * entryBytes + sizeof(RunLength), sizeof(T));
+    if(filled + length > count)
+    {
+      return false;
+    }
+    for(size_t j = 0; j < length; j++)
+    {
+      std::memcpy(destination + (filled + j) * sizeof(T), &value, sizeof(T));
+    }
+    filled += length;
+  }
+  return filled == count;
+}
+
+QByteArray EncodeRuns(const char* data, size_t bytes, size_t elementBytes)
+{
+  switch(elementBytes)
+  {
+  case 1:
+    return RunLengthEncode<uint8_t>(data, bytes);
+  case 2:
+    return RunLengthEncode<uint16_t>(data, bytes / 2);
+  case 4:
+    return RunLengthEncode<uint32_t>(data, bytes / 4);
+  case 8:
+    return RunLengthEncode<uint64_t>(data, bytes / 8);
+  default:
+    return QByteArray();
+  }
+}
+
+bool DecodeRuns(const QByteArray& encoded, char* destination, size_t bytes, size_t elementBytes)
+{
+  switch(elementBytes)
+  {
+  case 1:
+    return RunLengthDecode<uint8_t>(encoded, destination, bytes);
+  case 2:
+    return RunLengthDecode<uint16_t>(encoded, destination, bytes / 2);
+  case 4:
+    return RunLengthDecode<uint32_t>(encoded, destination, bytes / 4);
+  case 8:
+    return RunLengthDecode<uint64_t>(encoded, destination, bytes / 8);
+  default:
+    return false;
+  }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+CompressedArray::CompressedArray() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+CompressedArray::~CompressedArray() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+CompressedArray::Pointer CompressedArray::Compress(const IDataArray::Pointer& array, size_t blockBytes)
+{
+  if(array.get() == nullptr || array->getSize() == 0 || array->getVoidPointer(0) == nullptr)
+  {
+    return Pointer();
+  }
+
+  Pointer compressed(new CompressedArray());
+  compressed->m_Prototype = array->createNewArray(array->getNumberOfTuples(), array->getComponentDimensions(), array->getName(), false);
+  compressed->m_ElementBytes = std::max<size_t>(array->getTypeSize(), 1);
+  compressed->m_Bytes = array->getSize() * compressed->m_ElementBytes;
+  blockBytes = std::min(std::max(blockBytes, compressed->m_ElementBytes), k_MaximumBlockBytes);
+  compressed->m_BlockBytes = blockBytes - blockBytes % compressed->m_ElementBytes;
+
+  size_t blockCount = (compressed->m_Bytes + compressed->m_BlockBytes - 1) / compressed->m_BlockBytes;
+  compressed->m_Blocks.resize(static_cast<int>(blockCount));
+
+  const char* data = reinterpret_cast<const char*>(array->getVoidPointer(0));
+  Block* blocks = compressed->m_Blocks.data();
+  size_t totalBytes = compressed->m_Bytes;
+  size_t stride = compressed->m_BlockBytes;
+  size_t elementBytes = compressed->m_ElementBytes;
+  auto encode = [=](size_t first, size_t last) {
+    for(size_t b = first; b < last; b++)
+    {
+      size_t offset = b * stride;
+      blocks[b] = EncodeBlock(data + offset, std::min(stride, totalBytes - offset), elementBytes);
+    }
+  };
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, blockCount), [&encode](const tbb::blocked_range<size_t>& range) { encode(range.begin(), range.end()); }, tbb::auto_partitioner());
+#else
+  encode(0, blockCount);
+#endif
+
+  return compressed;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+CompressedArray::Block CompressedArray::EncodeBlock(const char* data, size_t bytes, size_t elementBytes)
+{
+  Block block;
+  block.bytes = bytes;
+
+  QByteArray runs = EncodeRuns(data, bytes, elementBytes);
+  if(!runs.isEmpty() && static_cast<size_t>(runs.size()) * k_GoodRunLengthRatio <= bytes)
+  {
+    block.codec = Codec::RunLength;
+    block.data = runs;
+    return block;
+  }
+
+  // Level 1 is several times faster than the default and loses little on this kind of data
+  QByteArray deflated = qCompress(reinterpret_cast<const uchar*>(data), static_cast<int>(bytes), 1);
+  if(!runs.isEmpty() && runs.size() <= deflated.size())
+  {
+    block.codec = Codec::RunLength;
+    block.data = runs;
+  }
+  else if(static_cast<size_t>(deflated.size()) < bytes)
+  {
+    block.codec = Codec::Deflate;
+    block.data = deflated;
+  }
+  else
+  {
+    block.codec = Codec::Raw;
+    block.data = QByteArray(data, static_cast<int>(bytes));
+  }
+  return block;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool CompressedArray::decodeBlock(int index, char* destination) const
+{
+  const Block& block = m_Blocks[index];
+  switch(block.codec)
+  {
+  case Codec::Raw:
+    std::memcpy(destination, block.data.constData(), block.bytes);
+    return true;
+  case Codec::RunLength:
+    return DecodeRuns(block.data, destination, block.bytes, m_ElementBytes);
+  case Codec::Deflate:
+  {
+    QByteArray inflated = qUncompress(block.data);
+    if(static_cast<size_t>(inflated.size()) != block.bytes)
+    {
+      return false;
+    }
+    std::memcpy(destination, inflated.constData(), block.bytes);
+    return true;
+  }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer CompressedArray::getPrototype() const
+{
+  return m_Prototype;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t CompressedArray::getBytes() const
+{
+  return m_Bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t CompressedArray::getCompressedBytes() const
+{
+  size_t bytes = 0;
+  for(const Block& block : m_Blocks)
+  {
+    bytes += static_cast<size_t>(block.data.size());
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double CompressedArray::getRatio() const
+{
+  size_t compressedBytes = getCompressedBytes();
+  return compressedBytes > 0 ? static_cast<double>(m_Bytes) / static_cast<double>(compressedBytes) : 1.0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int CompressedArray::getBlockCount() const
+{
+  return m_Blocks.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t CompressedArray::getBlockBytes() const
+{
+  return m_BlockBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+CompressedArray::Codec CompressedArray::getCodec(int index) const
+{
+  return m_Blocks[index].codec;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CompressedArray::setCacheBlocks(int blocks)
+{
+  QMutexLocker locker(&m_CacheMutex);
+  m_CacheBlocks = std::max(blocks, 1);
+  while(m_Cache.size() > m_CacheBlocks)
+  {
+    m_Cache.removeLast();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int CompressedArray::getCacheBlocks() const
+{
+  QMutexLocker locker(&m_CacheMutex);
+  return m_CacheBlocks;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray CompressedArray::block(int index) const
+{
+  if(index < 0 || index >= m_Blocks.size())
+  {
+    return QByteArray();
+  }
+
+  QMutexLocker locker(&m_CacheMutex);
+  for(int i = 0; i < m_Cache.size(); i++)
+  {
+    if(m_Cache[i].first == index)
+    {
+      m_CacheHits++;
+      m_Cache.move(i, 0);
+      return m_Cache.front().second;
+    }
+  }
+
+  m_CacheMisses++;
+  QByteArray decoded(static_cast<int>(m_Blocks[index].bytes), Qt::Uninitialized);
+  if(!decodeBlock(index, decoded.data()))
+  {
+    return QByteArray();
+  }
+  m_Cache.push_front(qMakePair(index, decoded));
+  while(m_Cache.size() > m_CacheBlocks)
+  {
+    m_Cache.removeLast();
+  }
+  return decoded;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool CompressedArray::read(size_t offset, size_t bytes, void* destination) const
+{
+  if(offset > m_Bytes || bytes > m_Bytes - offset)
+  {
+    return false;
+  }
+
+  char* out = reinterpret_cast<char*>(destination);
+  while(bytes > 0)
+  {
+    int index = static_cast<int>(offset / m_BlockBytes);
+    size_t within = offset % m_BlockBytes;
+    QByteArray decoded = block(index);
+    if(decoded.isEmpty())
+    {
+      return false;
+    }
+    size_t count = std::min(bytes, static_cast<size_t>(decoded.size()) - within);
+    std::memcpy(out, decoded.constData() + within, count);
+    out += count;
+    offset += count;
+    bytes -= count;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CompressedArray::forEachBlock(const std::function<bool(const char*, size_t)>& visit) const
+{
+  QByteArray scratch(static_cast<int>(m_BlockBytes), Qt::Uninitialized);
+  for(int i = 0; i < m_Blocks.size(); i++)
+  {
+    const Block& block = m_Blocks[i];
+    const char* data = block.data.constData();
+    if(block.codec != Codec::Raw)
+    {
+      if(!decodeBlock(i, scratch.data()))
+      {
+        return;
+      }
+      data = scratch.constData();
+    }
+    if(!visit(data, block.bytes))
+    {
+      return;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool CompressedArray::matches(const IDataArray::Pointer& array) const
+{
+  if(array.get() == nullptr || array->getTypeAsString() != m_Prototype->getTypeAsString() || array->getSize() * std::max<size_t>(array->getTypeSize(), 1) != m_Bytes ||
+     array->getVoidPointer(0) == nullptr)
+  {
+    return false;
+  }
+
+  const char* data = reinterpret_cast<const char*>(array->getVoidPointer(0));
+  size_t offset = 0;
+  bool equal = true;
+  forEachBlock([data, &offset, &equal](const char* block, size_t bytes) {
+    equal = (std::memcmp(data + offset, block, bytes) == 0);
+    offset += bytes;
+    return equal;
+  });
+  return equal && offset == m_Bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer CompressedArray::decompress() const
+{
+  IDataArray::Pointer array = ArrayMemoryPool::Instance()->createArrayLike(m_Prototype, m_Prototype->getNumberOfTuples(), m_Prototype->getName());
+  if(array.get() == nullptr || array->getVoidPointer(0) == nullptr)
+  {
+    return IDataArray::Pointer();
+  }
+
+  char* data = reinterpret_cast<char*>(array->getVoidPointer(0));
+  std::vector<char> decoded(static_cast<size_t>(m_Blocks.size()), 0);
+  auto decode = [this, data, &decoded](size_t first, size_t last) {
+    for(size_t b = first; b < last; b++)
+    {
+      decoded[b] = decodeBlock(static_cast<int>(b), data + b * m_BlockBytes);
+    }
+  };
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, static_cast<size_t>(m_Blocks.size())), [&decode](const tbb::blocked_range<size_t>& range) { decode(range.begin(), range.end()); },
+                    tbb::auto_partitioner());
+#else
+  decode(0, static_cast<size_t>(m_Blocks.size()));
+#endif
+
+  if(std::find(decoded.begin(), decoded.end(), 0) != decoded.end())
+  {
+    return IDataArray::Pointer();
+  }
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t CompressedArray::getCacheHits() const
+{
+  QMutexLocker locker(&m_CacheMutex);
+  return m_CacheHits;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t CompressedArray::getCacheMisses() const
+{
+  QMutexLocker locker(&m_CacheMutex);
+  return m_CacheMisses;
+}
@@ -0,0 +1,202 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataArrays/IDataArray.h"
+
+/**
+ * @brief The CompressedArray class holds the contents of a data array in independently compressed blocks.
+ *
+ * Every block is encoded with whichever of run-length encoding (runs of equal elements, which suits feature
+ * ids, phases and masks) and deflate is smaller, or stored as is if neither helps. Blocks are compressed and
+ * decompressed in parallel.
+ *
+ * Random access through block() and read() goes through a small cache of decompressed blocks, so reading
+ * neighbouring values does not decompress a block again. forEachBlock() visits the blocks in order with one
+ * scratch buffer and leaves the cache alone, and decompress() writes every block straight into a new array.
+ */
+class CompressedArray
+{
+public:
+  using Pointer = std::shared_ptr<CompressedArray>;
+
+  enum class Codec
+  {
+    Raw,
+    RunLength,
+    Deflate
+  };
+
+  static const size_t DefaultBlockBytes = 256 * 1024;
+  static const int DefaultCacheBlocks = 8;
+
+  /**
+   * @brief Compress Returns the compressed contents of 'array', or null if the array does not keep its
+   * values in one contiguous buffer
+   * @param array
+   * @param blockBytes The decompressed size of a block, rounded down to whole elements
+   * @return
+   */
+  static Pointer Compress(const IDataArray::Pointer& array, size_t blockBytes = DefaultBlockBytes);
+
+  virtual ~CompressedArray();
+
+  /**
+   * @brief getPrototype Returns an unallocated array with the name, type, tuples and components of the
+   * compressed one
+   * @return
+   */
+  IDataArray::Pointer getPrototype() const;
+
+  size_t getBytes() const;
+  size_t getCompressedBytes() const;
+
+  /**
+   * @brief getRatio Returns the decompressed size divided by the compressed size
+   * @return
+   */
+  double getRatio() const;
+
+  int getBlockCount() const;
+  size_t getBlockBytes() const;
+
+  /**
+   * @brief getCodec Returns how block 'index' is encoded
+   * @param index
+   * @return
+   */
+  Codec getCodec(int index) const;
+
+  /**
+   * @brief setCacheBlocks Sets how many decompressed blocks block() and read() keep
+   * @param blocks
+   */
+  void setCacheBlocks(int blocks);
+  int getCacheBlocks() const;
+
+  /**
+   * @brief block Returns the decompressed block 'index' from the cache, decompressing it on a miss
+   * @param index
+   * @return
+   */
+  QByteArray block(int index) const;
+
+  /**
+   * @brief read Copies 'bytes' starting at byte 'offset' of the decompressed contents to 'destination'
+   * @param offset
+   * @param bytes
+   * @param destination
+   * @return false if the range is outside the array
+   */
+  bool read(size_t offset, size_t bytes, void* destination) const;
+
+  /**
+   * @brief forEachBlock Calls 'visit' with every decompressed block in order until it returns false
+   * @param visit Called with the data and the size of a block
+   */
+  void forEachBlock(const std::function<bool(const char*, size_t)>& visit) const;
+
+  /**
+   * @brief matches Returns true if 'array' has the type, size and contents of the compressed array, e.g.
+   * before the copy is reused for an array a filter may have changed in place
+   * @param array
+   * @return
+   */
+  bool matches(const IDataArray::Pointer& array) const;
+
+  /**
+   * @brief decompress Returns a new array with the decompressed contents, taken from the ArrayMemoryPool
+   * @return
+   */
+  IDataArray::Pointer decompress() const;
+
+  size_t getCacheHits() const;
+  size_t getCacheMisses() const;
+
+protected:
+  CompressedArray();
+
+  struct Block
+  {
+    Codec codec = Codec::Raw;
+    size_t bytes = 0;
+    QByteArray data;
+  };
+
+  /**
+   * @brief EncodeBlock Encodes 'bytes' of 'data' with the smallest codec
+   * @param data
+   * @param bytes
+   * @param elementBytes
+   * @return
+   */
+  static Block EncodeBlock(const char* data, size_t bytes, size_t elementBytes);
+
+  /**
+   * @brief decodeBlock Decodes block 'index' into 'destination', which holds the whole block
+   * @param index
+   * @param destination
+   * @return
+   */
+  bool decodeBlock(int index, char* destination) const;
+
+private:
+  IDataArray::Pointer m_Prototype;
+  size_t m_Bytes = 0;
+  size_t m_BlockBytes = 0;
+  size_t m_ElementBytes = 1;
+  QVector<Block> m_Blocks;
+
+  // Most recently used first
+  mutable QMutex m_CacheMutex;
+  mutable QList<QPair<int, QByteArray>> m_Cache;
+  int m_CacheBlocks = DefaultCacheBlocks;
+  mutable size_t m_CacheHits = 0;
+  mutable size_t m_CacheMisses = 0;
+
+  CompressedArray(const CompressedArray&) = delete; // Copy Constructor Not Implemented
+  void operator=(const CompressedArray&) = delete;  // Move assignment Not Implemented
+};
@@ -0,0 +1,392 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "DataSnapshotStore.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QObject>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "Common/ArrayMemoryPool.h"
+#include "Common/MemoryEstimator.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataSnapshotStore::DataSnapshotStore(size_t chunkBytes)
+: m_ChunkBytes(std::max(chunkBytes, static_cast<size_t>(4096)))
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataSnapshotStore::~DataSnapshotStore() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DataSnapshotStore::Key(const QString& dcName, const QString& amName, const QString& arrayName)
+{
+  return DataArrayPath(dcName, amName, arrayName).serialize("|");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataSnapshotStore::StoredArray DataSnapshotStore::storeArray(const IDataArray::Pointer& array, const StoredArray* previous, bool compare, size_t* copiedBytes) const
+{
+  StoredArray stored;
+  stored.typeName = array->getTypeAsString();
+  stored.bytes = array->getSize() * array->getTypeSize();
+
+  const char* data = static_cast<const char*>(array->getVoidPointer(0));
+  if(data == nullptr)
+  {
+    if(previous != nullptr && previous->whole.get() != nullptr && !compare)
+    {
+      stored.whole = previous->whole;
+    }
+    else if(stored.bytes > 0)
+    {
+      stored.whole = array->deepCopy();
+      *copiedBytes += stored.bytes;
+    }
+    return stored;
+  }
+
+  // A previous version of a different type or size cannot share anything
+  if(previous != nullptr && (previous->whole.get() != nullptr || previous->typeName != stored.typeName || previous->bytes != stored.bytes))
+  {
+    previous = nullptr;
+  }
+
+  size_t chunkCount = (stored.bytes + m_ChunkBytes - 1) / m_ChunkBytes;
+  stored.chunks.reserve(static_cast<int>(chunkCount));
+  for(size_t i = 0; i < chunkCount; i++)
+  {
+    size_t offset = i * m_ChunkBytes;
+    size_t length = std::min(m_ChunkBytes, stored.bytes - offset);
+    if(previous != nullptr)
+    {
+      const Chunk& chunk = previous->chunks[static_cast<int>(i)];
+      if(!compare || std::memcmp(chunk->constData(), data + offset, length) == 0)
+      {
+        stored.chunks.push_back(chunk);
+        continue;
+      }
+    }
+    stored.chunks.push_back(std::make_shared<const QByteArray>(data + offset, static_cast<int>(length)));
+    *copiedBytes += length;
+  }
+  return stored;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int DataSnapshotStore::take(const DataContainerArray::Pointer& dca, const QString& label, const QSet<QString>* touchedContainers)
+{
+  QMutexLocker locker(&m_Mutex);
+
+  Snapshot snapshot;
+  snapshot.label = label;
+  snapshot.structure = dca->deepCopy(true);
+
+  const Snapshot* previous = m_Snapshots.isEmpty() ? nullptr : &m_Snapshots.back();
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    bool compare = (touchedContainers == nullptr || touchedContainers->contains(dc->getName()));
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        QString key = Key(dc->getName(), am->getName(), name);
+        const StoredArray* previousArray = nullptr;
+        if(previous != nullptr && previous->arrays.contains(key))
+        {
+          previousArray = &previous->arrays.constFind(key).value();
+        }
+        snapshot.arrays.insert(key, storeArray(am->getAttributeArray(name), previousArray, compare, &snapshot.copiedBytes));
+      }
+    }
+  }
+
+  // Containers that are checked out by a running filter are missing from 'dca'. Unless they are known to be
+  // untouched they may as well have been removed, so only the untouched ones carry over.
+  if(previous != nullptr && touchedContainers != nullptr)
+  {
+    QList<DataContainer::Pointer> previousContainers = previous->structure->getDataContainers();
+    for(const DataContainer::Pointer& dc : previousContainers)
+    {
+      if(dca->doesDataContainerExist(dc->getName()) || touchedContainers->contains(dc->getName()))
+      {
+        continue;
+      }
+      snapshot.structure->addDataContainer(dc->deepCopy(true));
+      DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+      for(const AttributeMatrix::Pointer& am : matrices)
+      {
+        QList<QString> names = am->getAttributeArrayNames();
+        for(const QString& name : names)
+        {
+          QString key = Key(dc->getName(), am->getName(), name);
+          if(previous->arrays.contains(key))
+          {
+            snapshot.arrays.insert(key, previous->arrays.value(key));
+          }
+        }
+      }
+    }
+  }
+
+  m_Snapshots.push_back(snapshot);
+  return m_Snapshots.size() - 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer DataSnapshotStore::restore(int index) const
+{
+  QMutexLocker locker(&m_Mutex);
+  if(index < 0 || index >= m_Snapshots.size())
+  {
+    return DataContainerArray::NullPointer();
+  }
+
+  const Snapshot& snapshot = m_Snapshots[index];
+  DataContainerArray::Pointer dca = snapshot.structure->deepCopy(true);
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        QString key = Key(dc->getName(), am->getName(), name);
+        if(!snapshot.arrays.contains(key))
+        {
+          continue;
+        }
+        const StoredArray& stored = snapshot.arrays.constFind(key).value();
+        IDataArray::Pointer prototype = am->removeAttributeArray(name);
+        if(stored.whole.get() != nullptr)
+        {
+          am->addAttributeArray(name, stored.whole->deepCopy());
+          continue;
+        }
+
+        IDataArray::Pointer array = ArrayMemoryPool::Instance()->createArrayLike(prototype, prototype->getNumberOfTuples(), name);
+        char* data = static_cast<char*>(array->getVoidPointer(0));
+        size_t offset = 0;
+        for(const Chunk& chunk : stored.chunks)
+        {
+          std::memcpy(data + offset, chunk->constData(), static_cast<size_t>(chunk->size()));
+          offset += static_cast<size_t>(chunk->size());
+        }
+        am->addAttributeArray(name, array);
+      }
+    }
+  }
+  return dca;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int DataSnapshotStore::size() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_Snapshots.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DataSnapshotStore::label(int index) const
+{
+  QMutexLocker locker(&m_Mutex);
+  return (index >= 0 && index < m_Snapshots.size()) ? m_Snapshots[index].label : QString();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DataSnapshotStore::remove(int index)
+{
+  QMutexLocker locker(&m_Mutex);
+  if(index >= 0 && index < m_Snapshots.size())
+  {
+    m_Snapshots.remove(index);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DataSnapshotStore::clear()
+{
+  QMutexLocker locker(&m_Mutex);
+  m_Snapshots.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SnapshotAccounting DataSnapshotStore::accounting(int index) const
+{
+  QMutexLocker locker(&m_Mutex);
+  SnapshotAccounting accounting;
+  if(index < 0 || index >= m_Snapshots.size())
+  {
+    return accounting;
+  }
+
+  const Snapshot& snapshot = m_Snapshots[index];
+  accounting.copiedBytes = snapshot.copiedBytes;
+  for(const StoredArray& stored : snapshot.arrays)
+  {
+    // Only snapshots hold chunks and whole copies, so any other reference is another snapshot
+    if(stored.whole.get() != nullptr)
+    {
+      if(stored.whole.use_count() > 1)
+      {
+        accounting.sharedBytes += stored.bytes;
+      }
+      else
+      {
+        accounting.privateBytes += stored.bytes;
+      }
+      continue;
+    }
+    for(const Chunk& chunk : stored.chunks)
+    {
+      if(chunk.use_count() > 1)
+      {
+        accounting.sharedBytes += static_cast<size_t>(chunk->size());
+      }
+      else
+      {
+        accounting.privateBytes += static_cast<size_t>(chunk->size());
+      }
+    }
+  }
+  return accounting;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t DataSnapshotStore::getStoredBytes() const
+{
+  QMutexLocker locker(&m_Mutex);
+  QSet<const void*> counted;
+  size_t bytes = 0;
+  for(const Snapshot& snapshot : m_Snapshots)
+  {
+    for(const StoredArray& stored : snapshot.arrays)
+    {
+      if(stored.whole.get() != nullptr)
+      {
+        if(!counted.contains(stored.whole.get()))
+        {
+          counted.insert(stored.whole.get());
+          bytes += stored.bytes;
+        }
+        continue;
+      }
+      for(const Chunk& chunk : stored.chunks)
+      {
+        if(!counted.contains(chunk.get()))
+        {
+          counted.insert(chunk.get());
+          bytes += static_cast<size_t>(chunk->size());
+        }
+      }
+    }
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t DataSnapshotStore::getLogicalBytes() const
+{
+  QMutexLocker locker(&m_Mutex);
+  size_t bytes = 0;
+  for(const Snapshot& snapshot : m_Snapshots)
+  {
+    for(const StoredArray& stored : snapshot.arrays)
+    {
+      bytes += stored.bytes;
+    }
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList DataSnapshotStore::report() const
+{
+  QStringList lines;
+  lines.push_back(QObject::tr("%1 snapshots store %2 instead of %3 as deep copies")
+                      .arg(size())
+                      .arg(MemoryEstimator::FormatBytes(getStoredBytes()))
+                      .arg(MemoryEstimator::FormatBytes(getLogicalBytes())));
+  for(int i = 0; i < size(); i++)
+  {
+    SnapshotAccounting snapshotAccounting = accounting(i);
+    lines.push_back(QObject::tr("  [%1] %2: %3 shared, %4 private, %5 copied")
+                        .arg(i)
+                        .arg(label(i))
+                        .arg(MemoryEstimator::FormatBytes(snapshotAccounting.sharedBytes))
+                        .arg(MemoryEstimator::FormatBytes(snapshotAccounting.privateBytes))
+                        .arg(MemoryEstimator::FormatBytes(snapshotAccounting.copiedBytes)));
+  }
+  return lines;
+}
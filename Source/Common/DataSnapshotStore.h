@@ -0,0 +1,184 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+/**
+ * @brief The SnapshotAccounting struct splits the bytes of one snapshot by whether another snapshot
+ * shares them
+ */
+struct SnapshotAccounting
+{
+  size_t sharedBytes = 0;
+  size_t privateBytes = 0;
+  size_t copiedBytes = 0;
+};
+
+/**
+ * @brief The DataSnapshotStore class keeps copies of a DataContainerArray at different points of a run
+ * without paying for a deep copy each time.
+ *
+ * The data of every array is stored in chunks of a fixed size. Chunks are immutable and shared between
+ * snapshots: a snapshot only copies the chunks whose bytes differ from the previous snapshot of the same
+ * array, so an array that a filter did not write costs nothing and an array that a filter changed in a
+ * few places costs only those chunks. When the caller knows which Data Containers can have been written
+ * since the previous snapshot, every array outside them is shared without even being compared.
+ *
+ * Arrays whose data is not one contiguous buffer, such as NeighborLists and StringDataArrays, are deep
+ * copied whole.
+ *
+ * restore() materializes a snapshot into a new DataContainerArray that shares nothing with the store.
+ */
+class DataSnapshotStore
+{
+public:
+  static const size_t DefaultChunkBytes = 4 * 1024 * 1024;
+
+  explicit DataSnapshotStore(size_t chunkBytes = DefaultChunkBytes);
+  virtual ~DataSnapshotStore();
+
+  /**
+   * @brief take Adds a snapshot of 'dca'
+   * @param dca
+   * @param label A name for the snapshot, e.g. the filter it was taken after
+   * @param touchedContainers The Data Containers that can have changed since the previous snapshot, or
+   * null if any of them can have. Containers that are in the previous snapshot but missing from 'dca'
+   * are carried over from it unless they were touched.
+   * @return The index of the new snapshot
+   */
+  int take(const DataContainerArray::Pointer& dca, const QString& label, const QSet<QString>* touchedContainers = nullptr);
+
+  /**
+   * @brief restore Returns a new DataContainerArray with the structure and data of snapshot 'index'
+   * @param index
+   * @return
+   */
+  DataContainerArray::Pointer restore(int index) const;
+
+  int size() const;
+  QString label(int index) const;
+
+  /**
+   * @brief remove Drops snapshot 'index'. Chunks that other snapshots share stay alive.
+   * @param index
+   */
+  void remove(int index);
+  void clear();
+
+  /**
+   * @brief accounting Returns the shared and private bytes of snapshot 'index' and the bytes that were
+   * copied when it was taken
+   * @param index
+   * @return
+   */
+  SnapshotAccounting accounting(int index) const;
+
+  /**
+   * @brief getStoredBytes Returns the bytes the store actually holds, every shared chunk counted once
+   * @return
+   */
+  size_t getStoredBytes() const;
+
+  /**
+   * @brief getLogicalBytes Returns the bytes the snapshots would take as deep copies
+   * @return
+   */
+  size_t getLogicalBytes() const;
+
+  /**
+   * @brief report Returns one line for the store and one for every snapshot
+   * @return
+   */
+  QStringList report() const;
+
+protected:
+  using Chunk = std::shared_ptr<const QByteArray>;
+
+  struct StoredArray
+  {
+    QString typeName;
+    size_t bytes = 0;
+    QVector<Chunk> chunks;
+    // Arrays without a contiguous buffer are kept as a deep copy instead of chunks
+    IDataArray::Pointer whole;
+  };
+
+  struct Snapshot
+  {
+    QString label;
+    DataContainerArray::Pointer structure;
+    QMap<QString, StoredArray> arrays;
+    size_t copiedBytes = 0;
+  };
+
+  /**
+   * @brief storeArray Stores the data of 'array', sharing whatever is unchanged from 'previous'
+   * @param array
+   * @param previous The same array in the previous snapshot, or null
+   * @param compare false if the array is known to be unchanged since 'previous'
+   * @param copiedBytes Incremented by the bytes that had to be copied
+   * @return
+   */
+  StoredArray storeArray(const IDataArray::Pointer& array, const StoredArray* previous, bool compare, size_t* copiedBytes) const;
+
+  /**
+   * @brief Key Returns the key of an array in a snapshot
+   * @param dcName
+   * @param amName
+   * @param arrayName
+   * @return
+   */
+  static QString Key(const QString& dcName, const QString& amName, const QString& arrayName);
+
+private:
+  size_t m_ChunkBytes = DefaultChunkBytes;
+  mutable QMutex m_Mutex;
+  QVector<Snapshot> m_Snapshots;
+
+  DataSnapshotStore(const DataSnapshotStore&) = delete; // Copy Constructor Not Implemented
+  void operator=(const DataSnapshotStore&) = delete;    // Move assignment Not Implemented
+};
@@ -0,0 +1,262 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ElementwiseFusion.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QtCore/QObject>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+// 4096 doubles per slot keeps the buffers of a typical run inside the L2 cache
+const size_t ElementwiseFusion::BlockSize = 4096;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ElementwiseFusion::ElementwiseFusion(const QVector<ElementwiseKernel::Pointer>& kernels, const QVector<DataArrayPath>& unmaterialized)
+: m_Kernels(kernels)
+, m_Unmaterialized(unmaterialized)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ElementwiseFusion::~ElementwiseFusion() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ElementwiseFusion::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ElementwiseFusion::getElementCount() const
+{
+  return m_ElementCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ElementwiseFusion::findSlot(const DataArrayPath& path) const
+{
+  for(int i = 0; i < m_Slots.size(); i++)
+  {
+    if(m_Slots[i].path == path)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ElementwiseFusion::execute(const DataContainerArray::Pointer& dca)
+{
+  m_ErrorMessage.clear();
+  m_ElementCount = 0;
+  m_Slots.clear();
+  m_KernelInputs.clear();
+  m_KernelOutputs.clear();
+
+  bool haveCount = false;
+  QVector<AttributeMatrix::Pointer> createdMatrices;
+  QVector<IDataArray::Pointer> createdArrays;
+
+  for(const ElementwiseKernel::Pointer& kernel : m_Kernels)
+  {
+    QVector<int> inputSlots;
+    QVector<QString> inputTypes;
+    for(const DataArrayPath& path : kernel->inputs())
+    {
+      int slot = findSlot(path);
+      if(slot < 0)
+      {
+        AttributeMatrix::Pointer am = dca->getAttributeMatrix(path);
+        IDataArray::Pointer array = (am.get() != nullptr) ? am->getAttributeArray(path.getDataArrayName()) : IDataArray::NullPointer();
+        if(array.get() == nullptr)
+        {
+          m_ErrorMessage = QObject::tr("The array '%1' does not exist").arg(path.serialize("/"));
+          return false;
+        }
+        if(!ElementwiseKernel::IsSupportedType(array->getTypeAsString()))
+        {
+          m_ErrorMessage = QObject::tr("The array '%1' is not a scalar array a double holds exactly").arg(path.serialize("/"));
+          return false;
+        }
+        if(haveCount && array->getSize() != m_ElementCount)
+        {
+          m_ErrorMessage = QObject::tr("The array '%1' has a different number of elements").arg(path.serialize("/"));
+          return false;
+        }
+        m_ElementCount = array->getSize();
+        haveCount = true;
+
+        Slot existing;
+        existing.path = path;
+        existing.typeName = array->getTypeAsString();
+        existing.prototype = array;
+        existing.source = array;
+        m_Slots.push_back(existing);
+        slot = m_Slots.size() - 1;
+      }
+      inputSlots.push_back(slot);
+      inputTypes.push_back(m_Slots[slot].typeName);
+    }
+    kernel->bind(inputTypes);
+
+    int outputSlot = inputSlots[0];
+    if(!kernel->outputIsCreated())
+    {
+      // In place: an array that already existed is written back, an intermediate stays in the buffers
+      if(m_Slots[outputSlot].source.get() != nullptr)
+      {
+        m_Slots[outputSlot].target = m_Slots[outputSlot].source;
+      }
+    }
+    else
+    {
+      DataArrayPath path = kernel->output();
+      AttributeMatrix::Pointer am = dca->getAttributeMatrix(path);
+      if(am.get() == nullptr || findSlot(path) >= 0 || am->doesAttributeArrayExist(path.getDataArrayName()))
+      {
+        m_ErrorMessage = QObject::tr("The array '%1' cannot be created").arg(path.serialize("/"));
+        return false;
+      }
+
+      bool materialize = !m_Unmaterialized.contains(path);
+      IDataArray::Pointer array = kernel->createOutput(m_Slots[outputSlot].prototype, materialize ? am->getNumberOfTuples() : 0);
+      if(array.get() == nullptr || !ElementwiseKernel::IsSupportedType(array->getTypeAsString()) || (materialize && array->getSize() != m_ElementCount))
+      {
+        m_ErrorMessage = QObject::tr("The array '%1' does not match its inputs").arg(path.serialize("/"));
+        return false;
+      }
+
+      Slot created;
+      created.path = path;
+      created.typeName = array->getTypeAsString();
+      created.prototype = array;
+      if(materialize)
+      {
+        created.target = array;
+        createdMatrices.push_back(am);
+        createdArrays.push_back(array);
+      }
+      m_Slots.push_back(created);
+      outputSlot = m_Slots.size() - 1;
+    }
+
+    m_KernelInputs.push_back(inputSlots);
+    m_KernelOutputs.push_back(outputSlot);
+  }
+
+  // Nothing has been modified up to here
+  for(int i = 0; i < createdArrays.size(); i++)
+  {
+    createdMatrices[i]->addAttributeArray(createdArrays[i]->getName(), createdArrays[i]);
+  }
+
+  size_t blockCount = (m_ElementCount + BlockSize - 1) / BlockSize;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, blockCount), [this](const tbb::blocked_range<size_t>& range) { processBlocks(range.begin(), range.end()); }, tbb::auto_partitioner());
+#else
+  processBlocks(0, blockCount);
+#endif
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ElementwiseFusion::processBlocks(size_t first, size_t last) const
+{
+  int slotCount = m_Slots.size();
+  std::vector<double> buffers(static_cast<size_t>(slotCount) * BlockSize);
+  std::vector<const double*> inputs;
+
+  for(size_t block = first; block < last; block++)
+  {
+    size_t offset = block * BlockSize;
+    size_t count = std::min(BlockSize, m_ElementCount - offset);
+
+    for(int s = 0; s < slotCount; s++)
+    {
+      if(m_Slots[s].source.get() != nullptr)
+      {
+        ElementwiseKernel::LoadValues(m_Slots[s].source, offset, count, buffers.data() + s * BlockSize);
+      }
+    }
+
+    for(int k = 0; k < m_Kernels.size(); k++)
+    {
+      const QVector<int>& inputSlots = m_KernelInputs[k];
+      inputs.resize(inputSlots.size());
+      for(int i = 0; i < inputSlots.size(); i++)
+      {
+        inputs[i] = buffers.data() + inputSlots[i] * BlockSize;
+      }
+      int outputSlot = m_KernelOutputs[k];
+      double* output = buffers.data() + outputSlot * BlockSize;
+      m_Kernels[k]->apply(inputs.data(), output, count);
+      ElementwiseKernel::Quantize(m_Slots[outputSlot].typeName, output, count);
+    }
+
+    for(int s = 0; s < slotCount; s++)
+    {
+      if(m_Slots[s].target.get() != nullptr)
+      {
+        ElementwiseKernel::StoreValues(buffers.data() + s * BlockSize, count, m_Slots[s].target, offset);
+      }
+    }
+  }
+}
@@ -0,0 +1,118 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+#include "Common/ElementwiseKernel.h"
+
+/**
+ * @brief The ElementwiseFusion class executes a run of ElementwiseKernels as a single loop.
+ *
+ * The elements are processed in blocks that fit in the cache. For each block the inputs are loaded once,
+ * every kernel of the run is applied to the block in order and only then are the outputs stored. Blocks are
+ * processed in parallel when SIMPLib was built with parallel algorithms.
+ *
+ * Created outputs that are listed as unmaterialized only ever exist inside the block buffers and are never
+ * added to the DataContainerArray. Every array touched by the run must have the same number of elements.
+ */
+class ElementwiseFusion
+{
+public:
+  ElementwiseFusion(const QVector<ElementwiseKernel::Pointer>& kernels, const QVector<DataArrayPath>& unmaterialized);
+  virtual ~ElementwiseFusion();
+
+  /**
+   * @brief BlockSize The number of elements per block
+   */
+  static const size_t BlockSize;
+
+  /**
+   * @brief execute Runs the kernels against 'dca'. Everything is validated before the DataContainerArray
+   * is modified, so on failure it is left untouched and the filters can be executed one by one instead.
+   * @param dca
+   * @return false if the run cannot be fused
+   */
+  bool execute(const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief getErrorMessage Returns why the last call to execute() could not fuse the run
+   * @return
+   */
+  QString getErrorMessage() const;
+
+  /**
+   * @brief getElementCount Returns the number of elements processed by the last call to execute()
+   * @return
+   */
+  size_t getElementCount() const;
+
+protected:
+  /**
+   * @brief processBlocks Runs every kernel over blocks [first, last)
+   * @param first
+   * @param last
+   */
+  void processBlocks(size_t first, size_t last) const;
+
+private:
+  struct Slot
+  {
+    DataArrayPath path;
+    QString typeName;
+    IDataArray::Pointer prototype; // Gives the type and components of the slot
+    IDataArray::Pointer source; // Loaded at the start of each block
+    IDataArray::Pointer target; // Stored at the end of each block
+  };
+
+  QVector<ElementwiseKernel::Pointer> m_Kernels;
+  QVector<DataArrayPath> m_Unmaterialized;
+  QString m_ErrorMessage;
+  size_t m_ElementCount = 0;
+
+  QVector<Slot> m_Slots;
+  QVector<QVector<int>> m_KernelInputs;
+  QVector<int> m_KernelOutputs;
+
+  int findSlot(const DataArrayPath& path) const;
+
+  ElementwiseFusion(const ElementwiseFusion&) = delete; // Copy Constructor Not Implemented
+  void operator=(const ElementwiseFusion&) = delete;    // Move assignment Not Implemented
+};
@@ -0,0 +1,428 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ElementwiseKernel.h"
+
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QVariant>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+
+#include "Common/ArrayMemoryPool.h"
+
+namespace
+{
+struct LaneFunctions
+{
+  void (*quantize)(double*, size_t);
+  void (*load)(const IDataArray::Pointer&, size_t, size_t, double*);
+  void (*store)(const double*, size_t, const IDataArray::Pointer&, size_t);
+};
+
+template <typename T> void QuantizeLane(double* values, size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    values[i] = static_cast<double>(static_cast<T>(values[i]));
+  }
+}
+
+template <typename T> void LoadLane(const IDataArray::Pointer& array, size_t offset, size_t count, double* values)
+{
+  const T* source = static_cast<const T*>(array->getVoidPointer(offset));
+  for(size_t i = 0; i < count; i++)
+  {
+    values[i] = static_cast<double>(source[i]);
+  }
+}
+
+template <typename T> void StoreLane(const double* values, size_t count, const IDataArray::Pointer& array, size_t offset)
+{
+  T* target = static_cast<T*>(array->getVoidPointer(offset));
+  for(size_t i = 0; i < count; i++)
+  {
+    target[i] = static_cast<T>(values[i]);
+  }
+}
+
+template <typename T> LaneFunctions MakeLaneFunctions()
+{
+  return LaneFunctions{&QuantizeLane<T>, &LoadLane<T>, &StoreLane<T>};
+}
+
+const LaneFunctions* FindLaneFunctions(const QString& typeName)
+{
+  // A double holds every value of these types exactly. 64 bit integers above 2^53 would be rounded, so
+  // filters on them are never fused.
+  static const QMap<QString, LaneFunctions> functions = {
+      {"int8_t", MakeLaneFunctions<int8_t>()},     {"uint8_t", MakeLaneFunctions<uint8_t>()}, {"int16_t", MakeLaneFunctions<int16_t>()},
+      {"uint16_t", MakeLaneFunctions<uint16_t>()}, {"int32_t", MakeLaneFunctions<int32_t>()}, {"uint32_t", MakeLaneFunctions<uint32_t>()},
+      {"float", MakeLaneFunctions<float>()},       {"double", MakeLaneFunctions<double>()},   {"bool", MakeLaneFunctions<bool>()}};
+
+  QMap<QString, LaneFunctions>::const_iterator iter = functions.find(typeName);
+  return iter == functions.end() ? nullptr : &iter.value();
+}
+
+double QuantizeValue(const QString& typeName, double value)
+{
+  ElementwiseKernel::Quantize(typeName, &value, 1);
+  return value;
+}
+
+/**
+ * @brief ConvertDataKernel Copies an array into a new array of another scalar type
+ */
+class ConvertDataKernel : public ElementwiseKernel
+{
+public:
+  ConvertDataKernel(const DataArrayPath& input, const QString& outputName, int scalarType)
+  : m_Input(input)
+  , m_Output(input.getDataContainerName(), input.getAttributeMatrixName(), outputName)
+  , m_ScalarType(scalarType)
+  {
+  }
+
+  QVector<DataArrayPath> inputs() const override
+  {
+    return QVector<DataArrayPath>(1, m_Input);
+  }
+
+  DataArrayPath output() const override
+  {
+    return m_Output;
+  }
+
+  bool outputIsCreated() const override
+  {
+    return true;
+  }
+
+  IDataArray::Pointer createOutput(const IDataArray::Pointer& prototype, size_t numTuples) const override
+  {
+    // Same order as SIMPL::ScalarTypes::Type
+    static const char* typeNames[] = {"int8_t", "uint8_t", "int16_t", "uint16_t", "int32_t", "uint32_t", "int64_t", "uint64_t", "float", "double", "bool"};
+    if(m_ScalarType < 0 || m_ScalarType >= static_cast<int>(sizeof(typeNames) / sizeof(typeNames[0])))
+    {
+      return IDataArray::NullPointer();
+    }
+    return ArrayMemoryPool::Instance()->createArray(typeNames[m_ScalarType], numTuples, prototype->getComponentDimensions(), m_Output.getDataArrayName());
+  }
+
+  void apply(const double* const* inputs, double* output, size_t count) const override
+  {
+    const double* values = inputs[0];
+    for(size_t i = 0; i < count; i++)
+    {
+      output[i] = values[i];
+    }
+  }
+
+private:
+  DataArrayPath m_Input;
+  DataArrayPath m_Output;
+  int m_ScalarType = 0;
+};
+
+/**
+ * @brief ReplaceValueKernel Replaces every element equal to one value with another value, in place
+ */
+class ReplaceValueKernel : public ElementwiseKernel
+{
+public:
+  ReplaceValueKernel(const DataArrayPath& array, double removeValue, double replaceValue)
+  : m_Array(array)
+  , m_RemoveValue(removeValue)
+  , m_ReplaceValue(replaceValue)
+  {
+  }
+
+  QVector<DataArrayPath> inputs() const override
+  {
+    return QVector<DataArrayPath>(1, m_Array);
+  }
+
+  DataArrayPath output() const override
+  {
+    return m_Array;
+  }
+
+  bool outputIsCreated() const override
+  {
+    return false;
+  }
+
+  void bind(const QVector<QString>& inputTypes) override
+  {
+    // The filter compares against the values converted to the type of the array
+    m_RemoveValue = QuantizeValue(inputTypes[0], m_RemoveValue);
+    m_ReplaceValue = QuantizeValue(inputTypes[0], m_ReplaceValue);
+  }
+
+  void apply(const double* const* inputs, double* output, size_t count) const override
+  {
+    const double* values = inputs[0];
+    const double removeValue = m_RemoveValue;
+    const double replaceValue = m_ReplaceValue;
+    for(size_t i = 0; i < count; i++)
+    {
+      output[i] = values[i] == removeValue ? replaceValue : values[i];
+    }
+  }
+
+private:
+  DataArrayPath m_Array;
+  double m_RemoveValue = 0.0;
+  double m_ReplaceValue = 0.0;
+};
+
+/**
+ * @brief ConditionalSetValueKernel Sets every element whose mask value is true to a value, in place
+ */
+class ConditionalSetValueKernel : public ElementwiseKernel
+{
+public:
+  ConditionalSetValueKernel(const DataArrayPath& array, const DataArrayPath& mask, double replaceValue)
+  : m_Array(array)
+  , m_Mask(mask)
+  , m_ReplaceValue(replaceValue)
+  {
+  }
+
+  QVector<DataArrayPath> inputs() const override
+  {
+    return QVector<DataArrayPath>({m_Array, m_Mask});
+  }
+
+  DataArrayPath output() const override
+  {
+    return m_Array;
+  }
+
+  bool outputIsCreated() const override
+  {
+    return false;
+  }
+
+  void bind(const QVector<QString>& inputTypes) override
+  {
+    m_ReplaceValue = QuantizeValue(inputTypes[0], m_ReplaceValue);
+  }
+
+  void apply(const double* const* inputs, double* output, size_t count) const override
+  {
+    const double* values = inputs[0];
+    const double* mask = inputs[1];
+    const double replaceValue = m_ReplaceValue;
+    for(size_t i = 0; i < count; i++)
+    {
+      output[i] = mask[i] != 0.0 ? replaceValue : values[i];
+    }
+  }
+
+private:
+  DataArrayPath m_Array;
+  DataArrayPath m_Mask;
+  double m_ReplaceValue = 0.0;
+};
+
+bool ReadPath(const AbstractFilter::Pointer& filter, const char* name, DataArrayPath& path)
+{
+  QVariant var = filter->property(name);
+  if(!var.isValid() || !var.canConvert<DataArrayPath>())
+  {
+    return false;
+  }
+  path = var.value<DataArrayPath>();
+  return !path.getDataArrayName().isEmpty();
+}
+
+bool ReadDouble(const AbstractFilter::Pointer& filter, const char* name, double& value)
+{
+  bool ok = false;
+  value = filter->property(name).toDouble(&ok);
+  return ok;
+}
+
+QMutex& RegistryMutex()
+{
+  static QMutex mutex;
+  return mutex;
+}
+
+QMap<QString, ElementwiseKernel::Factory>& Registry()
+{
+  static QMap<QString, ElementwiseKernel::Factory> registry = {
+      {"ConvertData",
+       [](const AbstractFilter::Pointer& filter) -> ElementwiseKernel::Pointer {
+         DataArrayPath input;
+         bool ok = false;
+         int scalarType = filter->property("ScalarType").toInt(&ok);
+         QString outputName = filter->property("OutputArrayName").toString();
+         if(!ReadPath(filter, "SelectedCellArrayPath", input) || !ok || outputName.isEmpty())
+         {
+           return ElementwiseKernel::Pointer();
+         }
+         return ElementwiseKernel::Pointer(new ConvertDataKernel(input, outputName, scalarType));
+       }},
+      {"ReplaceValueInArray",
+       [](const AbstractFilter::Pointer& filter) -> ElementwiseKernel::Pointer {
+         DataArrayPath array;
+         double removeValue = 0.0;
+         double replaceValue = 0.0;
+         if(!ReadPath(filter, "SelectedArray", array) || !ReadDouble(filter, "RemoveValue", removeValue) || !ReadDouble(filter, "ReplaceValue", replaceValue))
+         {
+           return ElementwiseKernel::Pointer();
+         }
+         return ElementwiseKernel::Pointer(new ReplaceValueKernel(array, removeValue, replaceValue));
+       }},
+      {"ConditionalSetValue",
+       [](const AbstractFilter::Pointer& filter) -> ElementwiseKernel::Pointer {
+         DataArrayPath array;
+         DataArrayPath mask;
+         double replaceValue = 0.0;
+         if(!ReadPath(filter, "SelectedArrayPath", array) || !ReadPath(filter, "ConditionalArrayPath", mask) || !ReadDouble(filter, "ReplaceValue", replaceValue))
+         {
+           return ElementwiseKernel::Pointer();
+         }
+         return ElementwiseKernel::Pointer(new ConditionalSetValueKernel(array, mask, replaceValue));
+       }}};
+  return registry;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ElementwiseKernel::ElementwiseKernel() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ElementwiseKernel::~ElementwiseKernel() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ElementwiseKernel::Register(const QString& filterClassName, const Factory& factory)
+{
+  QMutexLocker locker(&RegistryMutex());
+  Registry().insert(filterClassName, factory);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ElementwiseKernel::Pointer ElementwiseKernel::ForFilter(const AbstractFilter::Pointer& filter)
+{
+  Factory factory;
+  {
+    QMutexLocker locker(&RegistryMutex());
+    QMap<QString, Factory>::const_iterator iter = Registry().find(filter->getNameOfClass());
+    if(iter == Registry().end())
+    {
+      return Pointer();
+    }
+    factory = iter.value();
+  }
+  return factory(filter);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ElementwiseKernel::Quantize(const QString& typeName, double* values, size_t count)
+{
+  const LaneFunctions* functions = FindLaneFunctions(typeName);
+  if(functions == nullptr)
+  {
+    return false;
+  }
+  functions->quantize(values, count);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ElementwiseKernel::LoadValues(const IDataArray::Pointer& array, size_t offset, size_t count, double* values)
+{
+  const LaneFunctions* functions = FindLaneFunctions(array->getTypeAsString());
+  if(functions == nullptr)
+  {
+    return false;
+  }
+  functions->load(array, offset, count, values);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ElementwiseKernel::StoreValues(const double* values, size_t count, const IDataArray::Pointer& array, size_t offset)
+{
+  const LaneFunctions* functions = FindLaneFunctions(array->getTypeAsString());
+  if(functions == nullptr)
+  {
+    return false;
+  }
+  functions->store(values, count, array, offset);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ElementwiseKernel::IsSupportedType(const QString& typeName)
+{
+  return FindLaneFunctions(typeName) != nullptr;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer ElementwiseKernel::createOutput(const IDataArray::Pointer& prototype, size_t numTuples) const
+{
+  return ArrayMemoryPool::Instance()->createArrayLike(prototype, numTuples, output().getDataArrayName());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ElementwiseKernel::bind(const QVector<QString>& inputTypes)
+{
+  Q_UNUSED(inputTypes)
+}
@@ -0,0 +1,165 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataArrays/IDataArray.h"
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The ElementwiseKernel class is the per-element body of a filter whose output element i only
+ * depends on element i of its inputs and that has no effect outside the arrays it names.
+ *
+ * Kernels work on blocks of values converted to double. After each kernel the values of its output are
+ * rounded through the output's native type, so a run of fused kernels produces exactly what executing
+ * the filters one after another would have stored.
+ *
+ * Kernels are looked up by the class name of a filter. The filters of SIMPLib that are known to be
+ * element-wise are registered by default; plugins may register more with Register().
+ */
+class ElementwiseKernel
+{
+public:
+  using Pointer = std::shared_ptr<ElementwiseKernel>;
+  using Factory = std::function<Pointer(const AbstractFilter::Pointer&)>;
+
+  virtual ~ElementwiseKernel();
+
+  /**
+   * @brief Register Makes filters of class 'filterClassName' element-wise. The factory returns a null
+   * pointer if the parameters of a filter instance cannot be expressed as a kernel.
+   * @param filterClassName
+   * @param factory
+   */
+  static void Register(const QString& filterClassName, const Factory& factory);
+
+  /**
+   * @brief ForFilter Returns the kernel for 'filter' or a null pointer if the filter is not element-wise
+   * @param filter
+   * @return
+   */
+  static Pointer ForFilter(const AbstractFilter::Pointer& filter);
+
+  /**
+   * @brief Quantize Rounds each value the way storing it into an array of 'typeName' would
+   * @param typeName The value of IDataArray::getTypeAsString()
+   * @param values
+   * @param count
+   * @return false if the type is not a supported scalar type
+   */
+  static bool Quantize(const QString& typeName, double* values, size_t count);
+
+  /**
+   * @brief LoadValues Converts elements [offset, offset + count) of 'array' to double
+   * @param array
+   * @param offset
+   * @param count
+   * @param values
+   * @return false if the type is not a supported scalar type
+   */
+  static bool LoadValues(const IDataArray::Pointer& array, size_t offset, size_t count, double* values);
+
+  /**
+   * @brief StoreValues Converts 'count' doubles to the type of 'array' and stores them starting at element 'offset'
+   * @param values
+   * @param count
+   * @param array
+   * @param offset
+   * @return false if the type is not a supported scalar type
+   */
+  static bool StoreValues(const double* values, size_t count, const IDataArray::Pointer& array, size_t offset);
+
+  /**
+   * @brief IsSupportedType Returns true if arrays of 'typeName' can be loaded into and stored from doubles
+   * without changing any value, which excludes int64_t and uint64_t
+   * @param typeName
+   * @return
+   */
+  static bool IsSupportedType(const QString& typeName);
+
+  /**
+   * @brief inputs Returns the arrays read per element. The first input is the prototype for a created output.
+   * @return
+   */
+  virtual QVector<DataArrayPath> inputs() const = 0;
+
+  /**
+   * @brief output Returns the array written per element
+   * @return
+   */
+  virtual DataArrayPath output() const = 0;
+
+  /**
+   * @brief outputIsCreated Returns false if the output is the first input modified in place
+   * @return
+   */
+  virtual bool outputIsCreated() const = 0;
+
+  /**
+   * @brief createOutput Allocates the created output. The default has the type and components of 'prototype'.
+   * @param prototype The array (or an empty array of the type) of the first input
+   * @param numTuples
+   * @return
+   */
+  virtual IDataArray::Pointer createOutput(const IDataArray::Pointer& prototype, size_t numTuples) const;
+
+  /**
+   * @brief bind Called once before apply() with the type names of the inputs
+   * @param inputTypes
+   */
+  virtual void bind(const QVector<QString>& inputTypes);
+
+  /**
+   * @brief apply Computes 'count' output elements. 'output' may alias inputs[0].
+   * @param inputs One pointer per entry of inputs()
+   * @param output
+   * @param count
+   */
+  virtual void apply(const double* const* inputs, double* output, size_t count) const = 0;
+
+protected:
+  ElementwiseKernel();
+
+private:
+  ElementwiseKernel(const ElementwiseKernel&) = delete; // Copy Constructor Not Implemented
+  void operator=(const ElementwiseKernel&) = delete;    // Move assignment Not Implemented
+};
@@ -0,0 +1,65 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QMutex>
+
+/**
+ * @brief The HDF5Lock class serializes the HDF5 calls of the whole process when the HDF5 library is not
+ * thread-safe, which is how SIMPL builds it. Readers, writers and every other code path that opens HDF5 files
+ * hold it while they do, so concurrent branches, background writes and other pipelines of the same process
+ * never call into HDF5 at the same time. The lock is recursive, so paths that hold it may call each other.
+ */
+class HDF5Lock
+{
+public:
+  /**
+   * @brief IsThreadSafe Returns true if the HDF5 library was built thread-safe, so no lock is needed
+   * @return
+   */
+  static bool IsThreadSafe();
+
+  /**
+   * @brief Mutex Returns the lock, or null if the HDF5 library is thread-safe. QMutexLocker accepts both.
+   * @return
+   */
+  static QMutex* Mutex();
+
+private:
+  HDF5Lock() = delete;
+  HDF5Lock(const HDF5Lock&) = delete;       // Copy Constructor Not Implemented
+  void operator=(const HDF5Lock&) = delete; // Move assignment Not Implemented
+};
@@ -0,0 +1,880 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "IncrementalFileWriter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+#include "H5Support/QH5Lite.h"
+
+#include "Common/MemoryEstimator.h"
+#include "Common/ParallelChunkIO.h"
+
+namespace
+{
+const char* const OutputFileProperty = "OutputFile";
+const size_t HashPieceBytes = 1024 * 1024;
+
+std::atomic<int> StagingCounter(0);
+
+// The primes of xxHash64
+const quint64 Prime1 = 0x9E3779B185EBCA87ULL;
+const quint64 Prime2 = 0xC2B2AE3D27D4EB4FULL;
+const quint64 Prime3 = 0x165667B19E3779F9ULL;
+const quint64 Prime4 = 0x85EBCA77C2B2AE63ULL;
+const quint64 Prime5 = 0x27D4EB2F165667C5ULL;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+quint64 RotateLeft(quint64 value, int bits)
+{
+  return (value << bits) | (value >> (64 - bits));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+quint64 HashRound(quint64 accumulator, quint64 input)
+{
+  accumulator += input * Prime2;
+  return RotateLeft(accumulator, 31) * Prime1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+quint64 MergeRound(quint64 accumulator, quint64 value)
+{
+  accumulator ^= HashRound(0, value);
+  return accumulator * Prime1 + Prime4;
+}
+
+// -----------------------------------------------------------------------------
+// xxHash64 of 'bytes' bytes, reading the words in the byte order of this machine
+// -----------------------------------------------------------------------------
+quint64 HashBytes(const char* data, size_t bytes, quint64 seed = 0)
+{
+  auto word64 = [data](size_t offset) {
+    quint64 word = 0;
+    std::memcpy(&word, data + offset, sizeof(word));
+    return word;
+  };
+  auto word32 = [data](size_t offset) {
+    quint32 word = 0;
+    std::memcpy(&word, data + offset, sizeof(word));
+    return static_cast<quint64>(word);
+  };
+
+  size_t offset = 0;
+  quint64 hash = 0;
+  if(bytes >= 32)
+  {
+    quint64 v1 = seed + Prime1 + Prime2;
+    quint64 v2 = seed + Prime2;
+    quint64 v3 = seed;
+    quint64 v4 = seed - Prime1;
+    for(; offset + 32 <= bytes; offset += 32)
+    {
+      v1 = HashRound(v1, word64(offset));
+      v2 = HashRound(v2, word64(offset + 8));
+      v3 = HashRound(v3, word64(offset + 16));
+      v4 = HashRound(v4, word64(offset + 24));
+    }
+    hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+    hash = MergeRound(hash, v1);
+    hash = MergeRound(hash, v2);
+    hash = MergeRound(hash, v3);
+    hash = MergeRound(hash, v4);
+  }
+  else
+  {
+    hash = seed + Prime5;
+  }
+  hash += static_cast<quint64>(bytes);
+
+  for(; offset + 8 <= bytes; offset += 8)
+  {
+    hash ^= HashRound(0, word64(offset));
+    hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+  }
+  if(offset + 4 <= bytes)
+  {
+    hash ^= word32(offset) * Prime1;
+    hash = RotateLeft(hash, 23) * Prime2 + Prime3;
+    offset += 4;
+  }
+  for(; offset < bytes; offset++)
+  {
+    hash ^= static_cast<unsigned char>(data[offset]) * Prime5;
+    hash = RotateLeft(hash, 11) * Prime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= Prime2;
+  hash ^= hash >> 29;
+  hash *= Prime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<hsize_t> DatasetDims(hid_t datasetId)
+{
+  hid_t space = H5Dget_space(datasetId);
+  QVector<hsize_t> dims;
+  if(H5Sget_simple_extent_type(space) == H5S_SIMPLE)
+  {
+    dims.resize(H5Sget_simple_extent_ndims(space));
+    H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+  }
+  H5Sclose(space);
+  return dims;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool HasVariableLength(hid_t type)
+{
+  return H5Tis_variable_str(type) > 0 || H5Tdetect_class(type, H5T_VLEN) > 0;
+}
+
+// -----------------------------------------------------------------------------
+// Hashes the stored bytes of a dataset of rank 1 or more, one block of rows at a time. Every piece of a block
+// is hashed on its own, and the hashes of all pieces are hashed again at the end.
+// -----------------------------------------------------------------------------
+bool Fingerprint(hid_t datasetId, hid_t type, const QVector<hsize_t>& dims, quint64* fingerprint)
+{
+  size_t rowBytes = H5Tget_size(type);
+  for(int i = 1; i < dims.size(); i++)
+  {
+    rowBytes *= dims[i];
+  }
+  hsize_t blockRows = std::max(static_cast<hsize_t>(WriteProfile::CopyBlockBytes / std::max(rowBytes, static_cast<size_t>(1))), static_cast<hsize_t>(1));
+  std::vector<char> buffer(static_cast<size_t>(std::min(blockRows, dims[0])) * rowBytes);
+
+  // Reading with the type of the file hashes the stored bytes without conversion
+  ParallelChunkIO chunkIO(datasetId);
+  std::vector<quint64> hashes(1, static_cast<quint64>(dims[0]));
+  for(hsize_t row = 0; row < dims[0]; row += blockRows)
+  {
+    hsize_t rows = std::min(blockRows, dims[0] - row);
+    if(!chunkIO.readRows(type, row, rows, buffer.data()))
+    {
+      return false;
+    }
+    size_t bytes = static_cast<size_t>(rows) * rowBytes;
+    size_t pieces = (bytes + HashPieceBytes - 1) / HashPieceBytes;
+    size_t blockStart = hashes.size();
+    hashes.resize(blockStart + pieces);
+    quint64* blockHashes = hashes.data() + blockStart;
+    const char* data = buffer.data();
+    auto hashPieces = [blockHashes, data, bytes](size_t first, size_t last) {
+      for(size_t p = first; p < last; p++)
+      {
+        size_t offset = p * HashPieceBytes;
+        blockHashes[p] = HashBytes(data + offset, std::min(HashPieceBytes, bytes - offset));
+      }
+    };
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pieces), [&hashPieces](const tbb::blocked_range<size_t>& range) { hashPieces(range.begin(), range.end()); }, tbb::auto_partitioner());
+#else
+    hashPieces(0, pieces);
+#endif
+  }
+  *fingerprint = HashBytes(reinterpret_cast<const char*>(hashes.data()), hashes.size() * sizeof(quint64));
+  return true;
+}
+
+/**
+ * @brief The AttributeValue struct holds one attribute read into memory
+ */
+struct AttributeValue
+{
+  hid_t type = -1;
+  hid_t space = -1;
+  hid_t memType = -1;
+  std::vector<char> bytes;
+  bool variableLength = false;
+
+  AttributeValue(hid_t location, const char* name)
+  {
+    hid_t attrId = H5Aopen(location, name, H5P_DEFAULT);
+    if(attrId < 0)
+    {
+      return;
+    }
+    type = H5Aget_type(attrId);
+    space = H5Aget_space(attrId);
+    memType = H5Tget_native_type(type, H5T_DIR_DEFAULT);
+    variableLength = HasVariableLength(memType);
+    hssize_t points = std::max(H5Sget_simple_extent_npoints(space), static_cast<hssize_t>(1));
+    bytes.resize(static_cast<size_t>(points) * H5Tget_size(memType));
+    if(H5Aread(attrId, memType, bytes.data()) < 0)
+    {
+      bytes.clear();
+    }
+    H5Aclose(attrId);
+  }
+
+  ~AttributeValue()
+  {
+    if(variableLength && !bytes.empty())
+    {
+      H5Dvlen_reclaim(memType, space, H5P_DEFAULT, bytes.data());
+    }
+    for(hid_t id : {memType, type})
+    {
+      if(id >= 0)
+      {
+        H5Tclose(id);
+      }
+    }
+    if(space >= 0)
+    {
+      H5Sclose(space);
+    }
+  }
+
+  AttributeValue(const AttributeValue&) = delete;
+  void operator=(const AttributeValue&) = delete;
+
+  bool isValid() const
+  {
+    return type >= 0 && !bytes.empty();
+  }
+
+  bool equals(const AttributeValue& other) const
+  {
+    if(!isValid() || !other.isValid() || H5Tequal(type, other.type) <= 0 || H5Sextent_equal(space, other.space) <= 0)
+    {
+      return false;
+    }
+    if(!variableLength)
+    {
+      return bytes == other.bytes;
+    }
+    if(H5Tis_variable_str(memType) <= 0)
+    {
+      // Variable length sequences are rare in SIMPL files and simply rewritten
+      return false;
+    }
+    size_t count = bytes.size() / sizeof(char*);
+    for(size_t i = 0; i < count; i++)
+    {
+      const char* left = reinterpret_cast<const char* const*>(bytes.data())[i];
+      const char* right = reinterpret_cast<const char* const*>(other.bytes.data())[i];
+      if((left == nullptr) != (right == nullptr) || (left != nullptr && std::strcmp(left, right) != 0))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool writeTo(hid_t location, const char* name) const
+  {
+    hid_t attrId = H5Acreate2(location, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+    bool ok = attrId >= 0 && H5Awrite(attrId, memType, bytes.data()) >= 0;
+    if(attrId >= 0)
+    {
+      H5Aclose(attrId);
+    }
+    return ok;
+  }
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t CollectAttributeName(hid_t /* location */, const char* name, const H5A_info_t* /* info */, void* data)
+{
+  static_cast<QStringList*>(data)->push_back(QString::fromLatin1(name));
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList AttributeNames(hid_t location)
+{
+  QStringList names;
+  H5Aiterate2(location, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, CollectAttributeName, &names);
+  return names;
+}
+
+/**
+ * @brief The LinkEntry struct is one link of a group
+ */
+struct LinkEntry
+{
+  QString name;
+  H5L_type_t type;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t CollectLink(hid_t /* group */, const char* name, const H5L_info_t* info, void* data)
+{
+  static_cast<QVector<LinkEntry>*>(data)->push_back({QString::fromLatin1(name), info->type});
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<LinkEntry> Links(hid_t group)
+{
+  QVector<LinkEntry> links;
+  H5Literate(group, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, CollectLink, &links);
+  return links;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+H5I_type_t ObjectType(hid_t group, const QString& name)
+{
+  hid_t objectId = H5Oopen(group, name.toLatin1().constData(), H5P_DEFAULT);
+  if(objectId < 0)
+  {
+    return H5I_BADID;
+  }
+  H5I_type_t objectType = H5Iget_type(objectId);
+  H5Oclose(objectId);
+  return objectType;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t AddStorageBytes(hid_t group, const char* name, const H5L_info_t* info, void* data)
+{
+  if(info->type != H5L_TYPE_HARD)
+  {
+    return 0;
+  }
+  hid_t objectId = H5Oopen(group, name, H5P_DEFAULT);
+  if(objectId < 0)
+  {
+    return 0;
+  }
+  H5I_type_t objectType = H5Iget_type(objectId);
+  if(objectType == H5I_GROUP)
+  {
+    H5Literate(objectId, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, AddStorageBytes, data);
+  }
+  else if(objectType == H5I_DATASET)
+  {
+    *static_cast<size_t*>(data) += static_cast<size_t>(H5Dget_storage_size(objectId));
+  }
+  H5Oclose(objectId);
+  return 0;
+}
+
+/**
+ * @brief The Merger class walks a staging file and the output file side by side for
+ * IncrementalFileWriter::Merge()
+ */
+class Merger
+{
+public:
+  Merger(const WriteProfile& profile, IncrementalFileWriter::MergeStats* stats)
+  : m_Profile(profile)
+  , m_Stats(stats)
+  {
+  }
+
+  QString getErrorMessage() const
+  {
+    return m_ErrorMessage;
+  }
+
+  bool mergeAttributes(hid_t source, hid_t destination)
+  {
+    QStringList sourceNames = AttributeNames(source);
+    QStringList destinationNames = AttributeNames(destination);
+    for(const QString& name : destinationNames)
+    {
+      // The attribute the write profile adds is kept
+      if(!sourceNames.contains(name) && name != WriteProfile::FileAttributeName)
+      {
+        H5Adelete(destination, name.toLatin1().constData());
+        m_Stats->rewrittenAttributes++;
+      }
+    }
+    for(const QString& name : sourceNames)
+    {
+      QByteArray attrName = name.toLatin1();
+      AttributeValue value(source, attrName.constData());
+      if(destinationNames.contains(name))
+      {
+        AttributeValue existing(destination, attrName.constData());
+        if(value.equals(existing))
+        {
+          continue;
+        }
+        H5Adelete(destination, attrName.constData());
+      }
+      if(!value.isValid() || !value.writeTo(destination, attrName.constData()))
+      {
+        m_ErrorMessage = QObject::tr("The attribute '%1' could not be written").arg(name);
+        return false;
+      }
+      m_Stats->rewrittenAttributes++;
+    }
+    return true;
+  }
+
+  bool mergeGroup(hid_t source, hid_t destination)
+  {
+    if(!mergeAttributes(source, destination))
+    {
+      return false;
+    }
+
+    QVector<LinkEntry> sourceLinks = Links(source);
+    QSet<QString> sourceNames;
+    for(const LinkEntry& link : sourceLinks)
+    {
+      sourceNames.insert(link.name);
+    }
+    for(const LinkEntry& link : Links(destination))
+    {
+      if(!sourceNames.contains(link.name))
+      {
+        H5Ldelete(destination, link.name.toLatin1().constData(), H5P_DEFAULT);
+        m_Stats->removedObjects++;
+      }
+    }
+
+    for(const LinkEntry& link : sourceLinks)
+    {
+      QByteArray name = link.name.toLatin1();
+      bool exists = H5Lexists(destination, name.constData(), H5P_DEFAULT) > 0;
+      H5I_type_t sourceType = (link.type == H5L_TYPE_HARD) ? ObjectType(source, link.name) : H5I_BADID;
+      H5I_type_t destinationType = exists ? ObjectType(destination, link.name) : H5I_BADID;
+      bool ok = true;
+      if(sourceType == H5I_GROUP && destinationType == H5I_GROUP)
+      {
+        hid_t sourceGroup = H5Gopen2(source, name.constData(), H5P_DEFAULT);
+        hid_t destinationGroup = H5Gopen2(destination, name.constData(), H5P_DEFAULT);
+        ok = sourceGroup >= 0 && destinationGroup >= 0 && mergeGroup(sourceGroup, destinationGroup);
+        for(hid_t groupId : {sourceGroup, destinationGroup})
+        {
+          if(groupId >= 0)
+          {
+            H5Gclose(groupId);
+          }
+        }
+      }
+      else if(sourceType == H5I_DATASET)
+      {
+        if(exists && destinationType != H5I_DATASET)
+        {
+          H5Ldelete(destination, name.constData(), H5P_DEFAULT);
+        }
+        ok = mergeDataset(source, destination, link.name, destinationType == H5I_DATASET);
+      }
+      else
+      {
+        // Links, named types and groups that replace something else are copied whole
+        if(exists)
+        {
+          H5Ldelete(destination, name.constData(), H5P_DEFAULT);
+        }
+        ok = m_Profile.copyObject(source, link.name, destination, &m_ErrorMessage);
+      }
+      if(!ok)
+      {
+        if(m_ErrorMessage.isEmpty())
+        {
+          m_ErrorMessage = QObject::tr("The object '%1' could not be merged").arg(link.name);
+        }
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool mergeDataset(hid_t source, hid_t destination, const QString& name, bool exists)
+  {
+    QByteArray datasetName = name.toLatin1();
+    hid_t sourceId = H5Dopen2(source, datasetName.constData(), H5P_DEFAULT);
+    hid_t destinationId = exists ? H5Dopen2(destination, datasetName.constData(), H5P_DEFAULT) : -1;
+    if(sourceId < 0)
+    {
+      return false;
+    }
+    m_Stats->datasets++;
+
+    hid_t type = H5Dget_type(sourceId);
+    QVector<hsize_t> dims = DatasetDims(sourceId);
+    size_t bytes = H5Tget_size(type);
+    for(hsize_t dim : dims)
+    {
+      bytes *= dim;
+    }
+    bool fingerprinted = !dims.isEmpty() && bytes > IncrementalFileWriter::SmallDatasetBytes;
+    bool same = false;
+    if(destinationId >= 0 && !HasVariableLength(type) && DatasetDims(destinationId) == dims)
+    {
+      hid_t destinationType = H5Dget_type(destinationId);
+      same = H5Tequal(type, destinationType) > 0;
+      H5Tclose(destinationType);
+    }
+    if(same && !fingerprinted)
+    {
+      // Small datasets are compared byte by byte
+      std::vector<char> sourceBytes(std::max(bytes, static_cast<size_t>(1)));
+      std::vector<char> destinationBytes(sourceBytes.size());
+      same = H5Dread(sourceId, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, sourceBytes.data()) >= 0 &&
+             H5Dread(destinationId, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, destinationBytes.data()) >= 0 && sourceBytes == destinationBytes;
+    }
+    else if(same)
+    {
+      // The output file is always hashed again, since another tool may have changed it since the last merge
+      quint64 sourceFingerprint = 0;
+      quint64 destinationFingerprint = 0;
+      same = Fingerprint(sourceId, type, dims, &sourceFingerprint) && Fingerprint(destinationId, type, dims, &destinationFingerprint) && sourceFingerprint == destinationFingerprint;
+    }
+    H5Tclose(type);
+
+    bool ok = true;
+    if(same)
+    {
+      ok = mergeAttributes(sourceId, destinationId);
+      m_Stats->keptBytes += bytes;
+    }
+    if(destinationId >= 0)
+    {
+      H5Dclose(destinationId);
+    }
+    if(!same)
+    {
+      if(exists)
+      {
+        H5Ldelete(destination, datasetName.constData(), H5P_DEFAULT);
+      }
+      ok = m_Profile.copyObject(source, name, destination, &m_ErrorMessage);
+      m_Stats->rewrittenDatasets++;
+      m_Stats->rewrittenBytes += bytes;
+    }
+    H5Dclose(sourceId);
+    return ok;
+  }
+
+private:
+  const WriteProfile& m_Profile;
+  IncrementalFileWriter::MergeStats* m_Stats;
+  QString m_ErrorMessage;
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IncrementalFileWriter::Merge(const QString& stagingFile, const QString& targetFile, const WriteProfile& profile, MergeStats* stats, QString* errorMessage)
+{
+  QElapsedTimer timer;
+  timer.start();
+  MergeStats local;
+  Merger merger(profile, &local);
+
+  hid_t sourceId = H5Fopen(stagingFile.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  hid_t destinationId = (sourceId >= 0) ? H5Fopen(targetFile.toLocal8Bit().constData(), H5F_ACC_RDWR, H5P_DEFAULT) : -1;
+  bool ok = destinationId >= 0 && merger.mergeGroup(sourceId, destinationId);
+  if(ok && !profile.isDefault())
+  {
+    ok = QH5Lite::writeStringAttribute(destinationId, "/", WriteProfile::FileAttributeName, profile.getName()) >= 0;
+  }
+  size_t liveBytes = 0;
+  if(ok)
+  {
+    H5Literate(destinationId, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, AddStorageBytes, &liveBytes);
+  }
+  if(destinationId >= 0)
+  {
+    ok = H5Fclose(destinationId) >= 0 && ok;
+  }
+  if(sourceId >= 0)
+  {
+    H5Fclose(sourceId);
+  }
+  if(!ok)
+  {
+    if(errorMessage != nullptr)
+    {
+      if(sourceId < 0 || destinationId < 0)
+      {
+        *errorMessage = QObject::tr("The file '%1' could not be opened").arg(sourceId < 0 ? stagingFile : targetFile);
+      }
+      else
+      {
+        *errorMessage = merger.getErrorMessage().isEmpty() ? QObject::tr("The file '%1' could not be updated").arg(targetFile) : merger.getErrorMessage();
+      }
+    }
+    return false;
+  }
+
+  // Space freed by removed datasets is only reused while the file is open, so it adds up over many merges
+  size_t fileBytes = static_cast<size_t>(QFileInfo(targetFile).size());
+  if(fileBytes >= MinCompactBytes && liveBytes * 100 < fileBytes * CompactPercent)
+  {
+    WriteProfile::RewriteStats rewriteStats;
+    local.compacted = profile.rewrite(targetFile, &rewriteStats, errorMessage);
+    if(!local.compacted)
+    {
+      return false;
+    }
+  }
+
+  local.msecs = timer.elapsed();
+  if(stats != nullptr)
+  {
+    *stats = local;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IncrementalFileWriter::MergeSummary(const QString& targetFile, const MergeStats& stats)
+{
+  QString summary = QObject::tr("Updated '%1' incrementally: rewrote %2 of %3 datasets (%4) and %5 attributes, kept %6 and removed %7 objects in %8 ms")
+                        .arg(targetFile)
+                        .arg(stats.rewrittenDatasets)
+                        .arg(stats.datasets)
+                        .arg(MemoryEstimator::FormatBytes(stats.rewrittenBytes))
+                        .arg(stats.rewrittenAttributes)
+                        .arg(MemoryEstimator::FormatBytes(stats.keptBytes))
+                        .arg(stats.removedObjects)
+                        .arg(stats.msecs);
+  if(stats.compacted)
+  {
+    summary += QObject::tr(", then compacted the file");
+  }
+  return summary;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IncrementalFileWriter::IncrementalFileWriter(const AbstractFilter::Pointer& writer, const WriteProfile& profile, bool enabled)
+: m_Writer(writer)
+, m_Profile(profile)
+, m_Enabled(enabled)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IncrementalFileWriter::~IncrementalFileWriter()
+{
+  if(isStaged())
+  {
+    m_Writer->setProperty(OutputFileProperty, m_TargetFile);
+    QFile::remove(m_StagingFile);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IncrementalFileWriter::setStagingDirectory(const QString& directory)
+{
+  m_StagingDirectory = directory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IncrementalFileWriter::stage()
+{
+  if(!m_Enabled || m_Writer.get() == nullptr || isStaged())
+  {
+    return isStaged();
+  }
+  QFileInfo targetInfo(m_Writer->property(OutputFileProperty).toString());
+  if(!targetInfo.isFile() || H5Fis_hdf5(targetInfo.absoluteFilePath().toLocal8Bit().constData()) <= 0)
+  {
+    return false;
+  }
+
+  QDir stagingDir(m_StagingDirectory.isEmpty() ? QDir::tempPath() : m_StagingDirectory);
+  m_TargetFile = targetInfo.absoluteFilePath();
+  m_StagingFile = stagingDir.absoluteFilePath(QString("SIMPLView-%1-%2-%3").arg(QCoreApplication::applicationPid()).arg(StagingCounter++).arg(targetInfo.fileName()));
+  m_Writer->setProperty(OutputFileProperty, m_StagingFile);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IncrementalFileWriter::isStaged() const
+{
+  return !m_StagingFile.isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IncrementalFileWriter::finish(bool writerSucceeded, QString* message)
+{
+  m_ErrorCode = 0;
+  if(!isStaged())
+  {
+    if(!writerSucceeded || m_Writer.get() == nullptr)
+    {
+      return true;
+    }
+    bool ok = m_Profile.applyTo(m_Writer->property(OutputFileProperty).toString(), message);
+    m_ErrorCode = ok ? 0 : WriteProfile::RewriteError;
+    return ok;
+  }
+
+  m_Writer->setProperty(OutputFileProperty, m_TargetFile);
+  bool ok = true;
+  if(writerSucceeded)
+  {
+    MergeStats stats;
+    QString errorMessage;
+    ok = Merge(m_StagingFile, m_TargetFile, m_Profile, &stats, &errorMessage);
+    if(ok)
+    {
+      moveXdmfFile();
+      if(message != nullptr)
+      {
+        *message = MergeSummary(m_TargetFile, stats);
+      }
+    }
+    else
+    {
+      m_ErrorCode = MergeError;
+      QString replaceMessage;
+      bool replaced = replaceTarget(&replaceMessage);
+      if(message != nullptr)
+      {
+        *message = replaced ? QObject::tr("The incremental write of '%1' failed, so the file was written completely: %2").arg(m_TargetFile).arg(errorMessage)
+                            : QObject::tr("The incremental write of '%1' failed and the file could not be replaced: %2").arg(m_TargetFile).arg(replaceMessage);
+      }
+    }
+  }
+
+  QFileInfo stagingInfo(m_StagingFile);
+  QFile::remove(m_StagingFile);
+  QFile::remove(stagingInfo.absoluteDir().absoluteFilePath(stagingInfo.completeBaseName() + ".xdmf"));
+  m_StagingFile.clear();
+  return ok;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IncrementalFileWriter::getErrorCode() const
+{
+  return m_ErrorCode;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IncrementalFileWriter::replaceTarget(QString* message)
+{
+  moveXdmfFile();
+  QByteArray stagingPath = m_StagingFile.toLocal8Bit();
+  QByteArray targetPath = m_TargetFile.toLocal8Bit();
+  if(std::rename(stagingPath.constData(), targetPath.constData()) != 0)
+  {
+    // The staging directory may be on another file system, and Windows does not replace on rename
+    if(!QFile::remove(m_TargetFile) || !QFile::copy(m_StagingFile, m_TargetFile))
+    {
+      *message = QObject::tr("The file '%1' could not be replaced").arg(m_TargetFile);
+      return false;
+    }
+  }
+  return m_Profile.applyTo(m_TargetFile, message);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IncrementalFileWriter::moveXdmfFile()
+{
+  QFileInfo stagingInfo(m_StagingFile);
+  QFileInfo targetInfo(m_TargetFile);
+  QFile stagingXdmf(stagingInfo.absoluteDir().absoluteFilePath(stagingInfo.completeBaseName() + ".xdmf"));
+  if(!stagingXdmf.exists() || !stagingXdmf.open(QIODevice::ReadOnly))
+  {
+    return;
+  }
+  QByteArray contents = stagingXdmf.readAll();
+  stagingXdmf.close();
+  contents.replace(stagingInfo.fileName().toUtf8(), targetInfo.fileName().toUtf8());
+
+  QFile targetXdmf(targetInfo.absoluteDir().absoluteFilePath(targetInfo.completeBaseName() + ".xdmf"));
+  if(targetXdmf.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    targetXdmf.write(contents);
+  }
+  stagingXdmf.remove();
+}
@@ -0,0 +1,175 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <hdf5.h>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+#include "Common/WriteProfile.h"
+
+/**
+ * @brief The IncrementalFileWriter class lets a writer filter update an existing HDF5 output file in place
+ * instead of rebuilding it, so rewriting the same output after a rerun only writes what changed.
+ *
+ * stage() points the writer at a staging file in the staging directory when its output file already exists
+ * and is an HDF5 file. finish() then merges the staging file into the output file:
+ * @li a dataset whose type, shape and content fingerprint match the one already in the file is kept, and
+ * only the attributes that differ are rewritten
+ * @li any other dataset is replaced by a copy in the layout of the WriteProfile
+ * @li groups, datasets and attributes the writer no longer writes are removed
+ *
+ * Removed and replaced datasets leave unused space behind, so the file is compacted by a full rewrite once
+ * less than CompactPercent of it holds datasets. The XDMF file the writer wrote next to the staging file is
+ * moved next to the output file as well. Files that do not exist yet, and every file when incremental
+ * writes are off, are written directly and only get their write profile applied.
+ *
+ * The fingerprints are xxHash64 hashes of the stored bytes. Both the staging file and the output file are
+ * hashed on every merge; nothing is stored with the output file, so a dataset another tool changed in the
+ * meantime is always noticed.
+ */
+class IncrementalFileWriter
+{
+public:
+  /**
+   * @brief The MergeStats struct describes one merge of a staging file into an output file
+   */
+  struct MergeStats
+  {
+    int datasets = 0;
+    int rewrittenDatasets = 0;
+    int rewrittenAttributes = 0;
+    int removedObjects = 0;
+    size_t rewrittenBytes = 0;
+    size_t keptBytes = 0;
+    bool compacted = false;
+    qint64 msecs = 0;
+  };
+
+  static const int MergeError = -9435;
+  static const int CompactPercent = 50;
+  static const size_t MinCompactBytes = 64 * 1024 * 1024;
+  static const size_t SmallDatasetBytes = 64 * 1024;
+
+  /**
+   * @brief Merge Updates 'targetFile' so it holds what 'stagingFile' holds, rewriting only what differs
+   * @param stagingFile
+   * @param targetFile
+   * @param profile The profile replaced datasets are written with
+   * @param stats
+   * @param errorMessage
+   * @return false if the merge failed. The target file may then be partly updated.
+   */
+  static bool Merge(const QString& stagingFile, const QString& targetFile, const WriteProfile& profile, MergeStats* stats = nullptr, QString* errorMessage = nullptr);
+
+  /**
+   * @brief MergeSummary Returns one line that describes a merge into 'targetFile'
+   * @param targetFile
+   * @param stats
+   * @return
+   */
+  static QString MergeSummary(const QString& targetFile, const MergeStats& stats);
+
+  /**
+   * @brief IncrementalFileWriter
+   * @param writer
+   * @param profile The profile the output file is written with
+   * @param enabled false to write the output file directly
+   */
+  IncrementalFileWriter(const AbstractFilter::Pointer& writer, const WriteProfile& profile, bool enabled);
+  virtual ~IncrementalFileWriter();
+
+  /**
+   * @brief setStagingDirectory Sets the directory staging files are written to, the temporary directory by
+   * default
+   * @param directory
+   */
+  void setStagingDirectory(const QString& directory);
+
+  /**
+   * @brief stage Points the writer at a staging file if incremental writes are enabled and its output file
+   * already is an HDF5 file. Call before the writer executes.
+   * @return true if the writer now writes a staging file
+   */
+  bool stage();
+
+  bool isStaged() const;
+
+  /**
+   * @brief finish Points the writer back at its output file. If the writer succeeded, the staging file is
+   * merged into the output file, or the write profile is applied to the output file if nothing was staged.
+   * If a merge fails, the staging file replaces the output file instead.
+   * @param writerSucceeded
+   * @param message Receives what was done or why it failed, stays empty if nothing was done
+   * @return false if the merge or the write profile failed. The message then tells what the output file
+   * holds.
+   */
+  bool finish(bool writerSucceeded, QString* message);
+
+  /**
+   * @brief getErrorCode Returns the code of the warning for a failed finish()
+   * @return
+   */
+  int getErrorCode() const;
+
+protected:
+  /**
+   * @brief replaceTarget Moves the staging file over the output file and applies the write profile to it
+   * @param message
+   * @return
+   */
+  bool replaceTarget(QString* message);
+
+  /**
+   * @brief moveXdmfFile Moves the XDMF file written next to the staging file next to the output file and
+   * points it at the output file
+   */
+  void moveXdmfFile();
+
+private:
+  AbstractFilter::Pointer m_Writer;
+  WriteProfile m_Profile;
+  bool m_Enabled = false;
+  QString m_StagingDirectory;
+  QString m_TargetFile;
+  QString m_StagingFile;
+  int m_ErrorCode = 0;
+
+  IncrementalFileWriter(const IncrementalFileWriter&) = delete; // Copy Constructor Not Implemented
+  void operator=(const IncrementalFileWriter&) = delete;        // Move assignment Not Implemented
+};
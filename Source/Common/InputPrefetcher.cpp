@@ -0,0 +1,422 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "InputPrefetcher.h"
+
+#include <algorithm>
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#endif
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+#include <QtCore/QVariant>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "SIMPLib/FilterParameters/FileListInfoFilterParameter.h"
+#include "SIMPLib/FilterParameters/FilterParameter.h"
+#include "SIMPLib/Utilities/FilePathGenerator.h"
+
+#include "Common/MemoryEstimator.h"
+#include "Common/PreviewReduction.h"
+
+namespace
+{
+const QString k_InputFileWidget("InputFileWidget");
+const char* const InputFileProperty = "InputFile";
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList InputPrefetcher::InputFiles(const AbstractFilter::Pointer& filter)
+{
+  QStringList files;
+  QString inputFile = filter->property(InputFileProperty).toString();
+  if(!inputFile.isEmpty())
+  {
+    files.push_back(inputFile);
+  }
+
+  FilterParameterVector parameters = filter->getFilterParameters();
+  for(FilterParameter::Pointer parameter : parameters)
+  {
+    QString propertyName = parameter->getPropertyName();
+    if(propertyName.isEmpty())
+    {
+      continue;
+    }
+    QVariant var = filter->property(propertyName.toLatin1().constData());
+    if(!var.isValid())
+    {
+      continue;
+    }
+
+    if(var.type() == QVariant::String && parameter->getWidgetType() == k_InputFileWidget)
+    {
+      files.push_back(var.toString());
+    }
+    else if(var.userType() == qMetaTypeId<FileListInfo_t>())
+    {
+      FileListInfo_t info = var.value<FileListInfo_t>();
+      bool hasMissingFiles = false;
+      QVector<QString> stack = FilePathGenerator::GenerateFileList(info.StartIndex, info.EndIndex, info.IncrementIndex, hasMissingFiles, info.Ordering == 0, info.InputPath, info.FilePrefix,
+                                                                   info.FileSuffix, info.FileExtension, info.PaddingDigits);
+      for(const QString& path : stack)
+      {
+        files.push_back(path);
+      }
+    }
+  }
+
+  files.removeAll(QString());
+  files.removeDuplicates();
+  return files;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+InputPrefetcher::InputPrefetcher(const PipelineDataFlowGraph& graph, int depth, size_t maxBytes)
+: m_Depth(std::max(depth, 1))
+, m_MaxBytes(maxBytes)
+, m_Stopped(false)
+{
+  m_Pool.setMaxThreadCount(Threads);
+
+  for(int node = 0; node < graph.size(); node++)
+  {
+    AbstractFilter::Pointer filter = graph.filter(node);
+    if(!PreviewReduction::IsReaderFilter(filter))
+    {
+      continue;
+    }
+
+    int reader = m_ReaderNodes.size();
+    int fileCount = 0;
+    QStringList paths = InputFiles(filter);
+    for(const QString& path : paths)
+    {
+      // Files a reader creates or that are missing are left to the reader to report
+      QFileInfo fileInfo(path);
+      if(!fileInfo.isFile())
+      {
+        continue;
+      }
+      PrefetchFile file;
+      file.path = fileInfo.absoluteFilePath();
+      file.reader = reader;
+      file.bytes = static_cast<size_t>(fileInfo.size());
+      m_Files.push_back(file);
+      fileCount++;
+    }
+    m_ReaderNodes.push_back(node);
+    m_ReaderFileCounts.push_back(fileCount);
+    m_ReaderStarted.push_back(false);
+  }
+  m_Stats.files = m_Files.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+InputPrefetcher::~InputPrefetcher()
+{
+  stop();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void InputPrefetcher::start()
+{
+  QMutexLocker locker(&m_Mutex);
+  startWorkers();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void InputPrefetcher::markStarted(int node)
+{
+  QMutexLocker locker(&m_Mutex);
+  int reader = m_ReaderNodes.indexOf(node);
+  if(reader < 0 || m_ReaderStarted[reader])
+  {
+    return;
+  }
+  m_ReaderStarted[reader] = true;
+  while(m_StartedReaders < m_ReaderStarted.size() && m_ReaderStarted[m_StartedReaders])
+  {
+    m_StartedReaders++;
+  }
+
+  bool single = (m_ReaderFileCounts[reader] == 1);
+  for(PrefetchFile& file : m_Files)
+  {
+    if(file.reader != reader)
+    {
+      continue;
+    }
+    switch(file.state)
+    {
+    case State::Done:
+      m_Stats.hits++;
+      break;
+    case State::Reading:
+      m_Stats.partialHits++;
+      file.abort = single;
+      break;
+    case State::Queued:
+      m_Stats.misses++;
+      if(single)
+      {
+        file.state = State::Dropped;
+      }
+      break;
+    case State::Dropped:
+    case State::Failed:
+      m_Stats.misses++;
+      break;
+    }
+    // The reader uses the file now, so it no longer counts against the read-ahead limit
+    if(file.ahead)
+    {
+      m_AheadBytes -= file.bytes;
+      file.ahead = false;
+    }
+  }
+
+  startWorkers();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void InputPrefetcher::stop()
+{
+  m_Stopped = true;
+  m_Pool.waitForDone();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PrefetchStats InputPrefetcher::getStats() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_Stats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList InputPrefetcher::report() const
+{
+  PrefetchStats stats = getStats();
+  QStringList lines;
+  int lookups = stats.hits + stats.partialHits + stats.misses;
+  double hitRate = lookups > 0 ? 100.0 * static_cast<double>(stats.hits) / static_cast<double>(lookups) : 0.0;
+  lines.push_back(QObject::tr("Prefetched %1 of %2 input files (%3) in %4 ms, %5 readers ahead, at most %6 ahead of the readers")
+                      .arg(stats.prefetchedFiles)
+                      .arg(stats.files)
+                      .arg(MemoryEstimator::FormatBytes(stats.prefetchedBytes))
+                      .arg(stats.prefetchMsecs)
+                      .arg(m_Depth)
+                      .arg(MemoryEstimator::FormatBytes(stats.peakAheadBytes)));
+  lines.push_back(QObject::tr("Prefetch hit rate %1%: %2 files were read completely when their reader started, %3 partially, %4 not at all")
+                      .arg(hitRate, 0, 'f', 1)
+                      .arg(stats.hits)
+                      .arg(stats.partialHits)
+                      .arg(stats.misses));
+  return lines;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int InputPrefetcher::takeNext()
+{
+  for(int i = 0; i < m_Files.size(); i++)
+  {
+    PrefetchFile& file = m_Files[i];
+    if(file.state != State::Queued)
+    {
+      continue;
+    }
+    // The files are in pipeline order, so every later file is outside the window as well
+    if(file.reader >= m_StartedReaders + m_Depth)
+    {
+      return -1;
+    }
+
+    bool ahead = !m_ReaderStarted[file.reader];
+    if(ahead && file.bytes > m_MaxBytes)
+    {
+      file.state = State::Dropped;
+      continue;
+    }
+    if(ahead && m_AheadBytes + file.bytes > m_MaxBytes)
+    {
+      return -1;
+    }
+
+    file.state = State::Reading;
+    file.ahead = ahead;
+    if(ahead)
+    {
+      m_AheadBytes += file.bytes;
+      m_Stats.peakAheadBytes = std::max(m_Stats.peakAheadBytes, m_AheadBytes);
+    }
+    return i;
+  }
+  return -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void InputPrefetcher::startWorkers()
+{
+  if(m_Stopped)
+  {
+    return;
+  }
+  bool queued = false;
+  for(const PrefetchFile& file : m_Files)
+  {
+    if(file.state == State::Queued && file.reader < m_StartedReaders + m_Depth)
+    {
+      queued = true;
+      break;
+    }
+  }
+  while(queued && m_Workers < Threads)
+  {
+    m_Workers++;
+    QtConcurrent::run(&m_Pool, [this] { work(); });
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void InputPrefetcher::work()
+{
+  QMutexLocker locker(&m_Mutex);
+  while(!m_Stopped)
+  {
+    int index = takeNext();
+    if(index < 0)
+    {
+      break;
+    }
+    locker.unlock();
+
+    QElapsedTimer timer;
+    timer.start();
+    bool complete = prefetch(index);
+    qint64 msecs = timer.elapsed();
+
+    locker.relock();
+    PrefetchFile& file = m_Files[index];
+    m_Stats.prefetchMsecs += msecs;
+    if(complete)
+    {
+      file.state = State::Done;
+      m_Stats.prefetchedFiles++;
+      m_Stats.prefetchedBytes += file.bytes;
+    }
+    else
+    {
+      file.state = file.abort ? State::Dropped : State::Failed;
+      if(file.ahead)
+      {
+        m_AheadBytes -= file.bytes;
+        file.ahead = false;
+      }
+    }
+  }
+  m_Workers--;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool InputPrefetcher::prefetch(int index)
+{
+  QString path;
+  {
+    QMutexLocker locker(&m_Mutex);
+    path = m_Files[index].path;
+  }
+
+  QFile file(path);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+#if defined(Q_OS_LINUX)
+  // Let the kernel read ahead aggressively; the contents themselves are discarded
+  posix_fadvise(file.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  QByteArray buffer(static_cast<int>(BlockBytes), Qt::Uninitialized);
+  while(!m_Stopped)
+  {
+    {
+      QMutexLocker locker(&m_Mutex);
+      if(m_Files[index].abort)
+      {
+        return false;
+      }
+    }
+    qint64 count = file.read(buffer.data(), buffer.size());
+    if(count < 0)
+    {
+      return false;
+    }
+    if(count == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,190 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+#include "Common/PipelineDataFlowGraph.h"
+
+/**
+ * @brief The PrefetchStats struct sums up what the InputPrefetcher did during one run
+ */
+struct PrefetchStats
+{
+  int files = 0;
+  int prefetchedFiles = 0;
+  size_t prefetchedBytes = 0;
+  qint64 prefetchMsecs = 0;
+  int hits = 0;
+  int partialHits = 0;
+  int misses = 0;
+  size_t peakAheadBytes = 0;
+};
+
+/**
+ * @brief The InputPrefetcher class reads the input files of the readers of a pipeline into the page cache
+ * on background threads while the filters before those readers execute.
+ *
+ * The files come from the parameters of every reader after preflight: the "InputFile" property, any other
+ * input file parameter, and the file list of image stack readers. They are read in pipeline order, but
+ * only for the next 'depth' readers that have not started yet and only while the files read ahead of their
+ * readers stay within 'maxBytes', so prefetching never pushes out what it read before it is used. A file
+ * larger than that limit is never prefetched.
+ *
+ * When a reader starts, each of its files counts as a hit if it was read completely, as a partial hit if
+ * it was still being read, and as a miss otherwise. Prefetching stops for a reader of a single file once
+ * it starts, since the reader is reading it itself; the later files of an image stack keep being read
+ * ahead of the reader.
+ */
+class InputPrefetcher
+{
+public:
+  static const size_t DefaultMaxBytes = static_cast<size_t>(2048) * 1024 * 1024;
+  static const size_t BlockBytes = 4 * 1024 * 1024;
+  static const int Threads = 2;
+
+  /**
+   * @brief InputFiles Returns the files 'filter' reads according to its parameters
+   * @param filter
+   * @return
+   */
+  static QStringList InputFiles(const AbstractFilter::Pointer& filter);
+
+  /**
+   * @brief InputPrefetcher
+   * @param graph
+   * @param depth The number of readers ahead of the running filters whose files are read
+   * @param maxBytes The bytes that may be read ahead of their readers at once
+   */
+  InputPrefetcher(const PipelineDataFlowGraph& graph, int depth, size_t maxBytes = DefaultMaxBytes);
+  virtual ~InputPrefetcher();
+
+  /**
+   * @brief start Starts reading the files of the first readers
+   */
+  void start();
+
+  /**
+   * @brief markStarted Records that the filter at 'node' is about to execute. If it is a reader, its files
+   * are counted as hits or misses and the readers after it move into the window.
+   * @param node
+   */
+  void markStarted(int node);
+
+  /**
+   * @brief stop Stops reading and waits for the background threads
+   */
+  void stop();
+
+  PrefetchStats getStats() const;
+
+  /**
+   * @brief report Returns the statistics as lines for a run report
+   * @return
+   */
+  QStringList report() const;
+
+protected:
+  enum class State
+  {
+    Queued,
+    Reading,
+    Done,
+    Dropped,
+    Failed
+  };
+
+  struct PrefetchFile
+  {
+    QString path;
+    int reader = 0;
+    size_t bytes = 0;
+    State state = State::Queued;
+    bool ahead = false;
+    bool abort = false;
+  };
+
+  /**
+   * @brief takeNext Returns the index of the next file that may be read, or -1. Must be called with the
+   * mutex locked.
+   * @return
+   */
+  int takeNext();
+
+  /**
+   * @brief startWorkers Starts background threads while there are files to read. Must be called with the
+   * mutex locked.
+   */
+  void startWorkers();
+
+  /**
+   * @brief work Reads files until none may be read. Called on a background thread.
+   */
+  void work();
+
+  /**
+   * @brief prefetch Reads the file at 'index' and discards its contents
+   * @param index
+   * @return false if the file could not be read completely
+   */
+  bool prefetch(int index);
+
+private:
+  QVector<PrefetchFile> m_Files;
+  QVector<int> m_ReaderNodes;
+  QVector<int> m_ReaderFileCounts;
+  QVector<bool> m_ReaderStarted;
+  int m_Depth = 1;
+  size_t m_MaxBytes = DefaultMaxBytes;
+  int m_StartedReaders = 0;
+  size_t m_AheadBytes = 0;
+  int m_Workers = 0;
+  std::atomic<bool> m_Stopped;
+  QThreadPool m_Pool;
+  mutable QMutex m_Mutex;
+  PrefetchStats m_Stats;
+
+  InputPrefetcher(const InputPrefetcher&) = delete; // Copy Constructor Not Implemented
+  void operator=(const InputPrefetcher&) = delete;  // Move assignment Not Implemented
+};
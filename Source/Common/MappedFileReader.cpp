@@ -0,0 +1,429 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "MappedFileReader.h"
+
+#include <cstring>
+
+#include <QtCore/QObject>
+
+#include "H5Support/QH5Lite.h"
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArrayProxy.h"
+
+#include "Common/ArrayMemoryPool.h"
+#include "Common/MemoryEstimator.h"
+#include "Common/SlabFileReader.h"
+
+namespace
+{
+const QString ReaderClassName("DataContainerReader");
+const char* const InputFileProperty = "InputFile";
+const char* const ProxyProperty = "InputFileDataContainerArrayProxy";
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MappedFileReader::MappedFileReader(Mode mode, const QString& scratchDirectory)
+: m_Mode(mode)
+, m_ScratchDirectory(scratchDirectory)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MappedFileReader::~MappedFileReader() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString MappedFileReader::ModeName(Mode mode)
+{
+  switch(mode)
+  {
+  case Mode::ReadOnly:
+    return "Read-Only";
+  case Mode::CopyOnWrite:
+    return "Copy-On-Write";
+  default:
+    return "Off";
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MappedFileReader::Mode MappedFileReader::ModeFromName(const QString& name, bool* ok)
+{
+  if(ok != nullptr)
+  {
+    *ok = true;
+  }
+  for(Mode mode : {Mode::Off, Mode::ReadOnly, Mode::CopyOnWrite})
+  {
+    if(name.compare(ModeName(mode), Qt::CaseInsensitive) == 0)
+    {
+      return mode;
+    }
+  }
+
+  if(ok != nullptr)
+  {
+    *ok = false;
+  }
+  return Mode::Off;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool MappedFileReader::IsMappable(hid_t datasetId, const QString& typeName, size_t elements, quint64* offset, QString* reason)
+{
+  hid_t createProps = H5Dget_create_plist(datasetId);
+  H5D_layout_t layout = H5Pget_layout(createProps);
+  int filters = H5Pget_nfilters(createProps);
+  int externalFiles = H5Pget_external_count(createProps);
+  H5Pclose(createProps);
+
+  // Compressed datasets are always chunked, so the filters are the more useful thing to report
+  if(filters > 0)
+  {
+    *reason = QObject::tr("is compressed or filtered");
+    return false;
+  }
+  if(layout == H5D_CHUNKED)
+  {
+    *reason = QObject::tr("is stored in chunks");
+    return false;
+  }
+  if(layout != H5D_CONTIGUOUS || externalFiles > 0)
+  {
+    *reason = QObject::tr("is not stored contiguously in the file");
+    return false;
+  }
+
+  hid_t fileType = H5Dget_type(datasetId);
+  hid_t memType = SlabFileReader::NativeType(typeName);
+  bool native = memType >= 0 && H5Tequal(fileType, memType) > 0;
+  size_t typeSize = H5Tget_size(fileType);
+  H5Tclose(fileType);
+  if(!native)
+  {
+    *reason = QObject::tr("is not stored in the byte order and type of this machine");
+    return false;
+  }
+
+  haddr_t address = H5Dget_offset(datasetId);
+  if(address == HADDR_UNDEF || H5Dget_storage_size(datasetId) != elements * typeSize)
+  {
+    *reason = QObject::tr("has no storage allocated in the file");
+    return false;
+  }
+  *offset = static_cast<quint64>(address);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool MappedFileReader::planArray(hid_t fileId, const DataArrayPath& path, PlannedArray* planned, QString* reason) const
+{
+  QString datasetPath = QString("/%1/%2/%3/%4").arg(SIMPL::StringConstants::DataContainerGroupName).arg(path.getDataContainerName()).arg(path.getAttributeMatrixName()).arg(path.getDataArrayName());
+
+  QString objectType;
+  QH5Lite::readStringAttribute(fileId, datasetPath, SIMPL::HDF5::ObjectType, objectType);
+  if(!objectType.startsWith("DataArray<") || !objectType.endsWith(">"))
+  {
+    *reason = QObject::tr("is not an array of numbers");
+    return false;
+  }
+  QString typeName = objectType.mid(10, objectType.size() - 11);
+  if(SlabFileReader::NativeType(typeName) < 0)
+  {
+    *reason = QObject::tr("is not an array of numbers");
+    return false;
+  }
+
+  QVector<uint64_t> componentDims;
+  if(QH5Lite::readVectorAttribute(fileId, datasetPath, SIMPL::HDF5::ComponentDimensions, componentDims) < 0 || componentDims.isEmpty())
+  {
+    *reason = QObject::tr("has no component dimensions");
+    return false;
+  }
+  QVector<size_t> cDims;
+  size_t components = 1;
+  for(uint64_t dim : componentDims)
+  {
+    cDims.push_back(static_cast<size_t>(dim));
+    components *= static_cast<size_t>(dim);
+  }
+
+  hid_t datasetId = H5Dopen2(fileId, datasetPath.toLatin1().constData(), H5P_DEFAULT);
+  if(datasetId < 0)
+  {
+    *reason = QObject::tr("could not be opened");
+    return false;
+  }
+  hid_t space = H5Dget_space(datasetId);
+  hssize_t elements = H5Sget_simple_extent_npoints(space);
+  H5Sclose(space);
+
+  quint64 offset = 0;
+  bool mappable = elements > 0 && components > 0 && IsMappable(datasetId, typeName, static_cast<size_t>(elements), &offset, reason);
+  H5Dclose(datasetId);
+  if(!mappable)
+  {
+    if(reason->isEmpty())
+    {
+      *reason = QObject::tr("is empty");
+    }
+    return false;
+  }
+
+  planned->path = path;
+  planned->typeName = typeName;
+  planned->numTuples = static_cast<size_t>(elements) / components;
+  planned->cDims = cDims;
+  planned->offset = offset;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool MappedFileReader::prepare(const AbstractFilter::Pointer& reader, const std::function<bool(const DataArrayPath&)>& touchedLater)
+{
+  m_Planned.clear();
+  m_Notes.clear();
+  m_SavedProxy = QVariant();
+  if(m_Mode == Mode::Off || reader->getNameOfClass() != ReaderClassName)
+  {
+    return true;
+  }
+
+  m_FilePath = reader->property(InputFileProperty).toString();
+  QVariant var = reader->property(ProxyProperty);
+  if(!var.canConvert<DataContainerArrayProxy>())
+  {
+    return true;
+  }
+
+  hid_t fileId = H5Fopen(m_FilePath.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if(fileId < 0)
+  {
+    m_ErrorMessage = QObject::tr("The file '%1' could not be opened to map its arrays").arg(m_FilePath);
+    return false;
+  }
+
+  DataContainerArrayProxy proxy = var.value<DataContainerArrayProxy>();
+  for(DataContainerProxy& dcProxy : proxy.dataContainers)
+  {
+    if(dcProxy.flag == Qt::Unchecked)
+    {
+      continue;
+    }
+    for(AttributeMatrixProxy& amProxy : dcProxy.attributeMatricies)
+    {
+      if(amProxy.flag == Qt::Unchecked)
+      {
+        continue;
+      }
+      for(DataArrayProxy& daProxy : amProxy.dataArrays)
+      {
+        if(daProxy.flag == Qt::Unchecked)
+        {
+          continue;
+        }
+
+        DataArrayPath path(dcProxy.name, amProxy.name, daProxy.name);
+        PlannedArray planned;
+        QString reason;
+        if(!planArray(fileId, path, &planned, &reason))
+        {
+          m_Notes.push_back(QObject::tr("'%1' %2, so it is read into a scratch file instead of mapped").arg(path.serialize("/")).arg(reason));
+          continue;
+        }
+        planned.copyOnWrite = (m_Mode == Mode::CopyOnWrite) || touchedLater(path);
+        m_Planned.push_back(planned);
+        // The attribute matrix stays selected so the reader still creates it
+        daProxy.flag = Qt::Unchecked;
+      }
+    }
+  }
+  H5Fclose(fileId);
+
+  if(!m_Planned.isEmpty())
+  {
+    m_SavedProxy = var;
+    reader->setProperty(ProxyProperty, QVariant::fromValue(proxy));
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool MappedFileReader::finish(const AbstractFilter::Pointer& reader, const DataContainerArray::Pointer& dca, const QStringList& readContainers)
+{
+  // The pipeline must not keep a reader whose selection differs from what the user chose
+  if(m_SavedProxy.isValid())
+  {
+    reader->setProperty(ProxyProperty, m_SavedProxy);
+    m_SavedProxy = QVariant();
+  }
+  if(m_Mode == Mode::Off || reader->getErrorCondition() < 0)
+  {
+    return true;
+  }
+
+  ArrayMemoryPool* pool = ArrayMemoryPool::Instance();
+  for(const PlannedArray& planned : m_Planned)
+  {
+    AttributeMatrix::Pointer am = dca->getAttributeMatrix(planned.path);
+    if(am.get() == nullptr || am->getNumberOfTuples() != planned.numTuples)
+    {
+      m_ErrorMessage = QObject::tr("The reader did not create an attribute matrix that fits '%1'").arg(planned.path.serialize("/"));
+      return false;
+    }
+
+    IDataArray::Pointer array = pool->mapFile(m_FilePath, planned.offset, planned.typeName, planned.numTuples, planned.cDims, planned.path.getDataArrayName(), planned.copyOnWrite);
+    if(array.get() == nullptr)
+    {
+      m_ErrorMessage = QObject::tr("'%1' could not be mapped from '%2'").arg(planned.path.serialize("/")).arg(m_FilePath);
+      return false;
+    }
+    am->addAttributeArray(planned.path.getDataArrayName(), array);
+
+    m_Stats.mappedArrays++;
+    m_Stats.mappedBytes += array->getSize() * array->getTypeSize();
+    if(planned.copyOnWrite)
+    {
+      m_Stats.copyOnWriteArrays++;
+    }
+  }
+
+  moveToScratch(dca, readContainers);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MappedFileReader::moveToScratch(const DataContainerArray::Pointer& dca, const QStringList& containers)
+{
+  ArrayMemoryPool* pool = ArrayMemoryPool::Instance();
+  for(const QString& dcName : containers)
+  {
+    DataContainer::Pointer dc = dca->getDataContainer(dcName);
+    if(dc.get() == nullptr)
+    {
+      continue;
+    }
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        IDataArray::Pointer array = am->getAttributeArray(name);
+        size_t bytes = array->getSize() * array->getTypeSize();
+        if(bytes < ArrayMemoryPool::MinimumPooledBytes || array->getVoidPointer(0) == nullptr || pool->isFileBacked(array))
+        {
+          continue;
+        }
+
+        IDataArray::Pointer scratch = pool->createScratchArray(array, array->getNumberOfTuples(), name, m_ScratchDirectory);
+        if(scratch.get() == nullptr)
+        {
+          m_Stats.fallbackArrays++;
+          m_Stats.fallbackBytes += bytes;
+          m_Notes.push_back(QObject::tr("No scratch file could be created for '%1', so it stays in memory").arg(DataArrayPath(dcName, am->getName(), name).serialize("/")));
+          continue;
+        }
+        std::memcpy(scratch->getVoidPointer(0), array->getVoidPointer(0), bytes);
+        am->addAttributeArray(name, scratch);
+
+        m_Stats.scratchArrays++;
+        m_Stats.scratchBytes += bytes;
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList MappedFileReader::getNotes() const
+{
+  return m_Notes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString MappedFileReader::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MappingStats MappedFileReader::getStats() const
+{
+  return m_Stats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList MappedFileReader::Report(const MappingStats& stats)
+{
+  QStringList lines;
+  lines.push_back(QObject::tr("Mapped %1 arrays (%2) from their files, %3 of them copy-on-write; read %4 arrays (%5) into scratch files; kept %6 arrays (%7) in memory")
+                      .arg(stats.mappedArrays)
+                      .arg(MemoryEstimator::FormatBytes(stats.mappedBytes))
+                      .arg(stats.copyOnWriteArrays)
+                      .arg(stats.scratchArrays)
+                      .arg(MemoryEstimator::FormatBytes(stats.scratchBytes))
+                      .arg(stats.fallbackArrays)
+                      .arg(MemoryEstimator::FormatBytes(stats.fallbackBytes)));
+  return lines;
+}
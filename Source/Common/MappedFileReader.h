@@ -0,0 +1,199 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+
+#include <hdf5.h>
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The MappingStats struct sums up how the arrays of input files were backed during one run
+ */
+struct MappingStats
+{
+  int mappedArrays = 0;
+  size_t mappedBytes = 0;
+  int copyOnWriteArrays = 0;
+  int scratchArrays = 0;
+  size_t scratchBytes = 0;
+  int fallbackArrays = 0;
+  size_t fallbackBytes = 0;
+};
+
+/**
+ * @brief The MappedFileReader class backs the arrays a reader filter produces with files instead of
+ * anonymous memory.
+ *
+ * For a DataContainerReader, prepare() takes every selected dataset that is stored contiguously, without
+ * filters and in the native byte order out of the reader's selection, so the reader skips it, and finish()
+ * maps those datasets straight from the .dream3d file. Their pages are only read once a filter touches
+ * them. A read-only mapping is only used for arrays no later filter reads or writes, since a filter may
+ * change a required array in place; the others, or every array in CopyOnWrite mode, get a copy-on-write
+ * mapping.
+ *
+ * Datasets that cannot be mapped, e.g. chunked or compressed ones, are read by the reader as usual; finish()
+ * then moves them, like the arrays of every other reader, into scratch files, and getNotes() says why each
+ * one was not mapped.
+ */
+class MappedFileReader
+{
+public:
+  enum class Mode
+  {
+    Off,
+    ReadOnly,
+    CopyOnWrite
+  };
+
+  /**
+   * @brief ModeName Returns the name of a mode as it is stored in the preferences
+   * @param mode
+   * @return
+   */
+  static QString ModeName(Mode mode);
+
+  /**
+   * @brief ModeFromName Returns the mode named 'name', case insensitive
+   * @param name
+   * @param ok
+   * @return
+   */
+  static Mode ModeFromName(const QString& name, bool* ok = nullptr);
+
+  /**
+   * @brief IsMappable Returns true if the dataset can be mapped as an array of 'typeName' with 'elements'
+   * values and sets 'offset' to where its values start in the file
+   * @param datasetId
+   * @param typeName
+   * @param elements
+   * @param offset
+   * @param reason Set to why the dataset cannot be mapped
+   * @return
+   */
+  static bool IsMappable(hid_t datasetId, const QString& typeName, size_t elements, quint64* offset, QString* reason);
+
+  /**
+   * @brief MappedFileReader
+   * @param mode
+   * @param scratchDirectory The directory of the scratch files, the system temporary directory if empty
+   */
+  MappedFileReader(Mode mode, const QString& scratchDirectory = QString());
+  virtual ~MappedFileReader();
+
+  /**
+   * @brief prepare Takes the mappable datasets out of the selection of 'reader' if it reads a .dream3d file
+   * @param reader
+   * @param touchedLater Returns true if a filter after the reader reads or writes the array at a path
+   * @return false if the file could not be inspected; the reader then reads everything itself
+   */
+  bool prepare(const AbstractFilter::Pointer& reader, const std::function<bool(const DataArrayPath&)>& touchedLater);
+
+  /**
+   * @brief finish Restores the selection of 'reader', adds the mapped arrays to 'dca' and moves the arrays
+   * the reader read into scratch files
+   * @param reader
+   * @param dca
+   * @param readContainers The Data Containers the reader created
+   * @return false if a planned array could not be mapped
+   */
+  bool finish(const AbstractFilter::Pointer& reader, const DataContainerArray::Pointer& dca, const QStringList& readContainers);
+
+  /**
+   * @brief getNotes Returns a line for every array that is not mapped, with the reason
+   * @return
+   */
+  QStringList getNotes() const;
+
+  QString getErrorMessage() const;
+  MappingStats getStats() const;
+
+  /**
+   * @brief Report Returns the statistics as lines for a run report
+   * @param stats
+   * @return
+   */
+  static QStringList Report(const MappingStats& stats);
+
+protected:
+  struct PlannedArray
+  {
+    DataArrayPath path;
+    QString typeName;
+    size_t numTuples = 0;
+    QVector<size_t> cDims;
+    quint64 offset = 0;
+    bool copyOnWrite = true;
+  };
+
+  /**
+   * @brief planArray Decides whether the dataset of 'path' in the open file can be mapped
+   * @param fileId
+   * @param path
+   * @param planned Filled in if it can
+   * @param reason Set to why it cannot
+   * @return
+   */
+  bool planArray(hid_t fileId, const DataArrayPath& path, PlannedArray* planned, QString* reason) const;
+
+  /**
+   * @brief moveToScratch Replaces the arrays of 'containers' in 'dca' with copies in scratch files
+   * @param dca
+   * @param containers
+   */
+  void moveToScratch(const DataContainerArray::Pointer& dca, const QStringList& containers);
+
+private:
+  Mode m_Mode = Mode::Off;
+  QString m_ScratchDirectory;
+  QString m_FilePath;
+  QVariant m_SavedProxy;
+  QVector<PlannedArray> m_Planned;
+  QStringList m_Notes;
+  QString m_ErrorMessage;
+  MappingStats m_Stats;
+
+  MappedFileReader(const MappedFileReader&) = delete; // Copy Constructor Not Implemented
+  void operator=(const MappedFileReader&) = delete;   // Move assignment Not Implemented
+};
@@ -0,0 +1,381 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "MemoryEstimator.h"
+
+#include <algorithm>
+
+#include <QtCore/QFile>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QTextStream>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_MAC)
+#include <mach/mach.h>
+#endif
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "Common/ArrayLivenessAnalysis.h"
+#include "Common/PipelineDataFlowGraph.h"
+
+namespace
+{
+#if defined(Q_OS_LINUX)
+// Returns a field of /proc/meminfo, which is given in kB, or 0
+size_t MemInfoBytes(const QString& field)
+{
+  QFile file("/proc/meminfo");
+  if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    return 0;
+  }
+
+  QTextStream in(&file);
+  for(QString line = in.readLine(); !line.isNull(); line = in.readLine())
+  {
+    if(line.startsWith(field + ":"))
+    {
+      QStringList tokens = line.mid(field.size() + 1).simplified().split(' ');
+      return static_cast<size_t>(tokens[0].toULongLong()) * 1024;
+    }
+  }
+  return 0;
+}
+#endif
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MemoryEstimator::MemoryEstimator(FilterPipeline::Pointer pipeline, bool releaseDeadArrays, const QVector<DataArrayPath>& keptPaths)
+{
+  PipelineDataFlowGraph graph(pipeline);
+  if(releaseDeadArrays)
+  {
+    // The preflight already left the arrays each filter creates in its DataContainerArray, including
+    // those named by plain strings that the footprints do not know about
+    QMap<QString, size_t> previous;
+    for(int i = 0; i < graph.size(); i++)
+    {
+      DataContainerArray::Pointer dca = graph.filter(i)->getDataContainerArray();
+      QMap<QString, size_t> current = (dca.get() != nullptr) ? structureOf(dca) : previous;
+      QVector<DataArrayPath> created;
+      for(QMap<QString, size_t>::const_iterator iter = current.constBegin(); iter != current.constEnd(); ++iter)
+      {
+        if(!previous.contains(iter.key()))
+        {
+          created.push_back(DataArrayPath::Deserialize(iter.key(), "|"));
+        }
+      }
+      if(!created.isEmpty())
+      {
+        graph.addWrites(i, created);
+      }
+      previous = current;
+    }
+  }
+  ArrayLivenessAnalysis liveness = releaseDeadArrays ? ArrayLivenessAnalysis(graph, keptPaths) : ArrayLivenessAnalysis();
+
+  QMap<QString, size_t> before;
+  QSet<QString> released;
+  size_t residentBefore = 0;
+  for(int i = 0; i < graph.size(); i++)
+  {
+    FilterMemoryEstimate estimate;
+    estimate.filter = graph.filter(i);
+
+    DataContainerArray::Pointer dca = estimate.filter->getDataContainerArray();
+    QMap<QString, size_t> after = (dca.get() != nullptr) ? structureOf(dca) : before;
+
+    size_t totalBefore = 0;
+    for(QMap<QString, size_t>::const_iterator iter = before.constBegin(); iter != before.constEnd(); ++iter)
+    {
+      totalBefore += iter.value();
+    }
+    for(QMap<QString, size_t>::const_iterator iter = after.constBegin(); iter != after.constEnd(); ++iter)
+    {
+      size_t previous = before.value(iter.key(), 0);
+      if(iter.value() > previous)
+      {
+        estimate.createdBytes += iter.value() - previous;
+      }
+    }
+
+    // The inputs and the outputs of a filter are resident together until it finishes
+    estimate.peakBytes = residentBefore + estimate.createdBytes;
+    m_PeakBytesWithoutRelease = std::max(m_PeakBytesWithoutRelease, totalBefore + estimate.createdBytes);
+
+    QVector<DataArrayPath> releasedPaths = liveness.releasedAfter(i);
+    for(const DataArrayPath& path : releasedPaths)
+    {
+      QString key = path.serialize("|");
+      if(after.contains(key) && !released.contains(key))
+      {
+        estimate.releasedBytes += after.value(key);
+      }
+      released.insert(key);
+    }
+    for(QMap<QString, size_t>::const_iterator iter = after.constBegin(); iter != after.constEnd(); ++iter)
+    {
+      if(!released.contains(iter.key()))
+      {
+        estimate.residentBytes += iter.value();
+      }
+    }
+
+    if(m_PeakFilter < 0 || estimate.peakBytes > m_PeakBytes)
+    {
+      m_PeakBytes = estimate.peakBytes;
+      m_PeakFilter = i;
+    }
+
+    m_Filters.push_back(estimate);
+    residentBefore = estimate.residentBytes;
+    before = after;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MemoryEstimator::~MemoryEstimator() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString MemoryEstimator::PolicyName(Policy policy)
+{
+  switch(policy)
+  {
+  case Policy::Off:
+    return "Off";
+  case Policy::Refuse:
+    return "Refuse";
+  default:
+    return "Warn";
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MemoryEstimator::Policy MemoryEstimator::PolicyFromName(const QString& name, bool* ok)
+{
+  if(ok != nullptr)
+  {
+    *ok = true;
+  }
+  for(Policy policy : {Policy::Off, Policy::Warn, Policy::Refuse})
+  {
+    if(name.compare(PolicyName(policy), Qt::CaseInsensitive) == 0)
+    {
+      return policy;
+    }
+  }
+
+  if(ok != nullptr)
+  {
+    *ok = false;
+  }
+  return Policy::Warn;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t MemoryEstimator::AvailableBytes()
+{
+#if defined(Q_OS_LINUX)
+  return MemInfoBytes("MemAvailable");
+#elif defined(Q_OS_WIN)
+  MEMORYSTATUSEX status;
+  status.dwLength = sizeof(status);
+  return GlobalMemoryStatusEx(&status) ? static_cast<size_t>(status.ullAvailPhys) : 0;
+#elif defined(Q_OS_MAC)
+  // Inactive pages are handed out again without swapping, the same as free ones
+  vm_statistics64_data_t stats;
+  mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+  if(host_statistics64(mach_host_self(), HOST_VM_INFO64, reinterpret_cast<host_info64_t>(&stats), &count) != KERN_SUCCESS)
+  {
+    return 0;
+  }
+  return static_cast<size_t>(stats.free_count + stats.inactive_count) * static_cast<size_t>(vm_page_size);
+#else
+  return 0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t MemoryEstimator::StructureBytes(const IDataArray::Pointer& array)
+{
+  // Preflight arrays are not allocated, so their size comes from the tuple count and component count
+  return array->getNumberOfTuples() * static_cast<size_t>(array->getNumberOfComponents()) * static_cast<size_t>(array->getTypeSize());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString MemoryEstimator::FormatBytes(size_t bytes)
+{
+  const double k_KiB = 1024.0;
+  double value = static_cast<double>(bytes);
+  if(value < k_KiB)
+  {
+    return QString("%1 B").arg(bytes);
+  }
+  if(value < k_KiB * k_KiB)
+  {
+    return QString("%1 KiB").arg(value / k_KiB, 0, 'f', 1);
+  }
+  if(value < k_KiB * k_KiB * k_KiB)
+  {
+    return QString("%1 MiB").arg(value / (k_KiB * k_KiB), 0, 'f', 1);
+  }
+  return QString("%1 GiB").arg(value / (k_KiB * k_KiB * k_KiB), 0, 'f', 2);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<FilterMemoryEstimate> MemoryEstimator::getFilters() const
+{
+  return m_Filters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t MemoryEstimator::getPeakBytes() const
+{
+  return m_PeakBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int MemoryEstimator::getPeakFilter() const
+{
+  return m_PeakFilter;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t MemoryEstimator::getPeakBytesWithoutRelease() const
+{
+  return m_PeakBytesWithoutRelease;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool MemoryEstimator::exceeds(size_t budget) const
+{
+  return budget > 0 && m_PeakBytes > budget;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString MemoryEstimator::summary(size_t budget) const
+{
+  QString text = QObject::tr("Estimated peak memory %1").arg(FormatBytes(m_PeakBytes));
+  if(m_PeakFilter >= 0)
+  {
+    text += QObject::tr(" at %1").arg(m_Filters[m_PeakFilter].filter->getHumanLabel());
+  }
+  if(budget > 0)
+  {
+    text += QObject::tr(", %1 available").arg(FormatBytes(budget));
+  }
+  return text;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList MemoryEstimator::report(size_t budget) const
+{
+  QStringList lines;
+  lines << summary(budget);
+  if(m_PeakBytesWithoutRelease > m_PeakBytes)
+  {
+    lines << QObject::tr("Releasing arrays after their last use lowers the peak from %1").arg(FormatBytes(m_PeakBytesWithoutRelease));
+  }
+
+  for(int i = 0; i < m_Filters.size(); i++)
+  {
+    const FilterMemoryEstimate& estimate = m_Filters[i];
+    if(estimate.createdBytes == 0 && estimate.releasedBytes == 0)
+    {
+      continue;
+    }
+    QString line = QObject::tr("  [%1] %2: creates %3, peak %4").arg(i + 1).arg(estimate.filter->getHumanLabel()).arg(FormatBytes(estimate.createdBytes)).arg(FormatBytes(estimate.peakBytes));
+    if(estimate.releasedBytes > 0)
+    {
+      line += QObject::tr(", releases %1").arg(FormatBytes(estimate.releasedBytes));
+    }
+    lines << line;
+  }
+  return lines;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QMap<QString, size_t> MemoryEstimator::structureOf(const DataContainerArray::Pointer& dca)
+{
+  QMap<QString, size_t> arrays;
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::AttributeMatrixMap_t& matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        arrays.insert(DataArrayPath(dc->getName(), am->getName(), name).serialize("|"), StructureBytes(am->getAttributeArray(name)));
+      }
+    }
+  }
+  return arrays;
+}
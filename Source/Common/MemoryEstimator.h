@@ -0,0 +1,189 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The FilterMemoryEstimate struct is the predicted array memory around one filter of a pipeline
+ */
+struct FilterMemoryEstimate
+{
+  AbstractFilter::Pointer filter;
+  size_t createdBytes = 0;
+  size_t releasedBytes = 0;
+  size_t peakBytes = 0;
+  size_t residentBytes = 0;
+};
+
+/**
+ * @brief The MemoryEstimator class predicts the array memory a pipeline will need before it runs.
+ *
+ * Preflighting leaves every filter with the structure of the DataContainerArray after that filter: the
+ * type, tuple count and component dimensions of every array, without any data. The bytes a filter creates
+ * are the arrays that appear or grow in its structure. While a filter runs, the arrays that existed before
+ * it and the arrays it creates are resident together, which is the peak the estimate reports. When arrays
+ * are released after their last use, the ArrayLivenessAnalysis decides which arrays stop counting after
+ * each filter, exactly as the PipelineExecutor would release them.
+ *
+ * Memory a filter allocates internally and frees before it finishes is not visible in the structure, so
+ * the estimate is a lower bound.
+ */
+class MemoryEstimator
+{
+public:
+  /**
+   * @brief The Policy enum decides what happens when the estimate exceeds the memory budget
+   */
+  enum class Policy : int
+  {
+    Off = 0,
+    Warn = 1,
+    Refuse = 2
+  };
+
+  /**
+   * @brief MemoryEstimator Estimates a preflighted pipeline
+   * @param pipeline
+   * @param releaseDeadArrays Whether arrays are released after their last use
+   * @param keptPaths The paths that are never released
+   */
+  MemoryEstimator(FilterPipeline::Pointer pipeline, bool releaseDeadArrays, const QVector<DataArrayPath>& keptPaths = QVector<DataArrayPath>());
+  virtual ~MemoryEstimator();
+
+  /**
+   * @brief PolicyName Returns the name of a policy as it is stored in the preferences
+   * @param policy
+   * @return
+   */
+  static QString PolicyName(Policy policy);
+
+  /**
+   * @brief PolicyFromName Returns the policy named 'name', case insensitive
+   * @param name
+   * @param ok Set to false if no policy has that name
+   * @return
+   */
+  static Policy PolicyFromName(const QString& name, bool* ok = nullptr);
+
+  /**
+   * @brief AvailableBytes Returns the physical memory the operating system can hand out without swapping,
+   * or 0 if it cannot be determined
+   * @return
+   */
+  static size_t AvailableBytes();
+
+  /**
+   * @brief StructureBytes Returns the bytes an array of the structure will hold once it is allocated
+   * @param array
+   * @return
+   */
+  static size_t StructureBytes(const IDataArray::Pointer& array);
+
+  /**
+   * @brief FormatBytes Returns 'bytes' in the largest binary unit that keeps the value above 1
+   * @param bytes
+   * @return
+   */
+  static QString FormatBytes(size_t bytes);
+
+  /**
+   * @brief getFilters Returns the estimate of every enabled filter in pipeline order
+   * @return
+   */
+  QVector<FilterMemoryEstimate> getFilters() const;
+
+  /**
+   * @brief getPeakBytes Returns the largest array memory predicted while any filter runs
+   * @return
+   */
+  size_t getPeakBytes() const;
+
+  /**
+   * @brief getPeakFilter Returns the index into getFilters() of the filter the peak occurs at, -1 if empty
+   * @return
+   */
+  int getPeakFilter() const;
+
+  /**
+   * @brief getPeakBytesWithoutRelease Returns what getPeakBytes() would be if no array were released
+   * @return
+   */
+  size_t getPeakBytesWithoutRelease() const;
+
+  /**
+   * @brief exceeds Returns true if the peak is larger than 'budget'. A budget of 0 is never exceeded.
+   * @param budget
+   * @return
+   */
+  bool exceeds(size_t budget) const;
+
+  /**
+   * @brief summary Returns one line with the peak and the budget, e.g. for a status bar
+   * @param budget
+   * @return
+   */
+  QString summary(size_t budget) const;
+
+  /**
+   * @brief report Returns the summary followed by one line per filter that creates or releases arrays
+   * @param budget
+   * @return
+   */
+  QStringList report(size_t budget) const;
+
+protected:
+  /**
+   * @brief structureOf Returns the bytes of every array of a structure, keyed by its serialized path
+   * @param dca
+   * @return
+   */
+  static QMap<QString, size_t> structureOf(const DataContainerArray::Pointer& dca);
+
+private:
+  QVector<FilterMemoryEstimate> m_Filters;
+  size_t m_PeakBytes = 0;
+  int m_PeakFilter = -1;
+  size_t m_PeakBytesWithoutRelease = 0;
+};
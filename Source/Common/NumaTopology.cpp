@@ -0,0 +1,620 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "NumaTopology.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QObject>
+#include <QtCore/QThread>
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_LINUX)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "Common/MemoryEstimator.h"
+
+namespace
+{
+const QString NodeDirectory("/sys/devices/system/node");
+
+// From linux/mempolicy.h: move pages that are only mapped by this process
+const int MpolMfMove = 1 << 1;
+
+// Pages sampled per array to estimate on which node it lies
+const size_t SampledPages = 64;
+
+// Pages passed to the kernel per call when moving an array
+const size_t MoveBatchPages = 4096;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<int> ParseCpuList(const QString& list)
+{
+  // e.g. "0-7,16-23"
+  QVector<int> cpus;
+  QStringList ranges = list.trimmed().split(',', QString::SkipEmptyParts);
+  for(const QString& range : ranges)
+  {
+    QStringList bounds = range.split('-');
+    int first = bounds.front().toInt();
+    int last = bounds.back().toInt();
+    for(int cpu = first; cpu <= last; cpu++)
+    {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+NumaTopology::NumaTopology()
+: m_FirstTouch(true)
+{
+  readNodes();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+NumaTopology::~NumaTopology() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+NumaTopology* NumaTopology::Instance()
+{
+  static NumaTopology topology;
+  return &topology;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int NumaTopology::NodeOfSlot(int slot, int threads, int nodeCount)
+{
+  if(threads < 1 || nodeCount < 2)
+  {
+    return 0;
+  }
+  slot = std::min(std::max(slot, 0), threads - 1);
+  return slot * nodeCount / threads;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void NumaTopology::readNodes()
+{
+  m_Nodes.clear();
+  m_ProcessCpus.clear();
+
+#if defined(Q_OS_WIN)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  m_PageBytes = info.dwPageSize;
+
+  DWORD_PTR processMask = 0;
+  DWORD_PTR systemMask = 0;
+  GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask);
+  for(int cpu = 0; cpu < static_cast<int>(sizeof(DWORD_PTR) * 8); cpu++)
+  {
+    if((processMask >> cpu) & 1)
+    {
+      m_ProcessCpus.push_back(cpu);
+    }
+  }
+
+  // Only the first processor group is used, like the affinity masks above
+  ULONG highestNode = 0;
+  if(GetNumaHighestNodeNumber(&highestNode))
+  {
+    for(ULONG id = 0; id <= highestNode; id++)
+    {
+      ULONGLONG nodeMask = 0;
+      if(!GetNumaNodeProcessorMask(static_cast<UCHAR>(id), &nodeMask))
+      {
+        continue;
+      }
+      Node node;
+      node.id = static_cast<int>(id);
+      for(int cpu : m_ProcessCpus)
+      {
+        if((nodeMask >> cpu) & 1)
+        {
+          node.cpus.push_back(cpu);
+        }
+      }
+      if(!node.cpus.isEmpty())
+      {
+        m_Nodes.push_back(node);
+      }
+    }
+  }
+#else
+  m_PageBytes = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+#if defined(Q_OS_LINUX)
+  cpu_set_t processSet;
+  CPU_ZERO(&processSet);
+  if(sched_getaffinity(0, sizeof(processSet), &processSet) == 0)
+  {
+    for(int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+      if(CPU_ISSET(cpu, &processSet))
+      {
+        m_ProcessCpus.push_back(cpu);
+      }
+    }
+  }
+
+  QDir nodeDir(NodeDirectory);
+  QStringList entries = nodeDir.entryList(QStringList("node*"), QDir::Dirs);
+  for(const QString& entry : entries)
+  {
+    bool ok = false;
+    int id = entry.mid(4).toInt(&ok);
+    QFile cpuList(nodeDir.filePath(entry + "/cpulist"));
+    if(!ok || !cpuList.open(QIODevice::ReadOnly))
+    {
+      continue;
+    }
+
+    // Nodes without CPUs the process may use, e.g. memory expanders, never get threads
+    Node node;
+    node.id = id;
+    QVector<int> cpus = ParseCpuList(QString::fromLatin1(cpuList.readAll()));
+    for(int cpu : cpus)
+    {
+      if(m_ProcessCpus.contains(cpu))
+      {
+        node.cpus.push_back(cpu);
+      }
+    }
+    if(!node.cpus.isEmpty())
+    {
+      m_Nodes.push_back(node);
+    }
+  }
+  std::sort(m_Nodes.begin(), m_Nodes.end(), [](const Node& a, const Node& b) { return a.id < b.id; });
+#endif
+#endif
+
+  if(m_ProcessCpus.isEmpty())
+  {
+    for(int cpu = 0; cpu < QThread::idealThreadCount(); cpu++)
+    {
+      m_ProcessCpus.push_back(cpu);
+    }
+  }
+  if(m_Nodes.isEmpty())
+  {
+    Node node;
+    node.cpus = m_ProcessCpus;
+    m_Nodes.push_back(node);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void NumaTopology::ReadMemory(Node& node)
+{
+#if defined(Q_OS_WIN)
+  ULONGLONG available = 0;
+  if(GetNumaAvailableMemoryNode(static_cast<UCHAR>(node.id), &available))
+  {
+    node.freeBytes = static_cast<size_t>(available);
+  }
+#elif defined(Q_OS_LINUX)
+  // e.g. "Node 0 MemTotal:       65842332 kB"
+  QFile meminfo(QString("%1/node%2/meminfo").arg(NodeDirectory).arg(node.id));
+  if(!meminfo.open(QIODevice::ReadOnly))
+  {
+    return;
+  }
+  QStringList lines = QString::fromLatin1(meminfo.readAll()).split('\n', QString::SkipEmptyParts);
+  for(const QString& line : lines)
+  {
+    QStringList fields = line.simplified().split(' ');
+    if(fields.size() < 4)
+    {
+      continue;
+    }
+    size_t bytes = fields[3].toULongLong() * 1024;
+    if(fields[2] == "MemTotal:")
+    {
+      node.totalBytes = bytes;
+    }
+    else if(fields[2] == "MemFree:")
+    {
+      node.freeBytes = bytes;
+    }
+  }
+#else
+  Q_UNUSED(node)
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int NumaTopology::getNodeCount() const
+{
+  return m_Nodes.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int NumaTopology::getNodeId(int index) const
+{
+  return (index >= 0 && index < m_Nodes.size()) ? m_Nodes[index].id : -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<NumaTopology::Node> NumaTopology::getNodes() const
+{
+  QVector<Node> nodes = m_Nodes;
+  for(Node& node : nodes)
+  {
+    ReadMemory(node);
+  }
+  return nodes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int NumaTopology::getCpuCount(int node) const
+{
+  for(const Node& entry : m_Nodes)
+  {
+    if(entry.id == node)
+    {
+      return entry.cpus.size();
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void NumaTopology::setFirstTouch(bool enabled)
+{
+  m_FirstTouch = enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool NumaTopology::getFirstTouch() const
+{
+  return m_FirstTouch;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool NumaTopology::pinCurrentThread(int node) const
+{
+  const Node* target = nullptr;
+  for(const Node& entry : m_Nodes)
+  {
+    if(entry.id == node)
+    {
+      target = &entry;
+    }
+  }
+  if(target == nullptr)
+  {
+    return false;
+  }
+
+#if defined(Q_OS_WIN)
+  DWORD_PTR mask = 0;
+  for(int cpu : target->cpus)
+  {
+    mask |= static_cast<DWORD_PTR>(1) << cpu;
+  }
+  return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(Q_OS_LINUX)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for(int cpu : target->cpus)
+  {
+    CPU_SET(cpu, &set);
+  }
+  // A pid of 0 is the calling thread
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void NumaTopology::unpinCurrentThread() const
+{
+  if(m_Nodes.size() < 2)
+  {
+    return;
+  }
+
+#if defined(Q_OS_WIN)
+  DWORD_PTR mask = 0;
+  for(int cpu : m_ProcessCpus)
+  {
+    mask |= static_cast<DWORD_PTR>(1) << cpu;
+  }
+  SetThreadAffinityMask(GetCurrentThread(), mask);
+#elif defined(Q_OS_LINUX)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for(int cpu : m_ProcessCpus)
+  {
+    CPU_SET(cpu, &set);
+  }
+  sched_setaffinity(0, sizeof(set), &set);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void NumaTopology::firstTouch(void* block, size_t bytes) const
+{
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(m_FirstTouch && m_Nodes.size() > 1 && bytes > m_PageBytes)
+  {
+    char* start = static_cast<char*>(block);
+    size_t pageBytes = m_PageBytes;
+    size_t pages = (bytes + pageBytes - 1) / pageBytes;
+    auto zero = [start, pageBytes, bytes](const tbb::blocked_range<size_t>& range) {
+      size_t first = range.begin() * pageBytes;
+      size_t last = std::min(range.end() * pageBytes, bytes);
+      std::memset(start + first, 0, last - first);
+    };
+#if TBB_INTERFACE_VERSION >= 9100
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pages), zero, tbb::static_partitioner());
+#else
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pages), zero, tbb::auto_partitioner());
+#endif
+    return;
+  }
+#endif
+
+  std::memset(block, 0, bytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<int> NumaTopology::PageNodes(void** pages, size_t count)
+{
+  QVector<int> nodes(static_cast<int>(count), -1);
+#if defined(Q_OS_LINUX) && defined(SYS_move_pages)
+  // Without target nodes move_pages() only reports where each page is
+  std::vector<int> status(count, -1);
+  if(syscall(SYS_move_pages, 0, count, pages, nullptr, status.data(), 0) == 0)
+  {
+    for(size_t i = 0; i < count; i++)
+    {
+      nodes[static_cast<int>(i)] = (status[i] >= 0) ? status[i] : -1;
+    }
+  }
+#else
+  Q_UNUSED(pages)
+#endif
+  return nodes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t NumaTopology::distribute(void* data, size_t bytes) const
+{
+#if defined(Q_OS_LINUX) && defined(SYS_move_pages)
+  if(m_Nodes.size() < 2)
+  {
+    return 0;
+  }
+
+  // Only whole pages of the array are moved; the partial pages at both ends may be shared with other data
+  uintptr_t first = (reinterpret_cast<uintptr_t>(data) + m_PageBytes - 1) / m_PageBytes * m_PageBytes;
+  uintptr_t last = (reinterpret_cast<uintptr_t>(data) + bytes) / m_PageBytes * m_PageBytes;
+  if(last <= first)
+  {
+    return 0;
+  }
+  size_t pages = (last - first) / m_PageBytes;
+  size_t nodeCount = static_cast<size_t>(m_Nodes.size());
+
+  size_t moved = 0;
+  std::vector<void*> addresses;
+  std::vector<int> targets;
+  for(size_t batch = 0; batch < pages; batch += MoveBatchPages)
+  {
+    size_t count = std::min(MoveBatchPages, pages - batch);
+    addresses.resize(count);
+    for(size_t i = 0; i < count; i++)
+    {
+      addresses[i] = reinterpret_cast<void*>(first + (batch + i) * m_PageBytes);
+    }
+
+    // Pages already on their node, or not touched yet, stay where they are
+    QVector<int> current = PageNodes(addresses.data(), count);
+    std::vector<void*> moving;
+    targets.clear();
+    for(size_t i = 0; i < count; i++)
+    {
+      int target = m_Nodes[static_cast<int>((batch + i) * nodeCount / pages)].id;
+      if(current[static_cast<int>(i)] >= 0 && current[static_cast<int>(i)] != target)
+      {
+        moving.push_back(addresses[i]);
+        targets.push_back(target);
+      }
+    }
+    if(moving.empty())
+    {
+      continue;
+    }
+
+    std::vector<int> status(moving.size(), -1);
+    if(syscall(SYS_move_pages, 0, moving.size(), moving.data(), targets.data(), status.data(), MpolMfMove) < 0)
+    {
+      break;
+    }
+    for(size_t i = 0; i < moving.size(); i++)
+    {
+      if(status[i] == targets[i])
+      {
+        moved += m_PageBytes;
+      }
+    }
+  }
+  return moved;
+#else
+  Q_UNUSED(data)
+  Q_UNUSED(bytes)
+  return 0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<size_t> NumaTopology::residentBytes(const DataContainerArray::Pointer& dca) const
+{
+  QVector<size_t> resident(m_Nodes.size(), 0);
+  if(m_Nodes.size() < 2 || dca.get() == nullptr)
+  {
+    return resident;
+  }
+
+  std::vector<void*> samples;
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        IDataArray::Pointer array = am->getAttributeArray(name);
+        size_t bytes = array->getSize() * array->getTypeSize();
+        char* data = static_cast<char*>(array->getVoidPointer(0));
+        if(bytes < m_PageBytes || data == nullptr)
+        {
+          continue;
+        }
+
+        size_t count = std::min(SampledPages, bytes / m_PageBytes);
+        samples.resize(count);
+        for(size_t i = 0; i < count; i++)
+        {
+          uintptr_t address = reinterpret_cast<uintptr_t>(data + i * (bytes / count));
+          samples[i] = reinterpret_cast<void*>(address / m_PageBytes * m_PageBytes);
+        }
+        QVector<int> nodes = PageNodes(samples.data(), count);
+        for(int node : nodes)
+        {
+          for(int i = 0; i < m_Nodes.size(); i++)
+          {
+            if(m_Nodes[i].id == node)
+            {
+              resident[i] += bytes / count;
+            }
+          }
+        }
+      }
+    }
+  }
+  return resident;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList NumaTopology::report(const DataContainerArray::Pointer& dca) const
+{
+  QStringList lines;
+  if(m_Nodes.size() < 2)
+  {
+    return lines;
+  }
+
+  QVector<Node> nodes = getNodes();
+  QVector<size_t> resident = residentBytes(dca);
+  for(int i = 0; i < nodes.size(); i++)
+  {
+    lines.push_back(QObject::tr("NUMA node %1: %2 CPUs, %3 of the arrays, %4 free of %5")
+                        .arg(nodes[i].id)
+                        .arg(nodes[i].cpus.size())
+                        .arg(MemoryEstimator::FormatBytes(resident[i]))
+                        .arg(MemoryEstimator::FormatBytes(nodes[i].freeBytes))
+                        .arg(MemoryEstimator::FormatBytes(nodes[i].totalBytes)));
+  }
+  return lines;
+}
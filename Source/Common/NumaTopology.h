@@ -0,0 +1,196 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+/**
+ * @brief The NumaTopology class describes the NUMA nodes of the machine and places threads and array pages
+ * on them.
+ *
+ * Memory is placed on the node of the thread that first touches it. An array zeroed by one thread ends up
+ * entirely on that thread's node, and every parallel loop over it then reads half of it across the socket
+ * interconnect. firstTouch() therefore zeroes fresh blocks with a static partitioning over the threads of
+ * the calling TBB arena, the same contiguous slices a parallel loop over the array hands to those threads.
+ * Arrays allocated elsewhere, e.g. by a filter itself, can be moved afterwards with distribute(), which puts
+ * consecutive equal slices of the array on consecutive nodes; this matches the threads of an arena that are
+ * pinned with pinCurrentThread(getNodeId(NodeOfSlot(...))).
+ *
+ * On machines with a single node, or where the topology cannot be read, every function is a cheap no-op
+ * apart from firstTouch(), which still zeroes the block.
+ */
+class NumaTopology
+{
+public:
+  /**
+   * @brief The Node struct describes one NUMA node
+   */
+  struct Node
+  {
+    int id = 0;
+    QVector<int> cpus;
+    size_t totalBytes = 0;
+    size_t freeBytes = 0;
+  };
+
+  /**
+   * @brief Instance Returns the topology of the machine, read once
+   * @return
+   */
+  static NumaTopology* Instance();
+
+  /**
+   * @brief NodeOfSlot Returns the index of the node the thread in 'slot' of an arena with 'threads' threads
+   * is pinned to, so consecutive slots share a node
+   * @param slot
+   * @param threads
+   * @param nodeCount
+   * @return
+   */
+  static int NodeOfSlot(int slot, int threads, int nodeCount);
+
+  int getNodeCount() const;
+
+  /**
+   * @brief getNodeId Returns the id the operating system gives the node at 'index'
+   * @param index
+   * @return
+   */
+  int getNodeId(int index) const;
+
+  /**
+   * @brief getNodes Returns the nodes with their current free memory
+   * @return
+   */
+  QVector<Node> getNodes() const;
+
+  /**
+   * @brief getCpuCount Returns the number of CPUs of 'node' this process may run on
+   * @param node
+   * @return
+   */
+  int getCpuCount(int node) const;
+
+  /**
+   * @brief setFirstTouch Sets whether firstTouch() zeroes blocks in parallel on machines with several nodes
+   * @param enabled
+   */
+  void setFirstTouch(bool enabled);
+  bool getFirstTouch() const;
+
+  /**
+   * @brief pinCurrentThread Restricts the calling thread to the CPUs of 'node'
+   * @param node
+   * @return false if the thread could not be pinned
+   */
+  bool pinCurrentThread(int node) const;
+
+  /**
+   * @brief unpinCurrentThread Lets the calling thread run on every CPU of the process again
+   */
+  void unpinCurrentThread() const;
+
+  /**
+   * @brief firstTouch Zeroes 'bytes' at 'block' with the threads of the calling arena, each zeroing the
+   * slice a statically partitioned loop would give it
+   * @param block
+   * @param bytes
+   */
+  void firstTouch(void* block, size_t bytes) const;
+
+  /**
+   * @brief distribute Moves the pages of 'bytes' at 'data' so that consecutive equal slices lie on
+   * consecutive nodes
+   * @param data
+   * @param bytes
+   * @return The bytes that were moved
+   */
+  size_t distribute(void* data, size_t bytes) const;
+
+  /**
+   * @brief residentBytes Estimates how many bytes of the arrays of 'dca' lie on each node by sampling pages
+   * @param dca
+   * @return The bytes per node, indexed like getNodes()
+   */
+  QVector<size_t> residentBytes(const DataContainerArray::Pointer& dca) const;
+
+  /**
+   * @brief report Returns a line for every node with its CPUs, the bytes of the arrays of 'dca' on it and
+   * its free memory
+   * @param dca
+   * @return
+   */
+  QStringList report(const DataContainerArray::Pointer& dca) const;
+
+protected:
+  NumaTopology();
+  virtual ~NumaTopology();
+
+  /**
+   * @brief readNodes Reads the nodes and the CPUs of the process
+   */
+  void readNodes();
+
+  /**
+   * @brief ReadMemory Fills in the total and free memory of 'node'
+   * @param node
+   */
+  static void ReadMemory(Node& node);
+
+  /**
+   * @brief PageNodes Returns the node id of each of the 'count' page addresses in 'pages', -1 for pages that
+   * are not resident
+   * @param pages
+   * @param count
+   * @return
+   */
+  static QVector<int> PageNodes(void** pages, size_t count);
+
+private:
+  QVector<Node> m_Nodes;
+  QVector<int> m_ProcessCpus;
+  size_t m_PageBytes = 4096;
+  std::atomic<bool> m_FirstTouch;
+
+  NumaTopology(const NumaTopology&) = delete;   // Copy Constructor Not Implemented
+  void operator=(const NumaTopology&) = delete; // Move assignment Not Implemented
+};
@@ -0,0 +1,583 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ParallelChunkIO.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFuture>
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+namespace
+{
+// qCompress() and qUncompress() take the size as an int and prepend it to the zlib stream
+const size_t MaxChunkBytes = INT_MAX / 2;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void RunParallel(size_t count, const std::function<void(size_t, size_t)>& body)
+{
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, count), [&body](const tbb::blocked_range<size_t>& range) { body(range.begin(), range.end()); }, tbb::auto_partitioner());
+#else
+  body(0, count);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// The byte shuffle of the HDF5 shuffle filter: byte 'j' of every element goes into the 'j'th plane
+// -----------------------------------------------------------------------------
+QByteArray Shuffle(const QByteArray& data, size_t typeSize, bool inverse)
+{
+  if(typeSize <= 1)
+  {
+    return data;
+  }
+  size_t elements = static_cast<size_t>(data.size()) / typeSize;
+  QByteArray shuffled(data.size(), Qt::Uninitialized);
+  const char* in = data.constData();
+  char* out = shuffled.data();
+  for(size_t i = 0; i < elements; i++)
+  {
+    for(size_t j = 0; j < typeSize; j++)
+    {
+      if(inverse)
+      {
+        out[i * typeSize + j] = in[j * elements + i];
+      }
+      else
+      {
+        out[j * elements + i] = in[i * typeSize + j];
+      }
+    }
+  }
+  // Like the filter, bytes that do not fill a whole element stay where they are
+  size_t tail = elements * typeSize;
+  std::memcpy(out + tail, in + tail, static_cast<size_t>(data.size()) - tail);
+  return shuffled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray Deflate(const QByteArray& data, int level)
+{
+  // Past its 4 byte size prefix, the output of qCompress() is the zlib stream the deflate filter stores
+  QByteArray compressed = qCompress(data, level);
+  return compressed.mid(4);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray Inflate(const QByteArray& data, size_t bytes)
+{
+  QByteArray prefixed(4, Qt::Uninitialized);
+  prefixed[0] = static_cast<char>((bytes >> 24) & 0xFF);
+  prefixed[1] = static_cast<char>((bytes >> 16) & 0xFF);
+  prefixed[2] = static_cast<char>((bytes >> 8) & 0xFF);
+  prefixed[3] = static_cast<char>(bytes & 0xFF);
+  prefixed.append(data);
+  return qUncompress(prefixed);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ParallelChunkIO::ParallelChunkIO(hid_t datasetId)
+: m_DatasetId(datasetId)
+{
+  m_FileType = H5Dget_type(datasetId);
+  m_TypeSize = m_FileType >= 0 ? H5Tget_size(m_FileType) : 0;
+  hid_t space = H5Dget_space(datasetId);
+  int rank = space >= 0 ? H5Sget_simple_extent_ndims(space) : 0;
+  if(rank > 0)
+  {
+    m_Dims.resize(rank);
+    H5Sget_simple_extent_dims(space, m_Dims.data(), nullptr);
+  }
+  if(space >= 0)
+  {
+    H5Sclose(space);
+  }
+
+#if H5_VERSION_GE(1, 10, 2)
+  H5T_class_t typeClass = m_FileType >= 0 ? H5Tget_class(m_FileType) : H5T_NO_CLASS;
+  hid_t dcpl = H5Dget_create_plist(datasetId);
+  if(dcpl >= 0 && rank > 0 && (typeClass == H5T_INTEGER || typeClass == H5T_FLOAT) && H5Pget_layout(dcpl) == H5D_CHUNKED)
+  {
+    m_Chunk.resize(rank);
+    H5Pget_chunk(dcpl, rank, m_Chunk.data());
+    m_ChunkBytes = m_TypeSize;
+    for(hsize_t extent : m_Chunk)
+    {
+      m_ChunkBytes *= extent;
+    }
+    m_Direct = m_ChunkBytes > 0 && m_ChunkBytes <= MaxChunkBytes;
+
+    int filters = H5Pget_nfilters(dcpl);
+    for(int i = 0; i < filters && m_Direct; i++)
+    {
+      unsigned int flags = 0;
+      size_t values = 8;
+      unsigned int cdValues[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+      H5Z_filter_t id = H5Pget_filter2(dcpl, static_cast<unsigned>(i), &flags, &values, cdValues, 0, nullptr, nullptr);
+      Filter filter;
+      if(id == H5Z_FILTER_SHUFFLE)
+      {
+        filter.shuffle = true;
+      }
+      else if(id == H5Z_FILTER_DEFLATE)
+      {
+        filter.level = values > 0 ? static_cast<int>(cdValues[0]) : 6;
+      }
+      else
+      {
+        m_Direct = false;
+      }
+      m_Filters.push_back(filter);
+    }
+
+    // Chunks that were never written read as the fill value, which the chunk path only knows to be zero
+    H5D_fill_value_t fillStatus = H5D_FILL_VALUE_DEFAULT;
+    H5Pfill_value_defined(dcpl, &fillStatus);
+    if(fillStatus == H5D_FILL_VALUE_USER_DEFINED && m_Direct)
+    {
+      std::vector<char> fill(m_TypeSize, 0);
+      H5Pget_fill_value(dcpl, m_FileType, fill.data());
+      m_Direct = std::all_of(fill.begin(), fill.end(), [](char c) { return c == 0; });
+    }
+  }
+  if(dcpl >= 0)
+  {
+    H5Pclose(dcpl);
+  }
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ParallelChunkIO::~ParallelChunkIO()
+{
+  if(m_FileType >= 0)
+  {
+    H5Tclose(m_FileType);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ParallelChunkIO::isDirect() const
+{
+  return m_Direct;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ParallelChunkIO::usesChunks(hid_t memType) const
+{
+  return m_Direct && H5Tequal(memType, m_FileType) > 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<QVector<hsize_t>> ParallelChunkIO::chunkOffsets(hsize_t rowStart, hsize_t rowEnd) const
+{
+  QVector<QVector<hsize_t>> offsets;
+  int rank = m_Dims.size();
+  QVector<hsize_t> first(rank, 0);
+  QVector<hsize_t> last(rank, 0);
+  first[0] = rowStart / m_Chunk[0];
+  last[0] = (rowEnd + m_Chunk[0] - 1) / m_Chunk[0];
+  for(int i = 1; i < rank; i++)
+  {
+    last[i] = (m_Dims[i] + m_Chunk[i] - 1) / m_Chunk[i];
+  }
+  for(int i = 0; i < rank; i++)
+  {
+    if(first[i] >= last[i])
+    {
+      return offsets;
+    }
+  }
+
+  QVector<hsize_t> index = first;
+  while(true)
+  {
+    QVector<hsize_t> offset(rank);
+    for(int i = 0; i < rank; i++)
+    {
+      offset[i] = index[i] * m_Chunk[i];
+    }
+    offsets.push_back(offset);
+
+    int d = rank - 1;
+    for(; d >= 0; d--)
+    {
+      if(++index[d] < last[d])
+      {
+        break;
+      }
+      index[d] = first[d];
+    }
+    if(d < 0)
+    {
+      break;
+    }
+  }
+  return offsets;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ParallelChunkIO::copyChunk(char* chunk, const QVector<hsize_t>& offset, char* rowData, hsize_t rowStart, hsize_t rows, bool toChunk) const
+{
+  int rank = m_Dims.size();
+  QVector<hsize_t> begin(rank);
+  QVector<hsize_t> end(rank);
+  for(int i = 0; i < rank; i++)
+  {
+    begin[i] = offset[i];
+    end[i] = std::min(offset[i] + m_Chunk[i], m_Dims[i]);
+  }
+  begin[0] = std::max(begin[0], rowStart);
+  end[0] = std::min(end[0], rowStart + rows);
+  if(begin[0] >= end[0])
+  {
+    return;
+  }
+
+  QVector<hsize_t> chunkStride(rank, 1);
+  QVector<hsize_t> rowStride(rank, 1);
+  for(int i = rank - 2; i >= 0; i--)
+  {
+    chunkStride[i] = chunkStride[i + 1] * m_Chunk[i + 1];
+    rowStride[i] = rowStride[i + 1] * m_Dims[i + 1];
+  }
+
+  // One run along the fastest dimension at a time
+  size_t lineBytes = static_cast<size_t>(end[rank - 1] - begin[rank - 1]) * m_TypeSize;
+  QVector<hsize_t> position = begin;
+  while(true)
+  {
+    hsize_t chunkIndex = 0;
+    hsize_t rowIndex = 0;
+    for(int i = 0; i < rank; i++)
+    {
+      chunkIndex += (position[i] - offset[i]) * chunkStride[i];
+      rowIndex += (position[i] - (i == 0 ? rowStart : 0)) * rowStride[i];
+    }
+    char* chunkLine = chunk + chunkIndex * m_TypeSize;
+    char* rowLine = rowData + rowIndex * m_TypeSize;
+    if(toChunk)
+    {
+      std::memcpy(chunkLine, rowLine, lineBytes);
+    }
+    else
+    {
+      std::memcpy(rowLine, chunkLine, lineBytes);
+    }
+
+    int d = rank - 2;
+    for(; d >= 0; d--)
+    {
+      if(++position[d] < end[d])
+      {
+        break;
+      }
+      position[d] = begin[d];
+    }
+    if(d < 0)
+    {
+      break;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ParallelChunkIO::writeHyperslab(hid_t memType, hsize_t rowStart, hsize_t rows, const void* data) const
+{
+  hid_t fileSpace = H5Dget_space(m_DatasetId);
+  QVector<hsize_t> start(m_Dims.size(), 0);
+  QVector<hsize_t> count = m_Dims;
+  start[0] = rowStart;
+  count[0] = rows;
+  H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr);
+  hid_t memSpace = H5Screate_simple(count.size(), count.data(), nullptr);
+  herr_t err = H5Dwrite(m_DatasetId, memType, memSpace, fileSpace, H5P_DEFAULT, data);
+  H5Sclose(memSpace);
+  H5Sclose(fileSpace);
+  return err >= 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ParallelChunkIO::readHyperslab(hid_t memType, hsize_t rowStart, hsize_t rows, void* data) const
+{
+  hid_t fileSpace = H5Dget_space(m_DatasetId);
+  QVector<hsize_t> start(m_Dims.size(), 0);
+  QVector<hsize_t> count = m_Dims;
+  start[0] = rowStart;
+  count[0] = rows;
+  H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr);
+  hid_t memSpace = H5Screate_simple(count.size(), count.data(), nullptr);
+  herr_t err = H5Dread(m_DatasetId, memType, memSpace, fileSpace, H5P_DEFAULT, data);
+  H5Sclose(memSpace);
+  H5Sclose(fileSpace);
+  return err >= 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ParallelChunkIO::writeRows(hid_t memType, hsize_t rowStart, hsize_t rows, const void* data)
+{
+  if(rows == 0 || m_Dims.isEmpty())
+  {
+    return true;
+  }
+  // A chunk that is only partly written here would lose the rows it already holds
+  bool wholeChunks = usesChunks(memType) && rowStart % m_Chunk[0] == 0 && (rows % m_Chunk[0] == 0 || rowStart + rows == m_Dims[0]);
+  if(!wholeChunks)
+  {
+    return writeHyperslab(memType, rowStart, rows, data);
+  }
+
+#if H5_VERSION_GE(1, 10, 2)
+  QVector<QVector<hsize_t>> offsets = chunkOffsets(rowStart, rowStart + rows);
+  size_t chunkCount = static_cast<size_t>(offsets.size());
+  size_t batchChunks = std::max(BatchBytes / m_ChunkBytes, static_cast<size_t>(1));
+  char* rowData = const_cast<char*>(reinterpret_cast<const char*>(data));
+
+  QVector<QByteArray> encoded;
+  QVector<QByteArray> writing;
+  QFuture<bool> pending;
+  bool writePending = false;
+  bool ok = true;
+  for(size_t first = 0; first < chunkCount && ok; first += batchChunks)
+  {
+    size_t count = std::min(batchChunks, chunkCount - first);
+    encoded.resize(static_cast<int>(count));
+    RunParallel(count, [&](size_t begin, size_t end) {
+      std::vector<char> raw(m_ChunkBytes);
+      for(size_t k = begin; k < end; k++)
+      {
+        // The parts of edge chunks outside the dataset are written as zeros, as HDF5 does
+        std::fill(raw.begin(), raw.end(), 0);
+        copyChunk(raw.data(), offsets[static_cast<int>(first + k)], rowData, rowStart, rows, true);
+        QByteArray chunk(raw.data(), static_cast<int>(m_ChunkBytes));
+        for(const Filter& filter : m_Filters)
+        {
+          chunk = filter.shuffle ? Shuffle(chunk, m_TypeSize, false) : Deflate(chunk, filter.level);
+        }
+        encoded[static_cast<int>(k)] = chunk;
+      }
+    });
+
+    // The previous batch was written while this one was encoded
+    if(writePending)
+    {
+      ok = pending.result();
+      writePending = false;
+      if(!ok)
+      {
+        break;
+      }
+    }
+    writing.swap(encoded);
+    pending = QtConcurrent::run([this, &offsets, &writing, first]() {
+      for(int k = 0; k < writing.size(); k++)
+      {
+        const QByteArray& chunk = writing[k];
+        if(H5Dwrite_chunk(m_DatasetId, H5P_DEFAULT, 0, offsets[static_cast<int>(first) + k].data(), static_cast<size_t>(chunk.size()), chunk.constData()) < 0)
+        {
+          return false;
+        }
+      }
+      return true;
+    });
+    writePending = true;
+  }
+  if(writePending)
+  {
+    ok = pending.result() && ok;
+  }
+  return ok;
+#else
+  return writeHyperslab(memType, rowStart, rows, data);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ParallelChunkIO::readRows(hid_t memType, hsize_t rowStart, hsize_t rows, void* data)
+{
+  if(rows == 0 || m_Dims.isEmpty())
+  {
+    return true;
+  }
+  if(!usesChunks(memType))
+  {
+    return readHyperslab(memType, rowStart, rows, data);
+  }
+
+#if H5_VERSION_GE(1, 10, 2)
+  QVector<QVector<hsize_t>> offsets = chunkOffsets(rowStart, rowStart + rows);
+  size_t chunkCount = static_cast<size_t>(offsets.size());
+  size_t batchChunks = std::max(BatchBytes / m_ChunkBytes, static_cast<size_t>(1));
+  char* rowData = reinterpret_cast<char*>(data);
+
+  // Reads the stored bytes and the skipped filters of the chunks in one batch; an empty chunk was never
+  // written
+  auto fetch = [this, &offsets](size_t first, size_t count, QVector<QByteArray>* chunks, QVector<uint32_t>* masks) {
+    chunks->resize(static_cast<int>(count));
+    masks->fill(0, static_cast<int>(count));
+    for(size_t k = 0; k < count; k++)
+    {
+      const hsize_t* offset = offsets[static_cast<int>(first + k)].data();
+      hsize_t storageBytes = 0;
+#if H5_VERSION_GE(1, 10, 5)
+      // Unlike H5Dget_chunk_storage_size(), this reports a chunk that was never written without pushing an
+      // error onto the error stack of the thread
+      unsigned int filterMask = 0;
+      haddr_t address = HADDR_UNDEF;
+      herr_t err = H5Dget_chunk_info_by_coord(m_DatasetId, offset, &filterMask, &address, &storageBytes);
+#else
+      herr_t err = 0;
+      H5E_BEGIN_TRY
+      {
+        err = H5Dget_chunk_storage_size(m_DatasetId, offset, &storageBytes);
+      }
+      H5E_END_TRY;
+#endif
+      QByteArray& chunk = (*chunks)[static_cast<int>(k)];
+      if(err < 0 || storageBytes == 0)
+      {
+        chunk.clear();
+        continue;
+      }
+      chunk.resize(static_cast<int>(storageBytes));
+      if(H5Dread_chunk(m_DatasetId, H5P_DEFAULT, offset, &(*masks)[static_cast<int>(k)], chunk.data()) < 0)
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  QVector<QByteArray> decoding;
+  QVector<uint32_t> decodingMasks;
+  QVector<QByteArray> reading;
+  QVector<uint32_t> readingMasks;
+  bool ok = fetch(0, std::min(batchChunks, chunkCount), &decoding, &decodingMasks);
+  for(size_t first = 0; first < chunkCount && ok; first += batchChunks)
+  {
+    // The next batch is read while this one is decoded
+    size_t next = first + batchChunks;
+    QFuture<bool> pending;
+    if(next < chunkCount)
+    {
+      pending = QtConcurrent::run([&fetch, &reading, &readingMasks, next, batchChunks, chunkCount]() {
+        return fetch(next, std::min(batchChunks, chunkCount - next), &reading, &readingMasks);
+      });
+    }
+
+    std::atomic<bool> decoded(true);
+    RunParallel(static_cast<size_t>(decoding.size()), [&](size_t begin, size_t end) {
+      std::vector<char> zeros;
+      for(size_t k = begin; k < end; k++)
+      {
+        const QVector<hsize_t>& offset = offsets[static_cast<int>(first + k)];
+        QByteArray chunk = decoding[static_cast<int>(k)];
+        if(chunk.isEmpty())
+        {
+          zeros.assign(m_ChunkBytes, 0);
+          copyChunk(zeros.data(), offset, rowData, rowStart, rows, false);
+          continue;
+        }
+        uint32_t mask = decodingMasks[static_cast<int>(k)];
+        for(int f = m_Filters.size() - 1; f >= 0; f--)
+        {
+          if((mask & (1u << f)) == 0)
+          {
+            chunk = m_Filters[f].shuffle ? Shuffle(chunk, m_TypeSize, true) : Inflate(chunk, m_ChunkBytes);
+          }
+        }
+        if(static_cast<size_t>(chunk.size()) != m_ChunkBytes)
+        {
+          decoded = false;
+          continue;
+        }
+        copyChunk(chunk.data(), offset, rowData, rowStart, rows, false);
+      }
+    });
+    ok = decoded;
+
+    if(next < chunkCount)
+    {
+      ok = pending.result() && ok;
+      decoding.swap(reading);
+      decodingMasks.swap(readingMasks);
+    }
+  }
+  return ok;
+#else
+  return readHyperslab(memType, rowStart, rows, data);
+#endif
+}
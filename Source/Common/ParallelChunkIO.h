@@ -0,0 +1,151 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <hdf5.h>
+
+#include <QtCore/QVector>
+
+/**
+ * @brief The ParallelChunkIO class reads and writes rows of the slowest dimension of a chunked HDF5 dataset
+ * whose only filters are the built-in shuffle and deflate filters, and runs those filters on a thread pool
+ * instead of in the serial filter pipeline of HDF5.
+ *
+ * Writes encode whole chunks in parallel and hand the encoded bytes to H5Dwrite_chunk; reads fetch the
+ * encoded chunks with H5Dread_chunk and decode them in parallel. The file only ever holds standard shuffle
+ * and deflate chunks, so any HDF5 tool reads it as usual. Chunks are processed in batches of about
+ * BatchBytes, and the file I/O of one batch runs on a background thread while the next batch is encoded or
+ * the previous one decoded, so the disk and the cores stay busy at the same time.
+ *
+ * Anything the chunk path cannot do falls back to a plain hyperslab H5Dwrite or H5Dread: other filters,
+ * a contiguous layout, a memory type that differs from the file type, a fill value that is not zero, a
+ * write that does not cover whole chunks, or an HDF5 library older than 1.10.2.
+ */
+class ParallelChunkIO
+{
+public:
+  static const size_t BatchBytes = 64 * 1024 * 1024;
+
+  /**
+   * @brief ParallelChunkIO Inspects the layout and the filters of 'datasetId'. The dataset stays owned by
+   * the caller and must stay open while this object is used.
+   * @param datasetId
+   */
+  explicit ParallelChunkIO(hid_t datasetId);
+  virtual ~ParallelChunkIO();
+
+  /**
+   * @brief isDirect Returns true if the dataset is read and written chunk by chunk
+   * @return
+   */
+  bool isDirect() const;
+
+  /**
+   * @brief writeRows Writes 'rows' rows of the slowest dimension starting at 'rowStart'. 'data' holds them
+   * as 'memType' with the full extent of every other dimension.
+   * @param memType
+   * @param rowStart
+   * @param rows
+   * @param data
+   * @return
+   */
+  bool writeRows(hid_t memType, hsize_t rowStart, hsize_t rows, const void* data);
+
+  /**
+   * @brief readRows Reads 'rows' rows of the slowest dimension starting at 'rowStart' into 'data', which
+   * must hold them as 'memType' with the full extent of every other dimension
+   * @param memType
+   * @param rowStart
+   * @param rows
+   * @param data
+   * @return
+   */
+  bool readRows(hid_t memType, hsize_t rowStart, hsize_t rows, void* data);
+
+protected:
+  /**
+   * @brief The Filter struct is one entry of the filter pipeline of the dataset
+   */
+  struct Filter
+  {
+    bool shuffle = false;
+    int level = 0;
+  };
+
+  /**
+   * @brief usesChunks Returns true if rows of 'memType' can go through the chunk path
+   * @param memType
+   * @return
+   */
+  bool usesChunks(hid_t memType) const;
+
+  /**
+   * @brief chunkOffsets Returns the element offsets of every chunk that overlaps the rows in 'rowStart' to
+   * 'rowEnd', in the order the chunks are stored
+   * @param rowStart
+   * @param rowEnd
+   * @return
+   */
+  QVector<QVector<hsize_t>> chunkOffsets(hsize_t rowStart, hsize_t rowEnd) const;
+
+  /**
+   * @brief copyChunk Copies the part of the chunk at 'offset' that lies within the rows 'rowStart' to
+   * 'rowStart' + 'rows' between 'chunk' and 'rowData'
+   * @param chunk
+   * @param offset
+   * @param rowData
+   * @param rowStart
+   * @param rows
+   * @param toChunk true to gather the rows into the chunk, false to scatter the chunk into the rows
+   */
+  void copyChunk(char* chunk, const QVector<hsize_t>& offset, char* rowData, hsize_t rowStart, hsize_t rows, bool toChunk) const;
+
+  bool writeHyperslab(hid_t memType, hsize_t rowStart, hsize_t rows, const void* data) const;
+  bool readHyperslab(hid_t memType, hsize_t rowStart, hsize_t rows, void* data) const;
+
+private:
+  hid_t m_DatasetId = -1;
+  hid_t m_FileType = -1;
+  size_t m_TypeSize = 0;
+  QVector<hsize_t> m_Dims;
+  QVector<hsize_t> m_Chunk;
+  QVector<Filter> m_Filters;
+  size_t m_ChunkBytes = 0;
+  bool m_Direct = false;
+
+  ParallelChunkIO(const ParallelChunkIO&) = delete; // Copy Constructor Not Implemented
+  void operator=(const ParallelChunkIO&) = delete;  // Move assignment Not Implemented
+};
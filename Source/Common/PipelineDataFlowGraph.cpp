@@ -0,0 +1,559 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineDataFlowGraph.h"
+
+#include <QtCore/QTextStream>
+#include <QtCore/QVariant>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/DataContainers/DataContainerArrayProxy.h"
+#include "SIMPLib/FilterParameters/FilterParameter.h"
+
+namespace
+{
+const QString k_DataContainerCreationWidget("DataContainerCreationWidget");
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int findRoot(QVector<int>& parents, int index)
+{
+  while(parents[index] != index)
+  {
+    parents[index] = parents[parents[index]];
+    index = parents[index];
+  }
+  return index;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<DataArrayPath> collectArrayPaths(const DataContainerArray::Pointer& dca)
+{
+  QVector<DataArrayPath> paths;
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::AttributeMatrixMap_t& matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        paths.push_back(DataArrayPath(dc->getName(), am->getName(), name));
+      }
+    }
+  }
+  return paths;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineDataFlowGraph::PipelineDataFlowGraph() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineDataFlowGraph::PipelineDataFlowGraph(FilterPipeline::Pointer pipeline)
+{
+  if(pipeline.get() != nullptr)
+  {
+    FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+    for(AbstractFilter::Pointer filter : filters)
+    {
+      if(filter->getEnabled())
+      {
+        m_Filters.push_back(filter);
+      }
+    }
+  }
+  buildGraph();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineDataFlowGraph::PipelineDataFlowGraph(const FilterPipeline::FilterContainerType& filters)
+{
+  for(AbstractFilter::Pointer filter : filters)
+  {
+    if(filter->getEnabled())
+    {
+      m_Filters.push_back(filter);
+    }
+  }
+  buildGraph();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineDataFlowGraph::~PipelineDataFlowGraph() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterDataFootprint PipelineDataFlowGraph::ComputeFootprint(AbstractFilter::Pointer filter)
+{
+  FilterDataFootprint footprint;
+  FilterParameterVector parameters = filter->getFilterParameters();
+  for(FilterParameter::Pointer parameter : parameters)
+  {
+    QString propertyName = parameter->getPropertyName();
+    if(propertyName.isEmpty())
+    {
+      continue;
+    }
+
+    QVariant var = filter->property(propertyName.toLatin1().constData());
+    if(!var.isValid())
+    {
+      continue;
+    }
+
+    FilterParameter::Category category = parameter->getCategory();
+    bool created = (category == FilterParameter::CreatedArray);
+
+    if(var.userType() == qMetaTypeId<DataArrayPath>())
+    {
+      DataArrayPath path = var.value<DataArrayPath>();
+      if(!path.getDataContainerName().isEmpty())
+      {
+        created ? footprint.writes.push_back(path) : footprint.reads.push_back(path);
+      }
+    }
+    else if(var.userType() == qMetaTypeId<QVector<DataArrayPath>>())
+    {
+      QVector<DataArrayPath> paths = var.value<QVector<DataArrayPath>>();
+      for(const DataArrayPath& path : paths)
+      {
+        if(!path.getDataContainerName().isEmpty())
+        {
+          created ? footprint.writes.push_back(path) : footprint.reads.push_back(path);
+        }
+      }
+    }
+    else if(var.userType() == qMetaTypeId<DataContainerArrayProxy>())
+    {
+      // Readers describe what they create through a proxy of the file contents
+      DataContainerArrayProxy proxy = var.value<DataContainerArrayProxy>();
+      for(const DataContainerProxy& dcProxy : proxy.dataContainers)
+      {
+        if(dcProxy.flag != Qt::Unchecked)
+        {
+          footprint.writes.push_back(DataArrayPath(dcProxy.name, "", ""));
+        }
+      }
+    }
+    else if(created && var.type() == QVariant::String && parameter->getWidgetType() == k_DataContainerCreationWidget)
+    {
+      QString dcName = var.toString();
+      if(!dcName.isEmpty())
+      {
+        footprint.writes.push_back(DataArrayPath(dcName, "", ""));
+      }
+    }
+    else if(created && var.type() == QVariant::String)
+    {
+      // A created AttributeMatrix or DataArray name. It lives inside a container that is referenced
+      // by one of the other parameters of this filter, so the container set below already covers it.
+      // resolveCreatedArrays() adds the full path of the array.
+      continue;
+    }
+    else if(category == FilterParameter::RequiredArray || category == FilterParameter::CreatedArray)
+    {
+      // Some parameter type that we do not know how to turn into paths
+      footprint.barrier = true;
+    }
+  }
+
+  for(const DataArrayPath& path : footprint.reads)
+  {
+    footprint.dataContainers.insert(path.getDataContainerName());
+  }
+  for(const DataArrayPath& path : footprint.writes)
+  {
+    footprint.dataContainers.insert(path.getDataContainerName());
+  }
+
+  if(footprint.dataContainers.isEmpty())
+  {
+    // Either the filter touches nothing we can see or it only names things we can not locate.
+    footprint.barrier = true;
+  }
+
+  return footprint;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineDataFlowGraph::PathCovers(const DataArrayPath& outer, const DataArrayPath& inner)
+{
+  if(outer.getDataContainerName() != inner.getDataContainerName())
+  {
+    return false;
+  }
+  if(outer.getAttributeMatrixName().isEmpty())
+  {
+    return true;
+  }
+  if(outer.getAttributeMatrixName() != inner.getAttributeMatrixName())
+  {
+    return false;
+  }
+  if(outer.getDataArrayName().isEmpty())
+  {
+    return true;
+  }
+  return outer.getDataArrayName() == inner.getDataArrayName();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineDataFlowGraph::PathsOverlap(const DataArrayPath& a, const DataArrayPath& b)
+{
+  return PathCovers(a, b) || PathCovers(b, a);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDataFlowGraph::buildGraph()
+{
+  int count = m_Filters.size();
+  m_Footprints.resize(count);
+  for(int i = 0; i < count; i++)
+  {
+    m_Footprints[i] = ComputeFootprint(m_Filters[i]);
+  }
+  buildEdges();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDataFlowGraph::addReads(int index, const QVector<DataArrayPath>& paths)
+{
+  FilterDataFootprint& footprint = m_Footprints[index];
+  for(const DataArrayPath& path : paths)
+  {
+    footprint.reads.push_back(path);
+    footprint.dataContainers.insert(path.getDataContainerName());
+  }
+  buildEdges();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDataFlowGraph::addWrites(int index, const QVector<DataArrayPath>& paths)
+{
+  FilterDataFootprint& footprint = m_Footprints[index];
+  for(const DataArrayPath& path : paths)
+  {
+    footprint.writes.push_back(path);
+    footprint.dataContainers.insert(path.getDataContainerName());
+  }
+  buildEdges();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineDataFlowGraph::resolveCreatedArrays()
+{
+  int count = m_Filters.size();
+  QVector<QVector<DataArrayPath>> created(count);
+
+  DataContainerArray::Pointer dca = DataContainerArray::New();
+  for(int i = 0; i < count; i++)
+  {
+    AbstractFilter::Pointer filter = m_Filters[i];
+    QVector<DataArrayPath> before = collectArrayPaths(dca);
+
+    filter->setDataContainerArray(dca);
+    filter->setErrorCondition(0);
+    filter->preflight();
+    if(filter->getErrorCondition() < 0)
+    {
+      // The created arrays of anything after this point are unreliable
+      return false;
+    }
+
+    QVector<DataArrayPath> after = collectArrayPaths(dca);
+    for(const DataArrayPath& path : after)
+    {
+      if(!before.contains(path))
+      {
+        created[i].push_back(path);
+      }
+    }
+  }
+
+  m_CreatedArrays = created;
+  m_Resolved = true;
+  for(int i = 0; i < count; i++)
+  {
+    FilterDataFootprint& footprint = m_Footprints[i];
+    for(const DataArrayPath& path : created[i])
+    {
+      if(!footprint.writes.contains(path))
+      {
+        footprint.writes.push_back(path);
+        footprint.dataContainers.insert(path.getDataContainerName());
+      }
+    }
+  }
+  buildEdges();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineDataFlowGraph::isResolved() const
+{
+  return m_Resolved;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<DataArrayPath> PipelineDataFlowGraph::createdArrays(int index) const
+{
+  if(index < 0 || index >= m_CreatedArrays.size())
+  {
+    return QVector<DataArrayPath>();
+  }
+  return m_CreatedArrays[index];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDataFlowGraph::buildEdges()
+{
+  int count = m_Filters.size();
+  m_Dependencies.fill(QList<int>(), count);
+  m_Dependents.fill(QList<int>(), count);
+  m_DataFlowSources.fill(QList<int>(), count);
+  m_Branches.fill(-1, count);
+  m_BranchCount = 0;
+
+  for(int j = 0; j < count; j++)
+  {
+    const FilterDataFootprint& later = m_Footprints[j];
+    for(int i = 0; i < j; i++)
+    {
+      const FilterDataFootprint& earlier = m_Footprints[i];
+
+      bool dataFlow = false;
+      for(const DataArrayPath& readPath : later.reads)
+      {
+        for(const DataArrayPath& writePath : earlier.writes)
+        {
+          if(PathsOverlap(readPath, writePath))
+          {
+            dataFlow = true;
+            break;
+          }
+        }
+        if(dataFlow)
+        {
+          break;
+        }
+      }
+      if(dataFlow)
+      {
+        m_DataFlowSources[j].push_back(i);
+      }
+
+      bool dependent = dataFlow || earlier.barrier || later.barrier || earlier.dataContainers.intersects(later.dataContainers);
+      if(dependent)
+      {
+        m_Dependencies[j].push_back(i);
+        m_Dependents[i].push_back(j);
+      }
+    }
+  }
+
+  // Group the non-barrier filters into branches (connected components)
+  QVector<int> parents(count);
+  for(int i = 0; i < count; i++)
+  {
+    parents[i] = i;
+  }
+  for(int j = 0; j < count; j++)
+  {
+    if(m_Footprints[j].barrier)
+    {
+      continue;
+    }
+    for(int i : m_Dependencies[j])
+    {
+      if(m_Footprints[i].barrier)
+      {
+        continue;
+      }
+      int rootI = findRoot(parents, i);
+      int rootJ = findRoot(parents, j);
+      if(rootI != rootJ)
+      {
+        parents[rootJ] = rootI;
+      }
+    }
+  }
+
+  QMap<int, int> branchIds;
+  for(int i = 0; i < count; i++)
+  {
+    if(m_Footprints[i].barrier)
+    {
+      continue;
+    }
+    int root = findRoot(parents, i);
+    if(!branchIds.contains(root))
+    {
+      branchIds.insert(root, m_BranchCount++);
+    }
+    m_Branches[i] = branchIds.value(root);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineDataFlowGraph::size() const
+{
+  return m_Filters.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer PipelineDataFlowGraph::filter(int index) const
+{
+  return m_Filters.at(index);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const FilterDataFootprint& PipelineDataFlowGraph::footprint(int index) const
+{
+  return m_Footprints.at(index);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QList<int> PipelineDataFlowGraph::dependencies(int index) const
+{
+  return m_Dependencies.at(index);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QList<int> PipelineDataFlowGraph::dependents(int index) const
+{
+  return m_Dependents.at(index);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QList<int> PipelineDataFlowGraph::dataFlowSources(int index) const
+{
+  return m_DataFlowSources.at(index);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineDataFlowGraph::branchCount() const
+{
+  return m_BranchCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineDataFlowGraph::branch(int index) const
+{
+  return m_Branches.at(index);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineDataFlowGraph::toString() const
+{
+  QString str;
+  QTextStream ss(&str);
+  ss << "Pipeline Data Flow Graph: " << size() << " filters, " << branchCount() << " independent branches\n";
+  for(int i = 0; i < size(); i++)
+  {
+    ss << "  [" << i << "] " << m_Filters[i]->getHumanLabel();
+    if(m_Footprints[i].barrier)
+    {
+      ss << " (barrier)";
+    }
+    else
+    {
+      ss << " (branch " << m_Branches[i] << ")";
+    }
+
+    QStringList deps;
+    for(int dep : m_Dependencies[i])
+    {
+      deps << QString::number(dep);
+    }
+    if(!deps.isEmpty())
+    {
+      ss << " waits on " << deps.join(", ");
+    }
+    ss << "\n";
+  }
+  return str;
+}
@@ -0,0 +1,225 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The FilterDataFootprint struct describes which parts of the DataContainerArray
+ * a single filter touches. It is derived from the filter's RequiredArray and CreatedArray
+ * parameters.
+ */
+struct FilterDataFootprint
+{
+  QVector<DataArrayPath> reads;
+  QVector<DataArrayPath> writes;
+  QSet<QString> dataContainers;
+
+  /**
+   * @brief barrier is true when the footprint could not be derived completely from the
+   * filter parameters. Such a filter must run alone against the whole DataContainerArray.
+   */
+  bool barrier = false;
+};
+
+/**
+ * @brief The PipelineDataFlowGraph class derives a dependency DAG from the read and write
+ * DataArrayPath sets of every filter in a FilterPipeline.
+ *
+ * Filter j depends on an earlier filter i when j reads a path that i writes (a data flow
+ * edge) or when both filters touch the same DataContainer. The second rule exists because
+ * the DataContainer and AttributeMatrix maps are not safe to modify from several threads, so
+ * two filters that touch the same DataContainer are never run at the same time. Filters whose
+ * footprint cannot be derived are barriers: they depend on every earlier filter and every
+ * later filter depends on them.
+ */
+class PipelineDataFlowGraph
+{
+public:
+  PipelineDataFlowGraph();
+  explicit PipelineDataFlowGraph(FilterPipeline::Pointer pipeline);
+  explicit PipelineDataFlowGraph(const FilterPipeline::FilterContainerType& filters);
+  virtual ~PipelineDataFlowGraph();
+
+  /**
+   * @brief ComputeFootprint Inspects the filter parameters of a filter and returns the
+   * paths that it reads and writes.
+   * @param filter
+   * @return
+   */
+  static FilterDataFootprint ComputeFootprint(AbstractFilter::Pointer filter);
+
+  /**
+   * @brief PathCovers Returns true if the path 'outer' is equal to or contains 'inner'. A
+   * DataContainer level path covers all of its AttributeMatrices and an AttributeMatrix
+   * level path covers all of its DataArrays.
+   * @param outer
+   * @param inner
+   * @return
+   */
+  static bool PathCovers(const DataArrayPath& outer, const DataArrayPath& inner);
+
+  /**
+   * @brief PathsOverlap Returns true if either path covers the other
+   * @param a
+   * @param b
+   * @return
+   */
+  static bool PathsOverlap(const DataArrayPath& a, const DataArrayPath& b);
+
+  /**
+   * @brief size Returns the number of filters (nodes) in the graph
+   * @return
+   */
+  int size() const;
+
+  /**
+   * @brief filter Returns the filter at the given node index
+   * @param index
+   * @return
+   */
+  AbstractFilter::Pointer filter(int index) const;
+
+  /**
+   * @brief footprint Returns the footprint of the filter at the given node index
+   * @param index
+   * @return
+   */
+  const FilterDataFootprint& footprint(int index) const;
+
+  /**
+   * @brief dependencies Returns the indices of the filters that must finish before the
+   * filter at 'index' may start.
+   * @param index
+   * @return
+   */
+  QList<int> dependencies(int index) const;
+
+  /**
+   * @brief dependents Returns the indices of the filters that wait on the filter at 'index'
+   * @param index
+   * @return
+   */
+  QList<int> dependents(int index) const;
+
+  /**
+   * @brief dataFlowSources Returns the earlier filters whose written paths are read by the
+   * filter at 'index'. This is a subset of dependencies() that ignores the container ordering.
+   * @param index
+   * @return
+   */
+  QList<int> dataFlowSources(int index) const;
+
+  /**
+   * @brief branchCount Returns the number of independent branches, i.e. the number of
+   * connected components of the graph when barriers are ignored.
+   * @return
+   */
+  int branchCount() const;
+
+  /**
+   * @brief branch Returns the branch id of the filter at 'index'. Barriers return -1.
+   * @param index
+   * @return
+   */
+  int branch(int index) const;
+
+  /**
+   * @brief toString Returns a human readable description of the graph, mostly useful
+   * for the standard output window and debugging.
+   * @return
+   */
+  QString toString() const;
+
+  /**
+   * @brief addReads Adds paths to the read set of the filter at 'index' and rebuilds the edges. This is
+   * used when the executor makes a filter consume data it does not name in its parameters.
+   * @param index
+   * @param paths
+   */
+  void addReads(int index, const QVector<DataArrayPath>& paths);
+
+  /**
+   * @brief addWrites Adds paths to the write set of the filter at 'index' and rebuilds the edges. This is
+   * used for arrays whose full path is only known after a preflight.
+   * @param index
+   * @param paths
+   */
+  void addWrites(int index, const QVector<DataArrayPath>& paths);
+
+  /**
+   * @brief resolveCreatedArrays Preflights the filters one after another against an empty DataContainerArray
+   * and adds every array a filter creates to its write set. Most filters name their created arrays with plain
+   * strings, so this is the only way to learn their full paths. Nothing is added if a preflight fails.
+   * @return false if a filter failed to preflight
+   */
+  bool resolveCreatedArrays();
+
+  /**
+   * @brief isResolved Returns true once resolveCreatedArrays() has succeeded
+   * @return
+   */
+  bool isResolved() const;
+
+  /**
+   * @brief createdArrays Returns the DataArrays that the preflight of the filter at 'index' added
+   * @param index
+   * @return
+   */
+  QVector<DataArrayPath> createdArrays(int index) const;
+
+protected:
+  void buildGraph();
+  void buildEdges();
+
+private:
+  FilterPipeline::FilterContainerType m_Filters;
+  QVector<FilterDataFootprint> m_Footprints;
+  QVector<QList<int>> m_Dependencies;
+  QVector<QList<int>> m_Dependents;
+  QVector<QList<int>> m_DataFlowSources;
+  QVector<int> m_Branches;
+  int m_BranchCount = 0;
+  QVector<QVector<DataArrayPath>> m_CreatedArrays;
+  bool m_Resolved = false;
+};
@@ -0,0 +1,1996 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineExecutor.h"
+
+#include <algorithm>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "Common/ArrayCompressionManager.h"
+#include "Common/ArrayMemoryPool.h"
+#include "Common/ArraySpillManager.h"
+#include "Common/AsyncFileWriter.h"
+#include "Common/ChunkedFileReader.h"
+#include "Common/ElementwiseFusion.h"
+#include "Common/HDF5Lock.h"
+#include "Common/IncrementalFileWriter.h"
+#include "Common/InputPrefetcher.h"
+#include "Common/MappedFileReader.h"
+#include "Common/MemoryEstimator.h"
+#include "Common/NumaTopology.h"
+#include "Common/ThreadBudget.h"
+#include "Common/TiledExecution.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineExecutor::PipelineExecutor(FilterPipeline::Pointer pipeline, QObject* parent)
+: QObject(parent)
+, m_Pipeline(pipeline)
+, m_TunedFilters(0)
+, m_ExploringFilters(0)
+, m_LiveArrayBytes(0)
+, m_NumaMovedBytes(0)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineExecutor::~PipelineExecutor() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setMaxConcurrentFilters(int count)
+{
+  m_MaxConcurrentFilters = count;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineExecutor::getMaxConcurrentFilters() const
+{
+  if(m_MaxConcurrentFilters < 1)
+  {
+    return QThread::idealThreadCount();
+  }
+  return m_MaxConcurrentFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setReleaseDeadArrays(bool release)
+{
+  m_ReleaseDeadArrays = release;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineExecutor::getReleaseDeadArrays() const
+{
+  return m_ReleaseDeadArrays;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setKeptArrayPaths(const QVector<DataArrayPath>& paths)
+{
+  m_KeptArrayPaths = paths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<DataArrayPath> PipelineExecutor::getKeptArrayPaths() const
+{
+  return m_KeptArrayPaths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setOptimizePipeline(bool optimize)
+{
+  m_OptimizePipeline = optimize;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineExecutor::getOptimizePipeline() const
+{
+  return m_OptimizePipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setFuseElementwiseFilters(bool fuse)
+{
+  m_FuseElementwiseFilters = fuse;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineExecutor::getFuseElementwiseFilters() const
+{
+  return m_FuseElementwiseFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<QVector<int>> PipelineExecutor::getFusedRuns() const
+{
+  return m_FusedRuns;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setTiledSlabThickness(int thickness)
+{
+  m_TiledSlabThickness = thickness;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineExecutor::getTiledSlabThickness() const
+{
+  return m_TiledSlabThickness;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setSeriesDatasets(const QVector<SeriesDataset>& datasets)
+{
+  m_SeriesDatasets = datasets;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<SeriesDataset> PipelineExecutor::getSeriesDatasets() const
+{
+  return m_SeriesDatasets;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setSeriesMemoryWindow(size_t bytes)
+{
+  m_SeriesMemoryWindow = bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t PipelineExecutor::getSeriesMemoryWindow() const
+{
+  return m_SeriesMemoryWindow;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<SeriesStageStats> PipelineExecutor::getSeriesStageStats() const
+{
+  return m_SeriesStageStats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setPreviewReduction(const PreviewReduction& reduction)
+{
+  m_PreviewReduction = reduction;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PreviewReduction PipelineExecutor::getPreviewReduction() const
+{
+  return m_PreviewReduction;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setSnapshotStore(const std::shared_ptr<DataSnapshotStore>& store)
+{
+  m_SnapshotStore = store;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::shared_ptr<DataSnapshotStore> PipelineExecutor::getSnapshotStore() const
+{
+  return m_SnapshotStore;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setSpillMemoryLimit(size_t bytes)
+{
+  m_SpillMemoryLimit = bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t PipelineExecutor::getSpillMemoryLimit() const
+{
+  return m_SpillMemoryLimit;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SpillStats PipelineExecutor::getSpillStats() const
+{
+  return m_SpillStats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setCompressIdleArrays(int filters)
+{
+  m_CompressIdleArrays = std::max(filters, 0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineExecutor::getCompressIdleArrays() const
+{
+  return m_CompressIdleArrays;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setCompressedArrayPaths(const QVector<DataArrayPath>& paths)
+{
+  m_CompressedArrayPaths = paths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<DataArrayPath> PipelineExecutor::getCompressedArrayPaths() const
+{
+  return m_CompressedArrayPaths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+CompressionStats PipelineExecutor::getCompressionStats() const
+{
+  return m_CompressionStats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<CompressedArrayInfo> PipelineExecutor::getCompressedArrays() const
+{
+  return m_CompressedArrays;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setArrayMapping(MappedFileReader::Mode mode)
+{
+  m_ArrayMapping = mode;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MappedFileReader::Mode PipelineExecutor::getArrayMapping() const
+{
+  return m_ArrayMapping;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setScratchDirectory(const QString& directory)
+{
+  m_ScratchDirectory = directory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineExecutor::getScratchDirectory() const
+{
+  return m_ScratchDirectory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setParallelChunkedReads(bool parallel)
+{
+  m_ParallelChunkedReads = parallel;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineExecutor::getParallelChunkedReads() const
+{
+  return m_ParallelChunkedReads;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MappingStats PipelineExecutor::getMappingStats() const
+{
+  return m_MappingStats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setAsyncWrites(bool async)
+{
+  m_AsyncWrites = async;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineExecutor::getAsyncWrites() const
+{
+  return m_AsyncWrites;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AsyncWriteStats PipelineExecutor::getAsyncWriteStats() const
+{
+  return m_AsyncWriteStats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setPrefetchDepth(int readers)
+{
+  m_PrefetchDepth = readers;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineExecutor::getPrefetchDepth() const
+{
+  return m_PrefetchDepth;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setPrefetchMemoryLimit(size_t bytes)
+{
+  m_PrefetchMemoryLimit = bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t PipelineExecutor::getPrefetchMemoryLimit() const
+{
+  return m_PrefetchMemoryLimit;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PrefetchStats PipelineExecutor::getPrefetchStats() const
+{
+  return m_PrefetchStats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setWriteProfile(WriteProfile::Preset preset)
+{
+  m_WriteProfile = preset;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WriteProfile::Preset PipelineExecutor::getWriteProfile() const
+{
+  return m_WriteProfile;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setIncrementalWrites(bool incremental)
+{
+  m_IncrementalWrites = incremental;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineExecutor::getIncrementalWrites() const
+{
+  return m_IncrementalWrites;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setThreadBudgetRequest(const ThreadBudget::Request& request)
+{
+  m_ThreadBudgetRequest = request;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::Request PipelineExecutor::getThreadBudgetRequest() const
+{
+  return m_ThreadBudgetRequest;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<OptimizationChange> PipelineExecutor::getOptimizationChanges() const
+{
+  return m_Optimizer.getChanges();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<ReleasedArray> PipelineExecutor::getReleasedArrays() const
+{
+  return m_ReleasedArrays;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t PipelineExecutor::getPeakArrayBytes() const
+{
+  return m_PeakArrayBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t PipelineExecutor::getLiveArrayBytes() const
+{
+  return m_LiveArrayBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t PipelineExecutor::getPeakArrayBytesWithoutRelease() const
+{
+  return m_PeakArrayBytesWithoutRelease;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const PipelineDataFlowGraph& PipelineExecutor::getDataFlowGraph() const
+{
+  return m_Graph;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer PipelineExecutor::getDataContainerArray() const
+{
+  return m_DataContainerArray;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineExecutor::getErrorCondition() const
+{
+  return m_ErrorCondition;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::addMessageReceiver(QObject* obj)
+{
+  connect(this, SIGNAL(pipelineGeneratedMessage(const PipelineMessage&)), obj, SLOT(processPipelineMessage(const PipelineMessage&)));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::run()
+{
+  execute();
+  emit pipelineFinished();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::cancelPipeline()
+{
+  m_Canceled = true;
+  {
+    QMutexLocker locker(&m_GraphMutex);
+    for(int i = 0; i < m_Graph.size(); i++)
+    {
+      m_Graph.filter(i)->setCancel(true);
+    }
+    for(const AbstractFilter::Pointer& copy : m_ReaderCopies)
+    {
+      copy->setCancel(true);
+    }
+  }
+
+  QMutexLocker locker(&m_SeriesMutex);
+  if(m_Series != nullptr)
+  {
+    m_Series->cancel();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setGraph(const PipelineDataFlowGraph& graph)
+{
+  QMutexLocker locker(&m_GraphMutex);
+  m_Graph = graph;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer PipelineExecutor::execute()
+{
+  m_ErrorCondition = 0;
+  m_Canceled = false;
+  m_DataContainerArray = DataContainerArray::New();
+  m_ReleasedArrays.clear();
+  m_PeakArrayBytes = 0;
+  m_PeakArrayBytesWithoutRelease = 0;
+  m_LiveArrayBytes = 0;
+  m_TunedFilters = 0;
+  m_ExploringFilters = 0;
+  m_NumaMovedBytes = 0;
+
+  ThreadBudget* budget = ThreadBudget::Instance();
+  ArrayMemoryPool* pool = ArrayMemoryPool::Instance();
+  ArrayMemoryPool::Stats poolStatsBefore = pool->getStats();
+
+  m_BudgetShare = budget->acquire(m_ThreadBudgetRequest);
+  notifyStandardOutput(QObject::tr("Using %1 of %2 threads at %3 priority, %4 pipelines running")
+                           .arg(budget->getThreads(m_BudgetShare))
+                           .arg(budget->getTotalThreads())
+                           .arg(ThreadBudget::PriorityClassName(m_ThreadBudgetRequest.priority).toLower())
+                           .arg(budget->getActiveShareCount()));
+  NumaTopology* topology = NumaTopology::Instance();
+  if(topology->getNodeCount() > 1 && m_ThreadBudgetRequest.numaNode >= 0)
+  {
+    notifyStandardOutput(QObject::tr("Running on NUMA node %1 of %2").arg(m_ThreadBudgetRequest.numaNode).arg(topology->getNodeCount()));
+  }
+  else if(topology->getNodeCount() > 1 && budget->getPinThreadsToNodes())
+  {
+    notifyStandardOutput(QObject::tr("Threads pinned across %1 NUMA nodes").arg(topology->getNodeCount()));
+  }
+
+  if(m_PreviewReduction.isEnabled())
+  {
+    notifyStandardOutput(QObject::tr("Preview execution: %1 after every reader, writers are skipped").arg(m_PreviewReduction.toString()));
+    executeGraph();
+  }
+  else if(!m_SeriesDatasets.isEmpty())
+  {
+    executeSeries();
+  }
+  else if(m_TiledSlabThickness > 0)
+  {
+    executeTiled();
+  }
+  else
+  {
+    executeGraph();
+  }
+
+  ThreadTuner* tuner = ThreadTuner::Instance();
+  if(tuner->isEnabled())
+  {
+    notifyStandardOutput(QObject::tr("Thread auto-tuning: %1 filters ran with fewer threads than available, %2 filters measured a new thread count")
+                             .arg(m_TunedFilters.load())
+                             .arg(m_ExploringFilters.load()));
+    tuner->save();
+  }
+
+  pool->collect();
+  ArrayMemoryPool::Stats poolStats = pool->getStats();
+  if(poolStats.hits + poolStats.misses > poolStatsBefore.hits + poolStatsBefore.misses)
+  {
+    notifyStandardOutput(QObject::tr("Array pool: %1 blocks reused, %2 newly mapped during this run")
+                             .arg(poolStats.hits - poolStatsBefore.hits)
+                             .arg(poolStats.misses - poolStatsBefore.misses));
+    notifyStandardOutput(pool->summary());
+  }
+
+  QStringList numaReport = topology->report(m_DataContainerArray);
+  for(const QString& line : numaReport)
+  {
+    notifyStandardOutput(line);
+  }
+  if(m_NumaMovedBytes > 0)
+  {
+    notifyStandardOutput(QObject::tr("Moved %1 of filter outputs between NUMA nodes to match the pinned threads").arg(MemoryEstimator::FormatBytes(m_NumaMovedBytes.load())));
+  }
+
+  budget->release(m_BudgetShare);
+  m_BudgetShare = -1;
+  return m_DataContainerArray;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::executeGraph()
+{
+  int err = 0;
+  {
+    QMutexLocker ioLocker(HDF5Lock::Mutex());
+    err = m_Pipeline->preflightPipeline();
+  }
+  if(err < 0)
+  {
+    m_ErrorCondition = err;
+    return;
+  }
+
+  PipelineDataFlowGraph graph(m_Pipeline);
+  bool compress = m_CompressIdleArrays > 0 || !m_CompressedArrayPaths.isEmpty();
+  if(m_OptimizePipeline || m_ReleaseDeadArrays || m_SpillMemoryLimit > 0 || compress)
+  {
+    // Arrays that filters name with plain strings are only tracked once the preflight tells us their full paths
+    QMutexLocker ioLocker(HDF5Lock::Mutex());
+    graph.resolveCreatedArrays();
+  }
+  setGraph(graph);
+  m_Optimizer = PipelineOptimizer();
+  if(m_OptimizePipeline)
+  {
+    m_Optimizer = PipelineOptimizer(m_Graph);
+    m_Optimizer.optimize();
+    setGraph(m_Optimizer.getGraph());
+
+    QStringList report = m_Optimizer.report();
+    for(const QString& line : report)
+    {
+      notifyStandardOutput(line);
+    }
+  }
+
+  int count = m_Graph.size();
+  findFusedRuns();
+  m_Liveness = m_ReleaseDeadArrays ? ArrayLivenessAnalysis(m_Graph, m_KeptArrayPaths) : ArrayLivenessAnalysis();
+  m_SpillStats = SpillStats();
+  m_SpillManager.reset(m_SpillMemoryLimit > 0 ? new ArraySpillManager(m_Graph, m_SpillMemoryLimit) : nullptr);
+  m_CompressionStats = CompressionStats();
+  m_CompressedArrays.clear();
+  m_CompressionManager.reset(compress ? new ArrayCompressionManager(m_Graph, m_CompressIdleArrays, m_CompressedArrayPaths) : nullptr);
+  m_MappingStats = MappingStats();
+  m_AsyncWriteStats = AsyncWriteStats();
+  m_AsyncWriter.reset(m_AsyncWrites && !m_PreviewReduction.isEnabled() ? new AsyncFileWriter : nullptr);
+  if(m_AsyncWriter)
+  {
+    m_AsyncWriter->setWriteProfile(m_WriteProfile);
+    m_AsyncWriter->setIncrementalWrites(m_IncrementalWrites);
+  }
+  m_PrefetchStats = PrefetchStats();
+  m_Prefetcher.reset(m_PrefetchDepth > 0 ? new InputPrefetcher(m_Graph, m_PrefetchDepth, m_PrefetchMemoryLimit) : nullptr);
+  if(m_Prefetcher)
+  {
+    m_Prefetcher->start();
+  }
+
+  // An array created inside a fused run and released before the run ends never needs to be allocated
+  for(int run = 0; run < m_FusedRuns.size(); run++)
+  {
+    const QVector<int>& members = m_FusedRuns[run];
+    for(const ElementwiseKernel::Pointer& kernel : m_FusedKernels[run])
+    {
+      DataArrayPath path = kernel->output();
+      int lastUse = m_Liveness.lastUse(path);
+      if(kernel->outputIsCreated() && members.contains(lastUse) && m_Liveness.releasedAfter(lastUse).contains(path))
+      {
+        m_FusedUnmaterialized[run].push_back(path);
+      }
+    }
+    notifyStandardOutput(QObject::tr("Fusing %1 element-wise filters [%2-%3], %4 intermediate arrays will not be allocated")
+                             .arg(members.size())
+                             .arg(members.first() + 1)
+                             .arg(members.last() + 1)
+                             .arg(m_FusedUnmaterialized[run].size()));
+  }
+
+  m_BufferedMessages.fill(QVector<PipelineMessage>(), count);
+  m_Finished.fill(false, count);
+  m_StreamingNode = 0;
+  m_CompletedNodes.clear();
+
+  QVector<int> waitingOn(count);
+  QVector<DataContainerArray::Pointer> nodeArrays(count);
+  QVector<QMetaObject::Connection> connections(count);
+  QVector<bool> started(count, false);
+  // Writers that are still writing in the background, with the structure they get once they are done
+  QVector<bool> writing(count, false);
+  QVector<DataContainerArray::Pointer> writeStructures(count);
+  QList<int> ready;
+  for(int i = 0; i < count; i++)
+  {
+    waitingOn[i] = m_Graph.dependencies(i).size();
+    if(waitingOn[i] == 0)
+    {
+      ready.push_back(i);
+    }
+  }
+  {
+    // A cancel that arrived before the graph was replaced still cancels its filters
+    QMutexLocker locker(&m_GraphMutex);
+    for(int i = 0; i < count; i++)
+    {
+      m_Graph.filter(i)->setCancel(m_Canceled);
+    }
+  }
+
+  ThreadBudget* budget = ThreadBudget::Instance();
+  QThreadPool threadPool;
+
+  bool background = (m_ThreadBudgetRequest.priority == ThreadBudget::PriorityClass::Background);
+  bool wasYielding = false;
+  int launched = 0;
+  int running = 0;
+  int finished = 0;
+  size_t releasedBytes = 0;
+  // The Data Containers a filter had checked out since the last snapshot
+  QSet<QString> snapshotTouched;
+
+  // A failed background write fails its writer, which stops the execution like any other failed filter
+  auto collectWrites = [&](bool wait) {
+    if(!m_AsyncWriter)
+    {
+      return;
+    }
+    if(wait)
+    {
+      m_AsyncWriter->wait();
+    }
+    QVector<AsyncFileWriter::Result> results = m_AsyncWriter->takeFinished();
+    for(const AsyncFileWriter::Result& result : results)
+    {
+      disconnect(connections[result.node]);
+      writing[result.node] = false;
+      if(writeStructures[result.node].get() != nullptr)
+      {
+        result.filter->setDataContainerArray(writeStructures[result.node]);
+        writeStructures[result.node] = DataContainerArray::NullPointer();
+      }
+
+      if(result.errorCondition < 0)
+      {
+        if(m_ErrorCondition >= 0)
+        {
+          m_ErrorCondition = result.errorCondition;
+        }
+        PipelineMessage error;
+        error.setFilterClassName(result.filter->getNameOfClass());
+        error.setFilterHumanLabel(result.filter->getHumanLabel());
+        error.setPipelineIndex(result.filter->getPipelineIndex());
+        error.setType(PipelineMessage::MessageType::Error);
+        error.setCode(AsyncWriteError);
+        error.setText(QObject::tr("Writing '%1' in the background failed with error %2").arg(result.outputFile).arg(result.errorCondition));
+        routeMessage(result.node, error);
+      }
+      else
+      {
+        routeNote(result.node, result.filter, QObject::tr("Wrote %1 to '%2' in the background in %3 ms").arg(MemoryEstimator::FormatBytes(result.bytes)).arg(result.outputFile).arg(result.msecs));
+        if(result.profileFailed)
+        {
+          routeWarning(result.node, result.filter, result.profileMessage, result.profileErrorCode);
+        }
+        else if(!result.profileMessage.isEmpty())
+        {
+          routeNote(result.node, result.filter, result.profileMessage);
+        }
+      }
+    }
+  };
+
+  while(finished < count)
+  {
+    // The share of the budget changes as other pipelines start and finish
+    threadPool.setMaxThreadCount(std::min(getMaxConcurrentFilters(), budget->getThreads(m_BudgetShare)));
+
+    // Background work starts no new filters while interactive work is running
+    bool yielding = background && budget->isInteractiveActive();
+    if(yielding && !wasYielding)
+    {
+      notifyStandardOutput(QObject::tr("Yielding to interactive pipelines"));
+    }
+    wasYielding = yielding;
+
+    while(!yielding && !m_Canceled && m_ErrorCondition >= 0 && !ready.isEmpty() && running < threadPool.maxThreadCount())
+    {
+      int node = ready.takeFirst();
+      int run = m_FusedRunOf[node];
+      if(started[node] || (run >= 0 && m_FusedRuns[run].first() != node))
+      {
+        // The later filters of a fused run are started together with the first one
+        continue;
+      }
+      started[node] = true;
+      AbstractFilter::Pointer filter = m_Graph.filter(node);
+      launched++;
+
+      bool previewSkipped = m_PreviewReduction.isEnabled() && ArrayLivenessAnalysis::IsWriterFilter(filter);
+      if(m_Optimizer.isEliminated(node) || previewSkipped)
+      {
+        PipelineMessage skipped;
+        skipped.setFilterClassName(filter->getNameOfClass());
+        skipped.setFilterHumanLabel(filter->getHumanLabel());
+        skipped.setPipelineIndex(filter->getPipelineIndex());
+        skipped.setType(PipelineMessage::MessageType::StatusMessage);
+        skipped.setText(QObject::tr("[%1/%2] %3 skipped %4").arg(node + 1).arg(count).arg(filter->getHumanLabel()).arg(previewSkipped ? QObject::tr("in preview") : QObject::tr("by the optimizer")));
+        routeMessage(node, skipped);
+
+        if(m_Prefetcher)
+        {
+          m_Prefetcher->markStarted(node);
+        }
+        if(m_SpillManager)
+        {
+          m_SpillManager->markStarted(node);
+        }
+        if(m_CompressionManager)
+        {
+          m_CompressionManager->markStarted(node);
+        }
+        nodeArrays[node] = DataContainerArray::New();
+        running++;
+        QMutexLocker locker(&m_CompletionMutex);
+        m_CompletedNodes.push_back(node);
+        continue;
+      }
+
+      // Barriers only become ready once nothing else is running, so they can use the whole array.
+      QVector<int> members = (run >= 0) ? m_FusedRuns[run] : QVector<int>(1, node);
+      if(run >= 0)
+      {
+        nodeArrays[node] = checkOut(members);
+      }
+      else
+      {
+        nodeArrays[node] = m_Graph.footprint(node).barrier ? m_DataContainerArray : checkOut(node);
+      }
+
+      // Arrays the filters use may have been spilled to disk or compressed while they were not needed
+      int restoreError = 0;
+      QString restoreMessage;
+      for(int member : members)
+      {
+        if(m_Prefetcher)
+        {
+          m_Prefetcher->markStarted(member);
+        }
+        if(m_SpillManager)
+        {
+          m_SpillManager->markStarted(member);
+          if(restoreError == 0 && !m_SpillManager->restore(nodeArrays[node], member))
+          {
+            restoreError = SpillError;
+            restoreMessage = m_SpillManager->getErrorMessage();
+          }
+        }
+        if(m_CompressionManager)
+        {
+          m_CompressionManager->markStarted(member);
+          if(restoreError == 0 && !m_CompressionManager->restore(nodeArrays[node], member))
+          {
+            restoreError = CompressionError;
+            restoreMessage = m_CompressionManager->getErrorMessage();
+          }
+        }
+      }
+      if(restoreError < 0)
+      {
+        for(int member : members)
+        {
+          AbstractFilter::Pointer memberFilter = m_Graph.filter(member);
+          memberFilter->setErrorCondition(restoreError);
+          PipelineMessage error;
+          error.setFilterClassName(memberFilter->getNameOfClass());
+          error.setFilterHumanLabel(memberFilter->getHumanLabel());
+          error.setPipelineIndex(memberFilter->getPipelineIndex());
+          error.setType(PipelineMessage::MessageType::Error);
+          error.setCode(restoreError);
+          error.setText(restoreMessage);
+          routeMessage(member, error);
+
+          started[member] = true;
+          running++;
+          QMutexLocker locker(&m_CompletionMutex);
+          m_CompletedNodes.push_back(member);
+        }
+        continue;
+      }
+      for(const QString& name : nodeArrays[node]->getDataContainerNames())
+      {
+        snapshotTouched.insert(name);
+      }
+
+      // Arrays a background write still holds must not change under it. Readers of other files may run
+      // alongside the write, and the HDF5Lock keeps their HDF5 calls apart from it.
+      bool async = m_AsyncWriter && run < 0 && ArrayLivenessAnalysis::IsWriterFilter(filter) && !m_Optimizer.isReused(node);
+      if(m_AsyncWriter && !async && m_AsyncWriter->isWriting())
+      {
+        if(m_Graph.footprint(node).barrier || (PreviewReduction::IsReaderFilter(filter) && m_AsyncWriter->isWritingFile(filter->property("InputFile").toString())))
+        {
+          m_AsyncWriter->wait();
+        }
+        else
+        {
+          for(int member : members)
+          {
+            m_AsyncWriter->protect(nodeArrays[node], m_Graph.footprint(member));
+          }
+        }
+      }
+
+      for(int member : members)
+      {
+        AbstractFilter::Pointer memberFilter = m_Graph.filter(member);
+        if(member != node)
+        {
+          started[member] = true;
+          launched++;
+        }
+
+        connections[member] = connect(memberFilter.get(), &AbstractFilter::filterGeneratedMessage, this, [this, member](const PipelineMessage& msg) { routeMessage(member, msg); }, Qt::DirectConnection);
+
+        PipelineMessage progValue;
+        progValue.setFilterClassName(memberFilter->getNameOfClass());
+        progValue.setFilterHumanLabel(memberFilter->getHumanLabel());
+        progValue.setPipelineIndex(memberFilter->getPipelineIndex());
+        progValue.setType(PipelineMessage::MessageType::ProgressValue);
+        progValue.setProgressValue(static_cast<int>(static_cast<float>(launched) / static_cast<float>(count) * 100.0f));
+        routeMessage(member, progValue);
+
+        progValue.setType(PipelineMessage::MessageType::StatusMessage);
+        progValue.setText(QObject::tr("[%1/%2] %3 ").arg(member + 1).arg(count).arg(memberFilter->getHumanLabel()));
+        routeMessage(member, progValue);
+
+        running++;
+      }
+
+      DataContainerArray::Pointer dca = nodeArrays[node];
+      if(async)
+      {
+        // The writer counts as finished right away, so the filters after it can start
+        m_AsyncWriter->submit(node, filter, dca);
+        writing[node] = true;
+        QMutexLocker locker(&m_CompletionMutex);
+        m_CompletedNodes.push_back(node);
+      }
+      else if(run >= 0)
+      {
+        QtConcurrent::run(&threadPool, [this, run, dca] { executeFusedRun(run, dca); });
+      }
+      else
+      {
+        QtConcurrent::run(&threadPool, [this, node, dca] { executeNode(node, dca); });
+      }
+    }
+
+    if(running == 0)
+    {
+      if(yielding && !m_Canceled && m_ErrorCondition >= 0)
+      {
+        budget->waitForInteractive(250);
+        continue;
+      }
+      // Either an error occurred or the pipeline was canceled
+      break;
+    }
+
+    QVector<int> completed;
+    {
+      QMutexLocker locker(&m_CompletionMutex);
+      while(m_CompletedNodes.isEmpty())
+      {
+        m_CompletionCondition.wait(&m_CompletionMutex);
+      }
+      completed.swap(m_CompletedNodes);
+    }
+
+    for(int node : completed)
+    {
+      running--;
+      finished++;
+
+      AbstractFilter::Pointer filter = m_Graph.filter(node);
+      if(!writing[node])
+      {
+        disconnect(connections[node]);
+      }
+
+      // The later filters of a fused run share the array of the first one
+      if(!m_Graph.footprint(node).barrier && nodeArrays[node].get() != nullptr)
+      {
+        checkIn(nodeArrays[node]);
+      }
+      nodeArrays[node] = DataContainerArray::NullPointer();
+
+      if(!writing[node] && filter->getErrorCondition() < 0 && m_ErrorCondition >= 0)
+      {
+        m_ErrorCondition = filter->getErrorCondition();
+      }
+
+      // Give the filter a structural copy so the Data Structure browser can show the state after this filter
+      DataContainerArray::Pointer structure = m_DataContainerArray->deepCopy(true);
+      if(m_SpillManager)
+      {
+        m_SpillManager->addSpilledStructure(structure);
+      }
+      if(m_CompressionManager)
+      {
+        m_CompressionManager->addCompressedStructure(structure);
+      }
+      if(writing[node])
+      {
+        writeStructures[node] = structure;
+      }
+      else
+      {
+        filter->setDataContainerArray(structure);
+      }
+
+      if(m_SnapshotStore.get() != nullptr)
+      {
+        m_SnapshotStore->take(m_DataContainerArray, filter->getHumanLabel(), &snapshotTouched);
+        // Containers that are still checked out can change before the next snapshot
+        snapshotTouched.clear();
+        for(int i = 0; i < count; i++)
+        {
+          if(nodeArrays[i].get() != nullptr)
+          {
+            for(const QString& name : nodeArrays[i]->getDataContainerNames())
+            {
+              snapshotTouched.insert(name);
+            }
+          }
+        }
+      }
+
+      if(m_ReleaseDeadArrays)
+      {
+        releasedBytes += releaseDeadArrays(node);
+      }
+      // Blocks of arrays released or replaced by this filter can serve the next one
+      ArrayMemoryPool::Instance()->collect();
+
+      // Arrays of running filters are checked out of the pipeline's array, so count those as well
+      size_t liveBytes = ArrayLivenessAnalysis::TotalArrayBytes(m_DataContainerArray);
+      for(int i = 0; i < count; i++)
+      {
+        if(nodeArrays[i].get() != nullptr && nodeArrays[i] != m_DataContainerArray)
+        {
+          liveBytes += ArrayLivenessAnalysis::TotalArrayBytes(nodeArrays[i]);
+        }
+      }
+      m_LiveArrayBytes = liveBytes;
+      m_PeakArrayBytes = std::max(m_PeakArrayBytes, liveBytes);
+      m_PeakArrayBytesWithoutRelease = std::max(m_PeakArrayBytesWithoutRelease, liveBytes + releasedBytes);
+
+      // Idle arrays are compressed first, so only what still does not fit is spilled
+      if(m_SpillManager || m_CompressionManager)
+      {
+        size_t checkedOutBytes = liveBytes - ArrayLivenessAnalysis::TotalArrayBytes(m_DataContainerArray);
+        size_t compressedBytes = 0;
+        if(m_CompressionManager)
+        {
+          m_CompressionManager->compressIdle(m_DataContainerArray, node);
+          compressedBytes = m_CompressionManager->getStoredBytes();
+        }
+        if(m_SpillManager)
+        {
+          m_SpillManager->relieve(m_DataContainerArray, checkedOutBytes + compressedBytes);
+        }
+        m_LiveArrayBytes = ArrayLivenessAnalysis::TotalArrayBytes(m_DataContainerArray) + checkedOutBytes + compressedBytes;
+      }
+
+      QList<int> dependents = m_Graph.dependents(node);
+      for(int dependent : dependents)
+      {
+        waitingOn[dependent]--;
+        if(waitingOn[dependent] == 0)
+        {
+          // Keep the ready list sorted so filters start in pipeline order whenever possible
+          QList<int>::iterator iter = std::lower_bound(ready.begin(), ready.end(), dependent);
+          ready.insert(iter, dependent);
+        }
+      }
+
+      nodeFinished(node);
+    }
+
+    collectWrites(false);
+  }
+
+  // The execution is only complete once everything is on disk
+  collectWrites(true);
+  if(m_Prefetcher)
+  {
+    m_Prefetcher->stop();
+  }
+
+  // Anything that is still buffered belongs to filters after a failed or canceled one
+  {
+    QMutexLocker locker(&m_MessageMutex);
+    for(int i = m_StreamingNode; i < count; i++)
+    {
+      for(const PipelineMessage& msg : m_BufferedMessages[i])
+      {
+        emit pipelineGeneratedMessage(msg);
+      }
+      m_BufferedMessages[i].clear();
+    }
+    m_StreamingNode = count;
+  }
+
+  // Arrays still on disk or compressed when the run ends go away with their manager
+  if(m_SpillManager)
+  {
+    m_SpillStats = m_SpillManager->getStats();
+    if(m_SpillStats.spilledArrays > 0)
+    {
+      QStringList report = m_SpillManager->report();
+      for(const QString& line : report)
+      {
+        notifyStandardOutput(line);
+      }
+    }
+    m_SpillManager.reset();
+  }
+  if(m_CompressionManager)
+  {
+    m_CompressionStats = m_CompressionManager->getStats();
+    m_CompressedArrays = m_CompressionManager->getCompressedArrays();
+    if(m_CompressionStats.compressedArrays > 0)
+    {
+      QStringList report = m_CompressionManager->report();
+      for(const QString& line : report)
+      {
+        notifyStandardOutput(line);
+      }
+    }
+    m_CompressionManager.reset();
+  }
+  if(m_MappingStats.mappedArrays > 0 || m_MappingStats.scratchArrays > 0)
+  {
+    QStringList report = MappedFileReader::Report(m_MappingStats);
+    for(const QString& line : report)
+    {
+      notifyStandardOutput(line);
+    }
+  }
+  if(m_AsyncWriter)
+  {
+    m_AsyncWriteStats = m_AsyncWriter->getStats();
+    if(m_AsyncWriteStats.writes > 0)
+    {
+      QStringList report = m_AsyncWriter->report();
+      for(const QString& line : report)
+      {
+        notifyStandardOutput(line);
+      }
+    }
+    m_AsyncWriter.reset();
+  }
+  if(m_Prefetcher)
+  {
+    m_PrefetchStats = m_Prefetcher->getStats();
+    if(m_PrefetchStats.files > 0)
+    {
+      QStringList report = m_Prefetcher->report();
+      for(const QString& line : report)
+      {
+        notifyStandardOutput(line);
+      }
+    }
+    m_Prefetcher.reset();
+  }
+
+  if(m_ErrorCondition >= 0 && !m_Canceled)
+  {
+    PipelineMessage progValue;
+    progValue.setType(PipelineMessage::MessageType::ProgressValue);
+    progValue.setProgressValue(100);
+    emit pipelineGeneratedMessage(progValue);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::executeTiled()
+{
+  // The graph holds every enabled filter, which is what cancelPipeline() cancels
+  setGraph(PipelineDataFlowGraph(m_Pipeline));
+  m_Optimizer = PipelineOptimizer();
+  m_FusedRuns.clear();
+  {
+    // A cancel that arrived before the graph was replaced still cancels its filters
+    QMutexLocker locker(&m_GraphMutex);
+    for(int i = 0; i < m_Graph.size(); i++)
+    {
+      m_Graph.filter(i)->setCancel(m_Canceled);
+    }
+  }
+
+  TiledExecution tiled(m_Pipeline);
+  tiled.setSlabThickness(static_cast<size_t>(m_TiledSlabThickness));
+  tiled.setWriteProfile(m_WriteProfile);
+  tiled.setMessageHandler([this](const PipelineMessage& msg) { emit pipelineGeneratedMessage(msg); });
+  ThreadBudget::Instance()->execute(m_BudgetShare, [this, &tiled] { m_ErrorCondition = tiled.execute(); });
+
+  if(m_ErrorCondition >= 0 && !m_Canceled)
+  {
+    PipelineMessage progValue;
+    progValue.setType(PipelineMessage::MessageType::ProgressValue);
+    progValue.setProgressValue(100);
+    emit pipelineGeneratedMessage(progValue);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::executeSeries()
+{
+  setGraph(PipelineDataFlowGraph());
+  m_Optimizer = PipelineOptimizer();
+  m_FusedRuns.clear();
+
+  SeriesExecution series(m_Pipeline);
+  series.setDatasets(m_SeriesDatasets);
+  series.setMemoryWindow(m_SeriesMemoryWindow);
+  series.setWriteProfile(m_WriteProfile);
+  series.setIncrementalWrites(m_IncrementalWrites);
+  series.setMessageHandler([this](const PipelineMessage& msg) { emit pipelineGeneratedMessage(msg); });
+  series.setResidentBytesHandler([this](size_t bytes) {
+    m_LiveArrayBytes = bytes;
+    m_PeakArrayBytes = std::max(m_PeakArrayBytes, bytes);
+  });
+  // Every stage thread runs its filters inside this execution's share of the budget. Background series
+  // hold back each filter while interactive work is running.
+  bool background = (m_ThreadBudgetRequest.priority == ThreadBudget::PriorityClass::Background);
+  series.setFilterWrapper([this, background](const std::function<void()>& func) {
+    ThreadBudget* budget = ThreadBudget::Instance();
+    while(background && !m_Canceled && !budget->waitForInteractive(250))
+    {
+    }
+    budget->execute(m_BudgetShare, func);
+  });
+
+  {
+    QMutexLocker locker(&m_SeriesMutex);
+    m_Series = &series;
+  }
+  if(!m_Canceled)
+  {
+    m_ErrorCondition = series.execute();
+  }
+  {
+    QMutexLocker locker(&m_SeriesMutex);
+    m_Series = nullptr;
+  }
+  m_SeriesStageStats = series.getStageStats();
+  m_PeakArrayBytesWithoutRelease = m_PeakArrayBytes;
+
+  if(m_ErrorCondition >= 0 && !m_Canceled)
+  {
+    PipelineMessage progValue;
+    progValue.setType(PipelineMessage::MessageType::ProgressValue);
+    progValue.setProgressValue(100);
+    emit pipelineGeneratedMessage(progValue);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer PipelineExecutor::checkOut(int node)
+{
+  DataContainerArray::Pointer dca = DataContainerArray::New();
+  for(const QString& name : m_Graph.footprint(node).dataContainers)
+  {
+    if(m_DataContainerArray->doesDataContainerExist(name))
+    {
+      dca->addDataContainer(m_DataContainerArray->removeDataContainer(name));
+    }
+  }
+  return dca;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer PipelineExecutor::checkOut(const QVector<int>& nodes)
+{
+  DataContainerArray::Pointer dca = DataContainerArray::New();
+  for(int node : nodes)
+  {
+    for(const QString& name : m_Graph.footprint(node).dataContainers)
+    {
+      if(m_DataContainerArray->doesDataContainerExist(name))
+      {
+        dca->addDataContainer(m_DataContainerArray->removeDataContainer(name));
+      }
+    }
+  }
+  return dca;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::checkIn(const DataContainerArray::Pointer& dca)
+{
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& container : containers)
+  {
+    m_DataContainerArray->addDataContainer(container);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t PipelineExecutor::releaseDeadArrays(int node)
+{
+  size_t bytes = 0;
+  QVector<DataArrayPath> paths = m_Liveness.releasedAfter(node);
+  for(const DataArrayPath& path : paths)
+  {
+    // Every filter touching this container is ordered against 'node', so it is checked in by now
+    AttributeMatrix::Pointer am = m_DataContainerArray->getAttributeMatrix(path);
+    if(am.get() == nullptr || !am->doesAttributeArrayExist(path.getDataArrayName()))
+    {
+      // A dead array that was spilled or compressed only has to be dropped from there
+      if(m_SpillManager)
+      {
+        m_SpillManager->forget(path);
+      }
+      if(m_CompressionManager)
+      {
+        m_CompressionManager->forget(path);
+      }
+      continue;
+    }
+
+    ReleasedArray released;
+    released.path = path;
+    released.filterHumanLabel = m_Graph.filter(node)->getHumanLabel();
+    released.node = node;
+    released.bytes = ArrayLivenessAnalysis::ArrayBytes(m_DataContainerArray, path);
+    am->removeAttributeArray(path.getDataArrayName());
+
+    bytes += released.bytes;
+    m_ReleasedArrays.push_back(released);
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineExecutor::copyReusedOutputs(int node, const DataContainerArray::Pointer& dca)
+{
+  PipelineOptimizer::AliasList aliases = m_Optimizer.aliases(node);
+
+  // Validate everything first so a filter is either fully reused or executed normally
+  QVector<IDataArray::Pointer> sources;
+  QVector<AttributeMatrix::Pointer> targets;
+  for(const QPair<DataArrayPath, DataArrayPath>& alias : aliases)
+  {
+    AttributeMatrix::Pointer sourceAm = dca->getAttributeMatrix(alias.first);
+    AttributeMatrix::Pointer targetAm = dca->getAttributeMatrix(alias.second);
+    if(sourceAm.get() == nullptr || targetAm.get() == nullptr)
+    {
+      return false;
+    }
+    IDataArray::Pointer source = sourceAm->getAttributeArray(alias.first.getDataArrayName());
+    if(source.get() == nullptr || source->getNumberOfTuples() != targetAm->getNumberOfTuples())
+    {
+      return false;
+    }
+    sources.push_back(source);
+    targets.push_back(targetAm);
+  }
+
+  for(int i = 0; i < aliases.size(); i++)
+  {
+    QString name = aliases[i].second.getDataArrayName();
+    IDataArray::Pointer copy = sources[i]->deepCopy();
+    copy->setName(name);
+    targets[i]->addAttributeArray(name, copy);
+  }
+
+  AbstractFilter::Pointer filter = m_Graph.filter(node);
+  PipelineMessage msg;
+  msg.setFilterClassName(filter->getNameOfClass());
+  msg.setFilterHumanLabel(filter->getHumanLabel());
+  msg.setPipelineIndex(filter->getPipelineIndex());
+  msg.setType(PipelineMessage::MessageType::StatusMessage);
+  msg.setText(QObject::tr("Reused the outputs of [%1] %2").arg(m_Optimizer.reuseSource(node) + 1).arg(m_Graph.filter(m_Optimizer.reuseSource(node))->getHumanLabel()));
+  routeMessage(node, msg);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::notifyStandardOutput(const QString& text)
+{
+  PipelineMessage msg;
+  msg.setType(PipelineMessage::MessageType::StandardOutputMessage);
+  msg.setText(text);
+  emit pipelineGeneratedMessage(msg);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::executeNode(int node, DataContainerArray::Pointer dca)
+{
+  AbstractFilter::Pointer filter = m_Graph.filter(node);
+  filter->setDataContainerArray(dca);
+  filter->setErrorCondition(0);
+  filter->setWarningCondition(0);
+  if(!m_Canceled && !(m_Optimizer.isReused(node) && copyReusedOutputs(node, dca)))
+  {
+    // Readers and writers stay inside HDF5 from preparing their files until they are finished with them
+    bool io = PreviewReduction::IsReaderFilter(filter) || ArrayLivenessAnalysis::IsWriterFilter(filter);
+    QMutexLocker ioLocker(io ? HDF5Lock::Mutex() : nullptr);
+
+    // A reader that runs as a barrier sees the containers of earlier readers, which are already reduced
+    bool previewReader = m_PreviewReduction.isEnabled() && PreviewReduction::IsReaderFilter(filter);
+    std::unique_ptr<MappedFileReader> mapping;
+    if(m_ArrayMapping != MappedFileReader::Mode::Off && !m_PreviewReduction.isEnabled() && PreviewReduction::IsReaderFilter(filter))
+    {
+      mapping.reset(new MappedFileReader(m_ArrayMapping, m_ScratchDirectory));
+    }
+    std::unique_ptr<ChunkedFileReader> chunked;
+    if(m_ParallelChunkedReads && PreviewReduction::IsReaderFilter(filter))
+    {
+      chunked.reset(new ChunkedFileReader());
+    }
+
+    // The mapping and the chunked reads unselect datasets of the reader. They do that to a copy, so the
+    // selection of the reader in the pipeline, which the user edits, is never changed from this thread.
+    AbstractFilter::Pointer runner = filter;
+    QMetaObject::Connection runnerConnection;
+    if(mapping || chunked)
+    {
+      runner = filter->newFilterInstance(true);
+      runner->setDataContainerArray(dca);
+      runner->setPipelineIndex(filter->getPipelineIndex());
+      runnerConnection = connect(runner.get(), &AbstractFilter::filterGeneratedMessage, this, [this, node](const PipelineMessage& msg) { routeMessage(node, msg); }, Qt::DirectConnection);
+      QMutexLocker locker(&m_GraphMutex);
+      m_ReaderCopies.insert(node, runner);
+      runner->setCancel(m_Canceled);
+    }
+    QStringList existingContainers;
+    if(previewReader || mapping)
+    {
+      existingContainers = dca->getDataContainerNames();
+    }
+    if(mapping)
+    {
+      // An array a later filter writes must not write through to the input file. Filters that change a
+      // required array in place only list it as read, so every array a later filter touches counts.
+      auto touchedLater = [this, node](const DataArrayPath& path) {
+        for(int i = node + 1; i < m_Graph.size(); i++)
+        {
+          const FilterDataFootprint& footprint = m_Graph.footprint(i);
+          if(footprint.barrier)
+          {
+            return true;
+          }
+          for(const QVector<DataArrayPath>* paths : {&footprint.reads, &footprint.writes})
+          {
+            for(const DataArrayPath& touched : *paths)
+            {
+              if(PipelineDataFlowGraph::PathsOverlap(touched, path))
+              {
+                return true;
+              }
+            }
+          }
+        }
+        return false;
+      };
+      if(!mapping->prepare(runner, touchedLater))
+      {
+        routeNote(node, filter, mapping->getErrorMessage());
+        mapping.reset();
+      }
+    }
+
+    // Runs after the mapping, which takes the contiguous datasets, and takes the compressed chunked ones
+    if(chunked && !chunked->prepare(runner))
+    {
+      routeNote(node, filter, chunked->getErrorMessage());
+      chunked.reset();
+    }
+
+    std::unique_ptr<IncrementalFileWriter> output;
+    if(ArrayLivenessAnalysis::IsWriterFilter(filter))
+    {
+      output.reset(new IncrementalFileWriter(filter, WriteProfile::ForWriter(filter, m_WriteProfile), m_IncrementalWrites));
+      output->stage();
+    }
+
+    ThreadBudget* budget = ThreadBudget::Instance();
+    ThreadTuner* tuner = ThreadTuner::Instance();
+    if(tuner->isEnabled())
+    {
+      QString className = filter->getNameOfClass();
+      size_t inputBytes = ArrayLivenessAnalysis::TotalArrayBytes(dca);
+      int available = budget->getThreads(m_BudgetShare);
+      int threads = tuner->select(className, inputBytes, available);
+      if(tuner->isExploring(className, inputBytes, available))
+      {
+        m_ExploringFilters++;
+      }
+      else if(threads < available)
+      {
+        m_TunedFilters++;
+      }
+
+      QElapsedTimer timer;
+      timer.start();
+      budget->execute(m_BudgetShare, threads, [&runner] { runner->execute(); });
+      if(runner->getErrorCondition() >= 0 && !m_Canceled)
+      {
+        tuner->record(className, inputBytes, threads, timer.elapsed());
+      }
+    }
+    else
+    {
+      budget->execute(m_BudgetShare, [&runner] { runner->execute(); });
+    }
+    if(runner != filter)
+    {
+      filter->setErrorCondition(runner->getErrorCondition());
+      filter->setWarningCondition(runner->getWarningCondition());
+    }
+
+    if(chunked)
+    {
+      if(!chunked->finish(runner, dca) && filter->getErrorCondition() >= 0)
+      {
+        filter->setErrorCondition(ChunkedReadError);
+        PipelineMessage msg;
+        msg.setFilterClassName(filter->getNameOfClass());
+        msg.setFilterHumanLabel(filter->getHumanLabel());
+        msg.setPipelineIndex(filter->getPipelineIndex());
+        msg.setType(PipelineMessage::MessageType::Error);
+        msg.setCode(ChunkedReadError);
+        msg.setText(chunked->getErrorMessage());
+        routeMessage(node, msg);
+      }
+      else if(chunked->getReadArrays() > 0)
+      {
+        routeNote(node, filter, QObject::tr("Decompressed %1 chunked arrays (%2) on the thread pool").arg(chunked->getReadArrays()).arg(MemoryEstimator::FormatBytes(chunked->getReadBytes())));
+      }
+    }
+    if(filter->getErrorCondition() >= 0 && !m_Canceled)
+    {
+      distributeWrites(node, dca);
+    }
+    if(output)
+    {
+      QString message;
+      if(!output->finish(filter->getErrorCondition() >= 0 && !m_Canceled, &message))
+      {
+        routeWarning(node, filter, message, output->getErrorCode());
+      }
+      else if(!message.isEmpty())
+      {
+        routeNote(node, filter, message);
+      }
+    }
+
+    QStringList readContainers;
+    if(previewReader || mapping)
+    {
+      readContainers = dca->getDataContainerNames();
+    }
+    for(const QString& name : existingContainers)
+    {
+      readContainers.removeAll(name);
+    }
+    if(mapping)
+    {
+      if(!mapping->finish(runner, dca, readContainers) && filter->getErrorCondition() >= 0)
+      {
+        filter->setErrorCondition(MappingError);
+        PipelineMessage msg;
+        msg.setFilterClassName(filter->getNameOfClass());
+        msg.setFilterHumanLabel(filter->getHumanLabel());
+        msg.setPipelineIndex(filter->getPipelineIndex());
+        msg.setType(PipelineMessage::MessageType::Error);
+        msg.setCode(MappingError);
+        msg.setText(mapping->getErrorMessage());
+        routeMessage(node, msg);
+      }
+      QStringList notes = mapping->getNotes();
+      for(const QString& note : notes)
+      {
+        routeNote(node, filter, note);
+      }
+      MappingStats stats = mapping->getStats();
+      QMutexLocker locker(&m_CompletionMutex);
+      m_MappingStats.mappedArrays += stats.mappedArrays;
+      m_MappingStats.mappedBytes += stats.mappedBytes;
+      m_MappingStats.copyOnWriteArrays += stats.copyOnWriteArrays;
+      m_MappingStats.scratchArrays += stats.scratchArrays;
+      m_MappingStats.scratchBytes += stats.scratchBytes;
+      m_MappingStats.fallbackArrays += stats.fallbackArrays;
+      m_MappingStats.fallbackBytes += stats.fallbackBytes;
+    }
+    if(runner != filter)
+    {
+      disconnect(runnerConnection);
+      QMutexLocker locker(&m_GraphMutex);
+      m_ReaderCopies.remove(node);
+    }
+    if(!previewReader)
+    {
+      readContainers.clear();
+    }
+    if(!readContainers.isEmpty() && filter->getErrorCondition() >= 0 && !m_Canceled)
+    {
+      QStringList notes;
+      m_PreviewReduction.reduce(dca, readContainers, &notes);
+      for(const QString& note : notes)
+      {
+        routeNote(node, filter, QObject::tr("Preview: %1").arg(note));
+      }
+    }
+  }
+
+  QMutexLocker locker(&m_CompletionMutex);
+  m_CompletedNodes.push_back(node);
+  m_CompletionCondition.wakeAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::distributeWrites(int node, const DataContainerArray::Pointer& dca)
+{
+  NumaTopology* topology = NumaTopology::Instance();
+  if(topology->getNodeCount() < 2 || !ThreadBudget::Instance()->getPinThreadsToNodes() || m_ThreadBudgetRequest.numaNode >= 0)
+  {
+    return;
+  }
+
+  // Filters allocate their outputs with a single thread, so all of their pages sit on that thread's node
+  const FilterDataFootprint& footprint = m_Graph.footprint(node);
+  ArrayMemoryPool* pool = ArrayMemoryPool::Instance();
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        DataArrayPath path(dc->getName(), am->getName(), name);
+        bool written = footprint.barrier;
+        for(int i = 0; i < footprint.writes.size() && !written; i++)
+        {
+          written = PipelineDataFlowGraph::PathsOverlap(footprint.writes[i], path);
+        }
+        IDataArray::Pointer array = am->getAttributeArray(name);
+        size_t bytes = array->getSize() * array->getTypeSize();
+        if(!written || bytes < ArrayMemoryPool::MinimumPooledBytes || array->getVoidPointer(0) == nullptr || pool->isFileBacked(array))
+        {
+          continue;
+        }
+        m_NumaMovedBytes += topology->distribute(array->getVoidPointer(0), bytes);
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::findFusedRuns()
+{
+  int count = m_Graph.size();
+  m_FusedRuns.clear();
+  m_FusedKernels.clear();
+  m_FusedUnmaterialized.clear();
+  m_FusedRunOf.fill(-1, count);
+  if(!m_FuseElementwiseFilters)
+  {
+    return;
+  }
+
+  QVector<ElementwiseKernel::Pointer> kernels(count);
+  for(int i = 0; i < count; i++)
+  {
+    AbstractFilter::Pointer filter = m_Graph.filter(i);
+    if(m_Graph.footprint(i).barrier || m_Optimizer.isEliminated(i) || m_Optimizer.isReused(i) || PipelineOptimizer::GetHasSideEffects(filter))
+    {
+      continue;
+    }
+    kernels[i] = ElementwiseKernel::ForFilter(filter);
+
+    // Outputs named by a plain string are not in the footprint yet, record them for the liveness analysis
+    if(kernels[i].get() != nullptr && !m_Graph.footprint(i).writes.contains(kernels[i]->output()))
+    {
+      m_Graph.addWrites(i, QVector<DataArrayPath>(1, kernels[i]->output()));
+    }
+  }
+
+  QVector<int> current;
+  for(int i = 0; i <= count; i++)
+  {
+    bool joins = (i < count && kernels[i].get() != nullptr);
+    if(joins && !current.isEmpty())
+    {
+      QList<int> startDependencies = m_Graph.dependencies(current.first());
+      QList<int> dependencies = m_Graph.dependencies(i);
+      for(int dependency : dependencies)
+      {
+        if(!current.contains(dependency) && !startDependencies.contains(dependency))
+        {
+          joins = false;
+        }
+      }
+    }
+
+    if(!joins || i == count)
+    {
+      if(current.size() > 1)
+      {
+        QVector<ElementwiseKernel::Pointer> runKernels;
+        for(int member : current)
+        {
+          runKernels.push_back(kernels[member]);
+          m_FusedRunOf[member] = m_FusedRuns.size();
+        }
+        m_FusedRuns.push_back(current);
+        m_FusedKernels.push_back(runKernels);
+        m_FusedUnmaterialized.push_back(QVector<DataArrayPath>());
+      }
+      current.clear();
+    }
+
+    if(i < count && kernels[i].get() != nullptr)
+    {
+      current.push_back(i);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::executeFusedRun(int run, DataContainerArray::Pointer dca)
+{
+  const QVector<int>& members = m_FusedRuns[run];
+  for(int member : members)
+  {
+    AbstractFilter::Pointer filter = m_Graph.filter(member);
+    filter->setDataContainerArray(dca);
+    filter->setErrorCondition(0);
+    filter->setWarningCondition(0);
+  }
+
+  if(!m_Canceled)
+  {
+    ThreadBudget::Instance()->execute(m_BudgetShare, [this, run, &dca] { executeFusedMembers(run, dca); });
+  }
+
+  QMutexLocker locker(&m_CompletionMutex);
+  for(int member : members)
+  {
+    m_CompletedNodes.push_back(member);
+  }
+  m_CompletionCondition.wakeAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::executeFusedMembers(int run, const DataContainerArray::Pointer& dca)
+{
+  const QVector<int>& members = m_FusedRuns[run];
+  ElementwiseFusion fusion(m_FusedKernels[run], m_FusedUnmaterialized[run]);
+  if(fusion.execute(dca))
+  {
+    for(int member : members)
+    {
+      AbstractFilter::Pointer filter = m_Graph.filter(member);
+      PipelineMessage msg;
+      msg.setFilterClassName(filter->getNameOfClass());
+      msg.setFilterHumanLabel(filter->getHumanLabel());
+      msg.setPipelineIndex(filter->getPipelineIndex());
+      msg.setType(PipelineMessage::MessageType::StatusMessage);
+      msg.setText(QObject::tr("Fused with filters [%1-%2] over %3 elements").arg(members.first() + 1).arg(members.last() + 1).arg(fusion.getElementCount()));
+      routeMessage(member, msg);
+    }
+    return;
+  }
+
+  notifyStandardOutput(QObject::tr("Filters [%1-%2] were not fused: %3").arg(members.first() + 1).arg(members.last() + 1).arg(fusion.getErrorMessage()));
+  for(int member : members)
+  {
+    AbstractFilter::Pointer filter = m_Graph.filter(member);
+    if(m_Canceled)
+    {
+      break;
+    }
+    filter->execute();
+    if(filter->getErrorCondition() < 0)
+    {
+      break;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::routeMessage(int node, const PipelineMessage& msg)
+{
+  QMutexLocker locker(&m_MessageMutex);
+  // Only a writer that is still writing in the background generates messages after it finished
+  if(node <= m_StreamingNode)
+  {
+    emit pipelineGeneratedMessage(msg);
+  }
+  else
+  {
+    m_BufferedMessages[node].push_back(msg);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::routeNote(int node, const AbstractFilter::Pointer& filter, const QString& text)
+{
+  PipelineMessage msg;
+  msg.setFilterClassName(filter->getNameOfClass());
+  msg.setFilterHumanLabel(filter->getHumanLabel());
+  msg.setPipelineIndex(filter->getPipelineIndex());
+  msg.setType(PipelineMessage::MessageType::StandardOutputMessage);
+  msg.setText(text);
+  routeMessage(node, msg);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::routeWarning(int node, const AbstractFilter::Pointer& filter, const QString& text, int code)
+{
+  PipelineMessage msg;
+  msg.setFilterClassName(filter->getNameOfClass());
+  msg.setFilterHumanLabel(filter->getHumanLabel());
+  msg.setPipelineIndex(filter->getPipelineIndex());
+  msg.setType(PipelineMessage::MessageType::Warning);
+  msg.setCode(code);
+  msg.setText(text);
+  routeMessage(node, msg);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::nodeFinished(int node)
+{
+  QMutexLocker locker(&m_MessageMutex);
+  m_Finished[node] = true;
+  int count = m_Finished.size();
+  while(m_StreamingNode < count && m_Finished[m_StreamingNode])
+  {
+    m_StreamingNode++;
+    if(m_StreamingNode < count)
+    {
+      for(const PipelineMessage& msg : m_BufferedMessages[m_StreamingNode])
+      {
+        emit pipelineGeneratedMessage(msg);
+      }
+      m_BufferedMessages[m_StreamingNode].clear();
+    }
+  }
+}
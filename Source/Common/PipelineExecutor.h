@@ -0,0 +1,664 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#include "SIMPLib/Common/PipelineMessage.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "Common/ArrayCompressionManager.h"
+#include "Common/ArrayLivenessAnalysis.h"
+#include "Common/ArraySpillManager.h"
+#include "Common/AsyncFileWriter.h"
+#include "Common/DataSnapshotStore.h"
+#include "Common/ElementwiseKernel.h"
+#include "Common/InputPrefetcher.h"
+#include "Common/MappedFileReader.h"
+#include "Common/PipelineDataFlowGraph.h"
+#include "Common/PipelineOptimizer.h"
+#include "Common/PreviewReduction.h"
+#include "Common/SeriesExecution.h"
+#include "Common/ThreadBudget.h"
+#include "Common/ThreadTuner.h"
+#include "Common/WriteProfile.h"
+
+/**
+ * @brief The ReleasedArray struct records a DataArray that was released after its last use
+ */
+struct ReleasedArray
+{
+  DataArrayPath path;
+  QString filterHumanLabel;
+  int node = -1;
+  size_t bytes = 0;
+};
+
+/**
+ * @brief The PipelineExecutor class executes a FilterPipeline the same way FilterPipeline::execute()
+ * does, except that filters on independent branches of the PipelineDataFlowGraph are run at
+ * the same time on a thread pool.
+ *
+ * Each running filter is handed a private DataContainerArray that holds only the DataContainers it
+ * touches. Those containers are checked out of the pipeline's DataContainerArray before the filter
+ * starts and checked back in when it finishes, so two running filters never share a container.
+ * Barrier filters run alone against the full DataContainerArray.
+ *
+ * Messages of a filter are always delivered in the order the filter generated them. Messages of
+ * different filters are delivered in pipeline order: the earliest unfinished filter streams its
+ * messages live while later filters buffer theirs until every filter before them has finished.
+ *
+ * When fusion is enabled, consecutive filters that have an ElementwiseKernel are run as a single
+ * ElementwiseFusion loop. Arrays created inside such a run that the ArrayLivenessAnalysis would release
+ * before the run ends are never allocated.
+ *
+ * Every execution holds a share of the process-wide ThreadBudget for as long as it runs. A background
+ * execution starts no new filter while an interactive one is running. While the ThreadTuner is enabled,
+ * each filter runs with the number of threads the tuner picks for its class and input size, and its wall
+ * time is recorded for future runs.
+ *
+ * When series datasets are set, the pipeline is executed once per dataset with SeriesExecution instead.
+ *
+ * A preview execution applies a PreviewReduction to the output of every reader and skips every writer,
+ * so nothing a full run produces is overwritten by reduced data.
+ *
+ * With a DataSnapshotStore set, a snapshot of the DataContainerArray is taken after every filter of the
+ * graph. Only the Data Containers checked out since the previous snapshot are compared for changes.
+ *
+ * Arrays the executor allocates itself come from the ArrayMemoryPool, which keeps their storage for the
+ * next run. The run report includes the hits and misses of the pool.
+ *
+ * With a spill memory limit set, an ArraySpillManager writes cold arrays to a temporary file whenever the
+ * arrays exceed the limit after a filter, and reads them back before a filter that uses them starts.
+ * Idle and flagged arrays are compressed by an ArrayCompressionManager first, in the same way.
+ *
+ * With array mapping on, a MappedFileReader maps the contiguous datasets of every .dream3d file a reader
+ * opens instead of reading them, and moves what the readers do read into scratch files, so the arrays of
+ * very large inputs are paged in and out by the operating system. Arrays that are mapped or in scratch
+ * files are never spilled or compressed. With parallel chunked reads on, a ChunkedFileReader reads the
+ * shuffle and deflate chunked datasets of those files itself, decompressing their chunks on the thread pool,
+ * whether mapping is on or not. Both reduce the selection of a copy of the reader, never of the reader in
+ * the pipeline.
+ *
+ * While the ThreadBudget pins threads to NUMA nodes, the pages of every array a filter writes are spread
+ * over the nodes after the filter, in the slices the pinned threads of later parallel loops work on. The
+ * run report ends with the memory of every node.
+ *
+ * With asynchronous writes on, every writer filter runs on the I/O thread of an AsyncFileWriter against the
+ * arrays as they are when it starts, and the filters after it start right away. A failed write stops the
+ * execution like any other failed filter, and every write has finished before the execution returns.
+ *
+ * With a prefetch depth set, an InputPrefetcher reads the input files of the next readers into the page
+ * cache while the filters before them execute.
+ *
+ * Every HDF5 file a writer produces is rewritten with its WriteProfile, or with the global one when the
+ * writer has none. A rewrite that fails leaves the file as the writer wrote it and only warns.
+ *
+ * With incremental writes on, a writer whose output file already exists writes a staging file that an
+ * IncrementalFileWriter merges into the output file, so only the datasets that changed are written again.
+ * Tiled execution writes its output file slab by slab and always writes it completely.
+ */
+class PipelineExecutor : public QObject
+{
+  Q_OBJECT
+
+public:
+  static const int SpillError = -9430;
+  static const int CompressionError = -9431;
+  static const int MappingError = -9432;
+  static const int AsyncWriteError = -9433;
+  static const int ChunkedReadError = -9439;
+
+  PipelineExecutor(FilterPipeline::Pointer pipeline, QObject* parent = nullptr);
+  ~PipelineExecutor() override;
+
+  /**
+   * @brief setMaxConcurrentFilters Sets the number of filters that may run at the same time. A value
+   * less than 1 uses QThread::idealThreadCount().
+   * @param count
+   */
+  void setMaxConcurrentFilters(int count);
+  int getMaxConcurrentFilters() const;
+
+  /**
+   * @brief setReleaseDeadArrays Enables releasing created arrays right after the last filter that uses them
+   * @param release
+   */
+  void setReleaseDeadArrays(bool release);
+  bool getReleaseDeadArrays() const;
+
+  /**
+   * @brief setKeptArrayPaths Sets the paths that must never be released. A DataContainer or AttributeMatrix
+   * level path keeps every array inside it.
+   * @param paths
+   */
+  void setKeptArrayPaths(const QVector<DataArrayPath>& paths);
+  QVector<DataArrayPath> getKeptArrayPaths() const;
+
+  /**
+   * @brief setOptimizePipeline Enables the PipelineOptimizer passes before execution
+   * @param optimize
+   */
+  void setOptimizePipeline(bool optimize);
+  bool getOptimizePipeline() const;
+
+  /**
+   * @brief setFuseElementwiseFilters Enables running consecutive element-wise filters as a single loop
+   * @param fuse
+   */
+  void setFuseElementwiseFilters(bool fuse);
+  bool getFuseElementwiseFilters() const;
+
+  /**
+   * @brief getFusedRuns Returns the node indices of each run of filters that was fused during the last execution
+   * @return
+   */
+  QVector<QVector<int>> getFusedRuns() const;
+
+  /**
+   * @brief setTiledSlabThickness Executes the pipeline slab by slab along Z with TiledExecution when greater
+   * than 0. The other passes of the executor do not apply to tiled execution.
+   * @param thickness The number of Z slices per slab
+   */
+  void setTiledSlabThickness(int thickness);
+  int getTiledSlabThickness() const;
+
+  /**
+   * @brief setSeriesDatasets Executes the pipeline once for every dataset with SeriesExecution when not empty.
+   * The other passes of the executor do not apply to series execution.
+   * @param datasets
+   */
+  void setSeriesDatasets(const QVector<SeriesDataset>& datasets);
+  QVector<SeriesDataset> getSeriesDatasets() const;
+
+  /**
+   * @brief setSeriesMemoryWindow Sets the bytes the datasets in flight of a series may use, 0 for no limit
+   * @param bytes
+   */
+  void setSeriesMemoryWindow(size_t bytes);
+  size_t getSeriesMemoryWindow() const;
+
+  /**
+   * @brief getSeriesStageStats Returns how each stage of the last series execution spent its time
+   * @return
+   */
+  QVector<SeriesStageStats> getSeriesStageStats() const;
+
+  /**
+   * @brief setPreviewReduction Executes the pipeline as a preview on reduced inputs when the reduction is
+   * enabled. Tiled and series execution do not apply to previews.
+   * @param reduction
+   */
+  void setPreviewReduction(const PreviewReduction& reduction);
+  PreviewReduction getPreviewReduction() const;
+
+  /**
+   * @brief setSnapshotStore Sets the store that receives a snapshot after every filter, or null for none.
+   * Tiled and series execution take no snapshots.
+   * @param store
+   */
+  void setSnapshotStore(const std::shared_ptr<DataSnapshotStore>& store);
+  std::shared_ptr<DataSnapshotStore> getSnapshotStore() const;
+
+  /**
+   * @brief setSpillMemoryLimit Sets the bytes the arrays may hold before cold arrays are spilled to disk,
+   * 0 to never spill. Tiled and series execution keep their own memory bounds and do not spill.
+   * @param bytes
+   */
+  void setSpillMemoryLimit(size_t bytes);
+  size_t getSpillMemoryLimit() const;
+
+  /**
+   * @brief getSpillStats Returns how many arrays the last execution spilled and how long it took
+   * @return
+   */
+  SpillStats getSpillStats() const;
+
+  /**
+   * @brief setCompressIdleArrays Sets how many filters in a row must not use an array before it is held
+   * compressed until the next filter that uses it, 0 to never compress idle arrays
+   * @param filters
+   */
+  void setCompressIdleArrays(int filters);
+  int getCompressIdleArrays() const;
+
+  /**
+   * @brief setCompressedArrayPaths Sets the arrays that are held compressed whenever no filter uses them.
+   * A DataContainer or AttributeMatrix level path covers every array inside it.
+   * @param paths
+   */
+  void setCompressedArrayPaths(const QVector<DataArrayPath>& paths);
+  QVector<DataArrayPath> getCompressedArrayPaths() const;
+
+  /**
+   * @brief getCompressionStats Returns how many arrays the last execution compressed and how long it took
+   * @return
+   */
+  CompressionStats getCompressionStats() const;
+
+  /**
+   * @brief getCompressedArrays Returns the arrays the last execution held compressed
+   * @return
+   */
+  QVector<CompressedArrayInfo> getCompressedArrays() const;
+
+  /**
+   * @brief setArrayMapping Sets how the arrays of input files are mapped, Off to read them into memory
+   * @param mode
+   */
+  void setArrayMapping(MappedFileReader::Mode mode);
+  MappedFileReader::Mode getArrayMapping() const;
+
+  /**
+   * @brief setScratchDirectory Sets the directory of the scratch files of mapped executions, the system
+   * temporary directory if empty
+   * @param directory
+   */
+  void setScratchDirectory(const QString& directory);
+  QString getScratchDirectory() const;
+
+  /**
+   * @brief setParallelChunkedReads Enables decompressing the chunked datasets of input files on the thread pool
+   * @param parallel
+   */
+  void setParallelChunkedReads(bool parallel);
+  bool getParallelChunkedReads() const;
+
+  /**
+   * @brief getMappingStats Returns how many arrays the last execution mapped or moved to scratch files
+   * @return
+   */
+  MappingStats getMappingStats() const;
+
+  /**
+   * @brief setAsyncWrites Enables running writer filters in the background while the next filters execute.
+   * Tiled, series and preview execution write synchronously.
+   * @param async
+   */
+  void setAsyncWrites(bool async);
+  bool getAsyncWrites() const;
+
+  /**
+   * @brief getAsyncWriteStats Returns how much the last execution wrote in the background and how long it waited
+   * @return
+   */
+  AsyncWriteStats getAsyncWriteStats() const;
+
+  /**
+   * @brief setPrefetchDepth Sets how many readers ahead of the running filters have their input files read
+   * in the background, 0 to never prefetch. Tiled and series execution do not prefetch.
+   * @param readers
+   */
+  void setPrefetchDepth(int readers);
+  int getPrefetchDepth() const;
+
+  /**
+   * @brief setPrefetchMemoryLimit Sets the bytes of input files that may be read ahead of their readers at once
+   * @param bytes
+   */
+  void setPrefetchMemoryLimit(size_t bytes);
+  size_t getPrefetchMemoryLimit() const;
+
+  /**
+   * @brief getPrefetchStats Returns how many input files the last execution prefetched and how many were used
+   * @return
+   */
+  PrefetchStats getPrefetchStats() const;
+
+  /**
+   * @brief setWriteProfile Sets the profile the files of writers without their own profile are written with
+   * @param preset
+   */
+  void setWriteProfile(WriteProfile::Preset preset);
+  WriteProfile::Preset getWriteProfile() const;
+
+  /**
+   * @brief setIncrementalWrites Enables updating existing output files in place with only the datasets
+   * that changed
+   * @param incremental
+   */
+  void setIncrementalWrites(bool incremental);
+  bool getIncrementalWrites() const;
+
+  /**
+   * @brief setThreadBudgetRequest Sets the weight and thread limit the execution asks of the ThreadBudget.
+   * The number of concurrent filters and any TBB parallelism inside them are limited to the share of the budget.
+   * @param request
+   */
+  void setThreadBudgetRequest(const ThreadBudget::Request& request);
+  ThreadBudget::Request getThreadBudgetRequest() const;
+
+  /**
+   * @brief getOptimizationChanges Returns what the optimizer changed for the last execution
+   * @return
+   */
+  QVector<OptimizationChange> getOptimizationChanges() const;
+
+  /**
+   * @brief getReleasedArrays Returns the arrays that were released during the last execution
+   * @return
+   */
+  QVector<ReleasedArray> getReleasedArrays() const;
+
+  /**
+   * @brief getPeakArrayBytes Returns the largest number of bytes held by arrays between two filters
+   * @return
+   */
+  size_t getPeakArrayBytes() const;
+
+  /**
+   * @brief getLiveArrayBytes Returns the number of bytes held by arrays after the most recently finished
+   * filter. May be called from any thread while the pipeline runs.
+   * @return
+   */
+  size_t getLiveArrayBytes() const;
+
+  /**
+   * @brief getPeakArrayBytesWithoutRelease Returns what getPeakArrayBytes() would have been had no
+   * array been released
+   * @return
+   */
+  size_t getPeakArrayBytesWithoutRelease() const;
+
+  /**
+   * @brief getDataFlowGraph Returns the graph that was used for the last call to execute()
+   * @return
+   */
+  const PipelineDataFlowGraph& getDataFlowGraph() const;
+
+  /**
+   * @brief getDataContainerArray Returns the DataContainerArray holding the results of the last execution
+   * @return
+   */
+  DataContainerArray::Pointer getDataContainerArray() const;
+
+  /**
+   * @brief getErrorCondition Returns the error condition of the first filter that failed or 0
+   * @return
+   */
+  int getErrorCondition() const;
+
+  /**
+   * @brief addMessageReceiver Connects the pipelineGeneratedMessage signal to the
+   * processPipelineMessage(const PipelineMessage&) slot of the receiver
+   * @param obj
+   */
+  void addMessageReceiver(QObject* obj);
+
+  /**
+   * @brief execute Runs the pipeline and blocks until every filter has finished, an error occurred
+   * or the execution was canceled.
+   * @return The DataContainerArray with the results
+   */
+  DataContainerArray::Pointer execute();
+
+public slots:
+  /**
+   * @brief run Executes the pipeline. Intended to be connected to QThread::started()
+   */
+  void run();
+
+  /**
+   * @brief cancelPipeline Cancels every running filter and prevents new filters from starting
+   */
+  void cancelPipeline();
+
+signals:
+  void pipelineGeneratedMessage(const PipelineMessage& msg);
+  void pipelineFinished();
+
+protected:
+  /**
+   * @brief checkOut Moves the DataContainers touched by 'node' out of the pipeline's DataContainerArray
+   * into a new private DataContainerArray
+   * @param node
+   * @return
+   */
+  DataContainerArray::Pointer checkOut(int node);
+
+  /**
+   * @brief checkOut Moves the DataContainers touched by any of 'nodes' into a new private DataContainerArray
+   * @param nodes
+   * @return
+   */
+  DataContainerArray::Pointer checkOut(const QVector<int>& nodes);
+
+  /**
+   * @brief checkIn Moves every DataContainer of a private DataContainerArray back into the pipeline's
+   * DataContainerArray
+   * @param dca
+   */
+  void checkIn(const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief executeNode Runs a single filter. Called from a pool thread.
+   * @param node
+   * @param dca
+   */
+  void executeNode(int node, DataContainerArray::Pointer dca);
+
+  /**
+   * @brief findFusedRuns Groups consecutive element-wise filters into runs. A filter only joins a run if
+   * everything it depends on is inside the run or already finished when the run starts.
+   */
+  void findFusedRuns();
+
+  /**
+   * @brief executeFusedRun Runs every filter of a fused run as one loop. Falls back to executing the filters
+   * one by one if the run cannot be fused. Called from a pool thread.
+   * @param run
+   * @param dca
+   */
+  void executeFusedRun(int run, DataContainerArray::Pointer dca);
+
+  /**
+   * @brief executeFusedMembers Runs the kernels of a fused run, or its filters one by one if they cannot be fused
+   * @param run
+   * @param dca
+   */
+  void executeFusedMembers(int run, const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief setGraph Replaces the graph that is executed and that cancelPipeline() cancels
+   * @param graph
+   */
+  void setGraph(const PipelineDataFlowGraph& graph);
+
+  /**
+   * @brief executeGraph Runs the pipeline along its PipelineDataFlowGraph
+   */
+  void executeGraph();
+
+  /**
+   * @brief executeTiled Runs the pipeline with TiledExecution
+   */
+  void executeTiled();
+
+  /**
+   * @brief executeSeries Runs the pipeline for every series dataset with SeriesExecution
+   */
+  void executeSeries();
+
+  /**
+   * @brief routeMessage Delivers or buffers a message generated by the filter at 'node'
+   * @param node
+   * @param msg
+   */
+  void routeMessage(int node, const PipelineMessage& msg);
+
+  /**
+   * @brief routeNote Routes 'text' as standard output of 'filter' at 'node'
+   * @param node
+   * @param filter
+   * @param text
+   */
+  void routeNote(int node, const AbstractFilter::Pointer& filter, const QString& text);
+
+  /**
+   * @brief routeWarning Routes 'text' as a warning of 'filter' at 'node'
+   * @param node
+   * @param filter
+   * @param text
+   * @param code
+   */
+  void routeWarning(int node, const AbstractFilter::Pointer& filter, const QString& text, int code);
+
+  /**
+   * @brief distributeWrites Spreads the pages of the arrays 'node' wrote across the NUMA nodes while the
+   * threads are pinned to them, see NumaTopology::distribute()
+   * @param node
+   * @param dca
+   */
+  void distributeWrites(int node, const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief nodeFinished Marks a node finished and flushes any messages that are now in order
+   * @param node
+   */
+  void nodeFinished(int node);
+
+  /**
+   * @brief releaseDeadArrays Removes the arrays whose last use was the filter at 'node'
+   * @param node
+   * @return The number of bytes released
+   */
+  size_t releaseDeadArrays(int node);
+
+  /**
+   * @brief copyReusedOutputs Copies the outputs of the filter a reused filter duplicates
+   * @param node
+   * @param dca
+   * @return false if the outputs could not be copied and the filter has to execute after all
+   */
+  bool copyReusedOutputs(int node, const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief notifyStandardOutput Sends a line of text to the standard output of the receivers
+   * @param text
+   */
+  void notifyStandardOutput(const QString& text);
+
+private:
+  FilterPipeline::Pointer m_Pipeline;
+  // Replaced under m_GraphMutex, which cancelPipeline() holds while it cancels the filters
+  QMutex m_GraphMutex;
+  PipelineDataFlowGraph m_Graph;
+  // The copies of readers that run in place of their graph nodes, also guarded by m_GraphMutex
+  QMap<int, AbstractFilter::Pointer> m_ReaderCopies;
+  DataContainerArray::Pointer m_DataContainerArray;
+  int m_MaxConcurrentFilters = 0;
+  int m_ErrorCondition = 0;
+  std::atomic<bool> m_Canceled{false};
+
+  bool m_OptimizePipeline = false;
+  PipelineOptimizer m_Optimizer;
+
+  bool m_FuseElementwiseFilters = false;
+  QVector<QVector<int>> m_FusedRuns;
+  QVector<QVector<ElementwiseKernel::Pointer>> m_FusedKernels;
+  QVector<QVector<DataArrayPath>> m_FusedUnmaterialized;
+  QVector<int> m_FusedRunOf;
+
+  int m_TiledSlabThickness = 0;
+
+  QVector<SeriesDataset> m_SeriesDatasets;
+  size_t m_SeriesMemoryWindow = 0;
+  QVector<SeriesStageStats> m_SeriesStageStats;
+  // Guarded by m_SeriesMutex
+  QMutex m_SeriesMutex;
+  SeriesExecution* m_Series = nullptr;
+
+  PreviewReduction m_PreviewReduction;
+  std::shared_ptr<DataSnapshotStore> m_SnapshotStore;
+  size_t m_SpillMemoryLimit = 0;
+  std::unique_ptr<ArraySpillManager> m_SpillManager;
+  SpillStats m_SpillStats;
+  int m_CompressIdleArrays = 0;
+  QVector<DataArrayPath> m_CompressedArrayPaths;
+  std::unique_ptr<ArrayCompressionManager> m_CompressionManager;
+  CompressionStats m_CompressionStats;
+  QVector<CompressedArrayInfo> m_CompressedArrays;
+  MappedFileReader::Mode m_ArrayMapping = MappedFileReader::Mode::Off;
+  QString m_ScratchDirectory;
+  bool m_ParallelChunkedReads = false;
+  // Guarded by m_CompletionMutex while the graph executes
+  MappingStats m_MappingStats;
+  bool m_AsyncWrites = false;
+  std::unique_ptr<AsyncFileWriter> m_AsyncWriter;
+  AsyncWriteStats m_AsyncWriteStats;
+  int m_PrefetchDepth = 0;
+  size_t m_PrefetchMemoryLimit = InputPrefetcher::DefaultMaxBytes;
+  std::unique_ptr<InputPrefetcher> m_Prefetcher;
+  PrefetchStats m_PrefetchStats;
+  WriteProfile::Preset m_WriteProfile = WriteProfile::Preset::Default;
+  bool m_IncrementalWrites = false;
+
+  ThreadBudget::Request m_ThreadBudgetRequest;
+  int m_BudgetShare = -1;
+  std::atomic<int> m_TunedFilters;
+  std::atomic<int> m_ExploringFilters;
+
+  bool m_ReleaseDeadArrays = false;
+  QVector<DataArrayPath> m_KeptArrayPaths;
+  ArrayLivenessAnalysis m_Liveness;
+  QVector<ReleasedArray> m_ReleasedArrays;
+  size_t m_PeakArrayBytes = 0;
+  size_t m_PeakArrayBytesWithoutRelease = 0;
+  std::atomic<size_t> m_LiveArrayBytes;
+  std::atomic<size_t> m_NumaMovedBytes;
+
+  // Guarded by m_MessageMutex
+  QMutex m_MessageMutex;
+  QVector<QVector<PipelineMessage>> m_BufferedMessages;
+  QVector<bool> m_Finished;
+  int m_StreamingNode = 0;
+
+  // Guarded by m_CompletionMutex
+  QMutex m_CompletionMutex;
+  QWaitCondition m_CompletionCondition;
+  QVector<int> m_CompletedNodes;
+
+  PipelineExecutor(const PipelineExecutor&) = delete; // Copy Constructor Not Implemented
+  void operator=(const PipelineExecutor&) = delete;   // Move assignment Not Implemented
+};
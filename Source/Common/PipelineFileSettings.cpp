@@ -0,0 +1,222 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineFileSettings.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonValue>
+#include <QtCore/QSaveFile>
+#include <QtCore/QVariantMap>
+
+#include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/JsonFilterParametersWriter.h"
+
+#include "Common/PipelineOptimizer.h"
+#include "Common/WriteProfile.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ReadRoot(const QString& filePath, QJsonObject& root)
+{
+  QFile inputFile(filePath);
+  if(filePath.isEmpty() || !inputFile.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+  QJsonParseError parseError;
+  QJsonDocument doc = QJsonDocument::fromJson(inputFile.readAll(), &parseError);
+  if(parseError.error != QJsonParseError::NoError || !doc.isObject())
+  {
+    return false;
+  }
+  root = doc.object();
+  return true;
+}
+} // namespace
+
+const char* PipelineFileSettings::PipelinePropertyName = "SIMPLViewPipelineSettings";
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineFileSettings::Read(const QJsonObject& root, const FilterPipeline::Pointer& pipeline, int firstFilter)
+{
+  if(pipeline.get() == nullptr)
+  {
+    return;
+  }
+  QJsonObject builderObj = root["PipelineBuilder"].toObject();
+  if(builderObj.contains(ThreadBudget::JsonKey))
+  {
+    QVariantMap settings = pipeline->property(PipelinePropertyName).toMap();
+    settings[ThreadBudget::JsonKey] = builderObj[ThreadBudget::JsonKey].toObject().toVariantMap();
+    pipeline->setProperty(PipelinePropertyName, settings);
+  }
+
+  // The filters of a pipeline file are objects keyed by their index
+  FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+  for(int i = 0; firstFilter + i < filters.size(); i++)
+  {
+    QJsonObject filterObj = root[QString::number(i)].toObject();
+    AbstractFilter::Pointer filter = filters[firstFilter + i];
+    if(filterObj.contains(PipelineOptimizer::SideEffectsPropertyName))
+    {
+      PipelineOptimizer::SetHasSideEffects(filter, filterObj[PipelineOptimizer::SideEffectsPropertyName].toBool());
+    }
+  }
+  WriteProfile::ReadWriterPresets(root, pipeline, firstFilter);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineFileSettings::Write(const FilterPipeline::Pointer& pipeline, QJsonObject& root)
+{
+  if(pipeline.get() == nullptr)
+  {
+    return;
+  }
+  QVariantMap settings = pipeline->property(PipelinePropertyName).toMap();
+  if(!settings.isEmpty())
+  {
+    QJsonObject builderObj = root["PipelineBuilder"].toObject();
+    for(QVariantMap::const_iterator iter = settings.constBegin(); iter != settings.constEnd(); ++iter)
+    {
+      builderObj[iter.key()] = QJsonValue::fromVariant(iter.value());
+    }
+    root["PipelineBuilder"] = builderObj;
+  }
+
+  FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+  for(int i = 0; i < filters.size(); i++)
+  {
+    QString key = QString::number(i);
+    if(!root.contains(key))
+    {
+      continue;
+    }
+    QJsonObject filterObj = root[key].toObject();
+    if(PipelineOptimizer::GetHasSideEffects(filters[i]))
+    {
+      filterObj[PipelineOptimizer::SideEffectsPropertyName] = true;
+    }
+    else
+    {
+      filterObj.remove(PipelineOptimizer::SideEffectsPropertyName);
+    }
+    root[key] = filterObj;
+  }
+  WriteProfile::WriteWriterPresets(pipeline, root);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineFileSettings::ReadFile(const QString& filePath, const FilterPipeline::Pointer& pipeline, int firstFilter)
+{
+  QJsonObject root;
+  if(!ReadRoot(filePath, root))
+  {
+    return false;
+  }
+  Read(root, pipeline, firstFilter);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineFileSettings::WriteFile(const QString& filePath, const FilterPipeline::Pointer& pipeline)
+{
+  QJsonObject root;
+  if(!ReadRoot(filePath, root))
+  {
+    return false;
+  }
+  Write(pipeline, root);
+
+  QSaveFile outputFile(filePath);
+  if(!outputFile.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  outputFile.write(QJsonDocument(root).toJson());
+  return outputFile.commit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineFileSettings::WriteString(const FilterPipeline::Pointer& pipeline)
+{
+  JsonFilterParametersWriter::Pointer jsonWriter = JsonFilterParametersWriter::New();
+  QString json = jsonWriter->writePipelineToString(pipeline, pipeline->getName());
+  QJsonObject root = QJsonDocument::fromJson(json.toUtf8()).object();
+  if(root.isEmpty())
+  {
+    return json;
+  }
+  Write(pipeline, root);
+  return QString::fromUtf8(QJsonDocument(root).toJson());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer PipelineFileSettings::ReadString(const QString& json)
+{
+  JsonFilterParametersReader::Pointer jsonReader = JsonFilterParametersReader::New();
+  FilterPipeline::Pointer pipeline = jsonReader->readPipelineFromString(json);
+  if(pipeline.get() != nullptr)
+  {
+    Read(QJsonDocument::fromJson(json.toUtf8()).object(), pipeline);
+  }
+  return pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::Request PipelineFileSettings::ReadRequest(const FilterPipeline::Pointer& pipeline, ThreadBudget::PriorityClass defaultPriority)
+{
+  // Only the "PipelineBuilder" object matters, so the filters are left out
+  QJsonObject root;
+  Write(pipeline, root);
+  return ThreadBudget::ReadRequest(root, defaultPriority);
+}
@@ -0,0 +1,128 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "Common/ThreadBudget.h"
+
+/**
+ * @brief The PipelineFileSettings class reads and writes the SIMPLView settings a pipeline file holds beside
+ * the filter parameters, which SIMPL's JSON reader and writer do not know about.
+ *
+ * The settings of a filter are extra keys in the object of the filter, which the pipeline file keys by the
+ * index of the filter: "SIMPLViewHasSideEffects" is the flag of PipelineOptimizer::SetHasSideEffects() and
+ * "SIMPLViewWriteProfile" the profile of WriteProfile::SetWriterPreset(). The settings of the whole pipeline,
+ * e.g. its ThreadBudget request, are keys of the "PipelineBuilder" object of the file; in memory they are the
+ * PipelinePropertyName property of the FilterPipeline.
+ *
+ * Every place that turns a pipeline into JSON and back, e.g. saving and opening it in the editor, queueing
+ * a job or running a file with PipelineRunner, goes through this class so the settings are never lost.
+ */
+class PipelineFileSettings
+{
+public:
+  /**
+   * @brief PipelinePropertyName The name of the dynamic property of a FilterPipeline that holds the settings
+   * of the whole pipeline as a map of "PipelineBuilder" keys to their values
+   */
+  static const char* PipelinePropertyName;
+
+  /**
+   * @brief Read Applies the settings in the pipeline file object 'root' to the filters of 'pipeline'
+   * @param root
+   * @param pipeline
+   * @param firstFilter The index in 'pipeline' of the first filter of the file, e.g. when the file was
+   * added to the end of an existing pipeline
+   */
+  static void Read(const QJsonObject& root, const FilterPipeline::Pointer& pipeline, int firstFilter = 0);
+
+  /**
+   * @brief Write Adds the settings of the filters of 'pipeline' to the pipeline file object 'root'
+   * @param pipeline
+   * @param root
+   */
+  static void Write(const FilterPipeline::Pointer& pipeline, QJsonObject& root);
+
+  /**
+   * @brief ReadFile Applies the settings in the pipeline file at 'filePath' to the filters of 'pipeline'
+   * @param filePath
+   * @param pipeline
+   * @param firstFilter
+   * @return false if the file is not a JSON pipeline file
+   */
+  static bool ReadFile(const QString& filePath, const FilterPipeline::Pointer& pipeline, int firstFilter = 0);
+
+  /**
+   * @brief WriteFile Adds the settings of the filters of 'pipeline' to the JSON pipeline file SIMPL just
+   * wrote at 'filePath'
+   * @param filePath
+   * @param pipeline
+   * @return false if the file is not a JSON pipeline file or could not be replaced
+   */
+  static bool WriteFile(const QString& filePath, const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief WriteString Returns the JSON of 'pipeline' with its settings
+   * @param pipeline
+   * @return
+   */
+  static QString WriteString(const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief ReadString Returns the pipeline of 'json' with its settings applied, or null if it is not a pipeline
+   * @param json
+   * @return
+   */
+  static FilterPipeline::Pointer ReadString(const QString& json);
+
+  /**
+   * @brief ReadRequest Returns the ThreadBudget request among the settings of 'pipeline' as they are in
+   * memory, which may differ from any file the pipeline came from
+   * @param pipeline
+   * @param defaultPriority The priority class if the settings do not name one
+   * @return
+   */
+  static ThreadBudget::Request ReadRequest(const FilterPipeline::Pointer& pipeline, ThreadBudget::PriorityClass defaultPriority);
+
+private:
+  PipelineFileSettings() = delete;
+  PipelineFileSettings(const PipelineFileSettings&) = delete; // Copy Constructor Not Implemented
+  void operator=(const PipelineFileSettings&) = delete;       // Move assignment Not Implemented
+};
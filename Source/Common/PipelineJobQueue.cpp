@@ -0,0 +1,495 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineJobQueue.h"
+
+#include <algorithm>
+
+#include <QtCore/QEventLoop>
+#include <QtCore/QFileInfo>
+#include <QtCore/QThread>
+
+#include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
+
+#include "Common/PipelineExecutor.h"
+#include "Common/PipelineFileSettings.h"
+#include "Common/ThreadBudget.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineJobQueue::PipelineJobQueue(QObject* parent)
+: QObject(parent)
+{
+  m_UpdateTimer.setInterval(500);
+  connect(&m_UpdateTimer, &QTimer::timeout, this, &PipelineJobQueue::updateRunningJobs);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineJobQueue::~PipelineJobQueue()
+{
+  cancelAll();
+  for(const Runner& runner : m_Runners)
+  {
+    runner.thread->quit();
+    runner.thread->wait();
+    delete runner.executor;
+    delete runner.thread;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineJobQueue::StateName(PipelineJob::State state)
+{
+  switch(state)
+  {
+  case PipelineJob::State::Queued:
+    return tr("Queued");
+  case PipelineJob::State::Running:
+    return tr("Running");
+  case PipelineJob::State::Finished:
+    return tr("Finished");
+  case PipelineJob::State::Failed:
+    return tr("Failed");
+  case PipelineJob::State::Canceled:
+    return tr("Canceled");
+  }
+  return QString();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::setMaxConcurrentJobs(int count)
+{
+  count = std::max(count, 1);
+  if(count == m_MaxConcurrentJobs)
+  {
+    return;
+  }
+  m_MaxConcurrentJobs = count;
+  emit maxConcurrentJobsChanged(m_MaxConcurrentJobs);
+  startJobs();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineJobQueue::getMaxConcurrentJobs() const
+{
+  return m_MaxConcurrentJobs;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::setDefaultPriorityClass(ThreadBudget::PriorityClass priority)
+{
+  if(priority == m_DefaultPriorityClass)
+  {
+    return;
+  }
+  m_DefaultPriorityClass = priority;
+  emit defaultPriorityClassChanged(m_DefaultPriorityClass);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::PriorityClass PipelineJobQueue::getDefaultPriorityClass() const
+{
+  return m_DefaultPriorityClass;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineJobQueue::enqueue(const QString& filePath, int priority)
+{
+  QFileInfo fi(filePath);
+  return addJob(fi.completeBaseName(), fi.absoluteFilePath(), QString(), priority);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineJobQueue::enqueue(const FilterPipeline::Pointer& pipeline, int priority)
+{
+  // The job gets its own filter instances so the pipeline can keep being edited while the job runs
+  QString pipelineJson = PipelineFileSettings::WriteString(pipeline);
+  return addJob(pipeline->getName(), QString(), pipelineJson, priority);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineJobQueue::enqueueSeries(const QString& filePath, const QVector<SeriesDataset>& datasets, size_t memoryWindow, int priority)
+{
+  QFileInfo fi(filePath);
+  Series series;
+  series.datasets = datasets;
+  series.memoryWindow = memoryWindow;
+
+  // Record the series before addJob() may start the job
+  int id = m_NextId;
+  m_Series.insert(id, series);
+  return addJob(tr("%1 (%2 datasets)").arg(fi.completeBaseName()).arg(datasets.size()), fi.absoluteFilePath(), QString(), priority);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineJobQueue::addJob(const QString& name, const QString& filePath, const QString& pipelineJson, int priority)
+{
+  PipelineJob job;
+  job.id = m_NextId++;
+  job.name = name.isEmpty() ? tr("Untitled Pipeline") : name;
+  job.filePath = filePath;
+  job.priority = priority;
+  job.datasetCount = m_Series.value(job.id).datasets.size();
+  m_Jobs.insert(job.id, job);
+  if(!pipelineJson.isEmpty())
+  {
+    m_PipelineJson.insert(job.id, pipelineJson);
+  }
+
+  emit jobAdded(job.id);
+  startJobs();
+  return job.id;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineJob PipelineJobQueue::job(int id) const
+{
+  return m_Jobs.value(id);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QList<int> PipelineJobQueue::jobIds() const
+{
+  return m_Jobs.keys();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::setPriority(int id, int priority)
+{
+  if(!m_Jobs.contains(id))
+  {
+    return;
+  }
+  m_Jobs[id].priority = priority;
+  emit jobChanged(id);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::setNumaNode(int id, int node)
+{
+  if(!m_Jobs.contains(id) || m_Jobs[id].state != PipelineJob::State::Queued)
+  {
+    return;
+  }
+  m_Jobs[id].numaNode = std::max(node, -1);
+  emit jobChanged(id);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::cancel(int id)
+{
+  if(!m_Jobs.contains(id))
+  {
+    return;
+  }
+
+  PipelineJob& job = m_Jobs[id];
+  if(job.state == PipelineJob::State::Queued)
+  {
+    job.state = PipelineJob::State::Canceled;
+    m_PipelineJson.remove(id);
+    m_Series.remove(id);
+    emit jobChanged(id);
+    if(isIdle())
+    {
+      emit allJobsFinished();
+    }
+  }
+  else if(job.state == PipelineJob::State::Running && m_Runners.contains(id))
+  {
+    m_Runners[id].canceled = true;
+    m_Runners[id].executor->cancelPipeline();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::cancelAll()
+{
+  QList<int> ids = m_Jobs.keys();
+  for(int id : ids)
+  {
+    cancel(id);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::removeFinishedJobs()
+{
+  QList<int> ids = m_Jobs.keys();
+  for(int id : ids)
+  {
+    PipelineJob::State state = m_Jobs[id].state;
+    if(state != PipelineJob::State::Queued && state != PipelineJob::State::Running)
+    {
+      m_Jobs.remove(id);
+      emit jobRemoved(id);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineJobQueue::isIdle() const
+{
+  for(const PipelineJob& job : m_Jobs)
+  {
+    if(job.state == PipelineJob::State::Queued || job.state == PipelineJob::State::Running)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::waitForAll()
+{
+  if(isIdle())
+  {
+    return;
+  }
+
+  QEventLoop loop;
+  connect(this, &PipelineJobQueue::allJobsFinished, &loop, &QEventLoop::quit);
+  loop.exec();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::startJobs()
+{
+  while(m_Runners.size() < m_MaxConcurrentJobs)
+  {
+    // Highest priority first, then in the order the jobs were added
+    int next = -1;
+    for(const PipelineJob& job : m_Jobs)
+    {
+      if(job.state == PipelineJob::State::Queued && (next < 0 || job.priority > m_Jobs[next].priority))
+      {
+        next = job.id;
+      }
+    }
+    if(next < 0)
+    {
+      break;
+    }
+    startJob(next);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::startJob(int id)
+{
+  PipelineJob& job = m_Jobs[id];
+
+  FilterPipeline::Pointer pipeline;
+  if(m_PipelineJson.contains(id))
+  {
+    pipeline = PipelineFileSettings::ReadString(m_PipelineJson.take(id));
+  }
+  else
+  {
+    JsonFilterParametersReader::Pointer jsonReader = JsonFilterParametersReader::New();
+    pipeline = jsonReader->readPipelineFromFile(job.filePath);
+    PipelineFileSettings::ReadFile(job.filePath, pipeline);
+  }
+
+  if(pipeline.get() == nullptr)
+  {
+    job.state = PipelineJob::State::Failed;
+    job.lastStatus = tr("The pipeline could not be read");
+    m_Series.remove(id);
+    emit jobChanged(id);
+    if(isIdle())
+    {
+      emit allJobsFinished();
+    }
+    return;
+  }
+
+  Runner runner;
+  runner.executor = new PipelineExecutor(pipeline);
+  // The request comes with the pipeline, so a copy queued from the editor keeps it as well
+  ThreadBudget::Request request = PipelineFileSettings::ReadRequest(pipeline, m_DefaultPriorityClass);
+  job.priorityClass = request.priority;
+  if(job.numaNode >= 0)
+  {
+    request.numaNode = job.numaNode;
+  }
+  job.numaNode = request.numaNode;
+  runner.executor->setThreadBudgetRequest(request);
+  if(m_Series.contains(id))
+  {
+    Series series = m_Series.take(id);
+    runner.executor->setSeriesDatasets(series.datasets);
+    runner.executor->setSeriesMemoryWindow(series.memoryWindow);
+  }
+  runner.thread = new QThread(this);
+  runner.executor->moveToThread(runner.thread);
+  connect(runner.thread, &QThread::started, runner.executor, &PipelineExecutor::run);
+  connect(runner.executor, &PipelineExecutor::pipelineFinished, runner.thread, &QThread::quit);
+  connect(runner.thread, &QThread::finished, this, [this, id] { jobFinished(id); });
+  connect(runner.executor, &PipelineExecutor::pipelineGeneratedMessage, this, [this, id](const PipelineMessage& msg) { processJobMessage(id, msg); });
+  runner.timer.start();
+  m_Runners.insert(id, runner);
+
+  job.state = PipelineJob::State::Running;
+  emit jobChanged(id);
+
+  runner.thread->start();
+  m_UpdateTimer.start();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::jobFinished(int id)
+{
+  Runner runner = m_Runners.take(id);
+  if(m_Jobs.contains(id))
+  {
+    PipelineJob& job = m_Jobs[id];
+    job.elapsedMsecs = runner.timer.elapsed();
+    job.errorCondition = runner.executor->getErrorCondition();
+    job.memoryBytes = 0;
+    job.peakMemoryBytes = std::max(job.peakMemoryBytes, runner.executor->getPeakArrayBytes());
+    if(runner.canceled)
+    {
+      job.state = PipelineJob::State::Canceled;
+    }
+    else if(job.errorCondition < 0)
+    {
+      job.state = PipelineJob::State::Failed;
+    }
+    else
+    {
+      job.state = PipelineJob::State::Finished;
+      job.progress = 100;
+    }
+    emit jobChanged(id);
+  }
+
+  runner.executor->deleteLater();
+  runner.thread->deleteLater();
+
+  if(m_Runners.isEmpty())
+  {
+    m_UpdateTimer.stop();
+  }
+
+  startJobs();
+  if(isIdle())
+  {
+    emit allJobsFinished();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::processJobMessage(int id, const PipelineMessage& msg)
+{
+  if(!m_Jobs.contains(id))
+  {
+    return;
+  }
+
+  PipelineJob& job = m_Jobs[id];
+  if(msg.getType() == PipelineMessage::MessageType::ProgressValue)
+  {
+    job.progress = msg.getProgressValue();
+  }
+  else if(msg.getType() == PipelineMessage::MessageType::StatusMessage || msg.getType() == PipelineMessage::MessageType::Error)
+  {
+    job.lastStatus = msg.getText();
+  }
+  emit jobMessage(id, msg);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobQueue::updateRunningJobs()
+{
+  for(QMap<int, Runner>::const_iterator iter = m_Runners.constBegin(); iter != m_Runners.constEnd(); ++iter)
+  {
+    PipelineJob& job = m_Jobs[iter.key()];
+    job.elapsedMsecs = iter->timer.elapsed();
+    job.memoryBytes = iter->executor->getLiveArrayBytes();
+    job.peakMemoryBytes = std::max(job.peakMemoryBytes, job.memoryBytes);
+    emit jobChanged(iter.key());
+  }
+}
@@ -0,0 +1,284 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+#include "SIMPLib/Common/PipelineMessage.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "Common/SeriesExecution.h"
+#include "Common/ThreadBudget.h"
+
+class PipelineExecutor;
+class QThread;
+
+/**
+ * @brief The PipelineJob struct is the state of one pipeline in a PipelineJobQueue
+ */
+struct PipelineJob
+{
+  enum class State : int
+  {
+    Queued,
+    Running,
+    Finished,
+    Failed,
+    Canceled
+  };
+
+  int id = -1;
+  QString name;
+  QString filePath;
+  int priority = 0;
+  ThreadBudget::PriorityClass priorityClass = ThreadBudget::PriorityClass::Background;
+  int numaNode = -1;
+  State state = State::Queued;
+  int progress = 0;
+  qint64 elapsedMsecs = 0;
+  size_t memoryBytes = 0;
+  size_t peakMemoryBytes = 0;
+  int errorCondition = 0;
+  QString lastStatus;
+  int datasetCount = 0;
+};
+
+/**
+ * @brief The PipelineJobQueue class runs pipeline files as background jobs, without an editor window.
+ *
+ * Queued jobs start in order of priority, highest first, and in the order they were added for equal
+ * priorities, as long as fewer than getMaxConcurrentJobs() jobs are running. Every job reads its own copy
+ * of the pipeline and runs it with a PipelineExecutor on its own thread, so the jobs share the process'
+ * ThreadBudget. While a job runs, its progress, elapsed time and array memory are refreshed about twice
+ * a second through jobChanged().
+ *
+ * Jobs run in the priority class their pipeline file names, or in the default priority class of the
+ * queue, which is background unless changed. A job placed on a NUMA node with setNumaNode(), or by its
+ * pipeline file, runs all of its threads on that node.
+ */
+class PipelineJobQueue : public QObject
+{
+  Q_OBJECT
+
+public:
+  PipelineJobQueue(QObject* parent = nullptr);
+  ~PipelineJobQueue() override;
+
+  /**
+   * @brief StateName Returns the display name of a job state
+   * @param state
+   * @return
+   */
+  static QString StateName(PipelineJob::State state);
+
+  /**
+   * @brief setMaxConcurrentJobs Sets the number of jobs that may run at the same time, at least 1
+   * @param count
+   */
+  void setMaxConcurrentJobs(int count);
+  int getMaxConcurrentJobs() const;
+
+  /**
+   * @brief setDefaultPriorityClass Sets the priority class of jobs whose pipeline does not name one. Applies
+   * to jobs that have not started yet.
+   * @param priority
+   */
+  void setDefaultPriorityClass(ThreadBudget::PriorityClass priority);
+  ThreadBudget::PriorityClass getDefaultPriorityClass() const;
+
+  /**
+   * @brief enqueue Adds the pipeline file at 'filePath' as a job
+   * @param filePath
+   * @param priority
+   * @return The id of the new job
+   */
+  int enqueue(const QString& filePath, int priority = 0);
+
+  /**
+   * @brief enqueue Adds a copy of 'pipeline' as a job. Later changes to 'pipeline' do not affect the job.
+   * @param pipeline
+   * @param priority
+   * @return The id of the new job
+   */
+  int enqueue(const FilterPipeline::Pointer& pipeline, int priority = 0);
+
+  /**
+   * @brief enqueueSeries Adds the pipeline file at 'filePath' as a job that runs it once for every dataset
+   * with the stages of consecutive datasets overlapped, see SeriesExecution
+   * @param filePath
+   * @param datasets
+   * @param memoryWindow The bytes the datasets in flight may use, 0 for no limit
+   * @param priority
+   * @return The id of the new job
+   */
+  int enqueueSeries(const QString& filePath, const QVector<SeriesDataset>& datasets, size_t memoryWindow, int priority = 0);
+
+  /**
+   * @brief job Returns a copy of the state of the job 'id'
+   * @param id
+   * @return
+   */
+  PipelineJob job(int id) const;
+
+  /**
+   * @brief jobIds Returns the ids of every job in the order they were added
+   * @return
+   */
+  QList<int> jobIds() const;
+
+  /**
+   * @brief setPriority Changes the priority of a job. Only affects jobs that have not started yet.
+   * @param id
+   * @param priority
+   */
+  void setPriority(int id, int priority);
+
+  /**
+   * @brief setNumaNode Places a job on a NUMA node, -1 for the node its pipeline file names or any node.
+   * Only affects jobs that have not started yet.
+   * @param id
+   * @param node
+   */
+  void setNumaNode(int id, int node);
+
+  /**
+   * @brief cancel Cancels a queued or running job
+   * @param id
+   */
+  void cancel(int id);
+
+  /**
+   * @brief cancelAll Cancels every queued and running job
+   */
+  void cancelAll();
+
+  /**
+   * @brief removeFinishedJobs Forgets every job that is no longer queued or running
+   */
+  void removeFinishedJobs();
+
+  /**
+   * @brief isIdle Returns true if no job is queued or running
+   * @return
+   */
+  bool isIdle() const;
+
+  /**
+   * @brief waitForAll Runs an event loop until every job has finished
+   */
+  void waitForAll();
+
+signals:
+  void jobAdded(int id);
+  void jobChanged(int id);
+  void jobRemoved(int id);
+  void jobMessage(int id, const PipelineMessage& msg);
+  void allJobsFinished();
+  void maxConcurrentJobsChanged(int count);
+  void defaultPriorityClassChanged(ThreadBudget::PriorityClass priority);
+
+protected:
+  /**
+   * @brief addJob Adds a job for a pipeline file or for pipeline JSON and starts it if there is room
+   * @param name
+   * @param filePath
+   * @param pipelineJson
+   * @param priority
+   * @return
+   */
+  int addJob(const QString& name, const QString& filePath, const QString& pipelineJson, int priority);
+
+  /**
+   * @brief startJobs Starts the queued jobs with the highest priority while there is room
+   */
+  void startJobs();
+
+  /**
+   * @brief startJob Reads the pipeline of a job and starts it on a new thread
+   * @param id
+   */
+  void startJob(int id);
+
+  /**
+   * @brief jobFinished Collects the result of a job whose thread has finished
+   * @param id
+   */
+  void jobFinished(int id);
+
+  /**
+   * @brief processJobMessage Tracks the progress of a job from its pipeline messages
+   * @param id
+   * @param msg
+   */
+  void processJobMessage(int id, const PipelineMessage& msg);
+
+  /**
+   * @brief updateRunningJobs Refreshes the elapsed time and memory of the running jobs
+   */
+  void updateRunningJobs();
+
+private:
+  struct Runner
+  {
+    PipelineExecutor* executor = nullptr;
+    QThread* thread = nullptr;
+    QElapsedTimer timer;
+    bool canceled = false;
+  };
+
+  QMap<int, PipelineJob> m_Jobs;
+  QMap<int, QString> m_PipelineJson;
+  struct Series
+  {
+    QVector<SeriesDataset> datasets;
+    size_t memoryWindow = 0;
+  };
+
+  QMap<int, Runner> m_Runners;
+  QMap<int, Series> m_Series;
+  int m_NextId = 0;
+  int m_MaxConcurrentJobs = 1;
+  ThreadBudget::PriorityClass m_DefaultPriorityClass = ThreadBudget::PriorityClass::Background;
+  QTimer m_UpdateTimer;
+
+  PipelineJobQueue(const PipelineJobQueue&) = delete; // Copy Constructor Not Implemented
+  void operator=(const PipelineJobQueue&) = delete;   // Move assignment Not Implemented
+};
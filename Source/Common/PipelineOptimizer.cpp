@@ -0,0 +1,512 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineOptimizer.h"
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QVariant>
+
+#include "SIMPLib/FilterParameters/FilterParameter.h"
+
+#include "Common/ArrayLivenessAnalysis.h"
+
+const char* PipelineOptimizer::SideEffectsPropertyName = "SIMPLViewHasSideEffects";
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject inputSignature(const AbstractFilter::Pointer& filter)
+{
+  QJsonObject obj;
+  filter->writeFilterParameters(obj);
+
+  FilterParameterVector parameters = filter->getFilterParameters();
+  for(const FilterParameter::Pointer& parameter : parameters)
+  {
+    if(parameter->getCategory() == FilterParameter::CreatedArray)
+    {
+      obj.remove(parameter->getPropertyName());
+    }
+  }
+  return obj;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int findCreatedArrayByName(const QVector<DataArrayPath>& created, const QString& name)
+{
+  int found = -1;
+  for(int i = 0; i < created.size(); i++)
+  {
+    if(created[i].getDataArrayName() == name)
+    {
+      if(found >= 0)
+      {
+        return -1; // Ambiguous
+      }
+      found = i;
+    }
+  }
+  return found;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool anyOverlap(const QVector<DataArrayPath>& a, const QVector<DataArrayPath>& b)
+{
+  for(const DataArrayPath& pathA : a)
+  {
+    for(const DataArrayPath& pathB : b)
+    {
+      if(PipelineDataFlowGraph::PathsOverlap(pathA, pathB))
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineOptimizer::PipelineOptimizer() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineOptimizer::PipelineOptimizer(const PipelineDataFlowGraph& graph)
+: m_Graph(graph)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineOptimizer::~PipelineOptimizer() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineOptimizer::SetHasSideEffects(const AbstractFilter::Pointer& filter, bool sideEffects)
+{
+  filter->setProperty(SideEffectsPropertyName, sideEffects);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineOptimizer::GetHasSideEffects(const AbstractFilter::Pointer& filter)
+{
+  return filter->property(SideEffectsPropertyName).toBool();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineOptimizer::setEliminateDeadFilters(bool eliminate)
+{
+  m_EliminateDeadFilters = eliminate;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineOptimizer::getEliminateDeadFilters() const
+{
+  return m_EliminateDeadFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineOptimizer::setReuseDuplicateFilters(bool reuse)
+{
+  m_ReuseDuplicateFilters = reuse;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineOptimizer::getReuseDuplicateFilters() const
+{
+  return m_ReuseDuplicateFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const PipelineDataFlowGraph& PipelineOptimizer::getGraph() const
+{
+  return m_Graph;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineOptimizer::isEliminated(int node) const
+{
+  return node >= 0 && node < m_Eliminated.size() && m_Eliminated[node];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineOptimizer::isReused(int node) const
+{
+  return node >= 0 && node < m_ReuseSource.size() && m_ReuseSource[node] >= 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineOptimizer::reuseSource(int node) const
+{
+  return isReused(node) ? m_ReuseSource[node] : -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineOptimizer::AliasList PipelineOptimizer::aliases(int node) const
+{
+  if(!isReused(node))
+  {
+    return AliasList();
+  }
+  return m_Aliases[node];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineOptimizer::hasSideEffects(int node) const
+{
+  AbstractFilter::Pointer filter = m_Graph.filter(node);
+  const FilterDataFootprint& footprint = m_Graph.footprint(node);
+  return GetHasSideEffects(filter) || ArrayLivenessAnalysis::IsWriterFilter(filter) || footprint.barrier || footprint.writes.isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineOptimizer::optimize()
+{
+  int count = m_Graph.size();
+  m_Eliminated.fill(false, count);
+  m_ReuseSource.fill(-1, count);
+  m_Aliases.fill(AliasList(), count);
+
+  // Most filters name their created arrays with plain strings, so the preflight is what tells us the full paths
+  if(!m_Graph.isResolved())
+  {
+    m_Graph.resolveCreatedArrays();
+  }
+
+  if(m_ReuseDuplicateFilters)
+  {
+    reuseDuplicateFilters();
+  }
+  if(m_EliminateDeadFilters)
+  {
+    eliminateDeadFilters();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineOptimizer::matchDuplicate(int earlier, int later, AliasList& aliases) const
+{
+  AbstractFilter::Pointer source = m_Graph.filter(earlier);
+  AbstractFilter::Pointer target = m_Graph.filter(later);
+
+  QVector<DataArrayPath> sourceCreated = m_Graph.createdArrays(earlier);
+  QVector<DataArrayPath> targetCreated = m_Graph.createdArrays(later);
+  if(sourceCreated.isEmpty() || sourceCreated.size() != targetCreated.size())
+  {
+    return false;
+  }
+
+  // Pair the created arrays through the CreatedArray parameters, which are the only ones allowed to differ
+  aliases.clear();
+  FilterParameterVector parameters = source->getFilterParameters();
+  for(const FilterParameter::Pointer& parameter : parameters)
+  {
+    if(parameter->getCategory() != FilterParameter::CreatedArray)
+    {
+      continue;
+    }
+
+    QByteArray propertyName = parameter->getPropertyName().toLatin1();
+    QVariant sourceVar = source->property(propertyName.constData());
+    QVariant targetVar = target->property(propertyName.constData());
+
+    QVector<QString> sourceNames;
+    QVector<QString> targetNames;
+    if(sourceVar.userType() == qMetaTypeId<DataArrayPath>())
+    {
+      sourceNames.push_back(sourceVar.value<DataArrayPath>().getDataArrayName());
+      targetNames.push_back(targetVar.value<DataArrayPath>().getDataArrayName());
+    }
+    else if(sourceVar.userType() == qMetaTypeId<QVector<DataArrayPath>>())
+    {
+      for(const DataArrayPath& path : sourceVar.value<QVector<DataArrayPath>>())
+      {
+        sourceNames.push_back(path.getDataArrayName());
+      }
+      for(const DataArrayPath& path : targetVar.value<QVector<DataArrayPath>>())
+      {
+        targetNames.push_back(path.getDataArrayName());
+      }
+    }
+    else if(sourceVar.type() == QVariant::String)
+    {
+      sourceNames.push_back(sourceVar.toString());
+      targetNames.push_back(targetVar.toString());
+    }
+    else
+    {
+      return false;
+    }
+
+    if(sourceNames.size() != targetNames.size())
+    {
+      return false;
+    }
+    for(int n = 0; n < sourceNames.size(); n++)
+    {
+      // Container or AttributeMatrix names do not resolve to a single created array
+      int sourceIndex = findCreatedArrayByName(sourceCreated, sourceNames[n]);
+      int targetIndex = findCreatedArrayByName(targetCreated, targetNames[n]);
+      if(sourceIndex < 0 || targetIndex < 0)
+      {
+        return false;
+      }
+      aliases.push_back(qMakePair(sourceCreated[sourceIndex], targetCreated[targetIndex]));
+    }
+  }
+
+  if(aliases.size() != sourceCreated.size())
+  {
+    return false;
+  }
+
+  // Nothing in between may change the inputs or touch the outputs of the earlier filter
+  const QVector<DataArrayPath>& inputs = m_Graph.footprint(earlier).reads;
+  for(int k = earlier + 1; k < later; k++)
+  {
+    const FilterDataFootprint& footprint = m_Graph.footprint(k);
+    if(footprint.barrier || anyOverlap(footprint.writes, inputs) || anyOverlap(footprint.writes, sourceCreated) || anyOverlap(footprint.reads, sourceCreated))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineOptimizer::reuseDuplicateFilters()
+{
+  int count = m_Graph.size();
+  QVector<QJsonObject> signatures(count);
+  for(int i = 0; i < count; i++)
+  {
+    signatures[i] = inputSignature(m_Graph.filter(i));
+  }
+
+  for(int later = 0; later < count; later++)
+  {
+    if(hasSideEffects(later))
+    {
+      continue;
+    }
+    QString className = m_Graph.filter(later)->getNameOfClass();
+    for(int earlier = 0; earlier < later; earlier++)
+    {
+      if(hasSideEffects(earlier) || isReused(earlier) || m_Graph.filter(earlier)->getNameOfClass() != className || signatures[earlier] != signatures[later])
+      {
+        continue;
+      }
+
+      AliasList aliases;
+      if(matchDuplicate(earlier, later, aliases))
+      {
+        m_ReuseSource[later] = earlier;
+        m_Aliases[later] = aliases;
+
+        QVector<DataArrayPath> sourcePaths;
+        for(const QPair<DataArrayPath, DataArrayPath>& alias : aliases)
+        {
+          sourcePaths.push_back(alias.first);
+        }
+        m_Graph.addReads(later, sourcePaths);
+        break;
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineOptimizer::eliminateDeadFilters()
+{
+  int count = m_Graph.size();
+  QVector<bool> needed(count, false);
+  for(int i = 0; i < count; i++)
+  {
+    needed[i] = (i == count - 1) || hasSideEffects(i);
+  }
+
+  for(int j = count - 1; j >= 0; j--)
+  {
+    if(!needed[j])
+    {
+      continue;
+    }
+    if(m_Graph.footprint(j).barrier)
+    {
+      // A barrier may read anything that was created before it
+      for(int i = 0; i < j; i++)
+      {
+        needed[i] = true;
+      }
+      break;
+    }
+    // Creating an array inside a container or AttributeMatrix also needs the filter that created the parent
+    const FilterDataFootprint& footprint = m_Graph.footprint(j);
+    for(int i = 0; i < j; i++)
+    {
+      const QVector<DataArrayPath>& writes = m_Graph.footprint(i).writes;
+      if(anyOverlap(writes, footprint.reads) || anyOverlap(writes, footprint.writes))
+      {
+        needed[i] = true;
+      }
+    }
+  }
+
+  for(int i = 0; i < count; i++)
+  {
+    if(!needed[i])
+    {
+      m_Eliminated[i] = true;
+      m_ReuseSource[i] = -1;
+      m_Aliases[i].clear();
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<OptimizationChange> PipelineOptimizer::getChanges() const
+{
+  QVector<OptimizationChange> changes;
+  for(int i = 0; i < m_Eliminated.size(); i++)
+  {
+    AbstractFilter::Pointer filter = m_Graph.filter(i);
+    if(m_Eliminated[i])
+    {
+      OptimizationChange change;
+      change.type = OptimizationChange::Type::Eliminated;
+      change.node = i;
+      change.filterHumanLabel = filter->getHumanLabel();
+
+      QStringList outputs;
+      for(const DataArrayPath& path : m_Graph.footprint(i).writes)
+      {
+        outputs << path.serialize("/");
+      }
+      change.description = QObject::tr("Skipped [%1] %2: its outputs (%3) never reach an output filter or the end of the pipeline")
+                               .arg(i + 1)
+                               .arg(change.filterHumanLabel)
+                               .arg(outputs.join(", "));
+      changes.push_back(change);
+    }
+    else if(m_ReuseSource[i] >= 0)
+    {
+      OptimizationChange change;
+      change.type = OptimizationChange::Type::Reused;
+      change.node = i;
+      change.sourceNode = m_ReuseSource[i];
+      change.filterHumanLabel = filter->getHumanLabel();
+      change.aliases = m_Aliases[i];
+
+      QStringList copies;
+      for(const QPair<DataArrayPath, DataArrayPath>& alias : change.aliases)
+      {
+        copies << QString("%1 -> %2").arg(alias.first.serialize("/")).arg(alias.second.serialize("/"));
+      }
+      change.description = QObject::tr("Reused [%1] %2: identical to [%3], outputs copied (%4)")
+                               .arg(i + 1)
+                               .arg(change.filterHumanLabel)
+                               .arg(change.sourceNode + 1)
+                               .arg(copies.join(", "));
+      changes.push_back(change);
+    }
+  }
+  return changes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList PipelineOptimizer::report() const
+{
+  QStringList lines;
+  QVector<OptimizationChange> changes = getChanges();
+  for(const OptimizationChange& change : changes)
+  {
+    lines << change.description;
+  }
+  if(lines.isEmpty())
+  {
+    lines << QObject::tr("Pipeline optimizer: no changes");
+  }
+  else
+  {
+    lines.prepend(QObject::tr("Pipeline optimizer: %1 changes").arg(changes.size()));
+  }
+  return lines;
+}
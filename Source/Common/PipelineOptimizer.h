@@ -0,0 +1,183 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QPair>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+#include "Common/PipelineDataFlowGraph.h"
+
+/**
+ * @brief The OptimizationChange struct describes a single change the PipelineOptimizer made to a pipeline
+ */
+struct OptimizationChange
+{
+  enum class Type : unsigned int
+  {
+    Eliminated,
+    Reused
+  };
+
+  Type type = Type::Eliminated;
+  int node = -1;
+  int sourceNode = -1;
+  QString filterHumanLabel;
+  QString description;
+  QVector<QPair<DataArrayPath, DataArrayPath>> aliases;
+};
+
+/**
+ * @brief The PipelineOptimizer class runs optimization passes over the PipelineDataFlowGraph of a pipeline
+ * before it is executed.
+ *
+ * Duplicate filter reuse: a filter with the same class and the same parameters (except the names of the
+ * arrays it creates) as an earlier filter, whose inputs and the earlier filter's outputs are untouched in
+ * between, is not executed. Its outputs are copied from the outputs of the earlier filter instead.
+ *
+ * Dead filter elimination: a filter is skipped when none of its outputs can reach a filter with side
+ * effects or the final filter of the pipeline. Output (writer) filters, barriers, filters that create
+ * nothing and filters flagged with SetHasSideEffects() are never eliminated.
+ */
+class PipelineOptimizer
+{
+public:
+  using AliasList = QVector<QPair<DataArrayPath, DataArrayPath>>;
+
+  PipelineOptimizer();
+  explicit PipelineOptimizer(const PipelineDataFlowGraph& graph);
+  virtual ~PipelineOptimizer();
+
+  /**
+   * @brief SideEffectsPropertyName The name of the dynamic property that holds the per filter
+   * "side effects, never eliminate" flag
+   */
+  static const char* SideEffectsPropertyName;
+
+  /**
+   * @brief SetHasSideEffects Flags a filter so the optimizer never eliminates or reuses it. The flag is
+   * saved with the pipeline by PipelineFileSettings.
+   * @param filter
+   * @param sideEffects
+   */
+  static void SetHasSideEffects(const AbstractFilter::Pointer& filter, bool sideEffects);
+
+  /**
+   * @brief GetHasSideEffects Returns the value of the flag set with SetHasSideEffects()
+   * @param filter
+   * @return
+   */
+  static bool GetHasSideEffects(const AbstractFilter::Pointer& filter);
+
+  void setEliminateDeadFilters(bool eliminate);
+  bool getEliminateDeadFilters() const;
+
+  void setReuseDuplicateFilters(bool reuse);
+  bool getReuseDuplicateFilters() const;
+
+  /**
+   * @brief optimize Runs the enabled passes. This preflights the filters of the graph unless its created arrays
+   * are already resolved.
+   */
+  void optimize();
+
+  /**
+   * @brief getGraph Returns the graph after optimization. Reused filters read the outputs they are copied from.
+   * @return
+   */
+  const PipelineDataFlowGraph& getGraph() const;
+
+  bool isEliminated(int node) const;
+  bool isReused(int node) const;
+
+  /**
+   * @brief reuseSource Returns the node whose outputs a reused filter copies or -1
+   * @param node
+   * @return
+   */
+  int reuseSource(int node) const;
+
+  /**
+   * @brief aliases Returns the (source, target) array pairs that a reused filter copies instead of executing
+   * @param node
+   * @return
+   */
+  AliasList aliases(int node) const;
+
+  /**
+   * @brief getChanges Returns every change in pipeline order
+   * @return
+   */
+  QVector<OptimizationChange> getChanges() const;
+
+  /**
+   * @brief report Returns one human readable line per change
+   * @return
+   */
+  QStringList report() const;
+
+protected:
+  /**
+   * @brief hasSideEffects Returns true if the filter at 'node' must never be eliminated or reused
+   * @param node
+   * @return
+   */
+  bool hasSideEffects(int node) const;
+
+  /**
+   * @brief matchDuplicate Returns true if 'later' may reuse the outputs of 'earlier' and fills in the aliases
+   * @param earlier
+   * @param later
+   * @param aliases
+   * @return
+   */
+  bool matchDuplicate(int earlier, int later, AliasList& aliases) const;
+
+  void reuseDuplicateFilters();
+  void eliminateDeadFilters();
+
+private:
+  PipelineDataFlowGraph m_Graph;
+  bool m_EliminateDeadFilters = true;
+  bool m_ReuseDuplicateFilters = true;
+
+  QVector<bool> m_Eliminated;
+  QVector<int> m_ReuseSource;
+  QVector<AliasList> m_Aliases;
+};
@@ -0,0 +1,322 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PreviewReduction.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QObject>
+#include <QtCore/QRegularExpression>
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "Common/ArrayLivenessAnalysis.h"
+#include "Common/ArrayMemoryPool.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PreviewReduction::PreviewReduction() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PreviewReduction::~PreviewReduction() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PreviewReduction PreviewReduction::Downsample(int factor)
+{
+  PreviewReduction reduction;
+  if(factor > 1)
+  {
+    reduction.m_Mode = Mode::Downsample;
+    reduction.m_Factor = factor;
+  }
+  return reduction;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PreviewReduction PreviewReduction::Crop(const size_t min[3], const size_t max[3])
+{
+  PreviewReduction reduction;
+  reduction.m_Mode = Mode::Crop;
+  for(int axis = 0; axis < 3; axis++)
+  {
+    reduction.m_Min[axis] = std::min(min[axis], max[axis]);
+    reduction.m_Max[axis] = std::max(min[axis], max[axis]);
+  }
+  return reduction;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PreviewReduction PreviewReduction::FromString(const QString& text, bool* ok)
+{
+  if(ok != nullptr)
+  {
+    *ok = true;
+  }
+
+  QStringList tokens = text.trimmed().split(QRegularExpression("[\\s,]+"), QString::SkipEmptyParts);
+  if(tokens.isEmpty() || tokens[0].compare("none", Qt::CaseInsensitive) == 0)
+  {
+    return PreviewReduction();
+  }
+
+  bool valid = false;
+  if(tokens[0].compare("downsample", Qt::CaseInsensitive) == 0 && tokens.size() == 2)
+  {
+    int factor = tokens[1].toInt(&valid);
+    if(valid && factor >= 1)
+    {
+      return Downsample(factor);
+    }
+  }
+  else if(tokens[0].compare("crop", Qt::CaseInsensitive) == 0 && tokens.size() == 7)
+  {
+    size_t min[3] = {0, 0, 0};
+    size_t max[3] = {0, 0, 0};
+    valid = true;
+    for(int axis = 0; axis < 3 && valid; axis++)
+    {
+      bool minOk = false;
+      bool maxOk = false;
+      min[axis] = tokens[1 + axis].toULongLong(&minOk);
+      max[axis] = tokens[4 + axis].toULongLong(&maxOk);
+      valid = minOk && maxOk;
+    }
+    if(valid)
+    {
+      return Crop(min, max);
+    }
+  }
+
+  if(ok != nullptr)
+  {
+    *ok = false;
+  }
+  return PreviewReduction();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PreviewReduction::toString() const
+{
+  switch(m_Mode)
+  {
+  case Mode::Downsample:
+    return QString("downsample %1").arg(m_Factor);
+  case Mode::Crop:
+    return QString("crop %1,%2,%3,%4,%5,%6").arg(m_Min[0]).arg(m_Min[1]).arg(m_Min[2]).arg(m_Max[0]).arg(m_Max[1]).arg(m_Max[2]);
+  default:
+    return QString("none");
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PreviewReduction::IsReaderFilter(const AbstractFilter::Pointer& filter)
+{
+  return filter->getSubGroupName() == SIMPL::FilterSubGroups::InputFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PreviewReduction::Mode PreviewReduction::getMode() const
+{
+  return m_Mode;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PreviewReduction::isEnabled() const
+{
+  return m_Mode != Mode::None;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PreviewReduction::getFactor() const
+{
+  return m_Factor;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t PreviewReduction::reduce(const DataContainerArray::Pointer& dca, const QStringList& containerNames, QStringList* notes) const
+{
+  if(m_Mode == Mode::None || dca.get() == nullptr)
+  {
+    return 0;
+  }
+
+  size_t bytesBefore = ArrayLivenessAnalysis::TotalArrayBytes(dca);
+
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    ImageGeom::Pointer geom = dc->getGeometryAs<ImageGeom>();
+    if(geom.get() == nullptr || (!containerNames.isEmpty() && !containerNames.contains(dc->getName())))
+    {
+      continue;
+    }
+
+    size_t dims[3] = {0, 0, 0};
+    float res[3] = {0.0f, 0.0f, 0.0f};
+    float origin[3] = {0.0f, 0.0f, 0.0f};
+    geom->getDimensions(dims);
+    geom->getResolution(res);
+    geom->getOrigin(origin);
+    if(dims[0] == 0 || dims[1] == 0 || dims[2] == 0)
+    {
+      continue;
+    }
+
+    // Voxel i along an axis of the reduced volume is voxel start + i * step of the full one
+    size_t start[3] = {0, 0, 0};
+    size_t step[3] = {1, 1, 1};
+    size_t reduced[3] = {dims[0], dims[1], dims[2]};
+    for(int axis = 0; axis < 3; axis++)
+    {
+      if(m_Mode == Mode::Downsample)
+      {
+        step[axis] = static_cast<size_t>(m_Factor);
+        reduced[axis] = (dims[axis] + step[axis] - 1) / step[axis];
+      }
+      else
+      {
+        size_t last = std::min(m_Max[axis], dims[axis] - 1);
+        start[axis] = std::min(m_Min[axis], last);
+        reduced[axis] = last - start[axis] + 1;
+      }
+    }
+    if(reduced[0] == dims[0] && reduced[1] == dims[1] && reduced[2] == dims[2])
+    {
+      continue;
+    }
+
+    size_t voxels = dims[0] * dims[1] * dims[2];
+    size_t reducedVoxels = reduced[0] * reduced[1] * reduced[2];
+
+    DataContainer::AttributeMatrixMap_t matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      if(am->getType() != AttributeMatrix::Type::Cell || am->getNumberOfTuples() != voxels)
+      {
+        continue;
+      }
+
+      QVector<size_t> tDims = {reduced[0], reduced[1], reduced[2]};
+      AttributeMatrix::Pointer reducedAm = AttributeMatrix::New(tDims, am->getName(), am->getType());
+
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        IDataArray::Pointer array = am->getAttributeArray(name);
+        const char* source = static_cast<const char*>(array->getVoidPointer(0));
+        if(source == nullptr || array->getNumberOfTuples() != voxels)
+        {
+          if(notes != nullptr)
+          {
+            notes->push_back(QObject::tr("Removed '%1' from the preview because it cannot be reduced").arg(DataArrayPath(dc->getName(), am->getName(), name).serialize("/")));
+          }
+          continue;
+        }
+
+        IDataArray::Pointer target = ArrayMemoryPool::Instance()->createArrayLike(array, reducedVoxels, name);
+        char* destination = static_cast<char*>(target->getVoidPointer(0));
+        size_t tupleBytes = array->getNumberOfComponents() * array->getTypeSize();
+        for(size_t z = 0; z < reduced[2]; z++)
+        {
+          for(size_t y = 0; y < reduced[1]; y++)
+          {
+            size_t row = ((start[2] + z * step[2]) * dims[1] + start[1] + y * step[1]) * dims[0] + start[0];
+            if(step[0] == 1)
+            {
+              std::memcpy(destination, source + row * tupleBytes, reduced[0] * tupleBytes);
+              destination += reduced[0] * tupleBytes;
+              continue;
+            }
+            for(size_t x = 0; x < reduced[0]; x++)
+            {
+              std::memcpy(destination, source + (row + x * step[0]) * tupleBytes, tupleBytes);
+              destination += tupleBytes;
+            }
+          }
+        }
+        reducedAm->addAttributeArray(name, target);
+      }
+
+      dc->removeAttributeMatrix(am->getName());
+      dc->addAttributeMatrix(reducedAm->getName(), reducedAm);
+    }
+
+    float reducedRes[3] = {res[0] * step[0], res[1] * step[1], res[2] * step[2]};
+    float reducedOrigin[3] = {origin[0] + start[0] * res[0], origin[1] + start[1] * res[1], origin[2] + start[2] * res[2]};
+    geom->setDimensions(reduced);
+    geom->setResolution(reducedRes);
+    geom->setOrigin(reducedOrigin);
+
+    if(notes != nullptr)
+    {
+      notes->push_back(QObject::tr("Reduced '%1' from %2 x %3 x %4 to %5 x %6 x %7 voxels")
+                           .arg(dc->getName())
+                           .arg(dims[0])
+                           .arg(dims[1])
+                           .arg(dims[2])
+                           .arg(reduced[0])
+                           .arg(reduced[1])
+                           .arg(reduced[2]));
+    }
+  }
+
+  size_t bytesAfter = ArrayLivenessAnalysis::TotalArrayBytes(dca);
+  return (bytesBefore > bytesAfter) ? bytesBefore - bytesAfter : 0;
+}
@@ -0,0 +1,124 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The PreviewReduction class shrinks the volumes a pipeline reads so the rest of the pipeline can be
+ * tried out in a fraction of the time of a full run.
+ *
+ * A reduction either keeps every n-th voxel along each axis (nearest neighbor, so label arrays stay valid)
+ * or crops a box of voxels. It is applied to the output of every reader, right after the reader executes;
+ * the pipeline itself is never changed, so a later full run uses it as it is.
+ *
+ * Only Image geometries are reduced, together with the Cell attribute matrices whose tuples match the
+ * geometry. The spacing and origin are adjusted so the reduced volume covers the same physical region.
+ */
+class PreviewReduction
+{
+public:
+  enum class Mode : int
+  {
+    None = 0,
+    Downsample = 1,
+    Crop = 2
+  };
+
+  PreviewReduction();
+  virtual ~PreviewReduction();
+
+  /**
+   * @brief Downsample Returns a reduction that keeps every 'factor'-th voxel along each axis
+   * @param factor
+   * @return
+   */
+  static PreviewReduction Downsample(int factor);
+
+  /**
+   * @brief Crop Returns a reduction that keeps the voxels from 'min' to 'max', inclusive, along each axis.
+   * The box is clamped to the volume.
+   * @param min
+   * @param max
+   * @return
+   */
+  static PreviewReduction Crop(const size_t min[3], const size_t max[3]);
+
+  /**
+   * @brief FromString Parses "downsample 4", "crop 0,0,0,127,127,63" or "none"
+   * @param text
+   * @param ok Set to false if the text could not be parsed
+   * @return
+   */
+  static PreviewReduction FromString(const QString& text, bool* ok = nullptr);
+
+  /**
+   * @brief toString Returns the reduction in the form FromString() reads
+   * @return
+   */
+  QString toString() const;
+
+  /**
+   * @brief IsReaderFilter Returns true if the output of 'filter' is reduced in a preview
+   * @param filter
+   * @return
+   */
+  static bool IsReaderFilter(const AbstractFilter::Pointer& filter);
+
+  Mode getMode() const;
+  bool isEnabled() const;
+  int getFactor() const;
+
+  /**
+   * @brief reduce Replaces the Image geometries of 'dca' and their Cell arrays by their reduced versions.
+   * Cell arrays that cannot be copied tuple by tuple are removed.
+   * @param dca
+   * @param containerNames The Data Containers to reduce, every one if empty
+   * @param notes Receives one line for every reduced Data Container and removed array
+   * @return The number of bytes the arrays of 'dca' shrank by
+   */
+  size_t reduce(const DataContainerArray::Pointer& dca, const QStringList& containerNames = QStringList(), QStringList* notes = nullptr) const;
+
+private:
+  Mode m_Mode = Mode::None;
+  int m_Factor = 1;
+  size_t m_Min[3] = {0, 0, 0};
+  size_t m_Max[3] = {0, 0, 0};
+};
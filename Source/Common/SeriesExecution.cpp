@@ -0,0 +1,811 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "SeriesExecution.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+#include <QtCore/QTextStream>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVariant>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/JsonFilterParametersWriter.h"
+
+#include "Common/ArrayLivenessAnalysis.h"
+#include "Common/HDF5Lock.h"
+#include "Common/IncrementalFileWriter.h"
+
+namespace
+{
+const QString InputFileProperty("InputFile");
+const QString OutputFileProperty("OutputFile");
+
+QList<AbstractFilter::Pointer> EnabledFilters(const FilterPipeline::Pointer& pipeline)
+{
+  QList<AbstractFilter::Pointer> filters;
+  FilterPipeline::FilterContainerType container = pipeline->getFilterContainer();
+  for(const AbstractFilter::Pointer& filter : container)
+  {
+    if(filter->getEnabled())
+    {
+      filters.push_back(filter);
+    }
+  }
+  return filters;
+}
+
+int ReadStageEnd(const QList<AbstractFilter::Pointer>& filters)
+{
+  int end = 0;
+  while(end < filters.size() && filters[end]->getSubGroupName() == SIMPL::FilterSubGroups::InputFilters)
+  {
+    end++;
+  }
+  return end;
+}
+
+int WriteStageBegin(const QList<AbstractFilter::Pointer>& filters, int readEnd)
+{
+  int begin = filters.size();
+  while(begin > readEnd && ArrayLivenessAnalysis::IsWriterFilter(filters[begin - 1]))
+  {
+    begin--;
+  }
+  return begin;
+}
+
+double Megabytes(size_t bytes)
+{
+  return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SeriesExecution::SeriesExecution(FilterPipeline::Pointer pipeline)
+: m_Pipeline(pipeline)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SeriesExecution::~SeriesExecution() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<SeriesDataset> SeriesExecution::ReadDatasetList(const QString& filePath, bool* ok)
+{
+  QVector<SeriesDataset> datasets;
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    if(ok != nullptr)
+    {
+      *ok = false;
+    }
+    return datasets;
+  }
+
+  QDir listDir = QFileInfo(filePath).absoluteDir();
+  QTextStream in(&file);
+  while(!in.atEnd())
+  {
+    QString line = in.readLine().trimmed();
+    if(line.isEmpty() || line.startsWith('#'))
+    {
+      continue;
+    }
+
+    QStringList fields = line.split('\t', QString::SkipEmptyParts);
+    SeriesDataset dataset;
+    dataset.inputFile = QDir::cleanPath(listDir.absoluteFilePath(fields[0].trimmed()));
+    if(fields.size() > 1)
+    {
+      dataset.outputFile = QDir::cleanPath(listDir.absoluteFilePath(fields[1].trimmed()));
+    }
+    datasets.push_back(dataset);
+  }
+
+  if(ok != nullptr)
+  {
+    *ok = true;
+  }
+  return datasets;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<SeriesDataset> SeriesExecution::DatasetsFor(const QStringList& inputFiles, const QString& outputDirectory)
+{
+  QVector<SeriesDataset> datasets;
+  QDir outputDir(outputDirectory);
+  for(const QString& inputFile : inputFiles)
+  {
+    SeriesDataset dataset;
+    dataset.inputFile = inputFile;
+    dataset.outputFile = outputDir.absoluteFilePath(QFileInfo(inputFile).completeBaseName() + ".dream3d");
+    datasets.push_back(dataset);
+  }
+  return datasets;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::setDatasets(const QVector<SeriesDataset>& datasets)
+{
+  m_Datasets = datasets;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<SeriesDataset> SeriesExecution::getDatasets() const
+{
+  return m_Datasets;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::setMemoryWindow(size_t bytes)
+{
+  m_MemoryWindow = bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t SeriesExecution::getMemoryWindow() const
+{
+  return m_MemoryWindow;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::setMessageHandler(const MessageHandler& handler)
+{
+  m_MessageHandler = handler;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::setResidentBytesHandler(const BytesHandler& handler)
+{
+  m_ResidentBytesHandler = handler;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::setFilterWrapper(const FilterWrapper& wrapper)
+{
+  m_FilterWrapper = wrapper;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::setWriteProfile(WriteProfile::Preset preset)
+{
+  m_WriteProfile = preset;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::setIncrementalWrites(bool incremental)
+{
+  m_IncrementalWrites = incremental;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<SeriesStageStats> SeriesExecution::getStageStats() const
+{
+  return m_Stats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SeriesExecution::getCompletedDatasets() const
+{
+  return m_CompletedDatasets;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t SeriesExecution::getPeakResidentBytes() const
+{
+  return m_PeakResidentBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 SeriesExecution::getElapsedMsecs() const
+{
+  return m_ElapsedMsecs;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SeriesExecution::execute()
+{
+  m_Loaded.clear();
+  m_Computed.clear();
+  m_InFlight.clear();
+  m_ReadDone = false;
+  m_ComputeDone = false;
+  m_ErrorCondition = 0;
+  {
+    // A cancel that arrives before execute() still stops it
+    QMutexLocker locker(&m_Mutex);
+    m_Stop = m_Canceled;
+  }
+  m_ResidentBytes = 0;
+  m_LargestDatasetBytes = 0;
+  m_PeakResidentBytes = 0;
+  m_StagesCompleted = 0;
+  m_CompletedDatasets = 0;
+  m_ElapsedMsecs = 0;
+  m_Stats.fill(SeriesStageStats(), StageCount);
+  m_Stats[static_cast<int>(Stage::Read)].name = QObject::tr("Read");
+  m_Stats[static_cast<int>(Stage::Compute)].name = QObject::tr("Compute");
+  m_Stats[static_cast<int>(Stage::Write)].name = QObject::tr("Write");
+
+  if(m_Datasets.isEmpty())
+  {
+    return 0;
+  }
+
+  QList<AbstractFilter::Pointer> filters = EnabledFilters(m_Pipeline);
+  int readEnd = ReadStageEnd(filters);
+  int writeBegin = WriteStageBegin(filters, readEnd);
+  if(readEnd == 0 || writeBegin == filters.size())
+  {
+    notify(PipelineMessage::MessageType::Error, AbstractFilter::NullPointer(),
+           QObject::tr("Series execution needs a pipeline that starts with a reader and ends with a writer"), RefusedError);
+    return RefusedError;
+  }
+  m_WriterProfiles.clear();
+  for(const AbstractFilter::Pointer& filter : filters)
+  {
+    m_WriterProfiles.push_back(WriteProfile::ForWriter(filter, m_WriteProfile));
+  }
+
+  JsonFilterParametersWriter::Pointer jsonWriter = JsonFilterParametersWriter::New();
+  m_PipelineJson = jsonWriter->writePipelineToString(m_Pipeline, m_Pipeline->getName());
+
+  notify(PipelineMessage::MessageType::StandardOutputMessage, AbstractFilter::NullPointer(),
+         QObject::tr("Executing a series of %1 datasets: %2 read, %3 compute and %4 write filters, memory window %5")
+             .arg(m_Datasets.size())
+             .arg(readEnd)
+             .arg(writeBegin - readEnd)
+             .arg(filters.size() - writeBegin)
+             .arg(m_MemoryWindow > 0 ? QObject::tr("%1 MB").arg(Megabytes(m_MemoryWindow), 0, 'f', 0) : QObject::tr("unlimited")));
+
+  QElapsedTimer timer;
+  timer.start();
+
+  QThreadPool stagePool;
+  stagePool.setMaxThreadCount(StageCount);
+  QFuture<void> read = QtConcurrent::run(&stagePool, [this] { readStage(); });
+  QFuture<void> compute = QtConcurrent::run(&stagePool, [this] { computeStage(); });
+  QFuture<void> write = QtConcurrent::run(&stagePool, [this] { writeStage(); });
+  read.waitForFinished();
+  compute.waitForFinished();
+  write.waitForFinished();
+
+  m_ElapsedMsecs = timer.elapsed();
+  m_Loaded.clear();
+  m_Computed.clear();
+  m_InFlight.clear();
+
+  if(m_ErrorCondition >= 0 && !m_Canceled)
+  {
+    QStringList lines = report();
+    for(const QString& line : lines)
+    {
+      notify(PipelineMessage::MessageType::StandardOutputMessage, AbstractFilter::NullPointer(), line);
+    }
+  }
+  return m_ErrorCondition;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::cancel()
+{
+  QMutexLocker locker(&m_Mutex);
+  m_Canceled = true;
+  m_Stop = true;
+  for(const FilterPipeline::Pointer& pipeline : m_InFlight)
+  {
+    QList<AbstractFilter::Pointer> filters = EnabledFilters(pipeline);
+    for(const AbstractFilter::Pointer& filter : filters)
+    {
+      filter->setCancel(true);
+    }
+  }
+  m_Changed.wakeAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SeriesExecution::prepareSlot(int index, Slot& slot)
+{
+  const SeriesDataset& dataset = m_Datasets[index];
+  JsonFilterParametersReader::Pointer jsonReader = JsonFilterParametersReader::New();
+  slot.index = index;
+  slot.pipeline = jsonReader->readPipelineFromString(m_PipelineJson);
+  if(slot.pipeline.get() == nullptr)
+  {
+    notify(PipelineMessage::MessageType::Error, AbstractFilter::NullPointer(), datasetPrefix(index) + QObject::tr("The pipeline could not be copied"), DatasetError);
+    return DatasetError;
+  }
+
+  slot.filters = EnabledFilters(slot.pipeline);
+  slot.readEnd = ReadStageEnd(slot.filters);
+  slot.writeBegin = WriteStageBegin(slot.filters, slot.readEnd);
+
+  AbstractFilter::Pointer reader;
+  for(int i = 0; i < slot.readEnd && reader.get() == nullptr; i++)
+  {
+    if(slot.filters[i]->property(InputFileProperty.toLatin1().constData()).isValid())
+    {
+      reader = slot.filters[i];
+    }
+  }
+  AbstractFilter::Pointer writer;
+  for(int i = slot.filters.size() - 1; i >= slot.writeBegin && writer.get() == nullptr; i--)
+  {
+    if(slot.filters[i]->property(OutputFileProperty.toLatin1().constData()).isValid())
+    {
+      writer = slot.filters[i];
+    }
+  }
+  if(reader.get() == nullptr || writer.get() == nullptr)
+  {
+    notify(PipelineMessage::MessageType::Error, AbstractFilter::NullPointer(),
+           QObject::tr("Series execution needs a reader with an input file and a writer with an output file"), RefusedError);
+    return RefusedError;
+  }
+
+  QString outputFile = dataset.outputFile;
+  if(outputFile.isEmpty())
+  {
+    QFileInfo pipelineOutput(writer->property(OutputFileProperty.toLatin1().constData()).toString());
+    outputFile = pipelineOutput.absoluteDir().absoluteFilePath(QFileInfo(dataset.inputFile).completeBaseName() + "." + pipelineOutput.suffix());
+  }
+  reader->setProperty(InputFileProperty.toLatin1().constData(), dataset.inputFile);
+  writer->setProperty(OutputFileProperty.toLatin1().constData(), outputFile);
+
+  for(const AbstractFilter::Pointer& filter : slot.filters)
+  {
+    QObject::connect(filter.get(), &AbstractFilter::filterGeneratedMessage, [this, index](const PipelineMessage& msg) {
+      // The series reports its own progress across every dataset
+      if(msg.getType() == PipelineMessage::MessageType::ProgressValue)
+      {
+        return;
+      }
+      PipelineMessage prefixed = msg;
+      if(msg.getType() == PipelineMessage::MessageType::StatusMessage)
+      {
+        prefixed.setText(datasetPrefix(index) + msg.getText());
+      }
+      deliver(prefixed);
+    });
+  }
+
+  {
+    QMutexLocker ioLocker(HDF5Lock::Mutex());
+    int err = slot.pipeline->preflightPipeline();
+    if(err < 0)
+    {
+      return err;
+    }
+  }
+
+  slot.dca = DataContainerArray::New();
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SeriesExecution::runFilters(Slot& slot, int begin, int end)
+{
+  for(int i = begin; i < end; i++)
+  {
+    AbstractFilter::Pointer filter = slot.filters[i];
+    if(filter->getCancel())
+    {
+      return 0;
+    }
+    filter->setDataContainerArray(slot.dca);
+    filter->setErrorCondition(0);
+    filter->setWarningCondition(0);
+    if(m_FilterWrapper)
+    {
+      m_FilterWrapper([&filter] { filter->execute(); });
+    }
+    else
+    {
+      filter->execute();
+    }
+    if(filter->getErrorCondition() < 0)
+    {
+      return filter->getErrorCondition();
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::readStage()
+{
+  SeriesStageStats& stats = m_Stats[static_cast<int>(Stage::Read)];
+  QElapsedTimer timer;
+  for(int index = 0; index < m_Datasets.size(); index++)
+  {
+    timer.start();
+    {
+      QMutexLocker locker(&m_Mutex);
+      while(!m_Stop && !m_InFlight.isEmpty()
+            && (m_InFlight.size() >= MaxDatasetsInFlight || (m_MemoryWindow > 0 && m_ResidentBytes + m_LargestDatasetBytes > m_MemoryWindow)))
+      {
+        m_Changed.wait(&m_Mutex);
+      }
+      if(m_Stop)
+      {
+        break;
+      }
+    }
+    stats.blockedMsecs += timer.restart();
+
+    Slot slot;
+    int err = prepareSlot(index, slot);
+    stats.busyMsecs += timer.restart();
+    {
+      QMutexLocker locker(&m_Mutex);
+      if(slot.pipeline.get() != nullptr)
+      {
+        m_InFlight.push_back(slot.pipeline);
+      }
+      if(m_Canceled)
+      {
+        break;
+      }
+    }
+    if(err >= 0)
+    {
+      QMutexLocker ioLocker(HDF5Lock::Mutex());
+      stats.blockedMsecs += timer.restart();
+      notify(PipelineMessage::MessageType::StatusMessage, AbstractFilter::NullPointer(), datasetPrefix(index) + QObject::tr("Reading %1").arg(m_Datasets[index].inputFile));
+      err = runFilters(slot, 0, slot.readEnd);
+    }
+    stats.busyMsecs += timer.elapsed();
+    if(err < 0)
+    {
+      fail(err);
+      break;
+    }
+
+    slot.bytes = ArrayLivenessAnalysis::TotalArrayBytes(slot.dca);
+    QMutexLocker locker(&m_Mutex);
+    stats.datasets++;
+    m_StagesCompleted++;
+    m_LargestDatasetBytes = std::max(m_LargestDatasetBytes, slot.bytes);
+    changeResidentBytes(static_cast<qint64>(slot.bytes));
+    m_Loaded.push_back(slot);
+    m_Changed.wakeAll();
+    locker.unlock();
+    notifyProgress();
+  }
+
+  QMutexLocker locker(&m_Mutex);
+  m_ReadDone = true;
+  m_Changed.wakeAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::computeStage()
+{
+  SeriesStageStats& stats = m_Stats[static_cast<int>(Stage::Compute)];
+  QElapsedTimer timer;
+  while(true)
+  {
+    timer.start();
+    Slot slot;
+    {
+      QMutexLocker locker(&m_Mutex);
+      while(!m_Stop && m_Loaded.isEmpty() && !m_ReadDone)
+      {
+        m_Changed.wait(&m_Mutex);
+      }
+      if(m_Stop || m_Loaded.isEmpty())
+      {
+        break;
+      }
+      slot = m_Loaded.takeFirst();
+    }
+    stats.starvedMsecs += timer.restart();
+
+    notify(PipelineMessage::MessageType::StatusMessage, AbstractFilter::NullPointer(), datasetPrefix(slot.index) + QObject::tr("Computing"));
+    int err = runFilters(slot, slot.readEnd, slot.writeBegin);
+    stats.busyMsecs += timer.elapsed();
+    if(err < 0)
+    {
+      fail(err);
+      break;
+    }
+
+    // Filters may create or remove arrays, so the dataset may have grown or shrunk
+    size_t bytes = ArrayLivenessAnalysis::TotalArrayBytes(slot.dca);
+    QMutexLocker locker(&m_Mutex);
+    stats.datasets++;
+    m_StagesCompleted++;
+    m_LargestDatasetBytes = std::max(m_LargestDatasetBytes, bytes);
+    changeResidentBytes(static_cast<qint64>(bytes) - static_cast<qint64>(slot.bytes));
+    slot.bytes = bytes;
+    m_Computed.push_back(slot);
+    m_Changed.wakeAll();
+    locker.unlock();
+    notifyProgress();
+  }
+
+  QMutexLocker locker(&m_Mutex);
+  m_ComputeDone = true;
+  m_Changed.wakeAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::writeStage()
+{
+  SeriesStageStats& stats = m_Stats[static_cast<int>(Stage::Write)];
+  QElapsedTimer timer;
+  while(true)
+  {
+    timer.start();
+    Slot slot;
+    {
+      QMutexLocker locker(&m_Mutex);
+      while(!m_Stop && m_Computed.isEmpty() && !m_ComputeDone)
+      {
+        m_Changed.wait(&m_Mutex);
+      }
+      if(m_Stop || m_Computed.isEmpty())
+      {
+        break;
+      }
+      slot = m_Computed.takeFirst();
+    }
+    stats.starvedMsecs += timer.restart();
+
+    int err = 0;
+    {
+      QMutexLocker ioLocker(HDF5Lock::Mutex());
+      stats.blockedMsecs += timer.restart();
+      notify(PipelineMessage::MessageType::StatusMessage, AbstractFilter::NullPointer(), datasetPrefix(slot.index) + QObject::tr("Writing"));
+      std::vector<std::unique_ptr<IncrementalFileWriter>> outputs;
+      for(int i = slot.writeBegin; i < slot.filters.size(); i++)
+      {
+        outputs.emplace_back(new IncrementalFileWriter(slot.filters[i], m_WriterProfiles.value(i), m_IncrementalWrites));
+        outputs.back()->stage();
+      }
+      err = runFilters(slot, slot.writeBegin, slot.filters.size());
+      for(int i = slot.writeBegin; i < slot.filters.size(); i++)
+      {
+        const AbstractFilter::Pointer& writer = slot.filters[i];
+        const std::unique_ptr<IncrementalFileWriter>& output = outputs[static_cast<size_t>(i - slot.writeBegin)];
+        QString message;
+        if(!output->finish(err >= 0, &message))
+        {
+          notify(PipelineMessage::MessageType::Warning, writer, datasetPrefix(slot.index) + message, output->getErrorCode());
+        }
+        else if(!message.isEmpty())
+        {
+          notify(PipelineMessage::MessageType::StandardOutputMessage, writer, datasetPrefix(slot.index) + message);
+        }
+      }
+    }
+    stats.busyMsecs += timer.elapsed();
+    if(err < 0)
+    {
+      fail(err);
+      break;
+    }
+
+    QMutexLocker locker(&m_Mutex);
+    stats.datasets++;
+    m_StagesCompleted++;
+    m_CompletedDatasets++;
+    changeResidentBytes(-static_cast<qint64>(slot.bytes));
+    m_InFlight.removeAll(slot.pipeline);
+    m_Changed.wakeAll();
+    locker.unlock();
+
+    // Releasing the last reference frees the arrays of the dataset
+    slot = Slot();
+    notifyProgress();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::fail(int err)
+{
+  QMutexLocker locker(&m_Mutex);
+  if(m_ErrorCondition >= 0)
+  {
+    m_ErrorCondition = err;
+  }
+  m_Stop = true;
+  m_Changed.wakeAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::changeResidentBytes(qint64 delta)
+{
+  m_ResidentBytes = static_cast<size_t>(std::max(static_cast<qint64>(m_ResidentBytes) + delta, static_cast<qint64>(0)));
+  m_PeakResidentBytes = std::max(m_PeakResidentBytes, m_ResidentBytes);
+  if(m_ResidentBytesHandler)
+  {
+    m_ResidentBytesHandler(m_ResidentBytes);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString SeriesExecution::datasetPrefix(int index) const
+{
+  return QObject::tr("[Dataset %1/%2] ").arg(index + 1).arg(m_Datasets.size());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::notify(PipelineMessage::MessageType type, const AbstractFilter::Pointer& filter, const QString& text, int code)
+{
+  PipelineMessage msg;
+  if(filter.get() != nullptr)
+  {
+    msg.setFilterClassName(filter->getNameOfClass());
+    msg.setFilterHumanLabel(filter->getHumanLabel());
+    msg.setPipelineIndex(filter->getPipelineIndex());
+  }
+  msg.setType(type);
+  msg.setCode(code);
+  msg.setText(text);
+  deliver(msg);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::deliver(const PipelineMessage& msg)
+{
+  if(!m_MessageHandler)
+  {
+    return;
+  }
+  QMutexLocker locker(&m_NotifyMutex);
+  m_MessageHandler(msg);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SeriesExecution::notifyProgress()
+{
+  int completed = 0;
+  {
+    QMutexLocker locker(&m_Mutex);
+    completed = m_StagesCompleted;
+  }
+  PipelineMessage progress;
+  progress.setType(PipelineMessage::MessageType::ProgressValue);
+  progress.setProgressValue(static_cast<int>(100.0f * static_cast<float>(completed) / static_cast<float>(StageCount * m_Datasets.size())));
+  deliver(progress);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList SeriesExecution::report() const
+{
+  QStringList lines;
+  double elapsed = std::max(static_cast<double>(m_ElapsedMsecs), 1.0);
+  lines << QObject::tr("Series of %1 datasets finished in %2 s, peak %3 MB in flight")
+               .arg(m_CompletedDatasets)
+               .arg(elapsed / 1000.0, 0, 'f', 1)
+               .arg(Megabytes(m_PeakResidentBytes), 0, 'f', 1);
+
+  qint64 busyTotal = 0;
+  int bottleneck = 0;
+  for(int i = 0; i < m_Stats.size(); i++)
+  {
+    const SeriesStageStats& stats = m_Stats[i];
+    busyTotal += stats.busyMsecs;
+    if(stats.busyMsecs > m_Stats[bottleneck].busyMsecs)
+    {
+      bottleneck = i;
+    }
+    lines << QObject::tr("  %1: %2% busy, %3% waiting for input, %4% blocked by the memory window or I/O")
+                 .arg(stats.name, -8)
+                 .arg(100.0 * static_cast<double>(stats.busyMsecs) / elapsed, 0, 'f', 0)
+                 .arg(100.0 * static_cast<double>(stats.starvedMsecs) / elapsed, 0, 'f', 0)
+                 .arg(100.0 * static_cast<double>(stats.blockedMsecs) / elapsed, 0, 'f', 0);
+  }
+  if(!m_Stats.isEmpty())
+  {
+    lines << QObject::tr("  Stages overlapped %1x, the bottleneck is the %2 stage").arg(static_cast<double>(busyTotal) / elapsed, 0, 'f', 2).arg(m_Stats[bottleneck].name.toLower());
+  }
+  return lines;
+}
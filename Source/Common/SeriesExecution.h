@@ -0,0 +1,320 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#include "SIMPLib/Common/PipelineMessage.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "Common/WriteProfile.h"
+
+/**
+ * @brief The SeriesDataset struct is one dataset of a series: the file the pipeline reads and the file it writes
+ */
+struct SeriesDataset
+{
+  QString inputFile;
+  QString outputFile;
+};
+
+/**
+ * @brief The SeriesStageStats struct records how one stage of a SeriesExecution spent its time
+ */
+struct SeriesStageStats
+{
+  QString name;
+  int datasets = 0;
+  qint64 busyMsecs = 0;
+  qint64 starvedMsecs = 0;
+  qint64 blockedMsecs = 0;
+};
+
+/**
+ * @brief The SeriesExecution class executes one pipeline for every dataset of a series with the stages of
+ * consecutive datasets overlapped: while dataset k computes, the readers of dataset k+1 prefetch it and the
+ * writers of dataset k-1 flush it.
+ *
+ * The pipeline is split into three stages. The read stage is the leading run of Input filters, the write
+ * stage is the trailing run of Output filters and the compute stage is everything in between. Each dataset
+ * gets its own copy of the pipeline in which the first reader's InputFile and the last writer's OutputFile
+ * are replaced by the paths of the dataset. Each stage runs on its own thread.
+ *
+ * At most three datasets are in flight at once. With a memory window, the read stage also waits before
+ * loading another dataset while the arrays of the datasets in flight plus the largest dataset seen so far
+ * would not fit in the window; a single dataset is always allowed, however large.
+ *
+ * Unless the HDF5 library is thread-safe, the read and write stages hold the HDF5Lock, so only one of them
+ * is inside HDF5 at a time, also with the other pipelines of the process. Computation still overlaps with
+ * either.
+ */
+class SeriesExecution
+{
+public:
+  using MessageHandler = std::function<void(const PipelineMessage&)>;
+  using BytesHandler = std::function<void(size_t)>;
+  using FilterWrapper = std::function<void(const std::function<void()>&)>;
+
+  enum class Stage : int
+  {
+    Read = 0,
+    Compute = 1,
+    Write = 2
+  };
+
+  static const int StageCount = 3;
+  static const int MaxDatasetsInFlight = 3;
+
+  static const int RefusedError = -9420;
+  static const int DatasetError = -9421;
+
+  explicit SeriesExecution(FilterPipeline::Pointer pipeline);
+  virtual ~SeriesExecution();
+
+  /**
+   * @brief ReadDatasetList Reads a series from a text file with one dataset per line: the input file,
+   * optionally followed by a tab and the output file. Empty lines and lines starting with # are skipped.
+   * Relative paths are relative to the list file.
+   * @param filePath
+   * @param ok Set to false if the file could not be read
+   * @return
+   */
+  static QVector<SeriesDataset> ReadDatasetList(const QString& filePath, bool* ok = nullptr);
+
+  /**
+   * @brief DatasetsFor Returns a series for 'inputFiles' whose outputs are written into 'outputDirectory'
+   * with the base name of the input and the extension '.dream3d'
+   * @param inputFiles
+   * @param outputDirectory
+   * @return
+   */
+  static QVector<SeriesDataset> DatasetsFor(const QStringList& inputFiles, const QString& outputDirectory);
+
+  /**
+   * @brief setDatasets Sets the datasets to run the pipeline for. A dataset without an output file writes
+   * next to the pipeline's own output file, named after its input file.
+   * @param datasets
+   */
+  void setDatasets(const QVector<SeriesDataset>& datasets);
+  QVector<SeriesDataset> getDatasets() const;
+
+  /**
+   * @brief setMemoryWindow Sets the number of bytes the arrays of the datasets in flight may use, 0 for no limit
+   * @param bytes
+   */
+  void setMemoryWindow(size_t bytes);
+  size_t getMemoryWindow() const;
+
+  /**
+   * @brief setMessageHandler Sets the function that receives every message of the execution and its filters.
+   * The handler is called from the stage threads, one message at a time.
+   * @param handler
+   */
+  void setMessageHandler(const MessageHandler& handler);
+
+  /**
+   * @brief setResidentBytesHandler Sets the function that receives the bytes held by the datasets in flight
+   * whenever that number changes. Called from the stage threads.
+   * @param handler
+   */
+  void setResidentBytesHandler(const BytesHandler& handler);
+
+  /**
+   * @brief setFilterWrapper Sets a function every filter is executed through, for example to run it inside
+   * a ThreadBudget arena. Called from the stage threads.
+   * @param wrapper
+   */
+  void setFilterWrapper(const FilterWrapper& wrapper);
+
+  /**
+   * @brief setWriteProfile Sets the profile the output files are rewritten with unless a writer has its own
+   * @param preset
+   */
+  void setWriteProfile(WriteProfile::Preset preset);
+
+  /**
+   * @brief setIncrementalWrites Enables merging the output of each dataset into its existing output file
+   * @param incremental
+   */
+  void setIncrementalWrites(bool incremental);
+
+  /**
+   * @brief execute Runs the pipeline for every dataset and blocks until the series is done, a dataset
+   * failed or the execution was canceled
+   * @return The error condition, 0 on success
+   */
+  int execute();
+
+  /**
+   * @brief cancel Cancels the filters of every dataset in flight and prevents new datasets from starting.
+   * May be called from any thread, also before execute().
+   */
+  void cancel();
+
+  /**
+   * @brief getStageStats Returns how each stage spent its time during the last execution
+   * @return
+   */
+  QVector<SeriesStageStats> getStageStats() const;
+
+  /**
+   * @brief report Returns a summary of the last execution with the utilization of every stage
+   * @return
+   */
+  QStringList report() const;
+
+  int getCompletedDatasets() const;
+  size_t getPeakResidentBytes() const;
+  qint64 getElapsedMsecs() const;
+
+protected:
+  struct Slot
+  {
+    int index = -1;
+    FilterPipeline::Pointer pipeline;
+    QList<AbstractFilter::Pointer> filters;
+    int readEnd = 0;
+    int writeBegin = 0;
+    DataContainerArray::Pointer dca;
+    size_t bytes = 0;
+  };
+
+  /**
+   * @brief prepareSlot Creates the pipeline copy of dataset 'index', substitutes its files and preflights it
+   * @param index
+   * @param slot
+   * @return The error condition, 0 on success
+   */
+  int prepareSlot(int index, Slot& slot);
+
+  /**
+   * @brief runFilters Executes the filters [begin, end) of a dataset on its DataContainerArray
+   * @param slot
+   * @param begin
+   * @param end
+   * @return The error condition, 0 on success
+   */
+  int runFilters(Slot& slot, int begin, int end);
+
+  void readStage();
+  void computeStage();
+  void writeStage();
+
+  /**
+   * @brief fail Records the first error and stops every stage
+   * @param err
+   */
+  void fail(int err);
+
+  /**
+   * @brief changeResidentBytes Adds 'delta' bytes to the datasets in flight. Requires m_Mutex.
+   * @param delta
+   */
+  void changeResidentBytes(qint64 delta);
+
+  /**
+   * @brief datasetPrefix Returns the text that starts every status message of dataset 'index'
+   * @param index
+   * @return
+   */
+  QString datasetPrefix(int index) const;
+
+  /**
+   * @brief notify Sends a message for 'filter', or for the series when 'filter' is null
+   * @param type
+   * @param filter
+   * @param text
+   * @param code
+   */
+  void notify(PipelineMessage::MessageType type, const AbstractFilter::Pointer& filter, const QString& text, int code = 0);
+
+  /**
+   * @brief deliver Passes a message to the handler, one at a time
+   * @param msg
+   */
+  void deliver(const PipelineMessage& msg);
+
+  /**
+   * @brief notifyProgress Sends the overall progress after a stage finished another dataset
+   */
+  void notifyProgress();
+
+private:
+  FilterPipeline::Pointer m_Pipeline;
+  QString m_PipelineJson;
+  QVector<SeriesDataset> m_Datasets;
+  size_t m_MemoryWindow = 0;
+  MessageHandler m_MessageHandler;
+  BytesHandler m_ResidentBytesHandler;
+  FilterWrapper m_FilterWrapper;
+  WriteProfile::Preset m_WriteProfile = WriteProfile::Preset::Default;
+  bool m_IncrementalWrites = false;
+  // The profile of every enabled filter, taken from the pipeline since the copies lose their properties
+  QVector<WriteProfile> m_WriterProfiles;
+  QMutex m_NotifyMutex;
+
+  // Guarded by m_Mutex
+  QMutex m_Mutex;
+  QWaitCondition m_Changed;
+  QList<Slot> m_Loaded;
+  QList<Slot> m_Computed;
+  QList<FilterPipeline::Pointer> m_InFlight;
+  bool m_ReadDone = false;
+  bool m_ComputeDone = false;
+  bool m_Stop = false;
+  bool m_Canceled = false;
+  int m_ErrorCondition = 0;
+  size_t m_ResidentBytes = 0;
+  size_t m_LargestDatasetBytes = 0;
+  size_t m_PeakResidentBytes = 0;
+  int m_StagesCompleted = 0;
+  int m_CompletedDatasets = 0;
+  QVector<SeriesStageStats> m_Stats;
+
+  qint64 m_ElapsedMsecs = 0;
+
+  SeriesExecution(const SeriesExecution&) = delete; // Copy Constructor Not Implemented
+  void operator=(const SeriesExecution&) = delete;  // Move assignment Not Implemented
+};
@@ -0,0 +1,550 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "SharedArrayPublisher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QObject>
+#include <QtCore/QSysInfo>
+
+#if !defined(Q_OS_WIN)
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+const QString SharedArrayPublisher::SegmentPrefix("SIMPLView");
+
+namespace
+{
+// Large arrays are copied into their segment in blocks of this size, in parallel, which also spreads the
+// page faults of the fresh segment over the cores
+const size_t k_CopyBlockBytes = 16 * 1024 * 1024;
+
+/**
+ * @brief The ScalarType struct names a plain number type of SIMPL the way numpy does
+ */
+struct ScalarType
+{
+  const char* typeName;
+  char kind;
+  size_t size;
+};
+
+const ScalarType k_ScalarTypes[] = {{"int8_t", 'i', 1},   {"uint8_t", 'u', 1}, {"bool", 'b', 1},    {"int16_t", 'i', 2}, {"uint16_t", 'u', 2}, {"int32_t", 'i', 4},
+                                    {"uint32_t", 'u', 4}, {"int64_t", 'i', 8}, {"uint64_t", 'u', 8}, {"float", 'f', 4},   {"double", 'f', 8}};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const ScalarType* FindScalarType(const QString& typeName)
+{
+  for(const ScalarType& type : k_ScalarTypes)
+  {
+    if(typeName == type.typeName)
+    {
+      return &type;
+    }
+  }
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// The numpy array-interface type string, e.g. "<f4"
+// -----------------------------------------------------------------------------
+QString NumpyTypeString(const ScalarType& type)
+{
+  QChar order = (type.size == 1) ? QChar('|') : (QSysInfo::ByteOrder == QSysInfo::LittleEndian ? QChar('<') : QChar('>'));
+  return QString("%1%2%3").arg(order).arg(QChar(type.kind)).arg(type.size);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonArray ToJsonArray(const QVector<size_t>& values)
+{
+  QJsonArray array;
+  for(size_t value : values)
+  {
+    array.append(static_cast<double>(value));
+  }
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ParallelCopy(char* target, const char* source, size_t bytes)
+{
+  size_t blocks = (bytes + k_CopyBlockBytes - 1) / k_CopyBlockBytes;
+  std::function<void(size_t, size_t)> body = [=](size_t begin, size_t end) {
+    for(size_t i = begin; i < end; i++)
+    {
+      size_t offset = i * k_CopyBlockBytes;
+      std::memcpy(target + offset, source + offset, std::min(k_CopyBlockBytes, bytes - offset));
+    }
+  };
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks), [&body](const tbb::blocked_range<size_t>& range) { body(range.begin(), range.end()); }, tbb::auto_partitioner());
+#else
+  body(0, blocks);
+#endif
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SharedArrayPublisher::SharedArrayPublisher()
+{
+  // Every window of SIMPLView has its own publisher, so the process id alone does not make a name unique
+  static QAtomicInt publishers;
+  m_Publisher = publishers.fetchAndAddRelaxed(1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SharedArrayPublisher::~SharedArrayPublisher()
+{
+  unpublishAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SharedArrayPublisher::Supported()
+{
+#if defined(Q_OS_WIN)
+  return false;
+#else
+  return true;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString SharedArrayPublisher::CatalogName(qint64 pid, int publisher)
+{
+  return QString("%1-%2-%3").arg(SegmentPrefix).arg(pid).arg(publisher);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject SharedArrayPublisher::Describe(const DataContainerArray::Pointer& dca, const DataArrayPath& path, QString* errorMessage)
+{
+  DataContainer::Pointer dc = (dca.get() != nullptr) ? dca->getDataContainer(path.getDataContainerName()) : DataContainer::NullPointer();
+  AttributeMatrix::Pointer am = (dc.get() != nullptr) ? dc->getAttributeMatrix(path.getAttributeMatrixName()) : AttributeMatrix::NullPointer();
+  IDataArray::Pointer array = (am.get() != nullptr) ? am->getAttributeArray(path.getDataArrayName()) : IDataArray::NullPointer();
+  if(array.get() == nullptr)
+  {
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = QObject::tr("The array '%1' does not exist").arg(path.serialize("/"));
+    }
+    return QJsonObject();
+  }
+  const ScalarType* type = FindScalarType(array->getTypeAsString());
+  if(type == nullptr || (array->getSize() > 0 && array->getVoidPointer(0) == nullptr))
+  {
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = QObject::tr("The array '%1' of type %2 does not hold plain numbers").arg(path.serialize("/")).arg(array->getTypeAsString());
+    }
+    return QJsonObject();
+  }
+
+  QVector<size_t> tDims = am->getTupleDimensions();
+  QVector<size_t> cDims = array->getComponentDimensions();
+  // SIMPL stores the first dimension fastest, so the C-order shape lists the dimensions in reverse
+  QVector<size_t> shape;
+  for(int i = tDims.size() - 1; i >= 0; i--)
+  {
+    shape.push_back(tDims[i]);
+  }
+  for(int i = cDims.size() - 1; i >= 0; i--)
+  {
+    if(cDims[i] > 1 || cDims.size() > 1)
+    {
+      shape.push_back(cDims[i]);
+    }
+  }
+
+  QJsonObject descriptor;
+  descriptor["path"] = path.serialize("/");
+  descriptor["type"] = array->getTypeAsString();
+  descriptor["dtype"] = NumpyTypeString(*type);
+  descriptor["shape"] = ToJsonArray(shape);
+  descriptor["tupleDimensions"] = ToJsonArray(tDims);
+  descriptor["componentDimensions"] = ToJsonArray(cDims);
+  descriptor["components"] = array->getNumberOfComponents();
+  descriptor["tuples"] = static_cast<double>(array->getNumberOfTuples());
+  descriptor["bytes"] = static_cast<double>(array->getSize() * type->size);
+
+  IGeometry::Pointer geom = dc->getGeometry();
+  if(geom.get() != nullptr)
+  {
+    QJsonObject geometry;
+    geometry["type"] = geom->getGeometryTypeAsString();
+    ImageGeom::Pointer image = dc->getGeometryAs<ImageGeom>();
+    if(image.get() != nullptr)
+    {
+      size_t dims[3] = {0, 0, 0};
+      float res[3] = {0.0f, 0.0f, 0.0f};
+      float origin[3] = {0.0f, 0.0f, 0.0f};
+      image->getDimensions(dims);
+      image->getResolution(res);
+      image->getOrigin(origin);
+      geometry["dimensions"] = ToJsonArray({dims[0], dims[1], dims[2]});
+      geometry["spacing"] = QJsonArray({static_cast<double>(res[0]), static_cast<double>(res[1]), static_cast<double>(res[2])});
+      geometry["origin"] = QJsonArray({static_cast<double>(origin[0]), static_cast<double>(origin[1]), static_cast<double>(origin[2])});
+    }
+    descriptor["geometry"] = geometry;
+  }
+  return descriptor;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SharedArrayPublisher::RemoveStaleSegments()
+{
+  int removed = 0;
+#if defined(Q_OS_LINUX)
+  QStringList names = QDir("/dev/shm").entryList({SegmentPrefix + "-*"}, QDir::Files | QDir::System);
+  for(const QString& name : names)
+  {
+    bool ok = false;
+    qint64 pid = name.section('-', 1, 1).toLongLong(&ok);
+    if(!ok || pid == QCoreApplication::applicationPid())
+    {
+      continue;
+    }
+    // EPERM means the process runs under another user, so only a missing process is stale
+    if(kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH)
+    {
+      UnlinkSegment(name);
+      removed++;
+    }
+  }
+#endif
+  return removed;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SharedArrayPublisher::publish(const DataContainerArray::Pointer& dca, const DataArrayPath& path, QString* errorMessage)
+{
+  if(!Supported())
+  {
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = QObject::tr("Publishing arrays needs POSIX shared memory, which this platform does not have");
+    }
+    return false;
+  }
+
+  QJsonObject descriptor = Describe(dca, path, errorMessage);
+  if(descriptor.isEmpty())
+  {
+    return false;
+  }
+  IDataArray::Pointer array = dca->getAttributeMatrix(path)->getAttributeArray(path.getDataArrayName());
+  size_t bytes = static_cast<size_t>(descriptor["bytes"].toDouble());
+
+  Segment segment;
+  segment.path = path;
+  segment.name = QString("%1-%2").arg(getCatalogName()).arg(m_Counter++);
+  segment.bytes = bytes;
+  // An empty array still gets a segment of one byte so consumers find every array they were told about
+  void* mapping = CreateSegment(segment.name, std::max<size_t>(bytes, 1), errorMessage);
+  if(mapping == nullptr)
+  {
+    return false;
+  }
+  if(bytes > 0)
+  {
+    ParallelCopy(static_cast<char*>(mapping), static_cast<const char*>(array->getVoidPointer(0)), bytes);
+  }
+  UnmapSegment(mapping, std::max<size_t>(bytes, 1));
+
+  descriptor["segment"] = segment.name;
+  segment.descriptor = descriptor;
+
+  QString previous;
+  for(int i = 0; i < m_Segments.size(); i++)
+  {
+    if(m_Segments[i].path == path)
+    {
+      previous = m_Segments[i].name;
+      m_Segments.remove(i);
+      break;
+    }
+  }
+  m_Segments.push_back(segment);
+  if(!previous.isEmpty())
+  {
+    UnlinkSegment(previous);
+  }
+
+  if(!writeCatalog(errorMessage))
+  {
+    m_Segments.removeLast();
+    UnlinkSegment(segment.name);
+    writeCatalog(nullptr);
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SharedArrayPublisher::unpublish(const DataArrayPath& path)
+{
+  for(int i = 0; i < m_Segments.size(); i++)
+  {
+    if(m_Segments[i].path == path)
+    {
+      UnlinkSegment(m_Segments[i].name);
+      m_Segments.remove(i);
+      writeCatalog(nullptr);
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SharedArrayPublisher::unpublishAll()
+{
+  for(const Segment& segment : m_Segments)
+  {
+    UnlinkSegment(segment.name);
+  }
+  m_Segments.clear();
+  writeCatalog(nullptr);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SharedArrayPublisher::isPublished(const DataArrayPath& path) const
+{
+  for(const Segment& segment : m_Segments)
+  {
+    if(segment.path == path)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<DataArrayPath> SharedArrayPublisher::getPublishedPaths() const
+{
+  QVector<DataArrayPath> paths;
+  for(const Segment& segment : m_Segments)
+  {
+    paths.push_back(segment.path);
+  }
+  return paths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<SharedArrayPublisher::Segment> SharedArrayPublisher::getSegments() const
+{
+  return m_Segments;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t SharedArrayPublisher::getPublishedBytes() const
+{
+  size_t bytes = 0;
+  for(const Segment& segment : m_Segments)
+  {
+    bytes += segment.bytes;
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString SharedArrayPublisher::getCatalogName() const
+{
+  return CatalogName(QCoreApplication::applicationPid(), m_Publisher);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray SharedArrayPublisher::catalog() const
+{
+  QJsonArray arrays;
+  for(const Segment& segment : m_Segments)
+  {
+    arrays.append(segment.descriptor);
+  }
+  QJsonObject root;
+  root["pid"] = static_cast<double>(QCoreApplication::applicationPid());
+  root["arrays"] = arrays;
+  return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SharedArrayPublisher::writeCatalog(QString* errorMessage)
+{
+  // A segment cannot be resized for someone who already maps it, so the catalog is replaced as a whole
+  UnlinkSegment(getCatalogName());
+  if(m_Segments.isEmpty())
+  {
+    return true;
+  }
+
+  QByteArray json = catalog();
+  void* mapping = CreateSegment(getCatalogName(), static_cast<size_t>(json.size()), errorMessage);
+  if(mapping == nullptr)
+  {
+    return false;
+  }
+  std::memcpy(mapping, json.constData(), static_cast<size_t>(json.size()));
+  UnmapSegment(mapping, static_cast<size_t>(json.size()));
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void* SharedArrayPublisher::CreateSegment(const QString& name, size_t bytes, QString* errorMessage)
+{
+#if defined(Q_OS_WIN)
+  Q_UNUSED(name)
+  Q_UNUSED(bytes)
+  if(errorMessage != nullptr)
+  {
+    *errorMessage = QObject::tr("Shared memory segments are not supported on this platform");
+  }
+  return nullptr;
+#else
+  QByteArray posixName = ("/" + name).toLocal8Bit();
+  // Only this user may map the values; O_EXCL keeps a segment of another process from being overwritten
+  int fd = shm_open(posixName.constData(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if(fd < 0)
+  {
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = QObject::tr("Could not create the shared memory segment '%1': %2").arg(name).arg(QString::fromLocal8Bit(strerror(errno)));
+    }
+    return nullptr;
+  }
+  void* mapping = MAP_FAILED;
+  if(ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+  {
+    mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  int error = errno;
+  close(fd);
+  if(mapping == MAP_FAILED)
+  {
+    shm_unlink(posixName.constData());
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = QObject::tr("Could not allocate %1 bytes of shared memory for '%2': %3").arg(bytes).arg(name).arg(QString::fromLocal8Bit(strerror(error)));
+    }
+    return nullptr;
+  }
+  return mapping;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SharedArrayPublisher::UnmapSegment(void* mapping, size_t bytes)
+{
+#if defined(Q_OS_WIN)
+  Q_UNUSED(mapping)
+  Q_UNUSED(bytes)
+#else
+  munmap(mapping, bytes);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SharedArrayPublisher::UnlinkSegment(const QString& name)
+{
+#if defined(Q_OS_WIN)
+  Q_UNUSED(name)
+#else
+  shm_unlink(("/" + name).toLocal8Bit().constData());
+#endif
+}
@@ -0,0 +1,176 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+/**
+ * @brief The SharedArrayPublisher class publishes arrays to other processes on the same machine through
+ * named POSIX shared memory, so local tools can map the values instead of reading them from a written file.
+ *
+ * Each published array is copied once into its own segment, named <catalog>-<n>, that holds nothing but the
+ * values, so a consumer maps the whole segment as the array, e.g. with numpy.ndarray(buffer=...). The
+ * catalog segment, named SIMPLView-<pid>-<publisher>, holds a JSON object whose "arrays" list has one
+ * descriptor per published array: its path, segment, byte count, SIMPL type, numpy dtype, C-order shape,
+ * tuple and component dimensions and the geometry of its Data Container. The catalog is replaced whenever
+ * the set of published arrays changes, and publishing an array again moves it to a new segment.
+ *
+ * Segments are removed by unpublish(), unpublishAll() or the destructor; a consumer that still maps one
+ * keeps its mapping until it unmaps it. Segments left behind by a process that crashed are removed by
+ * RemoveStaleSegments(). Shared memory is not available on Windows, where publish() always fails.
+ */
+class SharedArrayPublisher
+{
+public:
+  /**
+   * @brief The Segment struct is one published array
+   */
+  struct Segment
+  {
+    DataArrayPath path;
+    QString name;
+    size_t bytes = 0;
+    QJsonObject descriptor;
+  };
+
+  static const QString SegmentPrefix;
+  static const int PublishError = -9436;
+
+  /**
+   * @brief Supported Returns true if the platform has named shared memory
+   * @return
+   */
+  static bool Supported();
+
+  /**
+   * @brief CatalogName Returns the name of the catalog segment of publisher 'publisher' in the process 'pid'
+   * @param pid
+   * @param publisher
+   * @return
+   */
+  static QString CatalogName(qint64 pid, int publisher);
+
+  /**
+   * @brief Describe Returns the descriptor of the array at 'path', without the segment it is published in
+   * @param dca
+   * @param path
+   * @param errorMessage
+   * @return An empty object if the array does not exist or is not a plain number array
+   */
+  static QJsonObject Describe(const DataContainerArray::Pointer& dca, const DataArrayPath& path, QString* errorMessage = nullptr);
+
+  /**
+   * @brief RemoveStaleSegments Removes the segments of SIMPLView processes that no longer run. Only Linux
+   * lists its segments; elsewhere nothing is removed.
+   * @return The number of removed segments
+   */
+  static int RemoveStaleSegments();
+
+  SharedArrayPublisher();
+  virtual ~SharedArrayPublisher();
+
+  /**
+   * @brief publish Copies the array at 'path' into a new segment and adds it to the catalog
+   * @param dca
+   * @param path
+   * @param errorMessage
+   * @return
+   */
+  bool publish(const DataContainerArray::Pointer& dca, const DataArrayPath& path, QString* errorMessage = nullptr);
+
+  /**
+   * @brief unpublish Removes the segment of the array at 'path' and drops it from the catalog
+   * @param path
+   * @return false if the array was not published
+   */
+  bool unpublish(const DataArrayPath& path);
+
+  /**
+   * @brief unpublishAll Removes every segment, the catalog included
+   */
+  void unpublishAll();
+
+  bool isPublished(const DataArrayPath& path) const;
+  QVector<DataArrayPath> getPublishedPaths() const;
+  QVector<Segment> getSegments() const;
+  size_t getPublishedBytes() const;
+
+  /**
+   * @brief getCatalogName Returns the name of the catalog segment of this publisher
+   * @return
+   */
+  QString getCatalogName() const;
+
+  /**
+   * @brief catalog Returns the JSON the catalog segment holds
+   * @return
+   */
+  QByteArray catalog() const;
+
+protected:
+  /**
+   * @brief writeCatalog Replaces the catalog segment with the current catalog, or removes it if nothing is
+   * published
+   * @param errorMessage
+   * @return
+   */
+  bool writeCatalog(QString* errorMessage);
+
+  /**
+   * @brief CreateSegment Creates the segment 'name' with 'bytes' bytes and maps it for writing
+   * @param name
+   * @param bytes
+   * @param errorMessage
+   * @return The mapping, or null if the segment could not be created
+   */
+  static void* CreateSegment(const QString& name, size_t bytes, QString* errorMessage);
+  static void UnmapSegment(void* mapping, size_t bytes);
+  static void UnlinkSegment(const QString& name);
+
+private:
+  QVector<Segment> m_Segments;
+  int m_Publisher = 0;
+  int m_Counter = 0;
+
+  SharedArrayPublisher(const SharedArrayPublisher&) = delete; // Copy Constructor Not Implemented
+  void operator=(const SharedArrayPublisher&) = delete;       // Move assignment Not Implemented
+};
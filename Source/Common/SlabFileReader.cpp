@@ -0,0 +1,287 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "SlabFileReader.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "Common/ArrayMemoryPool.h"
+#include "Common/ParallelChunkIO.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SlabFileReader::SlabFileReader(const QString& filePath, const DataContainerArray::Pointer& structure)
+: m_FilePath(filePath)
+, m_Structure(structure)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SlabFileReader::~SlabFileReader()
+{
+  close();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t SlabFileReader::NativeType(const QString& typeName)
+{
+  if(typeName == "int8_t")
+  {
+    return H5T_NATIVE_INT8;
+  }
+  if(typeName == "uint8_t" || typeName == "bool")
+  {
+    return H5T_NATIVE_UINT8;
+  }
+  if(typeName == "int16_t")
+  {
+    return H5T_NATIVE_INT16;
+  }
+  if(typeName == "uint16_t")
+  {
+    return H5T_NATIVE_UINT16;
+  }
+  if(typeName == "int32_t")
+  {
+    return H5T_NATIVE_INT32;
+  }
+  if(typeName == "uint32_t")
+  {
+    return H5T_NATIVE_UINT32;
+  }
+  if(typeName == "int64_t")
+  {
+    return H5T_NATIVE_INT64;
+  }
+  if(typeName == "uint64_t")
+  {
+    return H5T_NATIVE_UINT64;
+  }
+  if(typeName == "float")
+  {
+    return H5T_NATIVE_FLOAT;
+  }
+  if(typeName == "double")
+  {
+    return H5T_NATIVE_DOUBLE;
+  }
+  return -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SlabFileReader::open()
+{
+  close();
+  m_BytesRead = 0;
+  m_FileId = H5Fopen(m_FilePath.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if(m_FileId < 0)
+  {
+    m_ErrorMessage = QObject::tr("The file '%1' could not be opened for reading").arg(m_FilePath);
+    return false;
+  }
+  // A file rewritten with a chunked profile is read with the chunk cache it was written with
+  m_Profile = WriteProfile::FromFile(m_FileId);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SlabFileReader::close()
+{
+  if(m_FileId >= 0)
+  {
+    H5Fclose(m_FileId);
+    m_FileId = -1;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString SlabFileReader::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t SlabFileReader::getBytesRead() const
+{
+  return m_BytesRead;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer SlabFileReader::readSlab(size_t zStart, size_t zEnd)
+{
+  DataContainerArray::Pointer slab = DataContainerArray::New();
+  size_t rows = zEnd - zStart;
+
+  QList<DataContainer::Pointer> containers = m_Structure->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    ImageGeom::Pointer geom = dc->getGeometryAs<ImageGeom>();
+    if(geom.get() == nullptr)
+    {
+      m_ErrorMessage = QObject::tr("The Data Container '%1' does not have an Image geometry").arg(dc->getName());
+      return DataContainerArray::NullPointer();
+    }
+
+    size_t dims[3] = {0, 0, 0};
+    float res[3] = {0.0f, 0.0f, 0.0f};
+    float origin[3] = {0.0f, 0.0f, 0.0f};
+    geom->getDimensions(dims);
+    geom->getResolution(res);
+    geom->getOrigin(origin);
+
+    size_t slabDims[3] = {dims[0], dims[1], rows};
+    float slabOrigin[3] = {origin[0], origin[1], origin[2] + static_cast<float>(zStart) * res[2]};
+    ImageGeom::Pointer slabGeom = ImageGeom::CreateGeometry(geom->getName());
+    slabGeom->setDimensions(slabDims);
+    slabGeom->setResolution(res);
+    slabGeom->setOrigin(slabOrigin);
+
+    DataContainer::Pointer slabDc = DataContainer::New(dc->getName());
+    slabDc->setGeometry(slabGeom);
+
+    DataContainer::AttributeMatrixMap_t& matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QVector<size_t> tDims = {dims[0], dims[1], rows};
+      AttributeMatrix::Pointer slabAm = AttributeMatrix::New(tDims, am->getName(), am->getType());
+
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        IDataArray::Pointer prototype = am->getAttributeArray(name);
+        IDataArray::Pointer array = ArrayMemoryPool::Instance()->createArrayLike(prototype, dims[0] * dims[1] * rows, name);
+        QString datasetPath = QString("/%1/%2/%3/%4").arg(SIMPL::StringConstants::DataContainerGroupName).arg(dc->getName()).arg(am->getName()).arg(name);
+        if(!readRows(datasetPath, dims[2], zStart, rows, array))
+        {
+          return DataContainerArray::NullPointer();
+        }
+        slabAm->addAttributeArray(name, array);
+      }
+      slabDc->addAttributeMatrix(am->getName(), slabAm);
+    }
+    slab->addDataContainer(slabDc);
+  }
+
+  return slab;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SlabFileReader::readRows(const QString& datasetPath, size_t zDim, size_t zStart, size_t rows, const IDataArray::Pointer& array)
+{
+  hid_t memType = NativeType(array->getTypeAsString());
+  if(memType < 0)
+  {
+    m_ErrorMessage = QObject::tr("The array '%1' is not a scalar array").arg(datasetPath);
+    return false;
+  }
+
+  hid_t dapl = m_Profile.createAccessPList();
+  hid_t datasetId = H5Dopen2(m_FileId, datasetPath.toLatin1().constData(), dapl);
+  H5Pclose(dapl);
+  if(datasetId < 0)
+  {
+    m_ErrorMessage = QObject::tr("The dataset '%1' could not be opened").arg(datasetPath);
+    return false;
+  }
+
+  hid_t fileSpace = H5Dget_space(datasetId);
+  int rank = H5Sget_simple_extent_ndims(fileSpace);
+  QVector<hsize_t> dims(rank > 0 ? rank : 0);
+  if(rank > 0)
+  {
+    H5Sget_simple_extent_dims(fileSpace, dims.data(), nullptr);
+  }
+
+  // Arrays of a 3D Image geometry are stored as (Z, Y, X, components), so Z is the slowest dimension
+  bool ok = (rank >= 3 && dims[0] == zDim);
+  herr_t err = -1;
+  if(ok)
+  {
+    QVector<hsize_t> count = dims;
+    count[0] = rows;
+    hsize_t elements = 1;
+    for(hsize_t c : count)
+    {
+      elements *= c;
+    }
+    ok = (elements == array->getSize());
+    if(ok)
+    {
+      // Chunks of files with a write profile are decompressed on the thread pool
+      ParallelChunkIO chunkIO(datasetId);
+      err = chunkIO.readRows(memType, zStart, rows, array->getVoidPointer(0)) ? 0 : -1;
+    }
+  }
+
+  H5Sclose(fileSpace);
+  H5Dclose(datasetId);
+
+  if(!ok)
+  {
+    m_ErrorMessage = QObject::tr("The dataset '%1' is not laid out as Z slices of the volume").arg(datasetPath);
+    return false;
+  }
+  if(err < 0)
+  {
+    m_ErrorMessage = QObject::tr("Z slices %1 to %2 of '%3' could not be read").arg(zStart).arg(zStart + rows - 1).arg(datasetPath);
+    return false;
+  }
+
+  m_BytesRead += array->getSize() * array->getTypeSize();
+  return true;
+}
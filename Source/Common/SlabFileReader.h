@@ -0,0 +1,111 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <hdf5.h>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+#include "Common/WriteProfile.h"
+
+/**
+ * @brief The SlabFileReader class reads ranges of Z slices of the Cell arrays of Image geometries out of
+ * a .dream3d file. Only the slices that are asked for are read from disk, using HDF5 hyperslabs.
+ *
+ * The layout of the returned slabs is taken from a structure DataContainerArray, usually the one that
+ * preflighting a DataContainerReader produces. Each slab has the full X and Y extent of the volume and
+ * its geometry origin is shifted to the first slice it holds.
+ */
+class SlabFileReader
+{
+public:
+  SlabFileReader(const QString& filePath, const DataContainerArray::Pointer& structure);
+  virtual ~SlabFileReader();
+
+  /**
+   * @brief NativeType Returns the native HDF5 type for a type name from IDataArray::getTypeAsString() or -1
+   * @param typeName
+   * @return
+   */
+  static hid_t NativeType(const QString& typeName);
+
+  /**
+   * @brief open Opens the file for reading
+   * @return
+   */
+  bool open();
+
+  /**
+   * @brief close Closes the file. Also done by the destructor.
+   */
+  void close();
+
+  /**
+   * @brief readSlab Reads Z slices [zStart, zEnd) of every array of the structure
+   * @param zStart
+   * @param zEnd
+   * @return A new DataContainerArray or a null pointer on error
+   */
+  DataContainerArray::Pointer readSlab(size_t zStart, size_t zEnd);
+
+  QString getErrorMessage() const;
+  size_t getBytesRead() const;
+
+protected:
+  /**
+   * @brief readRows Reads Z slices [zStart, zStart + rows) of the dataset at 'datasetPath' into 'array'
+   * @param datasetPath
+   * @param zDim The number of Z slices of the whole volume
+   * @param zStart
+   * @param rows
+   * @param array
+   * @return
+   */
+  bool readRows(const QString& datasetPath, size_t zDim, size_t zStart, size_t rows, const IDataArray::Pointer& array);
+
+private:
+  QString m_FilePath;
+  DataContainerArray::Pointer m_Structure;
+  hid_t m_FileId = -1;
+  WriteProfile m_Profile;
+  QString m_ErrorMessage;
+  size_t m_BytesRead = 0;
+
+  SlabFileReader(const SlabFileReader&) = delete; // Copy Constructor Not Implemented
+  void operator=(const SlabFileReader&) = delete; // Move assignment Not Implemented
+};
@@ -0,0 +1,303 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "SlabFileWriter.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+#include "H5Support/QH5Lite.h"
+#include "H5Support/QH5Utilities.h"
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/FilterParameters/JsonFilterParametersWriter.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "Common/ParallelChunkIO.h"
+#include "Common/SlabFileReader.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SlabFileWriter::SlabFileWriter(const QString& filePath, const DataContainerArray::Pointer& structure)
+: m_FilePath(filePath)
+, m_Structure(structure)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SlabFileWriter::~SlabFileWriter()
+{
+  close();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SlabFileWriter::setWriteProfile(const WriteProfile& profile)
+{
+  m_Profile = profile;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WriteProfile SlabFileWriter::getWriteProfile() const
+{
+  return m_Profile;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString SlabFileWriter::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t SlabFileWriter::getBytesWritten() const
+{
+  return m_BytesWritten;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SlabFileWriter::create(const FilterPipeline::Pointer& pipeline)
+{
+  close();
+  m_BytesWritten = 0;
+  m_FileId = H5Fcreate(m_FilePath.toLocal8Bit().constData(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if(m_FileId < 0)
+  {
+    m_ErrorMessage = QObject::tr("The file '%1' could not be created").arg(m_FilePath);
+    return false;
+  }
+
+  QH5Lite::writeStringAttribute(m_FileId, "/", SIMPL::HDF5::FileVersionName, SIMPL::HDF5::FileVersion);
+  QH5Lite::writeStringAttribute(m_FileId, "/", SIMPL::HDF5::DREAM3DVersion, QCoreApplication::applicationVersion());
+  if(!m_Profile.isDefault())
+  {
+    QH5Lite::writeStringAttribute(m_FileId, "/", WriteProfile::FileAttributeName, m_Profile.getName());
+  }
+
+  JsonFilterParametersWriter::Pointer jsonWriter = JsonFilterParametersWriter::New();
+  QString pipelineJson = jsonWriter->writePipelineToString(pipeline, pipeline->getName());
+  hid_t pipelineId = QH5Utilities::createGroup(m_FileId, SIMPL::StringConstants::PipelineGroupName);
+  QH5Lite::writeStringAttribute(m_FileId, SIMPL::StringConstants::PipelineGroupName, SIMPL::StringConstants::PipelineGroupName, pipelineJson);
+  H5Gclose(pipelineId);
+
+  hid_t containersId = QH5Utilities::createGroup(m_FileId, SIMPL::StringConstants::DataContainerGroupName);
+  bool ok = (containersId >= 0);
+
+  QList<DataContainer::Pointer> containers = m_Structure->getDataContainers();
+  for(int d = 0; d < containers.size() && ok; d++)
+  {
+    const DataContainer::Pointer& dc = containers[d];
+    hid_t dcId = QH5Utilities::createGroup(containersId, dc->getName());
+
+    // The geometry of the whole volume is small, so it is written the same way DataContainerWriter does
+    ok = (dcId >= 0 && dc->writeMeshToHDF5(dcId, false) >= 0);
+
+    DataContainer::AttributeMatrixMap_t& matrices = dc->getAttributeMatrices();
+    for(AttributeMatrix::Pointer am : matrices)
+    {
+      if(!ok)
+      {
+        break;
+      }
+      QVector<size_t> tDims = am->getTupleDimensions();
+      hid_t amId = QH5Utilities::createGroup(dcId, am->getName());
+      QH5Lite::writeScalarAttribute(dcId, am->getName(), SIMPL::StringConstants::AttributeMatrixType, static_cast<uint32_t>(am->getType()));
+      QVector<hsize_t> attrDims(1, static_cast<hsize_t>(tDims.size()));
+      QVector<uint64_t> tupleDims;
+      for(size_t t : tDims)
+      {
+        tupleDims.push_back(t);
+      }
+      QH5Lite::writeVectorAttribute(dcId, am->getName(), SIMPL::HDF5::TupleDimensions, attrDims, tupleDims);
+
+      QList<QString> names = am->getAttributeArrayNames();
+      for(int n = 0; n < names.size() && ok; n++)
+      {
+        QString key = QString("%1/%2/%3").arg(dc->getName()).arg(am->getName()).arg(names[n]);
+        ok = createDataset(amId, key, am->getAttributeArray(names[n]), tDims);
+      }
+      H5Gclose(amId);
+    }
+    H5Gclose(dcId);
+  }
+  H5Gclose(containersId);
+
+  if(!ok)
+  {
+    if(m_ErrorMessage.isEmpty())
+    {
+      m_ErrorMessage = QObject::tr("The layout of '%1' could not be written").arg(m_FilePath);
+    }
+    close();
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SlabFileWriter::createDataset(hid_t amId, const QString& key, const IDataArray::Pointer& array, const QVector<size_t>& tDims)
+{
+  hid_t type = SlabFileReader::NativeType(array->getTypeAsString());
+  if(type < 0)
+  {
+    m_ErrorMessage = QObject::tr("The array '%1' is not a scalar array").arg(key);
+    return false;
+  }
+
+  // Same layout as the DataArray writer: the tuple and component dimensions, slowest first
+  QVector<size_t> cDims = array->getComponentDimensions();
+  QVector<hsize_t> dims;
+  for(int i = tDims.size() - 1; i >= 0; i--)
+  {
+    dims.push_back(tDims[i]);
+  }
+  for(int i = cDims.size() - 1; i >= 0; i--)
+  {
+    dims.push_back(cDims[i]);
+  }
+
+  hid_t space = H5Screate_simple(dims.size(), dims.data(), nullptr);
+  hid_t dcpl = m_Profile.createDatasetPList(dims, array->getTypeSize());
+  hid_t dapl = m_Profile.createAccessPList();
+  hid_t datasetId = H5Dcreate2(amId, array->getName().toLatin1().constData(), type, space, H5P_DEFAULT, dcpl, dapl);
+  H5Pclose(dapl);
+  H5Pclose(dcpl);
+  H5Sclose(space);
+  if(datasetId < 0)
+  {
+    m_ErrorMessage = QObject::tr("The dataset for '%1' could not be created").arg(key);
+    return false;
+  }
+
+  QVector<hsize_t> attrDims(1, static_cast<hsize_t>(cDims.size()));
+  QVector<uint64_t> componentDims;
+  for(size_t c : cDims)
+  {
+    componentDims.push_back(c);
+  }
+  QVector<uint64_t> tupleDims;
+  for(size_t t : tDims)
+  {
+    tupleDims.push_back(t);
+  }
+  QVector<hsize_t> tupleAttrDims(1, static_cast<hsize_t>(tDims.size()));
+
+  QH5Lite::writeVectorAttribute(amId, array->getName(), SIMPL::HDF5::ComponentDimensions, attrDims, componentDims);
+  QH5Lite::writeVectorAttribute(amId, array->getName(), SIMPL::HDF5::TupleDimensions, tupleAttrDims, tupleDims);
+  QH5Lite::writeScalarAttribute(amId, array->getName(), SIMPL::HDF5::DataArrayVersion, static_cast<int32_t>(2));
+  QH5Lite::writeStringAttribute(amId, array->getName(), SIMPL::HDF5::ObjectType, array->getFullNameOfClass());
+
+  m_Datasets.insert(key, datasetId);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SlabFileWriter::writeSlab(const DataContainerArray::Pointer& slab, size_t slabStart, size_t zStart, size_t zEnd)
+{
+  size_t rows = zEnd - zStart;
+
+  QList<DataContainer::Pointer> containers = m_Structure->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    ImageGeom::Pointer geom = dc->getGeometryAs<ImageGeom>();
+    size_t dims[3] = {0, 0, 0};
+    geom->getDimensions(dims);
+
+    DataContainer::AttributeMatrixMap_t& matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        QString key = QString("%1/%2/%3").arg(dc->getName()).arg(am->getName()).arg(name);
+        AttributeMatrix::Pointer slabAm = slab->getAttributeMatrix(DataArrayPath(dc->getName(), am->getName(), ""));
+        IDataArray::Pointer array = (slabAm.get() != nullptr) ? slabAm->getAttributeArray(name) : IDataArray::NullPointer();
+        if(array.get() == nullptr || !m_Datasets.contains(key))
+        {
+          m_ErrorMessage = QObject::tr("The array '%1' is missing from the slab").arg(key);
+          return false;
+        }
+
+        // Chunked profiles compress whole chunks of the slab on the thread pool
+        ParallelChunkIO chunkIO(m_Datasets.value(key));
+        size_t elementsPerSlice = dims[0] * dims[1] * array->getNumberOfComponents();
+        void* data = array->getVoidPointer((zStart - slabStart) * elementsPerSlice);
+        if(!chunkIO.writeRows(SlabFileReader::NativeType(array->getTypeAsString()), zStart, rows, data))
+        {
+          m_ErrorMessage = QObject::tr("Z slices %1 to %2 of '%3' could not be written").arg(zStart).arg(zEnd - 1).arg(key);
+          return false;
+        }
+        m_BytesWritten += rows * elementsPerSlice * array->getTypeSize();
+      }
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SlabFileWriter::close()
+{
+  for(hid_t datasetId : m_Datasets)
+  {
+    H5Dclose(datasetId);
+  }
+  m_Datasets.clear();
+  if(m_FileId >= 0)
+  {
+    H5Fclose(m_FileId);
+    m_FileId = -1;
+  }
+}
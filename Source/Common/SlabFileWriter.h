@@ -0,0 +1,117 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <hdf5.h>
+
+#include <QtCore/QMap>
+#include <QtCore/QString>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "Common/WriteProfile.h"
+
+/**
+ * @brief The SlabFileWriter class writes a .dream3d file one range of Z slices at a time.
+ *
+ * create() lays out the whole file from a structure DataContainerArray: the geometries, the attribute
+ * matrices and one full size dataset per array, plus the pipeline. writeSlab() then fills the datasets
+ * slice range by slice range, so the complete volume is never held in memory. The file has the same
+ * layout as one written by DataContainerWriter, without the Xdmf side car file. The datasets are laid
+ * out with the WriteProfile set before create(), so a profile costs no rewrite of the finished file.
+ */
+class SlabFileWriter
+{
+public:
+  SlabFileWriter(const QString& filePath, const DataContainerArray::Pointer& structure);
+  virtual ~SlabFileWriter();
+
+  /**
+   * @brief setWriteProfile Sets the chunk shape, filters and chunk cache of the datasets create() makes
+   * @param profile
+   */
+  void setWriteProfile(const WriteProfile& profile);
+  WriteProfile getWriteProfile() const;
+
+  /**
+   * @brief create Creates the file and every dataset at its full size
+   * @param pipeline The pipeline that is stored in the file
+   * @return
+   */
+  bool create(const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief writeSlab Writes Z slices [zStart, zEnd) of every array. The slab holds the slices starting at 'slabStart'.
+   * @param slab
+   * @param slabStart
+   * @param zStart
+   * @param zEnd
+   * @return
+   */
+  bool writeSlab(const DataContainerArray::Pointer& slab, size_t slabStart, size_t zStart, size_t zEnd);
+
+  /**
+   * @brief close Closes every dataset and the file. Also done by the destructor.
+   */
+  void close();
+
+  QString getErrorMessage() const;
+  size_t getBytesWritten() const;
+
+protected:
+  /**
+   * @brief createDataset Creates the dataset for 'array' inside the attribute matrix group 'amId'
+   * @param amId
+   * @param key
+   * @param array
+   * @param tDims
+   * @return
+   */
+  bool createDataset(hid_t amId, const QString& key, const IDataArray::Pointer& array, const QVector<size_t>& tDims);
+
+private:
+  QString m_FilePath;
+  DataContainerArray::Pointer m_Structure;
+  WriteProfile m_Profile;
+  hid_t m_FileId = -1;
+  QMap<QString, hid_t> m_Datasets;
+  QString m_ErrorMessage;
+  size_t m_BytesWritten = 0;
+
+  SlabFileWriter(const SlabFileWriter&) = delete; // Copy Constructor Not Implemented
+  void operator=(const SlabFileWriter&) = delete; // Move assignment Not Implemented
+};
@@ -2,6 +2,59 @@
 set(AppsCommon_Widgets_HDRS "")
 set(AppsCommon_Widgets_SRCS "")
 set(AppsCommon_Widgets_UIS "")
+set(AppsCommon_HDRS "")
+set(AppsCommon_SRCS "")
+
+# --------------------------------------------------------------------
+# List the Classes here that are NOT QWidget Derived Classes. These are
+# shared by the GUI application and the command line tools.
+set(APPS_COMMON_CLASSES
+  ArrayCompressionManager
+  ArrayLivenessAnalysis
+  ArrayMemoryPool
+  ArraySpillManager
+  AsyncFileWriter
+  ChunkedFileReader
+  ColumnarFile
+  ColumnarFileReader
+  ColumnarFileWriter
+  CompressedArray
+  DataSnapshotStore
+  ElementwiseFusion
+  ElementwiseKernel
+  HDF5Lock
+  IncrementalFileWriter
+  InputPrefetcher
+  MappedFileReader
+  MemoryEstimator
+  NumaTopology
+  ParallelChunkIO
+  PipelineDataFlowGraph
+  PipelineExecutor
+  PipelineFileSettings
+  PipelineJobQueue
+  PipelineOptimizer
+  PreviewReduction
+  SeriesExecution
+  SharedArrayPublisher
+  SlabFileReader
+  SlabFileWriter
+  ThreadBudget
+  ThreadTuner
+  TiledExecution
+  WriteProfile
+)
+
+foreach(CLASS ${APPS_COMMON_CLASSES})
+  set(AppsCommon_HDRS ${AppsCommon_HDRS}
+    ${SIMPLViewProj_SOURCE_DIR}/Source/Common/${CLASS}.h
+    )
+  set(AppsCommon_SRCS ${AppsCommon_SRCS}
+    ${SIMPLViewProj_SOURCE_DIR}/Source/Common/${CLASS}.cpp
+    )
+endforeach()
+
+cmp_IDE_SOURCE_PROPERTIES( "Applications/Common" "${AppsCommon_HDRS}" "${AppsCommon_SRCS}" "0")
 
 
 # --------------------------------------------------------------------
@@ -0,0 +1,723 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ThreadBudget.h"
+
+#include <algorithm>
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#if TBB_INTERFACE_VERSION >= 11000
+#include <tbb/global_control.h>
+#include <tbb/task_scheduler_observer.h>
+#endif
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <cerrno>
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef SIMPL_USE_ITK
+#include <itkConfigure.h>
+#if ITK_VERSION_MAJOR >= 5
+#include <itkMultiThreaderBase.h>
+using ItkMultiThreader = itk::MultiThreaderBase;
+#else
+#include <itkMultiThreader.h>
+using ItkMultiThreader = itk::MultiThreader;
+#endif
+#endif
+
+#include "Common/NumaTopology.h"
+
+const QString ThreadBudget::JsonKey("ThreadBudget");
+
+namespace
+{
+// Interactive shares weigh this much more than normal ones, background shares this much less
+const double InteractiveWeightFactor = 4.0;
+const double BackgroundWeightFactor = 0.25;
+
+const int BackgroundNice = 10;
+
+#if defined(Q_OS_LINUX)
+// From linux/ioprio.h: the lowest level of the best-effort class
+const int IoprioWhoProcess = 1;
+const int IoprioClassShift = 13;
+const int IoprioClassBestEffort = 2;
+const int IoprioLowestLevel = 7;
+
+/**
+ * @brief The ThreadPriorityState struct remembers the priorities a thread had before it started background
+ * work, and how deeply it is nested in background work
+ */
+struct ThreadPriorityState
+{
+  int depth = 0;
+  bool niceLowered = false;
+  int nice = 0;
+  int ioprio = -1;
+};
+thread_local ThreadPriorityState t_PriorityState;
+
+// -----------------------------------------------------------------------------
+// Raising the nice value back needs CAP_SYS_NICE or an RLIMIT_NICE that reaches the old value
+// -----------------------------------------------------------------------------
+bool CanRestoreNice(int nice)
+{
+  if(geteuid() == 0)
+  {
+    return true;
+  }
+  struct rlimit limit;
+  return getrlimit(RLIMIT_NICE, &limit) == 0 && (limit.rlim_cur == RLIM_INFINITY || 20 - static_cast<long>(limit.rlim_cur) <= nice);
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Lowers the priorities of the calling thread until the matching LeaveBackgroundPriority(). The nice value
+// is only lowered if it can be restored, since a pooled thread would otherwise stay slow for the work of
+// other shares; background work is then held back by its smaller share of the threads alone.
+// -----------------------------------------------------------------------------
+void EnterBackgroundPriority()
+{
+#if defined(Q_OS_LINUX)
+  ThreadPriorityState& state = t_PriorityState;
+  if(state.depth++ > 0)
+  {
+    return;
+  }
+
+  pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+  errno = 0;
+  state.nice = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+  state.niceLowered = (errno == 0 && state.nice < BackgroundNice && CanRestoreNice(state.nice) && setpriority(PRIO_PROCESS, static_cast<id_t>(tid), BackgroundNice) == 0);
+  state.ioprio = -1;
+#if defined(SYS_ioprio_get) && defined(SYS_ioprio_set)
+  state.ioprio = static_cast<int>(syscall(SYS_ioprio_get, IoprioWhoProcess, tid));
+  if(state.ioprio >= 0)
+  {
+    syscall(SYS_ioprio_set, IoprioWhoProcess, tid, (IoprioClassBestEffort << IoprioClassShift) | IoprioLowestLevel);
+  }
+#endif
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void LeaveBackgroundPriority()
+{
+#if defined(Q_OS_LINUX)
+  ThreadPriorityState& state = t_PriorityState;
+  if(state.depth == 0 || --state.depth > 0)
+  {
+    return;
+  }
+
+  pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+  if(state.niceLowered)
+  {
+    setpriority(PRIO_PROCESS, static_cast<id_t>(tid), state.nice);
+  }
+#if defined(SYS_ioprio_get) && defined(SYS_ioprio_set)
+  if(state.ioprio >= 0)
+  {
+    syscall(SYS_ioprio_set, IoprioWhoProcess, tid, state.ioprio);
+  }
+#endif
+#endif
+}
+
+/**
+ * @brief The BackgroundPriorityScope class runs background work on the calling thread at the lower priority
+ */
+class BackgroundPriorityScope
+{
+public:
+  explicit BackgroundPriorityScope(bool background)
+  : m_Background(background)
+  {
+    if(m_Background)
+    {
+      EnterBackgroundPriority();
+    }
+  }
+
+  ~BackgroundPriorityScope()
+  {
+    if(m_Background)
+    {
+      LeaveBackgroundPriority();
+    }
+  }
+
+private:
+  bool m_Background = false;
+
+  BackgroundPriorityScope(const BackgroundPriorityScope&) = delete; // Copy Constructor Not Implemented
+  void operator=(const BackgroundPriorityScope&) = delete;          // Move assignment Not Implemented
+};
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#if TBB_INTERFACE_VERSION >= 11000
+/**
+ * @brief The NodePinningObserver class pins every thread that joins an arena to a NUMA node and lets it go
+ * again when it leaves
+ */
+class NodePinningObserver : public tbb::task_scheduler_observer
+{
+public:
+  NodePinningObserver(tbb::task_arena& arena, int threads, int numaNode)
+  : tbb::task_scheduler_observer(arena)
+  , m_Threads(threads)
+  , m_NumaNode(numaNode)
+  {
+    observe(true);
+  }
+
+  void on_scheduler_entry(bool) override
+  {
+    NumaTopology* topology = NumaTopology::Instance();
+    int node = m_NumaNode;
+    if(node < 0)
+    {
+      node = topology->getNodeId(NumaTopology::NodeOfSlot(tbb::this_task_arena::current_thread_index(), m_Threads, topology->getNodeCount()));
+    }
+    topology->pinCurrentThread(node);
+  }
+
+  void on_scheduler_exit(bool) override
+  {
+    NumaTopology::Instance()->unpinCurrentThread();
+  }
+
+private:
+  int m_Threads = 1;
+  int m_NumaNode = -1;
+};
+
+/**
+ * @brief The BackgroundPriorityObserver class lowers the priority of every thread that joins the arena of a
+ * background share and restores it when the thread leaves, so pooled workers that go on to other arenas run
+ * at their usual priority again
+ */
+class BackgroundPriorityObserver : public tbb::task_scheduler_observer
+{
+public:
+  explicit BackgroundPriorityObserver(tbb::task_arena& arena)
+  : tbb::task_scheduler_observer(arena)
+  {
+    observe(true);
+  }
+
+  void on_scheduler_entry(bool) override
+  {
+    EnterBackgroundPriority();
+  }
+
+  void on_scheduler_exit(bool) override
+  {
+    LeaveBackgroundPriority();
+  }
+};
+#endif
+#endif
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::ThreadBudget()
+{
+  QMutexLocker locker(&m_Mutex);
+  m_TotalThreads = QThread::idealThreadCount();
+  applyGlobalLimits();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::~ThreadBudget() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget* ThreadBudget::Instance()
+{
+  static ThreadBudget budget;
+  return &budget;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ThreadBudget::PriorityClassName(PriorityClass priority)
+{
+  switch(priority)
+  {
+  case PriorityClass::Interactive:
+    return "Interactive";
+  case PriorityClass::Background:
+    return "Background";
+  default:
+    return "Normal";
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::PriorityClass ThreadBudget::PriorityClassFromName(const QString& name, bool* ok)
+{
+  if(ok != nullptr)
+  {
+    *ok = true;
+  }
+  for(PriorityClass priority : {PriorityClass::Interactive, PriorityClass::Normal, PriorityClass::Background})
+  {
+    if(name.compare(PriorityClassName(priority), Qt::CaseInsensitive) == 0)
+    {
+      return priority;
+    }
+  }
+
+  if(ok != nullptr)
+  {
+    *ok = false;
+  }
+  return PriorityClass::Normal;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadBudget::LowerCurrentThreadPriority()
+{
+  static thread_local bool lowered = false;
+  if(lowered)
+  {
+    return;
+  }
+  lowered = true;
+
+#if defined(Q_OS_LINUX)
+  // On Linux the nice value and the I/O priority belong to the thread, not the process
+  pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+  setpriority(PRIO_PROCESS, static_cast<id_t>(tid), BackgroundNice);
+#ifdef SYS_ioprio_set
+  syscall(SYS_ioprio_set, IoprioWhoProcess, tid, (IoprioClassBestEffort << IoprioClassShift) | IoprioLowestLevel);
+#endif
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::Request ThreadBudget::ReadRequest(const QJsonObject& root, PriorityClass defaultPriority)
+{
+  Request request;
+  request.priority = defaultPriority;
+  QJsonObject budgetObj = root["PipelineBuilder"].toObject()[JsonKey].toObject();
+  if(budgetObj.isEmpty())
+  {
+    return request;
+  }
+
+  double weight = budgetObj["Weight"].toDouble(1.0);
+  request.weight = (weight > 0.0) ? weight : 1.0;
+  request.maxThreads = std::max(budgetObj["MaxThreads"].toInt(0), 0);
+  request.numaNode = std::max(budgetObj["NumaNode"].toInt(-1), -1);
+
+  bool ok = false;
+  PriorityClass priority = PriorityClassFromName(budgetObj["Priority"].toString(), &ok);
+  if(ok)
+  {
+    request.priority = priority;
+  }
+  return request;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::Request ThreadBudget::ReadRequest(const QString& filePath, PriorityClass defaultPriority)
+{
+  QFile inputFile(filePath);
+  if(filePath.isEmpty() || !inputFile.open(QIODevice::ReadOnly))
+  {
+    Request request;
+    request.priority = defaultPriority;
+    return request;
+  }
+
+  QJsonDocument doc = QJsonDocument::fromJson(inputFile.readAll());
+  return ReadRequest(doc.object(), defaultPriority);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadBudget::setTotalThreads(int count)
+{
+  QMutexLocker locker(&m_Mutex);
+  m_TotalThreads = (count < 1) ? QThread::idealThreadCount() : count;
+  applyGlobalLimits();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ThreadBudget::getTotalThreads() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_TotalThreads;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadBudget::setPinThreadsToNodes(bool enabled)
+{
+  QMutexLocker locker(&m_Mutex);
+  m_PinThreadsToNodes = enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThreadBudget::getPinThreadsToNodes() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_PinThreadsToNodes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadBudget::applyGlobalLimits()
+{
+  QThreadPool::globalInstance()->setMaxThreadCount(m_TotalThreads);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#if TBB_INTERFACE_VERSION >= 11000
+  // Only one limit may be in effect, the old one has to go before the new one is created
+  m_TbbLimit.reset();
+  m_TbbLimit = std::make_shared<tbb::global_control>(tbb::global_control::max_allowed_parallelism, static_cast<size_t>(m_TotalThreads));
+#endif
+#endif
+
+#ifdef SIMPL_USE_ITK
+  ItkMultiThreader::SetGlobalMaximumNumberOfThreads(m_TotalThreads);
+  ItkMultiThreader::SetGlobalDefaultNumberOfThreads(m_TotalThreads);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ThreadBudget::acquire(const Request& request)
+{
+  QMutexLocker locker(&m_Mutex);
+  int share = m_NextShare++;
+  Share entry;
+  entry.request = request;
+  m_Shares.insert(share, entry);
+  return share;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadBudget::release(int share)
+{
+  QMutexLocker locker(&m_Mutex);
+  // Threads still executing in the share keep its arena alive through their own reference
+  m_Shares.remove(share);
+  m_InteractiveFinished.wakeAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ThreadBudget::getThreads(int share) const
+{
+  QMutexLocker locker(&m_Mutex);
+  return threadsFor(share);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ThreadBudget::threadsFor(int share) const
+{
+  if(!m_Shares.contains(share))
+  {
+    return m_TotalThreads;
+  }
+
+  auto effectiveWeight = [](const Request& request) {
+    switch(request.priority)
+    {
+    case PriorityClass::Interactive:
+      return request.weight * InteractiveWeightFactor;
+    case PriorityClass::Background:
+      return request.weight * BackgroundWeightFactor;
+    default:
+      return request.weight;
+    }
+  };
+
+  double totalWeight = 0.0;
+  for(const Share& entry : m_Shares)
+  {
+    totalWeight += effectiveWeight(entry.request);
+  }
+
+  const Request& request = m_Shares[share].request;
+  if(request.priority == PriorityClass::Background && hasInteractiveShare())
+  {
+    return 1;
+  }
+  int threads = static_cast<int>(static_cast<double>(m_TotalThreads) * effectiveWeight(request) / totalWeight);
+  if(request.maxThreads > 0)
+  {
+    threads = std::min(threads, request.maxThreads);
+  }
+  int nodeCpus = (request.numaNode >= 0) ? NumaTopology::Instance()->getCpuCount(request.numaNode) : 0;
+  if(nodeCpus > 0)
+  {
+    threads = std::min(threads, nodeCpus);
+  }
+  return std::max(threads, 1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::PriorityClass ThreadBudget::getPriorityClass(int share) const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_Shares.value(share).request.priority;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThreadBudget::isInteractiveActive() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return hasInteractiveShare();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThreadBudget::hasInteractiveShare() const
+{
+  for(const Share& entry : m_Shares)
+  {
+    if(entry.request.priority == PriorityClass::Interactive)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThreadBudget::waitForInteractive(unsigned long msecs)
+{
+  QMutexLocker locker(&m_Mutex);
+  if(hasInteractiveShare())
+  {
+    m_InteractiveFinished.wait(&m_Mutex, msecs);
+  }
+  return !hasInteractiveShare();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ThreadBudget::getActiveShareCount() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_Shares.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadBudget::execute(int share, const std::function<void()>& func)
+{
+  // The calling thread works at the priority of the share until it returns, like the workers of its arena
+  bool background = (getPriorityClass(share) == PriorityClass::Background);
+  BackgroundPriorityScope priority(background);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  std::shared_ptr<tbb::task_arena> arena;
+  {
+    QMutexLocker locker(&m_Mutex);
+    QMap<int, Share>::iterator iter = m_Shares.find(share);
+    if(iter != m_Shares.end())
+    {
+      // The share shrinks or grows as other pipelines start and finish. A resized share gets a new arena;
+      // work that is already running finishes in the old one.
+      int threads = threadsFor(share);
+      if(iter->arena.get() == nullptr || iter->arena->max_concurrency() != threads || iter->pinned != m_PinThreadsToNodes)
+      {
+        iter->arena = CreateArena(threads, m_PinThreadsToNodes, iter->request.numaNode, background);
+        iter->pinned = m_PinThreadsToNodes;
+      }
+      arena = iter->arena;
+    }
+  }
+
+  if(arena.get() != nullptr)
+  {
+    arena->execute(func);
+    return;
+  }
+#endif
+
+  executeOnNode(share, func);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadBudget::execute(int share, int maxThreads, const std::function<void()>& func)
+{
+  if(maxThreads < 1 || maxThreads >= getThreads(share))
+  {
+    execute(share, func);
+    return;
+  }
+
+  bool background = (getPriorityClass(share) == PriorityClass::Background);
+  BackgroundPriorityScope priority(background);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  // A smaller arena just for this call; the share keeps its size and the rest of it stays idle
+  int numaNode = -1;
+  bool pinned = false;
+  {
+    QMutexLocker locker(&m_Mutex);
+    numaNode = m_Shares.value(share).request.numaNode;
+    pinned = m_PinThreadsToNodes;
+  }
+  std::shared_ptr<tbb::task_arena> arena = CreateArena(maxThreads, pinned, numaNode, background);
+  arena->execute(func);
+#else
+  executeOnNode(share, func);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadBudget::executeOnNode(int share, const std::function<void()>& func)
+{
+  int numaNode = -1;
+  {
+    QMutexLocker locker(&m_Mutex);
+    numaNode = m_Shares.value(share).request.numaNode;
+  }
+
+  NumaTopology* topology = NumaTopology::Instance();
+  if(numaNode < 0 || topology->getNodeCount() < 2)
+  {
+    func();
+    return;
+  }
+  topology->pinCurrentThread(numaNode);
+  func();
+  topology->unpinCurrentThread();
+}
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::shared_ptr<tbb::task_arena> ThreadBudget::CreateArena(int threads, bool pinned, int numaNode, bool background)
+{
+#if TBB_INTERFACE_VERSION >= 11000
+  bool pin = (pinned || numaNode >= 0) && NumaTopology::Instance()->getNodeCount() > 1;
+  if(pin || background)
+  {
+    tbb::task_arena* arena = new tbb::task_arena(threads);
+    arena->initialize();
+    std::shared_ptr<NodePinningObserver> pinning;
+    if(pin)
+    {
+      pinning = std::make_shared<NodePinningObserver>(*arena, threads, numaNode);
+    }
+    std::shared_ptr<BackgroundPriorityObserver> priority;
+    if(background)
+    {
+      priority = std::make_shared<BackgroundPriorityObserver>(*arena);
+    }
+    // The observers have to stop observing before their arena goes away
+    return std::shared_ptr<tbb::task_arena>(arena, [pinning, priority](tbb::task_arena* doomed) {
+      if(pinning)
+      {
+        pinning->observe(false);
+      }
+      if(priority)
+      {
+        priority->observe(false);
+      }
+      delete doomed;
+    });
+  }
+#else
+  Q_UNUSED(pinned)
+  Q_UNUSED(numaNode)
+  Q_UNUSED(background)
+#endif
+  return std::make_shared<tbb::task_arena>(threads);
+}
+#endif
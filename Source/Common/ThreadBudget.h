@@ -0,0 +1,286 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QWaitCondition>
+
+#include "SIMPLib/SIMPLib.h"
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/task_arena.h>
+#endif
+
+/**
+ * @brief The ThreadBudget class is the single owner of the number of threads the process may use.
+ *
+ * TBB, ITK's multithreader and QThreadPool::globalInstance() each assume by default that they own every
+ * core. setTotalThreads() caps all three to the same budget. Pipelines that run at the same time each
+ * acquire() a share of the budget; the threads are divided between the active shares by weight and
+ * every share runs its parallel work inside its own TBB arena of that size, so two pipelines (or an ITK
+ * filter inside a parallel pipeline) do not oversubscribe the machine.
+ *
+ * A pipeline file may ask for a weight, a thread limit or a priority class with a "ThreadBudget" object
+ * inside its "PipelineBuilder" object, e.g. "ThreadBudget": { "Weight": 2, "MaxThreads": 4, "Priority": "Background" }.
+ * "NumaNode": 1 places the threads of the pipeline on that NUMA node and limits them to its CPUs.
+ *
+ * Interactive shares weigh more than normal ones and background shares less. While any interactive share
+ * is active, background shares shrink to a single thread and their executions hold back new filters until
+ * the interactive work is done. Threads that execute background work also get a lower OS scheduling and,
+ * on Linux, I/O priority while they work for the share: an observer on the arena of a background share
+ * lowers the priority of every thread that joins it and restores it when the thread leaves. The scheduling
+ * priority is only lowered where the process may raise it again.
+ *
+ * With setPinThreadsToNodes(), the threads of every arena are pinned to the NUMA nodes in blocks of
+ * consecutive arena slots, see NumaTopology::NodeOfSlot(), so the pages a thread touches first stay local to
+ * it for the rest of the run.
+ */
+class ThreadBudget
+{
+public:
+  enum class PriorityClass : int
+  {
+    Interactive = 0,
+    Normal = 1,
+    Background = 2
+  };
+
+  /**
+   * @brief The Request struct describes what a pipeline asks of the budget
+   */
+  struct Request
+  {
+    double weight = 1.0;
+    int maxThreads = 0; // 0 means no limit besides the weighted share
+    PriorityClass priority = PriorityClass::Normal;
+    int numaNode = -1; // The NUMA node the threads run on, -1 for any
+  };
+
+  static const QString JsonKey;
+
+  /**
+   * @brief PriorityClassName Returns the name of a priority class as it is stored in pipeline files
+   * @param priority
+   * @return
+   */
+  static QString PriorityClassName(PriorityClass priority);
+
+  /**
+   * @brief PriorityClassFromName Returns the priority class named 'name', case insensitive
+   * @param name
+   * @param ok Set to false if 'name' is not a priority class
+   * @return
+   */
+  static PriorityClass PriorityClassFromName(const QString& name, bool* ok = nullptr);
+
+  /**
+   * @brief LowerCurrentThreadPriority Lowers the OS scheduling priority of the calling thread for background
+   * work. Unprivileged processes cannot raise it again, so this must only be called on threads that end with
+   * the work or belong to a process that only does background work.
+   */
+  static void LowerCurrentThreadPriority();
+
+  /**
+   * @brief Instance Returns the process-wide budget
+   * @return
+   */
+  static ThreadBudget* Instance();
+
+  /**
+   * @brief ReadRequest Returns the request stored in the "PipelineBuilder" object of a pipeline file's root
+   * object, or the default request
+   * @param root
+   * @param defaultPriority The priority class if the object does not name one
+   * @return
+   */
+  static Request ReadRequest(const QJsonObject& root, PriorityClass defaultPriority = PriorityClass::Normal);
+
+  /**
+   * @brief ReadRequest Returns the request stored in the pipeline file at 'filePath', or the default request
+   * @param filePath
+   * @param defaultPriority The priority class if the file does not name one
+   * @return
+   */
+  static Request ReadRequest(const QString& filePath, PriorityClass defaultPriority = PriorityClass::Normal);
+
+  /**
+   * @brief setTotalThreads Sets the number of threads of the whole process and applies it to TBB, ITK and the
+   * global QThreadPool. A value less than 1 uses QThread::idealThreadCount().
+   * @param count
+   */
+  void setTotalThreads(int count);
+  int getTotalThreads() const;
+
+  /**
+   * @brief setPinThreadsToNodes Sets whether the threads of new arenas are pinned to NUMA nodes. Has no
+   * effect on machines with a single node.
+   * @param enabled
+   */
+  void setPinThreadsToNodes(bool enabled);
+  bool getPinThreadsToNodes() const;
+
+  /**
+   * @brief acquire Adds a share for a pipeline that is about to run
+   * @param request
+   * @return The share id to pass to the other functions
+   */
+  int acquire(const Request& request = Request());
+
+  /**
+   * @brief release Removes a share once its pipeline has finished. The other shares grow back.
+   * @param share
+   */
+  void release(int share);
+
+  /**
+   * @brief getThreads Returns the number of threads 'share' may currently use, at least 1
+   * @param share
+   * @return
+   */
+  int getThreads(int share) const;
+
+  /**
+   * @brief getActiveShareCount Returns the number of pipelines currently holding a share
+   * @return
+   */
+  int getActiveShareCount() const;
+
+  /**
+   * @brief getPriorityClass Returns the priority class of 'share'
+   * @param share
+   * @return
+   */
+  PriorityClass getPriorityClass(int share) const;
+
+  /**
+   * @brief isInteractiveActive Returns true while any interactive share is active
+   * @return
+   */
+  bool isInteractiveActive() const;
+
+  /**
+   * @brief waitForInteractive Blocks until no interactive share is active or 'msecs' have passed
+   * @param msecs
+   * @return true if no interactive share is active any more
+   */
+  bool waitForInteractive(unsigned long msecs);
+
+  /**
+   * @brief execute Calls 'func' on the current thread with any TBB parallelism inside it limited to the
+   * threads of 'share'. Several threads may execute in the same share at once.
+   * @param share
+   * @param func
+   */
+  void execute(int share, const std::function<void()>& func);
+
+  /**
+   * @brief execute Calls 'func' like execute(int, const std::function<void()>&) but with at most 'maxThreads'
+   * threads, for work that is known to scale no further than that
+   * @param share
+   * @param maxThreads
+   * @param func
+   */
+  void execute(int share, int maxThreads, const std::function<void()>& func);
+
+protected:
+  ThreadBudget();
+  virtual ~ThreadBudget();
+
+  /**
+   * @brief applyGlobalLimits Caps TBB, ITK and the global QThreadPool at the total. Called with the mutex held.
+   */
+  void applyGlobalLimits();
+
+  /**
+   * @brief threadsFor Returns the threads of 'share'. Called with the mutex held.
+   * @param share
+   * @return
+   */
+  int threadsFor(int share) const;
+
+  /**
+   * @brief hasInteractiveShare Returns true if any share is interactive. Called with the mutex held.
+   * @return
+   */
+  bool hasInteractiveShare() const;
+
+  /**
+   * @brief executeOnNode Calls 'func' on the calling thread, pinned to the NUMA node of 'share' if it has one
+   * @param share
+   * @param func
+   */
+  void executeOnNode(int share, const std::function<void()>& func);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  /**
+   * @brief CreateArena Returns an arena of 'threads' threads that pins its threads to the NUMA nodes if
+   * 'pinned', or to 'numaNode' if that is not -1
+   * @param threads
+   * @param pinned
+   * @param numaNode
+   * @param background Lowers the priority of every thread while it works in the arena
+   * @return
+   */
+  static std::shared_ptr<tbb::task_arena> CreateArena(int threads, bool pinned, int numaNode, bool background);
+#endif
+
+private:
+  struct Share
+  {
+    Request request;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    std::shared_ptr<tbb::task_arena> arena;
+    bool pinned = false;
+#endif
+  };
+
+  mutable QMutex m_Mutex;
+  int m_TotalThreads = 0;
+  bool m_PinThreadsToNodes = false;
+  int m_NextShare = 0;
+  QMap<int, Share> m_Shares;
+  QWaitCondition m_InteractiveFinished;
+  std::shared_ptr<void> m_TbbLimit;
+
+  ThreadBudget(const ThreadBudget&) = delete;   // Copy Constructor Not Implemented
+  void operator=(const ThreadBudget&) = delete; // Move assignment Not Implemented
+};
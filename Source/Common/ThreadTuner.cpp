@@ -0,0 +1,443 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ThreadTuner.h"
+
+#include <algorithm>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+namespace
+{
+// A count this much slower than the best stops the search for fewer threads
+const double ExplorationCutoff = 1.25;
+// The smallest count within this factor of the best is chosen
+const double Tolerance = 1.10;
+
+const int FileVersion = 1;
+
+/**
+ * @brief Candidates Returns the thread counts tried for 'maxThreads': the count itself and its halvings down to 1
+ */
+QVector<int> Candidates(int maxThreads)
+{
+  QVector<int> candidates;
+  for(int threads = maxThreads; threads >= 1; threads /= 2)
+  {
+    candidates.push_back(threads);
+  }
+  return candidates;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double ThreadTuner::Measurement::msecsPerGigabyte() const
+{
+  return msecs / std::max(bytes, 1.0) * 1024.0 * 1024.0 * 1024.0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadTuner::ThreadTuner()
+: m_FilePath(DefaultFilePath())
+{
+  load();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadTuner::~ThreadTuner() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadTuner* ThreadTuner::Instance()
+{
+  static ThreadTuner tuner;
+  return &tuner;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ThreadTuner::DefaultFilePath()
+{
+  QString dataDir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation);
+  return QDir(dataDir).absoluteFilePath("SIMPLView/ThreadProfiles.json");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ThreadTuner::SizeBucket(size_t bytes)
+{
+  int bucket = 0;
+  while(bytes > 1)
+  {
+    bytes >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ThreadTuner::SizeBucketName(int bucket)
+{
+  auto sizeName = [](int exponent) {
+    const QStringList units = {"B", "KB", "MB", "GB", "TB", "PB"};
+    int unit = std::min(exponent / 10, units.size() - 1);
+    return QString("%1 %2").arg(1ULL << (exponent - unit * 10)).arg(units[unit]);
+  };
+  return QString("%1 - %2").arg(sizeName(bucket)).arg(sizeName(bucket + 1));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ThreadTuner::Key(const QString& filterClassName, int sizeBucket)
+{
+  return QString("%1/%2").arg(filterClassName).arg(sizeBucket, 2, 10, QChar('0'));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadTuner::setEnabled(bool enabled)
+{
+  QMutexLocker locker(&m_Mutex);
+  m_Enabled = enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThreadTuner::isEnabled() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_Enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadTuner::setFilePath(const QString& filePath)
+{
+  {
+    QMutexLocker locker(&m_Mutex);
+    m_FilePath = filePath;
+  }
+  load();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ThreadTuner::getFilePath() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_FilePath;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ThreadTuner::choose(const Profile& profile, int maxThreads, bool* exploring) const
+{
+  *exploring = false;
+  if(maxThreads <= 1)
+  {
+    return 1;
+  }
+
+  QVector<int> candidates = Candidates(maxThreads);
+  double best = -1.0;
+  for(int threads : candidates)
+  {
+    if(!profile.measurements.contains(threads))
+    {
+      *exploring = true;
+      return threads;
+    }
+
+    double rate = profile.measurements[threads].msecsPerGigabyte();
+    if(best >= 0.0 && rate > best * ExplorationCutoff)
+    {
+      // Fewer threads than this will not catch up again
+      break;
+    }
+    best = (best < 0.0) ? rate : std::min(best, rate);
+  }
+
+  int chosen = maxThreads;
+  for(int threads : candidates)
+  {
+    if(profile.measurements.contains(threads) && profile.measurements[threads].msecsPerGigabyte() <= best * Tolerance)
+    {
+      chosen = threads;
+    }
+  }
+  return chosen;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ThreadTuner::select(const QString& filterClassName, size_t inputBytes, int maxThreads)
+{
+  QMutexLocker locker(&m_Mutex);
+  bool exploring = false;
+  return choose(m_Profiles.value(Key(filterClassName, SizeBucket(inputBytes))), maxThreads, &exploring);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThreadTuner::isExploring(const QString& filterClassName, size_t inputBytes, int maxThreads) const
+{
+  QMutexLocker locker(&m_Mutex);
+  bool exploring = false;
+  choose(m_Profiles.value(Key(filterClassName, SizeBucket(inputBytes))), maxThreads, &exploring);
+  return exploring;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadTuner::record(const QString& filterClassName, size_t inputBytes, int threads, qint64 msecs)
+{
+  QMutexLocker locker(&m_Mutex);
+  int bucket = SizeBucket(inputBytes);
+  Profile& profile = m_Profiles[Key(filterClassName, bucket)];
+  profile.filterClassName = filterClassName;
+  profile.sizeBucket = bucket;
+
+  Measurement& measurement = profile.measurements[threads];
+  measurement.threads = threads;
+  measurement.runs++;
+  measurement.msecs += static_cast<double>(msecs);
+  measurement.bytes += static_cast<double>(inputBytes);
+  m_Modified = true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<ThreadTuner::Profile> ThreadTuner::getProfiles() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_Profiles.values().toVector();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadTuner::reset(const QString& filterClassName)
+{
+  {
+    QMutexLocker locker(&m_Mutex);
+    if(filterClassName.isEmpty())
+    {
+      m_Profiles.clear();
+    }
+    else
+    {
+      QMap<QString, Profile>::iterator iter = m_Profiles.begin();
+      while(iter != m_Profiles.end())
+      {
+        if(iter->filterClassName == filterClassName)
+        {
+          iter = m_Profiles.erase(iter);
+        }
+        else
+        {
+          ++iter;
+        }
+      }
+    }
+    m_Modified = true;
+  }
+  save();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThreadTuner::load()
+{
+  QMutexLocker locker(&m_Mutex);
+  m_Profiles.clear();
+  m_Modified = false;
+
+  QFile file(m_FilePath);
+  if(!file.exists())
+  {
+    return true;
+  }
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+  if(!doc.isObject() || doc.object()["Version"].toInt() != FileVersion)
+  {
+    return false;
+  }
+
+  QJsonArray profiles = doc.object()["Profiles"].toArray();
+  for(const QJsonValue& profileValue : profiles)
+  {
+    QJsonObject profileObj = profileValue.toObject();
+    Profile profile;
+    profile.filterClassName = profileObj["Filter"].toString();
+    profile.sizeBucket = profileObj["SizeBucket"].toInt();
+
+    QJsonArray measurements = profileObj["Measurements"].toArray();
+    for(const QJsonValue& measurementValue : measurements)
+    {
+      QJsonObject measurementObj = measurementValue.toObject();
+      Measurement measurement;
+      measurement.threads = measurementObj["Threads"].toInt();
+      measurement.runs = measurementObj["Runs"].toInt();
+      measurement.msecs = measurementObj["Msecs"].toDouble();
+      measurement.bytes = measurementObj["Bytes"].toDouble();
+      if(measurement.threads > 0 && measurement.runs > 0)
+      {
+        profile.measurements.insert(measurement.threads, measurement);
+      }
+    }
+
+    if(!profile.filterClassName.isEmpty())
+    {
+      m_Profiles.insert(Key(profile.filterClassName, profile.sizeBucket), profile);
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThreadTuner::save()
+{
+  QMutexLocker locker(&m_Mutex);
+  if(!m_Modified)
+  {
+    return true;
+  }
+
+  QJsonArray profiles;
+  for(const Profile& profile : m_Profiles)
+  {
+    QJsonArray measurements;
+    for(const Measurement& measurement : profile.measurements)
+    {
+      QJsonObject measurementObj;
+      measurementObj["Threads"] = measurement.threads;
+      measurementObj["Runs"] = measurement.runs;
+      measurementObj["Msecs"] = measurement.msecs;
+      measurementObj["Bytes"] = measurement.bytes;
+      measurements.append(measurementObj);
+    }
+
+    QJsonObject profileObj;
+    profileObj["Filter"] = profile.filterClassName;
+    profileObj["SizeBucket"] = profile.sizeBucket;
+    profileObj["Measurements"] = measurements;
+    profiles.append(profileObj);
+  }
+
+  QJsonObject root;
+  root["Version"] = FileVersion;
+  root["Profiles"] = profiles;
+
+  QDir().mkpath(QFileInfo(m_FilePath).absolutePath());
+  QSaveFile file(m_FilePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(QJsonDocument(root).toJson());
+  if(!file.commit())
+  {
+    return false;
+  }
+
+  m_Modified = false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList ThreadTuner::report() const
+{
+  QMutexLocker locker(&m_Mutex);
+  QStringList lines;
+  for(const Profile& profile : m_Profiles)
+  {
+    int maxThreads = profile.measurements.isEmpty() ? 1 : profile.measurements.lastKey();
+    bool exploring = false;
+    int chosen = choose(profile, maxThreads, &exploring);
+
+    QStringList measured;
+    for(const Measurement& measurement : profile.measurements)
+    {
+      measured << QObject::tr("%1 threads %2 s/GB (%3 runs)").arg(measurement.threads).arg(measurement.msecsPerGigabyte() / 1000.0, 0, 'f', 2).arg(measurement.runs);
+    }
+    lines << QObject::tr("%1 [%2]: %3 threads%4, %5")
+                 .arg(profile.filterClassName)
+                 .arg(SizeBucketName(profile.sizeBucket))
+                 .arg(chosen)
+                 .arg(exploring ? QObject::tr(" (exploring)") : QString())
+                 .arg(measured.join(", "));
+  }
+  return lines;
+}
@@ -0,0 +1,217 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+/**
+ * @brief The ThreadTuner class learns how many threads each filter class should run with.
+ *
+ * Filters do not all scale the same: some keep getting faster up to every core, others are limited by
+ * memory bandwidth or serial sections and get slower beyond a few threads. While enabled, every filter
+ * invocation is timed against the number of threads it was given. Measurements are kept per filter class
+ * and per input size bucket (powers of two of the bytes the filter sees), normalized by the input size.
+ *
+ * A profile is explored by halving the thread count from the full share, one invocation per count, until
+ * a count is clearly slower than the best one so far. From then on select() returns the smallest measured
+ * count that is within a small tolerance of the fastest, which leaves the remaining threads to other work.
+ *
+ * Profiles are stored as JSON in a local file so they carry over between runs of the application and the
+ * command line tools; they can be listed with getProfiles() and discarded with reset().
+ */
+class ThreadTuner
+{
+public:
+  /**
+   * @brief The Measurement struct sums up the runs of a filter class with one thread count
+   */
+  struct Measurement
+  {
+    int threads = 0;
+    int runs = 0;
+    double msecs = 0.0;
+    double bytes = 0.0;
+
+    /**
+     * @brief msecsPerGigabyte Returns the average time per GB of input
+     * @return
+     */
+    double msecsPerGigabyte() const;
+  };
+
+  /**
+   * @brief The Profile struct holds every measurement of a filter class for one input size bucket
+   */
+  struct Profile
+  {
+    QString filterClassName;
+    int sizeBucket = 0;
+    QMap<int, Measurement> measurements;
+  };
+
+  /**
+   * @brief Instance Returns the process-wide tuner, loaded from DefaultFilePath()
+   * @return
+   */
+  static ThreadTuner* Instance();
+
+  /**
+   * @brief DefaultFilePath Returns the file the profiles are stored in, shared by every application
+   * @return
+   */
+  static QString DefaultFilePath();
+
+  /**
+   * @brief SizeBucket Returns the input size bucket of 'bytes', the floor of its base 2 logarithm
+   * @param bytes
+   * @return
+   */
+  static int SizeBucket(size_t bytes);
+
+  /**
+   * @brief SizeBucketName Returns a readable range for a size bucket, e.g. "64 MB - 128 MB"
+   * @param bucket
+   * @return
+   */
+  static QString SizeBucketName(int bucket);
+
+  /**
+   * @brief setEnabled Turns auto-tuning on for every pipeline executed in this process
+   * @param enabled
+   */
+  void setEnabled(bool enabled);
+  bool isEnabled() const;
+
+  /**
+   * @brief setFilePath Sets the file the profiles are loaded from and saved to and loads it
+   * @param filePath
+   */
+  void setFilePath(const QString& filePath);
+  QString getFilePath() const;
+
+  /**
+   * @brief select Returns the number of threads to run the next invocation of a filter with
+   * @param filterClassName
+   * @param inputBytes
+   * @param maxThreads The threads available to the invocation
+   * @return A number from 1 to maxThreads
+   */
+  int select(const QString& filterClassName, size_t inputBytes, int maxThreads);
+
+  /**
+   * @brief record Adds the wall time of an invocation that ran with 'threads' threads
+   * @param filterClassName
+   * @param inputBytes
+   * @param threads
+   * @param msecs
+   */
+  void record(const QString& filterClassName, size_t inputBytes, int threads, qint64 msecs);
+
+  /**
+   * @brief isExploring Returns true if select() would still try a new thread count for the profile
+   * @param filterClassName
+   * @param inputBytes
+   * @param maxThreads
+   * @return
+   */
+  bool isExploring(const QString& filterClassName, size_t inputBytes, int maxThreads) const;
+
+  /**
+   * @brief getProfiles Returns a copy of every profile, sorted by filter class and size
+   * @return
+   */
+  QVector<Profile> getProfiles() const;
+
+  /**
+   * @brief reset Discards every profile, or only those of 'filterClassName', and saves the file
+   * @param filterClassName
+   */
+  void reset(const QString& filterClassName = QString());
+
+  /**
+   * @brief load Replaces the profiles with those in the file
+   * @return false if the file exists but could not be read
+   */
+  bool load();
+
+  /**
+   * @brief save Writes the profiles to the file if they changed since the last load or save
+   * @return false if the file could not be written
+   */
+  bool save();
+
+  /**
+   * @brief report Returns one line per profile with the chosen and the measured thread counts
+   * @return
+   */
+  QStringList report() const;
+
+protected:
+  ThreadTuner();
+  virtual ~ThreadTuner();
+
+  /**
+   * @brief choose Returns the thread count for 'profile' and whether it is still being explored. Called
+   * with the mutex held.
+   * @param profile
+   * @param maxThreads
+   * @param exploring
+   * @return
+   */
+  int choose(const Profile& profile, int maxThreads, bool* exploring) const;
+
+  /**
+   * @brief Key Returns the key of a profile in the map
+   * @param filterClassName
+   * @param sizeBucket
+   * @return
+   */
+  static QString Key(const QString& filterClassName, int sizeBucket);
+
+private:
+  mutable QMutex m_Mutex;
+  bool m_Enabled = false;
+  bool m_Modified = false;
+  QString m_FilePath;
+  QMap<QString, Profile> m_Profiles;
+
+  ThreadTuner(const ThreadTuner&) = delete;    // Copy Constructor Not Implemented
+  void operator=(const ThreadTuner&) = delete; // Move assignment Not Implemented
+};
@@ -0,0 +1,518 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "TiledExecution.h"
+
+#include <algorithm>
+
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+#include <QtCore/QVariant>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "Common/ElementwiseKernel.h"
+#include "Common/HDF5Lock.h"
+#include "Common/SlabFileReader.h"
+#include "Common/SlabFileWriter.h"
+
+namespace
+{
+const QString ReaderClassName("DataContainerReader");
+const QString WriterClassName("DataContainerWriter");
+
+const int RefusedError = -9410;
+const int ReadError = -9411;
+const int WriteError = -9412;
+
+int ErodeDilateHalo(const AbstractFilter::Pointer& filter)
+{
+  // Every iteration grows or shrinks by one voxel, but only along the enabled directions
+  bool ok = false;
+  int iterations = filter->property("NumIterations").toInt(&ok);
+  if(!ok || iterations < 0)
+  {
+    return -1;
+  }
+  return filter->property("ZDirOn").toBool() ? iterations : 0;
+}
+
+QMutex& RegistryMutex()
+{
+  static QMutex mutex;
+  return mutex;
+}
+
+QMap<QString, TiledExecution::HaloFactory>& Registry()
+{
+  static QMap<QString, TiledExecution::HaloFactory> registry = {{"ErodeDilateBadData", &ErodeDilateHalo},
+                                                                {"ErodeDilateMask", &ErodeDilateHalo},
+                                                                {"FindBoundaryCells", [](const AbstractFilter::Pointer&) { return 1; }},
+                                                                {"FindSurfaceCells", [](const AbstractFilter::Pointer&) { return 1; }}};
+  return registry;
+}
+
+QVector<AbstractFilter::Pointer> EnabledFilters(const FilterPipeline::Pointer& pipeline)
+{
+  QVector<AbstractFilter::Pointer> filters;
+  FilterPipeline::FilterContainerType container = pipeline->getFilterContainer();
+  for(const AbstractFilter::Pointer& filter : container)
+  {
+    if(filter->getEnabled())
+    {
+      filters.push_back(filter);
+    }
+  }
+  return filters;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+TiledExecution::TiledExecution(FilterPipeline::Pointer pipeline)
+: m_Pipeline(pipeline)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+TiledExecution::~TiledExecution() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledExecution::RegisterHalo(const QString& filterClassName, const HaloFactory& factory)
+{
+  QMutexLocker locker(&RegistryMutex());
+  Registry().insert(filterClassName, factory);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TiledExecution::Halo(const AbstractFilter::Pointer& filter)
+{
+  if(ElementwiseKernel::ForFilter(filter).get() != nullptr)
+  {
+    return 0;
+  }
+
+  HaloFactory factory;
+  {
+    QMutexLocker locker(&RegistryMutex());
+    QMap<QString, HaloFactory>::const_iterator iter = Registry().find(filter->getNameOfClass());
+    if(iter == Registry().end())
+    {
+      return -1;
+    }
+    factory = iter.value();
+  }
+  return factory(filter);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<TilingProblem> TiledExecution::FindProblems(const FilterPipeline::Pointer& pipeline)
+{
+  QVector<TilingProblem> problems;
+  QVector<AbstractFilter::Pointer> filters = EnabledFilters(pipeline);
+  if(filters.size() < 2)
+  {
+    problems.push_back({AbstractFilter::NullPointer(), QObject::tr("Tiled execution needs a pipeline that reads and writes a .dream3d file")});
+    return problems;
+  }
+
+  AbstractFilter::Pointer reader = filters.first();
+  AbstractFilter::Pointer writer = filters.last();
+  if(reader->getNameOfClass() != ReaderClassName)
+  {
+    problems.push_back({reader, QObject::tr("The first filter must read the volume from a .dream3d file so that slabs can be streamed from it")});
+  }
+  if(writer->getNameOfClass() != WriterClassName)
+  {
+    problems.push_back({writer, QObject::tr("The last filter must write a .dream3d file so that slabs can be streamed into it")});
+  }
+  else if(reader->getNameOfClass() == ReaderClassName && reader->property("InputFile").toString() == writer->property("OutputFile").toString())
+  {
+    problems.push_back({writer, QObject::tr("The output file must not be the input file")});
+  }
+
+  for(int i = 1; i < filters.size() - 1; i++)
+  {
+    if(Halo(filters[i]) < 0)
+    {
+      problems.push_back({filters[i], QObject::tr("%1 does not declare a bounded halo along Z and cannot be tiled").arg(filters[i]->getHumanLabel())});
+    }
+  }
+
+  DataContainerArray::Pointer structure = writer->getDataContainerArray();
+  if(structure.get() == nullptr)
+  {
+    return problems;
+  }
+
+  bool haveZ = false;
+  size_t zDim = 0;
+  QList<DataContainer::Pointer> containers = structure->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    ImageGeom::Pointer geom = dc->getGeometryAs<ImageGeom>();
+    if(geom.get() == nullptr)
+    {
+      problems.push_back({writer, QObject::tr("The Data Container '%1' does not have an Image geometry").arg(dc->getName())});
+      continue;
+    }
+    if(haveZ && geom->getZPoints() != zDim)
+    {
+      problems.push_back({writer, QObject::tr("The Data Container '%1' has a different number of Z slices").arg(dc->getName())});
+    }
+    zDim = geom->getZPoints();
+    haveZ = true;
+
+    DataContainer::AttributeMatrixMap_t& matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      if(am->getType() != AttributeMatrix::Type::Cell)
+      {
+        problems.push_back({writer, QObject::tr("The Attribute Matrix '%1/%2' is not a Cell attribute matrix").arg(dc->getName()).arg(am->getName())});
+      }
+    }
+  }
+
+  return problems;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledExecution::setSlabThickness(size_t thickness)
+{
+  m_SlabThickness = std::max(thickness, static_cast<size_t>(1));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t TiledExecution::getSlabThickness() const
+{
+  return m_SlabThickness;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledExecution::setMessageHandler(const MessageHandler& handler)
+{
+  m_MessageHandler = handler;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledExecution::setWriteProfile(WriteProfile::Preset preset)
+{
+  m_WriteProfile = preset;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WriteProfile::Preset TiledExecution::getWriteProfile() const
+{
+  return m_WriteProfile;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t TiledExecution::getSlabCount() const
+{
+  return m_SlabCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TiledExecution::getTotalHalo() const
+{
+  return m_TotalHalo;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t TiledExecution::getBytesRead() const
+{
+  return m_BytesRead;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t TiledExecution::getBytesWritten() const
+{
+  return m_BytesWritten;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledExecution::cancel()
+{
+  QVector<AbstractFilter::Pointer> filters = EnabledFilters(m_Pipeline);
+  for(const AbstractFilter::Pointer& filter : filters)
+  {
+    filter->setCancel(true);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool TiledExecution::isCanceled() const
+{
+  QVector<AbstractFilter::Pointer> filters = EnabledFilters(m_Pipeline);
+  for(const AbstractFilter::Pointer& filter : filters)
+  {
+    if(filter->getCancel())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledExecution::notify(PipelineMessage::MessageType type, const AbstractFilter::Pointer& filter, const QString& text, int code)
+{
+  if(!m_MessageHandler)
+  {
+    return;
+  }
+  PipelineMessage msg;
+  if(filter.get() != nullptr)
+  {
+    msg.setFilterClassName(filter->getNameOfClass());
+    msg.setFilterHumanLabel(filter->getHumanLabel());
+    msg.setPipelineIndex(filter->getPipelineIndex());
+  }
+  msg.setType(type);
+  msg.setCode(code);
+  msg.setText(text);
+  m_MessageHandler(msg);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TiledExecution::execute()
+{
+  m_SlabCount = 0;
+  m_TotalHalo = 0;
+  m_BytesRead = 0;
+  m_BytesWritten = 0;
+
+  // Holds the HDF5Lock while the files are opened, read, written or closed, but not while the slabs run
+  QMutexLocker ioLocker(HDF5Lock::Mutex());
+  int err = m_Pipeline->preflightPipeline();
+  if(err < 0)
+  {
+    return err;
+  }
+
+  QVector<TilingProblem> problems = FindProblems(m_Pipeline);
+  if(!problems.isEmpty())
+  {
+    for(const TilingProblem& problem : problems)
+    {
+      notify(PipelineMessage::MessageType::Error, problem.filter, QObject::tr("Tiled execution refused: %1").arg(problem.text), RefusedError);
+    }
+    return RefusedError;
+  }
+
+  QVector<AbstractFilter::Pointer> filters = EnabledFilters(m_Pipeline);
+  AbstractFilter::Pointer reader = filters.first();
+  AbstractFilter::Pointer writer = filters.last();
+  QVector<AbstractFilter::Pointer> tiled = filters.mid(1, filters.size() - 2);
+  for(const AbstractFilter::Pointer& filter : tiled)
+  {
+    m_TotalHalo += Halo(filter);
+  }
+
+  // Preflighting the reader alone gives the arrays it selects, preflighting the pipeline gives what is written
+  DataContainerArray::Pointer outputStructure = writer->getDataContainerArray();
+  DataContainerArray::Pointer inputStructure = DataContainerArray::New();
+  reader->setDataContainerArray(inputStructure);
+  reader->preflight();
+
+  size_t zDim = 0;
+  QList<DataContainer::Pointer> containers = outputStructure->getDataContainers();
+  if(!containers.isEmpty())
+  {
+    zDim = containers.first()->getGeometryAs<ImageGeom>()->getZPoints();
+  }
+
+  SlabFileReader slabReader(reader->property("InputFile").toString(), inputStructure);
+  if(!slabReader.open())
+  {
+    notify(PipelineMessage::MessageType::Error, reader, slabReader.getErrorMessage(), ReadError);
+    return ReadError;
+  }
+  SlabFileWriter slabWriter(writer->property("OutputFile").toString(), outputStructure);
+  slabWriter.setWriteProfile(WriteProfile::ForWriter(writer, m_WriteProfile));
+  if(!slabWriter.create(m_Pipeline))
+  {
+    notify(PipelineMessage::MessageType::Error, writer, slabWriter.getErrorMessage(), WriteError);
+    return WriteError;
+  }
+  if(writer->property("WriteXdmfFile").toBool())
+  {
+    notify(PipelineMessage::MessageType::Warning, writer, QObject::tr("No Xdmf file is written in tiled execution"));
+  }
+
+  ioLocker.unlock();
+
+  QVector<QMetaObject::Connection> connections;
+  for(const AbstractFilter::Pointer& filter : tiled)
+  {
+    connections.push_back(QObject::connect(filter.get(), &AbstractFilter::filterGeneratedMessage, [this](const PipelineMessage& msg) {
+      if(m_MessageHandler)
+      {
+        m_MessageHandler(msg);
+      }
+    }));
+  }
+
+  size_t halo = static_cast<size_t>(m_TotalHalo);
+  size_t slabTotal = (zDim + m_SlabThickness - 1) / m_SlabThickness;
+  notify(PipelineMessage::MessageType::StandardOutputMessage, AbstractFilter::NullPointer(),
+         QObject::tr("Executing %1 slabs of %2 Z slices with a halo of %3 slices").arg(slabTotal).arg(m_SlabThickness).arg(halo));
+
+  err = 0;
+  for(size_t zStart = 0; zStart < zDim && err >= 0; zStart += m_SlabThickness)
+  {
+    if(isCanceled())
+    {
+      break;
+    }
+
+    size_t zEnd = std::min(zDim, zStart + m_SlabThickness);
+    size_t readStart = (zStart > halo) ? zStart - halo : 0;
+    size_t readEnd = std::min(zDim, zEnd + halo);
+
+    PipelineMessage progress;
+    progress.setType(PipelineMessage::MessageType::ProgressValue);
+    progress.setProgressValue(static_cast<int>(100.0f * static_cast<float>(m_SlabCount) / static_cast<float>(slabTotal)));
+    if(m_MessageHandler)
+    {
+      m_MessageHandler(progress);
+    }
+    notify(PipelineMessage::MessageType::StatusMessage, AbstractFilter::NullPointer(),
+           QObject::tr("Slab %1/%2: Z slices %3 to %4").arg(m_SlabCount + 1).arg(slabTotal).arg(zStart).arg(zEnd - 1));
+
+    ioLocker.relock();
+    DataContainerArray::Pointer slab = slabReader.readSlab(readStart, readEnd);
+    ioLocker.unlock();
+    if(slab.get() == nullptr)
+    {
+      notify(PipelineMessage::MessageType::Error, reader, slabReader.getErrorMessage(), ReadError);
+      err = ReadError;
+      break;
+    }
+
+    for(const AbstractFilter::Pointer& filter : tiled)
+    {
+      filter->setDataContainerArray(slab);
+      filter->setErrorCondition(0);
+      filter->setWarningCondition(0);
+      filter->execute();
+      if(filter->getErrorCondition() < 0)
+      {
+        err = filter->getErrorCondition();
+        break;
+      }
+      if(isCanceled())
+      {
+        break;
+      }
+    }
+    if(err < 0 || isCanceled())
+    {
+      break;
+    }
+
+    ioLocker.relock();
+    bool written = slabWriter.writeSlab(slab, readStart, zStart, zEnd);
+    ioLocker.unlock();
+    if(!written)
+    {
+      notify(PipelineMessage::MessageType::Error, writer, slabWriter.getErrorMessage(), WriteError);
+      err = WriteError;
+      break;
+    }
+    m_SlabCount++;
+  }
+
+  for(const QMetaObject::Connection& connection : connections)
+  {
+    QObject::disconnect(connection);
+  }
+
+  ioLocker.relock();
+  m_BytesRead = slabReader.getBytesRead();
+  m_BytesWritten = slabWriter.getBytesWritten();
+  slabReader.close();
+  slabWriter.close();
+  ioLocker.unlock();
+
+  if(err >= 0 && !isCanceled())
+  {
+    notify(PipelineMessage::MessageType::StandardOutputMessage, AbstractFilter::NullPointer(),
+           QObject::tr("Tiled execution finished: %1 slabs, %2 MB read, %3 MB written")
+               .arg(m_SlabCount)
+               .arg(static_cast<double>(m_BytesRead) / (1024.0 * 1024.0), 0, 'f', 1)
+               .arg(static_cast<double>(m_BytesWritten) / (1024.0 * 1024.0), 0, 'f', 1));
+  }
+  return err;
+}
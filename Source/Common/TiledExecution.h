@@ -0,0 +1,167 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Common/PipelineMessage.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "Common/WriteProfile.h"
+
+/**
+ * @brief The TilingProblem struct names a filter that prevents a pipeline from being tiled and why
+ */
+struct TilingProblem
+{
+  AbstractFilter::Pointer filter;
+  QString text;
+};
+
+/**
+ * @brief The TiledExecution class executes a pipeline slab by slab along Z for volumes that do not fit
+ * in memory.
+ *
+ * A tileable pipeline starts with a DataContainerReader, ends with a DataContainerWriter and every filter
+ * in between declares a bounded halo: the number of Z slices on either side of a slice that it needs to
+ * compute that slice. The halos of all filters add up. Each slab is read from the input file together
+ * with that many extra slices on both sides, the filters in between are executed on it and only the
+ * slices that belong to the slab are streamed into the output file.
+ *
+ * Only Image geometries with Cell attribute matrices can be tiled. Filters with an ElementwiseKernel have
+ * a halo of 0; other filters declare their halo with RegisterHalo().
+ */
+class TiledExecution
+{
+public:
+  using HaloFactory = std::function<int(const AbstractFilter::Pointer&)>;
+  using MessageHandler = std::function<void(const PipelineMessage&)>;
+
+  explicit TiledExecution(FilterPipeline::Pointer pipeline);
+  virtual ~TiledExecution();
+
+  /**
+   * @brief RegisterHalo Declares the halo of filters of class 'filterClassName'. The factory returns the
+   * halo in Z slices for a filter instance or -1 if its parameters make it impossible to tile.
+   * @param filterClassName
+   * @param factory
+   */
+  static void RegisterHalo(const QString& filterClassName, const HaloFactory& factory);
+
+  /**
+   * @brief Halo Returns the halo of 'filter' in Z slices or -1 if the filter cannot be tiled
+   * @param filter
+   * @return
+   */
+  static int Halo(const AbstractFilter::Pointer& filter);
+
+  /**
+   * @brief FindProblems Returns everything that prevents 'pipeline' from being tiled. The pipeline
+   * must have been preflighted.
+   * @param pipeline
+   * @return
+   */
+  static QVector<TilingProblem> FindProblems(const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief setSlabThickness Sets the number of Z slices written per slab
+   * @param thickness
+   */
+  void setSlabThickness(size_t thickness);
+  size_t getSlabThickness() const;
+
+  /**
+   * @brief setMessageHandler Sets the function that receives every message of the execution and its filters
+   * @param handler
+   */
+  void setMessageHandler(const MessageHandler& handler);
+
+  /**
+   * @brief setWriteProfile Sets the profile the output file is written with unless the writer has its own
+   * @param preset
+   */
+  void setWriteProfile(WriteProfile::Preset preset);
+  WriteProfile::Preset getWriteProfile() const;
+
+  /**
+   * @brief execute Preflights the pipeline, refuses it if it cannot be tiled and otherwise runs every slab
+   * @return The error condition, 0 on success
+   */
+  int execute();
+
+  /**
+   * @brief cancel Cancels the filters of the pipeline. The execution stops after the current filter.
+   */
+  void cancel();
+
+  size_t getSlabCount() const;
+  int getTotalHalo() const;
+  size_t getBytesRead() const;
+  size_t getBytesWritten() const;
+
+protected:
+  /**
+   * @brief isCanceled Returns true if any filter of the pipeline has been canceled
+   * @return
+   */
+  bool isCanceled() const;
+
+  /**
+   * @brief notify Sends a message for 'filter', or for the pipeline when 'filter' is null
+   * @param type
+   * @param filter
+   * @param text
+   * @param code
+   */
+  void notify(PipelineMessage::MessageType type, const AbstractFilter::Pointer& filter, const QString& text, int code = 0);
+
+private:
+  FilterPipeline::Pointer m_Pipeline;
+  size_t m_SlabThickness = 32;
+  MessageHandler m_MessageHandler;
+  WriteProfile::Preset m_WriteProfile = WriteProfile::Preset::Default;
+  size_t m_SlabCount = 0;
+  int m_TotalHalo = 0;
+  size_t m_BytesRead = 0;
+  size_t m_BytesWritten = 0;
+
+  TiledExecution(const TiledExecution&) = delete; // Copy Constructor Not Implemented
+  void operator=(const TiledExecution&) = delete; // Move assignment Not Implemented
+};
@@ -0,0 +1,945 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "WriteProfile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+#include <QtCore/QVariant>
+
+#include "H5Support/QH5Lite.h"
+
+#include "Common/HDF5Lock.h"
+#include "Common/MemoryEstimator.h"
+#include "Common/ParallelChunkIO.h"
+
+const char* WriteProfile::PropertyName = "SIMPLViewWriteProfile";
+const QString WriteProfile::FileAttributeName("SIMPLViewWriteProfile");
+
+namespace
+{
+/**
+ * @brief The PresetLayout struct holds the settings behind one preset
+ */
+struct PresetLayout
+{
+  size_t chunkBytes;
+  bool sliceChunks;
+  bool shuffle;
+  int deflate;
+  size_t cacheBytes;
+};
+
+// A prime well above the number of chunks that fit in the largest cache
+const size_t CacheSlots = 12421;
+
+PresetLayout Layout(WriteProfile::Preset preset)
+{
+  switch(preset)
+  {
+  case WriteProfile::Preset::FastScratch:
+    return {16 * 1024 * 1024, false, false, 0, 64 * 1024 * 1024};
+  case WriteProfile::Preset::Archive:
+    return {1024 * 1024, false, true, 6, 16 * 1024 * 1024};
+  case WriteProfile::Preset::SliceAccess:
+    return {4 * 1024 * 1024, true, true, 1, 64 * 1024 * 1024};
+  case WriteProfile::Preset::Default:
+    break;
+  }
+  return {0, false, false, 0, 1024 * 1024};
+}
+
+/**
+ * @brief The CopyContext struct is handed to the HDF5 iteration callbacks of WriteProfile::rewrite()
+ */
+struct CopyContext
+{
+  const WriteProfile* profile;
+  hid_t destination;
+  WriteProfile::RewriteStats* stats;
+  QString errorMessage;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t CopyAttribute(hid_t location, const char* name, const H5A_info_t* /* info */, void* data)
+{
+  hid_t destination = *static_cast<hid_t*>(data);
+  hid_t attrId = H5Aopen(location, name, H5P_DEFAULT);
+  if(attrId < 0)
+  {
+    return -1;
+  }
+  hid_t type = H5Aget_type(attrId);
+  hid_t space = H5Aget_space(attrId);
+  hid_t memType = H5Tget_native_type(type, H5T_DIR_DEFAULT);
+  hssize_t points = std::max(H5Sget_simple_extent_npoints(space), static_cast<hssize_t>(1));
+  std::vector<char> buffer(static_cast<size_t>(points) * H5Tget_size(memType));
+
+  herr_t err = H5Aread(attrId, memType, buffer.data());
+  if(err >= 0)
+  {
+    hid_t copyId = H5Acreate2(destination, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+    err = (copyId >= 0) ? H5Awrite(copyId, memType, buffer.data()) : -1;
+    if(copyId >= 0)
+    {
+      H5Aclose(copyId);
+    }
+    // Variable length strings were allocated by the read
+    if(H5Tis_variable_str(memType) > 0 || H5Tdetect_class(memType, H5T_VLEN) > 0)
+    {
+      H5Dvlen_reclaim(memType, space, H5P_DEFAULT, buffer.data());
+    }
+  }
+  H5Tclose(memType);
+  H5Sclose(space);
+  H5Tclose(type);
+  H5Aclose(attrId);
+  return (err < 0) ? -1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool CopyAttributes(hid_t source, hid_t destination)
+{
+  return H5Aiterate2(source, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, CopyAttribute, &destination) >= 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<hsize_t> DatasetDims(hid_t datasetId, bool* numeric)
+{
+  hid_t type = H5Dget_type(datasetId);
+  H5T_class_t typeClass = H5Tget_class(type);
+  H5Tclose(type);
+
+  hid_t space = H5Dget_space(datasetId);
+  QVector<hsize_t> dims;
+  if(H5Sget_simple_extent_type(space) == H5S_SIMPLE)
+  {
+    dims.resize(H5Sget_simple_extent_ndims(space));
+    H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+  }
+  H5Sclose(space);
+  *numeric = (typeClass == H5T_INTEGER || typeClass == H5T_FLOAT) && !dims.isEmpty();
+  return dims;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool CopyRows(hid_t source, hid_t destination, hid_t memType, const QVector<hsize_t>& dims, hsize_t blockRows)
+{
+  size_t rowBytes = H5Tget_size(memType);
+  for(int i = 1; i < dims.size(); i++)
+  {
+    rowBytes *= dims[i];
+  }
+  std::vector<char> buffer(static_cast<size_t>(std::min(blockRows, dims[0])) * rowBytes);
+
+  // Both sides run the shuffle and deflate filters of their chunks on the thread pool
+  ParallelChunkIO sourceIO(source);
+  ParallelChunkIO destinationIO(destination);
+  bool ok = true;
+  for(hsize_t row = 0; row < dims[0] && ok; row += blockRows)
+  {
+    hsize_t rows = std::min(blockRows, dims[0] - row);
+    ok = sourceIO.readRows(memType, row, rows, buffer.data()) && destinationIO.writeRows(memType, row, rows, buffer.data());
+  }
+  return ok;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool CopyDataset(hid_t group, const char* name, CopyContext* context)
+{
+  hid_t source = H5Dopen2(group, name, H5P_DEFAULT);
+  if(source < 0)
+  {
+    return false;
+  }
+  bool numeric = false;
+  QVector<hsize_t> dims = DatasetDims(source, &numeric);
+  hid_t type = H5Dget_type(source);
+  size_t typeSize = H5Tget_size(type);
+  QVector<hsize_t> chunk = numeric ? context->profile->chunkDims(dims, typeSize) : QVector<hsize_t>();
+  context->stats->datasets++;
+
+  bool ok = false;
+  if(chunk.isEmpty())
+  {
+    // Strings, compound types and small datasets keep their layout
+    ok = H5Ocopy(group, name, context->destination, name, H5P_DEFAULT, H5P_DEFAULT) >= 0;
+  }
+  else
+  {
+    hid_t space = H5Dget_space(source);
+    hid_t dcpl = context->profile->createDatasetPList(dims, typeSize);
+    hid_t dapl = context->profile->createAccessPList();
+    hid_t destination = H5Dcreate2(context->destination, name, type, space, H5P_DEFAULT, dcpl, dapl);
+    H5Pclose(dapl);
+    H5Pclose(dcpl);
+    H5Sclose(space);
+    if(destination >= 0)
+    {
+      // Whole chunks of the slowest dimension at a time, so no chunk is written twice
+      size_t rowBytes = typeSize;
+      for(int i = 1; i < dims.size(); i++)
+      {
+        rowBytes *= dims[i];
+      }
+      hsize_t blockRows = std::max(static_cast<hsize_t>(WriteProfile::CopyBlockBytes / std::max(rowBytes, static_cast<size_t>(1))), chunk[0]);
+      blockRows -= blockRows % chunk[0];
+      ok = CopyAttributes(source, destination) && CopyRows(source, destination, type, dims, blockRows);
+      H5Dclose(destination);
+      context->stats->chunkedDatasets++;
+    }
+  }
+  H5Tclose(type);
+  H5Dclose(source);
+  if(!ok)
+  {
+    context->errorMessage = QObject::tr("The dataset '%1' could not be copied").arg(QString::fromLatin1(name));
+  }
+  return ok;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t CopyLink(hid_t group, const char* name, const H5L_info_t* info, void* data)
+{
+  CopyContext* context = static_cast<CopyContext*>(data);
+  if(info->type == H5L_TYPE_SOFT || info->type == H5L_TYPE_EXTERNAL)
+  {
+    std::vector<char> value(info->u.val_size);
+    bool ok = H5Lget_val(group, name, value.data(), value.size(), H5P_DEFAULT) >= 0;
+    if(ok && info->type == H5L_TYPE_SOFT)
+    {
+      ok = H5Lcreate_soft(value.data(), context->destination, name, H5P_DEFAULT, H5P_DEFAULT) >= 0;
+    }
+    else if(ok)
+    {
+      const char* fileName = nullptr;
+      const char* objectName = nullptr;
+      ok = H5Lunpack_elink_val(value.data(), value.size(), nullptr, &fileName, &objectName) >= 0 &&
+           H5Lcreate_external(fileName, objectName, context->destination, name, H5P_DEFAULT, H5P_DEFAULT) >= 0;
+    }
+    return ok ? 0 : -1;
+  }
+
+  hid_t objectId = H5Oopen(group, name, H5P_DEFAULT);
+  if(objectId < 0)
+  {
+    return -1;
+  }
+  H5I_type_t objectType = H5Iget_type(objectId);
+  bool ok = false;
+  if(objectType == H5I_GROUP)
+  {
+    hid_t copyId = H5Gcreate2(context->destination, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if(copyId >= 0)
+    {
+      CopyContext member = *context;
+      member.destination = copyId;
+      ok = CopyAttributes(objectId, copyId) && H5Literate(objectId, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, CopyLink, &member) >= 0;
+      context->errorMessage = member.errorMessage;
+      H5Gclose(copyId);
+    }
+  }
+  else if(objectType == H5I_DATASET)
+  {
+    ok = CopyDataset(group, name, context);
+  }
+  else
+  {
+    ok = H5Ocopy(group, name, context->destination, name, H5P_DEFAULT, H5P_DEFAULT) >= 0;
+  }
+  H5Oclose(objectId);
+  return ok ? 0 : -1;
+}
+
+/**
+ * @brief The LargestDataset struct is handed to FindLargestDataset() while it walks a file
+ */
+struct LargestDataset
+{
+  QString path;
+  QString prefix;
+  size_t bytes = 0;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t FindLargestDataset(hid_t group, const char* name, const H5L_info_t* info, void* data)
+{
+  LargestDataset* largest = static_cast<LargestDataset*>(data);
+  if(info->type != H5L_TYPE_HARD)
+  {
+    return 0;
+  }
+  hid_t objectId = H5Oopen(group, name, H5P_DEFAULT);
+  if(objectId < 0)
+  {
+    return 0;
+  }
+  QString path = largest->prefix + "/" + QString::fromLatin1(name);
+  H5I_type_t objectType = H5Iget_type(objectId);
+  if(objectType == H5I_GROUP)
+  {
+    QString prefix = largest->prefix;
+    largest->prefix = path;
+    H5Literate(objectId, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, FindLargestDataset, largest);
+    largest->prefix = prefix;
+  }
+  else if(objectType == H5I_DATASET)
+  {
+    bool numeric = false;
+    QVector<hsize_t> dims = DatasetDims(objectId, &numeric);
+    hid_t type = H5Dget_type(objectId);
+    size_t bytes = H5Tget_size(type);
+    H5Tclose(type);
+    for(hsize_t dim : dims)
+    {
+      bytes *= dim;
+    }
+    if(numeric && bytes > largest->bytes)
+    {
+      largest->path = path;
+      largest->bytes = bytes;
+    }
+  }
+  H5Oclose(objectId);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double Throughput(size_t bytes, qint64 msecs)
+{
+  return static_cast<double>(bytes) / (1024.0 * 1024.0) / (static_cast<double>(std::max(msecs, static_cast<qint64>(1))) / 1000.0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MeasurePreset(WriteProfile::Measurement& measurement, const QString& filePath, hid_t memType, const QVector<hsize_t>& dims, const std::vector<char>& sample)
+{
+  WriteProfile profile(measurement.preset);
+  QByteArray path = filePath.toLocal8Bit();
+  QElapsedTimer timer;
+
+  // The write counts until the file is closed, so the compression and the flush are included
+  timer.start();
+  hid_t fileId = H5Fcreate(path.constData(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if(fileId < 0)
+  {
+    measurement.errorMessage = QObject::tr("The file '%1' could not be created").arg(filePath);
+    return;
+  }
+  hid_t space = H5Screate_simple(dims.size(), dims.data(), nullptr);
+  hid_t dcpl = profile.createDatasetPList(dims, H5Tget_size(memType));
+  hid_t dapl = profile.createAccessPList();
+  hid_t datasetId = H5Dcreate2(fileId, "Sample", memType, space, H5P_DEFAULT, dcpl, dapl);
+  bool ok = false;
+  if(datasetId >= 0)
+  {
+    ok = ParallelChunkIO(datasetId).writeRows(memType, 0, dims[0], sample.data());
+    H5Dclose(datasetId);
+  }
+  H5Pclose(dcpl);
+  H5Sclose(space);
+  H5Fclose(fileId);
+  measurement.writeMsecs = timer.elapsed();
+  measurement.fileBytes = static_cast<size_t>(QFileInfo(filePath).size());
+  if(!ok)
+  {
+    H5Pclose(dapl);
+    measurement.errorMessage = QObject::tr("The sample could not be written");
+    return;
+  }
+
+  std::vector<char> buffer(sample.size());
+  timer.restart();
+  fileId = H5Fopen(path.constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  datasetId = H5Dopen2(fileId, "Sample", dapl);
+  ok = ParallelChunkIO(datasetId).readRows(memType, 0, dims[0], buffer.data());
+  H5Dclose(datasetId);
+  H5Fclose(fileId);
+  measurement.readMsecs = timer.elapsed();
+
+  // One slice of the slowest dimension at a time, the way a viewer or a slab reader reads
+  timer.restart();
+  fileId = H5Fopen(path.constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  datasetId = H5Dopen2(fileId, "Sample", dapl);
+  {
+    ParallelChunkIO sliceIO(datasetId);
+    for(hsize_t slice = 0; slice < dims[0] && ok; slice++)
+    {
+      ok = sliceIO.readRows(memType, slice, 1, buffer.data());
+    }
+  }
+  H5Dclose(datasetId);
+  H5Fclose(fileId);
+  H5Pclose(dapl);
+  measurement.sliceReadMsecs = timer.elapsed();
+  if(!ok)
+  {
+    measurement.errorMessage = QObject::tr("The sample could not be read back");
+  }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WriteProfile::WriteProfile(Preset preset)
+: m_Preset(preset)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WriteProfile::~WriteProfile() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString WriteProfile::PresetName(Preset preset)
+{
+  switch(preset)
+  {
+  case Preset::FastScratch:
+    return QString("fast-scratch");
+  case Preset::Archive:
+    return QString("archive");
+  case Preset::SliceAccess:
+    return QString("slice-access");
+  case Preset::Default:
+    break;
+  }
+  return QString("default");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WriteProfile::Preset WriteProfile::PresetFromName(const QString& name, bool* ok)
+{
+  for(Preset preset : Presets())
+  {
+    if(name.compare(PresetName(preset), Qt::CaseInsensitive) == 0)
+    {
+      if(ok != nullptr)
+      {
+        *ok = true;
+      }
+      return preset;
+    }
+  }
+  if(ok != nullptr)
+  {
+    *ok = false;
+  }
+  return Preset::Default;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<WriteProfile::Preset> WriteProfile::Presets()
+{
+  return QVector<Preset>() << Preset::Default << Preset::FastScratch << Preset::Archive << Preset::SliceAccess;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString WriteProfile::Description(Preset preset)
+{
+  switch(preset)
+  {
+  case Preset::FastScratch:
+    return QObject::tr("Large uncompressed chunks for intermediate files that are read back soon");
+  case Preset::Archive:
+    return QObject::tr("Small shuffled chunks with strong compression for the smallest files");
+  case Preset::SliceAccess:
+    return QObject::tr("One Z slice per chunk with light compression for reading slice by slice");
+  case Preset::Default:
+    break;
+  }
+  return QObject::tr("The contiguous layout of the writers, which can be mapped into memory");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WriteProfile::SetWriterPreset(const AbstractFilter::Pointer& filter, const QString& name)
+{
+  filter->setProperty(PropertyName, name.isEmpty() ? QVariant() : QVariant(name));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString WriteProfile::GetWriterPreset(const AbstractFilter::Pointer& filter)
+{
+  return filter->property(PropertyName).toString();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WriteProfile::ReadWriterPresets(const QJsonObject& root, const FilterPipeline::Pointer& pipeline, int firstFilter)
+{
+  // The filters of a pipeline file are objects keyed by their index
+  FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+  for(int i = 0; firstFilter + i < filters.size(); i++)
+  {
+    QString name = root[QString::number(i)].toObject()[PropertyName].toString();
+    bool ok = false;
+    PresetFromName(name, &ok);
+    if(ok)
+    {
+      SetWriterPreset(filters[firstFilter + i], name);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WriteProfile::WriteWriterPresets(const FilterPipeline::Pointer& pipeline, QJsonObject& root)
+{
+  FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+  for(int i = 0; i < filters.size(); i++)
+  {
+    QString key = QString::number(i);
+    if(!root.contains(key))
+    {
+      continue;
+    }
+    QJsonObject filterObj = root[key].toObject();
+    QString name = GetWriterPreset(filters[i]);
+    if(name.isEmpty())
+    {
+      filterObj.remove(PropertyName);
+    }
+    else
+    {
+      filterObj[PropertyName] = name;
+    }
+    root[key] = filterObj;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WriteProfile WriteProfile::ForWriter(const AbstractFilter::Pointer& filter, Preset global)
+{
+  bool ok = false;
+  Preset preset = PresetFromName(GetWriterPreset(filter), &ok);
+  return WriteProfile(ok ? preset : global);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WriteProfile WriteProfile::FromFile(hid_t fileId)
+{
+  QString name;
+  if(H5Aexists_by_name(fileId, "/", FileAttributeName.toLatin1().constData(), H5P_DEFAULT) > 0)
+  {
+    QH5Lite::readStringAttribute(fileId, "/", FileAttributeName, name);
+  }
+  return WriteProfile(PresetFromName(name));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<WriteProfile::Measurement> WriteProfile::Measure(const QString& sourceFile, const QString& directory, QString* errorMessage)
+{
+  QVector<Measurement> measurements;
+  QMutexLocker ioLocker(HDF5Lock::Mutex());
+  hid_t fileId = H5Fopen(sourceFile.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if(fileId < 0)
+  {
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = QObject::tr("The file '%1' could not be opened").arg(sourceFile);
+    }
+    return measurements;
+  }
+
+  LargestDataset largest;
+  H5Literate(fileId, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, FindLargestDataset, &largest);
+  hid_t datasetId = largest.path.isEmpty() ? -1 : H5Dopen2(fileId, largest.path.toLatin1().constData(), H5P_DEFAULT);
+  if(datasetId < 0)
+  {
+    H5Fclose(fileId);
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = QObject::tr("The file '%1' holds no numeric dataset").arg(sourceFile);
+    }
+    return measurements;
+  }
+
+  // The first slices of the dataset, as many as fit in the sample
+  bool numeric = false;
+  QVector<hsize_t> dims = DatasetDims(datasetId, &numeric);
+  hid_t type = H5Dget_type(datasetId);
+  hid_t memType = H5Tget_native_type(type, H5T_DIR_DEFAULT);
+  H5Tclose(type);
+  size_t rowBytes = H5Tget_size(memType);
+  for(int i = 1; i < dims.size(); i++)
+  {
+    rowBytes *= dims[i];
+  }
+  dims[0] = std::max(std::min(dims[0], static_cast<hsize_t>(MaxSampleBytes / std::max(rowBytes, static_cast<size_t>(1)))), static_cast<hsize_t>(1));
+  std::vector<char> sample(static_cast<size_t>(dims[0]) * rowBytes);
+
+  hid_t fileSpace = H5Dget_space(datasetId);
+  QVector<hsize_t> start(dims.size(), 0);
+  H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start.data(), nullptr, dims.data(), nullptr);
+  hid_t memSpace = H5Screate_simple(dims.size(), dims.data(), nullptr);
+  bool ok = H5Dread(datasetId, memType, memSpace, fileSpace, H5P_DEFAULT, sample.data()) >= 0;
+  H5Sclose(memSpace);
+  H5Sclose(fileSpace);
+  H5Dclose(datasetId);
+  H5Fclose(fileId);
+  if(!ok)
+  {
+    H5Tclose(memType);
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = QObject::tr("The dataset '%1' could not be read").arg(largest.path);
+    }
+    return measurements;
+  }
+
+  for(Preset preset : Presets())
+  {
+    Measurement measurement;
+    measurement.preset = preset;
+    measurement.dataset = largest.path;
+    measurement.sampleBytes = sample.size();
+    QString filePath = QDir(directory).absoluteFilePath(QString("write-profile-%1.h5").arg(PresetName(preset)));
+    MeasurePreset(measurement, filePath, memType, dims, sample);
+    QFile::remove(filePath);
+    measurements.push_back(measurement);
+  }
+  H5Tclose(memType);
+  return measurements;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList WriteProfile::MeasurementReport(const QVector<Measurement>& measurements)
+{
+  QStringList lines;
+  if(measurements.isEmpty())
+  {
+    return lines;
+  }
+  lines << QObject::tr("Write profiles measured with %1 of '%2'; reads may be served from the page cache")
+               .arg(MemoryEstimator::FormatBytes(measurements.front().sampleBytes))
+               .arg(measurements.front().dataset);
+  for(const Measurement& measurement : measurements)
+  {
+    if(!measurement.errorMessage.isEmpty())
+    {
+      lines << QObject::tr("  %1: %2").arg(PresetName(measurement.preset), -13).arg(measurement.errorMessage);
+      continue;
+    }
+    lines << QObject::tr("  %1: %2 file (%3% of the sample), writes %4 MB/s, reads %5 MB/s whole and %6 MB/s slice by slice")
+                 .arg(PresetName(measurement.preset), -13)
+                 .arg(MemoryEstimator::FormatBytes(measurement.fileBytes))
+                 .arg(100.0 * static_cast<double>(measurement.fileBytes) / static_cast<double>(std::max(measurement.sampleBytes, static_cast<size_t>(1))), 0, 'f', 0)
+                 .arg(Throughput(measurement.sampleBytes, measurement.writeMsecs), 0, 'f', 0)
+                 .arg(Throughput(measurement.sampleBytes, measurement.readMsecs), 0, 'f', 0)
+                 .arg(Throughput(measurement.sampleBytes, measurement.sliceReadMsecs), 0, 'f', 0);
+  }
+  return lines;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WriteProfile::Preset WriteProfile::getPreset() const
+{
+  return m_Preset;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString WriteProfile::getName() const
+{
+  return PresetName(m_Preset);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool WriteProfile::isDefault() const
+{
+  return m_Preset == Preset::Default;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<hsize_t> WriteProfile::chunkDims(const QVector<hsize_t>& dims, size_t typeSize) const
+{
+  QVector<hsize_t> chunk;
+  if(isDefault() || dims.isEmpty())
+  {
+    return chunk;
+  }
+  size_t bytes = typeSize;
+  for(hsize_t dim : dims)
+  {
+    bytes *= dim;
+  }
+  // Chunking a tiny dataset only adds an index to it
+  if(bytes < MinChunkedBytes)
+  {
+    return chunk;
+  }
+
+  PresetLayout layout = Layout(m_Preset);
+  chunk = dims;
+  // Image arrays are Z, Y, X and the components
+  if(layout.sliceChunks && dims.size() >= 3)
+  {
+    chunk[0] = 1;
+  }
+  auto chunkBytes = [&chunk, typeSize] {
+    size_t total = typeSize;
+    for(hsize_t dim : chunk)
+    {
+      total *= dim;
+    }
+    return total;
+  };
+  // Halve the slowest dimensions first, so a chunk stays a run of whole rows for as long as possible
+  int i = 0;
+  while(i < chunk.size() && chunkBytes() > layout.chunkBytes)
+  {
+    if(chunk[i] <= 1)
+    {
+      i++;
+      continue;
+    }
+    chunk[i] = (chunk[i] + 1) / 2;
+  }
+  return chunk;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t WriteProfile::createDatasetPList(const QVector<hsize_t>& dims, size_t typeSize) const
+{
+  hid_t plist = H5Pcreate(H5P_DATASET_CREATE);
+  QVector<hsize_t> chunk = chunkDims(dims, typeSize);
+  if(chunk.isEmpty())
+  {
+    return plist;
+  }
+  PresetLayout layout = Layout(m_Preset);
+  H5Pset_chunk(plist, chunk.size(), chunk.data());
+  if(layout.shuffle && typeSize > 1)
+  {
+    H5Pset_shuffle(plist);
+  }
+  if(layout.deflate > 0)
+  {
+    H5Pset_deflate(plist, static_cast<unsigned>(layout.deflate));
+  }
+  return plist;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t WriteProfile::createAccessPList() const
+{
+  hid_t plist = H5Pcreate(H5P_DATASET_ACCESS);
+  if(!isDefault())
+  {
+    // Chunks are written and read once each, so fully used chunks are evicted first
+    H5Pset_chunk_cache(plist, CacheSlots, Layout(m_Preset).cacheBytes, 1.0);
+  }
+  return plist;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool WriteProfile::rewrite(const QString& filePath, RewriteStats* stats, QString* errorMessage) const
+{
+  QElapsedTimer timer;
+  timer.start();
+  RewriteStats local;
+  QFileInfo fileInfo(filePath);
+  local.bytesBefore = static_cast<size_t>(fileInfo.size());
+  QString tempPath = fileInfo.absoluteDir().absoluteFilePath(QString(".%1.%2").arg(fileInfo.fileName()).arg(getName()));
+
+  CopyContext context = {this, -1, &local, QString()};
+  QMutexLocker ioLocker(HDF5Lock::Mutex());
+  hid_t sourceId = H5Fopen(fileInfo.absoluteFilePath().toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if(sourceId < 0)
+  {
+    context.errorMessage = QObject::tr("The file '%1' could not be opened").arg(filePath);
+  }
+  else
+  {
+    context.destination = H5Fcreate(tempPath.toLocal8Bit().constData(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if(context.destination < 0)
+    {
+      context.errorMessage = QObject::tr("The file '%1' could not be created").arg(tempPath);
+    }
+  }
+
+  bool ok = context.destination >= 0 && CopyAttributes(sourceId, context.destination) &&
+            H5Literate(sourceId, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, CopyLink, &context) >= 0 &&
+            QH5Lite::writeStringAttribute(context.destination, "/", FileAttributeName, getName()) >= 0;
+  if(context.destination >= 0)
+  {
+    ok = H5Fclose(context.destination) >= 0 && ok;
+  }
+  if(sourceId >= 0)
+  {
+    H5Fclose(sourceId);
+  }
+
+  if(ok && std::rename(tempPath.toLocal8Bit().constData(), fileInfo.absoluteFilePath().toLocal8Bit().constData()) != 0)
+  {
+    // Windows does not replace an existing file on rename
+    ok = QFile::remove(fileInfo.absoluteFilePath()) && QFile::rename(tempPath, fileInfo.absoluteFilePath());
+    if(!ok)
+    {
+      context.errorMessage = QObject::tr("The file '%1' could not be replaced").arg(filePath);
+    }
+  }
+  if(!ok)
+  {
+    QFile::remove(tempPath);
+    if(errorMessage != nullptr)
+    {
+      *errorMessage = context.errorMessage.isEmpty() ? QObject::tr("The file '%1' could not be rewritten").arg(filePath) : context.errorMessage;
+    }
+    return false;
+  }
+
+  local.bytesAfter = static_cast<size_t>(QFileInfo(fileInfo.absoluteFilePath()).size());
+  local.msecs = timer.elapsed();
+  if(stats != nullptr)
+  {
+    *stats = local;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool WriteProfile::copyObject(hid_t sourceGroup, const QString& name, hid_t destinationGroup, QString* errorMessage) const
+{
+  RewriteStats stats;
+  CopyContext context = {this, destinationGroup, &stats, QString()};
+  QByteArray linkName = name.toLatin1();
+  H5L_info_t info;
+  bool ok = H5Lget_info(sourceGroup, linkName.constData(), &info, H5P_DEFAULT) >= 0 && CopyLink(sourceGroup, linkName.constData(), &info, &context) >= 0;
+  if(!ok && errorMessage != nullptr)
+  {
+    *errorMessage = context.errorMessage.isEmpty() ? QObject::tr("The object '%1' could not be copied").arg(name) : context.errorMessage;
+  }
+  return ok;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool WriteProfile::applyTo(const QString& filePath, QString* message) const
+{
+  if(isDefault() || !QFileInfo(filePath).isFile() || H5Fis_hdf5(filePath.toLocal8Bit().constData()) <= 0)
+  {
+    return true;
+  }
+  RewriteStats stats;
+  QString errorMessage;
+  bool ok = rewrite(filePath, &stats, &errorMessage);
+  if(message != nullptr)
+  {
+    *message = ok ? rewriteSummary(filePath, stats) : QObject::tr("The %1 write profile was not applied: %2").arg(getName()).arg(errorMessage);
+  }
+  return ok;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString WriteProfile::rewriteSummary(const QString& filePath, const RewriteStats& stats) const
+{
+  return QObject::tr("Rewrote '%1' with the %2 write profile: %3 of %4 datasets chunked, %5 to %6 in %7 ms")
+      .arg(filePath)
+      .arg(getName())
+      .arg(stats.chunkedDatasets)
+      .arg(stats.datasets)
+      .arg(MemoryEstimator::FormatBytes(stats.bytesBefore))
+      .arg(MemoryEstimator::FormatBytes(stats.bytesAfter))
+      .arg(stats.msecs);
+}
@@ -0,0 +1,273 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <hdf5.h>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The WriteProfile class describes how the datasets of an HDF5 output file are laid out: the chunk
+ * shape, the built-in shuffle and deflate filters and the chunk cache used while the file is written and
+ * read back.
+ *
+ * The presets are tuned for how an output is used next:
+ * @li default keeps the contiguous layout the writers produce, which is also the only layout that
+ * MappedFileReader can map
+ * @li fast-scratch uses large chunks without filters for intermediate files that are read back soon
+ * @li archive uses chunks of about 1 MB with shuffle and deflate level 6 for the smallest files
+ * @li slice-access uses one Z slice per chunk with shuffle and deflate level 1, so reading a slice
+ * decompresses nothing else
+ *
+ * Writer filters write their file with the layout of SIMPL; rewrite() then copies every numeric dataset of
+ * the finished file into the layout of the profile. The name of the profile is stored in the file so
+ * readers can size their chunk cache to match.
+ */
+class WriteProfile
+{
+public:
+  enum class Preset : int
+  {
+    Default = 0,
+    FastScratch = 1,
+    Archive = 2,
+    SliceAccess = 3
+  };
+
+  /**
+   * @brief The RewriteStats struct describes one rewritten file
+   */
+  struct RewriteStats
+  {
+    int datasets = 0;
+    int chunkedDatasets = 0;
+    size_t bytesBefore = 0;
+    size_t bytesAfter = 0;
+    qint64 msecs = 0;
+  };
+
+  /**
+   * @brief The Measurement struct holds the result of writing and reading the sample with one profile
+   */
+  struct Measurement
+  {
+    Preset preset = Preset::Default;
+    QString dataset;
+    size_t sampleBytes = 0;
+    size_t fileBytes = 0;
+    qint64 writeMsecs = 0;
+    qint64 readMsecs = 0;
+    qint64 sliceReadMsecs = 0;
+    QString errorMessage;
+  };
+
+  /**
+   * @brief PropertyName The name of the dynamic property that holds the profile a writer filter uses
+   * instead of the global one
+   */
+  static const char* PropertyName;
+
+  /**
+   * @brief FileAttributeName The root attribute of a rewritten file that names its profile
+   */
+  static const QString FileAttributeName;
+
+  static const int RewriteError = -9434;
+
+  static const size_t MinChunkedBytes = 64 * 1024;
+  static const size_t CopyBlockBytes = 64 * 1024 * 1024;
+  static const size_t MaxSampleBytes = 256 * 1024 * 1024;
+
+  static QString PresetName(Preset preset);
+  static Preset PresetFromName(const QString& name, bool* ok = nullptr);
+  static QVector<Preset> Presets();
+
+  /**
+   * @brief Description Returns one line that tells what 'preset' is meant for
+   * @param preset
+   * @return
+   */
+  static QString Description(Preset preset);
+
+  /**
+   * @brief SetWriterPreset Makes a writer filter use 'name' instead of the global profile. An empty name
+   * makes it follow the global profile again.
+   * @param filter
+   * @param name
+   */
+  static void SetWriterPreset(const AbstractFilter::Pointer& filter, const QString& name);
+
+  /**
+   * @brief GetWriterPreset Returns the name set with SetWriterPreset(), empty if the filter follows the
+   * global profile
+   * @param filter
+   * @return
+   */
+  static QString GetWriterPreset(const AbstractFilter::Pointer& filter);
+
+  /**
+   * @brief ReadWriterPresets Sets the profile of every filter of 'pipeline' whose object in the pipeline
+   * file object 'root' has a "SIMPLViewWriteProfile" key
+   * @param root
+   * @param pipeline
+   * @param firstFilter The index in 'pipeline' of the first filter of the file
+   */
+  static void ReadWriterPresets(const QJsonObject& root, const FilterPipeline::Pointer& pipeline, int firstFilter = 0);
+
+  /**
+   * @brief WriteWriterPresets Adds a "SIMPLViewWriteProfile" key to the object in the pipeline file object
+   * 'root' of every filter of 'pipeline' that has its own profile, and removes it from the others
+   * @param pipeline
+   * @param root
+   */
+  static void WriteWriterPresets(const FilterPipeline::Pointer& pipeline, QJsonObject& root);
+
+  /**
+   * @brief ForWriter Returns the profile 'filter' writes with when the global profile is 'global'
+   * @param filter
+   * @param global
+   * @return
+   */
+  static WriteProfile ForWriter(const AbstractFilter::Pointer& filter, Preset global);
+
+  /**
+   * @brief FromFile Returns the profile a file was written with according to its root attribute
+   * @param fileId
+   * @return
+   */
+  static WriteProfile FromFile(hid_t fileId);
+
+  /**
+   * @brief Measure Writes the largest numeric dataset of 'sourceFile' into 'directory' with every profile
+   * and reads it back whole and slice by slice. At most MaxSampleBytes of the dataset are used.
+   * @param sourceFile
+   * @param directory
+   * @param errorMessage
+   * @return One measurement per profile, empty if no sample could be read
+   */
+  static QVector<Measurement> Measure(const QString& sourceFile, const QString& directory, QString* errorMessage = nullptr);
+
+  /**
+   * @brief MeasurementReport Returns the measurements as lines for a report
+   * @param measurements
+   * @return
+   */
+  static QStringList MeasurementReport(const QVector<Measurement>& measurements);
+
+  explicit WriteProfile(Preset preset = Preset::Default);
+  virtual ~WriteProfile();
+
+  Preset getPreset() const;
+  QString getName() const;
+
+  /**
+   * @brief isDefault Returns true if the profile keeps the layout of the writers
+   * @return
+   */
+  bool isDefault() const;
+
+  /**
+   * @brief chunkDims Returns the chunk shape for a dataset of 'dims', slowest first, or an empty vector
+   * if the dataset stays contiguous
+   * @param dims
+   * @param typeSize
+   * @return
+   */
+  QVector<hsize_t> chunkDims(const QVector<hsize_t>& dims, size_t typeSize) const;
+
+  /**
+   * @brief createDatasetPList Returns a new dataset creation property list with the chunk shape and the
+   * filters of the profile. The caller closes it.
+   * @param dims
+   * @param typeSize
+   * @return
+   */
+  hid_t createDatasetPList(const QVector<hsize_t>& dims, size_t typeSize) const;
+
+  /**
+   * @brief createAccessPList Returns a new dataset access property list with the chunk cache of the
+   * profile. The caller closes it.
+   * @return
+   */
+  hid_t createAccessPList() const;
+
+  /**
+   * @brief rewrite Copies the HDF5 file at 'filePath' into the layout of the profile and replaces it. The
+   * original is kept if anything fails.
+   * @param filePath
+   * @param stats
+   * @param errorMessage
+   * @return
+   */
+  bool rewrite(const QString& filePath, RewriteStats* stats = nullptr, QString* errorMessage = nullptr) const;
+
+  /**
+   * @brief copyObject Copies the object 'name' of 'sourceGroup', and everything below it, into
+   * 'destinationGroup' with its numeric datasets in the layout of the profile
+   * @param sourceGroup
+   * @param name
+   * @param destinationGroup
+   * @param errorMessage
+   * @return
+   */
+  bool copyObject(hid_t sourceGroup, const QString& name, hid_t destinationGroup, QString* errorMessage = nullptr) const;
+
+  /**
+   * @brief applyTo Rewrites 'filePath' with the profile unless the profile is the default one or the file
+   * is not an HDF5 file
+   * @param filePath
+   * @param message Receives what was rewritten or why it failed, stays empty if nothing was done
+   * @return false if the rewrite failed. The file is then left as it was written.
+   */
+  bool applyTo(const QString& filePath, QString* message) const;
+
+  /**
+   * @brief rewriteSummary Returns one line that describes a rewrite of 'filePath'
+   * @param filePath
+   * @param stats
+   * @return
+   */
+  QString rewriteSummary(const QString& filePath, const RewriteStats& stats) const;
+
+private:
+  Preset m_Preset = Preset::Default;
+};
@@ -0,0 +1,252 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ArrayMemoryWidget.h"
+
+#include <QtWidgets/QAction>
+#include <QtWidgets/QMenu>
+
+namespace
+{
+const int k_PathRole = Qt::UserRole + 1;
+const int k_ResultRole = Qt::UserRole + 2;
+const int k_PublishedRole = Qt::UserRole + 3;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayMemoryWidget::ArrayMemoryWidget(QWidget* parent)
+: QWidget(parent)
+{
+  setupUi(this);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ArrayMemoryWidget::~ArrayMemoryWidget() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ArrayMemoryWidget::FormatBytes(size_t bytes)
+{
+  const double k_KiB = 1024.0;
+  double value = static_cast<double>(bytes);
+  if(value < k_KiB)
+  {
+    return QString("%1 B").arg(bytes);
+  }
+  if(value < k_KiB * k_KiB)
+  {
+    return QString("%1 KiB").arg(value / k_KiB, 0, 'f', 1);
+  }
+  if(value < k_KiB * k_KiB * k_KiB)
+  {
+    return QString("%1 MiB").arg(value / (k_KiB * k_KiB), 0, 'f', 1);
+  }
+  return QString("%1 GiB").arg(value / (k_KiB * k_KiB * k_KiB), 0, 'f', 2);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryWidget::clearArrays()
+{
+  arrayTree->clear();
+  summaryLabel->setText(tr("No arrays have been released"));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryWidget::addArray(const DataArrayPath& path, const QString& status, size_t bytes, const QString& detail)
+{
+  QTreeWidgetItem* item = new QTreeWidgetItem(arrayTree);
+  item->setText(0, path.serialize("/"));
+  item->setText(1, status);
+  item->setText(2, FormatBytes(bytes));
+  item->setText(3, detail);
+  item->setData(0, k_PathRole, path.serialize("/"));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryWidget::clearResultArrays()
+{
+  for(int i = arrayTree->topLevelItemCount() - 1; i >= 0; i--)
+  {
+    if(arrayTree->topLevelItem(i)->data(0, k_ResultRole).toBool())
+    {
+      delete arrayTree->takeTopLevelItem(i);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryWidget::addResultArray(const DataArrayPath& path, size_t bytes, const QString& segment)
+{
+  QTreeWidgetItem* item = new QTreeWidgetItem(arrayTree);
+  item->setText(0, path.serialize("/"));
+  item->setText(1, segment.isEmpty() ? tr("Result") : tr("Published"));
+  item->setText(2, FormatBytes(bytes));
+  item->setText(3, segment.isEmpty() ? QString() : tr("Shared memory segment %1").arg(segment));
+  item->setData(0, k_PathRole, path.serialize("/"));
+  item->setData(0, k_ResultRole, true);
+  item->setData(0, k_PublishedRole, !segment.isEmpty());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryWidget::setSummary(const QString& summary)
+{
+  summaryLabel->setText(summary);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryWidget::setKeptArrayPaths(const QVector<DataArrayPath>& paths)
+{
+  m_KeptArrayPaths = paths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<DataArrayPath> ArrayMemoryWidget::getKeptArrayPaths() const
+{
+  return m_KeptArrayPaths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryWidget::setCompressedArrayPaths(const QVector<DataArrayPath>& paths)
+{
+  m_CompressedArrayPaths = paths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<DataArrayPath> ArrayMemoryWidget::getCompressedArrayPaths() const
+{
+  return m_CompressedArrayPaths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ArrayMemoryWidget::on_arrayTree_customContextMenuRequested(const QPoint& pos)
+{
+  QTreeWidgetItem* item = arrayTree->itemAt(pos);
+  if(item == nullptr)
+  {
+    return;
+  }
+
+  DataArrayPath path = DataArrayPath::Deserialize(item->data(0, k_PathRole).toString(), "/");
+
+  QMenu menu(this);
+  QAction* keepAction = menu.addAction(tr("Keep After Last Use"));
+  keepAction->setCheckable(true);
+  keepAction->setChecked(m_KeptArrayPaths.contains(path));
+  QAction* compressAction = menu.addAction(tr("Compress When Not In Use"));
+  compressAction->setCheckable(true);
+  compressAction->setChecked(m_CompressedArrayPaths.contains(path));
+
+  QAction* publishAction = nullptr;
+  QAction* unpublishAllAction = nullptr;
+  QAction* exportAction = nullptr;
+  if(item->data(0, k_ResultRole).toBool())
+  {
+    menu.addSeparator();
+    publishAction = menu.addAction(tr("Publish To Shared Memory"));
+    publishAction->setCheckable(true);
+    publishAction->setChecked(item->data(0, k_PublishedRole).toBool());
+    unpublishAllAction = menu.addAction(tr("Unpublish All Shared Arrays"));
+    menu.addSeparator();
+    exportAction = menu.addAction(tr("Export Attribute Matrix As Columns..."));
+  }
+  QAction* chosen = menu.exec(arrayTree->viewport()->mapToGlobal(pos));
+  if(chosen != nullptr && chosen == publishAction)
+  {
+    emit publishArrayRequested(path, publishAction->isChecked());
+    return;
+  }
+  if(chosen != nullptr && chosen == unpublishAllAction)
+  {
+    emit unpublishAllRequested();
+    return;
+  }
+  if(chosen != nullptr && chosen == exportAction)
+  {
+    emit exportAttributeMatrixRequested(DataArrayPath(path.getDataContainerName(), path.getAttributeMatrixName(), ""));
+    return;
+  }
+  if(chosen == compressAction)
+  {
+    if(compressAction->isChecked())
+    {
+      m_CompressedArrayPaths.push_back(path);
+    }
+    else
+    {
+      m_CompressedArrayPaths.removeAll(path);
+    }
+    emit compressedArrayPathsChanged(m_CompressedArrayPaths);
+    return;
+  }
+  if(chosen != keepAction)
+  {
+    return;
+  }
+
+  if(keepAction->isChecked())
+  {
+    m_KeptArrayPaths.push_back(path);
+  }
+  else
+  {
+    m_KeptArrayPaths.removeAll(path);
+  }
+  emit keptArrayPathsChanged(m_KeptArrayPaths);
+}
@@ -0,0 +1,145 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QVector>
+#include <QtWidgets/QWidget>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+
+//-- UIC generated Header
+#include "ui_ArrayMemoryWidget.h"
+
+/**
+ * @brief The ArrayMemoryWidget class sits below the Data Structure browser and lists what happened to
+ * the memory of individual arrays during the last pipeline execution, e.g. which arrays were released
+ * after their last use or held compressed while idle, together with a summary line of the savings.
+ *
+ * It also lists the arrays the last execution produced, which can be published to shared memory for
+ * other processes from their context menu.
+ */
+class ArrayMemoryWidget : public QWidget, private Ui::ArrayMemoryWidget
+{
+  Q_OBJECT
+
+public:
+  ArrayMemoryWidget(QWidget* parent = nullptr);
+  ~ArrayMemoryWidget() override;
+
+  /**
+   * @brief FormatBytes Returns a human readable string for a number of bytes
+   * @param bytes
+   * @return
+   */
+  static QString FormatBytes(size_t bytes);
+
+  /**
+   * @brief clearArrays Removes every array from the list and resets the summary
+   */
+  void clearArrays();
+
+  /**
+   * @brief addArray Adds a row for the array at 'path'
+   * @param path
+   * @param status
+   * @param bytes
+   * @param detail
+   */
+  void addArray(const DataArrayPath& path, const QString& status, size_t bytes, const QString& detail);
+
+  /**
+   * @brief clearResultArrays Removes the rows added by addResultArray()
+   */
+  void clearResultArrays();
+
+  /**
+   * @brief addResultArray Adds a row for the array at 'path' the last execution produced
+   * @param path
+   * @param bytes
+   * @param segment The shared memory segment the array is published in, empty if it is not published
+   */
+  void addResultArray(const DataArrayPath& path, size_t bytes, const QString& segment);
+
+  /**
+   * @brief setSummary Sets the text shown above the list
+   * @param summary
+   */
+  void setSummary(const QString& summary);
+
+  /**
+   * @brief setKeptArrayPaths Sets the paths the user asked to keep until the end of a run
+   * @param paths
+   */
+  void setKeptArrayPaths(const QVector<DataArrayPath>& paths);
+  QVector<DataArrayPath> getKeptArrayPaths() const;
+
+  /**
+   * @brief setCompressedArrayPaths Sets the paths the user asked to hold compressed whenever no filter uses them
+   * @param paths
+   */
+  void setCompressedArrayPaths(const QVector<DataArrayPath>& paths);
+  QVector<DataArrayPath> getCompressedArrayPaths() const;
+
+signals:
+  void keptArrayPathsChanged(const QVector<DataArrayPath>& paths);
+  void compressedArrayPathsChanged(const QVector<DataArrayPath>& paths);
+
+  /**
+   * @brief publishArrayRequested Emitted when the user asks to publish the array at 'path' to shared memory,
+   * or to remove it from there if 'publish' is false
+   * @param path
+   * @param publish
+   */
+  void publishArrayRequested(const DataArrayPath& path, bool publish);
+  void unpublishAllRequested();
+
+  /**
+   * @brief exportAttributeMatrixRequested Emitted when the user asks to export the attribute matrix at
+   * 'amPath' to a columnar file
+   * @param amPath
+   */
+  void exportAttributeMatrixRequested(const DataArrayPath& amPath);
+
+protected slots:
+  void on_arrayTree_customContextMenuRequested(const QPoint& pos);
+
+private:
+  QVector<DataArrayPath> m_KeptArrayPaths;
+  QVector<DataArrayPath> m_CompressedArrayPaths;
+
+  ArrayMemoryWidget(const ArrayMemoryWidget&) = delete; // Copy Constructor Not Implemented
+  void operator=(const ArrayMemoryWidget&) = delete;    // Move assignment Not Implemented
+};
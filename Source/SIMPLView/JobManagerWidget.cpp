@@ -0,0 +1,496 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "JobManagerWidget.h"
+
+#include <QtCore/QFileInfo>
+#include <QtWidgets/QAction>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QInputDialog>
+#include <QtWidgets/QMenu>
+
+#include "SVWidgetsLib/Widgets/BookmarksItem.h"
+#include "SVWidgetsLib/Widgets/BookmarksModel.h"
+
+#include "Common/NumaTopology.h"
+#include "Common/PipelineJobQueue.h"
+
+#include "SIMPLView/ArrayMemoryWidget.h"
+
+namespace
+{
+const int k_JobIdRole = Qt::UserRole + 1;
+
+enum Column
+{
+  Name = 0,
+  Priority,
+  Status,
+  Progress,
+  Elapsed,
+  Memory
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString FormatElapsed(qint64 msecs)
+{
+  qint64 secs = msecs / 1000;
+  return QString("%1:%2:%3").arg(secs / 3600, 2, 10, QChar('0')).arg((secs / 60) % 60, 2, 10, QChar('0')).arg(secs % 60, 2, 10, QChar('0'));
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+JobManagerWidget::JobManagerWidget(QWidget* parent)
+: QWidget(parent)
+{
+  setupUi(this);
+
+  m_BookmarksMenu = new QMenu(this);
+  addBookmarkBtn->setMenu(m_BookmarksMenu);
+  connect(m_BookmarksMenu, &QMenu::aboutToShow, this, &JobManagerWidget::updateBookmarksMenu);
+
+  // Placing jobs only matters on machines with several NUMA nodes
+  if(NumaTopology::Instance()->getNodeCount() > 1)
+  {
+    jobTree->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(jobTree, &QTreeWidget::customContextMenuRequested, this, &JobManagerWidget::showJobContextMenu);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+JobManagerWidget::~JobManagerWidget() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::setJobQueue(PipelineJobQueue* queue)
+{
+  if(m_JobQueue != nullptr)
+  {
+    disconnect(m_JobQueue, nullptr, this, nullptr);
+  }
+  jobTree->clear();
+  m_Items.clear();
+
+  m_JobQueue = queue;
+  if(m_JobQueue == nullptr)
+  {
+    return;
+  }
+
+  concurrencySpinBox->blockSignals(true);
+  concurrencySpinBox->setValue(m_JobQueue->getMaxConcurrentJobs());
+  concurrencySpinBox->blockSignals(false);
+  priorityClassComboBox->blockSignals(true);
+  priorityClassComboBox->setCurrentIndex(static_cast<int>(m_JobQueue->getDefaultPriorityClass()));
+  priorityClassComboBox->blockSignals(false);
+
+  connect(m_JobQueue, &PipelineJobQueue::jobAdded, this, &JobManagerWidget::jobAdded);
+  connect(m_JobQueue, &PipelineJobQueue::jobChanged, this, &JobManagerWidget::jobChanged);
+  connect(m_JobQueue, &PipelineJobQueue::jobRemoved, this, &JobManagerWidget::jobRemoved);
+  connect(m_JobQueue, &PipelineJobQueue::maxConcurrentJobsChanged, this, [=](int count) {
+    concurrencySpinBox->blockSignals(true);
+    concurrencySpinBox->setValue(count);
+    concurrencySpinBox->blockSignals(false);
+  });
+  connect(m_JobQueue, &PipelineJobQueue::defaultPriorityClassChanged, this, [=](ThreadBudget::PriorityClass priority) {
+    priorityClassComboBox->blockSignals(true);
+    priorityClassComboBox->setCurrentIndex(static_cast<int>(priority));
+    priorityClassComboBox->blockSignals(false);
+  });
+
+  QList<int> ids = m_JobQueue->jobIds();
+  for(int id : ids)
+  {
+    jobAdded(id);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineJobQueue* JobManagerWidget::getJobQueue() const
+{
+  return m_JobQueue;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::enqueuePipeline(const FilterPipeline::Pointer& pipeline)
+{
+  if(m_JobQueue != nullptr)
+  {
+    m_JobQueue->enqueue(pipeline);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::on_addPipelineBtn_clicked()
+{
+  if(m_JobQueue == nullptr)
+  {
+    return;
+  }
+
+  QStringList filePaths = QFileDialog::getOpenFileNames(this, tr("Queue Pipelines"), QString(), tr("Pipeline Files (*.json *.dream3d);;All Files (*.*)"));
+  for(const QString& filePath : filePaths)
+  {
+    m_JobQueue->enqueue(filePath);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::on_addSeriesBtn_clicked()
+{
+  if(m_JobQueue == nullptr)
+  {
+    return;
+  }
+
+  QString pipelinePath = QFileDialog::getOpenFileName(this, tr("Select the Pipeline of the Series"), QString(), tr("Pipeline Files (*.json *.dream3d);;All Files (*.*)"));
+  if(pipelinePath.isEmpty())
+  {
+    return;
+  }
+  QStringList inputFiles = QFileDialog::getOpenFileNames(this, tr("Select the Datasets of the Series"), QFileInfo(pipelinePath).absolutePath(), tr("DREAM3D Files (*.dream3d);;All Files (*.*)"));
+  if(inputFiles.isEmpty())
+  {
+    return;
+  }
+  QString outputDir = QFileDialog::getExistingDirectory(this, tr("Select the Output Folder of the Series"), QFileInfo(inputFiles.front()).absolutePath());
+  if(outputDir.isEmpty())
+  {
+    return;
+  }
+
+  bool ok = false;
+  int windowMB = QInputDialog::getInt(this, tr("Series Memory Window"), tr("Memory the datasets in flight may use in MB (0 for no limit):"), 0, 0, 1 << 30, 256, &ok);
+  if(!ok)
+  {
+    return;
+  }
+
+  m_JobQueue->enqueueSeries(pipelinePath, SeriesExecution::DatasetsFor(inputFiles, outputDir), static_cast<size_t>(windowMB) * 1024 * 1024);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::updateBookmarksMenu()
+{
+  m_BookmarksMenu->clear();
+  addBookmarkItems(m_BookmarksMenu, QModelIndex());
+  if(m_BookmarksMenu->isEmpty())
+  {
+    m_BookmarksMenu->addAction(tr("No Bookmarks"))->setEnabled(false);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::addBookmarkItems(QMenu* menu, const QModelIndex& parent)
+{
+  BookmarksModel* model = BookmarksModel::Instance();
+  for(int row = 0; row < model->rowCount(parent); row++)
+  {
+    QModelIndex nameIndex = model->index(row, BookmarksItem::Contents::Name, parent);
+    QString name = model->data(nameIndex, Qt::DisplayRole).toString();
+    QString path = model->data(model->index(row, BookmarksItem::Contents::Path, parent), Qt::DisplayRole).toString();
+
+    if(path.isEmpty())
+    {
+      // A folder
+      QMenu* folderMenu = menu->addMenu(name);
+      QAction* queueAll = folderMenu->addAction(tr("Queue Every Bookmark in '%1'").arg(name));
+      connect(queueAll, &QAction::triggered, this, [=] {
+        QStringList paths = bookmarkPaths(nameIndex);
+        for(const QString& filePath : paths)
+        {
+          m_JobQueue->enqueue(filePath);
+        }
+      });
+      folderMenu->addSeparator();
+      addBookmarkItems(folderMenu, nameIndex);
+    }
+    else
+    {
+      QAction* queueOne = menu->addAction(name);
+      queueOne->setEnabled(QFileInfo::exists(path));
+      connect(queueOne, &QAction::triggered, this, [=] { m_JobQueue->enqueue(path); });
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList JobManagerWidget::bookmarkPaths(const QModelIndex& parent) const
+{
+  QStringList paths;
+  BookmarksModel* model = BookmarksModel::Instance();
+  for(int row = 0; row < model->rowCount(parent); row++)
+  {
+    QString path = model->data(model->index(row, BookmarksItem::Contents::Path, parent), Qt::DisplayRole).toString();
+    if(path.isEmpty())
+    {
+      paths << bookmarkPaths(model->index(row, BookmarksItem::Contents::Name, parent));
+    }
+    else if(QFileInfo::exists(path))
+    {
+      paths << path;
+    }
+  }
+  return paths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QList<int> JobManagerWidget::selectedJobIds() const
+{
+  QList<int> ids;
+  QList<QTreeWidgetItem*> items = jobTree->selectedItems();
+  for(QTreeWidgetItem* item : items)
+  {
+    ids.push_back(item->data(Column::Name, k_JobIdRole).toInt());
+  }
+  return ids;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::changeSelectedPriority(int delta)
+{
+  if(m_JobQueue == nullptr)
+  {
+    return;
+  }
+
+  QList<int> ids = selectedJobIds();
+  for(int id : ids)
+  {
+    m_JobQueue->setPriority(id, m_JobQueue->job(id).priority + delta);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::showJobContextMenu(const QPoint& pos)
+{
+  QList<int> ids = selectedJobIds();
+  if(m_JobQueue == nullptr || ids.isEmpty())
+  {
+    return;
+  }
+
+  QMenu menu(this);
+  QMenu* nodeMenu = menu.addMenu(tr("Run On NUMA Node"));
+  QList<QPair<QString, int>> choices;
+  choices.push_back(qMakePair(tr("Any Node"), -1));
+  NumaTopology* topology = NumaTopology::Instance();
+  for(int i = 0; i < topology->getNodeCount(); i++)
+  {
+    int node = topology->getNodeId(i);
+    choices.push_back(qMakePair(tr("Node %1 (%2 CPUs)").arg(node).arg(topology->getCpuCount(node)), node));
+  }
+
+  // Only queued jobs can still be placed
+  bool queued = false;
+  for(int id : ids)
+  {
+    queued = queued || m_JobQueue->job(id).state == PipelineJob::State::Queued;
+  }
+  int current = (ids.size() == 1) ? m_JobQueue->job(ids.front()).numaNode : -2;
+  for(const QPair<QString, int>& choice : choices)
+  {
+    QAction* action = nodeMenu->addAction(choice.first);
+    action->setCheckable(true);
+    action->setChecked(choice.second == current);
+    int node = choice.second;
+    connect(action, &QAction::triggered, this, [=] {
+      for(int id : ids)
+      {
+        m_JobQueue->setNumaNode(id, node);
+      }
+    });
+  }
+  nodeMenu->setEnabled(queued);
+
+  menu.exec(jobTree->viewport()->mapToGlobal(pos));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::on_raisePriorityBtn_clicked()
+{
+  changeSelectedPriority(1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::on_lowerPriorityBtn_clicked()
+{
+  changeSelectedPriority(-1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::on_cancelJobBtn_clicked()
+{
+  if(m_JobQueue == nullptr)
+  {
+    return;
+  }
+
+  QList<int> ids = selectedJobIds();
+  for(int id : ids)
+  {
+    m_JobQueue->cancel(id);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::on_clearFinishedBtn_clicked()
+{
+  if(m_JobQueue != nullptr)
+  {
+    m_JobQueue->removeFinishedJobs();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::on_concurrencySpinBox_valueChanged(int value)
+{
+  if(m_JobQueue != nullptr)
+  {
+    m_JobQueue->setMaxConcurrentJobs(value);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::on_priorityClassComboBox_currentIndexChanged(int index)
+{
+  if(m_JobQueue != nullptr)
+  {
+    m_JobQueue->setDefaultPriorityClass(static_cast<ThreadBudget::PriorityClass>(index));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::jobAdded(int id)
+{
+  QTreeWidgetItem* item = new QTreeWidgetItem(jobTree);
+  item->setData(Column::Name, k_JobIdRole, id);
+  m_Items.insert(id, item);
+  jobChanged(id);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::jobChanged(int id)
+{
+  QTreeWidgetItem* item = m_Items.value(id, nullptr);
+  if(item == nullptr)
+  {
+    return;
+  }
+
+  PipelineJob job = m_JobQueue->job(id);
+  item->setText(Column::Name, job.name);
+  item->setToolTip(Column::Name, job.filePath);
+  item->setText(Column::Priority, QString::number(job.priority));
+  if(job.state != PipelineJob::State::Queued)
+  {
+    item->setText(Column::Priority, QString("%1, %2").arg(job.priority).arg(ThreadBudget::PriorityClassName(job.priorityClass)));
+  }
+  if(job.numaNode >= 0)
+  {
+    item->setText(Column::Priority, tr("%1, node %2").arg(item->text(Column::Priority)).arg(job.numaNode));
+  }
+
+  QString status = PipelineJobQueue::StateName(job.state);
+  if(job.state == PipelineJob::State::Failed && job.errorCondition < 0)
+  {
+    status = tr("Failed (%1)").arg(job.errorCondition);
+  }
+  item->setText(Column::Status, status);
+  item->setToolTip(Column::Status, job.lastStatus);
+
+  item->setText(Column::Progress, QString("%1%").arg(job.progress));
+  item->setText(Column::Elapsed, job.state == PipelineJob::State::Queued ? QString() : FormatElapsed(job.elapsedMsecs));
+
+  if(job.state == PipelineJob::State::Running)
+  {
+    item->setText(Column::Memory, ArrayMemoryWidget::FormatBytes(job.memoryBytes));
+  }
+  else if(job.peakMemoryBytes > 0)
+  {
+    item->setText(Column::Memory, tr("%1 peak").arg(ArrayMemoryWidget::FormatBytes(job.peakMemoryBytes)));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void JobManagerWidget::jobRemoved(int id)
+{
+  delete m_Items.take(id);
+}
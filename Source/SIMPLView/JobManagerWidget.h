@@ -0,0 +1,136 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QMap>
+#include <QtWidgets/QWidget>
+
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+//-- UIC generated Header
+#include "ui_JobManagerWidget.h"
+
+class PipelineJobQueue;
+class QMenu;
+class QModelIndex;
+
+/**
+ * @brief The JobManagerWidget class shows the jobs of a PipelineJobQueue with their live progress,
+ * elapsed time and memory. Pipeline files, bookmarks, whole bookmark folders and a pipeline over a series
+ * of datasets can be queued from it, and queued or running jobs can be canceled or moved up and down the queue.
+ */
+class JobManagerWidget : public QWidget, private Ui::JobManagerWidget
+{
+  Q_OBJECT
+
+public:
+  JobManagerWidget(QWidget* parent = nullptr);
+  ~JobManagerWidget() override;
+
+  /**
+   * @brief setJobQueue Shows the jobs of 'queue'. The queue is not owned by the widget.
+   * @param queue
+   */
+  void setJobQueue(PipelineJobQueue* queue);
+  PipelineJobQueue* getJobQueue() const;
+
+  /**
+   * @brief enqueuePipeline Queues a copy of 'pipeline' as a background job
+   * @param pipeline
+   */
+  void enqueuePipeline(const FilterPipeline::Pointer& pipeline);
+
+protected slots:
+  void on_addPipelineBtn_clicked();
+  void on_addSeriesBtn_clicked();
+  void on_raisePriorityBtn_clicked();
+  void on_lowerPriorityBtn_clicked();
+  void on_cancelJobBtn_clicked();
+  void on_clearFinishedBtn_clicked();
+  void on_concurrencySpinBox_valueChanged(int value);
+  void on_priorityClassComboBox_currentIndexChanged(int index);
+
+  /**
+   * @brief showJobContextMenu Shows the menu that places the selected jobs on a NUMA node
+   * @param pos
+   */
+  void showJobContextMenu(const QPoint& pos);
+
+  /**
+   * @brief updateBookmarksMenu Rebuilds the bookmark menu from the BookmarksModel right before it is shown
+   */
+  void updateBookmarksMenu();
+
+  void jobAdded(int id);
+  void jobChanged(int id);
+  void jobRemoved(int id);
+
+protected:
+  /**
+   * @brief addBookmarkItems Adds an action for every bookmark below 'parent' to 'menu' and a sub menu for
+   * every folder, which starts with an action that queues every bookmark inside the folder
+   * @param menu
+   * @param parent
+   */
+  void addBookmarkItems(QMenu* menu, const QModelIndex& parent);
+
+  /**
+   * @brief bookmarkPaths Returns the file paths of every bookmark below 'parent', recursively
+   * @param parent
+   * @return
+   */
+  QStringList bookmarkPaths(const QModelIndex& parent) const;
+
+  /**
+   * @brief changeSelectedPriority Adds 'delta' to the priority of the selected jobs
+   * @param delta
+   */
+  void changeSelectedPriority(int delta);
+
+  /**
+   * @brief selectedJobIds Returns the ids of the selected jobs
+   * @return
+   */
+  QList<int> selectedJobIds() const;
+
+private:
+  PipelineJobQueue* m_JobQueue = nullptr;
+  QMap<int, QTreeWidgetItem*> m_Items;
+  QMenu* m_BookmarksMenu = nullptr;
+
+  JobManagerWidget(const JobManagerWidget&) = delete; // Copy Constructor Not Implemented
+  void operator=(const JobManagerWidget&) = delete;   // Move assignment Not Implemented
+};
@@ -40,6 +40,7 @@
 
 #include <ctime>
 #include <iostream>
+#include <limits>
 
 #include <QtCore/QPluginLoader>
 #include <QtCore/QProcess>
@@ -52,6 +53,7 @@
 #include <QtGui/QIcon>
 #include <QtGui/QScreen>
 #include <QtWidgets/QFileDialog>
+#include <QtWidgets/QInputDialog>
 #include <QtWidgets/QSplashScreen>
 
 #include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
@@ -79,6 +81,13 @@
 #include "SVWidgetsLib/Widgets/PipelineModel.h"
 #include "SVWidgetsLib/Widgets/SVStyle.h"
 
+#include "Common/ArrayMemoryPool.h"
+#include "Common/ColumnarFile.h"
+#include "Common/PipelineJobQueue.h"
+#include "Common/SharedArrayPublisher.h"
+#include "Common/ThreadBudget.h"
+#include "Common/ThreadTuner.h"
+
 #include "SIMPLView/AboutSIMPLView.h"
 #include "SIMPLView/SIMPLView_UI.h"
 #include "SIMPLView/SIMPLViewVersion.h"
@@ -125,8 +134,13 @@ SIMPLViewApplication::SIMPLViewApplication(int& argc, char** argv)
   QString defaultLoadedThemePath = BrandedStrings::DefaultStyleDirectory + "/" + BrandedStrings::DefaultLoadedTheme + ".json";
   style->loadStyleSheet(defaultLoadedThemePath);
 
+  m_JobQueue = new PipelineJobQueue(this);
+
   readSettings();
 
+  // Shared memory outlives a crashed process, so remove what earlier sessions could not clean up
+  SharedArrayPublisher::RemoveStaleSegments();
+
   // Create the default menu bar
   createDefaultMenuBar();
 
@@ -148,6 +162,12 @@ SIMPLViewApplication::SIMPLViewApplication(int& argc, char** argv)
 // -----------------------------------------------------------------------------
 SIMPLViewApplication::~SIMPLViewApplication()
 {
+  writeSettings();
+
+  // Stop any background job before the plugins and filters go away
+  delete m_JobQueue;
+  m_JobQueue = nullptr;
+
   delete this->m_SplashScreen;
   this->m_SplashScreen = nullptr;
 
@@ -156,8 +176,6 @@ SIMPLViewApplication::~SIMPLViewApplication()
     delete m_PluginLoaders[i];
   }
 
-  writeSettings();
-
   QtSSettings prefs;
   if(prefs.value("Program Mode", QString("")) == "Clear Cache")
   {
@@ -383,6 +401,7 @@ QVector<ISIMPLibPlugin*> SIMPLViewApplication::loadPlugins()
   // will NOT however get filters from plugins. We are going to have to figure out how to compile filters
   // into their own plugin and load the plugins from a command line.
   filterManager->RegisterKnownFilters(filterManager);
+  ColumnarFile::RegisterFilters(filterManager);
 
   PluginManager* pluginManager = PluginManager::Instance();
   QList<PluginProxy::Pointer> proxies = AboutPlugins::readPluginCache();
@@ -682,6 +701,66 @@ void SIMPLViewApplication::listenShowDataFolderTriggered()
   QtSFileUtils::ShowPathInGui(nullptr, dataDirectory);
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::listenSetArrayPoolRetentionTriggered()
+{
+  ArrayMemoryPool* pool = ArrayMemoryPool::Instance();
+  bool ok = false;
+  int retention = QInputDialog::getInt(nullptr, tr("Array Pool Retention"), tr("Memory of destroyed arrays kept for the next run in MB:"), static_cast<int>(pool->getRetentionCap() / (1024 * 1024)), 0,
+                                       std::numeric_limits<int>::max(), 256, &ok);
+  if(!ok)
+  {
+    return;
+  }
+
+  pool->setRetentionCap(static_cast<size_t>(retention) * 1024 * 1024);
+
+  if(m_ActiveWindow)
+  {
+    m_ActiveWindow->setStatusBarMessage(pool->summary());
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::listenSetThreadBudgetTriggered()
+{
+  bool ok = false;
+  int total = QInputDialog::getInt(nullptr, tr("Thread Budget"), tr("Threads shared by all running pipelines (0 uses every core):"), m_TotalThreads, 0, 4096, 1, &ok);
+  if(!ok)
+  {
+    return;
+  }
+
+  m_TotalThreads = total;
+  ThreadBudget* budget = getThreadBudget();
+  budget->setTotalThreads(m_TotalThreads);
+
+  if(m_ActiveWindow)
+  {
+    m_ActiveWindow->setStatusBarMessage(tr("Pipelines now share %1 threads").arg(budget->getTotalThreads()));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget* SIMPLViewApplication::getThreadBudget() const
+{
+  return ThreadBudget::Instance();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineJobQueue* SIMPLViewApplication::getJobQueue() const
+{
+  return m_JobQueue;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -968,6 +1047,16 @@ void SIMPLViewApplication::writeSettings()
 
   prefs->endGroup();
 
+  prefs->beginGroup(SIMPLView::ExecutionSettings::GroupName);
+  prefs->setValue(SIMPLView::ExecutionSettings::TotalThreads, m_TotalThreads);
+  prefs->setValue(SIMPLView::ExecutionSettings::MaxConcurrentJobs, m_JobQueue->getMaxConcurrentJobs());
+  prefs->setValue(SIMPLView::ExecutionSettings::AutoTuneThreads, ThreadTuner::Instance()->isEnabled());
+  prefs->setValue(SIMPLView::ExecutionSettings::JobPriorityClass, ThreadBudget::PriorityClassName(m_JobQueue->getDefaultPriorityClass()));
+  prefs->setValue(SIMPLView::ExecutionSettings::ArrayPoolRetention, static_cast<qulonglong>(ArrayMemoryPool::Instance()->getRetentionCap() / (1024 * 1024)));
+  prefs->setValue(SIMPLView::ExecutionSettings::ArrayPoolHugePages, ArrayMemoryPool::Instance()->getHugePages());
+  prefs->setValue(SIMPLView::ExecutionSettings::PinThreadsToNumaNodes, getThreadBudget()->getPinThreadsToNodes());
+  prefs->endGroup();
+
   BookmarksModel* model = BookmarksModel::Instance();
   model->writeBookmarksToPrefsFile();
 
@@ -1010,6 +1099,19 @@ void SIMPLViewApplication::readSettings()
   #endif
 
   prefs->endGroup();
+
+  prefs->beginGroup(SIMPLView::ExecutionSettings::GroupName);
+  m_TotalThreads = prefs->value(SIMPLView::ExecutionSettings::TotalThreads, QVariant(0)).toInt();
+  m_JobQueue->setMaxConcurrentJobs(prefs->value(SIMPLView::ExecutionSettings::MaxConcurrentJobs, QVariant(1)).toInt());
+  ThreadTuner::Instance()->setEnabled(prefs->value(SIMPLView::ExecutionSettings::AutoTuneThreads, QVariant(false)).toBool());
+  QString jobPriorityClass = prefs->value(SIMPLView::ExecutionSettings::JobPriorityClass, ThreadBudget::PriorityClassName(ThreadBudget::PriorityClass::Background)).toString();
+  m_JobQueue->setDefaultPriorityClass(ThreadBudget::PriorityClassFromName(jobPriorityClass));
+  qulonglong poolRetention = prefs->value(SIMPLView::ExecutionSettings::ArrayPoolRetention, static_cast<qulonglong>(ArrayMemoryPool::DefaultRetentionCap / (1024 * 1024))).toULongLong();
+  ArrayMemoryPool::Instance()->setRetentionCap(static_cast<size_t>(poolRetention) * 1024 * 1024);
+  ArrayMemoryPool::Instance()->setHugePages(prefs->value(SIMPLView::ExecutionSettings::ArrayPoolHugePages, QVariant(true)).toBool());
+  getThreadBudget()->setPinThreadsToNodes(prefs->value(SIMPLView::ExecutionSettings::PinThreadsToNumaNodes, QVariant(false)).toBool());
+  prefs->endGroup();
+  getThreadBudget()->setTotalThreads(m_TotalThreads);
 }
 
 // -----------------------------------------------------------------------------
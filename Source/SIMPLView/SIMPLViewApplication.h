@@ -51,6 +51,8 @@ class SIMPLView_UI;
 class QPluginLoader;
 class ISIMPLibPlugin;
 class SIMPLViewToolbox;
+class ThreadBudget;
+class PipelineJobQueue;
 class SVPipelineFilterWidget;
 class SVPipelineViewWidget;
 
@@ -121,6 +123,18 @@ public:
    */
   QMenu* getRecentFilesMenu();
 
+  /**
+   * @brief getThreadBudget Returns the budget shared by every pipeline that runs in the application
+   * @return
+   */
+  ThreadBudget* getThreadBudget() const;
+
+  /**
+   * @brief getJobQueue Returns the queue of background jobs shared by every window
+   * @return
+   */
+  PipelineJobQueue* getJobQueue() const;
+
 public slots:
   void listenNewInstanceTriggered();
   void listenOpenPipelineTriggered();
@@ -133,6 +147,8 @@ public slots:
   void listenExitApplicationTriggered();
   void listenSetDataFolderTriggered();
   void listenShowDataFolderTriggered();
+  void listenSetThreadBudgetTriggered();
+  void listenSetArrayPoolRetentionTriggered();
 
   SIMPLView_UI* getNewSIMPLViewInstance();
 
@@ -239,6 +255,11 @@ private:
 
   int m_minSplashTime;
 
+  // The thread budget preference, 0 uses every core
+  int m_TotalThreads = 0;
+
+  PipelineJobQueue* m_JobQueue = nullptr;
+
   SIMPLViewApplication(const SIMPLViewApplication&) = delete; // Copy Constructor Not Implemented
   void operator=(const SIMPLViewApplication&);                // Move assignment Not Implemented
 };
@@ -49,5 +49,39 @@ namespace SIMPLView
     static const QString WhenToCheck("WhenToCheck");
     static const QString UpdateWebSite("http://dream3d.bluequartz.net/dream3d_version.json");
   }
+
+  namespace ExecutionSettings
+  {
+    static const QString GroupName("PipelineExecution");
+    static const QString ReleaseDeadArrays("ReleaseDeadArrays");
+    static const QString OptimizePipeline("OptimizePipeline");
+    static const QString FuseElementwiseFilters("FuseElementwiseFilters");
+    static const QString TiledExecution("TiledExecution");
+    static const QString TiledSlabThickness("TiledSlabThickness");
+    static const QString TotalThreads("TotalThreads");
+    static const QString MaxConcurrentJobs("MaxConcurrentJobs");
+    static const QString AutoTuneThreads("AutoTuneThreads");
+    static const QString JobPriorityClass("JobPriorityClass");
+    static const QString PreviewReduction("PreviewReduction");
+    static const QString MemoryCheck("MemoryCheck");
+    static const QString MemoryBudget("MemoryBudget");
+    static const QString KeepSnapshots("KeepSnapshots");
+    static const QString SpillToDisk("SpillToDisk");
+    static const QString CompressIdleArrays("CompressIdleArrays");
+    static const QString ArrayMapping("ArrayMapping");
+    static const QString ParallelChunkedReads("ParallelChunkedReads");
+    static const QString AsyncWrites("AsyncWrites");
+    static const QString PrefetchDepth("PrefetchDepth");
+    static const QString WriteProfile("WriteProfile");
+    static const QString IncrementalWrites("IncrementalWrites");
+    static const QString ArrayPoolRetention("ArrayPoolRetention");
+    static const QString ArrayPoolHugePages("ArrayPoolHugePages");
+    static const QString PinThreadsToNumaNodes("PinThreadsToNumaNodes");
+  }
+
+  namespace DockWidgetSettings
+  {
+    static const QString JobManagerGroupName("Job Manager Dock Widget");
+  }
 }
 
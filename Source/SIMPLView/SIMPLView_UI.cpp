@@ -35,6 +35,9 @@
 
 #include "SIMPLView_UI.h"
 
+#include <algorithm>
+#include <limits>
+
 //-- Qt Includes
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
@@ -46,12 +49,16 @@
 #include <QtCore/QProcess>
 #include <QtCore/QString>
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
 #include <QtCore/QUrl>
 #include <QtGui/QClipboard>
 #include <QtGui/QCloseEvent>
 #include <QtGui/QDesktopServices>
+#include <QtWidgets/QApplication>
 #include <QtWidgets/QCheckBox>
 #include <QtWidgets/QFileDialog>
+#include <QtWidgets/QInputDialog>
+#include <QtWidgets/QLabel>
 #include <QtWidgets/QListWidget>
 #include <QtWidgets/QScrollBar>
 #include <QtWidgets/QShortcut>
@@ -60,6 +67,8 @@
 //-- SIMPLView Includes
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/Common/DocRequestManager.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
 #include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
 #include "SIMPLib/Filtering/FilterManager.h"
 #include "SIMPLib/Plugin/PluginManager.h"
@@ -99,11 +108,30 @@
 #include "SVWidgetsLib/QtSupport/QtSHelpUrlGenerator.h"
 #endif
 
+#include "Common/ArrayLivenessAnalysis.h"
+#include "Common/ArrayMemoryPool.h"
+#include "Common/ColumnarFile.h"
+#include "Common/MemoryEstimator.h"
+#include "Common/NumaTopology.h"
+#include "Common/PipelineDataFlowGraph.h"
+#include "Common/PipelineExecutor.h"
+#include "Common/PipelineFileSettings.h"
+#include "Common/PipelineJobQueue.h"
+#include "Common/PipelineOptimizer.h"
+#include "Common/PreviewReduction.h"
+#include "Common/ThreadBudget.h"
+#include "Common/ThreadTuner.h"
+#include "Common/TiledExecution.h"
+#include "Common/WriteProfile.h"
+
 #include "SIMPLView/AboutSIMPLView.h"
+#include "SIMPLView/ArrayMemoryWidget.h"
+#include "SIMPLView/JobManagerWidget.h"
 #include "SIMPLView/SIMPLView.h"
 #include "SIMPLView/SIMPLViewApplication.h"
 #include "SIMPLView/SIMPLViewConstants.h"
 #include "SIMPLView/SIMPLViewVersion.h"
+#include "SIMPLView/ThreadProfilesDialog.h"
 
 #include "BrandedStrings.h"
 
@@ -210,7 +238,10 @@ bool SIMPLView_UI::savePipeline()
 
   // Write the pipeline
   SVPipelineView* viewWidget = m_Ui->pipelineListWidget->getPipelineView();
-  viewWidget->writePipeline(filePath);
+  if(viewWidget->writePipeline(filePath) >= 0)
+  {
+    PipelineFileSettings::WriteFile(filePath, getEditedPipeline());
+  }
 
   // Set window title and save flag
   QFileInfo prefFileInfo = QFileInfo(filePath);
@@ -260,6 +291,8 @@ bool SIMPLView_UI::savePipelineAs()
 
   if(err >= 0)
   {
+    PipelineFileSettings::WriteFile(filePath, getEditedPipeline());
+
     // Set window title and save flag
     setWindowTitle("[*]" + fi.baseName() + " - " + BrandedStrings::ApplicationName);
     setWindowModified(false);
@@ -326,7 +359,7 @@ void SIMPLView_UI::activateBookmark(const QString& filePath, bool execute)
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::closeEvent(QCloseEvent* event)
 {
-  if(m_Ui->pipelineListWidget->getPipelineView()->isPipelineCurrentlyRunning() == true)
+  if(m_Ui->pipelineListWidget->getPipelineView()->isPipelineCurrentlyRunning() == true || m_PipelineExecutor != nullptr)
   {
     QMessageBox runningPipelineBox;
     runningPipelineBox.setWindowTitle("Pipeline is Running");
@@ -373,6 +406,42 @@ void SIMPLView_UI::readSettings()
   readDockWidgetSettings(prefs.data(), m_Ui->stdOutDockWidget);
   prefs->endGroup();
 
+  prefs->beginGroup(SIMPLView::DockWidgetSettings::JobManagerGroupName);
+  readDockWidgetSettings(prefs.data(), m_Ui->jobManagerDockWidget);
+  prefs->endGroup();
+
+  prefs->endGroup();
+
+  prefs->beginGroup(SIMPLView::ExecutionSettings::GroupName);
+  m_ActionReleaseDeadArrays->setChecked(prefs->value(SIMPLView::ExecutionSettings::ReleaseDeadArrays, QVariant(false)).toBool());
+  m_ActionOptimizePipeline->setChecked(prefs->value(SIMPLView::ExecutionSettings::OptimizePipeline, QVariant(false)).toBool());
+  m_ActionFuseElementwiseFilters->setChecked(prefs->value(SIMPLView::ExecutionSettings::FuseElementwiseFilters, QVariant(false)).toBool());
+  m_ActionTiledExecution->setChecked(prefs->value(SIMPLView::ExecutionSettings::TiledExecution, QVariant(false)).toBool());
+  m_TiledSlabThickness = prefs->value(SIMPLView::ExecutionSettings::TiledSlabThickness, QVariant(32)).toInt();
+  m_PreviewReduction = PreviewReduction::FromString(prefs->value(SIMPLView::ExecutionSettings::PreviewReduction, QString("downsample 4")).toString());
+  m_MemoryPolicy = MemoryEstimator::PolicyFromName(prefs->value(SIMPLView::ExecutionSettings::MemoryCheck, MemoryEstimator::PolicyName(MemoryEstimator::Policy::Warn)).toString());
+  m_MemoryBudgetMB = prefs->value(SIMPLView::ExecutionSettings::MemoryBudget, QVariant(0)).toInt();
+  m_ActionSpillToDisk->setChecked(prefs->value(SIMPLView::ExecutionSettings::SpillToDisk, QVariant(false)).toBool());
+  m_CompressIdleFilters = prefs->value(SIMPLView::ExecutionSettings::CompressIdleArrays, QVariant(0)).toInt();
+  m_ArrayMapping = MappedFileReader::ModeFromName(prefs->value(SIMPLView::ExecutionSettings::ArrayMapping, MappedFileReader::ModeName(MappedFileReader::Mode::Off)).toString());
+  m_ActionParallelChunkedReads->setChecked(prefs->value(SIMPLView::ExecutionSettings::ParallelChunkedReads, QVariant(false)).toBool());
+  m_ActionAsyncWrites->setChecked(prefs->value(SIMPLView::ExecutionSettings::AsyncWrites, QVariant(false)).toBool());
+  m_PrefetchDepth = prefs->value(SIMPLView::ExecutionSettings::PrefetchDepth, QVariant(0)).toInt();
+  m_WriteProfile = WriteProfile::PresetFromName(prefs->value(SIMPLView::ExecutionSettings::WriteProfile, WriteProfile::PresetName(WriteProfile::Preset::Default)).toString());
+  m_ActionIncrementalWrites->setChecked(prefs->value(SIMPLView::ExecutionSettings::IncrementalWrites, QVariant(false)).toBool());
+  m_ActionKeepSnapshots->setChecked(prefs->value(SIMPLView::ExecutionSettings::KeepSnapshots, QVariant(false)).toBool());
+  for(QAction* action : m_MemoryCheckGroup->actions())
+  {
+    action->setChecked(action->data().toInt() == static_cast<int>(m_MemoryPolicy));
+  }
+  for(QAction* action : m_ArrayMappingGroup->actions())
+  {
+    action->setChecked(action->data().toInt() == static_cast<int>(m_ArrayMapping));
+  }
+  for(QAction* action : m_WriteProfileGroup->actions())
+  {
+    action->setChecked(action->data().toInt() == static_cast<int>(m_WriteProfile));
+  }
   prefs->endGroup();
 
   prefs->beginGroup("ToolboxSettings");
@@ -463,6 +532,30 @@ void SIMPLView_UI::writeSettings()
   //writeHideDockSettings(prefs.data(), m_HideStdOutput);
   prefs->endGroup();
 
+  prefs->beginGroup(SIMPLView::DockWidgetSettings::JobManagerGroupName);
+  writeDockWidgetSettings(prefs.data(), m_Ui->jobManagerDockWidget);
+  prefs->endGroup();
+
+  prefs->endGroup();
+
+  prefs->beginGroup(SIMPLView::ExecutionSettings::GroupName);
+  prefs->setValue(SIMPLView::ExecutionSettings::ReleaseDeadArrays, m_ActionReleaseDeadArrays->isChecked());
+  prefs->setValue(SIMPLView::ExecutionSettings::OptimizePipeline, m_ActionOptimizePipeline->isChecked());
+  prefs->setValue(SIMPLView::ExecutionSettings::FuseElementwiseFilters, m_ActionFuseElementwiseFilters->isChecked());
+  prefs->setValue(SIMPLView::ExecutionSettings::TiledExecution, m_ActionTiledExecution->isChecked());
+  prefs->setValue(SIMPLView::ExecutionSettings::TiledSlabThickness, m_TiledSlabThickness);
+  prefs->setValue(SIMPLView::ExecutionSettings::PreviewReduction, m_PreviewReduction.toString());
+  prefs->setValue(SIMPLView::ExecutionSettings::MemoryCheck, MemoryEstimator::PolicyName(m_MemoryPolicy));
+  prefs->setValue(SIMPLView::ExecutionSettings::MemoryBudget, m_MemoryBudgetMB);
+  prefs->setValue(SIMPLView::ExecutionSettings::SpillToDisk, m_ActionSpillToDisk->isChecked());
+  prefs->setValue(SIMPLView::ExecutionSettings::CompressIdleArrays, m_CompressIdleFilters);
+  prefs->setValue(SIMPLView::ExecutionSettings::ArrayMapping, MappedFileReader::ModeName(m_ArrayMapping));
+  prefs->setValue(SIMPLView::ExecutionSettings::ParallelChunkedReads, m_ActionParallelChunkedReads->isChecked());
+  prefs->setValue(SIMPLView::ExecutionSettings::AsyncWrites, m_ActionAsyncWrites->isChecked());
+  prefs->setValue(SIMPLView::ExecutionSettings::PrefetchDepth, m_PrefetchDepth);
+  prefs->setValue(SIMPLView::ExecutionSettings::WriteProfile, WriteProfile::PresetName(m_WriteProfile));
+  prefs->setValue(SIMPLView::ExecutionSettings::IncrementalWrites, m_ActionIncrementalWrites->isChecked());
+  prefs->setValue(SIMPLView::ExecutionSettings::KeepSnapshots, m_ActionKeepSnapshots->isChecked());
   prefs->endGroup();
 }
 
@@ -529,6 +622,10 @@ void SIMPLView_UI::setupGui()
 
   tabifyDockWidget(m_Ui->filterListDockWidget, m_Ui->filterLibraryDockWidget);
   tabifyDockWidget(m_Ui->filterLibraryDockWidget, m_Ui->bookmarksDockWidget);
+  tabifyDockWidget(m_Ui->stdOutDockWidget, m_Ui->jobManagerDockWidget);
+
+  // Background jobs belong to the application so they keep running when this window closes
+  m_Ui->jobManagerWidget->setJobQueue(dream3dApp->getJobQueue());
 
   m_Ui->filterListDockWidget->raise();
 
@@ -551,6 +648,9 @@ void SIMPLView_UI::setupGui()
   //  connect(m_Ui->issuesWidget, SIGNAL(tableHasErrors(bool, int, int)), m_StatusBar, SLOT(issuesTableHasErrors(bool, int, int)));
   connect(m_Ui->issuesWidget, SIGNAL(tableHasErrors(bool, int, int)), this, SLOT(issuesTableHasErrors(bool, int, int)));
   connect(m_Ui->issuesWidget, SIGNAL(showTable(bool)), m_Ui->issuesDockWidget, SLOT(setVisible(bool)));
+
+  m_MemoryEstimateLabel = new QLabel(this);
+  statusBar()->addPermanentWidget(m_MemoryEstimateLabel);
 }
 
 // -----------------------------------------------------------------------------
@@ -583,6 +683,108 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   m_ActionCheckForUpdates = new QAction("Check For Updates", this);
   m_ActionPluginInformation = new QAction("Plugin Information", this);
   m_ActionClearCache = new QAction("Clear Cache", this);
+  m_ActionExecutePipeline = new QAction("Execute", this);
+  m_ActionReleaseDeadArrays = new QAction("Release Arrays After Last Use", this);
+  m_ActionReleaseDeadArrays->setCheckable(true);
+  m_ActionOptimizePipeline = new QAction("Optimize Before Execution", this);
+  m_ActionOptimizePipeline->setCheckable(true);
+  m_ActionFuseElementwiseFilters = new QAction("Fuse Element-wise Filters", this);
+  m_ActionFuseElementwiseFilters->setCheckable(true);
+  m_ActionTiledExecution = new QAction("Execute Tiled Along Z", this);
+  m_ActionTiledExecution->setCheckable(true);
+  m_ActionTiledSlabThickness = new QAction("Tiled Slab Thickness...", this);
+  m_ActionThreadBudget = new QAction("Thread Budget...", this);
+  m_ActionAutoTuneThreads = new QAction("Auto-Tune Filter Threads", this);
+  m_ActionAutoTuneThreads->setCheckable(true);
+  m_ActionThreadProfiles = new QAction("Thread Profiles...", this);
+  m_ActionArrayPoolRetention = new QAction("Array Pool Retention...", this);
+  m_ActionArrayPoolHugePages = new QAction("Use Huge Pages For Arrays", this);
+  m_ActionArrayPoolHugePages->setCheckable(true);
+  m_ActionArrayPoolHugePages->setEnabled(ArrayMemoryPool::HugePagesSupported());
+  m_ActionPinThreadsToNumaNodes = new QAction("Pin Threads To NUMA Nodes", this);
+  m_ActionPinThreadsToNumaNodes->setCheckable(true);
+  m_ActionPinThreadsToNumaNodes->setEnabled(NumaTopology::Instance()->getNodeCount() > 1);
+  m_ActionPinThreadsToNumaNodes->setToolTip("Keep every thread on one NUMA node and spread the pages of new arrays over the nodes to match");
+  m_ActionRunAsBackgroundJob = new QAction("Run as Background Job", this);
+  m_MenuMemoryCheck = new QMenu("Memory Check", this);
+  m_MemoryCheckGroup = new QActionGroup(this);
+  for(MemoryEstimator::Policy policy : {MemoryEstimator::Policy::Off, MemoryEstimator::Policy::Warn, MemoryEstimator::Policy::Refuse})
+  {
+    QAction* action = m_MenuMemoryCheck->addAction(MemoryEstimator::PolicyName(policy));
+    action->setCheckable(true);
+    action->setChecked(policy == m_MemoryPolicy);
+    action->setData(static_cast<int>(policy));
+    m_MemoryCheckGroup->addAction(action);
+  }
+  m_ActionMemoryBudget = new QAction("Memory Budget...", this);
+  m_ActionSpillToDisk = new QAction("Spill Arrays To Disk Above Memory Budget", this);
+  m_ActionSpillToDisk->setCheckable(true);
+  m_ActionSpillToDisk->setToolTip("Write the arrays that are not needed soon to a temporary file while the arrays exceed the memory budget");
+  m_ActionCompressIdleArrays = new QAction("Compress Idle Arrays...", this);
+  m_MenuArrayMapping = new QMenu("Map Input Arrays", this);
+  m_MenuArrayMapping->setToolTip("Map the arrays of .dream3d inputs from their files and keep the arrays of other inputs in scratch files");
+  m_ArrayMappingGroup = new QActionGroup(this);
+  for(MappedFileReader::Mode mode : {MappedFileReader::Mode::Off, MappedFileReader::Mode::ReadOnly, MappedFileReader::Mode::CopyOnWrite})
+  {
+    QAction* action = m_MenuArrayMapping->addAction(MappedFileReader::ModeName(mode));
+    action->setCheckable(true);
+    action->setChecked(mode == m_ArrayMapping);
+    action->setData(static_cast<int>(mode));
+    m_ArrayMappingGroup->addAction(action);
+  }
+  m_ActionParallelChunkedReads = new QAction("Decompress Input Chunks In Parallel", this);
+  m_ActionParallelChunkedReads->setCheckable(true);
+  m_ActionParallelChunkedReads->setToolTip("Read the compressed chunked arrays of .dream3d inputs with every thread instead of through HDF5 alone");
+  m_ActionAsyncWrites = new QAction("Write Files In The Background", this);
+  m_ActionAsyncWrites->setCheckable(true);
+  m_ActionAsyncWrites->setToolTip("Let the filters after a writer execute while it writes its file");
+  m_ActionPrefetchInputs = new QAction("Prefetch Input Files...", this);
+  m_ActionPrefetchInputs->setToolTip("Read the input files of the next readers into the cache while the filters before them execute");
+  m_MenuWriteProfile = new QMenu("Write Profile", this);
+  m_MenuWriteProfile->setToolTip("Lay out the datasets of every HDF5 file the writers produce for how it is used next");
+  m_WriteProfileGroup = new QActionGroup(this);
+  m_MenuWriterProfile = new QMenu("Selected Writer's Write Profile", this);
+  m_MenuWriterProfile->setEnabled(false);
+  m_WriterProfileGroup = new QActionGroup(this);
+  QAction* followAction = m_MenuWriterProfile->addAction("Follow The Global Profile");
+  followAction->setCheckable(true);
+  followAction->setData(QString());
+  m_WriterProfileGroup->addAction(followAction);
+  m_MenuWriterProfile->addSeparator();
+  for(WriteProfile::Preset preset : WriteProfile::Presets())
+  {
+    QAction* action = m_MenuWriteProfile->addAction(WriteProfile::PresetName(preset));
+    action->setCheckable(true);
+    action->setChecked(preset == m_WriteProfile);
+    action->setData(static_cast<int>(preset));
+    action->setToolTip(WriteProfile::Description(preset));
+    m_WriteProfileGroup->addAction(action);
+
+    QAction* writerAction = m_MenuWriterProfile->addAction(WriteProfile::PresetName(preset));
+    writerAction->setCheckable(true);
+    writerAction->setData(WriteProfile::PresetName(preset));
+    writerAction->setToolTip(WriteProfile::Description(preset));
+    m_WriterProfileGroup->addAction(writerAction);
+  }
+  m_ActionMeasureWriteProfiles = new QAction("Measure Write Profiles...", this);
+  m_ActionMeasureWriteProfiles->setToolTip("Write the largest array of a .dream3d file with every profile and compare the throughput and size");
+  m_ActionIncrementalWrites = new QAction("Write Only Changed Datasets", this);
+  m_ActionIncrementalWrites->setCheckable(true);
+  m_ActionIncrementalWrites->setToolTip("Update output files that already exist with only the datasets and attributes that changed");
+  m_ActionKeepSnapshots = new QAction("Keep Snapshots After Every Filter", this);
+  m_ActionKeepSnapshots->setCheckable(true);
+  m_ActionKeepSnapshots->setToolTip("Keep the data after every filter of the last run. Unchanged data is shared between snapshots.");
+  m_ActionClearSnapshots = new QAction("Clear Snapshots", this);
+  m_ActionPreviewMode = new QAction("Preview Mode", this);
+  m_ActionPreviewMode->setCheckable(true);
+  m_ActionPreviewMode->setToolTip("Run the pipeline on reduced inputs whenever it changes and show the results in the data browser");
+  m_ActionPreviewReduction = new QAction("Preview Reduction...", this);
+  m_PreviewTimer = new QTimer(this);
+  m_PreviewTimer->setSingleShot(true);
+  m_PreviewTimer->setInterval(500);
+  m_ActionFilterHasSideEffects = new QAction("Filter Has Side Effects (Never Eliminate)", this);
+  m_ActionFilterHasSideEffects->setCheckable(true);
+  m_ActionFilterHasSideEffects->setEnabled(false);
 
   // SIMPLView_UI Actions
   connect(m_ActionNew, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenNewInstanceTriggered);
@@ -596,6 +798,151 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   connect(m_ActionShowSIMPLViewHelp, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenShowSIMPLViewHelpTriggered);
   connect(m_ActionPluginInformation, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenDisplayPluginInfoDialogTriggered);
   connect(m_ActionClearCache, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenClearSIMPLViewCacheTriggered);
+  connect(m_ActionExecutePipeline, &QAction::triggered, this, &SIMPLView_UI::executePipeline);
+  connect(m_ActionTiledExecution, &QAction::triggered, [=] { m_Ui->pipelineListWidget->getPipelineView()->preflightPipeline(); });
+  connect(m_ActionTiledSlabThickness, &QAction::triggered, [=] {
+    bool ok = false;
+    int thickness = QInputDialog::getInt(this, tr("Tiled Slab Thickness"), tr("Z slices per slab:"), m_TiledSlabThickness, 1, 100000, 1, &ok);
+    if(ok)
+    {
+      m_TiledSlabThickness = thickness;
+    }
+  });
+  connect(m_ActionThreadBudget, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenSetThreadBudgetTriggered);
+  connect(m_ActionAutoTuneThreads, &QAction::triggered, [=](bool checked) { ThreadTuner::Instance()->setEnabled(checked); });
+  connect(m_ActionThreadProfiles, &QAction::triggered, [=] {
+    ThreadProfilesDialog dialog(this);
+    dialog.exec();
+  });
+  // Auto-tuning is shared by every window, so pick up changes made in another one
+  connect(m_MenuPipeline, &QMenu::aboutToShow, [=] {
+    m_ActionAutoTuneThreads->setChecked(ThreadTuner::Instance()->isEnabled());
+    m_ActionArrayPoolHugePages->setChecked(ArrayMemoryPool::Instance()->getHugePages());
+    m_ActionPinThreadsToNumaNodes->setChecked(ThreadBudget::Instance()->getPinThreadsToNodes());
+  });
+  connect(m_ActionArrayPoolRetention, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenSetArrayPoolRetentionTriggered);
+  connect(m_ActionArrayPoolHugePages, &QAction::triggered, [=](bool checked) { ArrayMemoryPool::Instance()->setHugePages(checked); });
+  connect(m_ActionPinThreadsToNumaNodes, &QAction::triggered, [=](bool checked) { ThreadBudget::Instance()->setPinThreadsToNodes(checked); });
+  connect(m_ActionRunAsBackgroundJob, &QAction::triggered, [=] {
+    FilterPipeline::Pointer pipeline = getEditedPipeline();
+    if(pipeline->size() == 0)
+    {
+      return;
+    }
+    if(m_LastOpenedFilePath.endsWith(".json") && !isWindowModified())
+    {
+      pipeline->setName(QFileInfo(m_LastOpenedFilePath).completeBaseName());
+    }
+    m_Ui->jobManagerWidget->enqueuePipeline(pipeline);
+    showDockWidget(m_Ui->jobManagerDockWidget);
+  });
+  connect(m_MemoryCheckGroup, &QActionGroup::triggered, [=](QAction* action) {
+    m_MemoryPolicy = static_cast<MemoryEstimator::Policy>(action->data().toInt());
+    m_Ui->pipelineListWidget->getPipelineView()->preflightPipeline();
+  });
+  connect(m_ActionMemoryBudget, &QAction::triggered, [=] {
+    bool ok = false;
+    int budget = QInputDialog::getInt(this, tr("Memory Budget"), tr("Memory a pipeline may use in MB, 0 for the memory available at the time:"), m_MemoryBudgetMB, 0, std::numeric_limits<int>::max(), 1024, &ok);
+    if(ok)
+    {
+      m_MemoryBudgetMB = budget;
+      m_Ui->pipelineListWidget->getPipelineView()->preflightPipeline();
+    }
+  });
+  connect(m_ActionCompressIdleArrays, &QAction::triggered, [=] {
+    bool ok = false;
+    int filters = QInputDialog::getInt(this, tr("Compress Idle Arrays"), tr("Compress arrays no filter has used for this many filters, 0 to only compress the arrays flagged in the array list:"),
+                                       m_CompressIdleFilters, 0, 1000, 1, &ok);
+    if(ok)
+    {
+      m_CompressIdleFilters = filters;
+    }
+  });
+  connect(m_ActionPrefetchInputs, &QAction::triggered, [=] {
+    bool ok = false;
+    int readers = QInputDialog::getInt(this, tr("Prefetch Input Files"), tr("Read the input files of this many readers ahead of the running filters, 0 to never prefetch:"), m_PrefetchDepth, 0,
+                                       100, 1, &ok);
+    if(ok)
+    {
+      m_PrefetchDepth = readers;
+    }
+  });
+  connect(m_ArrayMappingGroup, &QActionGroup::triggered, [=](QAction* action) { m_ArrayMapping = static_cast<MappedFileReader::Mode>(action->data().toInt()); });
+  connect(m_WriteProfileGroup, &QActionGroup::triggered, [=](QAction* action) { m_WriteProfile = static_cast<WriteProfile::Preset>(action->data().toInt()); });
+  connect(m_WriterProfileGroup, &QActionGroup::triggered, [=](QAction* action) {
+    SVPipelineView* pipelineView = m_Ui->pipelineListWidget->getPipelineView();
+    QModelIndexList selectedIndexes = pipelineView->selectionModel()->selectedRows();
+    for(const QModelIndex& index : selectedIndexes)
+    {
+      AbstractFilter::Pointer filter = getPipelineModel()->filter(index);
+      if(ArrayLivenessAnalysis::IsWriterFilter(filter))
+      {
+        WriteProfile::SetWriterPreset(filter, action->data().toString());
+        // The profile is saved with the pipeline
+        setWindowModified(true);
+      }
+    }
+  });
+  connect(m_ActionMeasureWriteProfiles, &QAction::triggered, [=] {
+    QString filePath = QFileDialog::getOpenFileName(this, tr("Measure Write Profiles"), QString(), tr("DREAM3D File (*.dream3d);;HDF5 File (*.h5 *.hdf5);;All Files (*.*)"));
+    if(filePath.isEmpty())
+    {
+      return;
+    }
+    QString errorMessage;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QVector<WriteProfile::Measurement> measurements = WriteProfile::Measure(filePath, QDir::tempPath(), &errorMessage);
+    QApplication::restoreOverrideCursor();
+    if(measurements.isEmpty())
+    {
+      QMessageBox::warning(this, tr("Measure Write Profiles"), errorMessage);
+      return;
+    }
+    QMessageBox::information(this, tr("Measure Write Profiles"), WriteProfile::MeasurementReport(measurements).join("\n"));
+  });
+  connect(m_ActionClearSnapshots, &QAction::triggered, [=] {
+    m_SnapshotStore.reset();
+    statusBar()->showMessage(tr("Snapshots cleared"));
+  });
+  connect(m_PreviewTimer, &QTimer::timeout, this, &SIMPLView_UI::startPreview);
+  connect(m_ActionPreviewMode, &QAction::triggered, [=](bool checked) {
+    if(checked)
+    {
+      startPreview();
+      return;
+    }
+    m_PreviewTimer->stop();
+    m_PreviewRestart = false;
+    if(m_PreviewRunning && m_PipelineExecutor != nullptr)
+    {
+      m_PipelineExecutor->cancelPipeline();
+    }
+  });
+  connect(m_ActionPreviewReduction, &QAction::triggered, [=] {
+    bool ok = false;
+    QString text = QInputDialog::getText(this, tr("Preview Reduction"), tr("Keep every n-th voxel (\"downsample 4\") or a box of voxels (\"crop x0,y0,z0,x1,y1,z1\"):"),
+                                         QLineEdit::Normal, m_PreviewReduction.toString(), &ok);
+    if(!ok)
+    {
+      return;
+    }
+    PreviewReduction reduction = PreviewReduction::FromString(text, &ok);
+    if(!ok || !reduction.isEnabled())
+    {
+      QMessageBox::warning(this, tr("Preview Reduction"), tr("'%1' is not a preview reduction.").arg(text));
+      return;
+    }
+    m_PreviewReduction = reduction;
+    schedulePreview();
+  });
+  connect(m_ActionFilterHasSideEffects, &QAction::triggered, [=](bool checked) {
+    SVPipelineView* pipelineView = m_Ui->pipelineListWidget->getPipelineView();
+    QModelIndexList selectedIndexes = pipelineView->selectionModel()->selectedRows();
+    for(const QModelIndex& index : selectedIndexes)
+    {
+      PipelineOptimizer::SetHasSideEffects(getPipelineModel()->filter(index), checked);
+    }
+  });
 
   m_ActionNew->setShortcut(QKeySequence::New);
   m_ActionOpen->setShortcut(QKeySequence::Open);
@@ -605,6 +952,7 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   m_ActionCheckForUpdates->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_U));
   m_ActionShowSIMPLViewHelp->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_H));
   m_ActionPluginInformation->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_I));
+  m_ActionExecutePipeline->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_R));
 
   // Pipeline View Actions
   SVPipelineView* viewWidget = m_Ui->pipelineListWidget->getPipelineView();
@@ -663,6 +1011,7 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   m_MenuView->addAction(m_Ui->issuesDockWidget->toggleViewAction());
   m_MenuView->addAction(m_Ui->stdOutDockWidget->toggleViewAction());
   m_MenuView->addAction(m_Ui->dataBrowserDockWidget->toggleViewAction());
+  m_MenuView->addAction(m_Ui->jobManagerDockWidget->toggleViewAction());
 
   // Create Bookmarks Menu
   m_SIMPLViewMenu->addMenu(m_MenuBookmarks);
@@ -672,6 +1021,37 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
 
   // Create Pipeline Menu
   m_SIMPLViewMenu->addMenu(m_MenuPipeline);
+  m_MenuPipeline->addAction(m_ActionExecutePipeline);
+  m_MenuPipeline->addAction(m_ActionRunAsBackgroundJob);
+  m_MenuPipeline->addAction(m_ActionPreviewMode);
+  m_MenuPipeline->addAction(m_ActionPreviewReduction);
+  m_MenuPipeline->addAction(m_ActionReleaseDeadArrays);
+  m_MenuPipeline->addAction(m_ActionOptimizePipeline);
+  m_MenuPipeline->addAction(m_ActionFuseElementwiseFilters);
+  m_MenuPipeline->addAction(m_ActionTiledExecution);
+  m_MenuPipeline->addAction(m_ActionTiledSlabThickness);
+  m_MenuPipeline->addAction(m_ActionThreadBudget);
+  m_MenuPipeline->addAction(m_ActionAutoTuneThreads);
+  m_MenuPipeline->addAction(m_ActionThreadProfiles);
+  m_MenuPipeline->addAction(m_ActionArrayPoolRetention);
+  m_MenuPipeline->addAction(m_ActionArrayPoolHugePages);
+  m_MenuPipeline->addAction(m_ActionPinThreadsToNumaNodes);
+  m_MenuPipeline->addMenu(m_MenuMemoryCheck);
+  m_MenuPipeline->addAction(m_ActionMemoryBudget);
+  m_MenuPipeline->addAction(m_ActionSpillToDisk);
+  m_MenuPipeline->addAction(m_ActionCompressIdleArrays);
+  m_MenuPipeline->addMenu(m_MenuArrayMapping);
+  m_MenuPipeline->addAction(m_ActionParallelChunkedReads);
+  m_MenuPipeline->addAction(m_ActionAsyncWrites);
+  m_MenuPipeline->addAction(m_ActionPrefetchInputs);
+  m_MenuPipeline->addMenu(m_MenuWriteProfile);
+  m_MenuPipeline->addMenu(m_MenuWriterProfile);
+  m_MenuPipeline->addAction(m_ActionMeasureWriteProfiles);
+  m_MenuPipeline->addAction(m_ActionIncrementalWrites);
+  m_MenuPipeline->addAction(m_ActionKeepSnapshots);
+  m_MenuPipeline->addAction(m_ActionClearSnapshots);
+  m_MenuPipeline->addAction(m_ActionFilterHasSideEffects);
+  m_MenuPipeline->addSeparator();
   m_MenuPipeline->addAction(actionClearPipeline);
 
   // Create Help Menu
@@ -737,12 +1117,20 @@ void SIMPLView_UI::connectSignalsSlots()
 
   /* Pipeline List Widget Connections */
   connect(m_Ui->pipelineListWidget, &PipelineListWidget::pipelineCanceled, pipelineView, &SVPipelineView::cancelPipeline);
+  connect(m_Ui->pipelineListWidget, &PipelineListWidget::pipelineCanceled, [=] {
+    if(m_PipelineExecutor != nullptr)
+    {
+      // The executor's thread is blocked inside execute() so this has to be a direct call
+      m_PipelineExecutor->cancelPipeline();
+    }
+  });
 
   /* Pipeline View Connections */
   connect(pipelineView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &SIMPLView_UI::filterSelectionChanged);
   connect(pipelineView, &SVPipelineView::filterParametersChanged, [=] (AbstractFilter::Pointer filter) {
     m_Ui->dataBrowserWidget->filterActivated(filter);
     markDocumentAsDirty();
+    schedulePreview();
   });
   connect(pipelineView, &SVPipelineView::clearDataStructureWidgetTriggered, [=] { m_Ui->dataBrowserWidget->filterActivated(AbstractFilter::NullPointer()); });
   connect(pipelineView, &SVPipelineView::filterInputWidgetNeedsCleared, this, &SIMPLView_UI::clearFilterInputWidget);
@@ -753,18 +1141,41 @@ void SIMPLView_UI::connectSignalsSlots()
   // Connection that displays issues in the Issue Table when the preflight is finished
   connect(pipelineView, &SVPipelineView::preflightFinished, [=](FilterPipeline::Pointer pipeline, int err) {
     m_Ui->dataBrowserWidget->refreshData();
+    if(m_ActionTiledExecution->isChecked())
+    {
+      flagUntileableFilters(pipeline);
+    }
+    if(err >= 0)
+    {
+      updateMemoryEstimate(pipeline);
+    }
     m_Ui->issuesWidget->displayCachedMessages();
     m_Ui->pipelineListWidget->preflightFinished(pipeline, err);
   });
 
   connect(pipelineView, &SVPipelineView::pipelineHasMessage, this, &SIMPLView_UI::processPipelineMessage);
   connect(pipelineView, &SVPipelineView::pipelineFinished, this, &SIMPLView_UI::pipelineDidFinish);
+  connect(pipelineView, &SVPipelineView::pipelineFinished, [=] {
+    // The pipeline view leaves the results with the filters, the last of which holds all of them
+    FilterPipeline::Pointer finished = pipelineView->getFilterPipeline();
+    AbstractFilter::Pointer last = finished->getFilterContainer().isEmpty() ? AbstractFilter::NullPointer() : finished->getFilterContainer().last();
+    m_Ui->arrayMemoryWidget->clearArrays();
+    showResultArrays(last.get() != nullptr ? last->getDataContainerArray() : DataContainerArray::NullPointer());
+  });
+  connect(m_Ui->arrayMemoryWidget, &ArrayMemoryWidget::publishArrayRequested, this, &SIMPLView_UI::publishArray);
+  connect(m_Ui->arrayMemoryWidget, &ArrayMemoryWidget::exportAttributeMatrixRequested, this, &SIMPLView_UI::exportAttributeMatrix);
+  connect(m_Ui->arrayMemoryWidget, &ArrayMemoryWidget::unpublishAllRequested, [=] {
+    m_SharedArrays.unpublishAll();
+    listResultArrays();
+    statusBar()->showMessage(tr("Removed every shared array"));
+  });
   connect(pipelineView, &SVPipelineView::pipelineFilePathUpdated, this, &SIMPLView_UI::setWindowFilePath);
 
   connect(pipelineView, &SVPipelineView::pipelineChanged, this, &SIMPLView_UI::handlePipelineChanges);
   connect(pipelineView, &SVPipelineView::filePathOpened, [=](const QString& filePath) { m_LastOpenedFilePath = filePath; });
 
   connect(pipelineView, SIGNAL(filterEnabledStateChanged()), this, SLOT(markDocumentAsDirty()));
+  connect(pipelineView, &SVPipelineView::filterEnabledStateChanged, this, &SIMPLView_UI::schedulePreview);
   connect(pipelineView, SIGNAL(statusMessage(const QString&)), statusBar(), SLOT(showMessage(const QString&)));
   connect(pipelineView, SIGNAL(stdOutMessage(const QString&)), this, SLOT(addStdOutputMessage(const QString&)));
 
@@ -794,9 +1205,18 @@ void SIMPLView_UI::showDockWidget(QDockWidget* dockWidget)
 int SIMPLView_UI::openPipeline(const QString& filePath)
 {
   SVPipelineView* pipelineView = m_Ui->pipelineListWidget->getPipelineView();
+  int firstFilter = pipelineView->getPipelineModel()->rowCount();
   int err = pipelineView->openPipeline(filePath);
   if (err >= 0)
   {
+    // The view appends the filters of the file to the ones it already has, and only keeps the filters
+    FilterPipeline::Pointer opened = pipelineView->getFilterPipeline();
+    PipelineFileSettings::ReadFile(filePath, opened, firstFilter);
+    if(firstFilter == 0)
+    {
+      m_PipelineSettings = opened->property(PipelineFileSettings::PipelinePropertyName);
+    }
+
     PipelineModel* model = pipelineView->getPipelineModel();
     if (model->rowCount() > 0)
     {
@@ -819,6 +1239,7 @@ int SIMPLView_UI::openPipeline(const QString& filePath)
 void SIMPLView_UI::handlePipelineChanges()
 {
   markDocumentAsDirty();
+  schedulePreview();
 
   SVPipelineView* pipelineView = m_Ui->pipelineListWidget->getPipelineView();
   QModelIndexList selectedIndexes = pipelineView->selectionModel()->selectedRows();
@@ -843,7 +1264,527 @@ void SIMPLView_UI::handlePipelineChanges()
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::executePipeline()
 {
-  m_Ui->pipelineListWidget->getPipelineView()->executePipeline();
+  SVPipelineView* pipelineView = m_Ui->pipelineListWidget->getPipelineView();
+  if(m_PreviewRunning && m_PipelineExecutor != nullptr)
+  {
+    // A full run replaces whatever the preview would have shown
+    m_PreviewTimer->stop();
+    m_PreviewRestart = false;
+    m_ExecuteAfterPreview = true;
+    m_PipelineExecutor->cancelPipeline();
+    return;
+  }
+  if(pipelineView->isPipelineCurrentlyRunning() || m_PipelineExecutor != nullptr)
+  {
+    return;
+  }
+  m_PreviewTimer->stop();
+
+  FilterPipeline::Pointer pipeline = pipelineView->getFilterPipeline();
+  if(!m_ActionTiledExecution->isChecked() && !confirmMemoryEstimate(pipeline))
+  {
+    m_Ui->pipelineListWidget->pipelineFinished();
+    return;
+  }
+
+  // Pipelines without independent branches gain nothing from the concurrent executor, so
+  // let the pipeline view run those as it always has unless one of the executor passes is enabled.
+  // With more than one window open or background jobs running, the executor is needed to share the
+  // ThreadBudget between them.
+  PipelineDataFlowGraph graph(pipeline);
+  bool hasWriterProfile = false;
+  for(int i = 0; i < graph.size(); i++)
+  {
+    hasWriterProfile = hasWriterProfile || !WriteProfile::GetWriterPreset(graph.filter(i)).isEmpty();
+  }
+  if(graph.branchCount() < 2 && !m_ActionReleaseDeadArrays->isChecked() && !m_ActionOptimizePipeline->isChecked() && !m_ActionFuseElementwiseFilters->isChecked() &&
+     !m_ActionTiledExecution->isChecked() && !m_ActionKeepSnapshots->isChecked() && !m_ActionSpillToDisk->isChecked() &&
+     m_CompressIdleFilters == 0 && m_Ui->arrayMemoryWidget->getCompressedArrayPaths().isEmpty() && m_ArrayMapping == MappedFileReader::Mode::Off && !m_ActionParallelChunkedReads->isChecked() &&
+     !m_ActionAsyncWrites->isChecked() && m_PrefetchDepth == 0 && m_WriteProfile == WriteProfile::Preset::Default && !hasWriterProfile && !m_ActionIncrementalWrites->isChecked() && dream3dApp->getSIMPLViewInstances().size() < 2 && dream3dApp->getJobQueue()->isIdle())
+  {
+    pipelineView->executePipeline();
+    return;
+  }
+
+  runPipelineExecutor(pipeline);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t SIMPLView_UI::memoryBudget() const
+{
+  if(m_MemoryBudgetMB > 0)
+  {
+    return static_cast<size_t>(m_MemoryBudgetMB) * 1024 * 1024;
+  }
+  return MemoryEstimator::AvailableBytes();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::updateMemoryEstimate(FilterPipeline::Pointer pipeline)
+{
+  if(m_MemoryPolicy == MemoryEstimator::Policy::Off || pipeline->size() == 0)
+  {
+    m_MemoryEstimateLabel->clear();
+    m_MemoryEstimateLabel->setToolTip(QString());
+    return;
+  }
+
+  MemoryEstimator estimator(pipeline, m_ActionReleaseDeadArrays->isChecked(), m_Ui->arrayMemoryWidget->getKeptArrayPaths());
+  size_t budget = memoryBudget();
+  bool exceeds = estimator.exceeds(budget);
+
+  m_MemoryEstimateLabel->setText(tr("Peak %1 / %2").arg(ArrayMemoryWidget::FormatBytes(estimator.getPeakBytes())).arg(budget > 0 ? ArrayMemoryWidget::FormatBytes(budget) : tr("unknown")));
+  m_MemoryEstimateLabel->setToolTip(estimator.report(budget).join("\n"));
+  m_MemoryEstimateLabel->setStyleSheet(exceeds ? QString("QLabel { color: red; }") : QString());
+
+  if(exceeds)
+  {
+    const FilterMemoryEstimate& peak = estimator.getFilters()[estimator.getPeakFilter()];
+    PipelineMessage msg;
+    msg.setFilterClassName(peak.filter->getNameOfClass());
+    msg.setFilterHumanLabel(peak.filter->getHumanLabel());
+    msg.setPipelineIndex(peak.filter->getPipelineIndex());
+    msg.setType(PipelineMessage::MessageType::Warning);
+    msg.setText(tr("%1, which the pipeline is expected to exceed").arg(estimator.summary(budget)));
+    m_Ui->issuesWidget->processPipelineMessage(msg);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLView_UI::confirmMemoryEstimate(FilterPipeline::Pointer pipeline)
+{
+  if(m_MemoryPolicy == MemoryEstimator::Policy::Off)
+  {
+    return true;
+  }
+
+  MemoryEstimator estimator(pipeline, m_ActionReleaseDeadArrays->isChecked(), m_Ui->arrayMemoryWidget->getKeptArrayPaths());
+  size_t budget = memoryBudget();
+  if(!estimator.exceeds(budget))
+  {
+    return true;
+  }
+
+  // The executor keeps the arrays within the budget by spilling them, at the cost of disk traffic
+  if(m_ActionSpillToDisk->isChecked())
+  {
+    addStdOutputMessage(tr("%1. Arrays will be spilled to disk while they exceed the budget.").arg(estimator.summary(budget)));
+    return true;
+  }
+
+  QString text = tr("%1.\n\nThe pipeline is likely to run out of memory.").arg(estimator.summary(budget));
+  if(m_MemoryPolicy == MemoryEstimator::Policy::Refuse)
+  {
+    QMessageBox::critical(this, tr("Not Enough Memory"), tr("%1 It will not be executed while the memory check is set to refuse.").arg(text));
+    return false;
+  }
+  return QMessageBox::warning(this, tr("Not Enough Memory"), tr("%1 Execute anyway?").arg(text), QMessageBox::Yes | QMessageBox::No, QMessageBox::No) == QMessageBox::Yes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::startPreview()
+{
+  if(!m_ActionPreviewMode->isChecked() || m_ExecuteAfterPreview)
+  {
+    return;
+  }
+
+  SVPipelineView* pipelineView = m_Ui->pipelineListWidget->getPipelineView();
+  if(m_PipelineExecutor != nullptr)
+  {
+    if(m_PreviewRunning)
+    {
+      m_PreviewRestart = true;
+      m_PipelineExecutor->cancelPipeline();
+    }
+    return;
+  }
+  if(pipelineView->isPipelineCurrentlyRunning())
+  {
+    return;
+  }
+
+  FilterPipeline::Pointer pipeline = pipelineView->getFilterPipeline();
+  if(pipeline->size() == 0)
+  {
+    return;
+  }
+
+  m_PreviewRunning = true;
+  m_PreviewRestart = false;
+  runPipelineExecutor(pipeline, true);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::schedulePreview()
+{
+  if(!m_ActionPreviewMode->isChecked())
+  {
+    return;
+  }
+
+  // Results for the old parameters are of no use, so stop computing them right away
+  if(m_PreviewRunning && m_PipelineExecutor != nullptr)
+  {
+    m_PipelineExecutor->cancelPipeline();
+  }
+  m_PreviewTimer->start();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer SIMPLView_UI::getEditedPipeline()
+{
+  FilterPipeline::Pointer pipeline = m_Ui->pipelineListWidget->getPipelineView()->getFilterPipeline();
+  pipeline->setProperty(PipelineFileSettings::PipelinePropertyName, m_PipelineSettings);
+  return pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::runPipelineExecutor(FilterPipeline::Pointer pipeline, bool preview)
+{
+  // Clear the issues and stop adding filters while the pipeline runs, same as the pipeline view does
+  m_Ui->issuesWidget->clearIssues();
+  m_Ui->filterListWidget->blockSignals(true);
+  m_Ui->filterLibraryWidget->blockSignals(true);
+
+  m_PipelineExecutor = new PipelineExecutor(pipeline);
+  m_PipelineExecutor->addMessageReceiver(this);
+  m_PipelineExecutor->addMessageReceiver(m_Ui->issuesWidget);
+  m_PipelineExecutor->setReleaseDeadArrays(m_ActionReleaseDeadArrays->isChecked());
+  m_PipelineExecutor->setOptimizePipeline(m_ActionOptimizePipeline->isChecked());
+  m_PipelineExecutor->setFuseElementwiseFilters(m_ActionFuseElementwiseFilters->isChecked());
+  m_PipelineExecutor->setKeptArrayPaths(m_Ui->arrayMemoryWidget->getKeptArrayPaths());
+  m_PipelineExecutor->setTiledSlabThickness(m_ActionTiledExecution->isChecked() ? m_TiledSlabThickness : 0);
+  m_PipelineExecutor->setPreviewReduction(preview ? m_PreviewReduction : PreviewReduction());
+  m_PipelineExecutor->setSpillMemoryLimit(m_ActionSpillToDisk->isChecked() ? memoryBudget() : 0);
+  m_PipelineExecutor->setCompressIdleArrays(m_CompressIdleFilters);
+  m_PipelineExecutor->setArrayMapping(m_ArrayMapping);
+  m_PipelineExecutor->setParallelChunkedReads(m_ActionParallelChunkedReads->isChecked());
+  m_PipelineExecutor->setAsyncWrites(m_ActionAsyncWrites->isChecked());
+  m_PipelineExecutor->setPrefetchDepth(m_PrefetchDepth);
+  m_PipelineExecutor->setWriteProfile(m_WriteProfile);
+  m_PipelineExecutor->setIncrementalWrites(m_ActionIncrementalWrites->isChecked());
+  m_PipelineExecutor->setCompressedArrayPaths(m_Ui->arrayMemoryWidget->getCompressedArrayPaths());
+  // Snapshots of a preview would hold reduced data, so they are only taken by full runs
+  if(m_ActionKeepSnapshots->isChecked() && !preview)
+  {
+    m_SnapshotStore = std::make_shared<DataSnapshotStore>();
+    m_PipelineExecutor->setSnapshotStore(m_SnapshotStore);
+  }
+  // Pipelines run from the editor are what the user is waiting for
+  pipeline->setProperty(PipelineFileSettings::PipelinePropertyName, m_PipelineSettings);
+  m_PipelineExecutor->setThreadBudgetRequest(PipelineFileSettings::ReadRequest(pipeline, ThreadBudget::PriorityClass::Interactive));
+
+  int branchCount = PipelineDataFlowGraph(pipeline).branchCount();
+  if(branchCount > 1)
+  {
+    addStdOutputMessage(QString("Executing %1 independent branches concurrently").arg(branchCount));
+  }
+
+  m_PipelineExecutorThread = new QThread(this);
+  m_PipelineExecutor->moveToThread(m_PipelineExecutorThread);
+  connect(m_PipelineExecutorThread, &QThread::started, m_PipelineExecutor, &PipelineExecutor::run);
+  connect(m_PipelineExecutor, &PipelineExecutor::pipelineFinished, m_PipelineExecutorThread, &QThread::quit);
+  connect(m_PipelineExecutorThread, &QThread::finished, this, [=] {
+    updateArrayMemoryWidget(m_PipelineExecutor);
+    if(!m_PreviewRunning)
+    {
+      showResultArrays(m_PipelineExecutor->getDataContainerArray());
+    }
+
+    m_PipelineExecutor->deleteLater();
+    m_PipelineExecutor = nullptr;
+    m_PipelineExecutorThread->deleteLater();
+    m_PipelineExecutorThread = nullptr;
+
+    pipelineDidFinish();
+
+    bool wasPreview = m_PreviewRunning;
+    m_PreviewRunning = false;
+    if(m_ExecuteAfterPreview)
+    {
+      m_ExecuteAfterPreview = false;
+      executePipeline();
+    }
+    else if(wasPreview && m_PreviewRestart)
+    {
+      startPreview();
+    }
+    else if(wasPreview)
+    {
+      statusBar()->showMessage(tr("Preview finished (%1)").arg(m_PreviewReduction.toString()));
+    }
+  });
+
+  m_PipelineExecutorThread->start();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::flagUntileableFilters(FilterPipeline::Pointer pipeline)
+{
+  QVector<TilingProblem> problems = TiledExecution::FindProblems(pipeline);
+  for(const TilingProblem& problem : problems)
+  {
+    PipelineMessage msg;
+    if(problem.filter.get() != nullptr)
+    {
+      msg.setFilterClassName(problem.filter->getNameOfClass());
+      msg.setFilterHumanLabel(problem.filter->getHumanLabel());
+      msg.setPipelineIndex(problem.filter->getPipelineIndex());
+    }
+    msg.setType(PipelineMessage::MessageType::Warning);
+    msg.setText(tr("Cannot be tiled: %1").arg(problem.text));
+    m_Ui->issuesWidget->processPipelineMessage(msg);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::updateArrayMemoryWidget(PipelineExecutor* executor)
+{
+  ArrayMemoryWidget* widget = m_Ui->arrayMemoryWidget;
+  widget->clearArrays();
+
+  QStringList summary;
+  if(executor->getReleaseDeadArrays())
+  {
+    QVector<ReleasedArray> releasedArrays = executor->getReleasedArrays();
+    for(const ReleasedArray& released : releasedArrays)
+    {
+      widget->addArray(released.path, tr("Released"), released.bytes, tr("After %1").arg(released.filterHumanLabel));
+    }
+
+    size_t peak = executor->getPeakArrayBytes();
+    size_t peakWithoutRelease = executor->getPeakArrayBytesWithoutRelease();
+    summary.push_back(tr("%1 arrays released. Peak array memory %2 instead of %3 (saved %4)")
+                          .arg(releasedArrays.size())
+                          .arg(ArrayMemoryWidget::FormatBytes(peak))
+                          .arg(ArrayMemoryWidget::FormatBytes(peakWithoutRelease))
+                          .arg(ArrayMemoryWidget::FormatBytes(peakWithoutRelease - peak)));
+  }
+
+  std::shared_ptr<DataSnapshotStore> store = executor->getSnapshotStore();
+  if(store.get() != nullptr && store->size() > 0)
+  {
+    size_t shared = 0;
+    size_t unshared = 0;
+    for(int i = 0; i < store->size(); i++)
+    {
+      SnapshotAccounting accounting = store->accounting(i);
+      shared += accounting.sharedBytes;
+      unshared += accounting.privateBytes;
+    }
+    summary.push_back(tr("%1 snapshots hold %2 instead of %3 (%4 shared between snapshots, %5 private)")
+                          .arg(store->size())
+                          .arg(ArrayMemoryWidget::FormatBytes(store->getStoredBytes()))
+                          .arg(ArrayMemoryWidget::FormatBytes(store->getLogicalBytes()))
+                          .arg(ArrayMemoryWidget::FormatBytes(shared))
+                          .arg(ArrayMemoryWidget::FormatBytes(unshared)));
+
+    QStringList report = store->report();
+    for(const QString& line : report)
+    {
+      addStdOutputMessage(line);
+    }
+  }
+
+  SpillStats spillStats = executor->getSpillStats();
+  if(spillStats.spilledArrays > 0)
+  {
+    summary.push_back(tr("%1 arrays (%2) spilled to disk, %3 read back. At most %4 on disk at once")
+                          .arg(spillStats.spilledArrays)
+                          .arg(ArrayMemoryWidget::FormatBytes(spillStats.spilledBytes))
+                          .arg(spillStats.restoredArrays)
+                          .arg(ArrayMemoryWidget::FormatBytes(spillStats.peakSpilledBytes)));
+  }
+
+  QVector<CompressedArrayInfo> compressedArrays = executor->getCompressedArrays();
+  for(const CompressedArrayInfo& compressed : compressedArrays)
+  {
+    double ratio = compressed.compressedBytes > 0 ? static_cast<double>(compressed.bytes) / static_cast<double>(compressed.compressedBytes) : 1.0;
+    widget->addArray(compressed.path, tr("Compressed"), compressed.bytes,
+                     tr("%1x, %2 in memory, after %3").arg(ratio, 0, 'f', 1).arg(ArrayMemoryWidget::FormatBytes(compressed.compressedBytes)).arg(compressed.filterHumanLabel));
+  }
+  CompressionStats compressionStats = executor->getCompressionStats();
+  if(compressionStats.compressedArrays > 0)
+  {
+    summary.push_back(tr("%1 arrays compressed %2x. At most %3 saved at once")
+                          .arg(compressionStats.compressedArrays)
+                          .arg(static_cast<double>(compressionStats.compressedBytes) / static_cast<double>(std::max<size_t>(compressionStats.storedBytes, 1)), 0, 'f', 1)
+                          .arg(ArrayMemoryWidget::FormatBytes(compressionStats.peakSavedBytes)));
+  }
+  MappingStats mappingStats = executor->getMappingStats();
+  if(mappingStats.mappedArrays > 0 || mappingStats.scratchArrays > 0)
+  {
+    summary.push_back(tr("%1 arrays (%2) mapped from input files, %3 arrays (%4) in scratch files")
+                          .arg(mappingStats.mappedArrays)
+                          .arg(ArrayMemoryWidget::FormatBytes(mappingStats.mappedBytes))
+                          .arg(mappingStats.scratchArrays)
+                          .arg(ArrayMemoryWidget::FormatBytes(mappingStats.scratchBytes)));
+  }
+  AsyncWriteStats writeStats = executor->getAsyncWriteStats();
+  if(writeStats.writes > 0)
+  {
+    summary.push_back(tr("%1 files (%2) written in the background, %3 ms of %4 ms overlapped with other filters")
+                          .arg(writeStats.writes)
+                          .arg(ArrayMemoryWidget::FormatBytes(writeStats.writtenBytes))
+                          .arg(std::max<qint64>(writeStats.writeMsecs - writeStats.waitMsecs, 0))
+                          .arg(writeStats.writeMsecs));
+  }
+  PrefetchStats prefetchStats = executor->getPrefetchStats();
+  if(prefetchStats.files > 0)
+  {
+    int lookups = prefetchStats.hits + prefetchStats.partialHits + prefetchStats.misses;
+    summary.push_back(tr("%1 input files (%2) prefetched, %3 of %4 ready when their reader started")
+                          .arg(prefetchStats.prefetchedFiles)
+                          .arg(ArrayMemoryWidget::FormatBytes(prefetchStats.prefetchedBytes))
+                          .arg(prefetchStats.hits)
+                          .arg(lookups));
+  }
+  widget->setSummary(summary.join("\n"));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::showResultArrays(DataContainerArray::Pointer results)
+{
+  // The filters hold on to the results until the next preflight anyway, so keeping them costs nothing
+  m_LastResults = results;
+
+  // Published arrays follow the latest results; consumers pick up the new segments from the catalog
+  QVector<DataArrayPath> published = m_SharedArrays.getPublishedPaths();
+  for(const DataArrayPath& path : published)
+  {
+    QString errorMessage;
+    if(!m_SharedArrays.publish(m_LastResults, path, &errorMessage))
+    {
+      m_SharedArrays.unpublish(path);
+      addStdOutputMessage(tr("'%1' is no longer published to shared memory: %2").arg(path.serialize("/")).arg(errorMessage));
+    }
+  }
+  if(!m_SharedArrays.getPublishedPaths().isEmpty())
+  {
+    addStdOutputMessage(tr("%1 arrays (%2) published again to shared memory, catalog '%3'")
+                            .arg(m_SharedArrays.getPublishedPaths().size())
+                            .arg(ArrayMemoryWidget::FormatBytes(m_SharedArrays.getPublishedBytes()))
+                            .arg(m_SharedArrays.getCatalogName()));
+  }
+  listResultArrays();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::listResultArrays()
+{
+  ArrayMemoryWidget* widget = m_Ui->arrayMemoryWidget;
+  widget->clearResultArrays();
+  if(m_LastResults.get() == nullptr)
+  {
+    return;
+  }
+
+  QVector<SharedArrayPublisher::Segment> segments = m_SharedArrays.getSegments();
+  QList<DataContainer::Pointer> containers = m_LastResults->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::AttributeMatrixMap_t& matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        DataArrayPath path(dc->getName(), am->getName(), name);
+        QString segmentName;
+        for(const SharedArrayPublisher::Segment& segment : segments)
+        {
+          segmentName = (segment.path == path) ? segment.name : segmentName;
+        }
+        widget->addResultArray(path, ArrayLivenessAnalysis::ArrayBytes(m_LastResults, path), segmentName);
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::publishArray(const DataArrayPath& path, bool publish)
+{
+  if(!publish)
+  {
+    m_SharedArrays.unpublish(path);
+    listResultArrays();
+    statusBar()->showMessage(tr("Removed '%1' from shared memory").arg(path.serialize("/")));
+    return;
+  }
+
+  QString errorMessage;
+  if(!m_SharedArrays.publish(m_LastResults, path, &errorMessage))
+  {
+    QMessageBox::warning(this, tr("Publish To Shared Memory"), errorMessage);
+    return;
+  }
+  listResultArrays();
+  addStdOutputMessage(tr("Published '%1' to shared memory. The catalog '%2' lists %3 arrays:\n%4")
+                          .arg(path.serialize("/"))
+                          .arg(m_SharedArrays.getCatalogName())
+                          .arg(m_SharedArrays.getPublishedPaths().size())
+                          .arg(QString::fromUtf8(m_SharedArrays.catalog())));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::exportAttributeMatrix(const DataArrayPath& amPath)
+{
+  AttributeMatrix::Pointer am = (m_LastResults.get() != nullptr) ? m_LastResults->getAttributeMatrix(amPath) : AttributeMatrix::NullPointer();
+  if(am.get() == nullptr)
+  {
+    QMessageBox::warning(this, tr("Export Attribute Matrix"), tr("The attribute matrix '%1' is no longer available").arg(amPath.serialize("/")));
+    return;
+  }
+
+  QFileInfo lastOpened(m_LastOpenedFilePath);
+  QString proposedDir = lastOpened.isDir() ? lastOpened.absoluteFilePath() : lastOpened.absolutePath();
+  QString proposedFile = proposedDir + QDir::separator() + amPath.getAttributeMatrixName() + "." + ColumnarFile::Extension;
+  QString filePath = QFileDialog::getSaveFileName(this, tr("Export Attribute Matrix"), proposedFile, tr("Columnar File (*.%1);;All Files (*.*)").arg(ColumnarFile::Extension));
+  if(filePath.isEmpty())
+  {
+    return;
+  }
+
+  QStringList skipped;
+  QString errorMessage;
+  if(!ColumnarFile::Write(am, amPath.getDataContainerName(), filePath, &skipped, &errorMessage))
+  {
+    QMessageBox::warning(this, tr("Export Attribute Matrix"), errorMessage);
+    return;
+  }
+  QString message = tr("Exported '%1' to '%2'").arg(amPath.serialize("/")).arg(filePath);
+  if(!skipped.isEmpty())
+  {
+    message += tr(". Arrays that are not plain numbers were left out: %1").arg(skipped.join(", "));
+  }
+  addStdOutputMessage(message);
 }
 
 // -----------------------------------------------------------------------------
@@ -1067,6 +2008,25 @@ void SIMPLView_UI::filterSelectionChanged(const QItemSelection& selected, const
     clearFilterInputWidget();
     m_Ui->dataBrowserWidget->filterActivated(AbstractFilter::NullPointer());
   }
+
+  m_ActionFilterHasSideEffects->setEnabled(!selectedIndexes.isEmpty());
+  m_ActionFilterHasSideEffects->setChecked(!selectedIndexes.isEmpty() && PipelineOptimizer::GetHasSideEffects(pipelineModel->filter(selectedIndexes[0])));
+
+  AbstractFilter::Pointer selectedWriter;
+  for(int i = 0; i < selectedIndexes.size() && selectedWriter.get() == nullptr; i++)
+  {
+    AbstractFilter::Pointer filter = pipelineModel->filter(selectedIndexes[i]);
+    if(ArrayLivenessAnalysis::IsWriterFilter(filter))
+    {
+      selectedWriter = filter;
+    }
+  }
+  m_MenuWriterProfile->setEnabled(selectedWriter.get() != nullptr);
+  QString writerPreset = (selectedWriter.get() != nullptr) ? WriteProfile::GetWriterPreset(selectedWriter) : QString();
+  for(QAction* action : m_WriterProfileGroup->actions())
+  {
+    action->setChecked(action->data().toString() == writerPreset);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -38,10 +38,13 @@
 #pragma once
 
 
+#include <memory>
+
 //-- Qt Includes
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QList>
+#include <QtCore/QVariant>
 #include <QtCore/QVector>
 #include <QtWidgets/QWidget>
 #include <QtWidgets/QMainWindow>
@@ -57,6 +60,13 @@
 #include "SVWidgetsLib/Widgets/FilterInputWidget.h"
 #include "SVWidgetsLib/QtSupport/QtSSettings.h"
 
+#include "Common/DataSnapshotStore.h"
+#include "Common/MappedFileReader.h"
+#include "Common/MemoryEstimator.h"
+#include "Common/PreviewReduction.h"
+#include "Common/SharedArrayPublisher.h"
+#include "Common/WriteProfile.h"
+
 //-- UIC generated Header
 #include "ui_SIMPLView_UI.h"
 
@@ -76,6 +86,10 @@ class PipelineModel;
 class PipelineListWidget;
 class SVPipelineViewWidget;
 class SIMPLViewMenuItems;
+class PipelineExecutor;
+class QTimer;
+class QLabel;
+class QActionGroup;
 
 /**
 * @class SIMPLView_UI SIMPLView_UI Applications/SIMPLView/SIMPLView_UI.h
@@ -125,7 +139,8 @@ class SIMPLView_UI : public QMainWindow
     int openPipeline(const QString& filePath);
 
     /**
-     * @brief executePipeline
+     * @brief executePipeline Executes the current pipeline. Pipelines that have independent branches
+     * are run through the PipelineExecutor so that those branches execute at the same time.
      */
     void executePipeline();
 
@@ -252,6 +267,92 @@ class SIMPLView_UI : public QMainWindow
     */
     void handlePipelineChanges();
 
+    /**
+     * @brief runPipelineExecutor Runs the pipeline through a PipelineExecutor on a separate thread
+     * @param pipeline
+     * @param preview Runs the pipeline as a preview with the current PreviewReduction
+     */
+    void runPipelineExecutor(FilterPipeline::Pointer pipeline, bool preview = false);
+
+    /**
+     * @brief getEditedPipeline Returns the pipeline of the pipeline view with the settings of the whole
+     * pipeline, which the view does not keep, applied
+     * @return
+     */
+    FilterPipeline::Pointer getEditedPipeline();
+
+    /**
+     * @brief memoryBudget Returns the memory the peak estimate is compared with: the configured budget or
+     * else the memory that is currently available
+     * @return
+     */
+    size_t memoryBudget() const;
+
+    /**
+     * @brief updateMemoryEstimate Shows the peak memory estimate of a preflighted pipeline in the status bar
+     * and adds a warning to the issues table if it exceeds the budget
+     * @param pipeline
+     */
+    void updateMemoryEstimate(FilterPipeline::Pointer pipeline);
+
+    /**
+     * @brief confirmMemoryEstimate Applies the memory policy before a pipeline is executed
+     * @param pipeline The preflighted pipeline
+     * @return false if the pipeline must not be executed
+     */
+    bool confirmMemoryEstimate(FilterPipeline::Pointer pipeline);
+
+    /**
+     * @brief startPreview Runs a preview of the pipeline if preview mode is on. A running preview is
+     * canceled and started again once it has stopped.
+     */
+    void startPreview();
+
+    /**
+     * @brief schedulePreview Cancels a running preview and starts a new one once the pipeline has not
+     * changed for a moment
+     */
+    void schedulePreview();
+
+    /**
+     * @brief updateArrayMemoryWidget Shows the arrays the executor released and the peak memory savings
+     * @param executor
+     */
+    void updateArrayMemoryWidget(PipelineExecutor* executor);
+
+    /**
+     * @brief showResultArrays Keeps 'results' for publishing to shared memory, publishes the arrays that are
+     * published already again from them and lists them in the ArrayMemoryWidget
+     * @param results
+     */
+    void showResultArrays(DataContainerArray::Pointer results);
+
+    /**
+     * @brief listResultArrays Lists the arrays of the last results in the ArrayMemoryWidget
+     */
+    void listResultArrays();
+
+    /**
+     * @brief publishArray Publishes the array at 'path' of the last results to shared memory or removes it
+     * from there
+     * @param path
+     * @param publish
+     */
+    void publishArray(const DataArrayPath& path, bool publish);
+
+    /**
+     * @brief exportAttributeMatrix Asks for a file and writes the attribute matrix at 'amPath' of the last
+     * results to it as a ColumnarFile
+     * @param amPath
+     */
+    void exportAttributeMatrix(const DataArrayPath& amPath);
+
+    /**
+     * @brief flagUntileableFilters Adds a warning to the issues table for everything that prevents tiled execution
+     * @param pipeline The preflighted pipeline
+     */
+    void flagUntileableFilters(FilterPipeline::Pointer pipeline);
+
   protected slots:
     /**
      * @brief pipelineDidFinish
@@ -309,6 +410,7 @@ class SIMPLView_UI : public QMainWindow
 //    StatusBarWidget*                        m_StatusBar = nullptr;
 
     QString                                 m_LastOpenedFilePath;
+    QVariant                                m_PipelineSettings;
 
     FilterInputWidget*                      m_FilterInputWidget = nullptr;
 
@@ -337,6 +439,63 @@ class SIMPLView_UI : public QMainWindow
     QAction*                                m_ActionClearCache = nullptr;
     QAction*                                m_ActionSetDataFolder = nullptr;
     QAction*                                m_ActionShowDataFolder = nullptr;
+    QAction*                                m_ActionExecutePipeline = nullptr;
+    QAction*                                m_ActionReleaseDeadArrays = nullptr;
+    QAction*                                m_ActionOptimizePipeline = nullptr;
+    QAction*                                m_ActionFuseElementwiseFilters = nullptr;
+    QAction*                                m_ActionTiledExecution = nullptr;
+    QAction*                                m_ActionTiledSlabThickness = nullptr;
+    QAction*                                m_ActionThreadBudget = nullptr;
+    QAction*                                m_ActionAutoTuneThreads = nullptr;
+    QAction*                                m_ActionArrayPoolRetention = nullptr;
+    QAction*                                m_ActionArrayPoolHugePages = nullptr;
+    QAction*                                m_ActionPinThreadsToNumaNodes = nullptr;
+    QAction*                                m_ActionThreadProfiles = nullptr;
+    QAction*                                m_ActionRunAsBackgroundJob = nullptr;
+    int                                     m_TiledSlabThickness = 32;
+    QAction*                                m_ActionFilterHasSideEffects = nullptr;
+
+    QMenu*                                  m_MenuMemoryCheck = nullptr;
+    QActionGroup*                           m_MemoryCheckGroup = nullptr;
+    QAction*                                m_ActionMemoryBudget = nullptr;
+    QLabel*                                 m_MemoryEstimateLabel = nullptr;
+    MemoryEstimator::Policy                 m_MemoryPolicy = MemoryEstimator::Policy::Warn;
+    int                                     m_MemoryBudgetMB = 0;
+    QAction*                                m_ActionSpillToDisk = nullptr;
+    QAction*                                m_ActionCompressIdleArrays = nullptr;
+    int                                     m_CompressIdleFilters = 0;
+    QMenu*                                  m_MenuArrayMapping = nullptr;
+    QActionGroup*                           m_ArrayMappingGroup = nullptr;
+    MappedFileReader::Mode                  m_ArrayMapping = MappedFileReader::Mode::Off;
+    QAction*                                m_ActionParallelChunkedReads = nullptr;
+
+    QAction*                                m_ActionAsyncWrites = nullptr;
+    QAction*                                m_ActionPrefetchInputs = nullptr;
+    int                                     m_PrefetchDepth = 0;
+    QMenu*                                  m_MenuWriteProfile = nullptr;
+    QActionGroup*                           m_WriteProfileGroup = nullptr;
+    WriteProfile::Preset                    m_WriteProfile = WriteProfile::Preset::Default;
+    QMenu*                                  m_MenuWriterProfile = nullptr;
+    QActionGroup*                           m_WriterProfileGroup = nullptr;
+    QAction*                                m_ActionMeasureWriteProfiles = nullptr;
+    QAction*                                m_ActionIncrementalWrites = nullptr;
+    QAction*                                m_ActionKeepSnapshots = nullptr;
+    QAction*                                m_ActionClearSnapshots = nullptr;
+    std::shared_ptr<DataSnapshotStore>      m_SnapshotStore;
+
+    QAction*                                m_ActionPreviewMode = nullptr;
+    QAction*                                m_ActionPreviewReduction = nullptr;
+    PreviewReduction                        m_PreviewReduction;
+    QTimer*                                 m_PreviewTimer = nullptr;
+    bool                                    m_PreviewRunning = false;
+    bool                                    m_PreviewRestart = false;
+    bool                                    m_ExecuteAfterPreview = false;
+
+    PipelineExecutor*                       m_PipelineExecutor = nullptr;
+    QThread*                                m_PipelineExecutorThread = nullptr;
+
+    DataContainerArray::Pointer             m_LastResults;
+    SharedArrayPublisher                    m_SharedArrays;
 
     QActionGroup*                           m_ThemeActionGroup = nullptr;
 
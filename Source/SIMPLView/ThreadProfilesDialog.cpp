@@ -0,0 +1,140 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ThreadProfilesDialog.h"
+
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+#include <QtWidgets/QMessageBox>
+
+#include "Common/ThreadTuner.h"
+
+namespace
+{
+enum Column
+{
+  Filter = 0,
+  InputSize,
+  Threads,
+  Measured
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadProfilesDialog::ThreadProfilesDialog(QWidget* parent)
+: QDialog(parent)
+{
+  setupUi(this);
+  connect(closeBtn, &QPushButton::clicked, this, &QDialog::accept);
+  updateProfiles();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadProfilesDialog::~ThreadProfilesDialog() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadProfilesDialog::updateProfiles()
+{
+  ThreadTuner* tuner = ThreadTuner::Instance();
+  filePathLabel->setText(tr("Stored in %1").arg(tuner->getFilePath()));
+  enabledLabel->setText(tuner->isEnabled() ? tr("Auto-tuning is on") : tr("Auto-tuning is off, the profiles are not used"));
+
+  profileTree->clear();
+  QVector<ThreadTuner::Profile> profiles = tuner->getProfiles();
+  for(const ThreadTuner::Profile& profile : profiles)
+  {
+    int maxThreads = profile.measurements.isEmpty() ? 1 : profile.measurements.lastKey();
+    QStringList measured;
+    for(const ThreadTuner::Measurement& measurement : profile.measurements)
+    {
+      measured << tr("%1: %2 s/GB (%3x)").arg(measurement.threads).arg(measurement.msecsPerGigabyte() / 1000.0, 0, 'f', 2).arg(measurement.runs);
+    }
+
+    QTreeWidgetItem* item = new QTreeWidgetItem(profileTree);
+    item->setText(Filter, profile.filterClassName);
+    item->setText(InputSize, ThreadTuner::SizeBucketName(profile.sizeBucket));
+    item->setText(Threads, QString::number(tuner->select(profile.filterClassName, 1ULL << profile.sizeBucket, maxThreads)));
+    item->setText(Measured, measured.join("  "));
+    if(tuner->isExploring(profile.filterClassName, 1ULL << profile.sizeBucket, maxThreads))
+    {
+      item->setText(Threads, tr("%1 (exploring)").arg(item->text(Threads)));
+    }
+  }
+
+  for(int i = 0; i < profileTree->columnCount(); i++)
+  {
+    profileTree->resizeColumnToContents(i);
+  }
+  resetAllBtn->setEnabled(!profiles.isEmpty());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadProfilesDialog::on_resetSelectedBtn_clicked()
+{
+  QSet<QString> classNames;
+  QList<QTreeWidgetItem*> items = profileTree->selectedItems();
+  for(QTreeWidgetItem* item : items)
+  {
+    classNames.insert(item->text(Filter));
+  }
+
+  ThreadTuner* tuner = ThreadTuner::Instance();
+  for(const QString& className : classNames)
+  {
+    tuner->reset(className);
+  }
+  updateProfiles();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadProfilesDialog::on_resetAllBtn_clicked()
+{
+  if(QMessageBox::question(this, tr("Reset Thread Profiles"), tr("Forget every learned thread count?")) != QMessageBox::Yes)
+  {
+    return;
+  }
+  ThreadTuner::Instance()->reset();
+  updateProfiles();
+}
@@ -0,0 +1,200 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QCoreApplication>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "Common/ArrayLivenessAnalysis.h"
+#include "Common/ColumnarFileWriter.h"
+#include "Common/PipelineDataFlowGraph.h"
+
+#include "GenerateTestArray.h"
+#include "OffsetTestArray.h"
+#include "SIMPLViewTestFileLocations.h"
+
+class ArrayLivenessAnalysisTest
+{
+public:
+  ArrayLivenessAnalysisTest() = default;
+  ~ArrayLivenessAnalysisTest() = default;
+  ArrayLivenessAnalysisTest(const ArrayLivenessAnalysisTest&) = delete;            // Copy Constructor
+  ArrayLivenessAnalysisTest(ArrayLivenessAnalysisTest&&) = delete;                 // Move Constructor
+  ArrayLivenessAnalysisTest& operator=(const ArrayLivenessAnalysisTest&) = delete; // Copy Assignment
+  ArrayLivenessAnalysisTest& operator=(ArrayLivenessAnalysisTest&&) = delete;      // Move Assignment
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  DataArrayPath path(const QString& arrayName)
+  {
+    return DataArrayPath("A", "AttributeMatrix", arrayName);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  AbstractFilter::Pointer offset(const QString& inputName, const QString& outputName)
+  {
+    OffsetTestArray::Pointer filter = OffsetTestArray::New();
+    filter->setInputArrayPath(path(inputName));
+    filter->setOutputArrayName(outputName);
+    return filter;
+  }
+
+  // -----------------------------------------------------------------------------
+  // Data -> T1 -> T2 -> Final, with T3 created from Data and never read
+  // -----------------------------------------------------------------------------
+  PipelineDataFlowGraph createGraph(const AbstractFilter::Pointer& extra = AbstractFilter::Pointer())
+  {
+    GenerateTestArray::Pointer generate = GenerateTestArray::New();
+    generate->setDataContainerName("A");
+    generate->setNumberOfTuples(10);
+
+    FilterPipeline::Pointer pipeline = FilterPipeline::New();
+    pipeline->pushBack(generate);
+    pipeline->pushBack(offset("Data", "T1"));
+    pipeline->pushBack(offset("T1", "T2"));
+    pipeline->pushBack(offset("Data", "T3"));
+    if(extra.get() != nullptr)
+    {
+      pipeline->pushBack(extra);
+    }
+    pipeline->pushBack(offset("T2", "Final"));
+
+    PipelineDataFlowGraph graph(pipeline);
+    graph.resolveCreatedArrays();
+    return graph;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestLastUse()
+  {
+    PipelineDataFlowGraph graph = createGraph();
+    DREAM3D_REQUIRE(graph.isResolved())
+    ArrayLivenessAnalysis liveness(graph, QVector<DataArrayPath>());
+
+    DREAM3D_REQUIRE_EQUAL(liveness.trackedArrays().size(), 5)
+    DREAM3D_REQUIRE_EQUAL(liveness.lastUse(path("Data")), 3)
+    DREAM3D_REQUIRE_EQUAL(liveness.lastUse(path("T1")), 2)
+    DREAM3D_REQUIRE_EQUAL(liveness.lastUse(path("T2")), 4)
+    DREAM3D_REQUIRE_EQUAL(liveness.lastUse(path("T3")), 3)
+    DREAM3D_REQUIRE_EQUAL(liveness.lastUse(path("Final")), 4)
+    DREAM3D_REQUIRE_EQUAL(liveness.lastUse(path("Missing")), -1)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestReleaseSets()
+  {
+    ArrayLivenessAnalysis liveness(createGraph(), QVector<DataArrayPath>());
+
+    DREAM3D_REQUIRE(liveness.releasedAfter(0).isEmpty())
+    DREAM3D_REQUIRE(liveness.releasedAfter(1).isEmpty())
+    DREAM3D_REQUIRE(liveness.releasedAfter(2) == QVector<DataArrayPath>({path("T1")}))
+    DREAM3D_REQUIRE(liveness.releasedAfter(3) == QVector<DataArrayPath>({path("Data"), path("T3")}))
+
+    // Nothing is released after the final filter
+    DREAM3D_REQUIRE(liveness.releasedAfter(4).isEmpty())
+    DREAM3D_REQUIRE(!liveness.isKept(path("T2")))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestKeptArrays()
+  {
+    ArrayLivenessAnalysis kept(createGraph(), QVector<DataArrayPath>({path("T1")}));
+    DREAM3D_REQUIRE(kept.isKept(path("T1")))
+    DREAM3D_REQUIRE(kept.releasedAfter(2).isEmpty())
+    DREAM3D_REQUIRE(kept.releasedAfter(3) == QVector<DataArrayPath>({path("Data"), path("T3")}))
+
+    // Keeping an attribute matrix keeps every array inside it
+    ArrayLivenessAnalysis keptAm(createGraph(), QVector<DataArrayPath>({DataArrayPath("A", "AttributeMatrix", "")}));
+    for(int i = 0; i < 5; i++)
+    {
+      DREAM3D_REQUIRE(keptAm.releasedAfter(i).isEmpty())
+    }
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestWriterKeepsArrays()
+  {
+    DREAM3D_REQUIRE(!ArrayLivenessAnalysis::IsWriterFilter(OffsetTestArray::New()))
+
+    ColumnarFileWriter::Pointer writer = ColumnarFileWriter::New();
+    writer->setSelectedAttributeMatrixPath(DataArrayPath("A", "AttributeMatrix", ""));
+    writer->setOutputFile(UnitTest::ArrayLivenessAnalysisTest::OutputFile);
+    DREAM3D_REQUIRE(ArrayLivenessAnalysis::IsWriterFilter(writer))
+
+    // The writer reads the whole attribute matrix, so every array created before it is written and kept
+    PipelineDataFlowGraph graph = createGraph(writer);
+    DREAM3D_REQUIRE(graph.isResolved())
+    ArrayLivenessAnalysis liveness(graph, QVector<DataArrayPath>());
+    DREAM3D_REQUIRE_EQUAL(liveness.lastUse(path("T1")), 4)
+    DREAM3D_REQUIRE(liveness.isKept(path("Data")))
+    DREAM3D_REQUIRE(liveness.isKept(path("T1")))
+    DREAM3D_REQUIRE(liveness.isKept(path("T3")))
+    for(int i = 0; i < graph.size(); i++)
+    {
+      DREAM3D_REQUIRE(liveness.releasedAfter(i).isEmpty())
+    }
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestLastUse())
+    DREAM3D_REGISTER_TEST(TestReleaseSets())
+    DREAM3D_REGISTER_TEST(TestKeptArrays())
+    DREAM3D_REGISTER_TEST(TestWriterKeepsArrays())
+  }
+};
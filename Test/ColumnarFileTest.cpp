@@ -0,0 +1,256 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cstring>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataArrays/StringDataArray.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "Common/ColumnarFile.h"
+
+#include "SIMPLViewTestFileLocations.h"
+
+class ColumnarFileTest
+{
+public:
+  ColumnarFileTest() = default;
+  ~ColumnarFileTest() = default;
+  ColumnarFileTest(const ColumnarFileTest&) = delete;            // Copy Constructor
+  ColumnarFileTest(ColumnarFileTest&&) = delete;                 // Move Constructor
+  ColumnarFileTest& operator=(const ColumnarFileTest&) = delete; // Copy Assignment
+  ColumnarFileTest& operator=(ColumnarFileTest&&) = delete;      // Move Assignment
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    QFile::remove(UnitTest::ColumnarFileTest::TestFile);
+    QFile::remove(UnitTest::ColumnarFileTest::DamagedFile);
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  AttributeMatrix::Pointer createAttributeMatrix()
+  {
+    QVector<size_t> tDims = {4, 3, 2};
+    size_t numTuples = 24;
+    Int32ArrayType::Pointer ids = Int32ArrayType::CreateArray(numTuples, QVector<size_t>(1, 1), "FeatureIds", true);
+    FloatArrayType::Pointer eulers = FloatArrayType::CreateArray(numTuples, QVector<size_t>(1, 3), "Eulers", true);
+    UInt8ArrayType::Pointer mask = UInt8ArrayType::CreateArray(numTuples, QVector<size_t>(1, 1), "Mask", true);
+    for(size_t i = 0; i < numTuples; i++)
+    {
+      ids->setValue(i, static_cast<int32_t>(i * 3));
+      mask->setValue(i, static_cast<uint8_t>(i % 2));
+      for(size_t c = 0; c < 3; c++)
+      {
+        eulers->setComponent(i, c, static_cast<float>(i) + 0.5f * static_cast<float>(c));
+      }
+    }
+
+    AttributeMatrix::Pointer am = AttributeMatrix::New(tDims, "CellData", AttributeMatrix::Type::Cell);
+    am->addAttributeArray(ids->getName(), ids);
+    am->addAttributeArray(eulers->getName(), eulers);
+    am->addAttributeArray(mask->getName(), mask);
+    am->addAttributeArray("Names", StringDataArray::CreateArray(numTuples, "Names"));
+    return am;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T> int compareArrays(const AttributeMatrix::Pointer& expected, const AttributeMatrix::Pointer& actual, const QString& name)
+  {
+    typename DataArray<T>::Pointer expectedArray = std::dynamic_pointer_cast<DataArray<T>>(expected->getAttributeArray(name));
+    typename DataArray<T>::Pointer actualArray = std::dynamic_pointer_cast<DataArray<T>>(actual->getAttributeArray(name));
+    DREAM3D_REQUIRE_VALID_POINTER(actualArray.get())
+    DREAM3D_REQUIRE(actualArray->getComponentDimensions() == expectedArray->getComponentDimensions())
+    DREAM3D_REQUIRE_EQUAL(actualArray->getSize(), expectedArray->getSize())
+    DREAM3D_REQUIRE_EQUAL(std::memcmp(actualArray->getVoidPointer(0), expectedArray->getVoidPointer(0), expectedArray->getSize() * sizeof(T)), 0)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestRoundTrip()
+  {
+    QDir().mkpath(UnitTest::ColumnarFileTest::TestDir);
+    AttributeMatrix::Pointer am = createAttributeMatrix();
+
+    QStringList skipped;
+    QString errorMessage;
+    DREAM3D_REQUIRE(ColumnarFile::Write(am, "DataContainer", UnitTest::ColumnarFileTest::TestFile, &skipped, &errorMessage))
+    DREAM3D_REQUIRE(skipped == QStringList({"Names"}))
+
+    ColumnarFile file(UnitTest::ColumnarFileTest::TestFile);
+    DREAM3D_REQUIRE(file.isValid())
+    DREAM3D_REQUIRE(file.getDataContainerName() == "DataContainer")
+    DREAM3D_REQUIRE(file.getAttributeMatrixName() == "CellData")
+    DREAM3D_REQUIRE(file.getAttributeMatrixType() == AttributeMatrix::Type::Cell)
+    DREAM3D_REQUIRE(file.getTupleDimensions() == am->getTupleDimensions())
+    DREAM3D_REQUIRE_EQUAL(file.getNumberOfTuples(), 24)
+
+    QVector<ColumnarFile::Column> columns = file.getColumns();
+    DREAM3D_REQUIRE_EQUAL(columns.size(), 3)
+    for(const ColumnarFile::Column& column : columns)
+    {
+      DREAM3D_REQUIRE_EQUAL(column.offset % ColumnarFile::Alignment, 0)
+      DREAM3D_REQUIRE(column.typeName == am->getAttributeArray(column.name)->getTypeAsString())
+    }
+
+    // The prototype has every column but no values
+    AttributeMatrix::Pointer prototype = file.createPrototype("Prototype");
+    DREAM3D_REQUIRE_EQUAL(prototype->getAttributeArrayNames().size(), 3)
+    DREAM3D_REQUIRE(prototype->getAttributeArray("Eulers")->getComponentDimensions() == QVector<size_t>(1, 3))
+
+    for(bool copyOnWrite : {false, true})
+    {
+      AttributeMatrix::Pointer mapped = file.map("Mapped", copyOnWrite, &errorMessage);
+      DREAM3D_REQUIRE_VALID_POINTER(mapped.get())
+      DREAM3D_REQUIRE(mapped->getName() == "Mapped")
+      DREAM3D_REQUIRE(mapped->getTupleDimensions() == am->getTupleDimensions())
+      DREAM3D_REQUIRE_EQUAL(compareArrays<int32_t>(am, mapped, "FeatureIds"), EXIT_SUCCESS)
+      DREAM3D_REQUIRE_EQUAL(compareArrays<float>(am, mapped, "Eulers"), EXIT_SUCCESS)
+      DREAM3D_REQUIRE_EQUAL(compareArrays<uint8_t>(am, mapped, "Mask"), EXIT_SUCCESS)
+    }
+
+    // Writes to a copy-on-write mapping stay in memory
+    {
+      AttributeMatrix::Pointer mapped = file.map("Mapped", true);
+      std::dynamic_pointer_cast<Int32ArrayType>(mapped->getAttributeArray("FeatureIds"))->setValue(0, -1);
+    }
+    AttributeMatrix::Pointer remapped = file.map("Mapped", false);
+    DREAM3D_REQUIRE_EQUAL(std::dynamic_pointer_cast<Int32ArrayType>(remapped->getAttributeArray("FeatureIds"))->getValue(0), 0)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  // Copies the test file with 'bytes' written over it at 'offset', or cut to 'offset' bytes if 'bytes' is empty
+  // -----------------------------------------------------------------------------
+  bool damage(qint64 offset, const QByteArray& bytes)
+  {
+    QFile source(UnitTest::ColumnarFileTest::TestFile);
+    if(!source.open(QIODevice::ReadOnly))
+    {
+      return false;
+    }
+    QByteArray contents = source.readAll();
+    if(bytes.isEmpty())
+    {
+      contents.truncate(static_cast<int>(offset));
+    }
+    else
+    {
+      contents.replace(static_cast<int>(offset), bytes.size(), bytes);
+    }
+
+    QFile target(UnitTest::ColumnarFileTest::DamagedFile);
+    return target.open(QIODevice::WriteOnly | QIODevice::Truncate) && target.write(contents) == contents.size();
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T> QByteArray field(T value)
+  {
+    return QByteArray(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestDamagedFiles()
+  {
+    DREAM3D_REQUIRE(ColumnarFile::Write(createAttributeMatrix(), "DataContainer", UnitTest::ColumnarFileTest::TestFile))
+
+    // Wrong magic
+    DREAM3D_REQUIRE(damage(0, QByteArray("NOTCOLMN")))
+    DREAM3D_REQUIRE(!ColumnarFile(UnitTest::ColumnarFileTest::DamagedFile).isValid())
+
+    // Newer version
+    DREAM3D_REQUIRE(damage(8, field<quint32>(ColumnarFile::Version + 1)))
+    DREAM3D_REQUIRE(!ColumnarFile(UnitTest::ColumnarFileTest::DamagedFile).isValid())
+
+    // Other byte order
+    DREAM3D_REQUIRE(damage(52, field<quint32>(0x04030201)))
+    DREAM3D_REQUIRE(!ColumnarFile(UnitTest::ColumnarFileTest::DamagedFile).isValid())
+
+    // Footer beyond the end of the file
+    DREAM3D_REQUIRE(damage(24, field<quint64>(1ull << 40)))
+    ColumnarFile outside(UnitTest::ColumnarFileTest::DamagedFile);
+    DREAM3D_REQUIRE(!outside.isValid())
+    DREAM3D_REQUIRE(outside.getErrorMessage().contains("truncated or damaged"))
+
+    // Footer pointing at the first column, which is not JSON
+    DREAM3D_REQUIRE(damage(24, field<quint64>(ColumnarFile::Alignment)))
+    DREAM3D_REQUIRE(!ColumnarFile(UnitTest::ColumnarFileTest::DamagedFile).isValid())
+
+    // A header that records more tuples than the columns hold
+    DREAM3D_REQUIRE(damage(40, field<quint64>(25)))
+    DREAM3D_REQUIRE(!ColumnarFile(UnitTest::ColumnarFileTest::DamagedFile).isValid())
+
+    // Truncated
+    QFile file(UnitTest::ColumnarFileTest::TestFile);
+    DREAM3D_REQUIRE(damage(file.size() - 8, QByteArray()))
+    DREAM3D_REQUIRE(!ColumnarFile(UnitTest::ColumnarFileTest::DamagedFile).isValid())
+
+    // Missing
+    DREAM3D_REQUIRE(!ColumnarFile(UnitTest::ColumnarFileTest::TestDir + "/Missing." + ColumnarFile::Extension).isValid())
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestRoundTrip())
+    DREAM3D_REGISTER_TEST(TestDamagedFiles())
+    DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  }
+};
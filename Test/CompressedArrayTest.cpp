@@ -0,0 +1,197 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cstring>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+
+#include "UnitTestSupport.hpp"
+
+#include "Common/CompressedArray.h"
+
+class CompressedArrayTest
+{
+public:
+  CompressedArrayTest() = default;
+  ~CompressedArrayTest() = default;
+  CompressedArrayTest(const CompressedArrayTest&) = delete;            // Copy Constructor
+  CompressedArrayTest(CompressedArrayTest&&) = delete;                 // Move Constructor
+  CompressedArrayTest& operator=(const CompressedArrayTest&) = delete; // Copy Assignment
+  CompressedArrayTest& operator=(CompressedArrayTest&&) = delete;      // Move Assignment
+
+  const size_t k_BlockBytes = 4096;
+  const size_t k_BlockElements = k_BlockBytes / sizeof(int32_t);
+
+  // -----------------------------------------------------------------------------
+  // Three constant blocks, three counting blocks and random values in the rest, so every codec is used
+  // -----------------------------------------------------------------------------
+  Int32ArrayType::Pointer createArray()
+  {
+    size_t numTuples = 10 * k_BlockElements + 100;
+    Int32ArrayType::Pointer array = Int32ArrayType::CreateArray(numTuples, QVector<size_t>(1, 1), "Data", true);
+    uint32_t state = 2463534242u;
+    for(size_t i = 0; i < numTuples; i++)
+    {
+      if(i < 3 * k_BlockElements)
+      {
+        array->setValue(i, 7);
+      }
+      else if(i < 6 * k_BlockElements)
+      {
+        array->setValue(i, static_cast<int32_t>(i));
+      }
+      else
+      {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        array->setValue(i, static_cast<int32_t>(state));
+      }
+    }
+    return array;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestCodecs()
+  {
+    Int32ArrayType::Pointer array = createArray();
+    CompressedArray::Pointer compressed = CompressedArray::Compress(array, k_BlockBytes);
+    DREAM3D_REQUIRE_VALID_POINTER(compressed.get())
+
+    DREAM3D_REQUIRE_EQUAL(compressed->getBytes(), array->getSize() * sizeof(int32_t))
+    DREAM3D_REQUIRE_EQUAL(compressed->getBlockBytes(), k_BlockBytes)
+    DREAM3D_REQUIRE_EQUAL(compressed->getBlockCount(), 11)
+    DREAM3D_REQUIRE(compressed->getCodec(0) == CompressedArray::Codec::RunLength)
+    DREAM3D_REQUIRE(compressed->getCodec(4) == CompressedArray::Codec::Deflate)
+    DREAM3D_REQUIRE(compressed->getCodec(8) == CompressedArray::Codec::Raw)
+    DREAM3D_REQUIRE(compressed->getCompressedBytes() < compressed->getBytes())
+    DREAM3D_REQUIRE(compressed->getRatio() > 1.0)
+
+    // Arrays without values cannot be compressed
+    DREAM3D_REQUIRE_NULL_POINTER(CompressedArray::Compress(Int32ArrayType::CreateArray(10, QVector<size_t>(1, 1), "Empty", false)).get())
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestRoundTrip()
+  {
+    Int32ArrayType::Pointer array = createArray();
+    CompressedArray::Pointer compressed = CompressedArray::Compress(array, k_BlockBytes);
+    DREAM3D_REQUIRE(compressed->matches(array))
+
+    IDataArray::Pointer prototype = compressed->getPrototype();
+    DREAM3D_REQUIRE(prototype->getName() == array->getName())
+    DREAM3D_REQUIRE(prototype->getTypeAsString() == array->getTypeAsString())
+    DREAM3D_REQUIRE_EQUAL(prototype->getNumberOfTuples(), array->getNumberOfTuples())
+
+    Int32ArrayType::Pointer decompressed = std::dynamic_pointer_cast<Int32ArrayType>(compressed->decompress());
+    DREAM3D_REQUIRE_VALID_POINTER(decompressed.get())
+    DREAM3D_REQUIRE_EQUAL(decompressed->getNumberOfTuples(), array->getNumberOfTuples())
+    DREAM3D_REQUIRE_EQUAL(std::memcmp(decompressed->getVoidPointer(0), array->getVoidPointer(0), compressed->getBytes()), 0)
+
+    // Blocks are visited in order and cover the whole array
+    size_t visited = 0;
+    const char* source = reinterpret_cast<const char*>(array->getVoidPointer(0));
+    bool same = true;
+    compressed->forEachBlock([&](const char* data, size_t bytes) {
+      same = same && std::memcmp(data, source + visited, bytes) == 0;
+      visited += bytes;
+      return true;
+    });
+    DREAM3D_REQUIRE(same)
+    DREAM3D_REQUIRE_EQUAL(visited, compressed->getBytes())
+
+    // A changed value no longer matches
+    array->setValue(5, 8);
+    DREAM3D_REQUIRE(!compressed->matches(array))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestRead()
+  {
+    Int32ArrayType::Pointer array = createArray();
+    CompressedArray::Pointer compressed = CompressedArray::Compress(array, k_BlockBytes);
+    compressed->setCacheBlocks(2);
+    DREAM3D_REQUIRE_EQUAL(compressed->getCacheBlocks(), 2)
+
+    // Across the boundary between the constant and the counting blocks
+    size_t first = 3 * k_BlockElements - 4;
+    std::vector<int32_t> values(8, 0);
+    DREAM3D_REQUIRE(compressed->read(first * sizeof(int32_t), values.size() * sizeof(int32_t), values.data()))
+    for(size_t i = 0; i < values.size(); i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(values[i], array->getValue(first + i))
+    }
+    DREAM3D_REQUIRE_EQUAL(compressed->getCacheMisses(), 2)
+
+    // The same blocks again come from the cache
+    DREAM3D_REQUIRE(compressed->read(first * sizeof(int32_t), values.size() * sizeof(int32_t), values.data()))
+    DREAM3D_REQUIRE_EQUAL(compressed->getCacheMisses(), 2)
+    DREAM3D_REQUIRE(compressed->getCacheHits() >= 2)
+
+    // The last, partial block
+    int32_t last = 0;
+    DREAM3D_REQUIRE(compressed->read(compressed->getBytes() - sizeof(int32_t), sizeof(int32_t), &last))
+    DREAM3D_REQUIRE_EQUAL(last, array->getValue(array->getNumberOfTuples() - 1))
+    DREAM3D_REQUIRE_EQUAL(static_cast<size_t>(compressed->block(10).size()), 100 * sizeof(int32_t))
+
+    // Outside the array
+    DREAM3D_REQUIRE(!compressed->read(compressed->getBytes() - 2, 4, &last))
+    DREAM3D_REQUIRE(!compressed->read(compressed->getBytes() + 4, 4, &last))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestCodecs())
+    DREAM3D_REGISTER_TEST(TestRoundTrip())
+    DREAM3D_REGISTER_TEST(TestRead())
+  }
+};
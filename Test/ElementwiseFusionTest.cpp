@@ -0,0 +1,229 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QCoreApplication>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/CoreFilters/ConditionalSetValue.h"
+#include "SIMPLib/CoreFilters/ReplaceValueInArray.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "Common/ElementwiseFusion.h"
+#include "Common/ElementwiseKernel.h"
+
+class ElementwiseFusionTest
+{
+public:
+  ElementwiseFusionTest() = default;
+  ~ElementwiseFusionTest() = default;
+  ElementwiseFusionTest(const ElementwiseFusionTest&) = delete;            // Copy Constructor
+  ElementwiseFusionTest(ElementwiseFusionTest&&) = delete;                 // Move Constructor
+  ElementwiseFusionTest& operator=(const ElementwiseFusionTest&) = delete; // Copy Assignment
+  ElementwiseFusionTest& operator=(ElementwiseFusionTest&&) = delete;      // Move Assignment
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  DataArrayPath path(const QString& arrayName)
+  {
+    return DataArrayPath("DataContainer", "AttributeMatrix", arrayName);
+  }
+
+  // -----------------------------------------------------------------------------
+  // A few blocks and a partial one, so every block boundary is crossed
+  // -----------------------------------------------------------------------------
+  DataContainerArray::Pointer createData()
+  {
+    size_t numTuples = 3 * ElementwiseFusion::BlockSize + 17;
+    QVector<size_t> cDims(1, 1);
+    FloatArrayType::Pointer floats = FloatArrayType::CreateArray(numTuples, cDims, "Floats", true);
+    Int32ArrayType::Pointer ints = Int32ArrayType::CreateArray(numTuples, cDims, "Ints", true);
+    BoolArrayType::Pointer mask = BoolArrayType::CreateArray(numTuples, cDims, "Mask", true);
+    for(size_t i = 0; i < numTuples; i++)
+    {
+      floats->setValue(i, static_cast<float>(i % 7) + 0.25f);
+      ints->setValue(i, static_cast<int32_t>(i % 11));
+      mask->setValue(i, i % 5 == 0);
+    }
+
+    AttributeMatrix::Pointer am = AttributeMatrix::New(QVector<size_t>(1, numTuples), "AttributeMatrix", AttributeMatrix::Type::Cell);
+    am->addAttributeArray(floats->getName(), floats);
+    am->addAttributeArray(ints->getName(), ints);
+    am->addAttributeArray(mask->getName(), mask);
+    DataContainer::Pointer dc = DataContainer::New("DataContainer");
+    dc->addAttributeMatrix(am->getName(), am);
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    dca->addDataContainer(dc);
+    return dca;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  AbstractFilter::Pointer replaceValue(const QString& arrayName, double removeValue, double replaceValue)
+  {
+    ReplaceValueInArray::Pointer filter = ReplaceValueInArray::New();
+    filter->setSelectedArray(path(arrayName));
+    filter->setRemoveValue(removeValue);
+    filter->setReplaceValue(replaceValue);
+    return filter;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  AbstractFilter::Pointer conditionalSetValue(const QString& arrayName, double replaceValue)
+  {
+    ConditionalSetValue::Pointer filter = ConditionalSetValue::New();
+    filter->setSelectedArrayPath(path(arrayName));
+    filter->setConditionalArrayPath(path("Mask"));
+    filter->setReplaceValue(replaceValue);
+    return filter;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  QVector<AbstractFilter::Pointer> createFilters()
+  {
+    QVector<AbstractFilter::Pointer> filters;
+    filters.push_back(replaceValue("Floats", 3.25, -1.0));
+    filters.push_back(conditionalSetValue("Floats", 42.5));
+    filters.push_back(replaceValue("Floats", -1.0, 0.5));
+    filters.push_back(replaceValue("Ints", 3.0, -1.0));
+    filters.push_back(conditionalSetValue("Ints", 42.0));
+    return filters;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T> int compareArrays(const DataContainerArray::Pointer& expected, const DataContainerArray::Pointer& actual, const QString& arrayName)
+  {
+    typename DataArray<T>::Pointer expectedArray = std::dynamic_pointer_cast<DataArray<T>>(expected->getAttributeMatrix(path(arrayName))->getAttributeArray(arrayName));
+    typename DataArray<T>::Pointer actualArray = std::dynamic_pointer_cast<DataArray<T>>(actual->getAttributeMatrix(path(arrayName))->getAttributeArray(arrayName));
+    DREAM3D_REQUIRE_VALID_POINTER(expectedArray.get())
+    DREAM3D_REQUIRE_VALID_POINTER(actualArray.get())
+    DREAM3D_REQUIRE_EQUAL(expectedArray->getNumberOfTuples(), actualArray->getNumberOfTuples())
+    for(size_t i = 0; i < expectedArray->getNumberOfTuples(); i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(expectedArray->getValue(i), actualArray->getValue(i))
+    }
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestKernelsAreRegistered()
+  {
+    for(const AbstractFilter::Pointer& filter : createFilters())
+    {
+      DREAM3D_REQUIRE_VALID_POINTER(ElementwiseKernel::ForFilter(filter).get())
+    }
+
+    // Missing parameters give no kernel
+    DREAM3D_REQUIRE_NULL_POINTER(ElementwiseKernel::ForFilter(ReplaceValueInArray::New()).get())
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestFusedMatchesFilters()
+  {
+    QVector<AbstractFilter::Pointer> filters = createFilters();
+
+    DataContainerArray::Pointer expected = createData();
+    for(const AbstractFilter::Pointer& filter : filters)
+    {
+      filter->setDataContainerArray(expected);
+      filter->execute();
+      DREAM3D_REQUIRED(filter->getErrorCondition(), >=, 0)
+    }
+
+    QVector<ElementwiseKernel::Pointer> kernels;
+    for(const AbstractFilter::Pointer& filter : filters)
+    {
+      kernels.push_back(ElementwiseKernel::ForFilter(filter));
+    }
+    DataContainerArray::Pointer fused = createData();
+    ElementwiseFusion fusion(kernels, QVector<DataArrayPath>());
+    DREAM3D_REQUIRE(fusion.execute(fused))
+    DREAM3D_REQUIRE_EQUAL(fusion.getElementCount(), 3 * ElementwiseFusion::BlockSize + 17)
+
+    DREAM3D_REQUIRE_EQUAL(compareArrays<float>(expected, fused, "Floats"), EXIT_SUCCESS)
+    DREAM3D_REQUIRE_EQUAL(compareArrays<int32_t>(expected, fused, "Ints"), EXIT_SUCCESS)
+    DREAM3D_REQUIRE_EQUAL(compareArrays<bool>(expected, fused, "Mask"), EXIT_SUCCESS)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestRejectedRunLeavesData()
+  {
+    DataContainerArray::Pointer dca = createData();
+    AttributeMatrix::Pointer am = dca->getAttributeMatrix(path("Mask"));
+    am->addAttributeArray("Short", FloatArrayType::CreateArray(10, QVector<size_t>(1, 1), "Short", true));
+
+    QVector<ElementwiseKernel::Pointer> kernels;
+    kernels.push_back(ElementwiseKernel::ForFilter(replaceValue("Floats", 3.25, -1.0)));
+    kernels.push_back(ElementwiseKernel::ForFilter(replaceValue("Short", 0.0, 1.0)));
+    ElementwiseFusion fusion(kernels, QVector<DataArrayPath>());
+    DREAM3D_REQUIRE(!fusion.execute(dca))
+    DREAM3D_REQUIRE(!fusion.getErrorMessage().isEmpty())
+
+    // Validation happens before anything is written
+    DREAM3D_REQUIRE_EQUAL(compareArrays<float>(createData(), dca, "Floats"), EXIT_SUCCESS)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestKernelsAreRegistered())
+    DREAM3D_REGISTER_TEST(TestFusedMatchesFilters())
+    DREAM3D_REGISTER_TEST(TestRejectedRunLeavesData())
+  }
+};
@@ -0,0 +1,222 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "GenerateTestArray.h"
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/FilterParameters/DataContainerCreationFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
+#include "SIMPLib/FilterParameters/StringFilterParameter.h"
+#include "SIMPLib/SIMPLibVersion.h"
+
+namespace
+{
+const int k_GenerateError = -9490;
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+GenerateTestArray::GenerateTestArray()
+: m_DataContainerName("")
+, m_AttributeMatrixName("AttributeMatrix")
+, m_ArrayName("Data")
+, m_NumberOfTuples(100)
+{
+  initialize();
+  setupFilterParameters();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+GenerateTestArray::~GenerateTestArray() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void GenerateTestArray::initialize()
+{
+  setErrorCondition(0);
+  setWarningCondition(0);
+  setCancel(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void GenerateTestArray::setupFilterParameters()
+{
+  FilterParameterVector parameters;
+  parameters.push_back(SIMPL_NEW_DC_CREATION_FP("Data Container", DataContainerName, FilterParameter::CreatedArray, GenerateTestArray));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Attribute Matrix", AttributeMatrixName, FilterParameter::CreatedArray, GenerateTestArray));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Array", ArrayName, FilterParameter::CreatedArray, GenerateTestArray));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Number of Tuples", NumberOfTuples, FilterParameter::Parameter, GenerateTestArray));
+  setFilterParameters(parameters);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void GenerateTestArray::dataCheck()
+{
+  setErrorCondition(0);
+  setWarningCondition(0);
+
+  if(getAttributeMatrixName().isEmpty() || getArrayName().isEmpty() || getNumberOfTuples() <= 0)
+  {
+    setErrorCondition(k_GenerateError);
+    notifyErrorMessage(getHumanLabel(), QObject::tr("The attribute matrix, the array and a positive number of tuples must be set"), getErrorCondition());
+    return;
+  }
+
+  DataContainer::Pointer dc = getDataContainerArray()->createNonPrereqDataContainer<AbstractFilter>(this, getDataContainerName());
+  if(getErrorCondition() < 0 || dc.get() == nullptr)
+  {
+    return;
+  }
+
+  size_t numTuples = static_cast<size_t>(getNumberOfTuples());
+  AttributeMatrix::Pointer am = AttributeMatrix::New(QVector<size_t>(1, numTuples), getAttributeMatrixName(), AttributeMatrix::Type::Cell);
+  am->addAttributeArray(getArrayName(), FloatArrayType::CreateArray(numTuples, QVector<size_t>(1, 1), getArrayName(), !getInPreflight()));
+  dc->addAttributeMatrix(getAttributeMatrixName(), am);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void GenerateTestArray::preflight()
+{
+  setInPreflight(true);
+  emit preflightAboutToExecute();
+  emit updateFilterParameters(this);
+  dataCheck();
+  emit preflightExecuted();
+  setInPreflight(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void GenerateTestArray::execute()
+{
+  initialize();
+  dataCheck();
+  if(getErrorCondition() < 0)
+  {
+    return;
+  }
+
+  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(DataArrayPath(getDataContainerName(), getAttributeMatrixName(), ""));
+  FloatArrayType::Pointer array = std::dynamic_pointer_cast<FloatArrayType>(am->getAttributeArray(getArrayName()));
+  for(size_t i = 0; i < array->getNumberOfTuples(); i++)
+  {
+    array->setValue(i, static_cast<float>(i));
+  }
+
+  notifyStatusMessage(getHumanLabel(), "Complete");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer GenerateTestArray::newFilterInstance(bool copyFilterParameters) const
+{
+  GenerateTestArray::Pointer filter = GenerateTestArray::New();
+  if(copyFilterParameters)
+  {
+    copyFilterParameterInstanceVariables(filter.get());
+  }
+  return filter;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString GenerateTestArray::getCompiledLibraryName() const
+{
+  return "SIMPLView";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString GenerateTestArray::getBrandingString() const
+{
+  return "SIMPLView";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString GenerateTestArray::getFilterVersion() const
+{
+  return SIMPLib::Version::Complete();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString GenerateTestArray::getGroupName() const
+{
+  return SIMPL::FilterGroups::CoreFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString GenerateTestArray::getSubGroupName() const
+{
+  return SIMPL::FilterSubGroups::GenerationFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString GenerateTestArray::getHumanLabel() const
+{
+  return "Generate Test Array";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QUuid GenerateTestArray::getUuid()
+{
+  return QUuid("{3b7c2e91-5d4f-5a08-9c6e-1f2a3b4c5d6e}");
+}
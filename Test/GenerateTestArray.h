@@ -0,0 +1,107 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The GenerateTestArray class is a filter for the unit tests. It adds a Data Container holding a cell
+ * attribute matrix with one float array whose value i is i. Like most filters it names the attribute matrix
+ * and the array it creates with plain strings.
+ */
+class GenerateTestArray : public AbstractFilter
+{
+  Q_OBJECT
+
+public:
+  SIMPL_SHARED_POINTERS(GenerateTestArray)
+  SIMPL_FILTER_NEW_MACRO(GenerateTestArray)
+  SIMPL_TYPE_MACRO_SUPER(GenerateTestArray, AbstractFilter)
+
+  ~GenerateTestArray() override;
+
+  SIMPL_FILTER_PARAMETER(QString, DataContainerName)
+  Q_PROPERTY(QString DataContainerName READ getDataContainerName WRITE setDataContainerName)
+
+  SIMPL_FILTER_PARAMETER(QString, AttributeMatrixName)
+  Q_PROPERTY(QString AttributeMatrixName READ getAttributeMatrixName WRITE setAttributeMatrixName)
+
+  SIMPL_FILTER_PARAMETER(QString, ArrayName)
+  Q_PROPERTY(QString ArrayName READ getArrayName WRITE setArrayName)
+
+  SIMPL_FILTER_PARAMETER(int, NumberOfTuples)
+  Q_PROPERTY(int NumberOfTuples READ getNumberOfTuples WRITE setNumberOfTuples)
+
+  const QString getCompiledLibraryName() const override;
+  const QString getBrandingString() const override;
+  const QString getFilterVersion() const override;
+  AbstractFilter::Pointer newFilterInstance(bool copyFilterParameters) const override;
+  const QString getGroupName() const override;
+  const QString getSubGroupName() const override;
+  const QUuid getUuid() override;
+  const QString getHumanLabel() const override;
+  void setupFilterParameters() override;
+  void execute() override;
+  void preflight() override;
+
+signals:
+  void updateFilterParameters(AbstractFilter* filter);
+  void parametersChanged();
+  void preflightAboutToExecute();
+  void preflightExecuted();
+
+protected:
+  GenerateTestArray();
+
+  /**
+   * @brief dataCheck Adds the Data Container, the attribute matrix and the array, which is only allocated
+   * outside of a preflight
+   */
+  void dataCheck();
+
+  /**
+   * @brief Initializes all the private instance variables.
+   */
+  void initialize();
+
+public:
+  GenerateTestArray(const GenerateTestArray&) = delete;            // Copy Constructor Not Implemented
+  GenerateTestArray& operator=(const GenerateTestArray&) = delete; // Copy Assignment Not Implemented
+  GenerateTestArray(GenerateTestArray&&) = delete;                 // Move Constructor Not Implemented
+  GenerateTestArray& operator=(GenerateTestArray&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,236 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QVector>
+
+#include "H5Support/QH5Lite.h"
+#include "H5Support/QH5Utilities.h"
+
+#include "SIMPLib/SIMPLib.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "Common/IncrementalFileWriter.h"
+#include "Common/WriteProfile.h"
+
+#include "SIMPLViewTestFileLocations.h"
+
+class IncrementalFileWriterTest
+{
+public:
+  IncrementalFileWriterTest() = default;
+  ~IncrementalFileWriterTest() = default;
+  IncrementalFileWriterTest(const IncrementalFileWriterTest&) = delete;            // Copy Constructor
+  IncrementalFileWriterTest(IncrementalFileWriterTest&&) = delete;                 // Move Constructor
+  IncrementalFileWriterTest& operator=(const IncrementalFileWriterTest&) = delete; // Copy Assignment
+  IncrementalFileWriterTest& operator=(IncrementalFileWriterTest&&) = delete;      // Move Assignment
+
+  // Above IncrementalFileWriter::SmallDatasetBytes, so these are hashed instead of compared byte by byte
+  const size_t k_LargeElements = 32768;
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    QFile::remove(UnitTest::IncrementalFileWriterTest::StagingFile);
+    QFile::remove(UnitTest::IncrementalFileWriterTest::TargetFile);
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T> QVector<T> counting(size_t count)
+  {
+    QVector<T> values(static_cast<int>(count));
+    for(int i = 0; i < values.size(); i++)
+    {
+      values[i] = static_cast<T>(i);
+    }
+    return values;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T> bool writeDataset(hid_t locId, const QString& name, QVector<T> values)
+  {
+    QVector<hsize_t> dims(1, static_cast<hsize_t>(values.size()));
+    return QH5Lite::writeVectorDataset(locId, name, dims, values) >= 0;
+  }
+
+  // -----------------------------------------------------------------------------
+  // The output file of an earlier run and the staging file of the next one. Small, Large and Group/Kept
+  // are the same in both, Changed differs in one value, Resized has more values, Stale is only in the
+  // output file and New only in the staging file.
+  // -----------------------------------------------------------------------------
+  bool createFile(const QString& filePath, bool staging)
+  {
+    hid_t fileId = QH5Utilities::createFile(filePath);
+    if(fileId < 0)
+    {
+      return false;
+    }
+
+    QVector<float> changed = counting<float>(k_LargeElements);
+    if(staging)
+    {
+      changed[1000] = -1.0f;
+    }
+
+    bool ok = writeDataset(fileId, "Small", counting<int32_t>(100));
+    ok = ok && writeDataset(fileId, "Large", counting<float>(k_LargeElements));
+    ok = ok && writeDataset(fileId, "Changed", changed);
+    ok = ok && writeDataset(fileId, "Resized", counting<int32_t>(staging ? 20 : 10));
+    ok = ok && writeDataset(fileId, staging ? "New" : "Stale", counting<int32_t>(5));
+
+    hid_t groupId = QH5Utilities::createGroup(fileId, "Group");
+    ok = ok && groupId >= 0 && writeDataset(groupId, "Kept", counting<int32_t>(10));
+    if(groupId >= 0)
+    {
+      QH5Utilities::closeHDF5Object(groupId);
+    }
+    QH5Utilities::closeFile(fileId);
+    return ok;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestMerge()
+  {
+    QDir().mkpath(UnitTest::IncrementalFileWriterTest::TestDir);
+    DREAM3D_REQUIRE(createFile(UnitTest::IncrementalFileWriterTest::TargetFile, false))
+    DREAM3D_REQUIRE(createFile(UnitTest::IncrementalFileWriterTest::StagingFile, true))
+
+    IncrementalFileWriter::MergeStats stats;
+    QString errorMessage;
+    DREAM3D_REQUIRE(IncrementalFileWriter::Merge(UnitTest::IncrementalFileWriterTest::StagingFile, UnitTest::IncrementalFileWriterTest::TargetFile, WriteProfile(), &stats, &errorMessage))
+
+    // Small, Large and Group/Kept are kept; Changed, Resized and New are written; Stale is removed
+    DREAM3D_REQUIRE_EQUAL(stats.datasets, 6)
+    DREAM3D_REQUIRE_EQUAL(stats.rewrittenDatasets, 3)
+    DREAM3D_REQUIRE_EQUAL(stats.removedObjects, 1)
+    DREAM3D_REQUIRE_EQUAL(stats.keptBytes, 100 * sizeof(int32_t) + k_LargeElements * sizeof(float) + 10 * sizeof(int32_t))
+    DREAM3D_REQUIRE_EQUAL(stats.rewrittenBytes, k_LargeElements * sizeof(float) + 20 * sizeof(int32_t) + 5 * sizeof(int32_t))
+    DREAM3D_REQUIRE(!stats.compacted)
+
+    hid_t fileId = QH5Utilities::openFile(UnitTest::IncrementalFileWriterTest::TargetFile, true);
+    DREAM3D_REQUIRE(fileId >= 0)
+    QVector<float> changed;
+    QVector<int32_t> resized;
+    QVector<int32_t> added;
+    QVector<int32_t> kept;
+    bool read = QH5Lite::readVectorDataset(fileId, "Changed", changed) >= 0 && QH5Lite::readVectorDataset(fileId, "Resized", resized) >= 0 &&
+                QH5Lite::readVectorDataset(fileId, "New", added) >= 0 && QH5Lite::readVectorDataset(fileId, "Group/Kept", kept) >= 0;
+    bool stale = H5Lexists(fileId, "Stale", H5P_DEFAULT) > 0;
+    QH5Utilities::closeFile(fileId);
+
+    DREAM3D_REQUIRE(read)
+    DREAM3D_REQUIRE(!stale)
+    DREAM3D_REQUIRE_EQUAL(static_cast<size_t>(changed.size()), k_LargeElements)
+    DREAM3D_REQUIRE_EQUAL(changed[1000], -1.0f)
+    DREAM3D_REQUIRE_EQUAL(changed[1001], 1001.0f)
+    DREAM3D_REQUIRE(resized == counting<int32_t>(20))
+    DREAM3D_REQUIRE(added == counting<int32_t>(5))
+    DREAM3D_REQUIRE(kept == counting<int32_t>(10))
+
+    // Merging the same staging file again changes nothing
+    DREAM3D_REQUIRE(IncrementalFileWriter::Merge(UnitTest::IncrementalFileWriterTest::StagingFile, UnitTest::IncrementalFileWriterTest::TargetFile, WriteProfile(), &stats, &errorMessage))
+    DREAM3D_REQUIRE_EQUAL(stats.datasets, 6)
+    DREAM3D_REQUIRE_EQUAL(stats.rewrittenDatasets, 0)
+    DREAM3D_REQUIRE_EQUAL(stats.removedObjects, 0)
+    DREAM3D_REQUIRE_EQUAL(stats.rewrittenBytes, 0)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  // A large dataset changed in the output file by another tool is noticed, since the output is always hashed
+  // -----------------------------------------------------------------------------
+  int TestChangedOutput()
+  {
+    hid_t fileId = QH5Utilities::openFile(UnitTest::IncrementalFileWriterTest::TargetFile, false);
+    DREAM3D_REQUIRE(fileId >= 0)
+    QVector<float> large = counting<float>(k_LargeElements);
+    large[0] = 7.0f;
+    herr_t err = H5Ldelete(fileId, "Large", H5P_DEFAULT);
+    bool written = err >= 0 && writeDataset(fileId, "Large", large);
+    QH5Utilities::closeFile(fileId);
+    DREAM3D_REQUIRE(written)
+
+    IncrementalFileWriter::MergeStats stats;
+    DREAM3D_REQUIRE(IncrementalFileWriter::Merge(UnitTest::IncrementalFileWriterTest::StagingFile, UnitTest::IncrementalFileWriterTest::TargetFile, WriteProfile(), &stats))
+    DREAM3D_REQUIRE_EQUAL(stats.rewrittenDatasets, 1)
+    DREAM3D_REQUIRE_EQUAL(stats.rewrittenBytes, k_LargeElements * sizeof(float))
+
+    fileId = QH5Utilities::openFile(UnitTest::IncrementalFileWriterTest::TargetFile, true);
+    DREAM3D_REQUIRE(fileId >= 0)
+    large.clear();
+    err = QH5Lite::readVectorDataset(fileId, "Large", large);
+    QH5Utilities::closeFile(fileId);
+    DREAM3D_REQUIRE(err >= 0)
+    DREAM3D_REQUIRE(large == counting<float>(k_LargeElements))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestMissingFile()
+  {
+    QString errorMessage;
+    QString missing = UnitTest::IncrementalFileWriterTest::TestDir + "/Missing.h5";
+    DREAM3D_REQUIRE(!IncrementalFileWriter::Merge(missing, UnitTest::IncrementalFileWriterTest::TargetFile, WriteProfile(), nullptr, &errorMessage))
+    DREAM3D_REQUIRE(errorMessage.contains(missing))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestMerge())
+    DREAM3D_REGISTER_TEST(TestChangedOutput())
+    DREAM3D_REGISTER_TEST(TestMissingFile())
+    DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  }
+};
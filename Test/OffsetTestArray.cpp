@@ -0,0 +1,222 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "OffsetTestArray.h"
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/DoubleFilterParameter.h"
+#include "SIMPLib/FilterParameters/StringFilterParameter.h"
+#include "SIMPLib/Geometry/IGeometry.h"
+#include "SIMPLib/SIMPLibVersion.h"
+
+namespace
+{
+const int k_OffsetError = -9491;
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+OffsetTestArray::OffsetTestArray()
+: m_InputArrayPath("", "", "")
+, m_OutputArrayName("")
+, m_Offset(1.0)
+{
+  initialize();
+  setupFilterParameters();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+OffsetTestArray::~OffsetTestArray() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void OffsetTestArray::initialize()
+{
+  setErrorCondition(0);
+  setWarningCondition(0);
+  setCancel(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void OffsetTestArray::setupFilterParameters()
+{
+  FilterParameterVector parameters;
+  DataArraySelectionFilterParameter::RequirementType requirement =
+      DataArraySelectionFilterParameter::CreateRequirement(SIMPL::TypeNames::Float, 1, AttributeMatrix::Type::Any, IGeometry::Type::Any);
+  parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Input Array", InputArrayPath, FilterParameter::RequiredArray, OffsetTestArray, requirement));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Output Array", OutputArrayName, FilterParameter::CreatedArray, OffsetTestArray));
+  parameters.push_back(SIMPL_NEW_DOUBLE_FP("Offset", Offset, FilterParameter::Parameter, OffsetTestArray));
+  setFilterParameters(parameters);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void OffsetTestArray::dataCheck()
+{
+  setErrorCondition(0);
+  setWarningCondition(0);
+
+  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(getInputArrayPath());
+  if(am.get() == nullptr || std::dynamic_pointer_cast<FloatArrayType>(am->getAttributeArray(getInputArrayPath().getDataArrayName())).get() == nullptr)
+  {
+    setErrorCondition(k_OffsetError);
+    notifyErrorMessage(getHumanLabel(), QObject::tr("The input array '%1' is not a float array").arg(getInputArrayPath().serialize("/")), getErrorCondition());
+    return;
+  }
+  if(getOutputArrayName().isEmpty() || am->getAttributeArray(getOutputArrayName()).get() != nullptr)
+  {
+    setErrorCondition(k_OffsetError);
+    notifyErrorMessage(getHumanLabel(), QObject::tr("The output array must be set to an array that does not exist yet"), getErrorCondition());
+    return;
+  }
+
+  am->addAttributeArray(getOutputArrayName(), FloatArrayType::CreateArray(am->getNumberOfTuples(), QVector<size_t>(1, 1), getOutputArrayName(), !getInPreflight()));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void OffsetTestArray::preflight()
+{
+  setInPreflight(true);
+  emit preflightAboutToExecute();
+  emit updateFilterParameters(this);
+  dataCheck();
+  emit preflightExecuted();
+  setInPreflight(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void OffsetTestArray::execute()
+{
+  initialize();
+  dataCheck();
+  if(getErrorCondition() < 0)
+  {
+    return;
+  }
+
+  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(getInputArrayPath());
+  FloatArrayType::Pointer input = std::dynamic_pointer_cast<FloatArrayType>(am->getAttributeArray(getInputArrayPath().getDataArrayName()));
+  FloatArrayType::Pointer output = std::dynamic_pointer_cast<FloatArrayType>(am->getAttributeArray(getOutputArrayName()));
+  for(size_t i = 0; i < input->getNumberOfTuples(); i++)
+  {
+    output->setValue(i, input->getValue(i) + static_cast<float>(getOffset()));
+  }
+
+  notifyStatusMessage(getHumanLabel(), "Complete");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer OffsetTestArray::newFilterInstance(bool copyFilterParameters) const
+{
+  OffsetTestArray::Pointer filter = OffsetTestArray::New();
+  if(copyFilterParameters)
+  {
+    copyFilterParameterInstanceVariables(filter.get());
+  }
+  return filter;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString OffsetTestArray::getCompiledLibraryName() const
+{
+  return "SIMPLView";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString OffsetTestArray::getBrandingString() const
+{
+  return "SIMPLView";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString OffsetTestArray::getFilterVersion() const
+{
+  return SIMPLib::Version::Complete();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString OffsetTestArray::getGroupName() const
+{
+  return SIMPL::FilterGroups::CoreFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString OffsetTestArray::getSubGroupName() const
+{
+  return SIMPL::FilterSubGroups::MiscFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QString OffsetTestArray::getHumanLabel() const
+{
+  return "Offset Test Array";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const QUuid OffsetTestArray::getUuid()
+{
+  return QUuid("{6a1d9f47-0c3b-5e82-b4a5-7d8e9f0a1b2c}");
+}
@@ -0,0 +1,104 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The OffsetTestArray class is a filter for the unit tests. It reads a float array and creates the
+ * array 'OutputArrayName' next to it, holding the input plus 'Offset'. The created array is named with a
+ * plain string, so its full path is only known after a preflight.
+ */
+class OffsetTestArray : public AbstractFilter
+{
+  Q_OBJECT
+
+public:
+  SIMPL_SHARED_POINTERS(OffsetTestArray)
+  SIMPL_FILTER_NEW_MACRO(OffsetTestArray)
+  SIMPL_TYPE_MACRO_SUPER(OffsetTestArray, AbstractFilter)
+
+  ~OffsetTestArray() override;
+
+  SIMPL_FILTER_PARAMETER(DataArrayPath, InputArrayPath)
+  Q_PROPERTY(DataArrayPath InputArrayPath READ getInputArrayPath WRITE setInputArrayPath)
+
+  SIMPL_FILTER_PARAMETER(QString, OutputArrayName)
+  Q_PROPERTY(QString OutputArrayName READ getOutputArrayName WRITE setOutputArrayName)
+
+  SIMPL_FILTER_PARAMETER(double, Offset)
+  Q_PROPERTY(double Offset READ getOffset WRITE setOffset)
+
+  const QString getCompiledLibraryName() const override;
+  const QString getBrandingString() const override;
+  const QString getFilterVersion() const override;
+  AbstractFilter::Pointer newFilterInstance(bool copyFilterParameters) const override;
+  const QString getGroupName() const override;
+  const QString getSubGroupName() const override;
+  const QUuid getUuid() override;
+  const QString getHumanLabel() const override;
+  void setupFilterParameters() override;
+  void execute() override;
+  void preflight() override;
+
+signals:
+  void updateFilterParameters(AbstractFilter* filter);
+  void parametersChanged();
+  void preflightAboutToExecute();
+  void preflightExecuted();
+
+protected:
+  OffsetTestArray();
+
+  /**
+   * @brief dataCheck Checks for the input array and adds the output array, which is only allocated outside
+   * of a preflight
+   */
+  void dataCheck();
+
+  /**
+   * @brief Initializes all the private instance variables.
+   */
+  void initialize();
+
+public:
+  OffsetTestArray(const OffsetTestArray&) = delete;            // Copy Constructor Not Implemented
+  OffsetTestArray& operator=(const OffsetTestArray&) = delete; // Copy Assignment Not Implemented
+  OffsetTestArray(OffsetTestArray&&) = delete;                 // Move Constructor Not Implemented
+  OffsetTestArray& operator=(OffsetTestArray&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,233 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QCoreApplication>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "Common/PipelineDataFlowGraph.h"
+
+#include "GenerateTestArray.h"
+#include "OffsetTestArray.h"
+
+class PipelineDataFlowGraphTest
+{
+public:
+  PipelineDataFlowGraphTest() = default;
+  ~PipelineDataFlowGraphTest() = default;
+  PipelineDataFlowGraphTest(const PipelineDataFlowGraphTest&) = delete;            // Copy Constructor
+  PipelineDataFlowGraphTest(PipelineDataFlowGraphTest&&) = delete;                 // Move Constructor
+  PipelineDataFlowGraphTest& operator=(const PipelineDataFlowGraphTest&) = delete; // Copy Assignment
+  PipelineDataFlowGraphTest& operator=(PipelineDataFlowGraphTest&&) = delete;      // Move Assignment
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  AbstractFilter::Pointer generate(const QString& dcName)
+  {
+    GenerateTestArray::Pointer filter = GenerateTestArray::New();
+    filter->setDataContainerName(dcName);
+    filter->setNumberOfTuples(10);
+    return filter;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  AbstractFilter::Pointer offset(const DataArrayPath& input, const QString& outputName)
+  {
+    OffsetTestArray::Pointer filter = OffsetTestArray::New();
+    filter->setInputArrayPath(input);
+    filter->setOutputArrayName(outputName);
+    return filter;
+  }
+
+  // -----------------------------------------------------------------------------
+  // Two independent Data Containers, and a filter in the first one that reads an array created by name
+  // -----------------------------------------------------------------------------
+  FilterPipeline::Pointer createBranchedPipeline()
+  {
+    FilterPipeline::Pointer pipeline = FilterPipeline::New();
+    pipeline->pushBack(generate("A"));
+    pipeline->pushBack(generate("B"));
+    pipeline->pushBack(offset(DataArrayPath("A", "AttributeMatrix", "Data"), "Out"));
+    pipeline->pushBack(offset(DataArrayPath("B", "AttributeMatrix", "Data"), "Out"));
+    pipeline->pushBack(offset(DataArrayPath("A", "AttributeMatrix", "Out"), "Out2"));
+    return pipeline;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestPaths()
+  {
+    DataArrayPath dc("A", "", "");
+    DataArrayPath am("A", "AttributeMatrix", "");
+    DataArrayPath array("A", "AttributeMatrix", "Data");
+    DataArrayPath other("A", "AttributeMatrix", "Other");
+
+    DREAM3D_REQUIRE(PipelineDataFlowGraph::PathCovers(dc, array))
+    DREAM3D_REQUIRE(PipelineDataFlowGraph::PathCovers(am, array))
+    DREAM3D_REQUIRE(PipelineDataFlowGraph::PathCovers(array, array))
+    DREAM3D_REQUIRE(!PipelineDataFlowGraph::PathCovers(array, am))
+    DREAM3D_REQUIRE(!PipelineDataFlowGraph::PathCovers(array, other))
+    DREAM3D_REQUIRE(!PipelineDataFlowGraph::PathCovers(DataArrayPath("B", "", ""), array))
+    DREAM3D_REQUIRE(PipelineDataFlowGraph::PathsOverlap(array, dc))
+    DREAM3D_REQUIRE(!PipelineDataFlowGraph::PathsOverlap(array, other))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestFootprints()
+  {
+    FilterDataFootprint generated = PipelineDataFlowGraph::ComputeFootprint(generate("A"));
+    DREAM3D_REQUIRE(!generated.barrier)
+    DREAM3D_REQUIRE(generated.reads.isEmpty())
+    DREAM3D_REQUIRE(generated.writes == QVector<DataArrayPath>(1, DataArrayPath("A", "", "")))
+
+    FilterDataFootprint offsetFootprint = PipelineDataFlowGraph::ComputeFootprint(offset(DataArrayPath("A", "AttributeMatrix", "Data"), "Out"));
+    DREAM3D_REQUIRE(!offsetFootprint.barrier)
+    DREAM3D_REQUIRE(offsetFootprint.reads == QVector<DataArrayPath>(1, DataArrayPath("A", "AttributeMatrix", "Data")))
+    DREAM3D_REQUIRE(offsetFootprint.writes.isEmpty())
+    DREAM3D_REQUIRE(offsetFootprint.dataContainers == QSet<QString>({"A"}))
+
+    // Nothing to locate makes the filter a barrier
+    DREAM3D_REQUIRE(PipelineDataFlowGraph::ComputeFootprint(offset(DataArrayPath(), "Out")).barrier)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestEdgesAndBranches()
+  {
+    PipelineDataFlowGraph graph(createBranchedPipeline());
+    DREAM3D_REQUIRE_EQUAL(graph.size(), 5)
+
+    DREAM3D_REQUIRE(graph.dependencies(0).isEmpty())
+    DREAM3D_REQUIRE(graph.dependencies(1).isEmpty())
+    DREAM3D_REQUIRE(graph.dependencies(2) == QList<int>({0}))
+    DREAM3D_REQUIRE(graph.dependencies(3) == QList<int>({1}))
+    DREAM3D_REQUIRE(graph.dependencies(4) == QList<int>({0, 2}))
+    DREAM3D_REQUIRE(graph.dependents(0) == QList<int>({2, 4}))
+    DREAM3D_REQUIRE(graph.dependents(1) == QList<int>({3}))
+
+    // Without a preflight node 2 is only ordered before node 4 because they share a Data Container
+    DREAM3D_REQUIRE(graph.dataFlowSources(2) == QList<int>({0}))
+    DREAM3D_REQUIRE(graph.dataFlowSources(4) == QList<int>({0}))
+
+    DREAM3D_REQUIRE_EQUAL(graph.branchCount(), 2)
+    DREAM3D_REQUIRE_EQUAL(graph.branch(0), graph.branch(2))
+    DREAM3D_REQUIRE_EQUAL(graph.branch(0), graph.branch(4))
+    DREAM3D_REQUIRE_EQUAL(graph.branch(1), graph.branch(3))
+    DREAM3D_REQUIRE(graph.branch(0) != graph.branch(1))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestResolveCreatedArrays()
+  {
+    PipelineDataFlowGraph graph(createBranchedPipeline());
+    DREAM3D_REQUIRE(!graph.isResolved())
+    DREAM3D_REQUIRE(graph.resolveCreatedArrays())
+    DREAM3D_REQUIRE(graph.isResolved())
+
+    DREAM3D_REQUIRE(graph.createdArrays(0) == QVector<DataArrayPath>(1, DataArrayPath("A", "AttributeMatrix", "Data")))
+    DREAM3D_REQUIRE(graph.createdArrays(2) == QVector<DataArrayPath>(1, DataArrayPath("A", "AttributeMatrix", "Out")))
+    DREAM3D_REQUIRE(graph.footprint(2).writes.contains(DataArrayPath("A", "AttributeMatrix", "Out")))
+
+    // The array created by name is now a data flow edge of its own
+    DREAM3D_REQUIRE(graph.dataFlowSources(4) == QList<int>({0, 2}))
+    DREAM3D_REQUIRE_EQUAL(graph.branchCount(), 2)
+
+    // A failed preflight leaves the graph as it was
+    FilterPipeline::Pointer broken = createBranchedPipeline();
+    broken->pushBack(offset(DataArrayPath("C", "AttributeMatrix", "Data"), "Out"));
+    PipelineDataFlowGraph unresolved(broken);
+    DREAM3D_REQUIRE(!unresolved.resolveCreatedArrays())
+    DREAM3D_REQUIRE(!unresolved.isResolved())
+    DREAM3D_REQUIRE(unresolved.createdArrays(0).isEmpty())
+    DREAM3D_REQUIRE(unresolved.dataFlowSources(4) == QList<int>({0}))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestBarrier()
+  {
+    FilterPipeline::Pointer pipeline = createBranchedPipeline();
+    pipeline->pushBack(offset(DataArrayPath(), "Out"));
+    pipeline->pushBack(generate("C"));
+
+    PipelineDataFlowGraph graph(pipeline);
+    DREAM3D_REQUIRE_EQUAL(graph.size(), 7)
+    DREAM3D_REQUIRE(graph.footprint(5).barrier)
+    DREAM3D_REQUIRE_EQUAL(graph.branch(5), -1)
+    DREAM3D_REQUIRE(graph.dependencies(5) == QList<int>({0, 1, 2, 3, 4}))
+
+    // A new Data Container after the barrier still waits for it
+    DREAM3D_REQUIRE(graph.dependencies(6) == QList<int>({5}))
+    DREAM3D_REQUIRE_EQUAL(graph.branchCount(), 3)
+
+    // Disabled filters are not part of the graph
+    AbstractFilter::Pointer disabled = generate("D");
+    disabled->setEnabled(false);
+    pipeline->pushBack(disabled);
+    DREAM3D_REQUIRE_EQUAL(PipelineDataFlowGraph(pipeline).size(), 7)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestPaths())
+    DREAM3D_REGISTER_TEST(TestFootprints())
+    DREAM3D_REGISTER_TEST(TestEdgesAndBranches())
+    DREAM3D_REGISTER_TEST(TestResolveCreatedArrays())
+    DREAM3D_REGISTER_TEST(TestBarrier())
+  }
+};
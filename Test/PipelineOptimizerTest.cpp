@@ -0,0 +1,197 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QCoreApplication>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "Common/PipelineDataFlowGraph.h"
+#include "Common/PipelineOptimizer.h"
+
+#include "GenerateTestArray.h"
+#include "OffsetTestArray.h"
+
+class PipelineOptimizerTest
+{
+public:
+  PipelineOptimizerTest() = default;
+  ~PipelineOptimizerTest() = default;
+  PipelineOptimizerTest(const PipelineOptimizerTest&) = delete;            // Copy Constructor
+  PipelineOptimizerTest(PipelineOptimizerTest&&) = delete;                 // Move Constructor
+  PipelineOptimizerTest& operator=(const PipelineOptimizerTest&) = delete; // Copy Assignment
+  PipelineOptimizerTest& operator=(PipelineOptimizerTest&&) = delete;      // Move Assignment
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  DataArrayPath path(const QString& arrayName)
+  {
+    return DataArrayPath("A", "AttributeMatrix", arrayName);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  AbstractFilter::Pointer offset(const QString& inputName, const QString& outputName, double value = 1.0)
+  {
+    OffsetTestArray::Pointer filter = OffsetTestArray::New();
+    filter->setInputArrayPath(path(inputName));
+    filter->setOutputArrayName(outputName);
+    filter->setOffset(value);
+    return filter;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  FilterPipeline::Pointer createPipeline(const QVector<AbstractFilter::Pointer>& filters)
+  {
+    GenerateTestArray::Pointer generate = GenerateTestArray::New();
+    generate->setDataContainerName("A");
+    generate->setNumberOfTuples(10);
+
+    FilterPipeline::Pointer pipeline = FilterPipeline::New();
+    pipeline->pushBack(generate);
+    for(const AbstractFilter::Pointer& filter : filters)
+    {
+      pipeline->pushBack(filter);
+    }
+    return pipeline;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestEliminateDeadFilters()
+  {
+    FilterPipeline::Pointer pipeline = createPipeline({offset("Data", "Dead", 5.0), offset("Data", "Live"), offset("Live", "Final")});
+
+    PipelineOptimizer optimizer((PipelineDataFlowGraph(pipeline)));
+    optimizer.setReuseDuplicateFilters(false);
+    optimizer.optimize();
+    DREAM3D_REQUIRE(optimizer.getGraph().isResolved())
+    DREAM3D_REQUIRE(!optimizer.isEliminated(0))
+    DREAM3D_REQUIRE(optimizer.isEliminated(1))
+    DREAM3D_REQUIRE(!optimizer.isEliminated(2))
+    DREAM3D_REQUIRE(!optimizer.isEliminated(3))
+
+    QVector<OptimizationChange> changes = optimizer.getChanges();
+    DREAM3D_REQUIRE_EQUAL(changes.size(), 1)
+    DREAM3D_REQUIRE(changes[0].type == OptimizationChange::Type::Eliminated)
+    DREAM3D_REQUIRE_EQUAL(changes[0].node, 1)
+    DREAM3D_REQUIRE_EQUAL(optimizer.report().size(), 1)
+
+    // A filter flagged with side effects always runs
+    PipelineOptimizer::SetHasSideEffects(pipeline->getFilterContainer()[1], true);
+    PipelineOptimizer flagged((PipelineDataFlowGraph(pipeline)));
+    flagged.optimize();
+    DREAM3D_REQUIRE(!flagged.isEliminated(1))
+    DREAM3D_REQUIRE(flagged.getChanges().isEmpty())
+
+    // Nothing is eliminated when the pass is off
+    PipelineOptimizer::SetHasSideEffects(pipeline->getFilterContainer()[1], false);
+    PipelineOptimizer disabled((PipelineDataFlowGraph(pipeline)));
+    disabled.setEliminateDeadFilters(false);
+    disabled.optimize();
+    DREAM3D_REQUIRE(!disabled.isEliminated(1))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestReuseDuplicateFilters()
+  {
+    FilterPipeline::Pointer pipeline = createPipeline({offset("Data", "X", 2.0), offset("Data", "Y", 2.0), offset("X", "Sum"), offset("Y", "Final")});
+
+    PipelineOptimizer optimizer((PipelineDataFlowGraph(pipeline)));
+    optimizer.optimize();
+    DREAM3D_REQUIRE(!optimizer.isReused(1))
+    DREAM3D_REQUIRE(optimizer.isReused(2))
+    DREAM3D_REQUIRE_EQUAL(optimizer.reuseSource(2), 1)
+    DREAM3D_REQUIRE(optimizer.aliases(2) == PipelineOptimizer::AliasList({qMakePair(path("X"), path("Y"))}))
+
+    // The reused filter now reads the outputs it copies, which keeps their creator alive
+    DREAM3D_REQUIRE(optimizer.getGraph().dataFlowSources(2).contains(1))
+    DREAM3D_REQUIRE(!optimizer.isEliminated(1))
+
+    // Sum is never read and the final filter does not need it
+    DREAM3D_REQUIRE(optimizer.isEliminated(3))
+    DREAM3D_REQUIRE_EQUAL(optimizer.getChanges().size(), 2)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestNoReuse()
+  {
+    // Different parameters
+    PipelineOptimizer different(PipelineDataFlowGraph(createPipeline({offset("Data", "X", 2.0), offset("Data", "Y", 3.0), offset("Y", "Final")})));
+    different.optimize();
+    DREAM3D_REQUIRE(!different.isReused(2))
+
+    // The earlier output is read in between, so a copy would be taken of what may since have changed
+    PipelineOptimizer readBetween(PipelineDataFlowGraph(createPipeline({offset("Data", "X", 2.0), offset("X", "Z"), offset("Data", "Y", 2.0), offset("Y", "Final")})));
+    readBetween.optimize();
+    DREAM3D_REQUIRE(readBetween.getGraph().isResolved())
+    DREAM3D_REQUIRE(!readBetween.isReused(3))
+
+    // A failed preflight leaves the created arrays unknown, so nothing can be matched
+    OffsetTestArray::Pointer broken = OffsetTestArray::New();
+    broken->setInputArrayPath(DataArrayPath("B", "AttributeMatrix", "Data"));
+    broken->setOutputArrayName("Out");
+    PipelineOptimizer unresolved(PipelineDataFlowGraph(createPipeline({offset("Data", "X", 2.0), offset("Data", "Y", 2.0), broken, offset("Y", "Final")})));
+    unresolved.optimize();
+    DREAM3D_REQUIRE(!unresolved.getGraph().isResolved())
+    DREAM3D_REQUIRE(!unresolved.isReused(2))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    DREAM3D_REGISTER_TEST(TestEliminateDeadFilters())
+    DREAM3D_REGISTER_TEST(TestReuseDuplicateFilters())
+    DREAM3D_REGISTER_TEST(TestNoReuse())
+  }
+};
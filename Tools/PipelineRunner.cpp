@@ -0,0 +1,544 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QString>
+#include <QtCore/QThread>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/PipelineMessage.h"
+#include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Filtering/QMetaObjectUtilities.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/Plugin/SIMPLibPluginLoader.h"
+#include "SIMPLib/SIMPLibVersion.h"
+
+#include "Common/ArrayMemoryPool.h"
+#include "Common/ColumnarFile.h"
+#include "Common/DataSnapshotStore.h"
+#include "Common/InputPrefetcher.h"
+#include "Common/MappedFileReader.h"
+#include "Common/MemoryEstimator.h"
+#include "Common/NumaTopology.h"
+#include "Common/PipelineDataFlowGraph.h"
+#include "Common/PipelineExecutor.h"
+#include "Common/PipelineFileSettings.h"
+#include "Common/PreviewReduction.h"
+#include "Common/SeriesExecution.h"
+#include "Common/SharedArrayPublisher.h"
+#include "Common/ThreadBudget.h"
+#include "Common/ThreadTuner.h"
+#include "Common/WriteProfile.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PrintMessage(const PipelineMessage& msg)
+{
+  switch(msg.getType())
+  {
+  case PipelineMessage::MessageType::Error:
+    std::cerr << "Error (" << msg.getCode() << ") " << msg.getFilterHumanLabel().toStdString() << ": " << msg.getText().toStdString() << std::endl;
+    break;
+  case PipelineMessage::MessageType::Warning:
+    std::cout << "Warning (" << msg.getCode() << ") " << msg.getFilterHumanLabel().toStdString() << ": " << msg.getText().toStdString() << std::endl;
+    break;
+  case PipelineMessage::MessageType::StatusMessage:
+  case PipelineMessage::MessageType::StandardOutputMessage:
+    std::cout << msg.getText().toStdString() << std::endl;
+    break;
+  default:
+    break;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Publishes the arrays 'paths' cover, holds them for 'seconds' or until Enter is pressed and removes them
+// -----------------------------------------------------------------------------
+int PublishArrays(const DataContainerArray::Pointer& dca, const QVector<DataArrayPath>& paths, int seconds, const QString& catalogFile)
+{
+  SharedArrayPublisher publisher;
+  QList<DataContainer::Pointer> containers = dca->getDataContainers();
+  for(const DataContainer::Pointer& dc : containers)
+  {
+    DataContainer::AttributeMatrixMap_t& matrices = dc->getAttributeMatrices();
+    for(const AttributeMatrix::Pointer& am : matrices)
+    {
+      QList<QString> names = am->getAttributeArrayNames();
+      for(const QString& name : names)
+      {
+        DataArrayPath array(dc->getName(), am->getName(), name);
+        bool covered = std::any_of(paths.begin(), paths.end(), [&array](const DataArrayPath& path) { return PipelineDataFlowGraph::PathCovers(path, array); });
+        QString errorMessage;
+        if(covered && !publisher.publish(dca, array, &errorMessage))
+        {
+          std::cerr << errorMessage.toStdString() << std::endl;
+          return 1;
+        }
+      }
+    }
+  }
+  if(publisher.getSegments().isEmpty())
+  {
+    std::cerr << "None of the paths to publish names an array of the results" << std::endl;
+    return 1;
+  }
+
+  QByteArray catalog = publisher.catalog();
+  if(!catalogFile.isEmpty())
+  {
+    QFile file(catalogFile);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(catalog) != catalog.size())
+    {
+      std::cerr << "The catalog could not be written to '" << catalogFile.toStdString() << "'" << std::endl;
+      return 1;
+    }
+  }
+  std::cout << "Published " << publisher.getSegments().size() << " arrays (" << MemoryEstimator::FormatBytes(publisher.getPublishedBytes()).toStdString() << ") to shared memory, catalog '"
+            << publisher.getCatalogName().toStdString() << "':" << std::endl
+            << catalog.toStdString() << std::endl;
+
+  if(seconds > 0)
+  {
+    QThread::sleep(static_cast<unsigned long>(seconds));
+  }
+  else
+  {
+    std::cout << "Press Enter to remove the published arrays and exit" << std::endl;
+    std::string line;
+    std::getline(std::cin, line);
+  }
+  publisher.unpublishAll();
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setOrganizationName("BlueQuartz Software");
+  QCoreApplication::setOrganizationDomain("bluequartz.net");
+  QCoreApplication::setApplicationName("PipelineRunner");
+  QCoreApplication::setApplicationVersion(SIMPLib::Version::Complete());
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Executes a pipeline file without the graphical user interface");
+  parser.addHelpOption();
+  parser.addVersionOption();
+  parser.addPositionalArgument("pipeline", "The pipeline file to execute");
+
+  QCommandLineOption threadsOption(QStringList() << "t" << "threads", "Total number of threads the process may use, 0 uses every core", "count", "0");
+  QCommandLineOption weightOption(QStringList() << "w" << "weight", "Weight of this pipeline's share of the thread budget. Overrides the pipeline file.", "weight");
+  QCommandLineOption maxThreadsOption("max-threads", "Most threads this pipeline may use. Overrides the pipeline file.", "count");
+  QCommandLineOption priorityOption("priority", "Priority class of this pipeline: interactive, normal or background. Overrides the pipeline file.", "class");
+  QCommandLineOption numaNodeOption("numa-node", "Run every thread on this NUMA node and allocate the arrays there. Overrides the pipeline file.", "node");
+  QCommandLineOption numaPinOption("numa-pin", "Pin the threads to the NUMA nodes and spread the pages of new arrays over the nodes to match");
+  QCommandLineOption noFirstTouchOption("no-first-touch", "Do not zero new pooled arrays in parallel on machines with several NUMA nodes");
+  QCommandLineOption releaseOption("release-dead-arrays", "Release arrays after their last use");
+  QCommandLineOption optimizeOption("optimize", "Optimize the pipeline before execution");
+  QCommandLineOption fuseOption("fuse", "Fuse consecutive element-wise filters");
+  QCommandLineOption tiledOption("tiled", "Execute slab by slab along Z with this many slices per slab", "slices");
+  parser.addOption(threadsOption);
+  parser.addOption(weightOption);
+  parser.addOption(maxThreadsOption);
+  parser.addOption(priorityOption);
+  parser.addOption(numaNodeOption);
+  parser.addOption(numaPinOption);
+  parser.addOption(noFirstTouchOption);
+  parser.addOption(releaseOption);
+  parser.addOption(optimizeOption);
+  parser.addOption(fuseOption);
+  QCommandLineOption seriesOption("series", "Execute once per dataset listed in this file, one input file per line optionally followed by a tab and the output file, "
+                                            "overlapping reading, computing and writing of consecutive datasets", "list");
+  QCommandLineOption memoryWindowOption("memory-window", "Memory the datasets in flight of a series may use in MB, 0 for no limit", "MB", "0");
+  QCommandLineOption previewOption("preview", "Execute a preview on reduced inputs without running any writer: \"downsample <factor>\" or \"crop x0,y0,z0,x1,y1,z1\"",
+                                    "reduction");
+  QCommandLineOption memoryCheckOption("memory-check", "What to do when the estimated peak memory exceeds the budget: off, warn or refuse", "policy", "warn");
+  QCommandLineOption memoryBudgetOption("memory-budget", "Memory the pipeline may use in MB, 0 for the memory available at the start", "MB", "0");
+  QCommandLineOption spillOption("spill", "Spill the arrays that are not needed soon to a temporary file while the arrays exceed the memory budget");
+  QCommandLineOption compressIdleOption("compress-idle", "Hold arrays no filter has used for this many filters compressed, 0 to never compress idle arrays", "filters", "0");
+  QCommandLineOption compressOption("compress", "Hold the array, attribute matrix or data container at this path (DataContainer/AttributeMatrix/Array) compressed whenever no filter uses it. May be given more than once.",
+                                    "path");
+  QCommandLineOption mapArraysOption("map-arrays", "Map the arrays of .dream3d inputs from their files instead of reading them: off, read-only or copy-on-write", "mode", "off");
+  QCommandLineOption scratchDirOption("scratch-dir", "Directory of the scratch files that hold the arrays of other inputs while arrays are mapped", "directory");
+  QCommandLineOption parallelChunksOption("parallel-chunks", "Decompress the compressed chunked arrays of .dream3d inputs on every thread instead of through HDF5 alone");
+  QCommandLineOption asyncWriteOption("async-write", "Write the files of writer filters on a background thread while the next filters execute");
+  QCommandLineOption prefetchOption("prefetch", "Read the input files of this many readers ahead of the running filters into the cache, 0 to never prefetch", "readers", "0");
+  QCommandLineOption prefetchLimitOption("prefetch-limit", "Input files that may be read ahead of their readers at once in MB", "MB",
+                                         QString::number(InputPrefetcher::DefaultMaxBytes / (1024 * 1024)));
+  QCommandLineOption writeProfileOption("write-profile", "Rewrite the HDF5 files of writers without their own profile with this profile: default, fast-scratch, archive or slice-access",
+                                        "profile", WriteProfile::PresetName(WriteProfile::Preset::Default));
+  QCommandLineOption measureProfilesOption("measure-write-profiles", "Write the largest numeric dataset of this HDF5 file with every write profile, print the throughput and size and exit",
+                                           "file");
+  QCommandLineOption incrementalOption("incremental-write", "Update output files that already exist with only the datasets and attributes that changed");
+  QCommandLineOption snapshotsOption("snapshots", "Keep a snapshot after every filter and print how much data the snapshots share");
+  QCommandLineOption publishOption("publish", "Publish the array, or every array of the attribute matrix or data container, at this path (DataContainer/AttributeMatrix/Array) "
+                                   "to shared memory once the pipeline finished. May be given more than once.",
+                                   "path");
+  QCommandLineOption publishSecondsOption("publish-seconds", "Keep the published arrays this many seconds before removing them and exiting, 0 to keep them until Enter is pressed",
+                                          "seconds", "0");
+  QCommandLineOption publishCatalogOption("publish-catalog", "Also write the catalog of the published arrays to this JSON file", "file");
+  QCommandLineOption removeStaleOption("remove-stale-segments", "Remove the shared memory segments of SIMPLView processes that no longer run and exit");
+  QCommandLineOption poolRetentionOption("pool-retention", "Memory of destroyed arrays the array pool keeps for reuse in MB", "MB",
+                                         QString::number(ArrayMemoryPool::DefaultRetentionCap / (1024 * 1024)));
+  QCommandLineOption noHugePagesOption("no-huge-pages", "Do not back pooled arrays with transparent huge pages");
+  QCommandLineOption autoTuneOption("auto-tune", "Run every filter with the thread count learned for it and keep learning");
+  QCommandLineOption showProfilesOption("show-thread-profiles", "Print the learned thread profiles and exit");
+  QCommandLineOption resetProfilesOption("reset-thread-profiles", "Forget the learned thread profiles of a filter class, or of every class with \"all\", and exit", "filter");
+  parser.addOption(tiledOption);
+  parser.addOption(autoTuneOption);
+  parser.addOption(showProfilesOption);
+  parser.addOption(resetProfilesOption);
+  parser.addOption(seriesOption);
+  parser.addOption(memoryWindowOption);
+  parser.addOption(previewOption);
+  parser.addOption(memoryCheckOption);
+  parser.addOption(memoryBudgetOption);
+  parser.addOption(spillOption);
+  parser.addOption(compressIdleOption);
+  parser.addOption(compressOption);
+  parser.addOption(mapArraysOption);
+  parser.addOption(scratchDirOption);
+  parser.addOption(parallelChunksOption);
+  parser.addOption(asyncWriteOption);
+  parser.addOption(prefetchOption);
+  parser.addOption(prefetchLimitOption);
+  parser.addOption(writeProfileOption);
+  parser.addOption(measureProfilesOption);
+  parser.addOption(incrementalOption);
+  parser.addOption(snapshotsOption);
+  parser.addOption(publishOption);
+  parser.addOption(publishSecondsOption);
+  parser.addOption(publishCatalogOption);
+  parser.addOption(removeStaleOption);
+  parser.addOption(poolRetentionOption);
+  parser.addOption(noHugePagesOption);
+  parser.process(app);
+
+  ThreadTuner* tuner = ThreadTuner::Instance();
+  if(parser.isSet(resetProfilesOption))
+  {
+    QString className = parser.value(resetProfilesOption);
+    tuner->reset(className == "all" ? QString() : className);
+    std::cout << "Reset the thread profiles in " << tuner->getFilePath().toStdString() << std::endl;
+    return 0;
+  }
+  // Shared memory outlives a crashed process, so remove what earlier runs could not clean up
+  int staleSegments = SharedArrayPublisher::RemoveStaleSegments();
+  if(parser.isSet(removeStaleOption))
+  {
+    std::cout << "Removed " << staleSegments << " stale shared memory segments" << std::endl;
+    return 0;
+  }
+  if(parser.isSet(showProfilesOption))
+  {
+    std::cout << "Thread profiles in " << tuner->getFilePath().toStdString() << std::endl;
+    QStringList lines = tuner->report();
+    for(const QString& line : lines)
+    {
+      std::cout << "  " << line.toStdString() << std::endl;
+    }
+    return 0;
+  }
+  tuner->setEnabled(parser.isSet(autoTuneOption));
+
+  if(parser.isSet(measureProfilesOption))
+  {
+    QString directory = parser.isSet(scratchDirOption) ? parser.value(scratchDirOption) : QDir::tempPath();
+    QString errorMessage;
+    QVector<WriteProfile::Measurement> measurements = WriteProfile::Measure(parser.value(measureProfilesOption), directory, &errorMessage);
+    if(measurements.isEmpty())
+    {
+      std::cerr << errorMessage.toStdString() << std::endl;
+      return 1;
+    }
+    QStringList lines = WriteProfile::MeasurementReport(measurements);
+    for(const QString& line : lines)
+    {
+      std::cout << line.toStdString() << std::endl;
+    }
+    return 0;
+  }
+
+  QStringList args = parser.positionalArguments();
+  if(args.size() != 1)
+  {
+    parser.showHelp(1);
+  }
+
+  QString pipelineFile = args.front();
+  QFileInfo fi(pipelineFile);
+  if(!fi.exists())
+  {
+    std::cerr << "The pipeline file '" << pipelineFile.toStdString() << "' does not exist" << std::endl;
+    return 1;
+  }
+
+  ThreadBudget* budget = ThreadBudget::Instance();
+  budget->setTotalThreads(parser.value(threadsOption).toInt());
+
+  ThreadBudget::Request request = ThreadBudget::ReadRequest(fi.absoluteFilePath());
+  if(parser.isSet(weightOption) && parser.value(weightOption).toDouble() > 0.0)
+  {
+    request.weight = parser.value(weightOption).toDouble();
+  }
+  if(parser.isSet(maxThreadsOption))
+  {
+    request.maxThreads = std::max(parser.value(maxThreadsOption).toInt(), 0);
+  }
+  if(parser.isSet(priorityOption))
+  {
+    bool ok = false;
+    request.priority = ThreadBudget::PriorityClassFromName(parser.value(priorityOption), &ok);
+    if(!ok)
+    {
+      std::cerr << "Unknown priority class '" << parser.value(priorityOption).toStdString() << "'" << std::endl;
+      return 1;
+    }
+  }
+  if(request.priority == ThreadBudget::PriorityClass::Background)
+  {
+    // Nothing else runs in this process; threads started from here on inherit the lower OS priority
+    ThreadBudget::LowerCurrentThreadPriority();
+  }
+
+  NumaTopology* topology = NumaTopology::Instance();
+  if(parser.isSet(numaNodeOption))
+  {
+    request.numaNode = parser.value(numaNodeOption).toInt();
+  }
+  if(request.numaNode >= 0 && topology->getCpuCount(request.numaNode) == 0)
+  {
+    std::cerr << "There is no NUMA node " << request.numaNode << " with CPUs this process may use" << std::endl;
+    return 1;
+  }
+  if(request.numaNode >= 0)
+  {
+    // Threads started from here on inherit the node, so the pages they touch first are allocated there
+    topology->pinCurrentThread(request.numaNode);
+  }
+  budget->setPinThreadsToNodes(parser.isSet(numaPinOption));
+  topology->setFirstTouch(!parser.isSet(noFirstTouchOption));
+
+  // Register all the filters including trying to load those from Plugins
+  FilterManager* fm = FilterManager::Instance();
+  SIMPLibPluginLoader::LoadPluginFilters(fm);
+  ColumnarFile::RegisterFilters(fm);
+  QMetaObjectUtilities::RegisterMetaTypes();
+
+  JsonFilterParametersReader::Pointer jsonReader = JsonFilterParametersReader::New();
+  FilterPipeline::Pointer pipeline = jsonReader->readPipelineFromFile(fi.absoluteFilePath());
+  if(pipeline.get() == nullptr)
+  {
+    std::cerr << "The pipeline file '" << pipelineFile.toStdString() << "' could not be read" << std::endl;
+    return 1;
+  }
+  PipelineFileSettings::ReadFile(fi.absoluteFilePath(), pipeline);
+
+  QVector<SeriesDataset> datasets;
+  if(parser.isSet(seriesOption))
+  {
+    bool ok = false;
+    datasets = SeriesExecution::ReadDatasetList(parser.value(seriesOption), &ok);
+    if(!ok || datasets.isEmpty())
+    {
+      std::cerr << "The series file '" << parser.value(seriesOption).toStdString() << "' could not be read or lists no datasets" << std::endl;
+      return 1;
+    }
+  }
+
+  PreviewReduction preview;
+  if(parser.isSet(previewOption))
+  {
+    bool ok = false;
+    preview = PreviewReduction::FromString(parser.value(previewOption), &ok);
+    if(!ok || !preview.isEnabled())
+    {
+      std::cerr << "'" << parser.value(previewOption).toStdString() << "' is not a preview reduction" << std::endl;
+      return 1;
+    }
+  }
+
+  bool policyOk = false;
+  MemoryEstimator::Policy memoryPolicy = MemoryEstimator::PolicyFromName(parser.value(memoryCheckOption), &policyOk);
+  if(!policyOk)
+  {
+    std::cerr << "Unknown memory check '" << parser.value(memoryCheckOption).toStdString() << "'" << std::endl;
+    return 1;
+  }
+  bool mappingOk = false;
+  MappedFileReader::Mode mapping = MappedFileReader::ModeFromName(parser.value(mapArraysOption), &mappingOk);
+  if(!mappingOk)
+  {
+    std::cerr << "Unknown array mapping '" << parser.value(mapArraysOption).toStdString() << "'" << std::endl;
+    return 1;
+  }
+  bool writeProfileOk = false;
+  WriteProfile::Preset writeProfile = WriteProfile::PresetFromName(parser.value(writeProfileOption), &writeProfileOk);
+  if(!writeProfileOk)
+  {
+    std::cerr << "Unknown write profile '" << parser.value(writeProfileOption).toStdString() << "'" << std::endl;
+    return 1;
+  }
+  size_t budget = static_cast<size_t>(std::max(parser.value(memoryBudgetOption).toLongLong(), 0LL)) * 1024 * 1024;
+  if(budget == 0)
+  {
+    budget = MemoryEstimator::AvailableBytes();
+  }
+
+  // Tiled runs and previews never hold the whole volume, so the estimate does not apply to them
+  if(memoryPolicy != MemoryEstimator::Policy::Off && !parser.isSet(tiledOption) && !preview.isEnabled())
+  {
+    if(pipeline->preflightPipeline() < 0)
+    {
+      std::cerr << "The pipeline failed to preflight" << std::endl;
+      return 1;
+    }
+
+    MemoryEstimator estimator(pipeline, parser.isSet(releaseOption));
+    QStringList report = estimator.report(budget);
+    for(const QString& line : report)
+    {
+      std::cout << line.toStdString() << std::endl;
+    }
+    if(estimator.exceeds(budget) && parser.isSet(spillOption))
+    {
+      std::cout << "The estimated peak memory exceeds the budget; arrays will be spilled to disk" << std::endl;
+    }
+    else if(estimator.exceeds(budget))
+    {
+      if(memoryPolicy == MemoryEstimator::Policy::Refuse)
+      {
+        std::cerr << "Refusing to execute: the estimated peak memory exceeds the budget" << std::endl;
+        return 1;
+      }
+      std::cout << "Warning: the estimated peak memory exceeds the budget" << std::endl;
+    }
+  }
+
+  ArrayMemoryPool* pool = ArrayMemoryPool::Instance();
+  pool->setRetentionCap(static_cast<size_t>(std::max(parser.value(poolRetentionOption).toLongLong(), 0LL)) * 1024 * 1024);
+  pool->setHugePages(!parser.isSet(noHugePagesOption));
+
+  PipelineExecutor executor(pipeline);
+  executor.setThreadBudgetRequest(request);
+  executor.setReleaseDeadArrays(parser.isSet(releaseOption));
+  executor.setOptimizePipeline(parser.isSet(optimizeOption));
+  executor.setFuseElementwiseFilters(parser.isSet(fuseOption));
+  executor.setTiledSlabThickness(parser.isSet(tiledOption) ? parser.value(tiledOption).toInt() : 0);
+  executor.setSeriesDatasets(datasets);
+  executor.setPreviewReduction(preview);
+  executor.setSpillMemoryLimit(parser.isSet(spillOption) ? budget : 0);
+  executor.setCompressIdleArrays(parser.value(compressIdleOption).toInt());
+  QVector<DataArrayPath> compressedPaths;
+  for(const QString& path : parser.values(compressOption))
+  {
+    compressedPaths.push_back(DataArrayPath::Deserialize(path, "/"));
+  }
+  executor.setCompressedArrayPaths(compressedPaths);
+  QVector<DataArrayPath> publishedPaths;
+  for(const QString& path : parser.values(publishOption))
+  {
+    publishedPaths.push_back(DataArrayPath::Deserialize(path, "/"));
+  }
+  // Arrays to publish must survive until the end even if dead arrays are released
+  executor.setKeptArrayPaths(publishedPaths);
+  executor.setArrayMapping(mapping);
+  executor.setScratchDirectory(parser.value(scratchDirOption));
+  executor.setParallelChunkedReads(parser.isSet(parallelChunksOption));
+  executor.setAsyncWrites(parser.isSet(asyncWriteOption));
+  executor.setPrefetchDepth(parser.value(prefetchOption).toInt());
+  executor.setPrefetchMemoryLimit(static_cast<size_t>(std::max(parser.value(prefetchLimitOption).toLongLong(), 0LL)) * 1024 * 1024);
+  executor.setWriteProfile(writeProfile);
+  executor.setIncrementalWrites(parser.isSet(incrementalOption));
+  executor.setSeriesMemoryWindow(static_cast<size_t>(std::max(parser.value(memoryWindowOption).toLongLong(), 0LL)) * 1024 * 1024);
+  std::shared_ptr<DataSnapshotStore> snapshots;
+  if(parser.isSet(snapshotsOption))
+  {
+    snapshots = std::make_shared<DataSnapshotStore>();
+    executor.setSnapshotStore(snapshots);
+  }
+  QObject::connect(&executor, &PipelineExecutor::pipelineGeneratedMessage, &PrintMessage);
+
+  DataContainerArray::Pointer dca = executor.execute();
+  if(executor.getErrorCondition() < 0)
+  {
+    std::cerr << "Pipeline failed with error " << executor.getErrorCondition() << std::endl;
+    return 1;
+  }
+
+  if(snapshots.get() != nullptr)
+  {
+    QStringList report = snapshots->report();
+    for(const QString& line : report)
+    {
+      std::cout << line.toStdString() << std::endl;
+    }
+  }
+
+  if(preview.isEnabled())
+  {
+    // Nothing was written, so describe what the preview produced
+    QList<DataContainer::Pointer> containers = dca->getDataContainers();
+    for(const DataContainer::Pointer& dc : containers)
+    {
+      std::cout << "Preview result '" << dc->getName().toStdString() << "':";
+      ImageGeom::Pointer geom = dc->getGeometryAs<ImageGeom>();
+      if(geom.get() != nullptr)
+      {
+        std::cout << " " << geom->getXPoints() << " x " << geom->getYPoints() << " x " << geom->getZPoints() << " voxels,";
+      }
+      std::cout << " " << dc->getAttributeMatrices().size() << " attribute matrices" << std::endl;
+    }
+  }
+
+  if(!publishedPaths.isEmpty())
+  {
+    return PublishArrays(dca, publishedPaths, parser.value(publishSecondsOption).toInt(), parser.value(publishCatalogOption));
+  }
+
+  return 0;
+}